@@ -0,0 +1,222 @@
+#include "Benchmark.h"
+#include "AllocationTracker.h"
+#include "Collision.h"
+#include "FrameArena.h"
+#include "GlyphCache.h"
+#include "ParticleSystem.h"
+#include "SpatialHash.h"
+#include "SpriteAnimation.h"
+#include "SweepAndPrune.h"
+#include "TextSystem.h"
+#include "Tilemap.h"
+#include <stdio.h>
+#include <vector>
+
+static const int WARMUP_FRAMES = 120;
+static const int CHECKED_FRAMES = 240;
+static const float FRAME_TIME = 1.0f / 60.0f;
+static const int SPRITE_COUNT = 1000;
+static const int BOX_COUNT = 2000;
+static const int TEXT_COUNT = 20;
+static const int MAP_SIZE = 256;
+
+// Solid squares in place of a font.
+class SquareGlyphSource : public GlyphSource
+{
+public:
+	bool RasterizeGlyph(unsigned int, GlyphBitmap& aGlyph)
+	{
+		aGlyph.width = 8;
+		aGlyph.height = 12;
+		aGlyph.offsetX = 1;
+		aGlyph.offsetY = 10;
+		aGlyph.advance = 10.0f;
+		aGlyph.coverage.assign(aGlyph.width * aGlyph.height, 255);
+		return true;
+	}
+
+	float GetAscent()
+	{
+		return 10.0f;
+	}
+
+	float GetLineHeight()
+	{
+		return 14.0f;
+	}
+};
+
+bool RunSteadyStateAllocationCheck()
+{
+#ifdef ALLOCATION_TRACKING
+	JobSystem jobSystem;
+	SpriteAnimation animation;
+	ParticleSystem particleSystem;
+	ParticleEmitter::Settings settings;
+	Tilemap tilemap;
+	SquareGlyphSource glyphSource;
+	GlyphCache glyphCache;
+	TextSystem textSystem;
+	SweepAndPrune sweepAndPrune;
+	SpatialHash spatialHash;
+	FrameArena frameArena;
+	std::vector<SpriteVertex> vertices;
+	std::vector<float> positions, sizes;
+	std::vector<AABB> boxes;
+	std::vector<CollisionPair> pairs;
+	std::vector<int> texts;
+	char string[32];
+	int i, frame, clip, allocations, worstFrame, worstAllocations;
+	long long bytes;
+	float* scratch;
+
+	// Set up every system the way a game would at load time, this is allowed to allocate.
+	jobSystem.Initialize(0);
+
+	animation.Initialize(SPRITE_COUNT);
+	clip = animation.AddGridClip(4, 4, 0, 16, 0.1f, true);
+	for (i = 0; i < SPRITE_COUNT; i++)
+	{
+		animation.CreateInstance(clip, 0.5f + (float)(i % 7) * 0.25f);
+	}
+
+	particleSystem.Initialize(jobSystem);
+	settings.positionX = 0.0f;
+	settings.positionY = 0.0f;
+	settings.spawnRadius = 0.5f;
+	settings.emissionRate = 3000.0f;
+	settings.lifetimeMin = 1.0f;
+	settings.lifetimeMax = 2.0f;
+	settings.speedMin = 1.0f;
+	settings.speedMax = 3.0f;
+	settings.directionMin = 0.0f;
+	settings.directionMax = 6.2831853f;
+	settings.gravityX = 0.0f;
+	settings.gravityY = -3.0f;
+	settings.drag = 0.1f;
+	for (i = 0; i < 4; i++)
+	{
+		settings.positionX = (float)i;
+		particleSystem.AddEmitter(settings, 8192);
+	}
+
+	tilemap.Initialize(MAP_SIZE, MAP_SIZE, 1.0f, 0.0f, 0.0f, 16, 16);
+
+	glyphCache.Initialize(glyphSource, 512, 16, 0);
+	textSystem.Initialize(glyphCache);
+	for (i = 0; i < TEXT_COUNT; i++)
+	{
+		texts.push_back(textSystem.CreateText());
+		textSystem.SetPosition(texts[i], 0.0f, (float)i);
+	}
+
+	sweepAndPrune.Initialize(BOX_COUNT);
+	spatialHash.Initialize(BOX_COUNT, 4.0f, 4096);
+	positions.resize(BOX_COUNT * 3);
+	sizes.resize(BOX_COUNT * 2);
+	boxes.resize(BOX_COUNT);
+	for (i = 0; i < BOX_COUNT; i++)
+	{
+		positions[i * 3 + 0] = (float)((i * 37) % 200);
+		positions[i * 3 + 1] = (float)((i * 91) % 200);
+		positions[i * 3 + 2] = 0.0f;
+		sizes[i * 2 + 0] = 1.0f + (float)(i % 3);
+		sizes[i * 2 + 1] = 1.0f + (float)(i % 5);
+	}
+
+	frameArena.Initialize(1024 * 1024);
+	vertices.resize(65536 * 4);
+
+	// Run the frames, the first ones may still grow buffers, the rest must not touch the heap.
+	worstFrame = -1;
+	worstAllocations = 0;
+	bytes = 0;
+	for (frame = 0; frame < WARMUP_FRAMES + CHECKED_FRAMES; frame++)
+	{
+		AllocationTracker::BeginFrame();
+		frameArena.BeginFrame();
+
+		// The last frame of a clean run is made with the tracker expecting no allocations, which aborts on the first one.
+		AllocationTracker::SetExpectNoAllocations(frame == WARMUP_FRAMES + CHECKED_FRAMES - 1 && worstAllocations == 0);
+
+		animation.Update(FRAME_TIME);
+		particleSystem.Update(FRAME_TIME);
+		particleSystem.WriteQuads(&vertices[0], 65536);
+
+		// Change a tile and rebuild the chunk it dirtied.
+		tilemap.SetTile(frame % MAP_SIZE, (frame * 7) % MAP_SIZE, (unsigned short)(1 + frame % 200));
+		for (i = 0; i < tilemap.GetChunkCount(); i++)
+		{
+			if (tilemap.IsChunkDirty(i))
+			{
+				tilemap.BuildChunkMesh(i, &vertices[0]);
+				tilemap.ClearChunkDirty(i);
+			}
+		}
+
+		// A counter that changes every frame, the rest of the texts stay the same.
+		snprintf(string, sizeof(string), "Frame %06d", frame);
+		textSystem.SetText(texts[0], string);
+		for (i = 1; i < TEXT_COUNT; i++)
+		{
+			textSystem.SetText(texts[i], "Static line of text");
+		}
+		textSystem.Update();
+		textSystem.Emit(&vertices[0], 65536);
+
+		// Move the boxes a little and find the overlaps.
+		for (i = 0; i < BOX_COUNT; i++)
+		{
+			positions[i * 3 + 0] += (i % 2 == 0) ? 0.05f : -0.05f;
+		}
+		ComputeBoxes(&positions[0], 3, &sizes[0], 2, BOX_COUNT, &boxes[0]);
+		sweepAndPrune.Update(&boxes[0], BOX_COUNT);
+		sweepAndPrune.FindPairs(pairs, &jobSystem);
+		spatialHash.Update(&boxes[0], BOX_COUNT);
+		spatialHash.FindPairs(pairs, &jobSystem);
+
+		// Temporary per frame data comes from the frame arena.
+		scratch = frameArena.AllocateArray<float>(BOX_COUNT);
+		scratch[frame % BOX_COUNT] = (float)pairs.size();
+
+		AllocationTracker::SetExpectNoAllocations(false);
+		if (frame >= WARMUP_FRAMES)
+		{
+			allocations = AllocationTracker::GetFrameHeapAllocationCount();
+			bytes += AllocationTracker::GetFrameHeapBytes();
+			if (allocations > worstAllocations)
+			{
+				worstAllocations = allocations;
+				worstFrame = frame;
+			}
+		}
+	}
+
+	if (worstAllocations > 0)
+	{
+		printf("Allocation check: FAILED, frame %d made %d heap allocations, %lld bytes over %d checked frames\n", worstFrame,
+			worstAllocations, bytes, CHECKED_FRAMES);
+		AllocationTracker::DumpTopSites(stdout, 10);
+	}
+	else
+	{
+		printf("Allocation check: %d frames after %d warm-up frames made no heap allocations (%d engine allocator allocations per frame)\n",
+			CHECKED_FRAMES, WARMUP_FRAMES, AllocationTracker::GetFrameEngineAllocationCount());
+	}
+
+	textSystem.Shutdown();
+	glyphCache.Shutdown();
+	spatialHash.Shutdown();
+	sweepAndPrune.Shutdown();
+	tilemap.Shutdown();
+	particleSystem.Shutdown();
+	animation.Shutdown();
+	jobSystem.Shutdown();
+	frameArena.Shutdown();
+
+	return worstAllocations == 0;
+#else
+	printf("Allocation check: skipped, build with ALLOCATION_TRACKING defined to run it\n");
+	return true;
+#endif
+}
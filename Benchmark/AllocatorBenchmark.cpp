@@ -0,0 +1,223 @@
+#include "Benchmark.h"
+#include "FrameArena.h"
+#include "PoolAllocator.h"
+#include "ScratchArena.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const int MODEL_ITERATIONS = 200000;
+static const int MODEL_VERTEX_COUNT = 4;
+static const int MODEL_INDEX_COUNT = 6;
+static const int TARGA_ITERATIONS = 50;
+static const int TARGA_SIZE = 1024;
+static const int CHURN_LIVE_COUNT = 10000;
+static const int CHURN_OPERATIONS = 2000000;
+static const int CHURN_OBJECT_SIZE = 64;
+static const int FRAME_COUNT = 1000;
+static const int FRAME_ALLOCATIONS = 1000;
+
+// Same layout as the model's vertices.
+struct BenchmarkVertex
+{
+	float x, y, z;
+	float u, v;
+};
+
+static void FillModel(BenchmarkVertex* aVertices, unsigned long* aIndices)
+{
+	int i;
+
+	for (i = 0; i < MODEL_VERTEX_COUNT; i++)
+	{
+		aVertices[i].x = (float)(i & 1);
+		aVertices[i].y = (float)(i >> 1);
+		aVertices[i].z = 0.0f;
+		aVertices[i].u = aVertices[i].x;
+		aVertices[i].v = aVertices[i].y;
+	}
+	for (i = 0; i < MODEL_INDEX_COUNT; i++)
+	{
+		aIndices[i] = i % MODEL_VERTEX_COUNT;
+	}
+}
+
+static void FlipImage(const unsigned char* aSource, unsigned char* aDestination)
+{
+	int y;
+
+	// Rows of a targa file are stored bottom up.
+	for (y = 0; y < TARGA_SIZE; y++)
+	{
+		memcpy(aDestination + y * TARGA_SIZE * 4, aSource + (TARGA_SIZE - 1 - y) * TARGA_SIZE * 4, TARGA_SIZE * 4);
+	}
+}
+
+static double Seconds(std::chrono::high_resolution_clock::time_point aStart)
+{
+	return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - aStart).count();
+}
+
+void RunAllocatorBenchmark()
+{
+	FrameArena frameArena;
+	PoolAllocator pool;
+	BenchmarkVertex* vertices;
+	unsigned long* indices;
+	unsigned char* image;
+	unsigned char* flipped;
+	void** live;
+	int i, j, slot, size;
+	unsigned int checksum;
+	double heapSeconds, arenaSeconds;
+	std::chrono::high_resolution_clock::time_point start;
+
+	checksum = 0;
+
+	// The model pattern, two small arrays filled, handed to the device and freed.
+	start = std::chrono::high_resolution_clock::now();
+	for (i = 0; i < MODEL_ITERATIONS; i++)
+	{
+		vertices = new BenchmarkVertex[MODEL_VERTEX_COUNT];
+		indices = new unsigned long[MODEL_INDEX_COUNT];
+		FillModel(vertices, indices);
+		checksum += indices[i % MODEL_INDEX_COUNT];
+		delete[] vertices;
+		delete[] indices;
+	}
+	heapSeconds = Seconds(start);
+
+	start = std::chrono::high_resolution_clock::now();
+	for (i = 0; i < MODEL_ITERATIONS; i++)
+	{
+		ScratchArena scratch;
+		vertices = scratch.AllocateArray<BenchmarkVertex>(MODEL_VERTEX_COUNT);
+		indices = scratch.AllocateArray<unsigned long>(MODEL_INDEX_COUNT);
+		FillModel(vertices, indices);
+		checksum += indices[i % MODEL_INDEX_COUNT];
+	}
+	arenaSeconds = Seconds(start);
+
+	printf("Allocators: model buffers, new/delete %.1f ns, scratch arena %.1f ns per model\n", heapSeconds * 1e9 / MODEL_ITERATIONS,
+		arenaSeconds * 1e9 / MODEL_ITERATIONS);
+
+	// The targa pattern, read into one image sized buffer and flipped into another.
+	start = std::chrono::high_resolution_clock::now();
+	for (i = 0; i < TARGA_ITERATIONS; i++)
+	{
+		image = new unsigned char[TARGA_SIZE * TARGA_SIZE * 4];
+		memset(image, i, TARGA_SIZE * TARGA_SIZE * 4);
+		flipped = new unsigned char[TARGA_SIZE * TARGA_SIZE * 4];
+		FlipImage(image, flipped);
+		checksum += flipped[i];
+		delete[] image;
+		delete[] flipped;
+	}
+	heapSeconds = Seconds(start);
+
+	start = std::chrono::high_resolution_clock::now();
+	for (i = 0; i < TARGA_ITERATIONS; i++)
+	{
+		ScratchArena scratch;
+		image = scratch.AllocateArray<unsigned char>(TARGA_SIZE * TARGA_SIZE * 4);
+		memset(image, i, TARGA_SIZE * TARGA_SIZE * 4);
+		flipped = scratch.AllocateArray<unsigned char>(TARGA_SIZE * TARGA_SIZE * 4);
+		FlipImage(image, flipped);
+		checksum += flipped[i];
+	}
+	arenaSeconds = Seconds(start);
+
+	printf("Allocators: %dx%d targa load, new/delete %.3f ms, scratch arena %.3f ms per image (scratch high water %.1f MB)\n", TARGA_SIZE,
+		TARGA_SIZE, heapSeconds * 1000.0 / TARGA_ITERATIONS, arenaSeconds * 1000.0 / TARGA_ITERATIONS,
+		ScratchArena::GetThreadArena().GetHighWaterMark() / (1024.0 * 1024.0));
+
+	// Objects created and destroyed in random order with a steady number alive.
+	live = new void*[CHURN_LIVE_COUNT];
+	for (i = 0; i < CHURN_LIVE_COUNT; i++)
+	{
+		live[i] = malloc(CHURN_OBJECT_SIZE);
+	}
+	srand(1234);
+	start = std::chrono::high_resolution_clock::now();
+	for (i = 0; i < CHURN_OPERATIONS; i++)
+	{
+		slot = rand() % CHURN_LIVE_COUNT;
+		free(live[slot]);
+		live[slot] = malloc(CHURN_OBJECT_SIZE);
+		((unsigned char*)live[slot])[0] = (unsigned char)i;
+	}
+	heapSeconds = Seconds(start);
+	for (i = 0; i < CHURN_LIVE_COUNT; i++)
+	{
+		free(live[i]);
+	}
+
+	pool.Initialize(CHURN_OBJECT_SIZE, CHURN_LIVE_COUNT);
+	for (i = 0; i < CHURN_LIVE_COUNT; i++)
+	{
+		live[i] = pool.Allocate();
+	}
+	srand(1234);
+	start = std::chrono::high_resolution_clock::now();
+	for (i = 0; i < CHURN_OPERATIONS; i++)
+	{
+		slot = rand() % CHURN_LIVE_COUNT;
+		pool.Free(live[slot]);
+		live[slot] = pool.Allocate();
+		((unsigned char*)live[slot])[0] = (unsigned char)i;
+	}
+	arenaSeconds = Seconds(start);
+
+	printf("Allocators: %d byte object churn, malloc/free %.1f ns, pool %.1f ns per free and allocate (pool high water %d of %d)\n",
+		CHURN_OBJECT_SIZE, heapSeconds * 1e9 / CHURN_OPERATIONS, arenaSeconds * 1e9 / CHURN_OPERATIONS, pool.GetHighWaterMark(),
+		pool.GetBlockCount());
+	pool.Shutdown();
+	delete[] live;
+
+	// Temporary arrays of mixed sizes that only live for one frame.
+	live = new void*[FRAME_ALLOCATIONS];
+	srand(1234);
+	start = std::chrono::high_resolution_clock::now();
+	for (i = 0; i < FRAME_COUNT; i++)
+	{
+		for (j = 0; j < FRAME_ALLOCATIONS; j++)
+		{
+			size = 16 + rand() % 1024;
+			live[j] = malloc(size);
+			((unsigned char*)live[j])[size - 1] = (unsigned char)j;
+		}
+		for (j = 0; j < FRAME_ALLOCATIONS; j++)
+		{
+			free(live[j]);
+		}
+	}
+	heapSeconds = Seconds(start);
+
+	frameArena.Initialize(FRAME_ALLOCATIONS * 1100);
+	srand(1234);
+	start = std::chrono::high_resolution_clock::now();
+	for (i = 0; i < FRAME_COUNT; i++)
+	{
+		frameArena.BeginFrame();
+		for (j = 0; j < FRAME_ALLOCATIONS; j++)
+		{
+			size = 16 + rand() % 1024;
+			live[j] = frameArena.Allocate(size);
+			((unsigned char*)live[j])[size - 1] = (unsigned char)j;
+		}
+	}
+	arenaSeconds = Seconds(start);
+
+	printf("Allocators: per frame temporaries, malloc/free %.1f ns, frame arena %.1f ns per allocation (frame high water %.1f KB)\n",
+		heapSeconds * 1e9 / ((double)FRAME_COUNT * FRAME_ALLOCATIONS), arenaSeconds * 1e9 / ((double)FRAME_COUNT * FRAME_ALLOCATIONS),
+		frameArena.GetHighWaterMark() / 1024.0);
+	frameArena.Shutdown();
+	delete[] live;
+
+	// Keep the filled memory observable so the loops are not optimized away.
+	if (checksum == 0xffffffff)
+	{
+		printf("Allocators: checksum %u\n", checksum);
+	}
+}
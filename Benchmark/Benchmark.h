@@ -0,0 +1,24 @@
+#pragma once
+
+class MicroBenchmark;
+
+// Headless benchmarks of the engine's CPU side systems.
+void RunSpriteAnimationBenchmark();
+void RunParticleBenchmark();
+void RunTilemapBenchmark();
+void RunCollisionBenchmark();
+void RunTextBenchmark();
+void RunAllocatorBenchmark();
+void RunHandleBenchmark();
+void RunSceneBenchmark();
+void RunStreamingBenchmark();
+void RunOverdrawBenchmark();
+void RunSpriteMeshBenchmark();
+void RunLightCullingBenchmark();
+void RunUploadRingBenchmark();
+void RunTextureUploadBenchmark();
+void RunTextureResidencyBenchmark();
+void RunTextureArrayBenchmark();
+void RunRenderGraphBenchmark();
+void RunHotPathBenchmarks(MicroBenchmark& aBenchmark);
+bool RunSteadyStateAllocationCheck();
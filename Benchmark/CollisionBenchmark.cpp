@@ -0,0 +1,180 @@
+#include "Benchmark.h"
+#include "SpatialHash.h"
+#include "SweepAndPrune.h"
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+static const int WARMUP_FRAMES = 5;
+static const int TIMED_FRAMES = 50;
+static const float FRAME_TIME = 1.0f / 60.0f;
+
+struct MovingBoxes
+{
+	std::vector<float> positions;
+	std::vector<float> sizes;
+	std::vector<float> velocities;
+	std::vector<AABB> boxes;
+	float worldSize;
+};
+
+static void CreateBoxes(MovingBoxes& aBoxes, int aCount)
+{
+	int i;
+
+	// Grow the world with the box count so the density, and with it the pairs per box, stays the same.
+	aBoxes.worldSize = 4.0f * sqrtf((float)aCount);
+	aBoxes.positions.resize(aCount * 3);
+	aBoxes.sizes.resize(aCount * 2);
+	aBoxes.velocities.resize(aCount * 2);
+	aBoxes.boxes.resize(aCount);
+
+	srand(1234);
+	for (i = 0; i < aCount; i++)
+	{
+		aBoxes.positions[i * 3 + 0] = aBoxes.worldSize * (float)rand() / (float)RAND_MAX;
+		aBoxes.positions[i * 3 + 1] = aBoxes.worldSize * (float)rand() / (float)RAND_MAX;
+		aBoxes.positions[i * 3 + 2] = 0.0f;
+		aBoxes.sizes[i * 2 + 0] = 0.5f + 1.5f * (float)rand() / (float)RAND_MAX;
+		aBoxes.sizes[i * 2 + 1] = 0.5f + 1.5f * (float)rand() / (float)RAND_MAX;
+		aBoxes.velocities[i * 2 + 0] = 4.0f * (float)rand() / (float)RAND_MAX - 2.0f;
+		aBoxes.velocities[i * 2 + 1] = 4.0f * (float)rand() / (float)RAND_MAX - 2.0f;
+	}
+}
+
+static void MoveBoxes(MovingBoxes& aBoxes)
+{
+	int i, axis, count;
+	float* position;
+
+	// Move every box and bounce it off the edges of the world.
+	count = (int)aBoxes.boxes.size();
+	for (i = 0; i < count; i++)
+	{
+		for (axis = 0; axis < 2; axis++)
+		{
+			position = &aBoxes.positions[i * 3 + axis];
+			*position += aBoxes.velocities[i * 2 + axis] * FRAME_TIME;
+			if (*position < 0.0f || *position > aBoxes.worldSize)
+			{
+				aBoxes.velocities[i * 2 + axis] = -aBoxes.velocities[i * 2 + axis];
+			}
+		}
+	}
+
+	// Boxes come from the same positions and sizes the sprite batch draws with.
+	ComputeBoxes(&aBoxes.positions[0], 3, &aBoxes.sizes[0], 2, count, &aBoxes.boxes[0]);
+}
+
+static void RunSweepAndPrune(int aCount, JobSystem* aJobSystem, const char* aName)
+{
+	MovingBoxes boxes;
+	SweepAndPrune sweepAndPrune;
+	std::vector<CollisionPair> pairs;
+	int i;
+	long long pairCount;
+	double seconds, firstSeconds;
+	std::chrono::high_resolution_clock::time_point start, end;
+
+	CreateBoxes(boxes, aCount);
+	sweepAndPrune.Initialize(aCount);
+
+	// The first update sorts from scratch, after that the order only needs fixing up.
+	start = std::chrono::high_resolution_clock::now();
+	sweepAndPrune.Update(&boxes.boxes[0], aCount);
+	end = std::chrono::high_resolution_clock::now();
+	firstSeconds = std::chrono::duration<double>(end - start).count();
+	for (i = 0; i < WARMUP_FRAMES; i++)
+	{
+		MoveBoxes(boxes);
+		sweepAndPrune.Update(&boxes.boxes[0], aCount);
+		sweepAndPrune.FindPairs(pairs, aJobSystem);
+	}
+
+	seconds = 0.0;
+	pairCount = 0;
+	for (i = 0; i < TIMED_FRAMES; i++)
+	{
+		MoveBoxes(boxes);
+
+		start = std::chrono::high_resolution_clock::now();
+		sweepAndPrune.Update(&boxes.boxes[0], aCount);
+		sweepAndPrune.FindPairs(pairs, aJobSystem);
+		end = std::chrono::high_resolution_clock::now();
+
+		seconds += std::chrono::duration<double>(end - start).count();
+		pairCount += pairs.size();
+	}
+
+	printf("Collision: sweep and prune %s, %d boxes, %.3f ms first sort, %.3f ms per frame, %lld pairs per frame, %lld swaps last frame\n",
+		aName, aCount, firstSeconds * 1000.0, seconds * 1000.0 / TIMED_FRAMES, pairCount / TIMED_FRAMES, sweepAndPrune.GetSwapCount());
+
+	sweepAndPrune.Shutdown();
+}
+
+static void RunSpatialHash(int aCount, JobSystem* aJobSystem, const char* aName)
+{
+	MovingBoxes boxes;
+	SpatialHash spatialHash;
+	std::vector<CollisionPair> pairs;
+	int i;
+	long long pairCount;
+	double seconds;
+	std::chrono::high_resolution_clock::time_point start, end;
+
+	CreateBoxes(boxes, aCount);
+
+	// Cells about the size of the largest box keep the number of cells per box low.
+	spatialHash.Initialize(aCount, 2.0f, aCount * 2);
+
+	for (i = 0; i < WARMUP_FRAMES; i++)
+	{
+		MoveBoxes(boxes);
+		spatialHash.Update(&boxes.boxes[0], aCount);
+		spatialHash.FindPairs(pairs, aJobSystem);
+	}
+
+	seconds = 0.0;
+	pairCount = 0;
+	for (i = 0; i < TIMED_FRAMES; i++)
+	{
+		MoveBoxes(boxes);
+
+		start = std::chrono::high_resolution_clock::now();
+		spatialHash.Update(&boxes.boxes[0], aCount);
+		spatialHash.FindPairs(pairs, aJobSystem);
+		end = std::chrono::high_resolution_clock::now();
+
+		seconds += std::chrono::duration<double>(end - start).count();
+		pairCount += pairs.size();
+	}
+
+	printf("Collision: spatial hash %s, %d boxes, %.3f ms per frame, %lld pairs per frame, %d cell entries\n", aName, aCount,
+		seconds * 1000.0 / TIMED_FRAMES, pairCount / TIMED_FRAMES, spatialHash.GetEntryCount());
+
+	spatialHash.Shutdown();
+}
+
+void RunCollisionBenchmark()
+{
+	JobSystem jobSystem;
+	int counts[2] = { 10000, 100000 };
+	int i;
+
+	jobSystem.Initialize(0);
+
+	for (i = 0; i < 2; i++)
+	{
+		RunSweepAndPrune(counts[i], nullptr, "single threaded");
+		RunSpatialHash(counts[i], nullptr, "single threaded");
+		if (jobSystem.GetThreadCount() > 1)
+		{
+			RunSweepAndPrune(counts[i], &jobSystem, "multithreaded");
+			RunSpatialHash(counts[i], &jobSystem, "multithreaded");
+		}
+	}
+
+	jobSystem.Shutdown();
+}
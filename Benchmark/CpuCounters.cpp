@@ -0,0 +1,106 @@
+#include "CpuCounters.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(__linux__)
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Opens a counter of the calling thread on any CPU, counting user space only so no extra privileges are needed.
+static int OpenCounter(unsigned long long aConfig)
+{
+	perf_event_attr attributes;
+
+	memset(&attributes, 0, sizeof(attributes));
+	attributes.type = PERF_TYPE_HARDWARE;
+	attributes.size = sizeof(attributes);
+	attributes.config = aConfig;
+	attributes.exclude_kernel = 1;
+	attributes.exclude_hv = 1;
+	return (int)syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0);
+}
+
+static unsigned long long ReadCounter(int aCounter)
+{
+	unsigned long long value;
+
+	if (read(aCounter, &value, sizeof(value)) != sizeof(value))
+	{
+		return 0;
+	}
+	return value;
+}
+#endif
+
+CpuCounters::CpuCounters()
+{
+	myCyclesCounter = -1;
+	myInstructionsCounter = -1;
+	myHasCycles = false;
+	myHasInstructions = false;
+}
+
+CpuCounters::~CpuCounters()
+{
+}
+
+void CpuCounters::Initialize()
+{
+#if defined(_WIN32)
+	myHasCycles = true;
+#elif defined(__linux__)
+	myCyclesCounter = OpenCounter(PERF_COUNT_HW_CPU_CYCLES);
+	myInstructionsCounter = OpenCounter(PERF_COUNT_HW_INSTRUCTIONS);
+	myHasCycles = myCyclesCounter >= 0;
+	myHasInstructions = myInstructionsCounter >= 0;
+#endif
+}
+
+void CpuCounters::Shutdown()
+{
+#if defined(__linux__)
+	if (myCyclesCounter >= 0)
+	{
+		close(myCyclesCounter);
+	}
+	if (myInstructionsCounter >= 0)
+	{
+		close(myInstructionsCounter);
+	}
+#endif
+	myCyclesCounter = -1;
+	myInstructionsCounter = -1;
+	myHasCycles = false;
+	myHasInstructions = false;
+}
+
+void CpuCounters::Read(Sample& aSample)
+{
+#if defined(_WIN32)
+	ULONG64 cycles;
+
+	QueryThreadCycleTime(GetCurrentThread(), &cycles);
+	aSample.cycles = cycles;
+	aSample.instructions = 0;
+#elif defined(__linux__)
+	aSample.cycles = myHasCycles ? ReadCounter(myCyclesCounter) : 0;
+	aSample.instructions = myHasInstructions ? ReadCounter(myInstructionsCounter) : 0;
+#else
+	aSample.cycles = 0;
+	aSample.instructions = 0;
+#endif
+}
+
+bool CpuCounters::HasCycles()
+{
+	return myHasCycles;
+}
+
+bool CpuCounters::HasInstructions()
+{
+	return myHasInstructions;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+// Hardware counters of the calling thread, where the platform exposes them.
+// Linux reads cycles and retired instructions through perf events, which may be refused in containers or by
+// the kernel's paranoia setting. Windows only has the thread cycle count. Missing counters are reported as such.
+class CpuCounters
+{
+public:
+	struct Sample
+	{
+		unsigned long long cycles;
+		unsigned long long instructions;
+	};
+
+	CpuCounters();
+	CpuCounters(const CpuCounters& aCpuCounters) = delete;
+	~CpuCounters();
+
+	void Initialize();
+	void Shutdown();
+
+	void Read(Sample& aSample);
+
+	bool HasCycles();
+	bool HasInstructions();
+
+private:
+	int myCyclesCounter;
+	int myInstructionsCounter;
+	bool myHasCycles;
+	bool myHasInstructions;
+};
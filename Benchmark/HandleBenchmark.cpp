@@ -0,0 +1,223 @@
+#include "Benchmark.h"
+#include "HandleTable.h"
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+static const int MESH_COUNT = 65536;
+static const int MATERIAL_COUNT = 64;
+static const int COMMAND_COUNT = 200000;
+static const int FRAME_COUNT = 20;
+static const int REMOVED_MESH_STRIDE = 10;
+
+// Stand in for a model, roughly the size of one with its buffers, texture and counts.
+struct BenchmarkMesh
+{
+	int id;
+	int indexCount;
+	void* buffers[4];
+	float bounds[6];
+};
+
+struct BenchmarkMaterial
+{
+	int id;
+	void* shader;
+	void* texture;
+};
+
+// A draw as the renderer recorded it before handles, pointers to wherever the resources happened to be allocated.
+struct PointerCommand
+{
+	BenchmarkMaterial* material;
+	BenchmarkMesh* mesh;
+};
+
+// The same draw with a precomputed key and handles into dense tables.
+struct HandleCommand
+{
+	unsigned int sortKey;
+	Handle<BenchmarkMaterial> material;
+	Handle<BenchmarkMesh> mesh;
+};
+
+static double Seconds(std::chrono::high_resolution_clock::time_point aStart)
+{
+	return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - aStart).count();
+}
+
+void RunHandleBenchmark()
+{
+	HandleTable<BenchmarkMesh> meshTable;
+	HandleTable<BenchmarkMaterial> materialTable;
+	BenchmarkMesh** meshes;
+	BenchmarkMaterial** materials;
+	Handle<BenchmarkMesh>* meshHandles;
+	Handle<BenchmarkMaterial>* materialHandles;
+	PointerCommand* pointerCommands;
+	PointerCommand* pointerFrame;
+	HandleCommand* handleCommands;
+	HandleCommand* handleFrame;
+	BenchmarkMesh mesh;
+	BenchmarkMaterial material;
+	BenchmarkMesh* resolvedMesh;
+	BenchmarkMaterial* resolvedMaterial;
+	int* order;
+	int i, frame, mi, ti, skipped;
+	long long indexSum;
+	double pointerSeconds, handleSeconds;
+	std::chrono::high_resolution_clock::time_point start;
+
+	meshes = new BenchmarkMesh*[MESH_COUNT];
+	materials = new BenchmarkMaterial*[MATERIAL_COUNT];
+	meshHandles = new Handle<BenchmarkMesh>[MESH_COUNT];
+	materialHandles = new Handle<BenchmarkMaterial>[MATERIAL_COUNT];
+	order = new int[MESH_COUNT];
+
+	// Allocate the pointer meshes one by one in shuffled order with some churn in between,
+	// the way resources loaded over a session end up scattered over the heap.
+	for (i = 0; i < MESH_COUNT; i++)
+	{
+		order[i] = i;
+	}
+	srand(1234);
+	for (i = MESH_COUNT - 1; i > 0; i--)
+	{
+		std::swap(order[i], order[rand() % (i + 1)]);
+	}
+	for (i = 0; i < MESH_COUNT; i++)
+	{
+		meshes[order[i]] = new BenchmarkMesh();
+		meshes[order[i]]->id = order[i];
+		meshes[order[i]]->indexCount = 6 + order[i] % 7;
+		delete[] new char[16 + rand() % 256];
+	}
+	for (i = 0; i < MATERIAL_COUNT; i++)
+	{
+		materials[i] = new BenchmarkMaterial();
+		materials[i]->id = i;
+	}
+
+	// Store the same resources by value in the handle tables.
+	meshTable.Initialize(MESH_COUNT);
+	materialTable.Initialize(MATERIAL_COUNT);
+	for (i = 0; i < MESH_COUNT; i++)
+	{
+		mesh = *meshes[i];
+		meshHandles[i] = meshTable.Add(mesh);
+	}
+	for (i = 0; i < MATERIAL_COUNT; i++)
+	{
+		material = *materials[i];
+		materialHandles[i] = materialTable.Add(material);
+	}
+
+	// Record the same random draw list both ways.
+	pointerCommands = new PointerCommand[COMMAND_COUNT];
+	pointerFrame = new PointerCommand[COMMAND_COUNT];
+	handleCommands = new HandleCommand[COMMAND_COUNT];
+	handleFrame = new HandleCommand[COMMAND_COUNT];
+	for (i = 0; i < COMMAND_COUNT; i++)
+	{
+		mi = rand() % MESH_COUNT;
+		ti = rand() % MATERIAL_COUNT;
+		pointerCommands[i].material = materials[ti];
+		pointerCommands[i].mesh = meshes[mi];
+		handleCommands[i].sortKey = (materialHandles[ti].GetIndex() << 20) | meshHandles[mi].GetIndex();
+		handleCommands[i].material = materialHandles[ti];
+		handleCommands[i].mesh = meshHandles[mi];
+	}
+
+	// Sort by material then mesh and walk the list, following the pointers to compare and to draw.
+	indexSum = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (frame = 0; frame < FRAME_COUNT; frame++)
+	{
+		std::copy(pointerCommands, pointerCommands + COMMAND_COUNT, pointerFrame);
+		std::sort(pointerFrame, pointerFrame + COMMAND_COUNT, [](const PointerCommand& aLeft, const PointerCommand& aRight)
+		{
+			if (aLeft.material->id != aRight.material->id)
+			{
+				return aLeft.material->id < aRight.material->id;
+			}
+			return aLeft.mesh->id < aRight.mesh->id;
+		});
+		for (i = 0; i < COMMAND_COUNT; i++)
+		{
+			indexSum += pointerFrame[i].mesh->indexCount + (long long)pointerFrame[i].material->id;
+		}
+	}
+	pointerSeconds = Seconds(start);
+
+	// Sort the plain keys and resolve the handles through the tables.
+	start = std::chrono::high_resolution_clock::now();
+	for (frame = 0; frame < FRAME_COUNT; frame++)
+	{
+		std::copy(handleCommands, handleCommands + COMMAND_COUNT, handleFrame);
+		std::sort(handleFrame, handleFrame + COMMAND_COUNT, [](const HandleCommand& aLeft, const HandleCommand& aRight)
+		{
+			return aLeft.sortKey < aRight.sortKey;
+		});
+		for (i = 0; i < COMMAND_COUNT; i++)
+		{
+			resolvedMesh = meshTable.Get(handleFrame[i].mesh);
+			resolvedMaterial = materialTable.Get(handleFrame[i].material);
+			indexSum -= resolvedMesh->indexCount + (long long)resolvedMaterial->id;
+		}
+	}
+	handleSeconds = Seconds(start);
+
+	printf("Handles: %d draw commands sorted and resolved, pointers %.2f ms, handles %.2f ms per frame (%d bytes vs %d bytes per command)\n",
+		COMMAND_COUNT, pointerSeconds * 1000.0 / FRAME_COUNT, handleSeconds * 1000.0 / FRAME_COUNT, (int)sizeof(PointerCommand),
+		(int)sizeof(HandleCommand));
+
+	// Remove every tenth mesh, then refill the freed slots so stale handles point at live but different meshes.
+	for (i = 0; i < MESH_COUNT; i += REMOVED_MESH_STRIDE)
+	{
+		meshTable.Remove(meshHandles[i]);
+	}
+	for (i = 0; i < MESH_COUNT; i += REMOVED_MESH_STRIDE)
+	{
+		mesh = *meshes[i];
+		meshTable.Add(mesh);
+	}
+
+	// Every command that still refers to a removed mesh must be caught.
+	skipped = 0;
+	for (i = 0; i < COMMAND_COUNT; i++)
+	{
+		if (meshTable.Get(handleCommands[i].mesh) == nullptr)
+		{
+			skipped++;
+		}
+	}
+	printf("Handles: %d of %d commands caught with stale handles after removing every %dth mesh (%d stale lookups)\n", skipped,
+		COMMAND_COUNT, REMOVED_MESH_STRIDE, meshTable.GetStaleLookupCount());
+
+	// Keep the sums observable so the loops are not optimized away.
+	if (indexSum != 0)
+	{
+		printf("Handles: pointer and handle walks disagree by %lld\n", indexSum);
+	}
+
+	meshTable.Shutdown();
+	materialTable.Shutdown();
+	for (i = 0; i < MESH_COUNT; i++)
+	{
+		delete meshes[i];
+	}
+	for (i = 0; i < MATERIAL_COUNT; i++)
+	{
+		delete materials[i];
+	}
+	delete[] handleFrame;
+	delete[] handleCommands;
+	delete[] pointerFrame;
+	delete[] pointerCommands;
+	delete[] order;
+	delete[] materialHandles;
+	delete[] meshHandles;
+	delete[] materials;
+	delete[] meshes;
+}
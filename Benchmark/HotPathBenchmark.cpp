@@ -0,0 +1,340 @@
+#include "Benchmark.h"
+#include "MicroBenchmark.h"
+#include "Collision.h"
+#include "FrameArena.h"
+#include "PoolAllocator.h"
+#include "RenderCommand.h"
+#include "SpriteAnimation.h"
+#include "SpriteQuads.h"
+#include "Targa.h"
+#include "Tilemap.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#if defined(_WIN32)
+#include "Camera.h"
+#endif
+
+static const int TARGA_SIZE = 1024;
+static const int CAMERA_UPDATES = 10000;
+static const int SPRITE_COUNT = 4096;
+static const int COMMAND_COUNT = 100000;
+static const int CULL_BOX_COUNT = 100000;
+static const float CULL_WORLD_SIZE = 1000.0f;
+static const float CULL_VIEW_SIZE = 100.0f;
+static const int CULL_TILEMAP_SIZE = 1024;
+static const int CULL_TILEMAP_VIEWS = 10000;
+static const int FRAME_ALLOCATIONS = 1000;
+static const int POOL_BLOCKS = 10000;
+static const int POOL_OPERATIONS = 100000;
+
+// Keeps results observable so the timed loops are not optimized away.
+static unsigned long long sink = 0;
+
+static float RandomFloat(float aMin, float aMax)
+{
+	return aMin + (aMax - aMin) * (float)rand() / (float)RAND_MAX;
+}
+
+// The byte by byte flip and swizzle textures were loaded with before, as a reference for the word wide one.
+static void SwizzleBytewise(const unsigned char* aSource, int aWidth, int aHeight, unsigned char* aDestination)
+{
+	int i, j, k, index;
+
+	index = 0;
+	k = (aWidth * aHeight * 4) - (aWidth * 4);
+	for (j = 0; j < aHeight; j++)
+	{
+		for (i = 0; i < aWidth; i++)
+		{
+			aDestination[index + 0] = aSource[k + 2];
+			aDestination[index + 1] = aSource[k + 1];
+			aDestination[index + 2] = aSource[k + 0];
+			aDestination[index + 3] = aSource[k + 3];
+			k += 4;
+			index += 4;
+		}
+		k -= (aWidth * 8);
+	}
+}
+
+static void RunTargaBenchmarks(MicroBenchmark& aBenchmark)
+{
+	std::vector<unsigned char> file, pixels;
+	TargaHeader header;
+	int i, width, height;
+
+	// Build an uncompressed 32 bit targa file in memory so disk speed does not enter the measurement.
+	memset(&header, 0, sizeof(header));
+	header.data1[2] = 2;
+	header.width = TARGA_SIZE;
+	header.height = TARGA_SIZE;
+	header.bpp = 32;
+	file.resize(sizeof(header) + TARGA_SIZE * TARGA_SIZE * 4);
+	memcpy(&file[0], &header, sizeof(header));
+	for (i = sizeof(header); i < (int)file.size(); i++)
+	{
+		file[i] = (unsigned char)rand();
+	}
+	pixels.resize(TARGA_SIZE * TARGA_SIZE * 4);
+
+	aBenchmark.Run("targa/decode_1024", TARGA_SIZE * TARGA_SIZE, [&]()
+	{
+		DecodeTarga(&file[0], file.size(), &pixels[0], pixels.size(), width, height);
+		sink += pixels[width * 4 + 1];
+	});
+	aBenchmark.Run("targa/swizzle_1024", TARGA_SIZE * TARGA_SIZE, [&]()
+	{
+		SwizzleRedBlue(&file[sizeof(header)], &pixels[0], TARGA_SIZE * TARGA_SIZE);
+		sink += pixels[7];
+	});
+	aBenchmark.Run("targa/swizzle_1024_bytewise_reference", TARGA_SIZE * TARGA_SIZE, [&]()
+	{
+		SwizzleBytewise(&file[sizeof(header)], TARGA_SIZE, TARGA_SIZE, &pixels[0]);
+		sink += pixels[7];
+	});
+}
+
+static void RunCameraBenchmarks(MicroBenchmark& aBenchmark)
+{
+#if defined(_WIN32)
+	Camera camera;
+	XMMATRIX viewMatrix, projectionMatrix, viewProjectionMatrix;
+	XMFLOAT4X4 stored;
+	float left, bottom, right, top;
+
+	projectionMatrix = XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 1000.0f);
+
+	// Move the camera every update so the view matrix is rebuilt from scratch each time.
+	aBenchmark.Run("camera/update_view", CAMERA_UPDATES, [&]()
+	{
+		int i;
+
+		for (i = 0; i < CAMERA_UPDATES; i++)
+		{
+			camera.SetPosition((float)(i & 255) * 0.01f, (float)(i >> 8) * 0.01f, -5.0f);
+			camera.Render();
+			camera.GetViewMatrix(viewMatrix);
+			camera.GetViewRect(XM_PIDIV4, 16.0f / 9.0f, 1.0f, left, bottom, right, top);
+		}
+		XMStoreFloat4x4(&stored, viewMatrix);
+		sink += (unsigned long long)(stored._41 + left);
+	});
+	aBenchmark.Run("matrix/view_projection", CAMERA_UPDATES, [&]()
+	{
+		int i;
+
+		viewProjectionMatrix = XMMatrixIdentity();
+		for (i = 0; i < CAMERA_UPDATES; i++)
+		{
+			viewProjectionMatrix = XMMatrixMultiply(viewMatrix, projectionMatrix);
+			viewMatrix = XMMatrixTranspose(viewProjectionMatrix);
+		}
+		XMStoreFloat4x4(&stored, viewProjectionMatrix);
+		sink += (unsigned long long)stored._11;
+	});
+#else
+	// The camera is built on DirectXMath, which only ships with the Windows SDK.
+	aBenchmark.Skip("camera/update_view", "needs DirectXMath");
+	aBenchmark.Skip("matrix/view_projection", "needs DirectXMath");
+#endif
+}
+
+static void RunSpriteBenchmarks(MicroBenchmark& aBenchmark)
+{
+	SpriteAnimation animation;
+	std::vector<float> positions, sizes;
+	std::vector<SpriteVertex> vertices;
+	int i, clip;
+
+	// A sheet of sprites playing the same 4x4 clip out of step with each other.
+	animation.Initialize(SPRITE_COUNT);
+	clip = animation.AddGridClip(4, 4, 0, 16, 0.1f, true);
+	positions.resize(SPRITE_COUNT * 2);
+	sizes.resize(SPRITE_COUNT * 2);
+	for (i = 0; i < SPRITE_COUNT; i++)
+	{
+		animation.CreateInstance(clip, RandomFloat(0.5f, 1.5f));
+		positions[i * 2 + 0] = RandomFloat(-100.0f, 100.0f);
+		positions[i * 2 + 1] = RandomFloat(-100.0f, 100.0f);
+		sizes[i * 2 + 0] = 1.0f;
+		sizes[i * 2 + 1] = 1.0f;
+	}
+	vertices.resize(SPRITE_COUNT * 4);
+
+	aBenchmark.Run("sprites/write_quads_4096", SPRITE_COUNT, [&]()
+	{
+		WriteSpriteQuads(&positions[0], 2, &sizes[0], 2, animation.GetUVRects(), SPRITE_COUNT, &vertices[0]);
+		sink += vertices[5].u;
+	});
+	aBenchmark.Run("sprites/animate_and_write_4096", SPRITE_COUNT, [&]()
+	{
+		animation.Update(1.0f / 60.0f);
+		WriteSpriteQuads(&positions[0], 2, &sizes[0], 2, animation.GetUVRects(), SPRITE_COUNT, &vertices[0]);
+		sink += vertices[5].u;
+	});
+
+	animation.Shutdown();
+}
+
+static void RunSortBenchmarks(MicroBenchmark& aBenchmark)
+{
+	std::vector<RenderCommand> recorded, commands;
+	RenderCommand command;
+	int i;
+
+	// Draws spread over 64 shaders, 1024 textures and 4096 models, recorded in random order as a frame would.
+	recorded.resize(COMMAND_COUNT);
+	for (i = 0; i < COMMAND_COUNT; i++)
+	{
+		command.shader.value = (1u << HANDLE_INDEX_BITS) | (unsigned int)(rand() % 64);
+		command.texture.value = (1u << HANDLE_INDEX_BITS) | (unsigned int)(rand() % 1024);
+		command.model.value = (1u << HANDLE_INDEX_BITS) | (unsigned int)(rand() % 4096);
+		command.sortKey = MakeSortKey(MATERIAL_OPAQUE, 0.0f, command.shader, command.texture, command.model);
+		recorded[i] = command;
+	}
+	commands.resize(COMMAND_COUNT);
+
+	aBenchmark.Run("sort/render_commands_100k", COMMAND_COUNT, [&]()
+	{
+		commands = recorded;
+		SortRenderCommands(&commands[0], COMMAND_COUNT);
+		sink += commands[COMMAND_COUNT / 2].sortKey;
+	});
+}
+
+static void RunCullBenchmarks(MicroBenchmark& aBenchmark)
+{
+	std::vector<AABB> boxes;
+	std::vector<int> visible;
+	AABB view;
+	Tilemap tilemap;
+	float x, y;
+	int i;
+
+	// Boxes scattered over a large world, the view sees about one percent of it.
+	boxes.resize(CULL_BOX_COUNT);
+	for (i = 0; i < CULL_BOX_COUNT; i++)
+	{
+		x = RandomFloat(0.0f, CULL_WORLD_SIZE);
+		y = RandomFloat(0.0f, CULL_WORLD_SIZE);
+		boxes[i].minX = x;
+		boxes[i].minY = y;
+		boxes[i].maxX = x + RandomFloat(0.5f, 2.0f);
+		boxes[i].maxY = y + RandomFloat(0.5f, 2.0f);
+	}
+	visible.resize(CULL_BOX_COUNT);
+	view.minX = (CULL_WORLD_SIZE - CULL_VIEW_SIZE) * 0.5f;
+	view.minY = view.minX;
+	view.maxX = view.minX + CULL_VIEW_SIZE;
+	view.maxY = view.minY + CULL_VIEW_SIZE;
+
+	aBenchmark.Run("cull/boxes_100k", CULL_BOX_COUNT, [&]()
+	{
+		sink += CullBoxes(&boxes[0], CULL_BOX_COUNT, view, &visible[0]);
+	});
+
+	// Chunk ranges of a tilemap for a camera panning over it, as the tilemap renderer asks for every frame.
+	tilemap.Initialize(CULL_TILEMAP_SIZE, CULL_TILEMAP_SIZE, 1.0f, 0.0f, 0.0f, 4, 4);
+	aBenchmark.Run("cull/tilemap_chunks", CULL_TILEMAP_VIEWS, [&]()
+	{
+		int step, minX, minY, maxX, maxY;
+		float left;
+
+		for (step = 0; step < CULL_TILEMAP_VIEWS; step++)
+		{
+			left = (float)(step % CULL_TILEMAP_SIZE);
+			tilemap.GetChunksInRect(left, left * 0.5f, left + 40.0f, left * 0.5f + 22.5f, minX, minY, maxX, maxY);
+			sink += (maxX - minX + 1) * (maxY - minY + 1);
+		}
+	});
+	tilemap.Shutdown();
+}
+
+static void RunAllocatorPathBenchmarks(MicroBenchmark& aBenchmark)
+{
+	FrameArena frameArena;
+	PoolAllocator pool;
+	std::vector<void*> live;
+	int i;
+
+	// A frame's worth of small temporaries from the frame arena.
+	frameArena.Initialize(FRAME_ALLOCATIONS * 256);
+	aBenchmark.Run("alloc/frame_arena_1000", FRAME_ALLOCATIONS, [&]()
+	{
+		int j;
+
+		frameArena.BeginFrame();
+		for (j = 0; j < FRAME_ALLOCATIONS; j++)
+		{
+			sink += (size_t)frameArena.Allocate(16 + (j & 127)) & 1;
+		}
+	});
+	frameArena.Shutdown();
+
+	// Freeing and allocating objects of a half full pool in random order.
+	pool.Initialize(64, POOL_BLOCKS);
+	live.resize(POOL_BLOCKS / 2);
+	for (i = 0; i < POOL_BLOCKS / 2; i++)
+	{
+		live[i] = pool.Allocate();
+	}
+	aBenchmark.Run("alloc/pool_churn_100k", POOL_OPERATIONS, [&]()
+	{
+		int j, slot;
+
+		for (j = 0; j < POOL_OPERATIONS; j++)
+		{
+			slot = (j * 7919) % (POOL_BLOCKS / 2);
+			pool.Free(live[slot]);
+			live[slot] = pool.Allocate();
+		}
+		sink += (size_t)live[0] & 1;
+	});
+	for (i = 0; i < POOL_BLOCKS / 2; i++)
+	{
+		pool.Free(live[i]);
+	}
+
+	// The same pattern through the heap for reference.
+	for (i = 0; i < POOL_BLOCKS / 2; i++)
+	{
+		live[i] = malloc(64);
+	}
+	aBenchmark.Run("alloc/malloc_churn_100k_reference", POOL_OPERATIONS, [&]()
+	{
+		int j, slot;
+
+		for (j = 0; j < POOL_OPERATIONS; j++)
+		{
+			slot = (j * 7919) % (POOL_BLOCKS / 2);
+			free(live[slot]);
+			live[slot] = malloc(64);
+		}
+		sink += (size_t)live[0] & 1;
+	});
+	for (i = 0; i < POOL_BLOCKS / 2; i++)
+	{
+		free(live[i]);
+	}
+	pool.Shutdown();
+}
+
+void RunHotPathBenchmarks(MicroBenchmark& aBenchmark)
+{
+	srand(1234);
+
+	RunTargaBenchmarks(aBenchmark);
+	RunCameraBenchmarks(aBenchmark);
+	RunSpriteBenchmarks(aBenchmark);
+	RunSortBenchmarks(aBenchmark);
+	RunCullBenchmarks(aBenchmark);
+	RunAllocatorPathBenchmarks(aBenchmark);
+
+	// Keep the sink observable.
+	if (sink == 1)
+	{
+		printf("\n");
+	}
+}
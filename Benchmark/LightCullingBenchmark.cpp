@@ -0,0 +1,117 @@
+#include "Benchmark.h"
+#include "LightGrid.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const int SCREEN_WIDTH = 1920;
+static const int SCREEN_HEIGHT = 1080;
+static const int LIGHT_COUNT = 1000;
+static const float MIN_LIGHT_RADIUS = 24.0f;
+static const float MAX_LIGHT_RADIUS = 128.0f;
+static const int MAX_LIGHTS_PER_TILE = 256;
+static const int CULL_COUNT = 200;
+
+static void AddLights(LightGrid& aLightGrid)
+{
+	PointLight light;
+	int i;
+
+	// The same scattered lights for every tile size, some of them reaching past the edges of the screen.
+	srand(4321);
+	for (i = 0; i < LIGHT_COUNT; i++)
+	{
+		light.x = (float)(rand() % (SCREEN_WIDTH + 200)) - 100.0f;
+		light.y = (float)(rand() % (SCREEN_HEIGHT + 200)) - 100.0f;
+		light.radius = MIN_LIGHT_RADIUS + (MAX_LIGHT_RADIUS - MIN_LIGHT_RADIUS) * (float)(rand() % 1000) / 1000.0f;
+		light.red = 1.0f;
+		light.green = 0.8f;
+		light.blue = 0.5f;
+		aLightGrid.AddLight(light);
+	}
+}
+
+static bool SameTiles(LightGrid& aLightGrid, const unsigned int* aRanges, const unsigned int* aLights, int aLightCount)
+{
+	const unsigned int* lights;
+	int count, tileCount;
+
+	tileCount = aLightGrid.GetTileCountX() * aLightGrid.GetTileCountY();
+	lights = aLightGrid.GetTileLights(count);
+	return count == aLightCount && memcmp(aLightGrid.GetTileRanges(), aRanges, sizeof(unsigned int) * 2 * tileCount) == 0 &&
+		memcmp(lights, aLights, sizeof(unsigned int) * count) == 0;
+}
+
+static void RunLightCulling(int aTileSize)
+{
+	LightGrid lightGrid;
+	unsigned int* ranges;
+	unsigned int* lights;
+	const unsigned int* tileLights;
+	int i, tileCount, lightCount, maxTileLights;
+	double scalarSeconds, simdSeconds;
+	bool same;
+	std::chrono::high_resolution_clock::time_point start, end;
+
+	if (!lightGrid.Initialize(SCREEN_WIDTH, SCREEN_HEIGHT, aTileSize, LIGHT_COUNT, MAX_LIGHTS_PER_TILE))
+	{
+		printf("Light culling: could not initialize\n");
+		return;
+	}
+	AddLights(lightGrid);
+	tileCount = lightGrid.GetTileCountX() * lightGrid.GetTileCountY();
+
+	// Bin the lights one light at a time and four at a time in turn, so a change of clock speed during the run weighs on both
+	// the same. The last tiles of the scalar path are kept to check the four wide tests against.
+	scalarSeconds = 0.0;
+	simdSeconds = 0.0;
+	for (i = 0; i < CULL_COUNT; i++)
+	{
+		start = std::chrono::high_resolution_clock::now();
+		lightGrid.CullSimd();
+		end = std::chrono::high_resolution_clock::now();
+		simdSeconds += std::chrono::duration<double>(end - start).count();
+
+		start = std::chrono::high_resolution_clock::now();
+		lightGrid.CullScalar();
+		end = std::chrono::high_resolution_clock::now();
+		scalarSeconds += std::chrono::duration<double>(end - start).count();
+	}
+	ranges = new unsigned int[tileCount * 2];
+	memcpy(ranges, lightGrid.GetTileRanges(), sizeof(unsigned int) * 2 * tileCount);
+	lights = new unsigned int[tileCount * MAX_LIGHTS_PER_TILE];
+	tileLights = lightGrid.GetTileLights(lightCount);
+	memcpy(lights, tileLights, sizeof(unsigned int) * lightCount);
+
+	// Bin them four at a time once more to compare.
+	lightGrid.CullSimd();
+	same = SameTiles(lightGrid, ranges, lights, lightCount);
+
+	// The busiest tile decides how long the slowest pixels take.
+	maxTileLights = 0;
+	for (i = 0; i < tileCount; i++)
+	{
+		maxTileLights = (int)ranges[i * 2 + 1] > maxTileLights ? (int)ranges[i * 2 + 1] : maxTileLights;
+	}
+
+	printf("Light culling: %2dpx tiles (%5d), %5.1f lights per pixel (at most %3d, %d dropped), scalar %.3f ms, SIMD %.3f ms (%.2fx), "
+		"Cull uses %s%s\n", aTileSize, tileCount, (double)lightCount / tileCount, maxTileLights, lightGrid.GetDroppedCount(),
+		scalarSeconds * 1000.0 / CULL_COUNT, simdSeconds * 1000.0 / CULL_COUNT, scalarSeconds / simdSeconds,
+		aTileSize < LIGHT_SIMD_MIN_TILE_SIZE ? "scalar" : "SIMD", same ? "" : ", MISMATCH");
+
+	delete[] lights;
+	delete[] ranges;
+	lightGrid.Shutdown();
+}
+
+void RunLightCullingBenchmark()
+{
+	// Without tiles every pixel would evaluate every light.
+	printf("Light culling: %d lights of %.0f to %.0f px on %dx%d, %d lights per pixel untiled\n", LIGHT_COUNT, MIN_LIGHT_RADIUS,
+		MAX_LIGHT_RADIUS, SCREEN_WIDTH, SCREEN_HEIGHT, LIGHT_COUNT);
+	RunLightCulling(8);
+	RunLightCulling(16);
+	RunLightCulling(32);
+	RunLightCulling(64);
+}
@@ -0,0 +1,196 @@
+#include "MicroBenchmark.h"
+#include <algorithm>
+#include <stdio.h>
+
+MicroBenchmark::MicroBenchmark()
+{
+	myStartCounters.cycles = 0;
+	myStartCounters.instructions = 0;
+	myWarmup = 0;
+	myRepetitions = 0;
+}
+
+MicroBenchmark::~MicroBenchmark()
+{
+}
+
+bool MicroBenchmark::Initialize(const char* aFilter, int aWarmup, int aRepetitions)
+{
+	if (aWarmup < 0 || aRepetitions <= 0)
+	{
+		return false;
+	}
+	myFilter = aFilter != nullptr ? aFilter : "";
+	myWarmup = aWarmup;
+	myRepetitions = aRepetitions;
+
+	// Reserve the samples up front so timing never waits on the heap.
+	mySamples.reserve(myRepetitions);
+	myCycleSamples.reserve(myRepetitions);
+	myInstructionSamples.reserve(myRepetitions);
+
+	myCounters.Initialize();
+	printf("Micro benchmarks: %d warm-up runs, %d repetitions, cycle counter %s, instruction counter %s\n", myWarmup, myRepetitions,
+		myCounters.HasCycles() ? "on" : "unavailable", myCounters.HasInstructions() ? "on" : "unavailable");
+
+	return true;
+}
+
+void MicroBenchmark::Shutdown()
+{
+	myCounters.Shutdown();
+	mySamples.clear();
+	myCycleSamples.clear();
+	myInstructionSamples.clear();
+	myResults.clear();
+	mySkipped.clear();
+}
+
+bool MicroBenchmark::IsEnabled(const char* aName)
+{
+	return myFilter.empty() || std::string(aName).find(myFilter) != std::string::npos;
+}
+
+void MicroBenchmark::Skip(const char* aName, const char* aReason)
+{
+	if (!IsEnabled(aName))
+	{
+		return;
+	}
+	printf("  %-40s skipped, %s\n", aName, aReason);
+	mySkipped.push_back(aName);
+}
+
+const std::vector<MicroBenchmark::Result>& MicroBenchmark::GetResults()
+{
+	return myResults;
+}
+
+bool MicroBenchmark::WriteJson(const char* aPath)
+{
+	FILE* file;
+	unsigned int i;
+	const Result* result;
+
+#if defined(_WIN32)
+	if (fopen_s(&file, aPath, "w") != 0)
+	{
+		file = nullptr;
+	}
+#else
+	file = fopen(aPath, "w");
+#endif
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	// Times are in nanoseconds per repetition, counters are medians per repetition or null where unavailable.
+	fprintf(file, "{\n  \"warmup\": %d,\n  \"repetitions\": %d,\n", myWarmup, myRepetitions);
+	fprintf(file, "  \"counters\": { \"cycles\": %s, \"instructions\": %s },\n", myCounters.HasCycles() ? "true" : "false",
+		myCounters.HasInstructions() ? "true" : "false");
+	fprintf(file, "  \"benchmarks\": [\n");
+	for (i = 0; i < myResults.size(); i++)
+	{
+		result = &myResults[i];
+		fprintf(file, "    { \"name\": \"%s\", \"items\": %d, \"min_ns\": %.1f, \"median_ns\": %.1f, \"p99_ns\": %.1f, \"mean_ns\": %.1f, "
+			"\"median_ns_per_item\": %.3f, ", result->name.c_str(), result->items, result->minimum, result->median,
+			result->percentile99, result->mean, result->median / result->items);
+		if (myCounters.HasCycles())
+		{
+			fprintf(file, "\"cycles\": %.0f, ", result->cycles);
+		}
+		else
+		{
+			fprintf(file, "\"cycles\": null, ");
+		}
+		if (myCounters.HasInstructions())
+		{
+			fprintf(file, "\"instructions\": %.0f }", result->instructions);
+		}
+		else
+		{
+			fprintf(file, "\"instructions\": null }");
+		}
+		fprintf(file, "%s\n", i + 1 < myResults.size() ? "," : "");
+	}
+	fprintf(file, "  ],\n  \"skipped\": [");
+	for (i = 0; i < mySkipped.size(); i++)
+	{
+		fprintf(file, "%s\"%s\"", i > 0 ? ", " : "", mySkipped[i].c_str());
+	}
+	fprintf(file, "]\n}\n");
+
+	return fclose(file) == 0;
+}
+
+void MicroBenchmark::StartSample()
+{
+	myCounters.Read(myStartCounters);
+	myStartTime = std::chrono::steady_clock::now();
+}
+
+void MicroBenchmark::EndSample()
+{
+	std::chrono::steady_clock::time_point endTime;
+	CpuCounters::Sample endCounters;
+
+	// Stop the clock before reading the counters, the counters exclude their own cost anyway.
+	endTime = std::chrono::steady_clock::now();
+	myCounters.Read(endCounters);
+
+	mySamples.push_back(std::chrono::duration<double, std::nano>(endTime - myStartTime).count());
+	myCycleSamples.push_back((double)(endCounters.cycles - myStartCounters.cycles));
+	myInstructionSamples.push_back((double)(endCounters.instructions - myStartCounters.instructions));
+}
+
+void MicroBenchmark::Record(const char* aName, int aItems)
+{
+	Result result;
+	unsigned int i;
+	double sum;
+
+	result.name = aName;
+	result.items = aItems > 0 ? aItems : 1;
+	result.repetitions = (int)mySamples.size();
+
+	// Nearest rank percentiles of the sorted repetitions.
+	std::sort(mySamples.begin(), mySamples.end());
+	sum = 0.0;
+	for (i = 0; i < mySamples.size(); i++)
+	{
+		sum += mySamples[i];
+	}
+	result.minimum = mySamples.front();
+	result.median = Median(mySamples);
+	result.percentile99 = mySamples[(mySamples.size() * 99 + 99) / 100 - 1];
+	result.mean = sum / mySamples.size();
+	result.cycles = Median(myCycleSamples);
+	result.instructions = Median(myInstructionSamples);
+	myResults.push_back(result);
+
+	printf("  %-40s median %10.1f us  p99 %10.1f us  %9.2f ns/item", aName, result.median / 1000.0, result.percentile99 / 1000.0,
+		result.median / result.items);
+	if (myCounters.HasCycles())
+	{
+		printf("  %8.1f cycles/item", result.cycles / result.items);
+	}
+	if (myCounters.HasCycles() && myCounters.HasInstructions() && result.cycles > 0.0)
+	{
+		printf("  IPC %.2f", result.instructions / result.cycles);
+	}
+	printf("\n");
+}
+
+double MicroBenchmark::Median(std::vector<double>& aSamples)
+{
+	size_t middle;
+
+	middle = aSamples.size() / 2;
+	std::nth_element(aSamples.begin(), aSamples.begin() + middle, aSamples.end());
+	if (aSamples.size() % 2 == 1)
+	{
+		return aSamples[middle];
+	}
+	return (aSamples[middle] + *std::max_element(aSamples.begin(), aSamples.begin() + middle)) * 0.5;
+}
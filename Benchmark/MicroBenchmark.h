@@ -0,0 +1,89 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "CpuCounters.h"
+
+const int MICRO_BENCHMARK_WARMUP = 5;
+const int MICRO_BENCHMARK_REPETITIONS = 50;
+
+// Times small pieces of engine code with repeatable statistics. Every case is run a few times untimed to warm the
+// caches and branch predictors, then timed once per repetition. The median and 99th percentile of the repetitions
+// are reported rather than the mean, so a single preempted repetition does not move the result.
+class MicroBenchmark
+{
+public:
+	struct Result
+	{
+		std::string name;
+		int items;
+		int repetitions;
+		double minimum;
+		double median;
+		double percentile99;
+		double mean;
+		double cycles;
+		double instructions;
+	};
+
+	MicroBenchmark();
+	MicroBenchmark(const MicroBenchmark& aMicroBenchmark) = delete;
+	~MicroBenchmark();
+
+	bool Initialize(const char* aFilter, int aWarmup, int aRepetitions);
+	void Shutdown();
+
+	bool IsEnabled(const char* aName);
+
+	// Runs aFunction as one repetition of the case, aItems is how many units of work one call does.
+	template<typename F> void Run(const char* aName, int aItems, F aFunction)
+	{
+		int i;
+
+		if (!IsEnabled(aName))
+		{
+			return;
+		}
+
+		for (i = 0; i < myWarmup; i++)
+		{
+			aFunction();
+		}
+
+		mySamples.clear();
+		myCycleSamples.clear();
+		myInstructionSamples.clear();
+		for (i = 0; i < myRepetitions; i++)
+		{
+			StartSample();
+			aFunction();
+			EndSample();
+		}
+
+		Record(aName, aItems);
+	}
+
+	void Skip(const char* aName, const char* aReason);
+
+	const std::vector<Result>& GetResults();
+	bool WriteJson(const char* aPath);
+
+private:
+	void StartSample();
+	void EndSample();
+	void Record(const char* aName, int aItems);
+	static double Median(std::vector<double>& aSamples);
+
+	CpuCounters myCounters;
+	CpuCounters::Sample myStartCounters;
+	std::chrono::steady_clock::time_point myStartTime;
+	std::vector<double> mySamples;
+	std::vector<double> myCycleSamples;
+	std::vector<double> myInstructionSamples;
+	std::vector<Result> myResults;
+	std::vector<std::string> mySkipped;
+	std::string myFilter;
+	int myWarmup;
+	int myRepetitions;
+};
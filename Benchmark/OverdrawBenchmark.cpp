@@ -0,0 +1,153 @@
+#include "Benchmark.h"
+#include "RenderCommand.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+static const int SCREEN_WIDTH = 320;
+static const int SCREEN_HEIGHT = 180;
+static const int QUAD_COUNT = 400;
+static const int MIN_QUAD_SIZE = 8;
+static const int MAX_QUAD_SIZE = 48;
+
+// A sprite as the rasterizer sees it, a screen rectangle at one depth.
+struct OverdrawQuad
+{
+	int left;
+	int top;
+	int right;
+	int bottom;
+	float depth;
+	MaterialType material;
+};
+
+// Pixel counts of one frame: pixels shaded, pixels rejected by the depth test before shading and pixels covered at all.
+struct OverdrawResult
+{
+	long long shadedPixelCount;
+	long long rejectedPixelCount;
+	long long coveredPixelCount;
+};
+
+// Alpha tested sprites are cut out, a quarter of their texels is transparent and discarded.
+static bool IsCutOut(int aX, int aY)
+{
+	return ((aX >> 1) & 1) != 0 && ((aY >> 1) & 1) != 0;
+}
+
+// Draws the quads in the order given the way the pipeline would: the depth test runs before shading when it is on,
+// opaque and alpha tested quads write depth where their texels survive, translucent ones never write it.
+static void Rasterize(const std::vector<OverdrawQuad>& aQuads, const std::vector<int>& aOrder, bool aDepthTest, OverdrawResult& aResult)
+{
+	std::vector<float> depthBuffer;
+	std::vector<unsigned char> covered;
+	const OverdrawQuad* quad;
+	int i, x, y, pixel;
+
+	depthBuffer.assign(SCREEN_WIDTH * SCREEN_HEIGHT, 1.0f);
+	covered.assign(SCREEN_WIDTH * SCREEN_HEIGHT, 0);
+	aResult.shadedPixelCount = 0;
+	aResult.rejectedPixelCount = 0;
+	aResult.coveredPixelCount = 0;
+	for (i = 0; i < (int)aOrder.size(); i++)
+	{
+		quad = &aQuads[aOrder[i]];
+		for (y = quad->top; y < quad->bottom; y++)
+		{
+			for (x = quad->left; x < quad->right; x++)
+			{
+				pixel = y * SCREEN_WIDTH + x;
+				aResult.coveredPixelCount += covered[pixel] == 0 ? 1 : 0;
+				covered[pixel] = 1;
+				if (aDepthTest && quad->depth >= depthBuffer[pixel])
+				{
+					aResult.rejectedPixelCount++;
+					continue;
+				}
+				aResult.shadedPixelCount++;
+				if (quad->material == MATERIAL_OPAQUE || (quad->material == MATERIAL_ALPHA_TESTED && !IsCutOut(x, y)))
+				{
+					depthBuffer[pixel] = quad->depth;
+				}
+			}
+		}
+	}
+}
+
+static void PrintResult(const char* aName, const OverdrawResult& aResult)
+{
+	printf("Overdraw: %-34s %.2f pixels shaded per covered pixel, %lld shaded, %lld rejected before shading\n", aName,
+		(double)aResult.shadedPixelCount / (double)aResult.coveredPixelCount, aResult.shadedPixelCount, aResult.rejectedPixelCount);
+}
+
+void RunOverdrawBenchmark()
+{
+	std::vector<OverdrawQuad> quads;
+	std::vector<RenderCommand> commands;
+	std::vector<int> order;
+	OverdrawQuad quad;
+	OverdrawResult result;
+	int i, width, height, opaqueCount, testedCount, translucentCount;
+
+	// Sprites spread over the screen at random depths, most of them opaque, some cut out and some blended.
+	srand(1234);
+	opaqueCount = testedCount = translucentCount = 0;
+	for (i = 0; i < QUAD_COUNT; i++)
+	{
+		width = MIN_QUAD_SIZE + rand() % (MAX_QUAD_SIZE - MIN_QUAD_SIZE);
+		height = MIN_QUAD_SIZE + rand() % (MAX_QUAD_SIZE - MIN_QUAD_SIZE);
+		quad.left = rand() % (SCREEN_WIDTH - width);
+		quad.top = rand() % (SCREEN_HEIGHT - height);
+		quad.right = quad.left + width;
+		quad.bottom = quad.top + height;
+		quad.depth = (float)(rand() % 1000) / 1000.0f;
+		switch (rand() % 10)
+		{
+		case 0:
+		case 1:
+			quad.material = MATERIAL_ALPHA_TESTED;
+			testedCount++;
+			break;
+		case 2:
+			quad.material = MATERIAL_TRANSLUCENT;
+			translucentCount++;
+			break;
+		default:
+			quad.material = MATERIAL_OPAQUE;
+			opaqueCount++;
+			break;
+		}
+		quads.push_back(quad);
+	}
+	printf("Overdraw: %d sprites on %dx%d pixels, %d opaque, %d alpha tested, %d translucent\n", QUAD_COUNT, SCREEN_WIDTH, SCREEN_HEIGHT,
+		opaqueCount, testedCount, translucentCount);
+
+	// Everything blended in the order it was submitted shades every pixel of every sprite.
+	for (i = 0; i < QUAD_COUNT; i++)
+	{
+		order.push_back(i);
+	}
+	Rasterize(quads, order, false, result);
+	PrintResult("submission order, no depth test:", result);
+
+	// Testing depth in submission order only rejects what happens to be behind something drawn earlier.
+	Rasterize(quads, order, true, result);
+	PrintResult("submission order, depth test:", result);
+
+	// The render queue order: opaque and alpha tested front to back with depth writes, then translucent back to front.
+	commands.resize(QUAD_COUNT);
+	for (i = 0; i < QUAD_COUNT; i++)
+	{
+		commands[i].shader.value = 0;
+		commands[i].texture.value = 0;
+		commands[i].model.value = (unsigned int)i;
+		commands[i].sortKey = MakeSortKey(quads[i].material, quads[i].depth, commands[i].shader, commands[i].texture, commands[i].model);
+	}
+	SortRenderCommands(&commands[0], QUAD_COUNT);
+	for (i = 0; i < QUAD_COUNT; i++)
+	{
+		order[i] = (int)commands[i].model.value;
+	}
+	Rasterize(quads, order, true, result);
+	PrintResult("sorted by pass and depth:", result);
+}
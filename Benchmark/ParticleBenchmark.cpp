@@ -0,0 +1,95 @@
+#include "Benchmark.h"
+#include "ParticleSystem.h"
+#include <chrono>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+static const int EMITTER_COUNT = 8;
+static const int PARTICLES_PER_EMITTER = 50000;
+static const int WARMUP_TICKS = 10;
+static const int TIMED_TICKS = 100;
+static const float TICK_TIME = 1.0f / 60.0f;
+
+static void RunParticleBenchmark(int aThreadCount)
+{
+	JobSystem jobSystem;
+	ParticleSystem particleSystem;
+	ParticleEmitter::Settings settings;
+	std::vector<SpriteVertex> vertices;
+	int i, particles, threads;
+	long long updated;
+	double updateSeconds, writeSeconds, perMillisecond;
+	std::chrono::high_resolution_clock::time_point start, end;
+
+	jobSystem.Initialize(aThreadCount);
+	particleSystem.Initialize(jobSystem);
+	threads = jobSystem.GetThreadCount();
+
+	// Long lived particles with an emission rate that replaces the ones dying, so the pools stay nearly full.
+	settings.positionX = 0.0f;
+	settings.positionY = 0.0f;
+	settings.spawnRadius = 1.0f;
+	settings.emissionRate = PARTICLES_PER_EMITTER / 4.0f;
+	settings.lifetimeMin = 3.0f;
+	settings.lifetimeMax = 5.0f;
+	settings.speedMin = 1.0f;
+	settings.speedMax = 4.0f;
+	settings.directionMin = 0.0f;
+	settings.directionMax = 6.2831853f;
+	settings.gravityX = 0.0f;
+	settings.gravityY = -9.8f;
+	settings.drag = 0.1f;
+
+	for (i = 0; i < EMITTER_COUNT; i++)
+	{
+		settings.positionX = (float)i;
+		particleSystem.AddEmitter(settings, PARTICLES_PER_EMITTER);
+		particleSystem.GetEmitter(i)->Burst(PARTICLES_PER_EMITTER);
+	}
+
+	// Warm up the caches and the worker threads before timing.
+	for (i = 0; i < WARMUP_TICKS; i++)
+	{
+		particleSystem.Update(TICK_TIME);
+	}
+
+	// Time the update, counting how many particles were alive in every tick.
+	updated = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (i = 0; i < TIMED_TICKS; i++)
+	{
+		particleSystem.Update(TICK_TIME);
+		updated += particleSystem.GetParticleCount();
+	}
+	end = std::chrono::high_resolution_clock::now();
+	updateSeconds = std::chrono::duration<double>(end - start).count();
+
+	// Time writing the quads out, as into a mapped vertex buffer.
+	particles = particleSystem.GetParticleCount();
+	vertices.resize(particles * 4);
+	start = std::chrono::high_resolution_clock::now();
+	for (i = 0; i < TIMED_TICKS; i++)
+	{
+		particleSystem.WriteQuads(&vertices[0], particles);
+	}
+	end = std::chrono::high_resolution_clock::now();
+	writeSeconds = std::chrono::duration<double>(end - start).count();
+
+	perMillisecond = (double)updated / (updateSeconds * 1000.0);
+	printf("Particles: %d threads, %d particles, update %.3f ms per tick, %.0f particles per ms per core, write %.3f ms per tick\n",
+		threads, particles, updateSeconds * 1000.0 / TIMED_TICKS, perMillisecond / threads, writeSeconds * 1000.0 / TIMED_TICKS);
+
+	particleSystem.Shutdown();
+	jobSystem.Shutdown();
+}
+
+void RunParticleBenchmark()
+{
+	// Single threaded first for the per core baseline, then on every core.
+	RunParticleBenchmark(1);
+	if (std::thread::hardware_concurrency() > 1)
+	{
+		RunParticleBenchmark(0);
+	}
+}
@@ -0,0 +1,248 @@
+#include "Benchmark.h"
+#include "RenderGraph.h"
+#include <chrono>
+#include <stdio.h>
+#include <vector>
+
+static const int SCREEN_WIDTH = 1920;
+static const int SCREEN_HEIGHT = 1080;
+static const int SHADOW_SIZE = 1024;
+static const int COMPILE_COUNT = 10000;
+static const int MAX_PASS_TEXTURES = 4;
+static const double MEGABYTE = 1024.0 * 1024.0;
+// DXGI formats as plain numbers, the benchmark is built without the graphics headers.
+static const int FORMAT_RGBA8 = 28;
+static const int FORMAT_RGBA16F = 10;
+static const int FORMAT_R32F = 41;
+
+// Stands in for the GPU: keeps track of which texture each target holds, and counts every time a texture is acquired into
+// a target that still holds another or a pass uses a texture that is not in its target.
+class NullGraphBackend : public RenderGraphBackend
+{
+public:
+	NullGraphBackend()
+	{
+		myErrorCount = 0;
+		myPassCount = 0;
+	}
+
+	bool CreateTargets(const RenderGraphTextureDesc*, int aCount) override
+	{
+		myHolders.assign(aCount, -1);
+		return true;
+	}
+
+	void Acquire(int aResource, int aTarget) override
+	{
+		myErrorCount += myHolders[aTarget] >= 0 ? 1 : 0;
+		myHolders[aTarget] = aResource;
+	}
+
+	void BeginPass(int) override
+	{
+		myPassCount++;
+	}
+
+	void Release(int aResource, int aTarget) override
+	{
+		myErrorCount += myHolders[aTarget] != aResource ? 1 : 0;
+		myHolders[aTarget] = -1;
+	}
+
+	void Use(RenderGraph& aGraph, int aResource)
+	{
+		int target;
+
+		target = aGraph.GetTarget(aResource);
+		myErrorCount += target >= 0 && myHolders[target] != aResource ? 1 : 0;
+	}
+
+	std::vector<int> myHolders;
+	int myErrorCount;
+	int myPassCount;
+};
+
+// A pass of the benchmark frame with the textures it reads and writes, -1 ends a list.
+struct BenchmarkPass
+{
+	const char* name;
+	int reads[MAX_PASS_TEXTURES];
+	int writes[MAX_PASS_TEXTURES];
+};
+
+enum BenchmarkTexture
+{
+	BACK_BUFFER,
+	BACKGROUND_LAYER,
+	SHADOW_SUN,
+	SHADOW_LAMP,
+	SCENE_HDR,
+	BLOOM_HALF,
+	BLOOM_QUARTER,
+	BLOOM_EIGHTH,
+	BLOOM_QUARTER_UP,
+	BLOOM_HALF_UP,
+	OVERDRAW,
+	MENU_BLUR_H,
+	MENU_BLUR,
+	TEXTURE_COUNT
+};
+
+// The frame the post effects, shadows and cached layers will make: the back buffer and the cached background come from
+// outside the graph, the shadow maps are declared up front the way they are usually grouped, and the overdraw view of the
+// debug overlay is drawn but not shown.
+static const BenchmarkPass BENCHMARK_PASSES[] =
+{
+	{ "shadow sun", { -1 }, { SHADOW_SUN, -1 } },
+	{ "shadow lamp", { -1 }, { SHADOW_LAMP, -1 } },
+	{ "scene", { BACKGROUND_LAYER, SHADOW_SUN, -1 }, { SCENE_HDR, -1 } },
+	{ "scene lamp", { SCENE_HDR, SHADOW_LAMP, -1 }, { SCENE_HDR, -1 } },
+	{ "bloom bright", { SCENE_HDR, -1 }, { BLOOM_HALF, -1 } },
+	{ "bloom down 1", { BLOOM_HALF, -1 }, { BLOOM_QUARTER, -1 } },
+	{ "bloom down 2", { BLOOM_QUARTER, -1 }, { BLOOM_EIGHTH, -1 } },
+	{ "bloom up 1", { BLOOM_EIGHTH, BLOOM_QUARTER, -1 }, { BLOOM_QUARTER_UP, -1 } },
+	{ "bloom up 2", { BLOOM_QUARTER_UP, BLOOM_HALF, -1 }, { BLOOM_HALF_UP, -1 } },
+	{ "overdraw", { -1 }, { OVERDRAW, -1 } },
+	{ "tonemap", { SCENE_HDR, BLOOM_HALF_UP, -1 }, { BACK_BUFFER, -1 } },
+	{ "menu blur h", { BACK_BUFFER, -1 }, { MENU_BLUR_H, -1 } },
+	{ "menu blur v", { MENU_BLUR_H, -1 }, { MENU_BLUR, -1 } },
+	{ "menu", { MENU_BLUR, BACK_BUFFER, -1 }, { BACK_BUFFER, -1 } }
+};
+
+static void DeclareFrame(RenderGraph& aGraph, NullGraphBackend& aBackend)
+{
+	const RenderGraphTextureDesc screen = { SCREEN_WIDTH, SCREEN_HEIGHT, FORMAT_RGBA8, 4 };
+	const RenderGraphTextureDesc shadow = { SHADOW_SIZE, SHADOW_SIZE, FORMAT_R32F, 4 };
+	const RenderGraphTextureDesc hdr = { SCREEN_WIDTH, SCREEN_HEIGHT, FORMAT_RGBA16F, 8 };
+	const RenderGraphTextureDesc half = { SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2, FORMAT_RGBA16F, 8 };
+	const RenderGraphTextureDesc quarter = { SCREEN_WIDTH / 4, SCREEN_HEIGHT / 4, FORMAT_RGBA16F, 8 };
+	const RenderGraphTextureDesc eighth = { SCREEN_WIDTH / 8, SCREEN_HEIGHT / 8, FORMAT_RGBA16F, 8 };
+	RenderGraph* graph;
+	NullGraphBackend* backend;
+	const BenchmarkPass* declared;
+	int textures[TEXTURE_COUNT];
+	int i, j, pass;
+
+	textures[BACK_BUFFER] = aGraph.ImportTexture("back buffer", screen);
+	textures[BACKGROUND_LAYER] = aGraph.ImportTexture("background layer", screen);
+	textures[SHADOW_SUN] = aGraph.CreateTexture("shadow sun", shadow);
+	textures[SHADOW_LAMP] = aGraph.CreateTexture("shadow lamp", shadow);
+	textures[SCENE_HDR] = aGraph.CreateTexture("scene hdr", hdr);
+	textures[BLOOM_HALF] = aGraph.CreateTexture("bloom half", half);
+	textures[BLOOM_QUARTER] = aGraph.CreateTexture("bloom quarter", quarter);
+	textures[BLOOM_EIGHTH] = aGraph.CreateTexture("bloom eighth", eighth);
+	textures[BLOOM_QUARTER_UP] = aGraph.CreateTexture("bloom quarter up", quarter);
+	textures[BLOOM_HALF_UP] = aGraph.CreateTexture("bloom half up", half);
+	textures[OVERDRAW] = aGraph.CreateTexture("overdraw", screen);
+	textures[MENU_BLUR_H] = aGraph.CreateTexture("menu blur h", half);
+	textures[MENU_BLUR] = aGraph.CreateTexture("menu blur", half);
+
+	// Each pass checks that what it uses is in its target when it runs.
+	graph = &aGraph;
+	backend = &aBackend;
+	for (i = 0; i < (int)(sizeof(BENCHMARK_PASSES) / sizeof(BENCHMARK_PASSES[0])); i++)
+	{
+		declared = &BENCHMARK_PASSES[i];
+		pass = aGraph.AddPass(declared->name, [graph, backend, declared, textures]()
+		{
+			int k;
+
+			for (k = 0; declared->reads[k] >= 0; k++)
+			{
+				backend->Use(*graph, textures[declared->reads[k]]);
+			}
+			for (k = 0; declared->writes[k] >= 0; k++)
+			{
+				backend->Use(*graph, textures[declared->writes[k]]);
+			}
+		});
+		for (j = 0; declared->reads[j] >= 0; j++)
+		{
+			aGraph.Read(pass, textures[declared->reads[j]]);
+		}
+		for (j = 0; declared->writes[j] >= 0; j++)
+		{
+			aGraph.Write(pass, textures[declared->writes[j]]);
+		}
+	}
+}
+
+void RunRenderGraphBenchmark()
+{
+	std::chrono::high_resolution_clock::time_point start, end;
+	RenderGraph graph;
+	RenderGraph::Stats stats;
+	NullGraphBackend backend;
+	const RenderGraph::Command* commands;
+	const RenderGraphTextureDesc* targets;
+	const char* separator;
+	int i, commandCount, targetCount, firstPass, lastPass;
+	bool compiled;
+	float time;
+
+	if (!graph.Initialize())
+	{
+		printf("Render graph: could not initialize\n");
+		return;
+	}
+
+	// Declare and compile the frame the way a renderer would every frame, then run the commands once on the null backend.
+	compiled = true;
+	start = std::chrono::high_resolution_clock::now();
+	for (i = 0; i < COMPILE_COUNT; i++)
+	{
+		graph.Reset();
+		DeclareFrame(graph, backend);
+		compiled = graph.Compile() && compiled;
+	}
+	end = std::chrono::high_resolution_clock::now();
+	time = std::chrono::duration<float, std::micro>(end - start).count();
+	if (!compiled || !graph.Execute(backend))
+	{
+		printf("Render graph: could not compile the frame\n");
+		graph.Shutdown();
+		return;
+	}
+	graph.GetStats(stats);
+	commands = graph.GetCommands(commandCount);
+	targets = graph.GetTargets(targetCount);
+
+	printf("Render graph: %d passes, %d culled, %d textures, %d transient, %d commands\n", stats.passCount, stats.culledPassCount,
+		stats.resourceCount, stats.transientCount, commandCount);
+	separator = "Render graph:   order ";
+	for (i = 0; i < commandCount; i++)
+	{
+		if (commands[i].type == RenderGraph::COMMAND_PASS)
+		{
+			printf("%s%s", separator, graph.GetPassName(commands[i].index));
+			separator = ", ";
+		}
+	}
+	printf("\n");
+	for (i = 0; i < stats.resourceCount; i++)
+	{
+		graph.GetLifetime(i, firstPass, lastPass);
+		if (graph.GetTarget(i) >= 0)
+		{
+			printf("Render graph:   %-18s %4dx%-4d %5.1f MB in target %d, from %s to %s\n", graph.GetResourceName(i),
+				targets[graph.GetTarget(i)].width, targets[graph.GetTarget(i)].height, targets[graph.GetTarget(i)].width *
+				targets[graph.GetTarget(i)].height * targets[graph.GetTarget(i)].bytesPerTexel / MEGABYTE, graph.GetTarget(i),
+				graph.GetPassName(firstPass), graph.GetPassName(lastPass));
+		}
+	}
+	for (i = 0; i < stats.passCount; i++)
+	{
+		if (graph.IsCulled(i))
+		{
+			printf("Render graph:   culled %s\n", graph.GetPassName(i));
+		}
+	}
+
+	printf("Render graph: %d transient textures in %d targets, %.1f MB without aliasing, %.1f MB with, %.1f MB saved (%.0f%%), "
+		"%.2f us to declare and compile%s\n", stats.transientCount, targetCount, stats.transientBytes / MEGABYTE, stats.targetBytes / MEGABYTE,
+		(stats.transientBytes - stats.targetBytes) / MEGABYTE, 100.0 * (stats.transientBytes - stats.targetBytes) / stats.transientBytes,
+		time / COMPILE_COUNT, backend.myErrorCount == 0 && backend.myPassCount == stats.passCount - stats.culledPassCount ? "" :
+		", TARGETS SHARED WHILE IN USE");
+
+	graph.Shutdown();
+}
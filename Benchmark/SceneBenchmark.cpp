@@ -0,0 +1,162 @@
+#include "Benchmark.h"
+#include "SceneFile.h"
+#include "SceneWriter.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+static const int ENTITY_COUNT = 500000;
+static const int SPRITE_COUNT = 16;
+static const int MAP_SIZE = 256;
+static const char* TEXT_PATH = "SceneBenchmark.txt";
+static const char* BINARY_PATH = "SceneBenchmark.scene";
+
+// Engine side storage the sections are copied into, kept the way the sprite arrays keep them.
+struct SceneStorage
+{
+	std::vector<SceneEntity> entities;
+	std::vector<SceneVector> positions;
+	std::vector<SceneVector> sizes;
+	std::vector<unsigned short> tiles;
+};
+
+static bool WriteTextScene(const char* aPath, int aSeed)
+{
+	FILE* file;
+	int i;
+
+#if defined(_WIN32)
+	if (fopen_s(&file, aPath, "w") != 0)
+	{
+		file = nullptr;
+	}
+#else
+	file = fopen(aPath, "w");
+#endif
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	// The same level the binary scene holds, one record per line.
+	srand(aSeed);
+	fprintf(file, "# Benchmark level\ncamera 0 0 -5\ntexture ../../Bin/Sprites/testTexture.tga\n");
+	for (i = 0; i < SPRITE_COUNT; i++)
+	{
+		fprintf(file, "sprite 0 4 4 %d 4 0.1 1\n", i % 13);
+	}
+	for (i = 0; i < ENTITY_COUNT; i++)
+	{
+		fprintf(file, "entity %d %.3f %.3f 0.25 0.25 1 %.2f\n", rand() % SPRITE_COUNT, (float)(rand() % 20000) * 0.01f - 100.0f,
+			(float)(rand() % 20000) * 0.01f - 100.0f, (float)(rand() % 100) * 0.01f);
+	}
+	fprintf(file, "tilemap %d %d 0.5 -64 -64 4 4 0\nfill 0 0 %d %d 1\n", MAP_SIZE, MAP_SIZE, MAP_SIZE, MAP_SIZE);
+	fclose(file);
+	return true;
+}
+
+static void CopyScene(SceneFile& aScene, SceneStorage& aStorage)
+{
+	const SceneEntity* entities;
+	const SceneVector* positions;
+	const SceneVector* sizes;
+	const unsigned short* tiles;
+	int entityCount, positionCount, sizeCount, tileCount;
+
+	// One block per section, nothing is looked at record by record.
+	entities = aScene.GetEntities(entityCount);
+	positions = aScene.GetPositions(positionCount);
+	sizes = aScene.GetSizes(sizeCount);
+	tiles = aScene.GetTiles(tileCount);
+	aStorage.entities.assign(entities, entities + entityCount);
+	aStorage.positions.assign(positions, positions + positionCount);
+	aStorage.sizes.assign(sizes, sizes + sizeCount);
+	aStorage.tiles.assign(tiles, tiles + tileCount);
+}
+
+static float SumPositions(const SceneVector* aPositions, int aCount)
+{
+	float sum;
+	int i;
+
+	// Touch every position so a mapped scene is really paged in.
+	sum = 0.0f;
+	for (i = 0; i < aCount; i++)
+	{
+		sum += aPositions[i].x + aPositions[i].y;
+	}
+	return sum;
+}
+
+void RunSceneBenchmark()
+{
+	SceneWriter writer;
+	SceneFile scene;
+	SceneStorage storage;
+	std::vector<unsigned char> file;
+	const SceneVector* positions;
+	int errorLine, count;
+	float sum;
+	double textSeconds, loadSeconds, copySeconds, mapSeconds, touchSeconds;
+	std::chrono::high_resolution_clock::time_point start, end;
+
+	// Convert the text level once, the binary scene is what the converter would ship.
+	if (!WriteTextScene(TEXT_PATH, 1234) || !writer.ReadText(TEXT_PATH, errorLine) || !writer.Write(BINARY_PATH))
+	{
+		printf("Scene: could not write the benchmark level\n");
+		remove(TEXT_PATH);
+		return;
+	}
+
+	// Read the text level the way a loader without the binary format would, parsing every object.
+	start = std::chrono::high_resolution_clock::now();
+	writer.ReadText(TEXT_PATH, errorLine);
+	writer.Build(file);
+	end = std::chrono::high_resolution_clock::now();
+	textSeconds = std::chrono::duration<double>(end - start).count();
+
+	// Read the binary scene with one call and copy its sections into engine storage.
+	start = std::chrono::high_resolution_clock::now();
+	if (!scene.Load(BINARY_PATH))
+	{
+		printf("Scene: could not load %s\n", BINARY_PATH);
+		remove(TEXT_PATH);
+		remove(BINARY_PATH);
+		return;
+	}
+	end = std::chrono::high_resolution_clock::now();
+	loadSeconds = std::chrono::duration<double>(end - start).count();
+	start = std::chrono::high_resolution_clock::now();
+	CopyScene(scene, storage);
+	end = std::chrono::high_resolution_clock::now();
+	copySeconds = std::chrono::duration<double>(end - start).count();
+	scene.Shutdown();
+
+	// Map the binary scene and use its positions where they lie.
+	start = std::chrono::high_resolution_clock::now();
+	if (!scene.Map(BINARY_PATH))
+	{
+		printf("Scene: could not map %s\n", BINARY_PATH);
+		remove(TEXT_PATH);
+		remove(BINARY_PATH);
+		return;
+	}
+	end = std::chrono::high_resolution_clock::now();
+	mapSeconds = std::chrono::duration<double>(end - start).count();
+	start = std::chrono::high_resolution_clock::now();
+	positions = scene.GetPositions(count);
+	sum = SumPositions(positions, count);
+	end = std::chrono::high_resolution_clock::now();
+	touchSeconds = std::chrono::duration<double>(end - start).count();
+
+	printf("Scene: %d entities, %d tiles, %.1f MB binary (checksum %.0f)\n", ENTITY_COUNT, (int)storage.tiles.size(),
+		scene.GetSize() / (1024.0 * 1024.0), sum);
+	printf("Scene: text parse %.1f ms, binary read %.2f ms + copy %.2f ms, map %.3f ms + first use %.2f ms (%.0fx faster than text)\n",
+		textSeconds * 1000.0, loadSeconds * 1000.0, copySeconds * 1000.0, mapSeconds * 1000.0, touchSeconds * 1000.0,
+		textSeconds / (loadSeconds + copySeconds));
+	scene.Shutdown();
+
+	remove(TEXT_PATH);
+	remove(BINARY_PATH);
+}
@@ -0,0 +1,66 @@
+#include "Benchmark.h"
+#include "SpriteAnimation.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+static const int SPRITE_COUNT = 100000;
+static const int CLIP_COUNT = 16;
+static const int WARMUP_TICKS = 10;
+static const int TIMED_TICKS = 200;
+static const float TICK_TIME = 1.0f / 60.0f;
+
+void RunSpriteAnimationBenchmark()
+{
+	SpriteAnimation animation;
+	int clips[CLIP_COUNT];
+	int i;
+	float checksum;
+	double seconds;
+	std::chrono::high_resolution_clock::time_point start, end;
+
+	if (!animation.Initialize(SPRITE_COUNT))
+	{
+		printf("SpriteAnimation: could not initialize\n");
+		return;
+	}
+
+	// Clips of different lengths and speeds on an 8x8 sheet, like a sheet holding several characters.
+	for (i = 0; i < CLIP_COUNT; i++)
+	{
+		clips[i] = animation.AddGridClip(8, 8, (i * 4) % 56, 4 + i % 5, 0.05f + 0.01f * (i % 7), i % 4 != 0);
+	}
+
+	// Spread the sprites over the clips with a fixed seed so runs are comparable.
+	srand(1234);
+	for (i = 0; i < SPRITE_COUNT; i++)
+	{
+		animation.CreateInstance(clips[rand() % CLIP_COUNT], 0.5f + (float)(rand() % 100) / 100.0f);
+	}
+
+	// Warm up the caches before timing.
+	for (i = 0; i < WARMUP_TICKS; i++)
+	{
+		animation.Update(TICK_TIME);
+	}
+
+	start = std::chrono::high_resolution_clock::now();
+	for (i = 0; i < TIMED_TICKS; i++)
+	{
+		animation.Update(TICK_TIME);
+	}
+	end = std::chrono::high_resolution_clock::now();
+
+	// Read the output so the update can not be optimized away.
+	checksum = 0.0f;
+	for (i = 0; i < animation.GetInstanceCount(); i++)
+	{
+		checksum += animation.GetUVRects()[i].left;
+	}
+
+	seconds = std::chrono::duration<double>(end - start).count();
+	printf("SpriteAnimation: %d sprites, %.3f ms per tick, %.2f ns per sprite (checksum %.1f)\n", SPRITE_COUNT,
+		seconds * 1000.0 / TIMED_TICKS, seconds * 1e9 / ((double)TIMED_TICKS * SPRITE_COUNT), checksum);
+
+	animation.Shutdown();
+}
@@ -0,0 +1,146 @@
+#include "Benchmark.h"
+#include "SpriteOutline.h"
+#include "Targa.h"
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+static const char* SPRITE_SHEET_PATH = "../../Bin/Sprites/testTexture.tga";
+static const int SHEET_COLUMNS = 4;
+static const int SHEET_ROWS = 4;
+static const int GENERATED_CELL_SIZE = 64;
+static const int BUDGETS[] = { 4, 6, 8, 12, 16 };
+
+static bool LoadSpriteSheet(std::vector<unsigned char>& aPixels, int& aWidth, int& aHeight)
+{
+	std::vector<unsigned char> file;
+	FILE* handle;
+	long size;
+
+#if defined(_WIN32)
+	if (fopen_s(&handle, SPRITE_SHEET_PATH, "rb") != 0)
+	{
+		handle = nullptr;
+	}
+#else
+	handle = fopen(SPRITE_SHEET_PATH, "rb");
+#endif
+	if (handle == nullptr)
+	{
+		return false;
+	}
+	fseek(handle, 0, SEEK_END);
+	size = ftell(handle);
+	fseek(handle, 0, SEEK_SET);
+	file.resize(size > 0 ? size : 1);
+	if (size <= 0 || fread(&file[0], 1, size, handle) != (size_t)size)
+	{
+		fclose(handle);
+		return false;
+	}
+	fclose(handle);
+
+	// Decode into a buffer large enough for any image the file could hold.
+	aPixels.resize(file.size() * 2);
+	return DecodeTarga(&file[0], file.size(), &aPixels[0], aPixels.size(), aWidth, aHeight);
+}
+
+// Sprites the way artists draw them when the sheet is not at hand: round, pointed and thin shapes, small ones off center.
+static void GenerateSpriteSheet(std::vector<unsigned char>& aPixels, int& aWidth, int& aHeight)
+{
+	float u, v, radius, distance, alpha;
+	int x, y, cell, column, row;
+
+	aWidth = GENERATED_CELL_SIZE * SHEET_COLUMNS;
+	aHeight = GENERATED_CELL_SIZE * SHEET_ROWS;
+	aPixels.assign(aWidth * aHeight * 4, 0);
+	for (y = 0; y < aHeight; y++)
+	{
+		for (x = 0; x < aWidth; x++)
+		{
+			column = x / GENERATED_CELL_SIZE;
+			row = y / GENERATED_CELL_SIZE;
+			cell = row * SHEET_COLUMNS + column;
+			u = ((float)(x % GENERATED_CELL_SIZE) + 0.5f) / GENERATED_CELL_SIZE * 2.0f - 1.0f;
+			v = ((float)(y % GENERATED_CELL_SIZE) + 0.5f) / GENERATED_CELL_SIZE * 2.0f - 1.0f;
+			radius = 0.3f + 0.04f * (float)cell;
+			switch (cell % 4)
+			{
+			case 0:
+				distance = sqrtf(u * u + v * v) / radius;
+				break;
+			case 1:
+				distance = (fabsf(u) + fabsf(v)) / radius;
+				break;
+			case 2:
+				distance = fmaxf(v / radius, fabsf(u) * 2.0f / fmaxf(v + radius, 1e-3f));
+				break;
+			default:
+				distance = sqrtf((u + v) * (u + v) * 0.5f + (u - v) * (u - v) * 4.0f) / radius;
+				break;
+			}
+			alpha = distance < 1.0f ? 1.0f : (distance < 1.1f ? (1.1f - distance) * 10.0f : 0.0f);
+			aPixels[(y * aWidth + x) * 4 + 3] = (unsigned char)(alpha * 255.0f);
+		}
+	}
+}
+
+void RunSpriteMeshBenchmark()
+{
+	std::vector<unsigned char> pixels;
+	OutlinePoint outline[MAX_OUTLINE_VERTICES];
+	double seconds, area, visible;
+	int width, height, cellWidth, cellHeight, cell, budget, i, x, y, count, vertices, quads;
+	bool loaded;
+	std::chrono::high_resolution_clock::time_point start;
+
+	// The sprite sheet of the interactive scene, cut into the cells its sprites animate through.
+	loaded = LoadSpriteSheet(pixels, width, height);
+	if (!loaded)
+	{
+		GenerateSpriteSheet(pixels, width, height);
+	}
+	cellWidth = width / SHEET_COLUMNS;
+	cellHeight = height / SHEET_ROWS;
+
+	// The share of each cell that holds visible texels, the least any outline can cover.
+	visible = 0.0;
+	for (cell = 0; cell < SHEET_COLUMNS * SHEET_ROWS; cell++)
+	{
+		count = 0;
+		for (y = (cell / SHEET_COLUMNS) * cellHeight; y < (cell / SHEET_COLUMNS + 1) * cellHeight; y++)
+		{
+			for (x = (cell % SHEET_COLUMNS) * cellWidth; x < (cell % SHEET_COLUMNS + 1) * cellWidth; x++)
+			{
+				count += pixels[(y * width + x) * 4 + 3] > 0 ? 1 : 0;
+			}
+		}
+		visible += (double)count / (double)(cellWidth * cellHeight);
+	}
+	printf("SpriteMesh: %s, %d cells of %dx%d, %.1f%% of the rectangles visible\n", loaded ? SPRITE_SHEET_PATH : "generated sheet",
+		SHEET_COLUMNS * SHEET_ROWS, cellWidth, cellHeight, visible * 100.0 / (SHEET_COLUMNS * SHEET_ROWS));
+
+	// Outline every cell with each budget and compare the rasterized area with the rectangle of 4 corners and 1 quad.
+	for (i = 0; i < (int)(sizeof(BUDGETS) / sizeof(BUDGETS[0])); i++)
+	{
+		budget = BUDGETS[i];
+		area = 0.0;
+		vertices = 0;
+		quads = 0;
+		start = std::chrono::high_resolution_clock::now();
+		for (cell = 0; cell < SHEET_COLUMNS * SHEET_ROWS; cell++)
+		{
+			x = (cell % SHEET_COLUMNS) * cellWidth;
+			y = (cell / SHEET_COLUMNS) * cellHeight;
+			count = BuildSpriteOutline(&pixels[0], width * 4, x, y, x + cellWidth, y + cellHeight, 1, budget, outline);
+			area += count > 0 ? GetOutlineArea(outline, count) : 0.0;
+			vertices += count;
+			quads += GetOutlineQuadCount(count);
+		}
+		seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+		printf("SpriteMesh: budget %2d corners: %.1f%% of the rectangle area rasterized, %.1f corners and %.1f quads per cell, built in %.2f ms\n",
+			budget, area * 100.0 / (SHEET_COLUMNS * SHEET_ROWS), (double)vertices / (SHEET_COLUMNS * SHEET_ROWS),
+			(double)quads / (SHEET_COLUMNS * SHEET_ROWS), seconds * 1000.0);
+	}
+}
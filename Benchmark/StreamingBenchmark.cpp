@@ -0,0 +1,133 @@
+#include "Benchmark.h"
+#include "SceneFile.h"
+#include "SceneWriter.h"
+#include "Tilemap.h"
+#include "WorldStreamer.h"
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+
+static const int MAP_SIZE = 4096;
+static const float TILE_SIZE = 0.25f;
+static const int FRAME_COUNT = 240;
+static const float FRAME_TIME = 1.0f / 60.0f;
+static const float CAMERA_SPEED = 40.0f;
+static const float VIEW_HALF_WIDTH = 8.0f;
+static const float VIEW_HALF_HEIGHT = 4.5f;
+static const char* SCENE_PATH = "StreamingBenchmark.scene";
+
+static bool WriteLevel(const char* aPath)
+{
+	SceneWriter writer;
+	SceneTilemap tilemap;
+	unsigned short* tiles;
+	int x, y;
+
+	// One large tilemap with the pattern of the interactive scene.
+	memset(&tilemap, 0, sizeof(tilemap));
+	tilemap.width = MAP_SIZE;
+	tilemap.height = MAP_SIZE;
+	tilemap.tileSize = TILE_SIZE;
+	tilemap.atlasColumns = 16;
+	tilemap.atlasRows = 16;
+	writer.AddTexture("../../Bin/Sprites/testTexture.tga");
+	tiles = writer.GetTiles(writer.AddTilemap(tilemap));
+	for (y = 0; y < MAP_SIZE; y++)
+	{
+		for (x = 0; x < MAP_SIZE; x++)
+		{
+			if (((x / 7) + (y / 5)) % 9 != 0)
+			{
+				tiles[y * MAP_SIZE + x] = (unsigned short)(1 + ((x * 31) ^ (y * 17)) % 256);
+			}
+		}
+	}
+	return writer.Write(aPath);
+}
+
+static void RunStreaming(const char* aName, size_t aOffset, float aPrefetchDistance, float aLookAheadTime)
+{
+	Tilemap tilemap;
+	WorldStreamer streamer;
+	WorldStreamer::Settings settings;
+	WorldStreamer::Stats stats;
+	float cameraX, cameraY, pending;
+	double updateSeconds;
+	int frame, maxResident;
+	std::chrono::high_resolution_clock::time_point start, end;
+
+	settings.cellSize = 64;
+	settings.prefetchDistance = aPrefetchDistance;
+	settings.lookAheadTime = aLookAheadTime;
+	settings.maxResidentCells = 256;
+	settings.maxLoadsInFlight = 8;
+	if (!tilemap.Initialize(MAP_SIZE, MAP_SIZE, TILE_SIZE, 0.0f, 0.0f, 16, 16) || !streamer.Initialize(SCENE_PATH, aOffset, tilemap, settings))
+	{
+		printf("Streaming: could not initialize\n");
+		return;
+	}
+
+	// Load the cells around the start, then fly diagonally across the map. Every frame sleeps for a few milliseconds
+	// in place of rendering, so the loader runs alongside frames the way it would in the engine.
+	cameraX = 20.0f;
+	cameraY = 20.0f;
+	streamer.Update(cameraX - VIEW_HALF_WIDTH, cameraY - VIEW_HALF_HEIGHT, cameraX + VIEW_HALF_WIDTH, cameraY + VIEW_HALF_HEIGHT, 0.0f, 0.0f, 0.0f);
+	streamer.Flush();
+	pending = 0.0f;
+	maxResident = 0;
+	updateSeconds = 0.0;
+	for (frame = 0; frame < FRAME_COUNT; frame++)
+	{
+		cameraX += CAMERA_SPEED * FRAME_TIME;
+		cameraY += CAMERA_SPEED * 0.5f * FRAME_TIME;
+		start = std::chrono::high_resolution_clock::now();
+		streamer.Update(cameraX - VIEW_HALF_WIDTH, cameraY - VIEW_HALF_HEIGHT, cameraX + VIEW_HALF_WIDTH, cameraY + VIEW_HALF_HEIGHT, CAMERA_SPEED,
+			CAMERA_SPEED * 0.5f, FRAME_TIME);
+		end = std::chrono::high_resolution_clock::now();
+		updateSeconds += std::chrono::duration<double>(end - start).count();
+
+		streamer.GetStats(stats);
+		pending += (float)stats.pendingCellCount;
+		maxResident = stats.residentCellCount > maxResident ? stats.residentCellCount : maxResident;
+		std::this_thread::sleep_for(std::chrono::milliseconds(4));
+	}
+	streamer.GetStats(stats);
+
+	printf("Streaming: %-24s %d cells loaded, %d unloaded, at most %d resident, %.1f pending, %d pop-ins, %.1f MB read, update %.1f us\n",
+		aName, stats.loadedCellCount, stats.unloadedCellCount, maxResident, pending / FRAME_COUNT, stats.popInCount,
+		stats.bytesRead / (1024.0 * 1024.0), updateSeconds * 1e6 / FRAME_COUNT);
+
+	streamer.Shutdown();
+	tilemap.Shutdown();
+}
+
+void RunStreamingBenchmark()
+{
+	SceneFile scene;
+	const SceneTilemap* tilemaps;
+	const unsigned short* tiles;
+	size_t offset;
+	int count;
+
+	// Write the level and find where its tiles start, the streamer reads them from the file itself.
+	if (!WriteLevel(SCENE_PATH) || !scene.Map(SCENE_PATH))
+	{
+		printf("Streaming: could not write the benchmark level\n");
+		remove(SCENE_PATH);
+		return;
+	}
+	tilemaps = scene.GetTilemaps(count);
+	tiles = scene.GetTiles(count);
+	offset = scene.GetOffset(tiles + tilemaps[0].firstTile);
+	printf("Streaming: %dx%d tiles, %.1f MB level, camera at %.0f units per second\n", MAP_SIZE, MAP_SIZE, scene.GetSize() / (1024.0 * 1024.0),
+		CAMERA_SPEED);
+	scene.Shutdown();
+
+	// Loading only what is in view pops cells in at the edge, prefetching ahead of the camera hides the reads.
+	RunStreaming("view only:", offset, 0.0f, 0.0f);
+	RunStreaming("prefetch 8:", offset, 8.0f, 0.0f);
+	RunStreaming("prefetch 8, look ahead:", offset, 8.0f, 1.0f);
+
+	remove(SCENE_PATH);
+}
@@ -0,0 +1,176 @@
+#include "Benchmark.h"
+#include "GlyphCache.h"
+#include "TextSystem.h"
+#include <chrono>
+#include <stdio.h>
+#include <vector>
+
+static const int TEXT_COUNT = 1000;
+static const int TEXT_LENGTH = 50;
+static const int FRAME_COUNT = 100;
+static const int GLYPH_SIZE = 24;
+static const int DISTANCE_FIELD_SPREAD = 4;
+
+// Stands in for a real font so the benchmark runs without one, every glyph is a ring shaped by its codepoint.
+class RingGlyphSource : public GlyphSource
+{
+public:
+	bool RasterizeGlyph(unsigned int aCodepoint, GlyphBitmap& aGlyph)
+	{
+		int x, y, dx, dy, inner, outer, distance;
+
+		if (aCodepoint == ' ')
+		{
+			aGlyph.width = 0;
+			aGlyph.height = 0;
+			aGlyph.offsetX = 0;
+			aGlyph.offsetY = 0;
+			aGlyph.advance = GLYPH_SIZE * 0.6f;
+			aGlyph.coverage.clear();
+			return true;
+		}
+
+		aGlyph.width = GLYPH_SIZE * 3 / 4;
+		aGlyph.height = GLYPH_SIZE;
+		aGlyph.offsetX = 1;
+		aGlyph.offsetY = GLYPH_SIZE * 3 / 4;
+		aGlyph.advance = (float)(aGlyph.width + 2);
+		aGlyph.coverage.resize(aGlyph.width * aGlyph.height);
+
+		outer = (aGlyph.width / 2) * (aGlyph.width / 2);
+		inner = (int)(aCodepoint % 7) * (int)(aCodepoint % 7);
+		for (y = 0; y < aGlyph.height; y++)
+		{
+			for (x = 0; x < aGlyph.width; x++)
+			{
+				dx = x - aGlyph.width / 2;
+				dy = y - aGlyph.height / 2;
+				distance = dx * dx + dy * dy;
+				aGlyph.coverage[y * aGlyph.width + x] = (distance <= outer && distance >= inner) ? 255 : 0;
+			}
+		}
+		return true;
+	}
+
+	float GetAscent()
+	{
+		return GLYPH_SIZE * 0.75f;
+	}
+
+	float GetLineHeight()
+	{
+		return GLYPH_SIZE * 1.2f;
+	}
+};
+
+static void FillString(char* aString, int aSeed)
+{
+	int i;
+
+	// Printable ASCII without spaces so every character is a quad.
+	for (i = 0; i < TEXT_LENGTH; i++)
+	{
+		aString[i] = (char)(33 + (aSeed * 7 + i * 13) % 94);
+	}
+	aString[TEXT_LENGTH] = 0;
+}
+
+void RunTextBenchmark()
+{
+	RingGlyphSource source;
+	GlyphCache glyphCache;
+	TextSystem textSystem;
+	std::vector<SpriteVertex> vertices;
+	std::vector<int> texts;
+	char string[TEXT_LENGTH + 1];
+	int i, frame, quads, layouts;
+	double seconds;
+	std::chrono::high_resolution_clock::time_point start, end;
+
+	if (!glyphCache.Initialize(source, 1024, 32, 0) || !textSystem.Initialize(glyphCache))
+	{
+		printf("Text: could not initialize\n");
+		return;
+	}
+
+	// One line of text per row down the screen.
+	texts.resize(TEXT_COUNT);
+	for (i = 0; i < TEXT_COUNT; i++)
+	{
+		texts[i] = textSystem.CreateText();
+		textSystem.SetPosition(texts[i], 0.0f, -(float)i * 0.05f);
+		textSystem.SetScale(texts[i], 0.002f);
+		FillString(string, i);
+		textSystem.SetText(texts[i], string);
+	}
+	vertices.resize(TEXT_COUNT * TEXT_LENGTH * 4);
+
+	// Warm up, which lays out every text and fills the atlas.
+	textSystem.Update();
+	textSystem.Emit(&vertices[0], TEXT_COUNT * TEXT_LENGTH);
+
+	// Strings that stay the same only have their cached quads copied.
+	quads = 0;
+	layouts = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (frame = 0; frame < FRAME_COUNT; frame++)
+	{
+		for (i = 0; i < TEXT_COUNT; i++)
+		{
+			FillString(string, i);
+			textSystem.SetText(texts[i], string);
+		}
+		textSystem.Update();
+		layouts += textSystem.GetLayoutCount();
+		quads += textSystem.Emit(&vertices[0], TEXT_COUNT * TEXT_LENGTH);
+	}
+	end = std::chrono::high_resolution_clock::now();
+	seconds = std::chrono::duration<double>(end - start).count();
+
+	printf("Text: %d glyphs per frame, unchanged strings %.3f ms per frame, %.2f ns per glyph (%d layouts)\n", quads / FRAME_COUNT,
+		seconds * 1000.0 / FRAME_COUNT, seconds * 1e9 / quads, layouts);
+
+	// Strings that change every frame are laid out again.
+	quads = 0;
+	layouts = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (frame = 0; frame < FRAME_COUNT; frame++)
+	{
+		for (i = 0; i < TEXT_COUNT; i++)
+		{
+			FillString(string, i + frame + 1);
+			textSystem.SetText(texts[i], string);
+		}
+		textSystem.Update();
+		layouts += textSystem.GetLayoutCount();
+		quads += textSystem.Emit(&vertices[0], TEXT_COUNT * TEXT_LENGTH);
+	}
+	end = std::chrono::high_resolution_clock::now();
+	seconds = std::chrono::duration<double>(end - start).count();
+
+	printf("Text: %d glyphs per frame, changing strings %.3f ms per frame, %.2f ns per glyph (%d layouts)\n", quads / FRAME_COUNT,
+		seconds * 1000.0 / FRAME_COUNT, seconds * 1e9 / quads, layouts);
+
+	textSystem.Shutdown();
+	glyphCache.Shutdown();
+
+	// Rasterize the whole character set into a distance field atlas, a cold start of the cache.
+	if (!glyphCache.Initialize(source, 1024, GLYPH_SIZE + DISTANCE_FIELD_SPREAD * 2, DISTANCE_FIELD_SPREAD))
+	{
+		printf("Text: could not initialize\n");
+		return;
+	}
+
+	start = std::chrono::high_resolution_clock::now();
+	for (i = 33; i < 127; i++)
+	{
+		glyphCache.FindGlyph(i);
+	}
+	end = std::chrono::high_resolution_clock::now();
+	seconds = std::chrono::duration<double>(end - start).count();
+
+	printf("Text: %d distance field glyphs of %dx%d in %.3f ms, %.1f us per glyph\n", glyphCache.GetMissCount(), GLYPH_SIZE * 3 / 4, GLYPH_SIZE,
+		seconds * 1000.0, seconds * 1e6 / glyphCache.GetMissCount());
+
+	glyphCache.Shutdown();
+}
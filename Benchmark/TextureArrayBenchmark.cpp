@@ -0,0 +1,76 @@
+#include "Benchmark.h"
+#include "SpriteVertex.h"
+#include "TextureArrayGroups.h"
+#include <algorithm>
+#include <stdio.h>
+#include <vector>
+
+static const int TEXTURE_COUNT = 200;
+static const int SPRITE_COUNT = 4096;
+static const int MAX_SLICES = 256;
+// DXGI_FORMAT_R8G8B8A8_UNORM, the benchmark is built without the graphics headers.
+static const int TEXTURE_FORMAT = 28;
+
+static unsigned int NextRandom(unsigned int& aSeed)
+{
+	aSeed = aSeed * 1664525u + 1013904223u;
+	return aSeed >> 8;
+}
+
+// A draw is needed wherever the view the next sprite samples differs from the one bound for the sprite before it.
+static int CountDraws(const std::vector<int>& aViews)
+{
+	unsigned int i;
+	int draws;
+
+	draws = aViews.empty() ? 0 : 1;
+	for (i = 1; i < aViews.size(); i++)
+	{
+		draws += aViews[i] != aViews[i - 1] ? 1 : 0;
+	}
+	return draws;
+}
+
+void RunTextureArrayBenchmark()
+{
+	TextureArrayGroups groups;
+	TextureArrayGroups::Location locations[TEXTURE_COUNT];
+	std::vector<int> textures, arrays;
+	int i, size, groupCount;
+	unsigned int seed;
+
+	// The images come at three sizes, so they fall into an array for each.
+	if (!groups.Initialize(MAX_SLICES))
+	{
+		printf("Texture arrays: could not initialize\n");
+		return;
+	}
+	for (i = 0; i < TEXTURE_COUNT; i++)
+	{
+		size = 32 << (i % 3);
+		groups.Add(size, size, TEXTURE_FORMAT, locations[i]);
+	}
+	groups.GetGroups(groupCount);
+
+	// Every sprite shows one of the images, in the order the scene submits them.
+	seed = 3;
+	for (i = 0; i < SPRITE_COUNT; i++)
+	{
+		textures.push_back(NextRandom(seed) % TEXTURE_COUNT);
+		arrays.push_back(locations[textures.back()].group);
+	}
+
+	printf("Texture arrays: %d sprites showing %d images, %d arrays of up to %d slices\n", SPRITE_COUNT, TEXTURE_COUNT, groupCount, MAX_SLICES);
+	printf("Texture arrays: a view per image, as submitted:   %5d draws\n", CountDraws(textures));
+	printf("Texture arrays: an array per size, as submitted:  %5d draws\n", CountDraws(arrays));
+
+	// Sorting by what is bound brings each down to one draw per view.
+	std::stable_sort(textures.begin(), textures.end());
+	std::stable_sort(arrays.begin(), arrays.end());
+	printf("Texture arrays: a view per image, sorted:         %5d draws, %d KB of vertices\n", CountDraws(textures),
+		(int)(SPRITE_COUNT * 4 * sizeof(SpriteVertex) / 1024));
+	printf("Texture arrays: an array per size, sorted:        %5d draws, %d KB of vertices\n", CountDraws(arrays),
+		(int)(SPRITE_COUNT * 4 * sizeof(SpriteArrayVertex) / 1024));
+
+	groups.Shutdown();
+}
@@ -0,0 +1,122 @@
+#include "Benchmark.h"
+#include "TextureResidency.h"
+#include <chrono>
+#include <stdio.h>
+#include <vector>
+
+static const int TEXTURE_COUNT = 512;
+static const int WORKING_SET_SIZE = 48;
+static const int FRAME_COUNT = 2000;
+static const int MIN_RESIDENT_SIZE = 64;
+static const long long MEGABYTE = 1024 * 1024;
+
+static unsigned int NextRandom(unsigned int& aSeed)
+{
+	aSeed = aSeed * 1664525u + 1013904223u;
+	return aSeed >> 8;
+}
+
+static void RunTextureResidency(long long aBudget, const std::vector<int>& aSizes, long long aFullBytes)
+{
+	std::chrono::high_resolution_clock::time_point start, end;
+	TextureResidency residency;
+	TextureResidency::Stats stats;
+	const TextureResidency::Change* changes;
+	std::vector<int> textures;
+	long long peakBytes, reloadedBytes, mipBytes;
+	int frame, i, mip, first, changeCount, evictions, reloads, reductions, overBudgetFrames, blurryDraws, draws, texture, random;
+	unsigned int seed;
+	float time;
+
+	if (!residency.Initialize(aBudget, MIN_RESIDENT_SIZE))
+	{
+		printf("Texture residency: could not initialize\n");
+		return;
+	}
+	for (i = 0; i < (int)aSizes.size(); i++)
+	{
+		textures.push_back(residency.AddTexture(aSizes[i], aSizes[i], 4));
+	}
+
+	// A working set that drifts through the textures, the way a camera moving through a level draws what is near it, with the
+	// odd texture from anywhere for the things that fly in.
+	seed = 7;
+	peakBytes = 0;
+	reloadedBytes = 0;
+	evictions = reloads = reductions = overBudgetFrames = blurryDraws = draws = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (frame = 0; frame < FRAME_COUNT; frame++)
+	{
+		residency.BeginFrame();
+		for (i = 0; i < WORKING_SET_SIZE; i++)
+		{
+			residency.Touch(textures[(frame / 8 + i) % TEXTURE_COUNT]);
+		}
+		random = textures[NextRandom(seed) % TEXTURE_COUNT];
+		residency.Touch(random);
+		residency.Update();
+
+		// What comes back to the GPU is what a reload costs, the bytes of the mips that were not resident.
+		changes = residency.GetChanges(changeCount);
+		for (i = 0; i < changeCount; i++)
+		{
+			for (mip = changes[i].firstMip; mip < changes[i].previousFirstMip; mip++)
+			{
+				mipBytes = (long long)TextureUploadQueue::GetMipSize(aSizes[changes[i].texture], mip);
+				reloadedBytes += mipBytes * mipBytes * 4;
+			}
+		}
+
+		// Count the draws that had to make do with fewer mips than the texture has, the one that flew in as well.
+		for (i = 0; i <= WORKING_SET_SIZE; i++)
+		{
+			texture = i < WORKING_SET_SIZE ? textures[(frame / 8 + i) % TEXTURE_COUNT] : random;
+			first = residency.GetFirstMip(texture);
+			blurryDraws += first > 0 ? 1 : 0;
+			draws++;
+		}
+
+		residency.GetStats(stats);
+		peakBytes = stats.residentBytes > peakBytes ? stats.residentBytes : peakBytes;
+		evictions += stats.frameEvictCount;
+		reloads += stats.frameReloadCount;
+		reductions += stats.frameReduceCount;
+		overBudgetFrames += stats.overBudget ? 1 : 0;
+	}
+	end = std::chrono::high_resolution_clock::now();
+	time = std::chrono::duration<float, std::milli>(end - start).count();
+
+	printf("Texture residency: budget %4lld MB (%3d%%), peak %4lld MB, %5d evictions, %5d reductions, %5d reloads, %6.1f MB reloaded, "
+		"%5.1f%% blurry draws, %4d frames over, %.3f ms per frame\n", aBudget / MEGABYTE, (int)(aBudget * 100 / aFullBytes), peakBytes / MEGABYTE,
+		evictions, reductions, reloads, (float)reloadedBytes / MEGABYTE, 100.0f * blurryDraws / draws, overBudgetFrames, time / FRAME_COUNT);
+
+	residency.Shutdown();
+}
+
+void RunTextureResidencyBenchmark()
+{
+	std::vector<int> sizes;
+	long long fullBytes;
+	unsigned int seed;
+	int i, size, scale;
+
+	// Square RGBA textures from 128 to 2048 texels a side, mostly the smaller ones.
+	seed = 1;
+	fullBytes = 0;
+	for (i = 0; i < TEXTURE_COUNT; i++)
+	{
+		scale = NextRandom(seed) % 5;
+		scale = scale * (NextRandom(seed) % 5) / 4;
+		size = 128 << scale;
+		sizes.push_back(size);
+		fullBytes += (long long)size * size * 4 * 4 / 3;
+	}
+
+	// From room for everything down to less than the working set needs at full detail.
+	printf("Texture residency: %d textures, %lld MB with all their mips, %d drawn at a time\n", TEXTURE_COUNT, fullBytes / MEGABYTE,
+		WORKING_SET_SIZE + 1);
+	RunTextureResidency(fullBytes, sizes, fullBytes);
+	RunTextureResidency(fullBytes / 4, sizes, fullBytes);
+	RunTextureResidency(fullBytes / 16, sizes, fullBytes);
+	RunTextureResidency(fullBytes / 64, sizes, fullBytes);
+}
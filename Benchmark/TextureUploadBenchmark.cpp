@@ -0,0 +1,113 @@
+#include "Benchmark.h"
+#include "TextureUploadQueue.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+static const int IMAGE_SIZE = 2048;
+static const int BLOCK_BYTES = 64 * 1024;
+static const int MAX_FRAMES = 10000;
+
+// Stands in for the GPU texture: copies the rows it is handed into a mip chain of its own, the way UpdateSubresource copies
+// them into the driver's memory, and remembers the most detailed mip it may sample.
+class NullUploadTarget : public TextureUploadTarget
+{
+public:
+	NullUploadTarget(int aWidth, int aHeight)
+	{
+		int mip;
+
+		myMostDetailedMip = -1;
+		for (mip = 0; mip < TextureUploadQueue::GetMipCount(aWidth, aHeight); mip++)
+		{
+			myMips.push_back(std::vector<unsigned char>((size_t)TextureUploadQueue::GetMipSize(aWidth, mip) *
+				TextureUploadQueue::GetMipSize(aHeight, mip) * 4));
+		}
+	}
+
+	void UploadRows(int aMip, int aTop, int aBottom, const unsigned char* aPixels, int aRowPitch) override
+	{
+		memcpy(&myMips[aMip][(size_t)aTop * aRowPitch], aPixels, (size_t)(aBottom - aTop) * aRowPitch);
+	}
+
+	void SetMostDetailedMip(int aMip) override
+	{
+		myMostDetailedMip = aMip;
+	}
+
+	std::vector<std::vector<unsigned char>> myMips;
+	int myMostDetailedMip;
+};
+
+static void RunTextureUpload(const char* aName, const unsigned char* aImage, int aMaxBytesPerFrame, float aMaxMilliseconds,
+	NullUploadTarget& aReference)
+{
+	TextureUploadQueue queue;
+	TextureUploadQueue::Stats stats;
+	NullUploadTarget target(IMAGE_SIZE, IMAGE_SIZE);
+	float worstTime, totalTime;
+	int frame, firstMipFrame;
+
+	if (!queue.Initialize(aMaxBytesPerFrame, aMaxMilliseconds, BLOCK_BYTES) || !queue.Submit(aImage, IMAGE_SIZE, IMAGE_SIZE, 0,
+		TextureUploadQueue::GetMipCount(IMAGE_SIZE, IMAGE_SIZE), target))
+	{
+		printf("Texture upload: could not initialize\n");
+		return;
+	}
+
+	// Run frames until the whole chain has arrived, noting the first frame the texture could be drawn at all.
+	worstTime = 0.0f;
+	totalTime = 0.0f;
+	firstMipFrame = -1;
+	for (frame = 0; frame < MAX_FRAMES && queue.IsPending(target); frame++)
+	{
+		queue.Update();
+		queue.GetStats(stats);
+		worstTime = stats.frameTime > worstTime ? stats.frameTime : worstTime;
+		totalTime += stats.frameTime;
+		if (firstMipFrame < 0 && target.myMostDetailedMip >= 0)
+		{
+			firstMipFrame = frame + 1;
+		}
+	}
+
+	printf("Texture upload: %-20s worst frame %6.2f ms, drawable after %3d frames, full detail after %4d frames, %.1f ms in all%s\n",
+		aName, worstTime, firstMipFrame, frame, totalTime, aReference.myMostDetailedMip < 0 || aReference.myMips == target.myMips ? "" : ", MISMATCH");
+
+	// The first run keeps its chain for the others to compare against.
+	if (aReference.myMostDetailedMip < 0)
+	{
+		aReference.myMips = target.myMips;
+		aReference.myMostDetailedMip = target.myMostDetailedMip;
+	}
+
+	queue.Shutdown();
+}
+
+void RunTextureUploadBenchmark()
+{
+	NullUploadTarget reference(IMAGE_SIZE, IMAGE_SIZE);
+	std::vector<unsigned char> image;
+	int x, y;
+
+	// A 16 MB image with detail at every scale, so every mip differs from its neighbours.
+	image.resize((size_t)IMAGE_SIZE * IMAGE_SIZE * 4);
+	for (y = 0; y < IMAGE_SIZE; y++)
+	{
+		for (x = 0; x < IMAGE_SIZE; x++)
+		{
+			image[((size_t)y * IMAGE_SIZE + x) * 4 + 0] = (unsigned char)(x ^ y);
+			image[((size_t)y * IMAGE_SIZE + x) * 4 + 1] = (unsigned char)((x * 7) + (y >> 3));
+			image[((size_t)y * IMAGE_SIZE + x) * 4 + 2] = (unsigned char)((x >> 4) * (y >> 4));
+			image[((size_t)y * IMAGE_SIZE + x) * 4 + 3] = 255;
+		}
+	}
+
+	// Everything in one frame is the hitch of a synchronous load, the budgets spread it out.
+	printf("Texture upload: %dx%d RGBA with %d mips, %d KB blocks\n", IMAGE_SIZE, IMAGE_SIZE, TextureUploadQueue::GetMipCount(IMAGE_SIZE, IMAGE_SIZE),
+		BLOCK_BYTES / 1024);
+	RunTextureUpload("all at once:", image.data(), 0x7fffffff, 1e9f, reference);
+	RunTextureUpload("4 MB or 4 ms:", image.data(), 4 * 1024 * 1024, 4.0f, reference);
+	RunTextureUpload("1 MB or 1 ms:", image.data(), 1024 * 1024, 1.0f, reference);
+	RunTextureUpload("256 KB or 0.5 ms:", image.data(), 256 * 1024, 0.5f, reference);
+}
@@ -0,0 +1,81 @@
+#include "Benchmark.h"
+#include "Tilemap.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+static const int MAP_SIZE = 4096;
+static const int EDIT_COUNT = 100;
+
+void RunTilemapBenchmark()
+{
+	Tilemap tilemap;
+	SpriteVertex* vertices;
+	int x, y, chunk, chunkCount, rebuilt;
+	long long quads;
+	double seconds;
+	std::chrono::high_resolution_clock::time_point start, end;
+
+	if (!tilemap.Initialize(MAP_SIZE, MAP_SIZE, 1.0f, 0.0f, 0.0f, 16, 16))
+	{
+		printf("Tilemap: could not initialize\n");
+		return;
+	}
+
+	// Fill the map with a pattern of tiles and holes.
+	for (y = 0; y < MAP_SIZE; y++)
+	{
+		for (x = 0; x < MAP_SIZE; x++)
+		{
+			if (((x / 7) + (y / 5)) % 9 != 0)
+			{
+				tilemap.SetTile(x, y, (unsigned short)(1 + ((x * 31) ^ (y * 17)) % 256));
+			}
+		}
+	}
+
+	vertices = new SpriteVertex[TILEMAP_CHUNK_SIZE * TILEMAP_CHUNK_SIZE * 4];
+	chunkCount = tilemap.GetChunkCount();
+
+	// Build the mesh of every chunk, as a full load of the level would.
+	quads = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (chunk = 0; chunk < chunkCount; chunk++)
+	{
+		quads += tilemap.BuildChunkMesh(chunk, vertices);
+		tilemap.ClearChunkDirty(chunk);
+	}
+	end = std::chrono::high_resolution_clock::now();
+	seconds = std::chrono::duration<double>(end - start).count();
+
+	printf("Tilemap: %dx%d tiles, %d chunks, full build %.1f ms, %.1f us per chunk, %.2f ns per tile (%lld quads)\n", MAP_SIZE, MAP_SIZE,
+		chunkCount, seconds * 1000.0, seconds * 1e6 / chunkCount, seconds * 1e9 / ((double)MAP_SIZE * MAP_SIZE), quads);
+	printf("Tilemap: full build uploads %.1f MB of %d byte vertices, indices come from the shared quad index buffer\n",
+		quads * 4.0 * sizeof(SpriteVertex) / (1024.0 * 1024.0), (int)sizeof(SpriteVertex));
+
+	// Change a few scattered tiles and rebuild only the chunks they dirtied, as an editor or destructible level would.
+	srand(1234);
+	for (x = 0; x < EDIT_COUNT; x++)
+	{
+		tilemap.SetTile(rand() % MAP_SIZE, rand() % MAP_SIZE, (unsigned short)(rand() % 257));
+	}
+
+	rebuilt = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (chunk = 0; chunk < chunkCount; chunk++)
+	{
+		if (tilemap.IsChunkDirty(chunk))
+		{
+			tilemap.BuildChunkMesh(chunk, vertices);
+			tilemap.ClearChunkDirty(chunk);
+			rebuilt++;
+		}
+	}
+	end = std::chrono::high_resolution_clock::now();
+	seconds = std::chrono::duration<double>(end - start).count();
+
+	printf("Tilemap: %d tile edits, %d chunks rebuilt in %.3f ms\n", EDIT_COUNT, rebuilt, seconds * 1000.0);
+
+	delete[] vertices;
+	tilemap.Shutdown();
+}
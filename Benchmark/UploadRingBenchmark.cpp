@@ -0,0 +1,147 @@
+#include "Benchmark.h"
+#include "RingAllocator.h"
+#include <chrono>
+#include <stdio.h>
+#include <vector>
+
+static const int FRAME_COUNT = 20000;
+static const int FENCE_COUNT = 4;
+static const size_t VERTEX_SIZE = 12;
+static const int MAX_SPRITES = 4096;
+static const int MAX_PARTICLES = 65536;
+static const int MAX_GLYPHS = 1024;
+static const int TEXT_GLYPHS = 180;
+
+// A range written during a frame, kept until the simulated GPU has passed the fence of its frame.
+struct LiveRange
+{
+	unsigned long long fence;
+	int generation;
+	size_t offset;
+	size_t size;
+};
+
+// A range reserved for the most quads of a batch and trimmed to the ones written, the way the sprite batches use the ring.
+static bool WriteBatch(RingAllocator& aAllocator, int aMaxQuads, int aQuadCount, unsigned long long aFence, int& aGeneration,
+	std::vector<LiveRange>* aLiveRanges, int& aOverlapCount)
+{
+	LiveRange range;
+	const LiveRange* live;
+	size_t offset;
+	unsigned int i;
+	bool discard;
+
+	if (!aAllocator.Allocate(VERTEX_SIZE * 4 * aMaxQuads, VERTEX_SIZE, offset, discard))
+	{
+		return false;
+	}
+	aAllocator.Trim(VERTEX_SIZE * 4 * aQuadCount);
+	if (aLiveRanges == nullptr || aQuadCount == 0)
+	{
+		return true;
+	}
+
+	// A discard hands out fresh memory, the ranges of the old buffer can no longer be overwritten.
+	if (discard)
+	{
+		aGeneration++;
+	}
+	range.fence = aFence;
+	range.generation = aGeneration;
+	range.offset = offset;
+	range.size = VERTEX_SIZE * 4 * aQuadCount;
+	for (i = 0; i < aLiveRanges->size(); i++)
+	{
+		live = &(*aLiveRanges)[i];
+		if (live->generation == range.generation && live->offset < range.offset + range.size && range.offset < live->offset + live->size)
+		{
+			aOverlapCount++;
+		}
+	}
+	aLiveRanges->push_back(range);
+
+	return true;
+}
+
+static void RunUploadRing(size_t aCapacity, int aGpuLatency, bool aValidate)
+{
+	RingAllocator allocator;
+	RingAllocator::Stats stats;
+	std::vector<LiveRange> liveRanges;
+	unsigned long long fence, completedFence;
+	int frame, particleCount, generation, overlapCount, failedCount;
+	unsigned int i, kept;
+	double seconds;
+	std::chrono::high_resolution_clock::time_point start, end;
+
+	if (!allocator.Initialize(aCapacity, FENCE_COUNT))
+	{
+		printf("Upload ring: could not initialize\n");
+		return;
+	}
+
+	// Every frame writes the sprites, a particle count that swells and fades, and the text. The null GPU finishes each frame
+	// a fixed number of frames after it was submitted.
+	generation = 0;
+	overlapCount = 0;
+	failedCount = 0;
+	fence = 1;
+	start = std::chrono::high_resolution_clock::now();
+	for (frame = 0; frame < FRAME_COUNT; frame++)
+	{
+		completedFence = fence > (unsigned long long)aGpuLatency ? fence - aGpuLatency : 0;
+		allocator.BeginFrame(completedFence);
+		if (aValidate)
+		{
+			kept = 0;
+			for (i = 0; i < liveRanges.size(); i++)
+			{
+				if (liveRanges[i].fence > completedFence)
+				{
+					liveRanges[kept++] = liveRanges[i];
+				}
+			}
+			liveRanges.resize(kept);
+		}
+
+		particleCount = (frame * 97) % (MAX_PARTICLES * 2);
+		particleCount = particleCount > MAX_PARTICLES ? MAX_PARTICLES * 2 - particleCount : particleCount;
+		failedCount += WriteBatch(allocator, MAX_PARTICLES, particleCount, fence, generation, aValidate ? &liveRanges : nullptr,
+			overlapCount) ? 0 : 1;
+		failedCount += WriteBatch(allocator, MAX_SPRITES, MAX_SPRITES, fence, generation, aValidate ? &liveRanges : nullptr,
+			overlapCount) ? 0 : 1;
+		failedCount += WriteBatch(allocator, MAX_GLYPHS, TEXT_GLYPHS, fence, generation, aValidate ? &liveRanges : nullptr,
+			overlapCount) ? 0 : 1;
+		fence = allocator.EndFrame() + 1;
+	}
+	end = std::chrono::high_resolution_clock::now();
+	seconds = std::chrono::duration<double>(end - start).count();
+	allocator.GetStats(stats);
+
+	if (aValidate)
+	{
+		printf("Upload ring: %2d MB, GPU %d frames behind: %6lld allocations, %5d wraps, %5d discards (%.1f%% of frames), %.1f MB per frame%s\n",
+			(int)(aCapacity / (1024 * 1024)), aGpuLatency, stats.allocationCount, stats.wrapCount, stats.discardCount,
+			stats.discardCount * 100.0 / FRAME_COUNT, stats.allocatedBytes / (1024.0 * 1024.0) / FRAME_COUNT,
+			overlapCount == 0 && failedCount == 0 ? "" : ", OVERWRITES IN FLIGHT");
+	}
+	else
+	{
+		printf("Upload ring: %2d MB, GPU %d frames behind: %.1f ns per allocation\n", (int)(aCapacity / (1024 * 1024)), aGpuLatency,
+			seconds * 1e9 / stats.allocationCount);
+	}
+
+	allocator.Shutdown();
+}
+
+void RunUploadRingBenchmark()
+{
+	// Too small a ring has to discard whenever a frame does not fit behind the ones in flight. The GPU running more frames
+	// behind than there are fences folds frames together, which holds on to their ranges longer.
+	RunUploadRing(4 * 1024 * 1024, 2, true);
+	RunUploadRing(8 * 1024 * 1024, 2, true);
+	RunUploadRing(16 * 1024 * 1024, 2, true);
+	RunUploadRing(16 * 1024 * 1024, 3, true);
+	RunUploadRing(16 * 1024 * 1024, 6, true);
+	RunUploadRing(16 * 1024 * 1024, 2, false);
+}
@@ -0,0 +1,95 @@
+#include "Benchmark.h"
+#include "MicroBenchmark.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int main(int argc, char* argv[])
+{
+	MicroBenchmark microBenchmark;
+	const char* jsonPath;
+	const char* filter;
+	int i, warmup, repetitions;
+	bool result;
+
+	// Parse the options, --json writes the micro benchmark results for a script to compare against a baseline.
+	jsonPath = nullptr;
+	filter = nullptr;
+	warmup = MICRO_BENCHMARK_WARMUP;
+	repetitions = MICRO_BENCHMARK_REPETITIONS;
+	for (i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+		{
+			jsonPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+		{
+			filter = argv[++i];
+		}
+		else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+		{
+			warmup = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc)
+		{
+			repetitions = atoi(argv[++i]);
+		}
+		else
+		{
+			printf("Usage: %s [--json path] [--filter text] [--warmup count] [--repetitions count]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	// Run every benchmark in turn, each one prints its own results. A filter narrows the run down to the micro benchmarks.
+	if (filter == nullptr)
+	{
+		RunSpriteAnimationBenchmark();
+		RunParticleBenchmark();
+		RunTilemapBenchmark();
+		RunCollisionBenchmark();
+		RunTextBenchmark();
+		RunAllocatorBenchmark();
+		RunHandleBenchmark();
+		RunSceneBenchmark();
+		RunStreamingBenchmark();
+		RunOverdrawBenchmark();
+		RunSpriteMeshBenchmark();
+		RunLightCullingBenchmark();
+		RunUploadRingBenchmark();
+		RunTextureUploadBenchmark();
+		RunTextureResidencyBenchmark();
+		RunTextureArrayBenchmark();
+		RunRenderGraphBenchmark();
+	}
+
+	// Time the hot paths with repeatable statistics.
+	result = microBenchmark.Initialize(filter, warmup, repetitions);
+	if (!result)
+	{
+		printf("Invalid warm-up or repetition count.\n");
+		return 1;
+	}
+	RunHotPathBenchmarks(microBenchmark);
+	if (jsonPath != nullptr)
+	{
+		result = microBenchmark.WriteJson(jsonPath);
+		if (!result)
+		{
+			printf("Could not write %s.\n", jsonPath);
+			microBenchmark.Shutdown();
+			return 1;
+		}
+	}
+	microBenchmark.Shutdown();
+
+	// Checks fail the run so a test script can rely on the exit code.
+	result = RunSteadyStateAllocationCheck();
+	if (!result)
+	{
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,294 @@
+#include "AllocationTracker.h"
+#include <algorithm>
+#include <new>
+#include <stdlib.h>
+
+// Allocations made outside of any scope.
+static AllocationSite untaggedSite("Untagged", "", 0);
+
+// Registered sites, written once each and never removed.
+static std::atomic<AllocationSite*> sites[MAX_ALLOCATION_SITES];
+static std::atomic<int> siteCount(0);
+
+// The innermost scope of each thread.
+static thread_local AllocationSite* currentSite = nullptr;
+
+// Totals of all threads.
+static std::atomic<int> frameHeapAllocationCount(0);
+static std::atomic<long long> frameHeapBytes(0);
+static std::atomic<int> frameEngineAllocationCount(0);
+static std::atomic<long long> frameEngineBytes(0);
+static std::atomic<long long> totalHeapAllocationCount(0);
+static std::atomic<long long> liveHeapBytes(0);
+static std::atomic<bool> expectNoAllocations(false);
+
+AllocationSite::AllocationSite(const char* aSubsystem, const char* aFile, int aLine)
+	: subsystem(aSubsystem), file(aFile), line(aLine), count(0), bytes(0), frameCount(0), frameBytes(0)
+{
+	AllocationTracker::RegisterSite(*this);
+}
+
+AllocationScope::AllocationScope(AllocationSite& aSite)
+{
+	myPreviousSite = currentSite;
+	currentSite = &aSite;
+}
+
+AllocationScope::~AllocationScope()
+{
+	currentSite = myPreviousSite;
+}
+
+void AllocationTracker::RecordHeapAllocation(size_t aSize)
+{
+	AllocationSite& site = GetCurrentSite();
+
+	site.count++;
+	site.bytes += aSize;
+	site.frameCount++;
+	site.frameBytes += aSize;
+
+	frameHeapAllocationCount++;
+	frameHeapBytes += aSize;
+	totalHeapAllocationCount++;
+	liveHeapBytes += aSize;
+
+	// Report the offending site and stop, a debugger catches the abort at the allocation itself.
+	if (expectNoAllocations)
+	{
+		expectNoAllocations = false;
+		fprintf(stderr, "Heap allocation of %zu bytes in a frame that expected none, site %s %s:%d\n", aSize, site.subsystem,
+			site.file, site.line);
+		abort();
+	}
+}
+
+void AllocationTracker::RecordHeapFree(size_t aSize)
+{
+	liveHeapBytes -= aSize;
+}
+
+void AllocationTracker::RecordEngineAllocation(size_t aSize)
+{
+	frameEngineAllocationCount++;
+	frameEngineBytes += aSize;
+}
+
+void AllocationTracker::BeginFrame()
+{
+	AllocationSite* site;
+	int i, count;
+
+	// Start the per frame counters over.
+	frameHeapAllocationCount = 0;
+	frameHeapBytes = 0;
+	frameEngineAllocationCount = 0;
+	frameEngineBytes = 0;
+
+	untaggedSite.frameCount = 0;
+	untaggedSite.frameBytes = 0;
+	count = siteCount;
+	for (i = 0; i < count; i++)
+	{
+		site = sites[i];
+		if (site != nullptr)
+		{
+			site->frameCount = 0;
+			site->frameBytes = 0;
+		}
+	}
+}
+
+void AllocationTracker::SetExpectNoAllocations(bool aExpectNoAllocations)
+{
+	expectNoAllocations = aExpectNoAllocations;
+}
+
+int AllocationTracker::GetFrameHeapAllocationCount()
+{
+	return frameHeapAllocationCount;
+}
+
+long long AllocationTracker::GetFrameHeapBytes()
+{
+	return frameHeapBytes;
+}
+
+int AllocationTracker::GetFrameEngineAllocationCount()
+{
+	return frameEngineAllocationCount;
+}
+
+long long AllocationTracker::GetFrameEngineBytes()
+{
+	return frameEngineBytes;
+}
+
+long long AllocationTracker::GetTotalHeapAllocationCount()
+{
+	return totalHeapAllocationCount;
+}
+
+long long AllocationTracker::GetLiveHeapBytes()
+{
+	return liveHeapBytes;
+}
+
+void AllocationTracker::DumpTopSites(FILE* aFile, int aCount)
+{
+	AllocationSite* sorted[MAX_ALLOCATION_SITES + 1];
+	int i, count, total;
+
+	// Gather the sites, the untagged one included.
+	total = siteCount;
+	count = 0;
+	for (i = 0; i < total; i++)
+	{
+		if (sites[i] != nullptr)
+		{
+			sorted[count] = sites[i];
+			count++;
+		}
+	}
+	sorted[count] = &untaggedSite;
+	count++;
+
+	// Largest number of allocations first.
+	std::sort(sorted, sorted + count, [](const AllocationSite* aFirst, const AllocationSite* aSecond)
+	{
+		return aFirst->count > aSecond->count;
+	});
+
+	fprintf(aFile, "%-12s %12s %14s %10s  %s\n", "Subsystem", "Allocations", "Bytes", "Last frame", "Site");
+	for (i = 0; i < count && i < aCount && sorted[i]->count > 0; i++)
+	{
+		fprintf(aFile, "%-12s %12lld %14lld %10d  %s:%d\n", sorted[i]->subsystem, (long long)sorted[i]->count,
+			(long long)sorted[i]->bytes, (int)sorted[i]->frameCount, sorted[i]->file, sorted[i]->line);
+	}
+}
+
+void AllocationTracker::RegisterSite(AllocationSite& aSite)
+{
+	int index;
+
+	// The untagged site is not in the table, it is always there.
+	if (&aSite == &untaggedSite)
+	{
+		return;
+	}
+
+	// Sites past the end of the table are charged to the untagged one.
+	index = siteCount.fetch_add(1);
+	if (index >= MAX_ALLOCATION_SITES)
+	{
+		siteCount = MAX_ALLOCATION_SITES;
+		return;
+	}
+	sites[index] = &aSite;
+}
+
+AllocationSite& AllocationTracker::GetCurrentSite()
+{
+	return currentSite != nullptr ? *currentSite : untaggedSite;
+}
+
+#ifdef ALLOCATION_TRACKING
+
+// Every heap block starts with a header holding its size so frees can be counted in bytes.
+// The header is as large as the alignment operator new guarantees so the block after it stays aligned.
+static const size_t HEADER_SIZE = 16;
+
+static void* TrackedAllocate(size_t aSize)
+{
+	unsigned char* block;
+
+	block = (unsigned char*)malloc(aSize + HEADER_SIZE);
+	if (block == nullptr)
+	{
+		return nullptr;
+	}
+	*(size_t*)block = aSize;
+
+	AllocationTracker::RecordHeapAllocation(aSize);
+	return block + HEADER_SIZE;
+}
+
+static void TrackedFree(void* aPointer)
+{
+	unsigned char* block;
+
+	if (aPointer == nullptr)
+	{
+		return;
+	}
+
+	block = (unsigned char*)aPointer - HEADER_SIZE;
+	AllocationTracker::RecordHeapFree(*(size_t*)block);
+	free(block);
+}
+
+void* operator new(size_t aSize)
+{
+	void* pointer;
+
+	pointer = TrackedAllocate(aSize);
+	if (pointer == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return pointer;
+}
+
+void* operator new[](size_t aSize)
+{
+	void* pointer;
+
+	pointer = TrackedAllocate(aSize);
+	if (pointer == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return pointer;
+}
+
+void* operator new(size_t aSize, const std::nothrow_t&) noexcept
+{
+	return TrackedAllocate(aSize);
+}
+
+void* operator new[](size_t aSize, const std::nothrow_t&) noexcept
+{
+	return TrackedAllocate(aSize);
+}
+
+void operator delete(void* aPointer) noexcept
+{
+	TrackedFree(aPointer);
+}
+
+void operator delete[](void* aPointer) noexcept
+{
+	TrackedFree(aPointer);
+}
+
+void operator delete(void* aPointer, size_t) noexcept
+{
+	TrackedFree(aPointer);
+}
+
+void operator delete[](void* aPointer, size_t) noexcept
+{
+	TrackedFree(aPointer);
+}
+
+void operator delete(void* aPointer, const std::nothrow_t&) noexcept
+{
+	TrackedFree(aPointer);
+}
+
+void operator delete[](void* aPointer, const std::nothrow_t&) noexcept
+{
+	TrackedFree(aPointer);
+}
+
+#endif
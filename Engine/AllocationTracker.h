@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdio.h>
+
+// Most call sites that can be told apart, further sites are counted as untagged.
+const int MAX_ALLOCATION_SITES = 256;
+
+// A place in the code that allocations are charged to, with the subsystem it belongs to.
+struct AllocationSite
+{
+	AllocationSite(const char* aSubsystem, const char* aFile, int aLine);
+
+	const char* subsystem;
+	const char* file;
+	int line;
+	std::atomic<long long> count;
+	std::atomic<long long> bytes;
+	std::atomic<int> frameCount;
+	std::atomic<long long> frameBytes;
+};
+
+// Charges every heap allocation made on this thread while it exists to a site, the innermost scope wins.
+class AllocationScope
+{
+public:
+	AllocationScope(AllocationSite& aSite);
+	AllocationScope(const AllocationScope& aAllocationScope) = delete;
+	~AllocationScope();
+
+private:
+	AllocationSite* myPreviousSite;
+};
+
+// Counts heap allocations made through global operator new and allocations made from the engine's own allocators.
+// Builds with ALLOCATION_TRACKING defined replace global operator new and delete, other builds compile the tracking
+// away. Counters are per frame, between two calls to BeginFrame, and in total. While no allocations are expected any
+// heap allocation prints its site and aborts, which is how a test run proves a warmed up frame does not touch the heap.
+class AllocationTracker
+{
+public:
+	static void RecordHeapAllocation(size_t aSize);
+	static void RecordHeapFree(size_t aSize);
+	static void RecordEngineAllocation(size_t aSize);
+
+	static void BeginFrame();
+	static void SetExpectNoAllocations(bool aExpectNoAllocations);
+
+	static int GetFrameHeapAllocationCount();
+	static long long GetFrameHeapBytes();
+	static int GetFrameEngineAllocationCount();
+	static long long GetFrameEngineBytes();
+	static long long GetTotalHeapAllocationCount();
+	static long long GetLiveHeapBytes();
+
+	static void DumpTopSites(FILE* aFile, int aCount);
+
+private:
+	friend struct AllocationSite;
+	friend class AllocationScope;
+
+	static void RegisterSite(AllocationSite& aSite);
+	static AllocationSite& GetCurrentSite();
+};
+
+#ifdef ALLOCATION_TRACKING
+#define ALLOCATION_JOIN(aFirst, aSecond) aFirst##aSecond
+#define ALLOCATION_NAME(aName, aLine) ALLOCATION_JOIN(aName, aLine)
+#define ALLOCATION_SCOPE(aSubsystem) \
+	static AllocationSite ALLOCATION_NAME(allocationSite, __LINE__)(aSubsystem, __FILE__, __LINE__); \
+	AllocationScope ALLOCATION_NAME(allocationScope, __LINE__)(ALLOCATION_NAME(allocationSite, __LINE__))
+#else
+#define ALLOCATION_SCOPE(aSubsystem)
+#endif
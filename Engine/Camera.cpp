@@ -1,4 +1,5 @@
 #include "Camera.h"
+#include <math.h>
 
 Camera::Camera()
 {
@@ -11,10 +12,6 @@ Camera::Camera()
 	myRotationZ = 0.0f;
 }
 
-Camera::Camera(const Camera& aCamera)
-{
-}
-
 Camera::~Camera()
 {
 }
@@ -97,4 +94,25 @@ void Camera::Render()
 void Camera::GetViewMatrix(XMMATRIX& aViewMatrix)
 {
 	aViewMatrix = myViewMatrix;
-}
\ No newline at end of file
+}
+
+void Camera::GetViewRect(const float aFieldOfView, const float aAspect, const float aPlaneZ, float& aLeft, float& aBottom, float& aRight, float& aTop)
+{
+	float distance, halfHeight, halfWidth;
+
+	// Distance from the camera to the plane, the camera looks down the z axis without rotation.
+	distance = aPlaneZ - myPositionZ;
+	if (distance < 0.0f)
+	{
+		distance = 0.0f;
+	}
+
+	// Half the size of the area the view covers on the plane.
+	halfHeight = distance * tanf(aFieldOfView * 0.5f);
+	halfWidth = halfHeight * aAspect;
+
+	aLeft = myPositionX - halfWidth;
+	aRight = myPositionX + halfWidth;
+	aBottom = myPositionY - halfHeight;
+	aTop = myPositionY + halfHeight;
+}
\ No newline at end of file
@@ -7,7 +7,7 @@ class Camera
 {
 public:
 	Camera();
-	Camera(const Camera& aCamera);
+	Camera(const Camera& aCamera) = delete;
 	~Camera();
 
 	void SetPosition(const float aX, const float aY, const float aZ);
@@ -18,6 +18,7 @@ public:
 
 	void Render();
 	void GetViewMatrix(XMMATRIX& aViewMatrix);
+	void GetViewRect(const float aFieldOfView, const float aAspect, const float aPlaneZ, float& aLeft, float& aBottom, float& aRight, float& aTop);
 
 private:
 	float myPositionX;
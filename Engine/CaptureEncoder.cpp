@@ -0,0 +1,234 @@
+#include "CaptureEncoder.h"
+#include "ImageWriter.h"
+#include <stdio.h>
+#include <string.h>
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+static FILE* OpenFile(const char* aPath, const char* aMode)
+{
+	FILE* file;
+
+#if defined(_WIN32)
+	if (fopen_s(&file, aPath, aMode) != 0)
+	{
+		file = nullptr;
+	}
+#else
+	file = fopen(aPath, aMode);
+#endif
+	return file;
+}
+
+static void MakeDirectory(const char* aPath)
+{
+	// A directory that is already there is fine, anything else shows up when the first frame cannot be written.
+#if defined(_WIN32)
+	_mkdir(aPath);
+#else
+	mkdir(aPath, 0755);
+#endif
+}
+
+CaptureEncoder::CaptureEncoder()
+{
+	myFirstJob = 0;
+	myJobCount = 0;
+	myDirectory[0] = '\0';
+	myFormat = FORMAT_PNG;
+	myWidth = 0;
+	myHeight = 0;
+	myWrittenCount = 0;
+	myFailedCount = 0;
+	myQuit = false;
+}
+
+CaptureEncoder::~CaptureEncoder()
+{
+}
+
+bool CaptureEncoder::Initialize(const char* aDirectory, Format aFormat, int aWidth, int aHeight, int aBufferCount)
+{
+	int i;
+
+	if (aDirectory == nullptr || aWidth <= 0 || aHeight <= 0 || aBufferCount <= 0)
+	{
+		return false;
+	}
+	snprintf(myDirectory, sizeof(myDirectory), "%s", aDirectory);
+	MakeDirectory(myDirectory);
+	myFormat = aFormat;
+	myWidth = aWidth;
+	myHeight = aHeight;
+
+	// Create the pixel buffers, all of them free, and room to queue every one of them.
+	for (i = 0; i < aBufferCount; i++)
+	{
+		myBuffers.push_back(new unsigned char[(size_t)myWidth * myHeight * 4]);
+		myFreeBuffers.push_back(myBuffers.back());
+	}
+	myJobs.resize(aBufferCount);
+	myFirstJob = 0;
+	myJobCount = 0;
+	myWrittenCount = 0;
+	myFailedCount = 0;
+	myQuit = false;
+
+	// Start the encoder thread.
+	myThread = std::thread(&CaptureEncoder::EncoderLoop, this);
+
+	return true;
+}
+
+void CaptureEncoder::Shutdown()
+{
+	unsigned int i;
+
+	// Let the encoder write what is still queued, then stop it.
+	if (myThread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(myMutex);
+			myQuit = true;
+		}
+		myWorkCondition.notify_one();
+		myThread.join();
+	}
+
+	// Release the pixel buffers.
+	for (i = 0; i < myBuffers.size(); i++)
+	{
+		delete[] myBuffers[i];
+	}
+	myBuffers.clear();
+	myFreeBuffers.clear();
+	myJobs.clear();
+	myJobCount = 0;
+	std::vector<unsigned char>().swap(myFile);
+}
+
+unsigned char* CaptureEncoder::AcquireBuffer(bool aWait)
+{
+	unsigned char* buffer;
+	std::unique_lock<std::mutex> lock(myMutex);
+
+	// Without a free buffer either wait for the encoder to hand one back or give up on the frame.
+	if (myFreeBuffers.empty())
+	{
+		if (!aWait)
+		{
+			return nullptr;
+		}
+		myFreeCondition.wait(lock, [this] { return !myFreeBuffers.empty(); });
+	}
+
+	buffer = myFreeBuffers.back();
+	myFreeBuffers.pop_back();
+	return buffer;
+}
+
+void CaptureEncoder::Submit(unsigned char* aBuffer, int aFrame)
+{
+	Job job;
+
+	job.pixels = aBuffer;
+	job.frame = aFrame;
+
+	// Queue the frame behind the ones already waiting, there is a slot for every buffer so the queue never overflows.
+	{
+		std::lock_guard<std::mutex> lock(myMutex);
+		myJobs[(myFirstJob + myJobCount) % myJobs.size()] = job;
+		myJobCount++;
+	}
+	myWorkCondition.notify_one();
+}
+
+void CaptureEncoder::Flush()
+{
+	std::unique_lock<std::mutex> lock(myMutex);
+
+	// Every frame is written once all buffers are back.
+	myFreeCondition.wait(lock, [this] { return myFreeBuffers.size() == myBuffers.size(); });
+}
+
+int CaptureEncoder::GetWrittenCount()
+{
+	return myWrittenCount;
+}
+
+int CaptureEncoder::GetFailedCount()
+{
+	return myFailedCount;
+}
+
+void CaptureEncoder::EncoderLoop()
+{
+	Job job;
+	bool result;
+
+	for (;;)
+	{
+		// Sleep until a frame is queued, and only leave once the queue is empty.
+		{
+			std::unique_lock<std::mutex> lock(myMutex);
+			myWorkCondition.wait(lock, [this] { return myJobCount > 0 || myQuit; });
+			if (myJobCount == 0)
+			{
+				return;
+			}
+			job = myJobs[myFirstJob];
+			myFirstJob = (myFirstJob + 1) % (int)myJobs.size();
+			myJobCount--;
+		}
+
+		// Encode and write the frame outside the lock so the capture can queue the next one meanwhile.
+		result = WriteFrame(job);
+		if (result)
+		{
+			myWrittenCount++;
+		}
+		else
+		{
+			myFailedCount++;
+		}
+
+		// Hand the buffer back.
+		{
+			std::lock_guard<std::mutex> lock(myMutex);
+			myFreeBuffers.push_back(job.pixels);
+		}
+		myFreeCondition.notify_one();
+	}
+}
+
+bool CaptureEncoder::WriteFrame(const Job& aJob)
+{
+	char path[300];
+	FILE* file;
+	size_t written;
+
+	// Encode the whole file into the buffer that is reused for every frame, then write it with one call.
+	if (myFormat == FORMAT_PNG)
+	{
+		EncodePng(aJob.pixels, myWidth, myHeight, myFile);
+		snprintf(path, sizeof(path), "%s/frame_%06d.png", myDirectory, aJob.frame);
+	}
+	else
+	{
+		EncodeTarga(aJob.pixels, myWidth, myHeight, myFile);
+		snprintf(path, sizeof(path), "%s/frame_%06d.tga", myDirectory, aJob.frame);
+	}
+
+	file = OpenFile(path, "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+	written = fwrite(&myFile[0], 1, myFile.size(), file);
+	fclose(file);
+
+	return written == myFile.size();
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// Writes captured frames to an image sequence on a thread of its own, so encoding and disk writes never hold up a frame.
+// Frames travel in a fixed set of pixel buffers: the capture takes a free one, fills it and submits it, the encoder
+// thread writes it and hands it back. When every buffer is in flight the capture either waits or drops the frame.
+class CaptureEncoder
+{
+public:
+	enum Format
+	{
+		FORMAT_PNG,
+		FORMAT_TARGA
+	};
+
+	CaptureEncoder();
+	CaptureEncoder(const CaptureEncoder& aCaptureEncoder) = delete;
+	~CaptureEncoder();
+
+	bool Initialize(const char* aDirectory, Format aFormat, int aWidth, int aHeight, int aBufferCount);
+	void Shutdown();
+
+	unsigned char* AcquireBuffer(bool aWait);
+	void Submit(unsigned char* aBuffer, int aFrame);
+	void Flush();
+
+	int GetWrittenCount();
+	int GetFailedCount();
+
+private:
+	struct Job
+	{
+		unsigned char* pixels;
+		int frame;
+	};
+
+	void EncoderLoop();
+	bool WriteFrame(const Job& aJob);
+
+	std::thread myThread;
+	std::mutex myMutex;
+	std::condition_variable myWorkCondition;
+	std::condition_variable myFreeCondition;
+
+	std::vector<unsigned char*> myBuffers;
+	std::vector<unsigned char*> myFreeBuffers;
+	std::vector<Job> myJobs;
+	int myFirstJob;
+	int myJobCount;
+	std::vector<unsigned char> myFile;
+
+	char myDirectory[260];
+	Format myFormat;
+	int myWidth;
+	int myHeight;
+	std::atomic<int> myWrittenCount;
+	std::atomic<int> myFailedCount;
+	bool myQuit;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+// Axis aligned bounding box in world units.
+struct AABB
+{
+	float minX;
+	float minY;
+	float maxX;
+	float maxY;
+};
+
+// Two overlapping boxes, identified by their index in the box array with the smaller index first.
+struct CollisionPair
+{
+	int a;
+	int b;
+};
+
+// Builds boxes from the center positions and sizes the sprites are drawn with.
+// The strides are in floats, so XMFLOAT3 positions use a stride of 3 and XMFLOAT2 sizes a stride of 2.
+inline void ComputeBoxes(const float* aPositions, int aPositionStride, const float* aSizes, int aSizeStride, int aCount, AABB* aBoxes)
+{
+	int i;
+	float halfWidth, halfHeight;
+
+	for (i = 0; i < aCount; i++)
+	{
+		halfWidth = aSizes[0] * 0.5f;
+		halfHeight = aSizes[1] * 0.5f;
+
+		aBoxes[i].minX = aPositions[0] - halfWidth;
+		aBoxes[i].maxX = aPositions[0] + halfWidth;
+		aBoxes[i].minY = aPositions[1] - halfHeight;
+		aBoxes[i].maxY = aPositions[1] + halfHeight;
+
+		aPositions += aPositionStride;
+		aSizes += aSizeStride;
+	}
+}
+
+// Grows a box so it also covers another one.
+inline void MergeBoxes(AABB& aBounds, const AABB& aBox)
+{
+	aBounds.minX = aBox.minX < aBounds.minX ? aBox.minX : aBounds.minX;
+	aBounds.minY = aBox.minY < aBounds.minY ? aBox.minY : aBounds.minY;
+	aBounds.maxX = aBox.maxX > aBounds.maxX ? aBox.maxX : aBounds.maxX;
+	aBounds.maxY = aBox.maxY > aBounds.maxY ? aBox.maxY : aBounds.maxY;
+}
+
+// Writes the indices of the boxes that overlap the view into aVisible and returns how many there are.
+inline int CullBoxes(const AABB* aBoxes, int aCount, const AABB& aView, int* aVisible)
+{
+	int i, count;
+
+	count = 0;
+	for (i = 0; i < aCount; i++)
+	{
+		// Branch free, so the loop costs the same however many boxes are visible.
+		aVisible[count] = i;
+		count += (aBoxes[i].maxX >= aView.minX) & (aBoxes[i].minX <= aView.maxX) & (aBoxes[i].maxY >= aView.minY) & (aBoxes[i].minY <= aView.maxY);
+	}
+	return count;
+}
@@ -3,25 +3,269 @@
 D3DClass::D3DClass()
 {
 	mySwapChain = nullptr;
+	myFrameQuery = nullptr;
 	myDevice = nullptr;
 	myDeviceContext = nullptr;
 	myRenderTargetView = nullptr;
+	myBackBuffer = nullptr;
 	myDepthStencilBuffer = nullptr;
 	myDepthStencilState = nullptr;
+	myDepthReadOnlyStencilState = nullptr;
+	myDepthDisabledStencilState = nullptr;
 	myDepthStencilView = nullptr;
 	myRasterState = nullptr;
+	myScissorRasterState = nullptr;
+	myAlphaEnableBlendingState = nullptr;
+	myAlphaDisableBlendingState = nullptr;
+	myPremultipliedBlendingState = nullptr;
+	myLayerBlendingState = nullptr;
 }
 
-D3DClass::D3DClass(const D3DClass& aD3DClass)
+D3DClass::~D3DClass()
 {
 }
 
-D3DClass::~D3DClass()
+bool D3DClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hwnd, bool fullscreen,
+	float screenDepth, float screenNear, bool headless)
 {
+	HRESULT result;
+	bool created;
+	D3D11_TEXTURE2D_DESC depthBufferDesc;
+	D3D11_DEPTH_STENCIL_DESC depthStencilDesc;
+	D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc;
+	D3D11_RASTERIZER_DESC rasterDesc;
+	D3D11_VIEWPORT viewport;
+	D3D11_BLEND_DESC blendStateDescription;
+	float fieldOfView, screenAspect;
+
+
+	// Store the vsync setting.
+	myVSyncEnabled = vsync;
+
+	// Create the device and the back buffer, either on the video card for a window or on the CPU with nothing to present to.
+	if (headless)
+	{
+		created = InitializeHeadless(screenWidth, screenHeight);
+	}
+	else
+	{
+		created = InitializeSwapChain(screenWidth, screenHeight, hwnd, fullscreen);
+	}
+	if (!created)
+	{
+		return false;
+	}
+
+	// Initialize the description of the depth buffer.
+	ZeroMemory(&depthBufferDesc, sizeof(depthBufferDesc));
+
+	// Set up the description of the depth buffer.
+	depthBufferDesc.Width = screenWidth;
+	depthBufferDesc.Height = screenHeight;
+	depthBufferDesc.MipLevels = 1;
+	depthBufferDesc.ArraySize = 1;
+	depthBufferDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+	depthBufferDesc.SampleDesc.Count = 1;
+	depthBufferDesc.SampleDesc.Quality = 0;
+	depthBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	depthBufferDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
+	depthBufferDesc.CPUAccessFlags = 0;
+	depthBufferDesc.MiscFlags = 0;
+
+	// Create the texture for the depth buffer using the filled out description.
+	result = myDevice->CreateTexture2D(&depthBufferDesc, nullptr, &myDepthStencilBuffer);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	// Initialize the description of the stencil state.
+	ZeroMemory(&depthStencilDesc, sizeof(depthStencilDesc));
+
+	// Set up the description of the stencil state.
+	depthStencilDesc.DepthEnable = true;
+	depthStencilDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
+	depthStencilDesc.DepthFunc = D3D11_COMPARISON_LESS;
+
+	depthStencilDesc.StencilEnable = true;
+	depthStencilDesc.StencilReadMask = 0xFF;
+	depthStencilDesc.StencilWriteMask = 0xFF;
+
+	// Stencil operations if pixel is front-facing.
+	depthStencilDesc.FrontFace.StencilFailOp = D3D11_STENCIL_OP_KEEP;
+	depthStencilDesc.FrontFace.StencilDepthFailOp = D3D11_STENCIL_OP_INCR;
+	depthStencilDesc.FrontFace.StencilPassOp = D3D11_STENCIL_OP_KEEP;
+	depthStencilDesc.FrontFace.StencilFunc = D3D11_COMPARISON_ALWAYS;
+
+	// Stencil operations if pixel is back-facing.
+	depthStencilDesc.BackFace.StencilFailOp = D3D11_STENCIL_OP_KEEP;
+	depthStencilDesc.BackFace.StencilDepthFailOp = D3D11_STENCIL_OP_DECR;
+	depthStencilDesc.BackFace.StencilPassOp = D3D11_STENCIL_OP_KEEP;
+	depthStencilDesc.BackFace.StencilFunc = D3D11_COMPARISON_ALWAYS;
+
+	// Create the depth stencil state.
+	result = myDevice->CreateDepthStencilState(&depthStencilDesc, &myDepthStencilState);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	// Set the depth stencil state.
+	myDeviceContext->OMSetDepthStencilState(myDepthStencilState, 1);
+
+	// Create a depth stencil state that tests against the Z buffer without writing it, for blended surfaces that must not hide what is drawn behind them.
+	depthStencilDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO;
+	result = myDevice->CreateDepthStencilState(&depthStencilDesc, &myDepthReadOnlyStencilState);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	// Create a third depth stencil state that turns off the Z buffer for drawing over everything in 2D.
+	depthStencilDesc.DepthEnable = false;
+	depthStencilDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
+	result = myDevice->CreateDepthStencilState(&depthStencilDesc, &myDepthDisabledStencilState);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	// Initialize the depth stencil view.
+	ZeroMemory(&depthStencilViewDesc, sizeof(depthStencilViewDesc));
+
+	// Set up the depth stencil view description.
+	depthStencilViewDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+	depthStencilViewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+	depthStencilViewDesc.Texture2D.MipSlice = 0;
+
+	// Create the depth stencil view.
+	result = myDevice->CreateDepthStencilView(myDepthStencilBuffer, &depthStencilViewDesc, &myDepthStencilView);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	// Bind the render target view and depth stencil buffer to the output render pipeline.
+	myDeviceContext->OMSetRenderTargets(1, &myRenderTargetView, myDepthStencilView);
+
+	// Setup the raster description which will determine how and what polygons will be drawn.
+	rasterDesc.AntialiasedLineEnable = false;
+	rasterDesc.CullMode = D3D11_CULL_BACK;
+	rasterDesc.DepthBias = 0;
+	rasterDesc.DepthBiasClamp = 0.0f;
+	rasterDesc.DepthClipEnable = true;
+	rasterDesc.FillMode = D3D11_FILL_SOLID;
+	rasterDesc.FrontCounterClockwise = false;
+	rasterDesc.MultisampleEnable = false;
+	rasterDesc.ScissorEnable = false;
+	rasterDesc.SlopeScaledDepthBias = 0.0f;
+
+	// Create the rasterizer state from the description we just filled out.
+	result = myDevice->CreateRasterizerState(&rasterDesc, &myRasterState);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	// Now set the rasterizer state.
+	myDeviceContext->RSSetState(myRasterState);
+
+	// Create a second rasterizer state that only draws inside the scissor rectangle, for redrawing part of the screen.
+	rasterDesc.ScissorEnable = true;
+	result = myDevice->CreateRasterizerState(&rasterDesc, &myScissorRasterState);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	// Setup the viewport for rendering.
+	viewport.Width = (float)screenWidth;
+	viewport.Height = (float)screenHeight;
+	viewport.MinDepth = 0.0f;
+	viewport.MaxDepth = 1.0f;
+	viewport.TopLeftX = 0.0f;
+	viewport.TopLeftY = 0.0f;
+
+	// Create the viewport.
+	myDeviceContext->RSSetViewports(1, &viewport);
+
+	// Keep the viewport so it can be restored after drawing into an offscreen target.
+	myViewport = viewport;
+
+	// Setup the projection matrix.
+	fieldOfView = 3.141592654f / 4.0f;
+	screenAspect = (float)screenWidth / (float)screenHeight;
+
+	// Create the projection matrix for 3D rendering.
+	myProjectionMatrix = XMMatrixPerspectiveFovLH(fieldOfView, screenAspect, screenNear, screenDepth);
+
+	// Keep the parameters around so the visible area of the world can be worked out for culling.
+	myFieldOfView = fieldOfView;
+	myScreenAspect = screenAspect;
+
+	// Initialize the world matrix to the identity matrix.
+	myWorldMatrix = XMMatrixIdentity();
+
+	// Create an orthographic projection matrix for 2D rendering.
+	myOrthoMatrix = XMMatrixOrthographicLH((float)screenWidth, (float)screenHeight, screenNear, screenDepth);
+
+	// Clear the blend state description.
+	ZeroMemory(&blendStateDescription, sizeof(D3D11_BLEND_DESC));
+
+	// Create an alpha enabled blend state description.
+	blendStateDescription.RenderTarget[0].BlendEnable = TRUE;
+	blendStateDescription.RenderTarget[0].SrcBlend = D3D11_BLEND_SRC_ALPHA;
+	blendStateDescription.RenderTarget[0].DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
+	blendStateDescription.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
+	blendStateDescription.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ONE;
+	blendStateDescription.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ZERO;
+	blendStateDescription.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+	blendStateDescription.RenderTarget[0].RenderTargetWriteMask = 0x0f;
+
+	// Create the blend state using the description.
+	result = myDevice->CreateBlendState(&blendStateDescription, &myAlphaEnableBlendingState);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	// Modify the description to create an alpha disabled blend state description.
+	blendStateDescription.RenderTarget[0].BlendEnable = FALSE;
+
+	// Create the blend state using the description.
+	result = myDevice->CreateBlendState(&blendStateDescription, &myAlphaDisableBlendingState);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	// Modify the description to blend colors that are already multiplied by their alpha, as offscreen targets hold them.
+	blendStateDescription.RenderTarget[0].BlendEnable = TRUE;
+	blendStateDescription.RenderTarget[0].SrcBlend = D3D11_BLEND_ONE;
+
+	// Create the blend state using the description.
+	result = myDevice->CreateBlendState(&blendStateDescription, &myPremultipliedBlendingState);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	// Modify the description to draw into an offscreen target that is later composited with premultiplied blending. Colors
+	// come out multiplied by their alpha and the alpha adds up the coverage of everything drawn, not just the last draw.
+	blendStateDescription.RenderTarget[0].SrcBlend = D3D11_BLEND_SRC_ALPHA;
+	blendStateDescription.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_INV_SRC_ALPHA;
+
+	// Create the blend state using the description.
+	result = myDevice->CreateBlendState(&blendStateDescription, &myLayerBlendingState);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	return true;
 }
 
-bool D3DClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hwnd, bool fullscreen,
-	float screenDepth, float screenNear)
+bool D3DClass::InitializeSwapChain(int screenWidth, int screenHeight, HWND hwnd, bool fullscreen)
 {
 	HRESULT result;
 	IDXGIFactory* factory;
@@ -35,16 +279,7 @@ bool D3DClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hw
 	DXGI_SWAP_CHAIN_DESC swapChainDesc;
 	D3D_FEATURE_LEVEL featureLevel;
 	ID3D11Texture2D* backBufferPtr;
-	D3D11_TEXTURE2D_DESC depthBufferDesc;
-	D3D11_DEPTH_STENCIL_DESC depthStencilDesc;
-	D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc;
-	D3D11_RASTERIZER_DESC rasterDesc;
-	D3D11_VIEWPORT viewport;
-	float fieldOfView, screenAspect;
-
 
-	// Store the vsync setting.
-	myVSyncEnabled = vsync;
 
 	// Create a DirectX graphics interface factory.
 	result = CreateDXGIFactory(__uuidof(IDXGIFactory), (void**)&factory);
@@ -184,8 +419,8 @@ bool D3DClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hw
 	swapChainDesc.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
 	swapChainDesc.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
 
-	// Discard the back buffer contents after presenting.
-	swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
+	// Keep the back buffer contents after presenting so a frame can redraw only the part of the screen that changed.
+	swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_SEQUENTIAL;
 
 	// Don't set the advanced flags.
 	swapChainDesc.Flags = 0;
@@ -215,131 +450,79 @@ bool D3DClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hw
 		return false;
 	}
 
-	// Release pointer to the back buffer as we no longer need it.
-	backBufferPtr->Release();
+	// Keep the pointer to the back buffer, frames are captured by copying from it.
+	myBackBuffer = backBufferPtr;
 	backBufferPtr = 0;
 
-	// Initialize the description of the depth buffer.
-	ZeroMemory(&depthBufferDesc, sizeof(depthBufferDesc));
+	return true;
+}
 
-	// Set up the description of the depth buffer.
-	depthBufferDesc.Width = screenWidth;
-	depthBufferDesc.Height = screenHeight;
-	depthBufferDesc.MipLevels = 1;
-	depthBufferDesc.ArraySize = 1;
-	depthBufferDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
-	depthBufferDesc.SampleDesc.Count = 1;
-	depthBufferDesc.SampleDesc.Quality = 0;
-	depthBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-	depthBufferDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
-	depthBufferDesc.CPUAccessFlags = 0;
-	depthBufferDesc.MiscFlags = 0;
+bool D3DClass::InitializeHeadless(int screenWidth, int screenHeight)
+{
+	HRESULT result;
+	D3D_FEATURE_LEVEL featureLevel;
+	D3D11_TEXTURE2D_DESC backBufferDesc;
+	ID3D11Texture2D* backBufferPtr;
+	D3D11_QUERY_DESC queryDesc;
 
-	// Create the texture for the depth buffer using the filled out description.
-	result = myDevice->CreateTexture2D(&depthBufferDesc, nullptr, &myDepthStencilBuffer);
+
+	// The software rasterizer stands in for the video card, it has no dedicated memory and no monitor to present to.
+	myVideoCardMemory = 0;
+	strcpy_s(myVideoCardDescription, 128, "Microsoft Basic Render Driver (WARP)");
+
+	// Set the feature level to DirectX 11.
+	featureLevel = D3D_FEATURE_LEVEL_11_0;
+
+	// Create the Direct3D device and device context on the software rasterizer.
+	result = D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_WARP, nullptr, 0, &featureLevel, 1, D3D11_SDK_VERSION, &myDevice, nullptr,
+		&myDeviceContext);
 	if (FAILED(result))
 	{
 		return false;
 	}
 
-	// Initialize the description of the stencil state.
-	ZeroMemory(&depthStencilDesc, sizeof(depthStencilDesc));
-
-	// Set up the description of the stencil state.
-	depthStencilDesc.DepthEnable = true;
-	depthStencilDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
-	depthStencilDesc.DepthFunc = D3D11_COMPARISON_LESS;
-
-	depthStencilDesc.StencilEnable = true;
-	depthStencilDesc.StencilReadMask = 0xFF;
-	depthStencilDesc.StencilWriteMask = 0xFF;
-
-	// Stencil operations if pixel is front-facing.
-	depthStencilDesc.FrontFace.StencilFailOp = D3D11_STENCIL_OP_KEEP;
-	depthStencilDesc.FrontFace.StencilDepthFailOp = D3D11_STENCIL_OP_INCR;
-	depthStencilDesc.FrontFace.StencilPassOp = D3D11_STENCIL_OP_KEEP;
-	depthStencilDesc.FrontFace.StencilFunc = D3D11_COMPARISON_ALWAYS;
-
-	// Stencil operations if pixel is back-facing.
-	depthStencilDesc.BackFace.StencilFailOp = D3D11_STENCIL_OP_KEEP;
-	depthStencilDesc.BackFace.StencilDepthFailOp = D3D11_STENCIL_OP_DECR;
-	depthStencilDesc.BackFace.StencilPassOp = D3D11_STENCIL_OP_KEEP;
-	depthStencilDesc.BackFace.StencilFunc = D3D11_COMPARISON_ALWAYS;
-
-	// Create the depth stencil state.
-	result = myDevice->CreateDepthStencilState(&depthStencilDesc, &myDepthStencilState);
+	// Set up the description of an offscreen back buffer in the format the swap chain would have.
+	ZeroMemory(&backBufferDesc, sizeof(backBufferDesc));
+	backBufferDesc.Width = screenWidth;
+	backBufferDesc.Height = screenHeight;
+	backBufferDesc.MipLevels = 1;
+	backBufferDesc.ArraySize = 1;
+	backBufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	backBufferDesc.SampleDesc.Count = 1;
+	backBufferDesc.SampleDesc.Quality = 0;
+	backBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	backBufferDesc.BindFlags = D3D11_BIND_RENDER_TARGET;
+	backBufferDesc.CPUAccessFlags = 0;
+	backBufferDesc.MiscFlags = 0;
+
+	// Create the back buffer texture.
+	result = myDevice->CreateTexture2D(&backBufferDesc, nullptr, &backBufferPtr);
 	if (FAILED(result))
 	{
 		return false;
 	}
 
-	// Set the depth stencil state.
-	myDeviceContext->OMSetDepthStencilState(myDepthStencilState, 1);
-
-	// Initialize the depth stencil view.
-	ZeroMemory(&depthStencilViewDesc, sizeof(depthStencilViewDesc));
-
-	// Set up the depth stencil view description.
-	depthStencilViewDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
-	depthStencilViewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
-	depthStencilViewDesc.Texture2D.MipSlice = 0;
-
-	// Create the depth stencil view.
-	result = myDevice->CreateDepthStencilView(myDepthStencilBuffer, &depthStencilViewDesc, &myDepthStencilView);
+	// Create the render target view with the back buffer pointer.
+	result = myDevice->CreateRenderTargetView(backBufferPtr, nullptr, &myRenderTargetView);
 	if (FAILED(result))
 	{
+		backBufferPtr->Release();
 		return false;
 	}
 
-	// Bind the render target view and depth stencil buffer to the output render pipeline.
-	myDeviceContext->OMSetRenderTargets(1, &myRenderTargetView, myDepthStencilView);
-
-	// Setup the raster description which will determine how and what polygons will be drawn.
-	rasterDesc.AntialiasedLineEnable = false;
-	rasterDesc.CullMode = D3D11_CULL_BACK;
-	rasterDesc.DepthBias = 0;
-	rasterDesc.DepthBiasClamp = 0.0f;
-	rasterDesc.DepthClipEnable = true;
-	rasterDesc.FillMode = D3D11_FILL_SOLID;
-	rasterDesc.FrontCounterClockwise = false;
-	rasterDesc.MultisampleEnable = false;
-	rasterDesc.ScissorEnable = false;
-	rasterDesc.SlopeScaledDepthBias = 0.0f;
+	// Keep the pointer to the back buffer, frames are captured by copying from it.
+	myBackBuffer = backBufferPtr;
+	backBufferPtr = 0;
 
-	// Create the rasterizer state from the description we just filled out.
-	result = myDevice->CreateRasterizerState(&rasterDesc, &myRasterState);
+	// Create the query that ends a frame, waiting for it takes the place of presenting.
+	queryDesc.Query = D3D11_QUERY_EVENT;
+	queryDesc.MiscFlags = 0;
+	result = myDevice->CreateQuery(&queryDesc, &myFrameQuery);
 	if (FAILED(result))
 	{
 		return false;
 	}
 
-	// Now set the rasterizer state.
-	myDeviceContext->RSSetState(myRasterState);
-
-	// Setup the viewport for rendering.
-	viewport.Width = (float)screenWidth;
-	viewport.Height = (float)screenHeight;
-	viewport.MinDepth = 0.0f;
-	viewport.MaxDepth = 1.0f;
-	viewport.TopLeftX = 0.0f;
-	viewport.TopLeftY = 0.0f;
-
-	// Create the viewport.
-	myDeviceContext->RSSetViewports(1, &viewport);
-
-	// Setup the projection matrix.
-	fieldOfView = 3.141592654f / 4.0f;
-	screenAspect = (float)screenWidth / (float)screenHeight;
-
-	// Create the projection matrix for 3D rendering.
-	myProjectionMatrix = XMMatrixPerspectiveFovLH(fieldOfView, screenAspect, screenNear, screenDepth);
-
-	// Initialize the world matrix to the identity matrix.
-	myWorldMatrix = XMMatrixIdentity();
-
-	// Create an orthographic projection matrix for 2D rendering.
-	myOrthoMatrix = XMMatrixOrthographicLH((float)screenWidth, (float)screenHeight, screenNear, screenDepth);
-
 	return true;
 }
 
@@ -350,6 +533,31 @@ void D3DClass::Shutdown()
 	{
 		mySwapChain->SetFullscreenState(false, nullptr);
 	}
+	if (myLayerBlendingState)
+	{
+		myLayerBlendingState->Release();
+		myLayerBlendingState = nullptr;
+	}
+	if (myPremultipliedBlendingState)
+	{
+		myPremultipliedBlendingState->Release();
+		myPremultipliedBlendingState = nullptr;
+	}
+	if (myAlphaEnableBlendingState)
+	{
+		myAlphaEnableBlendingState->Release();
+		myAlphaEnableBlendingState = nullptr;
+	}
+	if (myAlphaDisableBlendingState)
+	{
+		myAlphaDisableBlendingState->Release();
+		myAlphaDisableBlendingState = nullptr;
+	}
+	if (myScissorRasterState)
+	{
+		myScissorRasterState->Release();
+		myScissorRasterState = nullptr;
+	}
 	if (myRasterState)
 	{
 		myRasterState->Release();
@@ -360,6 +568,16 @@ void D3DClass::Shutdown()
 		myDepthStencilView->Release();
 		myDepthStencilView = nullptr;
 	}
+	if (myDepthDisabledStencilState)
+	{
+		myDepthDisabledStencilState->Release();
+		myDepthDisabledStencilState = nullptr;
+	}
+	if (myDepthReadOnlyStencilState)
+	{
+		myDepthReadOnlyStencilState->Release();
+		myDepthReadOnlyStencilState = nullptr;
+	}
 	if (myDepthStencilState)
 	{
 		myDepthStencilState->Release();
@@ -375,6 +593,16 @@ void D3DClass::Shutdown()
 		myRenderTargetView->Release();
 		myRenderTargetView = nullptr;
 	}
+	if (myBackBuffer)
+	{
+		myBackBuffer->Release();
+		myBackBuffer = nullptr;
+	}
+	if (myFrameQuery)
+	{
+		myFrameQuery->Release();
+		myFrameQuery = nullptr;
+	}
 	if (myDeviceContext)
 	{
 		myDeviceContext->Release();
@@ -414,6 +642,18 @@ void D3DClass::BeginScene(float red, float green, float blue, float alpha)
 
 void D3DClass::EndScene()
 {
+	// Without a swap chain wait for the device to finish the frame instead, so the frame time covers the rendering.
+	if (mySwapChain == nullptr)
+	{
+		myDeviceContext->End(myFrameQuery);
+		while (myDeviceContext->GetData(myFrameQuery, nullptr, 0, 0) == S_FALSE)
+		{
+			// Give the rest of the time slice away so the driver threads are not starved while polling.
+			Sleep(0);
+		}
+		return;
+	}
+
 	// Present the back buffer to the screen since rendering is complete.
 	if (myVSyncEnabled)
 	{
@@ -438,6 +678,11 @@ ID3D11DeviceContext* D3DClass::GetDeviceContext()
 	return myDeviceContext;
 }
 
+ID3D11Texture2D* D3DClass::GetBackBuffer()
+{
+	return myBackBuffer;
+}
+
 void D3DClass::GetProjectionMatrix(XMMATRIX& projectionMatrix)
 {
 	projectionMatrix = myProjectionMatrix;
@@ -456,6 +701,133 @@ void D3DClass::GetOrthoMatrix(XMMATRIX& orthoMatrix)
 	return;
 }
 
+void D3DClass::GetProjectionParameters(float& fieldOfView, float& screenAspect)
+{
+	fieldOfView = myFieldOfView;
+	screenAspect = myScreenAspect;
+	return;
+}
+
+void D3DClass::TurnOnAlphaBlending()
+{
+	float blendFactor[4];
+
+	// Setup the blend factor.
+	blendFactor[0] = 0.0f;
+	blendFactor[1] = 0.0f;
+	blendFactor[2] = 0.0f;
+	blendFactor[3] = 0.0f;
+
+	// Turn on the alpha blending.
+	myDeviceContext->OMSetBlendState(myAlphaEnableBlendingState, blendFactor, 0xffffffff);
+	return;
+}
+
+void D3DClass::TurnOnPremultipliedAlphaBlending()
+{
+	float blendFactor[4];
+
+	// Setup the blend factor.
+	blendFactor[0] = 0.0f;
+	blendFactor[1] = 0.0f;
+	blendFactor[2] = 0.0f;
+	blendFactor[3] = 0.0f;
+
+	// Turn on the blending of premultiplied colors.
+	myDeviceContext->OMSetBlendState(myPremultipliedBlendingState, blendFactor, 0xffffffff);
+	return;
+}
+
+void D3DClass::TurnOnLayerBlending()
+{
+	float blendFactor[4];
+
+	// Setup the blend factor.
+	blendFactor[0] = 0.0f;
+	blendFactor[1] = 0.0f;
+	blendFactor[2] = 0.0f;
+	blendFactor[3] = 0.0f;
+
+	// Turn on the blending that accumulates coverage in the alpha of an offscreen layer.
+	myDeviceContext->OMSetBlendState(myLayerBlendingState, blendFactor, 0xffffffff);
+	return;
+}
+
+void D3DClass::TurnOffAlphaBlending()
+{
+	float blendFactor[4];
+
+	// Setup the blend factor.
+	blendFactor[0] = 0.0f;
+	blendFactor[1] = 0.0f;
+	blendFactor[2] = 0.0f;
+	blendFactor[3] = 0.0f;
+
+	// Turn off the alpha blending.
+	myDeviceContext->OMSetBlendState(myAlphaDisableBlendingState, blendFactor, 0xffffffff);
+	return;
+}
+
+void D3DClass::TurnZBufferOn()
+{
+	myDeviceContext->OMSetDepthStencilState(myDepthStencilState, 1);
+	return;
+}
+
+void D3DClass::TurnZBufferReadOnly()
+{
+	myDeviceContext->OMSetDepthStencilState(myDepthReadOnlyStencilState, 1);
+	return;
+}
+
+void D3DClass::TurnZBufferOff()
+{
+	myDeviceContext->OMSetDepthStencilState(myDepthDisabledStencilState, 1);
+	return;
+}
+
+void D3DClass::ClearDepthBuffer()
+{
+	// Clear the depth buffer only, the back buffer keeps what was presented last.
+	myDeviceContext->ClearDepthStencilView(myDepthStencilView, D3D11_CLEAR_DEPTH, 1.0f, 0);
+	return;
+}
+
+void D3DClass::TurnScissorOn(int left, int top, int right, int bottom)
+{
+	D3D11_RECT rect;
+
+	// Setup the rectangle drawing is limited to, in pixels from the top left corner.
+	rect.left = left;
+	rect.top = top;
+	rect.right = right;
+	rect.bottom = bottom;
+
+	myDeviceContext->RSSetScissorRects(1, &rect);
+	myDeviceContext->RSSetState(myScissorRasterState);
+	return;
+}
+
+void D3DClass::TurnScissorOff()
+{
+	myDeviceContext->RSSetState(myRasterState);
+	return;
+}
+
+void D3DClass::SetBackBufferRenderTarget()
+{
+	// Bind the render target view and depth stencil buffer to the output render pipeline.
+	myDeviceContext->OMSetRenderTargets(1, &myRenderTargetView, myDepthStencilView);
+	return;
+}
+
+void D3DClass::ResetViewport()
+{
+	// Set the viewport back to the whole back buffer.
+	myDeviceContext->RSSetViewports(1, &myViewport);
+	return;
+}
+
 void D3DClass::GetVideoCardInfo(char* cardName, int& memory)
 {
 	strcpy_s(cardName, 128, myVideoCardDescription);
@@ -13,10 +13,10 @@ class D3DClass
 {
 public:
 	D3DClass();
-	D3DClass(const D3DClass& aD3DClass);
+	D3DClass(const D3DClass& aD3DClass) = delete;
 	~D3DClass();
 
-	bool Initialize(int, int, bool, HWND, bool, float, float);
+	bool Initialize(int, int, bool, HWND, bool, float, float, bool);
 	void Shutdown();
 
 	void BeginScene(float, float, float, float);
@@ -24,26 +24,58 @@ public:
 
 	ID3D11Device* GetDevice();
 	ID3D11DeviceContext* GetDeviceContext();
+	ID3D11Texture2D* GetBackBuffer();
 
 	void GetProjectionMatrix(XMMATRIX&);
 	void GetWorldMatrix(XMMATRIX&);
 	void GetOrthoMatrix(XMMATRIX&);
+	void GetProjectionParameters(float&, float&);
+
+	void TurnOnAlphaBlending();
+	void TurnOnPremultipliedAlphaBlending();
+	void TurnOnLayerBlending();
+	void TurnOffAlphaBlending();
+	void TurnZBufferOn();
+	void TurnZBufferReadOnly();
+	void TurnZBufferOff();
+
+	void ClearDepthBuffer();
+	void TurnScissorOn(int, int, int, int);
+	void TurnScissorOff();
+
+	void SetBackBufferRenderTarget();
+	void ResetViewport();
 
 	void GetVideoCardInfo(char*, int&);
 
 private:
+	bool InitializeSwapChain(int, int, HWND, bool);
+	bool InitializeHeadless(int, int);
+
 	bool myVSyncEnabled;
 	int myVideoCardMemory;
 	char myVideoCardDescription[128];
 	IDXGISwapChain* mySwapChain;
+	ID3D11Query* myFrameQuery;
 	ID3D11Device* myDevice;
 	ID3D11DeviceContext* myDeviceContext;
 	ID3D11RenderTargetView* myRenderTargetView;
+	ID3D11Texture2D* myBackBuffer;
 	ID3D11Texture2D* myDepthStencilBuffer;
 	ID3D11DepthStencilState* myDepthStencilState;
+	ID3D11DepthStencilState* myDepthReadOnlyStencilState;
+	ID3D11DepthStencilState* myDepthDisabledStencilState;
 	ID3D11DepthStencilView* myDepthStencilView;
 	ID3D11RasterizerState* myRasterState;
+	ID3D11RasterizerState* myScissorRasterState;
+	ID3D11BlendState* myAlphaEnableBlendingState;
+	ID3D11BlendState* myAlphaDisableBlendingState;
+	ID3D11BlendState* myPremultipliedBlendingState;
+	ID3D11BlendState* myLayerBlendingState;
+	D3D11_VIEWPORT myViewport;
 	XMMATRIX myProjectionMatrix;
 	XMMATRIX myWorldMatrix;
 	XMMATRIX myOrthoMatrix;
+	float myFieldOfView;
+	float myScreenAspect;
 };
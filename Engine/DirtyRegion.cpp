@@ -0,0 +1,108 @@
+#include "DirtyRegion.h"
+
+DirtyRegion::DirtyRegion()
+{
+	myBounds.left = 0;
+	myBounds.top = 0;
+	myBounds.right = 0;
+	myBounds.bottom = 0;
+	myWidth = 0;
+	myHeight = 0;
+}
+
+DirtyRegion::~DirtyRegion()
+{
+}
+
+bool DirtyRegion::Initialize(int aWidth, int aHeight)
+{
+	if (aWidth <= 0 || aHeight <= 0)
+	{
+		return false;
+	}
+	myWidth = aWidth;
+	myHeight = aHeight;
+
+	// Nothing has been presented yet, so the first frame draws everything.
+	Invalidate();
+	return true;
+}
+
+void DirtyRegion::Clear()
+{
+	myBounds.left = 0;
+	myBounds.top = 0;
+	myBounds.right = 0;
+	myBounds.bottom = 0;
+}
+
+void DirtyRegion::Add(const Rect& aRect)
+{
+	Rect rect;
+
+	// Clamp the rectangle to the screen and drop it if nothing of it is left.
+	rect.left = aRect.left < 0 ? 0 : aRect.left;
+	rect.top = aRect.top < 0 ? 0 : aRect.top;
+	rect.right = aRect.right > myWidth ? myWidth : aRect.right;
+	rect.bottom = aRect.bottom > myHeight ? myHeight : aRect.bottom;
+	if (rect.left >= rect.right || rect.top >= rect.bottom)
+	{
+		return;
+	}
+
+	if (IsEmpty())
+	{
+		myBounds = rect;
+		return;
+	}
+
+	// Grow the union to cover the rectangle.
+	if (rect.left < myBounds.left)
+	{
+		myBounds.left = rect.left;
+	}
+	if (rect.top < myBounds.top)
+	{
+		myBounds.top = rect.top;
+	}
+	if (rect.right > myBounds.right)
+	{
+		myBounds.right = rect.right;
+	}
+	if (rect.bottom > myBounds.bottom)
+	{
+		myBounds.bottom = rect.bottom;
+	}
+}
+
+void DirtyRegion::Invalidate()
+{
+	myBounds.left = 0;
+	myBounds.top = 0;
+	myBounds.right = myWidth;
+	myBounds.bottom = myHeight;
+}
+
+bool DirtyRegion::IsEmpty()
+{
+	return myBounds.left >= myBounds.right || myBounds.top >= myBounds.bottom;
+}
+
+bool DirtyRegion::IsFull()
+{
+	return myBounds.left == 0 && myBounds.top == 0 && myBounds.right == myWidth && myBounds.bottom == myHeight;
+}
+
+const DirtyRegion::Rect& DirtyRegion::GetBounds()
+{
+	return myBounds;
+}
+
+float DirtyRegion::GetCoverage()
+{
+	if (IsEmpty())
+	{
+		return 0.0f;
+	}
+	return (float)((myBounds.right - myBounds.left) * (myBounds.bottom - myBounds.top)) / (float)(myWidth * myHeight);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+// Collects the rectangles of the screen that changed since the last presented frame, in pixels with the origin top left.
+// The region is kept as the union of the rectangles, clamped to the screen, so it can be redrawn with a single scissor.
+class DirtyRegion
+{
+public:
+	struct Rect
+	{
+		int left;
+		int top;
+		int right;
+		int bottom;
+	};
+
+	DirtyRegion();
+	DirtyRegion(const DirtyRegion& aDirtyRegion) = delete;
+	~DirtyRegion();
+
+	bool Initialize(int aWidth, int aHeight);
+
+	void Clear();
+	void Add(const Rect& aRect);
+	void Invalidate();
+
+	bool IsEmpty();
+	bool IsFull();
+	const Rect& GetBounds();
+	float GetCoverage();
+
+private:
+	Rect myBounds;
+	int myWidth;
+	int myHeight;
+};
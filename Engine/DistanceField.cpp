@@ -0,0 +1,135 @@
+#include "DistanceField.h"
+#include <math.h>
+#include <vector>
+
+// Stands in for an infinite distance.
+static const float DISTANCE_INFINITY = 1e20f;
+
+void DistanceField::Generate(const unsigned char* aCoverage, int aWidth, int aHeight, int aSpread, unsigned char* aOutput)
+{
+	std::vector<float> outside, inside;
+	int width, height, x, y, index;
+	bool covered;
+	float distance, value;
+
+	// The output has room for the distance falloff on every side.
+	width = aWidth + aSpread * 2;
+	height = aHeight + aSpread * 2;
+	outside.resize(width * height);
+	inside.resize(width * height);
+
+	// Seed the grids, covered pixels are distance zero from the inside and the other way around.
+	for (y = 0; y < height; y++)
+	{
+		for (x = 0; x < width; x++)
+		{
+			index = y * width + x;
+			covered = false;
+			if (x >= aSpread && y >= aSpread && x < aSpread + aWidth && y < aSpread + aHeight)
+			{
+				covered = aCoverage[(y - aSpread) * aWidth + (x - aSpread)] >= 128;
+			}
+			outside[index] = covered ? 0.0f : DISTANCE_INFINITY;
+			inside[index] = covered ? DISTANCE_INFINITY : 0.0f;
+		}
+	}
+
+	// Squared distance of every pixel to the nearest covered and the nearest uncovered pixel.
+	Transform(&outside[0], width, height);
+	Transform(&inside[0], width, height);
+
+	// Combine the two into one signed distance mapped to a byte, the outline runs half a pixel from the covered centers.
+	for (index = 0; index < width * height; index++)
+	{
+		distance = outside[index] > 0.0f ? sqrtf(outside[index]) - 0.5f : 0.5f - sqrtf(inside[index]);
+		value = 128.0f - distance * (127.0f / (float)aSpread);
+		value = value < 0.0f ? 0.0f : (value > 255.0f ? 255.0f : value);
+		aOutput[index] = (unsigned char)value;
+	}
+}
+
+void DistanceField::Transform(float* aGrid, int aWidth, int aHeight)
+{
+	std::vector<float> input, output, boundaries;
+	std::vector<int> parabolas;
+	int x, y, size;
+
+	// Exact euclidean distance transform, done as one dimensional transforms over the columns and then the rows.
+	size = aWidth > aHeight ? aWidth : aHeight;
+	input.resize(size);
+	output.resize(size);
+	boundaries.resize(size + 1);
+	parabolas.resize(size);
+
+	for (x = 0; x < aWidth; x++)
+	{
+		for (y = 0; y < aHeight; y++)
+		{
+			input[y] = aGrid[y * aWidth + x];
+		}
+		Transform1D(&input[0], &output[0], aHeight, &parabolas[0], &boundaries[0]);
+		for (y = 0; y < aHeight; y++)
+		{
+			aGrid[y * aWidth + x] = output[y];
+		}
+	}
+
+	for (y = 0; y < aHeight; y++)
+	{
+		Transform1D(aGrid + y * aWidth, &output[0], aWidth, &parabolas[0], &boundaries[0]);
+		for (x = 0; x < aWidth; x++)
+		{
+			aGrid[y * aWidth + x] = output[x];
+		}
+	}
+}
+
+void DistanceField::Transform1D(const float* aInput, float* aOutput, int aCount, int* aParabolas, float* aBoundaries)
+{
+	int i, k;
+	float boundary;
+
+	// Lower envelope of the parabolas rooted at every sample.
+	k = 0;
+	aParabolas[0] = 0;
+	aBoundaries[0] = -DISTANCE_INFINITY;
+	aBoundaries[1] = DISTANCE_INFINITY;
+
+	for (i = 1; i < aCount; i++)
+	{
+		for (;;)
+		{
+			boundary = ((aInput[i] + (float)(i * i)) - (aInput[aParabolas[k]] + (float)(aParabolas[k] * aParabolas[k]))) /
+				(2.0f * (float)(i - aParabolas[k]));
+			if (boundary > aBoundaries[k] || k == 0)
+			{
+				break;
+			}
+			k--;
+		}
+
+		// The first parabola is only dropped if the new one already wins at its left boundary.
+		if (boundary <= aBoundaries[k])
+		{
+			aParabolas[k] = i;
+			aBoundaries[k + 1] = DISTANCE_INFINITY;
+			continue;
+		}
+
+		k++;
+		aParabolas[k] = i;
+		aBoundaries[k] = boundary;
+		aBoundaries[k + 1] = DISTANCE_INFINITY;
+	}
+
+	// Read the distance of every sample off the envelope.
+	k = 0;
+	for (i = 0; i < aCount; i++)
+	{
+		while (aBoundaries[k + 1] < (float)i)
+		{
+			k++;
+		}
+		aOutput[i] = (float)((i - aParabolas[k]) * (i - aParabolas[k])) + aInput[aParabolas[k]];
+	}
+}
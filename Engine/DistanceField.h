@@ -0,0 +1,14 @@
+#pragma once
+
+// Turns a coverage bitmap into a signed distance field.
+// The output is aSpread pixels larger on every side, 128 lies on the outline, 255 is aSpread or more pixels inside
+// and 0 is aSpread or more pixels outside. Scaled up distance fields stay sharp where the coverage bitmap would blur.
+class DistanceField
+{
+public:
+	static void Generate(const unsigned char* aCoverage, int aWidth, int aHeight, int aSpread, unsigned char* aOutput);
+
+private:
+	static void Transform(float* aGrid, int aWidth, int aHeight);
+	static void Transform1D(const float* aInput, float* aOutput, int aCount, int* aParabolas, float* aBoundaries);
+};
@@ -0,0 +1,65 @@
+#include "FrameArena.h"
+
+FrameArena::FrameArena()
+{
+	myCurrent = 0;
+}
+
+FrameArena::~FrameArena()
+{
+}
+
+bool FrameArena::Initialize(size_t aCapacityPerFrame)
+{
+	// Create one arena for each of the two frames in flight.
+	if (!myArenas[0].Initialize(aCapacityPerFrame))
+	{
+		return false;
+	}
+	if (!myArenas[1].Initialize(aCapacityPerFrame))
+	{
+		return false;
+	}
+	myCurrent = 0;
+
+	return true;
+}
+
+void FrameArena::Shutdown()
+{
+	// Release both arenas.
+	myArenas[1].Shutdown();
+	myArenas[0].Shutdown();
+}
+
+void FrameArena::BeginFrame()
+{
+	// Switch to the other arena, the one the frame before last used, and release what it held.
+	myCurrent = 1 - myCurrent;
+	myArenas[myCurrent].Reset();
+}
+
+void* FrameArena::Allocate(size_t aSize, size_t aAlignment)
+{
+	return myArenas[myCurrent].Allocate(aSize, aAlignment);
+}
+
+size_t FrameArena::GetUsed()
+{
+	return myArenas[myCurrent].GetUsed();
+}
+
+size_t FrameArena::GetCapacity()
+{
+	return myArenas[myCurrent].GetCapacity();
+}
+
+size_t FrameArena::GetHighWaterMark()
+{
+	size_t first, second;
+
+	// The most any single frame has used.
+	first = myArenas[0].GetHighWaterMark();
+	second = myArenas[1].GetHighWaterMark();
+	return first > second ? first : second;
+}
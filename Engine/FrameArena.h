@@ -0,0 +1,33 @@
+#pragma once
+
+#include "LinearArena.h"
+
+// Two linear arenas used on alternate frames.
+// Memory handed out during a frame stays valid through the next one, so a render thread can still read what the
+// update thread wrote last frame while the new frame is being built. BeginFrame releases everything from two frames ago.
+class FrameArena
+{
+public:
+	FrameArena();
+	FrameArena(const FrameArena& aFrameArena) = delete;
+	~FrameArena();
+
+	bool Initialize(size_t aCapacityPerFrame);
+	void Shutdown();
+
+	void BeginFrame();
+
+	void* Allocate(size_t aSize, size_t aAlignment = ARENA_DEFAULT_ALIGNMENT);
+	template<typename T> T* AllocateArray(int aCount)
+	{
+		return myArenas[myCurrent].AllocateArray<T>(aCount);
+	}
+
+	size_t GetUsed();
+	size_t GetCapacity();
+	size_t GetHighWaterMark();
+
+private:
+	LinearArena myArenas[2];
+	int myCurrent;
+};
@@ -0,0 +1,233 @@
+#include "FrameCapture.h"
+#include <string.h>
+
+FrameCapture::FrameCapture()
+{
+	myFirstSlot = 0;
+	myPendingCount = 0;
+	myFrame = 0;
+	myEncoder = nullptr;
+	myWidth = 0;
+	myHeight = 0;
+	myLossless = false;
+	myCapturedCount = 0;
+	myDroppedCount = 0;
+	myLatencySum = 0.0;
+	myMaxLatency = 0.0f;
+	myLatencyFrameSum = 0;
+	myMaxLatencyFrames = 0;
+	myTimerFrequency = 0;
+}
+
+FrameCapture::~FrameCapture()
+{
+}
+
+bool FrameCapture::Initialize(ID3D11Device& aDevice, ID3D11Texture2D& aBackBuffer, int aRingSize, int aBufferCount, const char* aDirectory,
+	CaptureEncoder::Format aFormat, bool aLossless)
+{
+	D3D11_TEXTURE2D_DESC textureDesc;
+	LARGE_INTEGER frequency;
+	Slot slot;
+	HRESULT result;
+	int i;
+
+	if (aRingSize <= 0)
+	{
+		return false;
+	}
+
+	// The encoder takes 8 bit RGBA rows, which is what both back buffers hold.
+	aBackBuffer.GetDesc(&textureDesc);
+	if (textureDesc.Format != DXGI_FORMAT_R8G8B8A8_UNORM || textureDesc.SampleDesc.Count != 1)
+	{
+		return false;
+	}
+	myWidth = (int)textureDesc.Width;
+	myHeight = (int)textureDesc.Height;
+	myLossless = aLossless;
+
+	// Create the ring of staging textures the back buffer is copied into, the CPU can map them but never draw to them.
+	textureDesc.MipLevels = 1;
+	textureDesc.ArraySize = 1;
+	textureDesc.Usage = D3D11_USAGE_STAGING;
+	textureDesc.BindFlags = 0;
+	textureDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+	textureDesc.MiscFlags = 0;
+	for (i = 0; i < aRingSize; i++)
+	{
+		memset(&slot, 0, sizeof(slot));
+		result = aDevice.CreateTexture2D(&textureDesc, nullptr, &slot.texture);
+		if (FAILED(result))
+		{
+			return false;
+		}
+		mySlots.push_back(slot);
+	}
+	myFirstSlot = 0;
+	myPendingCount = 0;
+	myFrame = 0;
+
+	// Create the encoder object.
+	myEncoder = new CaptureEncoder;
+	if (!myEncoder)
+	{
+		return false;
+	}
+
+	// Initialize the encoder object, which starts the thread the frames are written on.
+	if (!myEncoder->Initialize(aDirectory, aFormat, myWidth, myHeight, aBufferCount))
+	{
+		return false;
+	}
+
+	QueryPerformanceFrequency(&frequency);
+	myTimerFrequency = frequency.QuadPart;
+
+	return true;
+}
+
+void FrameCapture::Shutdown()
+{
+	unsigned int i;
+
+	// Release the encoder object once it has written every frame handed to it.
+	if (myEncoder != nullptr)
+	{
+		myEncoder->Shutdown();
+		delete myEncoder;
+		myEncoder = nullptr;
+	}
+
+	// Release the staging textures, frames still in them are lost, Flush reads them back first.
+	for (i = 0; i < mySlots.size(); i++)
+	{
+		if (mySlots[i].texture != nullptr)
+		{
+			mySlots[i].texture->Release();
+		}
+	}
+	mySlots.clear();
+	myPendingCount = 0;
+}
+
+void FrameCapture::Capture(ID3D11DeviceContext& aDeviceContext, ID3D11Texture2D& aBackBuffer)
+{
+	Slot* slot;
+
+	// Hand the copies the GPU has finished to the encoder, oldest first, without waiting for the rest.
+	while (myPendingCount > 0 && Retrieve(aDeviceContext, false))
+	{
+	}
+
+	// Every staging texture still waits for its copy. A live capture drops the frame rather than stall the GPU,
+	// a lossless one waits for the oldest copy to finish.
+	if (myPendingCount == (int)mySlots.size())
+	{
+		if (!myLossless)
+		{
+			myDroppedCount++;
+			myFrame++;
+			return;
+		}
+		Retrieve(aDeviceContext, true);
+	}
+
+	// Queue the copy of the back buffer into the next free staging texture.
+	slot = &mySlots[(myFirstSlot + myPendingCount) % mySlots.size()];
+	aDeviceContext.CopyResource(slot->texture, &aBackBuffer);
+	slot->frame = myFrame;
+	QueryPerformanceCounter(&slot->copyTime);
+	myPendingCount++;
+	myFrame++;
+}
+
+void FrameCapture::Update(ID3D11DeviceContext& aDeviceContext)
+{
+	// A frame that is not captured still collects the copies of earlier ones.
+	while (myPendingCount > 0 && Retrieve(aDeviceContext, false))
+	{
+	}
+	myFrame++;
+}
+
+void FrameCapture::Flush(ID3D11DeviceContext& aDeviceContext)
+{
+	// Wait for every copy still in flight, hand it to the encoder and wait until it is written.
+	while (myPendingCount > 0)
+	{
+		Retrieve(aDeviceContext, true);
+	}
+	if (myEncoder != nullptr)
+	{
+		myEncoder->Flush();
+	}
+}
+
+void FrameCapture::GetStats(Stats& aStats)
+{
+	aStats.capturedCount = myCapturedCount;
+	aStats.droppedCount = myDroppedCount;
+	aStats.writtenCount = myEncoder != nullptr ? myEncoder->GetWrittenCount() : 0;
+	aStats.failedCount = myEncoder != nullptr ? myEncoder->GetFailedCount() : 0;
+	aStats.averageLatency = myCapturedCount > 0 ? (float)(myLatencySum / myCapturedCount) : 0.0f;
+	aStats.maxLatency = myMaxLatency;
+	aStats.averageLatencyFrames = myCapturedCount > 0 ? (float)myLatencyFrameSum / (float)myCapturedCount : 0.0f;
+	aStats.maxLatencyFrames = myMaxLatencyFrames;
+}
+
+bool FrameCapture::Retrieve(ID3D11DeviceContext& aDeviceContext, bool aWait)
+{
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	LARGE_INTEGER now;
+	Slot* slot;
+	HRESULT result;
+	unsigned char* pixels;
+	float latency;
+	int y;
+
+	// Map the oldest copy, asking the driver not to block when the GPU has not got to it yet.
+	slot = &mySlots[myFirstSlot];
+	result = aDeviceContext.Map(slot->texture, 0, D3D11_MAP_READ, aWait ? 0 : D3D11_MAP_FLAG_DO_NOT_WAIT, &mappedResource);
+	if (result == DXGI_ERROR_WAS_STILL_DRAWING)
+	{
+		return false;
+	}
+
+	// The staging texture is free again whatever happens to its frame.
+	myFirstSlot = (myFirstSlot + 1) % (int)mySlots.size();
+	myPendingCount--;
+	if (FAILED(result))
+	{
+		myDroppedCount++;
+		return true;
+	}
+
+	// Take a buffer from the encoder, a live capture drops the frame when the encoder is behind.
+	pixels = myEncoder->AcquireBuffer(myLossless || aWait);
+	if (pixels == nullptr)
+	{
+		aDeviceContext.Unmap(slot->texture, 0);
+		myDroppedCount++;
+		return true;
+	}
+
+	// Copy the rows out, the mapped rows may be padded past the width of the image.
+	for (y = 0; y < myHeight; y++)
+	{
+		memcpy(pixels + (size_t)y * myWidth * 4, (const unsigned char*)mappedResource.pData + (size_t)y * mappedResource.RowPitch, (size_t)myWidth * 4);
+	}
+	aDeviceContext.Unmap(slot->texture, 0);
+	myEncoder->Submit(pixels, slot->frame);
+
+	// Count how long the frame took from the copy to here.
+	QueryPerformanceCounter(&now);
+	latency = (float)((double)(now.QuadPart - slot->copyTime.QuadPart) * 1000.0 / (double)myTimerFrequency);
+	myCapturedCount++;
+	myLatencySum += latency;
+	myMaxLatency = latency > myMaxLatency ? latency : myMaxLatency;
+	myLatencyFrameSum += myFrame - slot->frame;
+	myMaxLatencyFrames = myFrame - slot->frame > myMaxLatencyFrames ? myFrame - slot->frame : myMaxLatencyFrames;
+
+	return true;
+}
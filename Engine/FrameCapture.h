@@ -0,0 +1,66 @@
+#pragma once
+
+#include <d3d11.h>
+#include <vector>
+#include "CaptureEncoder.h"
+
+// Reads rendered frames back to the CPU for screenshots and video without waiting on the GPU.
+// A captured frame is copied from the back buffer into the next texture of a ring of staging textures, and only mapped
+// once the GPU has finished the copy, a few frames later. The pixels then go to the encoder thread. When the ring or the
+// encoder is still full the frame is dropped, unless the capture is lossless: an offline render waits instead.
+class FrameCapture
+{
+public:
+	// Latency runs from the copy of a frame until its pixels were read back, in milliseconds and in frames.
+	struct Stats
+	{
+		int capturedCount;
+		int droppedCount;
+		int writtenCount;
+		int failedCount;
+		float averageLatency;
+		float maxLatency;
+		float averageLatencyFrames;
+		int maxLatencyFrames;
+	};
+
+	FrameCapture();
+	FrameCapture(const FrameCapture& aFrameCapture) = delete;
+	~FrameCapture();
+
+	bool Initialize(ID3D11Device& aDevice, ID3D11Texture2D& aBackBuffer, int aRingSize, int aBufferCount, const char* aDirectory,
+		CaptureEncoder::Format aFormat, bool aLossless);
+	void Shutdown();
+
+	void Capture(ID3D11DeviceContext& aDeviceContext, ID3D11Texture2D& aBackBuffer);
+	void Update(ID3D11DeviceContext& aDeviceContext);
+	void Flush(ID3D11DeviceContext& aDeviceContext);
+
+	void GetStats(Stats& aStats);
+
+private:
+	struct Slot
+	{
+		ID3D11Texture2D* texture;
+		int frame;
+		LARGE_INTEGER copyTime;
+	};
+
+	bool Retrieve(ID3D11DeviceContext& aDeviceContext, bool aWait);
+
+	std::vector<Slot> mySlots;
+	int myFirstSlot;
+	int myPendingCount;
+	int myFrame;
+	CaptureEncoder* myEncoder;
+	int myWidth;
+	int myHeight;
+	bool myLossless;
+	int myCapturedCount;
+	int myDroppedCount;
+	double myLatencySum;
+	float myMaxLatency;
+	long long myLatencyFrameSum;
+	int myMaxLatencyFrames;
+	long long myTimerFrequency;
+};
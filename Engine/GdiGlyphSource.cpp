@@ -0,0 +1,141 @@
+#include "GdiGlyphSource.h"
+
+// GGO_GRAY8_BITMAP hands out coverage in 65 levels.
+static const int GDI_COVERAGE_LEVELS = 64;
+
+GdiGlyphSource::GdiGlyphSource()
+{
+	myDeviceContext = nullptr;
+	myFont = nullptr;
+	myPreviousFont = nullptr;
+	myAscent = 0.0f;
+	myLineHeight = 0.0f;
+}
+
+GdiGlyphSource::~GdiGlyphSource()
+{
+}
+
+bool GdiGlyphSource::Initialize(const wchar_t* aFontName, int aPixelHeight)
+{
+	TEXTMETRICW metrics;
+
+	// Create a memory device context to rasterize the glyphs with.
+	myDeviceContext = CreateCompatibleDC(nullptr);
+	if (myDeviceContext == nullptr)
+	{
+		return false;
+	}
+
+	// Create the font, a negative height asks for the character height rather than the cell height.
+	myFont = CreateFontW(-aPixelHeight, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE, DEFAULT_CHARSET, OUT_TT_PRECIS,
+		CLIP_DEFAULT_PRECIS, ANTIALIASED_QUALITY, DEFAULT_PITCH | FF_DONTCARE, aFontName);
+	if (myFont == nullptr)
+	{
+		return false;
+	}
+	myPreviousFont = SelectObject(myDeviceContext, myFont);
+
+	// Get the vertical metrics used to place the lines.
+	if (!GetTextMetricsW(myDeviceContext, &metrics))
+	{
+		return false;
+	}
+	myAscent = (float)metrics.tmAscent;
+	myLineHeight = (float)(metrics.tmHeight + metrics.tmExternalLeading);
+
+	return true;
+}
+
+void GdiGlyphSource::Shutdown()
+{
+	// Put the original font back before deleting ours.
+	if (myDeviceContext != nullptr && myPreviousFont != nullptr)
+	{
+		SelectObject(myDeviceContext, myPreviousFont);
+		myPreviousFont = nullptr;
+	}
+	// Release the font.
+	if (myFont != nullptr)
+	{
+		DeleteObject(myFont);
+		myFont = nullptr;
+	}
+	// Release the device context.
+	if (myDeviceContext != nullptr)
+	{
+		DeleteDC(myDeviceContext);
+		myDeviceContext = nullptr;
+	}
+}
+
+bool GdiGlyphSource::RasterizeGlyph(unsigned int aCodepoint, GlyphBitmap& aGlyph)
+{
+	GLYPHMETRICS glyphMetrics;
+	MAT2 transform;
+	DWORD size;
+	int x, y, pitch;
+
+	if (myDeviceContext == nullptr || aCodepoint > 0xffff)
+	{
+		return false;
+	}
+
+	// No rotation or scaling of the outline.
+	ZeroMemory(&transform, sizeof(transform));
+	transform.eM11.value = 1;
+	transform.eM22.value = 1;
+
+	// Ask for the size of the bitmap first.
+	size = GetGlyphOutlineW(myDeviceContext, aCodepoint, GGO_GRAY8_BITMAP, &glyphMetrics, 0, nullptr, &transform);
+	if (size == GDI_ERROR)
+	{
+		return false;
+	}
+
+	aGlyph.advance = (float)glyphMetrics.gmCellIncX;
+	aGlyph.offsetX = glyphMetrics.gmptGlyphOrigin.x;
+	aGlyph.offsetY = glyphMetrics.gmptGlyphOrigin.y;
+
+	// Blank glyphs such as the space only move the pen.
+	if (size == 0)
+	{
+		aGlyph.width = 0;
+		aGlyph.height = 0;
+		aGlyph.coverage.clear();
+		return true;
+	}
+
+	// Rasterize the glyph.
+	myBuffer.resize(size);
+	size = GetGlyphOutlineW(myDeviceContext, aCodepoint, GGO_GRAY8_BITMAP, &glyphMetrics, size, &myBuffer[0], &transform);
+	if (size == GDI_ERROR)
+	{
+		return false;
+	}
+
+	// Rows come padded to four bytes with 65 coverage levels, repack them tightly as full bytes.
+	aGlyph.width = glyphMetrics.gmBlackBoxX;
+	aGlyph.height = glyphMetrics.gmBlackBoxY;
+	aGlyph.coverage.resize(aGlyph.width * aGlyph.height);
+	pitch = (aGlyph.width + 3) & ~3;
+	for (y = 0; y < aGlyph.height; y++)
+	{
+		for (x = 0; x < aGlyph.width; x++)
+		{
+			aGlyph.coverage[y * aGlyph.width + x] = (unsigned char)(myBuffer[y * pitch + x] * 255 / GDI_COVERAGE_LEVELS);
+		}
+	}
+
+	return true;
+}
+
+float GdiGlyphSource::GetAscent()
+{
+	return myAscent;
+}
+
+float GdiGlyphSource::GetLineHeight()
+{
+	return myLineHeight;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <windows.h>
+#include "GlyphSource.h"
+
+// Rasterizes glyphs of an installed font at runtime with GDI, so text needs no font sheet on disk.
+class GdiGlyphSource : public GlyphSource
+{
+public:
+	GdiGlyphSource();
+	GdiGlyphSource(const GdiGlyphSource& aGdiGlyphSource) = delete;
+	~GdiGlyphSource();
+
+	bool Initialize(const wchar_t* aFontName, int aPixelHeight);
+	void Shutdown();
+
+	bool RasterizeGlyph(unsigned int aCodepoint, GlyphBitmap& aGlyph);
+	float GetAscent();
+	float GetLineHeight();
+
+private:
+	HDC myDeviceContext;
+	HFONT myFont;
+	HGDIOBJ myPreviousFont;
+	std::vector<unsigned char> myBuffer;
+	float myAscent;
+	float myLineHeight;
+};
@@ -0,0 +1,299 @@
+#include "GlyphCache.h"
+#include "DistanceField.h"
+
+// Marks a cell that holds no glyph.
+static const unsigned int NO_CODEPOINT = 0xffffffff;
+
+GlyphCache::GlyphCache()
+{
+	mySource = nullptr;
+	myUsedSlotCount = 0;
+	myDirtyLeft = 0;
+	myDirtyTop = 0;
+	myDirtyRight = 0;
+	myDirtyBottom = 0;
+	myAtlasSize = 0;
+	myCellSize = 0;
+	myCellsPerRow = 0;
+	mySpread = 0;
+	myFrame = 0;
+	myEvictionCount = 0;
+	myMissCount = 0;
+}
+
+GlyphCache::~GlyphCache()
+{
+}
+
+bool GlyphCache::Initialize(GlyphSource& aSource, int aAtlasSize, int aCellSize, int aSpread)
+{
+	int i, slotCount;
+
+	if (aAtlasSize <= 0 || aCellSize <= 0 || aCellSize > aAtlasSize || aSpread < 0)
+	{
+		return false;
+	}
+	mySource = &aSource;
+	myAtlasSize = aAtlasSize;
+	myCellSize = aCellSize;
+	myCellsPerRow = aAtlasSize / aCellSize;
+	mySpread = aSpread;
+
+	// Every cell starts out empty.
+	slotCount = myCellsPerRow * myCellsPerRow;
+	myGlyphs.resize(slotCount);
+	myCodepoints.resize(slotCount);
+	myLastUsedFrames.resize(slotCount);
+	for (i = 0; i < slotCount; i++)
+	{
+		myCodepoints[i] = NO_CODEPOINT;
+		myLastUsedFrames[i] = 0;
+	}
+	myUsedSlotCount = 0;
+
+	// Clear the atlas to white with zero alpha so filtering at glyph edges blends towards white, not black.
+	myPixels.resize(myAtlasSize * myAtlasSize * 4);
+	for (i = 0; i < myAtlasSize * myAtlasSize; i++)
+	{
+		myPixels[i * 4 + 0] = 255;
+		myPixels[i * 4 + 1] = 255;
+		myPixels[i * 4 + 2] = 255;
+		myPixels[i * 4 + 3] = 0;
+	}
+
+	// The first upload sends the whole atlas.
+	myDirtyLeft = 0;
+	myDirtyTop = 0;
+	myDirtyRight = myAtlasSize;
+	myDirtyBottom = myAtlasSize;
+
+	myFrame = 1;
+	myEvictionCount = 0;
+	myMissCount = 0;
+
+	return true;
+}
+
+void GlyphCache::Shutdown()
+{
+	// Release the cells and the atlas.
+	mySlotLookup.clear();
+	myGlyphs.clear();
+	myCodepoints.clear();
+	myLastUsedFrames.clear();
+	myPixels.clear();
+	myField.clear();
+	myBitmap.coverage.clear();
+
+	myUsedSlotCount = 0;
+	mySource = nullptr;
+}
+
+void GlyphCache::BeginFrame()
+{
+	myFrame++;
+}
+
+int GlyphCache::FindGlyph(unsigned int aCodepoint)
+{
+	std::unordered_map<unsigned int, int>::iterator found;
+	int slot;
+
+	// Glyphs already in the atlas only need to be marked as used.
+	found = mySlotLookup.find(aCodepoint);
+	if (found != mySlotLookup.end())
+	{
+		myLastUsedFrames[found->second] = myFrame;
+		return found->second;
+	}
+
+	// Find a cell for the new glyph, this fails when every glyph in the atlas is in use this frame.
+	slot = FindFreeSlot();
+	if (slot < 0)
+	{
+		return -1;
+	}
+
+	// Evict the glyph that was in the cell.
+	if (myCodepoints[slot] != NO_CODEPOINT)
+	{
+		mySlotLookup.erase(myCodepoints[slot]);
+		myEvictionCount++;
+	}
+
+	myCodepoints[slot] = aCodepoint;
+	myLastUsedFrames[slot] = myFrame;
+	mySlotLookup[aCodepoint] = slot;
+	myMissCount++;
+
+	// Rasterize the glyph into the cell.
+	LoadGlyph(slot);
+
+	return slot;
+}
+
+void GlyphCache::Touch(int aSlot)
+{
+	myLastUsedFrames[aSlot] = myFrame;
+}
+
+const GlyphCache::Glyph& GlyphCache::GetGlyph(int aSlot)
+{
+	return myGlyphs[aSlot];
+}
+
+float GlyphCache::GetAscent()
+{
+	return mySource->GetAscent();
+}
+
+float GlyphCache::GetLineHeight()
+{
+	return mySource->GetLineHeight();
+}
+
+unsigned int GlyphCache::GetEvictionCount()
+{
+	return myEvictionCount;
+}
+
+int GlyphCache::GetMissCount()
+{
+	return myMissCount;
+}
+
+int GlyphCache::GetAtlasSize()
+{
+	return myAtlasSize;
+}
+
+const unsigned char* GlyphCache::GetPixels()
+{
+	return &myPixels[0];
+}
+
+bool GlyphCache::GetDirtyRect(int& aLeft, int& aTop, int& aRight, int& aBottom)
+{
+	aLeft = myDirtyLeft;
+	aTop = myDirtyTop;
+	aRight = myDirtyRight;
+	aBottom = myDirtyBottom;
+
+	return myDirtyRight > myDirtyLeft;
+}
+
+void GlyphCache::ClearDirtyRect()
+{
+	myDirtyLeft = 0;
+	myDirtyTop = 0;
+	myDirtyRight = 0;
+	myDirtyBottom = 0;
+}
+
+int GlyphCache::FindFreeSlot()
+{
+	int i, slot;
+	unsigned int oldest;
+
+	// Hand out the empty cells first.
+	if (myUsedSlotCount < (int)myCodepoints.size())
+	{
+		myUsedSlotCount++;
+		return myUsedSlotCount - 1;
+	}
+
+	// Then the least recently used one, as long as it was not used this frame.
+	slot = -1;
+	oldest = myFrame;
+	for (i = 0; i < (int)myLastUsedFrames.size(); i++)
+	{
+		if (myLastUsedFrames[i] < oldest)
+		{
+			oldest = myLastUsedFrames[i];
+			slot = i;
+		}
+	}
+
+	return slot;
+}
+
+void GlyphCache::LoadGlyph(int aSlot)
+{
+	Glyph& glyph = myGlyphs[aSlot];
+	const unsigned char* source;
+	unsigned char* destination;
+	int cellX, cellY, width, height, pitch, x, y;
+
+	// Rasterize the glyph, glyphs the source does not have come out blank.
+	if (!mySource->RasterizeGlyph(myCodepoints[aSlot], myBitmap))
+	{
+		myBitmap.width = 0;
+		myBitmap.height = 0;
+		myBitmap.offsetX = 0;
+		myBitmap.offsetY = 0;
+		myBitmap.advance = 0.0f;
+	}
+
+	// Turn the coverage into a distance field, it grows by the spread on every side.
+	width = myBitmap.width;
+	height = myBitmap.height;
+	source = myBitmap.coverage.empty() ? nullptr : &myBitmap.coverage[0];
+	if (mySpread > 0 && width > 0 && height > 0)
+	{
+		width += mySpread * 2;
+		height += mySpread * 2;
+		myField.resize(width * height);
+		DistanceField::Generate(source, myBitmap.width, myBitmap.height, mySpread, &myField[0]);
+		source = &myField[0];
+	}
+
+	// Glyphs too large for a cell are cropped.
+	pitch = width;
+	if (width > myCellSize)
+	{
+		width = myCellSize;
+	}
+	if (height > myCellSize)
+	{
+		height = myCellSize;
+	}
+
+	// Clear the cell and copy the glyph into its top left corner.
+	cellX = (aSlot % myCellsPerRow) * myCellSize;
+	cellY = (aSlot / myCellsPerRow) * myCellSize;
+	for (y = 0; y < myCellSize; y++)
+	{
+		destination = &myPixels[((cellY + y) * myAtlasSize + cellX) * 4];
+		for (x = 0; x < myCellSize; x++)
+		{
+			destination[x * 4 + 3] = (x < width && y < height) ? source[y * pitch + x] : 0;
+		}
+	}
+
+	// Describe the quad that shows the glyph, relative to the pen on the baseline.
+	glyph.left = (float)cellX / (float)myAtlasSize;
+	glyph.top = (float)cellY / (float)myAtlasSize;
+	glyph.right = (float)(cellX + width) / (float)myAtlasSize;
+	glyph.bottom = (float)(cellY + height) / (float)myAtlasSize;
+	glyph.offsetX = (float)(myBitmap.offsetX - (width > 0 ? mySpread : 0));
+	glyph.offsetY = (float)(myBitmap.offsetY + (width > 0 ? mySpread : 0));
+	glyph.width = (float)width;
+	glyph.height = (float)height;
+	glyph.advance = myBitmap.advance;
+
+	// Grow the dirty rectangle over the cell.
+	if (myDirtyRight <= myDirtyLeft)
+	{
+		myDirtyLeft = cellX;
+		myDirtyTop = cellY;
+		myDirtyRight = cellX + myCellSize;
+		myDirtyBottom = cellY + myCellSize;
+	}
+	else
+	{
+		myDirtyLeft = cellX < myDirtyLeft ? cellX : myDirtyLeft;
+		myDirtyTop = cellY < myDirtyTop ? cellY : myDirtyTop;
+		myDirtyRight = cellX + myCellSize > myDirtyRight ? cellX + myCellSize : myDirtyRight;
+		myDirtyBottom = cellY + myCellSize > myDirtyBottom ? cellY + myCellSize : myDirtyBottom;
+	}
+}
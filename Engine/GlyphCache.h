@@ -0,0 +1,81 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "GlyphSource.h"
+
+// Texture atlas of rasterized glyphs, filled on demand as text asks for them.
+// The atlas is split into equal cells, one glyph per cell. When every cell is taken the glyph that has gone unused
+// the longest is evicted, glyphs used in the current frame are never evicted. With a spread above zero the cells
+// hold signed distance fields instead of plain coverage.
+// Pixels are kept in system memory as RGBA8 with the glyph in alpha, the renderer uploads the dirty rectangle.
+class GlyphCache
+{
+public:
+	struct Glyph
+	{
+		float left;
+		float top;
+		float right;
+		float bottom;
+		float offsetX;
+		float offsetY;
+		float width;
+		float height;
+		float advance;
+	};
+
+	GlyphCache();
+	GlyphCache(const GlyphCache& aGlyphCache) = delete;
+	~GlyphCache();
+
+	bool Initialize(GlyphSource& aSource, int aAtlasSize, int aCellSize, int aSpread);
+	void Shutdown();
+
+	void BeginFrame();
+	int FindGlyph(unsigned int aCodepoint);
+	void Touch(int aSlot);
+	const Glyph& GetGlyph(int aSlot);
+
+	float GetAscent();
+	float GetLineHeight();
+	unsigned int GetEvictionCount();
+	int GetMissCount();
+
+	int GetAtlasSize();
+	const unsigned char* GetPixels();
+	bool GetDirtyRect(int& aLeft, int& aTop, int& aRight, int& aBottom);
+	void ClearDirtyRect();
+
+private:
+	int FindFreeSlot();
+	void LoadGlyph(int aSlot);
+
+	GlyphSource* mySource;
+	std::unordered_map<unsigned int, int> mySlotLookup;
+
+	// Per cell data.
+	std::vector<Glyph> myGlyphs;
+	std::vector<unsigned int> myCodepoints;
+	std::vector<unsigned int> myLastUsedFrames;
+	int myUsedSlotCount;
+
+	// Atlas pixels and the rectangle changed since the last upload.
+	std::vector<unsigned char> myPixels;
+	int myDirtyLeft;
+	int myDirtyTop;
+	int myDirtyRight;
+	int myDirtyBottom;
+
+	// Scratch space reused by every rasterized glyph.
+	GlyphSource::GlyphBitmap myBitmap;
+	std::vector<unsigned char> myField;
+
+	int myAtlasSize;
+	int myCellSize;
+	int myCellsPerRow;
+	int mySpread;
+	unsigned int myFrame;
+	unsigned int myEvictionCount;
+	int myMissCount;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+
+// Produces coverage bitmaps of single glyphs for the glyph cache.
+// Distances are in pixels with y pointing up from the baseline, which is how the text system lays out lines.
+class GlyphSource
+{
+public:
+	struct GlyphBitmap
+	{
+		int width;
+		int height;
+		int offsetX;
+		int offsetY;
+		float advance;
+		std::vector<unsigned char> coverage;
+	};
+
+	virtual ~GlyphSource() {}
+
+	virtual bool RasterizeGlyph(unsigned int aCodepoint, GlyphBitmap& aGlyph) = 0;
+	virtual float GetAscent() = 0;
+	virtual float GetLineHeight() = 0;
+};
@@ -1,156 +1,2024 @@
 #include "graphicsclass.h"
+#include "AllocationTracker.h"
+#include <math.h>
+#include <string.h>
+
+// Marks a remembered screen rectangle as covering nothing.
+static const DirtyRegion::Rect EMPTY_RECT = { 0, 0, 0, 0 };
+
+// Distance of a plane of the scene from the camera, between the near plane at 0 and the far plane at 1, as the render queue sorts by it.
+static float GetSortDepth(const XMMATRIX& aViewMatrix, float aZ)
+{
+	XMVECTOR position;
+
+	position = XMVector3TransformCoord(XMVectorSet(0.0f, 0.0f, aZ, 1.0f), aViewMatrix);
+	return (XMVectorGetZ(position) - SCREEN_NEAR) / (SCREEN_DEPTH - SCREEN_NEAR);
+}
+
+// Next number between 0 and 1 of a small generator, so the lights of a scenario are laid out the same way every run.
+static float GetRandom(unsigned int& aSeed)
+{
+	aSeed = aSeed * 1664525u + 1013904223u;
+	return (float)(aSeed >> 8) / 16777216.0f;
+}
 
 GraphicsClass::GraphicsClass()
 {
+	int i;
+
 	myDirect3D = nullptr;
-	myCamera = nullptr;
-	myModel = nullptr;
-	myShader = nullptr;
+	myScene = nullptr;
+	myQuadIndexBuffer = nullptr;
+	myUploadRing = nullptr;
+	myTextureUploadQueue = nullptr;
+	myTextureResidency = nullptr;
+	myModelTexture = -1;
+	myRenderResources = nullptr;
+	myRenderQueue = nullptr;
+	myCamera.value = 0;
+	myModel.value = 0;
+	myShader.value = 0;
+	myTexture.value = 0;
+	myMaterial = MATERIAL_OPAQUE;
+	mySpriteAnimation = nullptr;
+	mySpriteBatch = nullptr;
+	mySpriteArrayBatch = nullptr;
+	for (i = 0; i < MAX_SPRITE_TEXTURE_ARRAYS; i++)
+	{
+		mySpriteTextureArrays[i] = nullptr;
+	}
+	mySpriteTextureArrayCount = 0;
+	myJobSystem = nullptr;
+	myParticleSystem = nullptr;
+	myParticleBatch = nullptr;
+	myTilemap = nullptr;
+	myTilemapRenderer = nullptr;
+	myGlyphSource = nullptr;
+	myGlyphCache = nullptr;
+	myTextSystem = nullptr;
+	myTextRenderer = nullptr;
+	myLayerCache = nullptr;
+	myBackgroundLayer = -1;
+	myHudLayer = -1;
+	myDirtyRegion = nullptr;
+	mySpritesMoved = false;
+	myLastTextRect = EMPTY_RECT;
+	myLastSpriteRect = EMPTY_RECT;
+	myLastParticleRect = EMPTY_RECT;
+	myScreenWidth = 0;
+	myScreenHeight = 0;
+	myRedrawCoverage = 0.0f;
+	myIdle = false;
+	myStatsText = -1;
+	myStatsTime = 0.0f;
+	myStatsFrames = 0;
+	myLastFrameAllocations = 0;
+	myOverdrawCounter = nullptr;
+	myShadedPixelCount = 0;
+	myCoveredPixelCount = 0;
+	myLightGrid = nullptr;
+	myLightRenderer = nullptr;
+	myLightCount = 0;
+	myLastLightRect = EMPTY_RECT;
+	GetDefaultScenario(myScenario);
+	myScenarioTime = 0.0f;
+	myTextUpdateTime = 0.0f;
+	for (i = 0; i < MAX_SCENARIO_TEXTS; i++)
+	{
+		myScenarioTexts[i] = -1;
+	}
+	memset(&myFrameStats, 0, sizeof(myFrameStats));
+	myFrameCapture = nullptr;
+	myCaptureContinuous = false;
+	myScreenshotRequested = false;
+	myCaptureText = -1;
+	myWorldStreamer = nullptr;
+	memset(&myStreamStats, 0, sizeof(myStreamStats));
+	myLastCameraPosition = XMFLOAT3(0.0f, 0.0f, 0.0f);
+	myStreamText = -1;
+	myTimerFrequency = 0;
+}
+
+GraphicsClass::~GraphicsClass()
+{
+}
+
+bool GraphicsClass::Initialize(int aScreenWidth, int aScreenHeight, HWND& aHWND, const Scenario& aScenario, bool aHeadless)
+{
+	bool result;
+	Camera* camera;
+	Model* model;
+	Shader* shader;
+	int clip, i, x, y, spriteCount, columns, emitter;
+	ParticleEmitter::Settings fountain;
+	float sizeTimes[3], sizes[3], spacing;
+	LARGE_INTEGER frequency;
+	const SceneCamera* sceneCameras;
+	const SceneTexture* sceneTextures;
+	const SceneTilemap* sceneTilemaps;
+	const unsigned short* sceneTiles;
+	const char* texturePath;
+	int sceneCount, tileCount;
+	WorldStreamer::Settings streamSettings;
+	unsigned int seed;
+	char videoCardName[128];
+	int videoCardMemory;
+	long long textureBudget;
+
+	// Keep the scenario, it decides what the scene holds and how it moves from frame to frame.
+	myScenario = aScenario;
+
+	// Get the frequency of the counter the subsystems are timed with.
+	QueryPerformanceFrequency(&frequency);
+	myTimerFrequency = frequency.QuadPart;
+
+	// Open the scene the scenario names, if any. It is mapped rather than read, so only the sections used are paged in.
+	if (myScenario.scene[0] != '\0')
+	{
+		// Create the scene object.
+		myScene = new SceneFile;
+		if (!myScene)
+		{
+			return false;
+		}
+
+		// Map the scene file.
+		result = myScene->Map(myScenario.scene);
+		if (!result)
+		{
+			MessageBox(aHWND, L"Could not load the scene.", L"Error", MB_OK);
+			return false;
+		}
+	}
+
+	// Create the Direct3D object.
+	myDirect3D = new D3DClass;
+	if (!myDirect3D)
+	{
+		return false;
+	}
+
+	// Initialize the Direct3D object, a headless run renders on the CPU as fast as it can and never presents.
+	result = myDirect3D->Initialize(aScreenWidth, aScreenHeight, VSYNC_ENABLED && !aHeadless, aHWND, FULL_SCREEN && !aHeadless, SCREEN_DEPTH,
+		SCREEN_NEAR, aHeadless);
+	if (!result)
+	{
+		MessageBox(aHWND, L"Could not initialize Direct3D", L"Error", MB_OK);
+		return false;
+	}
+
+	// Create the overdraw counter object.
+	myOverdrawCounter = new OverdrawCounter;
+	if (!myOverdrawCounter)
+	{
+		return false;
+	}
+
+	// Initialize the overdraw counter object.
+	result = myOverdrawCounter->Initialize(*myDirect3D->GetDevice());
+	if (!result)
+	{
+		MessageBox(aHWND, L"Could not initialize the overdraw counter object.", L"Error", MB_OK);
+		return false;
+	}
+
+	// Create the quad index buffer object.
+	myQuadIndexBuffer = new QuadIndexBuffer;
+	if (!myQuadIndexBuffer)
+	{
+		return false;
+	}
+
+	// Initialize the quad index buffer object, every quad drawn below takes its indices from it.
+	result = myQuadIndexBuffer->Initialize(*myDirect3D->GetDevice());
+	if (!result)
+	{
+		MessageBox(aHWND, L"Could not initialize the quad index buffer object.", L"Error", MB_OK);
+		return false;
+	}
+
+	// Create the upload ring object.
+	myUploadRing = new UploadRing;
+	if (!myUploadRing)
+	{
+		return false;
+	}
+
+	// Initialize the upload ring object, the sprites, particles and text write their vertices to it every frame.
+	result = myUploadRing->Initialize(*myDirect3D->GetDevice(), UPLOAD_RING_SIZE);
+	if (!result)
+	{
+		MessageBox(aHWND, L"Could not initialize the upload ring object.", L"Error", MB_OK);
+		return false;
+	}
+
+	// Create the texture upload queue object.
+	myTextureUploadQueue = new TextureUploadQueue;
+	if (!myTextureUploadQueue)
+	{
+		return false;
+	}
+
+	// Initialize the texture upload queue object, textures loaded through it arrive over the first frames instead of all at once.
+	result = myTextureUploadQueue->Initialize(TEXTURE_UPLOAD_BYTES_PER_FRAME, TEXTURE_UPLOAD_MILLISECONDS, TEXTURE_UPLOAD_BLOCK_BYTES);
+	if (!result)
+	{
+		MessageBox(aHWND, L"Could not initialize the texture upload queue object.", L"Error", MB_OK);
+		return false;
+	}
+
+	// Create the texture residency object.
+	myTextureResidency = new TextureResidency;
+	if (!myTextureResidency)
+	{
+		return false;
+	}
+
+	// Initialize the texture residency object with a share of the memory of the video card, or the budget the scenario gives.
+	// A card that reports no memory of its own, like the software rasterizer, gets a default.
+	myDirect3D->GetVideoCardInfo(videoCardName, videoCardMemory);
+	textureBudget = videoCardMemory > 0 ? (long long)videoCardMemory * 1024 * 1024 * TEXTURE_BUDGET_PERCENT / 100 : DEFAULT_TEXTURE_BUDGET;
+	if (myScenario.textureBudget > 0)
+	{
+		textureBudget = (long long)myScenario.textureBudget * 1024;
+	}
+	result = myTextureResidency->Initialize(textureBudget, MIN_RESIDENT_TEXTURE_SIZE);
+	if (!result)
+	{
+		MessageBox(aHWND, L"Could not initialize the texture residency object.", L"Error", MB_OK);
+		return false;
+	}
+
+	// Create the render resources object.
+	myRenderResources = new RenderResources;
+	if (!myRenderResources)
+	{
+		return false;
+	}
+
+	// Initialize the render resources object, it owns the camera, model and shader from here on.
+	result = myRenderResources->Initialize();
+	if (!result)
+	{
+		MessageBox(aHWND, L"Could not initialize the render resources object.", L"Error", MB_OK);
+		return false;
+	}
+
+	// Create the render queue object.
+	myRenderQueue = new RenderQueue;
+	if (!myRenderQueue)
+	{
+		return false;
+	}
+
+	// Initialize the render queue object.
+	result = myRenderQueue->Initialize(MAX_RENDER_COMMANDS);
+	if (!result)
+	{
+		MessageBox(aHWND, L"Could not initialize the render queue object.", L"Error", MB_OK);
+		return false;
+	}
+
+	// Create the camera object and hand it to the render resources.
+	camera = new Camera;
+	if (!camera)
+	{
+		return false;
+	}
+	myCamera = myRenderResources->AddCamera(camera);
+	if (myCamera.IsNull())
+	{
+		delete camera;
+		return false;
+	}
+
+	// Set the initial position of the camera, a scene brings its own.
+	sceneCameras = myScene != nullptr ? myScene->GetCameras(sceneCount) : nullptr;
+	if (sceneCameras != nullptr)
+	{
+		camera->SetPosition(sceneCameras[0].position[0], sceneCameras[0].position[1], sceneCameras[0].position[2]);
+		camera->SetRotation(sceneCameras[0].rotation[0], sceneCameras[0].rotation[1], sceneCameras[0].rotation[2]);
+	}
+	else
+	{
+		camera->SetPosition(0.0f, 0.0f, -5.0f);
+	}
+	myLastCameraPosition = camera->GetPosition();
+
+	// Create the model object and hand it to the render resources.
+	model = new Model;
+	if (!model)
+	{
+		return false;
+	}
+	myModel = myRenderResources->AddModel(model);
+	if (myModel.IsNull())
+	{
+		delete model;
+		return false;
+	}
+
+	// Initialize the model object, with the first texture of the scene when there is one. It is drawn as the outline of its visible texels.
+	texturePath = "../../Bin/Sprites/testTexture.tga";
+	sceneTextures = myScene != nullptr ? myScene->GetTextures(sceneCount) : nullptr;
+	if (sceneTextures != nullptr && memchr(sceneTextures[0].path, '\0', SCENE_PATH_LENGTH) != nullptr)
+	{
+		texturePath = sceneTextures[0].path;
+	}
+	result = model->Initialize(*myDirect3D->GetDevice(), *myDirect3D->GetDeviceContext(), *myQuadIndexBuffer, texturePath, MODEL_OUTLINE_VERTICES,
+		myTextureUploadQueue);
+	if (!result)
+	{
+		MessageBox(aHWND, L"Could not initialize the model object.", L"Error", MB_OK);
+		return false;
+	}
+
+	// The model texture doubles as the sprite sheet and tile atlas, so give it a handle of its own.
+	// Its alpha decides the pass the model, the sprites and the particles drawn with it go in.
+	myTexture = myRenderResources->AddTexture(model->GetTexture());
+	if (myTexture.IsNull())
+	{
+		return false;
+	}
+
+	// Count the texture against the budget, the normal map built from it is as large again.
+	myModelTexture = myTextureResidency->AddTexture(model->GetTextureWidth(), model->GetTextureHeight(), 8);
+	myMaterial = model->GetMaterial();
+
+	// Create the shader object and hand it to the render resources.
+	shader = new Shader;
+	if (!shader)
+	{
+		return false;
+	}
+	myShader = myRenderResources->AddShader(shader);
+	if (myShader.IsNull())
+	{
+		delete shader;
+		return false;
+	}
+
+	// Initialize the shader object.
+	result = shader->Initialize(*myDirect3D->GetDevice(), aHWND);
+	if (!result)
+	{
+		MessageBox(aHWND, L"Could not initialize the shader object.", L"Error", MB_OK);
+		return false;
+	}
+
+	// Create the sprite animation object.
+	mySpriteAnimation = new SpriteAnimation;
+	if (!mySpriteAnimation)
+	{
+		return false;
+	}
+
+	// Initialize the sprite animation object.
+	result = mySpriteAnimation->Initialize(MAX_SPRITES);
+	if (!result)
+	{
+		MessageBox(aHWND, L"Could not initialize the sprite animation object.", L"Error", MB_OK);
+		return false;
+	}
+
+	// Create the sprite batch object.
+	mySpriteBatch = new SpriteBatch;
+	if (!mySpriteBatch)
+	{
+		return false;
+	}
+
+	// Initialize the sprite batch object.
+	result = mySpriteBatch->Initialize(*myUploadRing, *myQuadIndexBuffer, MAX_SPRITES);
+	if (!result)
+	{
+		MessageBox(aHWND, L"Could not initialize the sprite batch object.", L"Error", MB_OK);
+		return false;
+	}
+
+	if (myScene != nullptr)
+	{
+		// Take the sprites from the scene.
+		result = CreateSceneSprites();
+		if (!result)
+		{
+			MessageBox(aHWND, L"Could not create the sprites of the scene.", L"Error", MB_OK);
+			return false;
+		}
+	}
+	else
+	{
+		// Lay the sprites out in rows from the top of the screen, one row of eight for the demo and a finer grid for more.
+		spriteCount = myScenario.spriteCount < 0 ? 0 : (myScenario.spriteCount > MAX_SPRITES ? MAX_SPRITES : myScenario.spriteCount);
+		columns = (int)ceilf(sqrtf(2.0f * (float)spriteCount));
+		columns = columns < SPRITE_GRID_MIN_COLUMNS ? SPRITE_GRID_MIN_COLUMNS : columns;
+		spacing = SPRITE_GRID_WIDTH / (float)columns;
+
+		// Play the texture as a 4x4 sheet on the sprites, each one a few frames ahead of the one to its right.
+		clip = mySpriteAnimation->AddGridClip(4, 4, 0, 16, 0.1f, true);
+		for (i = 0; i < spriteCount; i++)
+		{
+			mySpriteAnimation->CreateInstance(clip, 1.0f);
+			mySpriteAnimation->Update(0.05f * (i % columns));
+
+			mySpriteOrigins[i] = XMFLOAT2(-SPRITE_GRID_WIDTH * 0.5f + spacing * ((float)(i % columns) + 0.5f), SPRITE_GRID_TOP - spacing * (float)(i / columns));
+			mySpritePositions[i] = mySpriteOrigins[i];
+			mySpriteSizes[i] = XMFLOAT2(0.8f * spacing, 0.8f * spacing);
+		}
+
+		// Give the sprites images of their own instead of the model texture when the scenario asks for them.
+		if (myScenario.spriteTextureCount > 0)
+		{
+			result = CreateSpriteTextures(myScenario.spriteTextureCount, spriteCount);
+			if (!result)
+			{
+				MessageBox(aHWND, L"Could not create the sprite textures.", L"Error", MB_OK);
+				return false;
+			}
+		}
+	}
+
+	// Create the job system object.
+	myJobSystem = new JobSystem;
+	if (!myJobSystem)
+	{
+		return false;
+	}
+
+	// Initialize the job system object with one thread per core.
+	result = myJobSystem->Initialize(0);
+	if (!result)
+	{
+		MessageBox(aHWND, L"Could not initialize the job system object.", L"Error", MB_OK);
+		return false;
+	}
+
+	// Create the particle system object.
+	myParticleSystem = new ParticleSystem;
+	if (!myParticleSystem)
+	{
+		return false;
+	}
+
+	// Initialize the particle system object.
+	result = myParticleSystem->Initialize(*myJobSystem);
+	if (!result)
+	{
+		MessageBox(aHWND, L"Could not initialize the particle system object.", L"Error", MB_OK);
+		return false;
+	}
+
+	// Create the particle batch object.
+	myParticleBatch = new SpriteBatch;
+	if (!myParticleBatch)
+	{
+		return false;
+	}
+
+	// Initialize the particle batch object.
+	result = myParticleBatch->Initialize(*myUploadRing, *myQuadIndexBuffer, MAX_PARTICLES);
+	if (!result)
+	{
+		MessageBox(aHWND, L"Could not initialize the particle batch object.", L"Error", MB_OK);
+		return false;
+	}
+
+	// Set up the fountains in a row below the model.
+	fountain.positionX = 0.0f;
+	fountain.positionY = -2.0f;
+	fountain.spawnRadius = 0.1f;
+	fountain.emissionRate = myScenario.emissionRate;
+	fountain.lifetimeMin = 1.5f;
+	fountain.lifetimeMax = 2.5f;
+	fountain.speedMin = 2.5f;
+	fountain.speedMax = 3.5f;
+	fountain.directionMin = 1.3f;
+	fountain.directionMax = 1.85f;
+	fountain.gravityX = 0.0f;
+	fountain.gravityY = -3.0f;
+	fountain.drag = 0.2f;
+
+	// Let the drops grow quickly and then shrink away.
+	sizeTimes[0] = 0.0f;
+	sizeTimes[1] = 0.1f;
+	sizeTimes[2] = 1.0f;
+	sizes[0] = 0.02f;
+	sizes[1] = 0.06f;
+	sizes[2] = 0.0f;
+
+	// Every fountain holds the drops it emits over their longest lifetime and one more step.
+	for (i = 0; i < myScenario.emitterCount; i++)
+	{
+		fountain.positionX = -3.0f + 6.0f * ((float)i + 0.5f) / (float)myScenario.emitterCount;
+		emitter = myParticleSystem->AddEmitter(fountain, (int)(fountain.emissionRate * (fountain.lifetimeMax + 0.1f)) + 1);
+		if (emitter < 0)
+		{
+			return false;
+		}
+		myParticleSystem->GetEmitter(emitter)->SetSizeCurve(sizeTimes, sizes, 3);
+	}
+
+	// Create the tilemap object.
+	myTilemap = new Tilemap;
+	if (!myTilemap)
+	{
+		return false;
+	}
+
+	sceneTilemaps = myScene != nullptr ? myScene->GetTilemaps(sceneCount) : nullptr;
+	if (sceneTilemaps != nullptr)
+	{
+		// Initialize the tilemap object the way the first tilemap of the scene is laid out.
+		result = myTilemap->Initialize(sceneTilemaps[0].width, sceneTilemaps[0].height, sceneTilemaps[0].tileSize, sceneTilemaps[0].originX,
+			sceneTilemaps[0].originY, sceneTilemaps[0].atlasColumns, sceneTilemaps[0].atlasRows);
+		if (!result)
+		{
+			MessageBox(aHWND, L"Could not initialize the tilemap object.", L"Error", MB_OK);
+			return false;
+		}
+
+		// Copy its tiles over in one block, they are stored the way the tilemap keeps them.
+		sceneTiles = myScene->GetTiles(tileCount);
+		if (sceneTiles == nullptr || (size_t)sceneTilemaps[0].firstTile + (size_t)sceneTilemaps[0].width * (size_t)sceneTilemaps[0].height > (size_t)tileCount)
+		{
+			MessageBox(aHWND, L"The tilemap of the scene is missing tiles.", L"Error", MB_OK);
+			return false;
+		}
+
+		if (myScenario.streamDistance > 0.0f)
+		{
+			// Create the world streamer object, it reads the tiles from the scene file in cells around the camera instead.
+			myWorldStreamer = new WorldStreamer;
+			if (!myWorldStreamer)
+			{
+				return false;
+			}
+
+			// Initialize the world streamer object.
+			streamSettings.cellSize = STREAM_CELL_SIZE;
+			streamSettings.prefetchDistance = myScenario.streamDistance;
+			streamSettings.lookAheadTime = STREAM_LOOK_AHEAD_TIME;
+			streamSettings.maxResidentCells = MAX_RESIDENT_CELLS;
+			streamSettings.maxLoadsInFlight = MAX_CELL_LOADS;
+			result = myWorldStreamer->Initialize(myScenario.scene, myScene->GetOffset(sceneTiles + sceneTilemaps[0].firstTile), *myTilemap,
+				streamSettings);
+			if (!result)
+			{
+				MessageBox(aHWND, L"Could not initialize the world streamer object.", L"Error", MB_OK);
+				return false;
+			}
+
+			// Wait for the cells around the first view, the rest stream in as the camera moves.
+			UpdateStreaming(0.0f);
+			myWorldStreamer->Flush();
+			myWorldStreamer->GetStats(myStreamStats);
+		}
+		else
+		{
+			myTilemap->SetTiles(sceneTiles + sceneTilemaps[0].firstTile);
+		}
+	}
+	else
+	{
+		// Initialize the tilemap object centered on the origin, using the texture as a 4x4 atlas.
+		result = myTilemap->Initialize(TILEMAP_SIZE, TILEMAP_SIZE, TILEMAP_TILE_SIZE, -TILEMAP_SIZE * TILEMAP_TILE_SIZE * 0.5f,
+			-TILEMAP_SIZE * TILEMAP_TILE_SIZE * 0.5f, 4, 4);
+		if (!result)
+		{
+			MessageBox(aHWND, L"Could not initialize the tilemap object.", L"Error", MB_OK);
+			return false;
+		}
+
+		// Fill the map with a pattern of tiles and holes.
+		for (y = 0; y < TILEMAP_SIZE; y++)
+		{
+			for (x = 0; x < TILEMAP_SIZE; x++)
+			{
+				if (((x / 7) + (y / 5)) % 9 != 0)
+				{
+					myTilemap->SetTile(x, y, (unsigned short)(1 + ((x * 31) ^ (y * 17)) % 16));
+				}
+			}
+		}
+	}
+
+	// Create the tilemap renderer object.
+	myTilemapRenderer = new TilemapRenderer;
+	if (!myTilemapRenderer)
+	{
+		return false;
+	}
+
+	// Initialize the tilemap renderer object. Streamed cells arrive every few frames, so their chunks are built a few at a time.
+	result = myTilemapRenderer->Initialize(*myDirect3D->GetDevice(), *myTilemap, *myQuadIndexBuffer, MAX_RESIDENT_CHUNKS,
+		myWorldStreamer != nullptr ? MAX_CHUNK_BUILDS_PER_FRAME : MAX_RESIDENT_CHUNKS);
+	if (!result)
+	{
+		MessageBox(aHWND, L"Could not initialize the tilemap renderer object.", L"Error", MB_OK);
+		return false;
+	}
+
+	// Create the glyph source object.
+	myGlyphSource = new GdiGlyphSource;
+	if (!myGlyphSource)
+	{
+		return false;
+	}
+
+	// Initialize the glyph source object with a font every Windows install has.
+	result = myGlyphSource->Initialize(L"Consolas", FONT_PIXEL_HEIGHT);
+	if (!result)
+	{
+		MessageBox(aHWND, L"Could not initialize the glyph source object.", L"Error", MB_OK);
+		return false;
+	}
+
+	// Create the glyph cache object.
+	myGlyphCache = new GlyphCache;
+	if (!myGlyphCache)
+	{
+		return false;
+	}
+
+	// Initialize the glyph cache object with plain coverage, the texture shader has no distance field threshold.
+	result = myGlyphCache->Initialize(*myGlyphSource, GLYPH_ATLAS_SIZE, GLYPH_CELL_SIZE, 0);
+	if (!result)
+	{
+		MessageBox(aHWND, L"Could not initialize the glyph cache object.", L"Error", MB_OK);
+		return false;
+	}
+
+	// Create the text system object.
+	myTextSystem = new TextSystem;
+	if (!myTextSystem)
+	{
+		return false;
+	}
+
+	// Initialize the text system object.
+	result = myTextSystem->Initialize(*myGlyphCache);
+	if (!result)
+	{
+		MessageBox(aHWND, L"Could not initialize the text system object.", L"Error", MB_OK);
+		return false;
+	}
+
+	// Create the text renderer object.
+	myTextRenderer = new TextRenderer;
+	if (!myTextRenderer)
+	{
+		return false;
+	}
+
+	// Initialize the text renderer object.
+	result = myTextRenderer->Initialize(*myDirect3D->GetDevice(), *myGlyphCache, *myUploadRing, *myQuadIndexBuffer, MAX_GLYPHS);
+	if (!result)
+	{
+		MessageBox(aHWND, L"Could not initialize the text renderer object.", L"Error", MB_OK);
+		return false;
+	}
+
+	// Create the layer cache object.
+	myLayerCache = new LayerCache;
+	if (!myLayerCache)
+	{
+		return false;
+	}
+
+	// Initialize the layer cache object with layers the size of the back buffer.
+	result = myLayerCache->Initialize(*myDirect3D, *myQuadIndexBuffer, aScreenWidth, aScreenHeight, MAX_LAYERS);
+	if (!result)
+	{
+		MessageBox(aHWND, L"Could not initialize the layer cache object.", L"Error", MB_OK);
+		return false;
+	}
+
+	// The tilemap behind the scene and the text in front of it only change now and then, so both get a layer.
+	myBackgroundLayer = myLayerCache->CreateLayer();
+	myHudLayer = myLayerCache->CreateLayer();
+	if (myBackgroundLayer < 0 || myHudLayer < 0)
+	{
+		MessageBox(aHWND, L"Could not create the cached layers.", L"Error", MB_OK);
+		return false;
+	}
+
+	// Create the dirty region object.
+	myDirtyRegion = new DirtyRegion;
+	if (!myDirtyRegion)
+	{
+		return false;
+	}
+
+	// Initialize the dirty region object, the first frame redraws the whole screen.
+	myScreenWidth = aScreenWidth;
+	myScreenHeight = aScreenHeight;
+	result = myDirtyRegion->Initialize(myScreenWidth, myScreenHeight);
+	if (!result)
+	{
+		MessageBox(aHWND, L"Could not initialize the dirty region object.", L"Error", MB_OK);
+		return false;
+	}
+
+	if (myScenario.lightCount > 0)
+	{
+		// Create the light grid object.
+		myLightGrid = new LightGrid;
+		if (!myLightGrid)
+		{
+			return false;
+		}
+
+		// Initialize the light grid object with tiles over the back buffer.
+		myLightCount = myScenario.lightCount > MAX_LIGHTS ? MAX_LIGHTS : myScenario.lightCount;
+		result = myLightGrid->Initialize(myScreenWidth, myScreenHeight, LIGHT_TILE_SIZE, myLightCount, MAX_LIGHTS_PER_TILE);
+		if (!result)
+		{
+			MessageBox(aHWND, L"Could not initialize the light grid object.", L"Error", MB_OK);
+			return false;
+		}
+
+		// Create the light renderer object.
+		myLightRenderer = new LightRenderer;
+		if (!myLightRenderer)
+		{
+			return false;
+		}
+
+		// Initialize the light renderer object with room for every light and a full list in every tile.
+		result = myLightRenderer->Initialize(*myDirect3D->GetDevice(), myLightCount, myLightGrid->GetTileCountX() * myLightGrid->GetTileCountY(),
+			MAX_LIGHTS_PER_TILE);
+		if (!result)
+		{
+			MessageBox(aHWND, L"Could not initialize the light renderer object.", L"Error", MB_OK);
+			return false;
+		}
+
+		// Scatter lanterns of warm colors over the sprites, each one with a place it wanders around and a radius in the scene.
+		seed = 1;
+		for (i = 0; i < myLightCount; i++)
+		{
+			myLightOrigins[i] = XMFLOAT3(-4.0f + 8.0f * GetRandom(seed), -2.5f + 5.0f * GetRandom(seed), 0.3f + 0.5f * GetRandom(seed));
+			myLightColors[i] = XMFLOAT3(0.9f + 0.6f * GetRandom(seed), 0.6f + 0.6f * GetRandom(seed), 0.2f + 0.6f * GetRandom(seed));
+		}
+	}
+
+	// Put a line of frame statistics in the bottom left corner.
+	myStatsText = myTextSystem->CreateText();
+	myTextSystem->SetPosition(myStatsText, -2.7f, -1.6f);
+	myTextSystem->SetScale(myStatsText, TEXT_SCALE);
+
+	// Show how the streaming keeps up above the statistics.
+	if (myWorldStreamer != nullptr)
+	{
+		myStreamText = myTextSystem->CreateText();
+		myTextSystem->SetPosition(myStreamText, -2.7f, -1.3f);
+		myTextSystem->SetScale(myStreamText, TEXT_SCALE);
+	}
+
+	// Stack the text lines of the scenario down from the top left corner, they are written as the scene runs.
+	for (i = 0; i < myScenario.textCount && i < MAX_SCENARIO_TEXTS; i++)
+	{
+		myScenarioTexts[i] = myTextSystem->CreateText();
+		myTextSystem->SetPosition(myScenarioTexts[i], -2.7f, 1.9f - SCENARIO_TEXT_SPACING * (float)i);
+		myTextSystem->SetScale(myScenarioTexts[i], SCENARIO_TEXT_SCALE);
+	}
+
+	return true;
+}
+
+void GraphicsClass::Shutdown()
+{
+	int i;
+
+	// Stop the capture, frames still in flight are written first.
+	StopCapture();
+	// Release the light renderer object.
+	if (myLightRenderer != nullptr)
+	{
+		myLightRenderer->Shutdown();
+		delete myLightRenderer;
+		myLightRenderer = nullptr;
+	}
+	// Release the light grid object.
+	if (myLightGrid != nullptr)
+	{
+		myLightGrid->Shutdown();
+		delete myLightGrid;
+		myLightGrid = nullptr;
+	}
+	myLightCount = 0;
+	// Release the dirty region object.
+	if (myDirtyRegion != nullptr)
+	{
+		delete myDirtyRegion;
+		myDirtyRegion = nullptr;
+	}
+	// Release the layer cache object.
+	if (myLayerCache != nullptr)
+	{
+		myLayerCache->Shutdown();
+		delete myLayerCache;
+		myLayerCache = nullptr;
+	}
+	myBackgroundLayer = -1;
+	myHudLayer = -1;
+	// Release the text renderer object.
+	if (myTextRenderer != nullptr)
+	{
+		myTextRenderer->Shutdown();
+		delete myTextRenderer;
+		myTextRenderer = nullptr;
+	}
+	// Release the text system object.
+	if (myTextSystem != nullptr)
+	{
+		myTextSystem->Shutdown();
+		delete myTextSystem;
+		myTextSystem = nullptr;
+	}
+	// Release the glyph cache object.
+	if (myGlyphCache != nullptr)
+	{
+		myGlyphCache->Shutdown();
+		delete myGlyphCache;
+		myGlyphCache = nullptr;
+	}
+	// Release the glyph source object.
+	if (myGlyphSource != nullptr)
+	{
+		myGlyphSource->Shutdown();
+		delete myGlyphSource;
+		myGlyphSource = nullptr;
+	}
+	// Release the tilemap renderer object.
+	if (myTilemapRenderer != nullptr)
+	{
+		myTilemapRenderer->Shutdown();
+		delete myTilemapRenderer;
+		myTilemapRenderer = nullptr;
+	}
+	// Release the world streamer object, it writes into the tilemap until it is stopped.
+	if (myWorldStreamer != nullptr)
+	{
+		myWorldStreamer->Shutdown();
+		delete myWorldStreamer;
+		myWorldStreamer = nullptr;
+	}
+	myStreamText = -1;
+	// Release the tilemap object.
+	if (myTilemap != nullptr)
+	{
+		myTilemap->Shutdown();
+		delete myTilemap;
+		myTilemap = nullptr;
+	}
+	// Release the particle batch object.
+	if (myParticleBatch != nullptr)
+	{
+		myParticleBatch->Shutdown();
+		delete myParticleBatch;
+		myParticleBatch = nullptr;
+	}
+	// Release the particle system object.
+	if (myParticleSystem != nullptr)
+	{
+		myParticleSystem->Shutdown();
+		delete myParticleSystem;
+		myParticleSystem = nullptr;
+	}
+	// Release the job system object.
+	if (myJobSystem != nullptr)
+	{
+		myJobSystem->Shutdown();
+		delete myJobSystem;
+		myJobSystem = nullptr;
+	}
+	// Release the sprite array batch object and the texture arrays it draws from.
+	if (mySpriteArrayBatch != nullptr)
+	{
+		mySpriteArrayBatch->Shutdown();
+		delete mySpriteArrayBatch;
+		mySpriteArrayBatch = nullptr;
+	}
+	for (i = 0; i < MAX_SPRITE_TEXTURE_ARRAYS; i++)
+	{
+		if (mySpriteTextureArrays[i] != nullptr)
+		{
+			mySpriteTextureArrays[i]->Shutdown();
+			delete mySpriteTextureArrays[i];
+			mySpriteTextureArrays[i] = nullptr;
+		}
+	}
+	mySpriteTextureArrayCount = 0;
+	// Release the sprite batch object.
+	if (mySpriteBatch != nullptr)
+	{
+		mySpriteBatch->Shutdown();
+		delete mySpriteBatch;
+		mySpriteBatch = nullptr;
+	}
+	// Release the sprite animation object.
+	if (mySpriteAnimation != nullptr)
+	{
+		mySpriteAnimation->Shutdown();
+		delete mySpriteAnimation;
+		mySpriteAnimation = nullptr;
+	}
+	// Release the render queue object.
+	if (myRenderQueue != nullptr)
+	{
+		myRenderQueue->Shutdown();
+		delete myRenderQueue;
+		myRenderQueue = nullptr;
+	}
+	// Release the render resources object along with the shader, texture, model and camera it owns.
+	if (myRenderResources != nullptr)
+	{
+		myRenderResources->Shutdown();
+		delete myRenderResources;
+		myRenderResources = nullptr;
+	}
+	myCamera.value = 0;
+	myModel.value = 0;
+	myShader.value = 0;
+	myTexture.value = 0;
+	myMaterial = MATERIAL_OPAQUE;
+	// Release the texture residency object.
+	if (myTextureResidency != nullptr)
+	{
+		myTextureResidency->Shutdown();
+		delete myTextureResidency;
+		myTextureResidency = nullptr;
+	}
+	myModelTexture = -1;
+	// Release the texture upload queue object, after the textures that may still have been waiting in it.
+	if (myTextureUploadQueue != nullptr)
+	{
+		myTextureUploadQueue->Shutdown();
+		delete myTextureUploadQueue;
+		myTextureUploadQueue = nullptr;
+	}
+	// Release the upload ring object.
+	if (myUploadRing != nullptr)
+	{
+		myUploadRing->Shutdown();
+		delete myUploadRing;
+		myUploadRing = nullptr;
+	}
+	// Release the quad index buffer object.
+	if (myQuadIndexBuffer != nullptr)
+	{
+		myQuadIndexBuffer->Shutdown();
+		delete myQuadIndexBuffer;
+		myQuadIndexBuffer = nullptr;
+	}
+	// Release the overdraw counter object.
+	if (myOverdrawCounter != nullptr)
+	{
+		myOverdrawCounter->Shutdown();
+		delete myOverdrawCounter;
+		myOverdrawCounter = nullptr;
+	}
+	// Release the Direct3D object.
+	if (myDirect3D != nullptr)
+	{
+		myDirect3D->Shutdown();
+		delete myDirect3D;
+		myDirect3D = nullptr;
+	}
+
+	// Release the scene object.
+	if (myScene != nullptr)
+	{
+		myScene->Shutdown();
+		delete myScene;
+		myScene = nullptr;
+	}
+	return;
+}
+
+
+bool GraphicsClass::Frame(float aFrameTime)
+{
+	bool result;
+	char stats[160];
+	LARGE_INTEGER frameStart, start, end;
+	FrameCapture::Stats captureStats;
+	OverdrawCounter::Result overdraw;
+	RingAllocator::Stats uploadStats;
+	TextureUploadQueue::Stats textureUploadStats;
+
+	ALLOCATION_SCOPE("Graphics");
+
+	// Start the stats of this frame.
+	QueryPerformanceCounter(&frameStart);
+	memset(&myFrameStats, 0, sizeof(myFrameStats));
+
+#ifdef ALLOCATION_TRACKING
+	// Keep the heap allocations of the last frame for the statistics and start counting this one.
+	myLastFrameAllocations = AllocationTracker::GetFrameHeapAllocationCount();
+	AllocationTracker::BeginFrame();
+#endif
+
+	// Move the scene the way the scenario scripts it.
+	UpdateScene(aFrameTime);
+
+	// Bring in the cells of the level around the camera.
+	UpdateStreaming(aFrameTime);
+
+	// Advance all sprite animations.
+	QueryPerformanceCounter(&start);
+	mySpriteAnimation->Update(aFrameTime);
+	QueryPerformanceCounter(&end);
+	myFrameStats.animationTime = GetMilliseconds(start, end);
+
+	// Advance all particle emitters.
+	QueryPerformanceCounter(&start);
+	myParticleSystem->Update(aFrameTime);
+	QueryPerformanceCounter(&end);
+	myFrameStats.particleTime = GetMilliseconds(start, end);
+
+	// Pick up the pixel counts of the earlier frames the GPU has finished.
+	while (myOverdrawCounter->Read(*myDirect3D->GetDeviceContext(), overdraw))
+	{
+		myFrameStats.shadedPixelCount += overdraw.shadedPixelCount;
+		myFrameStats.coveredPixelCount += overdraw.coveredPixelCount;
+	}
+	myShadedPixelCount += myFrameStats.shadedPixelCount;
+	myCoveredPixelCount += myFrameStats.coveredPixelCount;
+
+	// Refresh the statistics once a second, the text keeps its layout in between. Only presented frames are counted.
+	myStatsTime += aFrameTime;
+	if (myStatsTime >= 1.0f)
+	{
+#ifdef ALLOCATION_TRACKING
+		sprintf_s(stats, sizeof(stats), "FPS: %d  Redrawn: %d%%  Overdraw: %.2f  Particles: %d  Layer hits: %d/%d  Heap allocations: %d",
+			(int)(myStatsFrames / myStatsTime), (int)(myRedrawCoverage * 100.0f),
+			myCoveredPixelCount > 0 ? (float)myShadedPixelCount / (float)myCoveredPixelCount : 0.0f, myParticleSystem->GetParticleCount(),
+			myLayerCache->GetHitCount(myBackgroundLayer), myLayerCache->GetHitCount(myBackgroundLayer) + myLayerCache->GetMissCount(myBackgroundLayer),
+			myLastFrameAllocations);
+#else
+		sprintf_s(stats, sizeof(stats), "FPS: %d  Redrawn: %d%%  Overdraw: %.2f  Particles: %d  Layer hits: %d/%d", (int)(myStatsFrames / myStatsTime),
+			(int)(myRedrawCoverage * 100.0f), myCoveredPixelCount > 0 ? (float)myShadedPixelCount / (float)myCoveredPixelCount : 0.0f,
+			myParticleSystem->GetParticleCount(), myLayerCache->GetHitCount(myBackgroundLayer),
+			myLayerCache->GetHitCount(myBackgroundLayer) + myLayerCache->GetMissCount(myBackgroundLayer));
+#endif
+		myTextSystem->SetText(myStatsText, stats);
+		if (myCaptureText >= 0)
+		{
+			myFrameCapture->GetStats(captureStats);
+			sprintf_s(stats, sizeof(stats), "Captured: %d  Dropped: %d  Latency: %.1f ms (%.1f frames)", captureStats.capturedCount,
+				captureStats.droppedCount, captureStats.averageLatency, captureStats.averageLatencyFrames);
+			myTextSystem->SetText(myCaptureText, stats);
+		}
+		if (myStreamText >= 0)
+		{
+			sprintf_s(stats, sizeof(stats), "Cells: %d  Pending: %d  Streamed: %.1f MB/s  Pop-ins: %d", myStreamStats.residentCellCount,
+				myStreamStats.pendingCellCount, myStreamStats.bandwidth / (1024.0f * 1024.0f), myStreamStats.popInCount);
+			myTextSystem->SetText(myStreamText, stats);
+		}
+		myStatsTime = 0.0f;
+		myStatsFrames = 0;
+		myShadedPixelCount = 0;
+		myCoveredPixelCount = 0;
+	}
+
+	// Keep the textures within their budget, then upload the next pieces of the textures still loading. A mip that arrived changes the look of everything drawn with the
+	// texture, the cached tilemap layer included.
+	UpdateTextureResidency();
+	myTextureUploadQueue->Update();
+	myTextureUploadQueue->GetStats(textureUploadStats);
+	myFrameStats.textureUploadTime = textureUploadStats.frameTime;
+	myFrameStats.textureUploadBytes = textureUploadStats.frameBytes;
+	if (textureUploadStats.frameMipCount > 0)
+	{
+		myLayerCache->Invalidate(myBackgroundLayer);
+		myDirtyRegion->Invalidate();
+	}
+
+	// Render the graphics scene. Its vertices go to the ranges of the upload ring the GPU is done with, and the end of
+	// the frame is fenced so the ranges it wrote are kept until the GPU has drawn them.
+	QueryPerformanceCounter(&start);
+	myUploadRing->BeginFrame(*myDirect3D->GetDeviceContext());
+	result = Render();
+	myUploadRing->EndFrame(*myDirect3D->GetDeviceContext());
+	QueryPerformanceCounter(&end);
+	if (!result)
+	{
+		return false;
+	}
+	myFrameStats.renderTime = GetMilliseconds(start, end);
+	myUploadRing->GetStats(uploadStats);
+	myFrameStats.uploadedBytes = (int)uploadStats.frameBytes;
+	myFrameStats.uploadDiscardCount = uploadStats.frameDiscardCount;
+
+	// Read the frame back for the capture. The back buffer keeps its contents, so an idle frame captures the last one again.
+	if (myFrameCapture != nullptr)
+	{
+		if (myCaptureContinuous || myScreenshotRequested)
+		{
+			myFrameCapture->Capture(*myDirect3D->GetDeviceContext(), *myDirect3D->GetBackBuffer());
+		}
+		else
+		{
+			myFrameCapture->Update(*myDirect3D->GetDeviceContext());
+		}
+		myScreenshotRequested = false;
+		QueryPerformanceCounter(&end);
+	}
+
+	// Finish the stats of this frame.
+	myFrameStats.frameTime = GetMilliseconds(frameStart, end);
+	myFrameStats.spriteCount = mySpriteAnimation->GetInstanceCount();
+	myFrameStats.particleCount = myParticleSystem->GetParticleCount();
+	myFrameStats.presented = !myIdle;
+	if (myFrameStats.presented)
+	{
+		myFrameStats.redrawCoverage = myRedrawCoverage;
+	}
+#ifdef ALLOCATION_TRACKING
+	myFrameStats.heapAllocationCount = AllocationTracker::GetFrameHeapAllocationCount();
+#endif
+	return true;
+}
+
+const FrameStats& GraphicsClass::GetFrameStats()
+{
+	return myFrameStats;
+}
+
+bool GraphicsClass::StartCapture(const char* aDirectory, CaptureEncoder::Format aFormat, bool aContinuous, bool aLossless)
+{
+	bool result;
+
+	StopCapture();
+
+	// Create the frame capture object.
+	myFrameCapture = new FrameCapture;
+	if (!myFrameCapture)
+	{
+		return false;
+	}
+
+	// Initialize the frame capture object with the size and format of the back buffer.
+	result = myFrameCapture->Initialize(*myDirect3D->GetDevice(), *myDirect3D->GetBackBuffer(), CAPTURE_RING_SIZE, CAPTURE_BUFFER_COUNT,
+		aDirectory, aFormat, aLossless);
+	if (!result)
+	{
+		StopCapture();
+		return false;
+	}
+
+	// A continuous capture takes every frame from here on and shows how it keeps up above the statistics.
+	myCaptureContinuous = aContinuous;
+	if (myCaptureContinuous)
+	{
+		myCaptureText = myTextSystem->CreateText();
+		myTextSystem->SetPosition(myCaptureText, -2.7f, -1.45f);
+		myTextSystem->SetScale(myCaptureText, TEXT_SCALE);
+	}
+
+	return true;
 }
 
-GraphicsClass::GraphicsClass(const GraphicsClass& aGraphicsClass)
+void GraphicsClass::StopCapture()
 {
+	// Release the frame capture object once the frames still in the staging ring are read back.
+	if (myFrameCapture != nullptr)
+	{
+		myFrameCapture->Flush(*myDirect3D->GetDeviceContext());
+		myFrameCapture->Shutdown();
+		delete myFrameCapture;
+		myFrameCapture = nullptr;
+	}
+	if (myCaptureText >= 0)
+	{
+		myTextSystem->DestroyText(myCaptureText);
+		myCaptureText = -1;
+	}
+	myCaptureContinuous = false;
+	myScreenshotRequested = false;
 }
 
-GraphicsClass::~GraphicsClass()
+void GraphicsClass::FlushCapture()
 {
+	// Read back and write every frame captured so far, the capture goes on afterwards.
+	if (myFrameCapture != nullptr)
+	{
+		myFrameCapture->Flush(*myDirect3D->GetDeviceContext());
+	}
 }
 
-bool GraphicsClass::Initialize(int aScreenWidth, int aScreenHeight, HWND& aHWND)
+void GraphicsClass::RequestScreenshot()
 {
-	bool result;
+	// Screenshots share the capture of a video when one runs, otherwise they get one of their own that only takes single frames.
+	if (myFrameCapture == nullptr && !StartCapture("Screenshots", CaptureEncoder::FORMAT_PNG, false, false))
+	{
+		return;
+	}
+	myScreenshotRequested = true;
+}
 
-	// Create the Direct3D object.
-	myDirect3D = new D3DClass;
-	if (!myDirect3D)
+bool GraphicsClass::GetCaptureStats(FrameCapture::Stats& aStats)
+{
+	if (myFrameCapture == nullptr)
 	{
 		return false;
 	}
 
-	// Initialize the Direct3D object.
-	result = myDirect3D->Initialize(aScreenWidth, aScreenHeight, VSYNC_ENABLED, aHWND, FULL_SCREEN, SCREEN_DEPTH, SCREEN_NEAR);
-	if (!result)
+	// Pixels that are already read back may still be on their way to the disk.
+	myFrameCapture->GetStats(aStats);
+	return true;
+}
+
+void GraphicsClass::Invalidate()
+{
+	// Something outside the engine drew over the window, so the next frame has to draw all of it.
+	if (myDirtyRegion != nullptr)
 	{
-		MessageBox(aHWND, L"Could not initialize Direct3D", L"Error", MB_OK);
-		return false;
+		myDirtyRegion->Invalidate();
+	}
+}
+
+bool GraphicsClass::IsIdle()
+{
+	return myIdle;
+}
+
+float GraphicsClass::GetIdleTimeout()
+{
+	// Nothing changes on its own before the statistics are refreshed, so sleeping until then is safe. Cells that are still
+	// being read change the tilemap once they arrive, so there is no sleeping while any are pending.
+	if (!myIdle || (myWorldStreamer != nullptr && myWorldStreamer->GetPendingCellCount() > 0))
+	{
+		return 0.0f;
 	}
+	return myStatsTime < 1.0f ? 1.0f - myStatsTime : 0.0f;
+}
 
-	// Create the camera object.
-	myCamera = new Camera;
-	if (!myCamera)
+bool GraphicsClass::CreateSceneSprites()
+{
+	const SceneSprite* sprites;
+	const SceneEntity* entities;
+	const SceneVector* positions;
+	const SceneVector* sizes;
+	std::vector<int> clips;
+	int spriteCount, entityCount, positionCount, sizeCount, i, instance;
+
+	sprites = myScene->GetSprites(spriteCount);
+	entities = myScene->GetEntities(entityCount);
+	positions = myScene->GetPositions(positionCount);
+	sizes = myScene->GetSizes(sizeCount);
+	if (positionCount != entityCount || sizeCount != entityCount)
 	{
 		return false;
 	}
 
-	// Set the initial position of the camera.
-	myCamera->SetPosition(0.0f, 0.0f, -5.0f);
+	// Only as many entities as the sprite arrays hold are shown.
+	entityCount = entityCount > MAX_SPRITES ? MAX_SPRITES : entityCount;
 
-	// Create the model object.
-	myModel = new Model;
-	if (!myModel)
+	// Turn every sprite of the scene into a clip of the sheet.
+	for (i = 0; i < spriteCount; i++)
 	{
-		return false;
+		clips.push_back(mySpriteAnimation->AddGridClip(sprites[i].atlasColumns, sprites[i].atlasRows, sprites[i].firstCell, sprites[i].frameCount,
+			sprites[i].frameDuration, sprites[i].looping != 0));
+	}
+
+	// The transforms are stored the way the sprite arrays are, so they are copied over in one block each.
+	static_assert(sizeof(SceneVector) == sizeof(XMFLOAT2), "Scene vectors have to be laid out like the sprite arrays.");
+	if (entityCount > 0)
+	{
+		memcpy(mySpriteOrigins, positions, sizeof(XMFLOAT2) * entityCount);
+		memcpy(mySpritePositions, positions, sizeof(XMFLOAT2) * entityCount);
+		memcpy(mySpriteSizes, sizes, sizeof(XMFLOAT2) * entityCount);
+	}
+
+	// Start an animation for every entity, as far into its clip as the scene asks for.
+	for (i = 0; i < entityCount; i++)
+	{
+		if (entities[i].sprite < 0 || entities[i].sprite >= spriteCount || clips[entities[i].sprite] < 0)
+		{
+			return false;
+		}
+		instance = mySpriteAnimation->CreateInstance(clips[entities[i].sprite], entities[i].speed);
+		mySpriteAnimation->Skip(instance, entities[i].timeOffset);
 	}
 
-	// Initialize the model object.
-	result = myModel->Initialize(*myDirect3D->GetDevice(), *myDirect3D->GetDeviceContext(), "../../Bin/Sprites/testTexture.tga");
+	return true;
+}
+
+bool GraphicsClass::CreateSpriteTextures(int aTextureCount, int aSpriteCount)
+{
+	TextureArrayGroups groups;
+	TextureArrayGroups::Location locations[MAX_SPRITE_TEXTURES];
+	const TextureArrayGroups::Group* arrays;
+	ScratchArena scratch;
+	unsigned char* pixels;
+	int texture, size, i, x, y, cell, cellSize, arrayCount;
+	float centerX, centerY, radius;
+	bool result;
+
+	aTextureCount = aTextureCount > MAX_SPRITE_TEXTURES ? MAX_SPRITE_TEXTURES : aTextureCount;
+
+	// Sort the images into arrays by size, half of them at each of two sizes the way sprites of different detail would be.
+	result = groups.Initialize(MAX_TEXTURE_ARRAY_SLICES);
 	if (!result)
 	{
-		MessageBox(aHWND, L"Could not initialize the model object.", L"Error", MB_OK);
 		return false;
 	}
+	for (texture = 0; texture < aTextureCount; texture++)
+	{
+		size = texture % 2 == 0 ? 64 : 32;
+		groups.Add(size, size, DXGI_FORMAT_R8G8B8A8_UNORM, locations[texture]);
+	}
+	arrays = groups.GetGroups(arrayCount);
+	if (arrayCount > MAX_SPRITE_TEXTURE_ARRAYS)
+	{
+		return false;
+	}
+
+	// Create a texture array for every group.
+	for (i = 0; i < arrayCount; i++)
+	{
+		mySpriteTextureArrays[i] = new TextureArray;
+		if (!mySpriteTextureArrays[i])
+		{
+			return false;
+		}
+		result = mySpriteTextureArrays[i]->Initialize(*myDirect3D->GetDevice(), arrays[i].width, arrays[i].height, arrays[i].sliceCount);
+		if (!result)
+		{
+			return false;
+		}
+	}
+	mySpriteTextureArrayCount = arrayCount;
 
-	// Create the shader object.
-	myShader = new Shader;
-	if (!myShader)
+	// Draw every image as a 4x4 sheet of a disc in a color of its own that grows from cell to cell, so the animation of the
+	// sprites plays on them as it does on the model texture. The texels outside the disc are transparent.
+	pixels = scratch.AllocateArray<unsigned char>(64 * 64 * 4);
+	if (pixels == nullptr)
 	{
 		return false;
 	}
+	for (texture = 0; texture < aTextureCount; texture++)
+	{
+		size = arrays[locations[texture].group].width;
+		cellSize = size / 4;
+		for (y = 0; y < size; y++)
+		{
+			for (x = 0; x < size; x++)
+			{
+				cell = (y / cellSize) * 4 + x / cellSize;
+				centerX = (float)(x % cellSize) + 0.5f - (float)cellSize * 0.5f;
+				centerY = (float)(y % cellSize) + 0.5f - (float)cellSize * 0.5f;
+				radius = (float)cellSize * (0.2f + 0.018f * (float)cell);
+				pixels[(y * size + x) * 4 + 0] = (unsigned char)(texture * 67);
+				pixels[(y * size + x) * 4 + 1] = (unsigned char)(texture * 149 + 80);
+				pixels[(y * size + x) * 4 + 2] = (unsigned char)(255 - texture * 31);
+				pixels[(y * size + x) * 4 + 3] = centerX * centerX + centerY * centerY <= radius * radius ? 255 : 0;
+			}
+		}
+		mySpriteTextureArrays[locations[texture].group]->SetSlice(*myDirect3D->GetDeviceContext(), locations[texture].slice, pixels);
+	}
+	for (i = 0; i < arrayCount; i++)
+	{
+		mySpriteTextureArrays[i]->GenerateMips(*myDirect3D->GetDeviceContext());
+	}
 
-	// Initialize the shader object.
-	result = myShader->Initialize(*myDirect3D->GetDevice(), aHWND);
-	if (!result)
+	// Hand the images out to the sprites in turn.
+	for (i = 0; i < aSpriteCount; i++)
+	{
+		mySpriteTextures[i] = locations[i % aTextureCount];
+	}
+
+	// Create the sprite array batch object.
+	mySpriteArrayBatch = new SpriteArrayBatch;
+	if (!mySpriteArrayBatch)
 	{
-		MessageBox(aHWND, L"Could not initialize the shader object.", L"Error", MB_OK);
 		return false;
 	}
 
-	return true;
+	// Initialize the sprite array batch object, one array is drawn at a time.
+	return mySpriteArrayBatch->Initialize(*myUploadRing, *myQuadIndexBuffer, MAX_SPRITES);
 }
 
-void GraphicsClass::Shutdown()
+void GraphicsClass::UpdateScene(float aFrameTime)
 {
-	// Release the shader object.
-	if (myShader != nullptr)
+	Camera* camera;
+	XMFLOAT3 position;
+	char text[64];
+	float angle, radius;
+	int i;
+
+	myScenarioTime += aFrameTime;
+
+	// Circle the sprites around their places on the grid, each one a step ahead of the one before.
+	if (myScenario.spriteSpeed > 0.0f && mySpriteAnimation->GetInstanceCount() > 0)
 	{
-		myShader->Shutdown();
-		delete myShader;
-		myShader = nullptr;
+		radius = mySpriteSizes[0].x * 0.5f;
+		for (i = 0; i < mySpriteAnimation->GetInstanceCount(); i++)
+		{
+			angle = myScenarioTime * myScenario.spriteSpeed + (float)i;
+			mySpritePositions[i].x = mySpriteOrigins[i].x + cosf(angle) * radius;
+			mySpritePositions[i].y = mySpriteOrigins[i].y + sinf(angle) * radius;
+		}
+		mySpritesMoved = true;
 	}
-	// Release the model object.
-	if (myModel != nullptr)
+
+	// Drift the camera over the tilemap.
+	if (myScenario.scrollSpeedX != 0.0f || myScenario.scrollSpeedY != 0.0f)
 	{
-		myModel->Shutdown();
-		delete myModel;
-		myModel = nullptr;
+		camera = myRenderResources->GetCamera(myCamera);
+		if (camera != nullptr)
+		{
+			position = camera->GetPosition();
+			camera->SetPosition(position.x + myScenario.scrollSpeedX * aFrameTime, position.y + myScenario.scrollSpeedY * aFrameTime, position.z);
+		}
 	}
-	// Release the camera object.
-	if (myCamera != nullptr)
+
+	// Write new numbers into the text lines at their update rate.
+	if (myScenario.textCount > 0 && myScenario.textUpdateRate > 0.0f)
 	{
-		delete myCamera;
-		myCamera = nullptr;
+		myTextUpdateTime += aFrameTime;
+		if (myTextUpdateTime >= 1.0f / myScenario.textUpdateRate)
+		{
+			myTextUpdateTime = 0.0f;
+			for (i = 0; i < myScenario.textCount && i < MAX_SCENARIO_TEXTS; i++)
+			{
+				sprintf_s(text, sizeof(text), "Line %2d  time %8.3f  value %8d", i, myScenarioTime, (int)(myScenarioTime * 1000.0f) * (i + 1));
+				myTextSystem->SetText(myScenarioTexts[i], text);
+			}
+		}
 	}
-	// Release the Direct3D object.
-	if (myDirect3D != nullptr)
+}
+
+void GraphicsClass::UpdateTextureResidency()
+{
+	const TextureResidency::Change* changes;
+	TextureResidency::Stats stats;
+	Model* model;
+	int i, changeCount;
+
+	// The model texture is drawn every frame, by the model, the sprites, the particles and the tilemap.
+	myTextureResidency->BeginFrame();
+	myTextureResidency->Touch(myModelTexture);
+	myTextureResidency->Update();
+
+	// Recreate the textures that gave up or got back mips, and point their handles at the new views. A texture that is reduced
+	// looks blurrier at once, one that is raised sharpens as the upload queue brings the mips in.
+	changes = myTextureResidency->GetChanges(changeCount);
+	for (i = 0; i < changeCount; i++)
 	{
-		myDirect3D->Shutdown();
-		delete myDirect3D;
-		myDirect3D = nullptr;
+		model = myRenderResources->GetModel(myModel);
+		if (changes[i].texture != myModelTexture || model == nullptr ||
+			!model->SetTextureFirstMip(*myDirect3D->GetDevice(), *myDirect3D->GetDeviceContext(), changes[i].firstMip))
+		{
+			continue;
+		}
+		myRenderResources->SetTexture(myTexture, model->GetTexture());
+		myLayerCache->Invalidate(myBackgroundLayer);
+		myDirtyRegion->Invalidate();
 	}
-	return;
+
+	myTextureResidency->GetStats(stats);
+	myFrameStats.textureBudgetBytes = stats.budgetBytes;
+	myFrameStats.textureResidentBytes = stats.residentBytes;
+	myFrameStats.textureEvictCount = stats.frameEvictCount;
+	myFrameStats.textureReloadCount = stats.frameReloadCount;
+}
+
+void GraphicsClass::UpdateStreaming(float aFrameTime)
+{
+	Camera* camera;
+	XMFLOAT3 position;
+	WorldStreamer::Stats stats;
+	float velocityX, velocityY, fieldOfView, screenAspect, viewLeft, viewBottom, viewRight, viewTop;
+
+	if (myWorldStreamer == nullptr)
+	{
+		return;
+	}
+	camera = myRenderResources->GetCamera(myCamera);
+	if (camera == nullptr)
+	{
+		return;
+	}
+
+	// How far the camera moved since the last frame tells where the view is heading.
+	position = camera->GetPosition();
+	velocityX = aFrameTime > 0.0f ? (position.x - myLastCameraPosition.x) / aFrameTime : 0.0f;
+	velocityY = aFrameTime > 0.0f ? (position.y - myLastCameraPosition.y) / aFrameTime : 0.0f;
+	myLastCameraPosition = position;
+
+	// Stream the cells around the part of the tilemap the camera sees.
+	myDirect3D->GetProjectionParameters(fieldOfView, screenAspect);
+	camera->GetViewRect(fieldOfView, screenAspect, TILEMAP_DEPTH, viewLeft, viewBottom, viewRight, viewTop);
+	myWorldStreamer->Update(viewLeft, viewBottom, viewRight, viewTop, velocityX, velocityY, aFrameTime);
+
+	// Count what this frame read and showed late.
+	myWorldStreamer->GetStats(stats);
+	myFrameStats.pendingCellCount = stats.pendingCellCount;
+	myFrameStats.streamedBytes = (int)(stats.bytesRead - myStreamStats.bytesRead);
+	myFrameStats.popInCount = stats.popInCount - myStreamStats.popInCount;
+	myStreamStats = stats;
 }
 
+bool GraphicsClass::Render()
+{
+	XMMATRIX worldMatrix, viewMatrix, projectionMatrix, viewProjectionMatrix;
+	Camera* camera;
+	Shader* shader;
+	Model* model;
+	ID3D11ShaderResourceView* texture;
+	const DirtyRegion::Rect* dirtyRect;
+	AABB bounds, box;
+	int i;
+	float fieldOfView, screenAspect, viewLeft, viewBottom, viewRight, viewTop;
+	bool result, backgroundChanged, hudChanged;
+
+	// Resolve the handles the batched systems below draw with, once for the whole frame.
+	camera = myRenderResources->GetCamera(myCamera);
+	shader = myRenderResources->GetShader(myShader);
+	texture = myRenderResources->GetTexture(myTexture);
+	if (camera == nullptr || shader == nullptr || texture == nullptr)
+	{
+		return false;
+	}
+
+	// Generate the view matrix based on the camera's position.
+	camera->Render();
+
+	// Get the world, view, and projection matrices from the camera and d3d objects.
+	myDirect3D->GetWorldMatrix(worldMatrix);
+	camera->GetViewMatrix(viewMatrix);
+	myDirect3D->GetProjectionMatrix(projectionMatrix);
+
+	// Redraw the tilemap into its layer only when a tile or the camera changed since it was last drawn.
+	backgroundChanged = myLayerCache->NeedsRender(myBackgroundLayer, viewMatrix, myTilemap->GetRevision());
+	if (backgroundChanged)
+	{
+		// Draw the chunks of the tilemap that the camera can see, pushed back to its layer by the world matrix.
+		// Blending into the cleared layer leaves the colors multiplied by their alpha and the alpha holding the coverage of
+		// everything drawn, which is how the layer is composited.
+		myLayerCache->BeginRender(myBackgroundLayer);
+		worldMatrix = XMMatrixMultiply(worldMatrix, XMMatrixTranslation(0.0f, 0.0f, TILEMAP_DEPTH));
+		myDirect3D->GetProjectionParameters(fieldOfView, screenAspect);
+		camera->GetViewRect(fieldOfView, screenAspect, TILEMAP_DEPTH, viewLeft, viewBottom, viewRight, viewTop);
+		myDirect3D->TurnOnLayerBlending();
+		result = myTilemapRenderer->Render(*myDirect3D->GetDeviceContext(), *shader, worldMatrix, viewMatrix, projectionMatrix,
+			*texture, viewLeft, viewBottom, viewRight, viewTop);
+		myDirect3D->TurnOffAlphaBlending();
+		myLayerCache->EndRender();
+		if (!result)
+		{
+			return false;
+		}
+		myFrameStats.layerRedrawCount++;
+		myFrameStats.drawnChunkCount = myTilemapRenderer->GetDrawnChunkCount();
+		myFrameStats.builtChunkCount = myTilemapRenderer->GetBuiltChunkCount();
+		myFrameStats.pendingChunkCount = myTilemapRenderer->GetPendingChunkCount();
+		myFrameStats.drawCallCount += myFrameStats.drawnChunkCount;
+
+		// Chunks left over the build budget are built next frame, so the layer has to be drawn again.
+		if (myFrameStats.pendingChunkCount > 0)
+		{
+			myLayerCache->Invalidate(myBackgroundLayer);
+		}
+	}
+
+	// Fetch the matrices again and redraw the text into its layer only when a text or the camera changed.
+	myDirect3D->GetWorldMatrix(worldMatrix);
+	camera->GetViewMatrix(viewMatrix);
+	myDirect3D->GetProjectionMatrix(projectionMatrix);
+
+	hudChanged = myLayerCache->NeedsRender(myHudLayer, viewMatrix, myTextSystem->GetRevision());
+	if (hudChanged)
+	{
+		myLayerCache->BeginRender(myHudLayer);
+		myDirect3D->TurnOnLayerBlending();
+		result = myTextRenderer->Render(*myDirect3D->GetDeviceContext(), *myTextSystem, *shader, worldMatrix, viewMatrix, projectionMatrix);
+		myDirect3D->TurnOffAlphaBlending();
+		myLayerCache->EndRender();
+		if (!result)
+		{
+			return false;
+		}
+		myFrameStats.layerRedrawCount++;
+		myFrameStats.drawCallCount++;
+	}
+
+	// Work out which part of the screen differs from the last presented frame.
+	camera->GetViewMatrix(viewMatrix);
+	myDirect3D->GetProjectionMatrix(projectionMatrix);
+	viewProjectionMatrix = XMMatrixMultiply(viewMatrix, projectionMatrix);
+
+	// A new background, or the camera moving, changes every pixel.
+	if (backgroundChanged)
+	{
+		myDirtyRegion->Invalidate();
+	}
+
+	// Text that changed has to be cleared where it was and drawn where it is now.
+	if (hudChanged)
+	{
+		myDirtyRegion->Add(myLastTextRect);
+		myLastTextRect = EMPTY_RECT;
+		if (myTextSystem->GetBounds(bounds))
+		{
+			myLastTextRect = ProjectBounds(bounds, 0.0f, viewProjectionMatrix);
+		}
+		myDirtyRegion->Add(myLastTextRect);
+	}
+
+	// Sprites that show a new frame of their animation or moved have to be cleared where they were and drawn where they are now.
+	if ((mySpriteAnimation->GetChangedCount() > 0 || mySpritesMoved) && mySpriteAnimation->GetInstanceCount() > 0)
+	{
+		myDirtyRegion->Add(myLastSpriteRect);
+		ComputeBoxes(&mySpritePositions[0].x, 2, &mySpriteSizes[0].x, 2, 1, &bounds);
+		for (i = 1; i < mySpriteAnimation->GetInstanceCount(); i++)
+		{
+			ComputeBoxes(&mySpritePositions[i].x, 2, &mySpriteSizes[i].x, 2, 1, &box);
+			MergeBoxes(bounds, box);
+		}
+		myLastSpriteRect = ProjectBounds(bounds, 0.0f, viewProjectionMatrix);
+		myDirtyRegion->Add(myLastSpriteRect);
+	}
+
+	// Particles move every tick, so the area they covered last frame and the one they cover now are both redrawn.
+	myDirtyRegion->Add(myLastParticleRect);
+	myLastParticleRect = EMPTY_RECT;
+	if (myParticleSystem->GetBounds(bounds))
+	{
+		myLastParticleRect = ProjectBounds(bounds, PARTICLE_DEPTH, viewProjectionMatrix);
+	}
+	myDirtyRegion->Add(myLastParticleRect);
+
+	// Lights move every tick as well, and whatever they reached last frame and reach now is lit differently.
+	if (myLightGrid != nullptr)
+	{
+		result = UpdateLights(viewProjectionMatrix);
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	// Skip drawing and presenting altogether when nothing on the screen changed.
+	myIdle = myDirtyRegion->IsEmpty();
+	if (myIdle)
+	{
+		return true;
+	}
+	myRedrawCoverage = myDirtyRegion->GetCoverage();
+
+	if (myDirtyRegion->IsFull())
+	{
+		// Clear the buffers to begin the scene.
+		myDirect3D->BeginScene(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+	else
+	{
+		// Clears ignore the scissor rectangle, so the dirty part is drawn over instead: the background layer behind the scene
+		// is copied without blending, its transparent holes standing in for the black clear color. The depth buffer is never
+		// presented and is cleared whole.
+		dirtyRect = &myDirtyRegion->GetBounds();
+		myDirect3D->ClearDepthBuffer();
+		myDirect3D->TurnScissorOn(dirtyRect->left, dirtyRect->top, dirtyRect->right, dirtyRect->bottom);
+	}
+
+	// Count the pixels the scene shades against the ones it covers.
+	myOverdrawCounter->Begin(*myDirect3D->GetDeviceContext());
+
+	// Hand the lights and the normal map of the sprite sheet to the lit pixel shader.
+	model = myRenderResources->GetModel(myModel);
+	if (myLightRenderer != nullptr && model != nullptr && model->GetNormalMap() != nullptr)
+	{
+		myLightRenderer->Bind(*myDirect3D->GetDeviceContext(), *model->GetNormalMap());
+	}
+
+	// Queue the model, the queue resolves the handles itself and orders the draws by pass and depth.
+	myRenderQueue->Clear();
+	myRenderQueue->Submit(myShader, myTexture, myModel, myMaterial, GetSortDepth(viewMatrix, 0.0f));
+	myRenderQueue->Sort();
+
+	// The opaque pass writes depth without blending, nearest first, so the pixels hidden behind what is drawn are rejected
+	// before they are shaded. Particles are in front of the sprites and the model, and the background is behind everything.
+	// The sprites share the plane of the model and come after it, so where they overlap the model stays on top as it did when
+	// everything was blended in submission order.
+	myDirect3D->TurnZBufferOn();
+	myDirect3D->TurnOffAlphaBlending();
+	if (myMaterial != MATERIAL_TRANSLUCENT)
+	{
+		shader->SetAlphaTest(myMaterial == MATERIAL_ALPHA_TESTED);
+		result = RenderParticles(*shader, *texture, *camera);
+		shader->SetAlphaTest(false);
+		if (!result)
+		{
+			myDirect3D->TurnScissorOff();
+			return false;
+		}
+	}
+
+	// Fetch the matrices again since the shader transposed them.
+	myDirect3D->GetWorldMatrix(worldMatrix);
+	camera->GetViewMatrix(viewMatrix);
+	myDirect3D->GetProjectionMatrix(projectionMatrix);
+
+	shader->SetLit(myLightRenderer != nullptr);
+	result = myRenderQueue->Execute(*myDirect3D->GetDeviceContext(), *myRenderResources, worldMatrix, viewMatrix, projectionMatrix, false);
+	shader->SetLit(false);
+	if (result && myMaterial != MATERIAL_TRANSLUCENT)
+	{
+		shader->SetAlphaTest(myMaterial == MATERIAL_ALPHA_TESTED);
+		result = RenderSprites(*shader, *texture, *camera);
+		shader->SetAlphaTest(false);
+	}
+	if (!result)
+	{
+		myDirect3D->TurnScissorOff();
+		return false;
+	}
+
+	// Lay the tilemap behind the scene, only where nothing covers it.
+	result = myLayerCache->CompositeBehind(myBackgroundLayer, *shader);
+	if (!result)
+	{
+		myDirect3D->TurnScissorOff();
+		return false;
+	}
+	myFrameStats.drawCallCount++;
+
+	// The translucent pass blends and only tests depth, farthest first, so each draw blends over what is behind it
+	// without hiding what comes after it.
+	myDirect3D->TurnZBufferReadOnly();
+	myDirect3D->TurnOnAlphaBlending();
+	shader->SetLit(myLightRenderer != nullptr);
+	result = myRenderQueue->Execute(*myDirect3D->GetDeviceContext(), *myRenderResources, worldMatrix, viewMatrix, projectionMatrix, true);
+	shader->SetLit(false);
+	if (result && myMaterial == MATERIAL_TRANSLUCENT)
+	{
+		result = RenderSprites(*shader, *texture, *camera);
+		if (result)
+		{
+			result = RenderParticles(*shader, *texture, *camera);
+		}
+	}
+	myDirect3D->TurnOffAlphaBlending();
+	myDirect3D->TurnZBufferOn();
+	if (!result)
+	{
+		myDirect3D->TurnScissorOff();
+		return false;
+	}
+	myFrameStats.drawCallCount += myRenderQueue->GetCommandCount() - myRenderQueue->GetSkippedCount();
+
+	// The text layer is laid over every pixel whatever the scene drew, so it is left out of the count.
+	myOverdrawCounter->End(*myDirect3D->GetDeviceContext(), (long long)(myRedrawCoverage * (float)myScreenWidth * (float)myScreenHeight));
+
+	// Lay the text over the scene last.
+	result = myLayerCache->Composite(myHudLayer, *shader, true);
+	myDirect3D->TurnScissorOff();
+	if (!result)
+	{
+		return false;
+	}
+	myFrameStats.drawCallCount++;
+
+	// Present the rendered scene to the screen.
+	myDirect3D->EndScene();
+
+	// Everything that changed is on the screen now.
+	myDirtyRegion->Clear();
+	mySpriteAnimation->ClearChangedCount();
+	mySpritesMoved = false;
+	myStatsFrames++;
+	return true;
+}
 
-bool GraphicsClass::Frame()
+bool GraphicsClass::RenderSprites(Shader& aShader, ID3D11ShaderResourceView& aTexture, Camera& aCamera)
 {
+	XMMATRIX worldMatrix, viewMatrix, projectionMatrix;
 	bool result;
 
-	// Render the graphics scene.
-	result = Render();
+	// Sprites with images of their own are drawn from the texture arrays instead.
+	if (mySpriteArrayBatch != nullptr)
+	{
+		return RenderSpriteArrays(aShader, aCamera);
+	}
+
+	// Write the animated sprites into the batch using the rectangles the animation update produced.
+	result = mySpriteBatch->Begin(*myDirect3D->GetDeviceContext());
+	if (!result)
+	{
+		return false;
+	}
+	mySpriteBatch->Add(mySpritePositions, mySpriteSizes, mySpriteAnimation->GetUVRects(), mySpriteAnimation->GetInstanceCount());
+	mySpriteBatch->End(*myDirect3D->GetDeviceContext());
+
+	// The shader transposes the matrices it is given, so fetch them fresh for the draw.
+	myDirect3D->GetWorldMatrix(worldMatrix);
+	aCamera.GetViewMatrix(viewMatrix);
+	myDirect3D->GetProjectionMatrix(projectionMatrix);
+
+	// Draw the whole batch in one call with the model texture as the sprite sheet, lit by the lights of the scene when it has any.
+	mySpriteBatch->Render(*myDirect3D->GetDeviceContext());
+	aShader.SetLit(myLightRenderer != nullptr);
+	result = aShader.Render(*myDirect3D->GetDeviceContext(), mySpriteBatch->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix, aTexture);
+	aShader.SetLit(false);
 	if (!result)
 	{
 		return false;
 	}
+	myFrameStats.drawCallCount++;
+
 	return true;
 }
 
-bool GraphicsClass::Render()
+bool GraphicsClass::RenderSpriteArrays(Shader& aShader, Camera& aCamera)
 {
 	XMMATRIX worldMatrix, viewMatrix, projectionMatrix;
+	const SpriteAnimation::UVRect* uvs;
+	int array, i, spriteCount;
 	bool result;
 
-	// Clear the buffers to begin the scene.
-	myDirect3D->BeginScene(0.0f, 0.0f, 0.0f, 1.0f);
+	// The images are cut out, so they are alpha tested in whichever pass the sprites are drawn in.
+	uvs = mySpriteAnimation->GetUVRects();
+	spriteCount = mySpriteAnimation->GetInstanceCount();
+	aShader.SetTextureArray(true);
+	aShader.SetAlphaTest(true);
+	result = true;
+	for (array = 0; array < mySpriteTextureArrayCount && result; array++)
+	{
+		// Write the sprites whose images are in this array, each quad with the slice of its image.
+		result = mySpriteArrayBatch->Begin(*myDirect3D->GetDeviceContext());
+		if (!result)
+		{
+			break;
+		}
+		for (i = 0; i < spriteCount; i++)
+		{
+			if (mySpriteTextures[i].group == array)
+			{
+				mySpriteArrayBatch->Add(&mySpritePositions[i].x, &mySpriteSizes[i].x, uvs[i], mySpriteTextures[i].slice);
+			}
+		}
+		mySpriteArrayBatch->End(*myDirect3D->GetDeviceContext());
+		if (mySpriteArrayBatch->GetIndexCount() == 0)
+		{
+			continue;
+		}
 
-	// Generate the view matrix based on the camera's position.
-	myCamera->Render();
+		// The shader transposes the matrices it is given, so fetch them fresh for every draw.
+		myDirect3D->GetWorldMatrix(worldMatrix);
+		aCamera.GetViewMatrix(viewMatrix);
+		myDirect3D->GetProjectionMatrix(projectionMatrix);
 
-	// Get the world, view, and projection matrices from the camera and d3d objects.
+		// Draw every sprite of the array in one call, however many images they show.
+		mySpriteArrayBatch->Render(*myDirect3D->GetDeviceContext());
+		result = aShader.Render(*myDirect3D->GetDeviceContext(), mySpriteArrayBatch->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix,
+			*mySpriteTextureArrays[array]->GetTexture());
+		if (result)
+		{
+			myFrameStats.drawCallCount++;
+		}
+	}
+	aShader.SetAlphaTest(false);
+	aShader.SetTextureArray(false);
+
+	return result;
+}
+
+bool GraphicsClass::RenderParticles(Shader& aShader, ID3D11ShaderResourceView& aTexture, Camera& aCamera)
+{
+	XMMATRIX worldMatrix, viewMatrix, projectionMatrix;
+	SpriteVertex* particleVertices;
+	int particleCount;
+	bool result;
+
+	// Let the emitters write their particle quads straight into the mapped particle buffer.
+	result = myParticleBatch->Begin(*myDirect3D->GetDeviceContext());
+	if (!result)
+	{
+		return false;
+	}
+	particleCount = myParticleSystem->GetParticleCount();
+	particleVertices = myParticleBatch->Allocate(particleCount);
+	if (particleVertices != nullptr)
+	{
+		myParticleSystem->WriteQuads(particleVertices, particleCount);
+	}
+	myParticleBatch->End(*myDirect3D->GetDeviceContext());
+
+	// Fetch the matrices and draw all particles in one call, in their layer in front of the sprites.
 	myDirect3D->GetWorldMatrix(worldMatrix);
-	myCamera->GetViewMatrix(viewMatrix);
+	worldMatrix = XMMatrixMultiply(worldMatrix, XMMatrixTranslation(0.0f, 0.0f, PARTICLE_DEPTH));
+	aCamera.GetViewMatrix(viewMatrix);
 	myDirect3D->GetProjectionMatrix(projectionMatrix);
 
-	// Put the model vertex and index buffers on the graphics pipeline to prepare them for drawing.
-	myModel->Render(*myDirect3D->GetDeviceContext());
+	myParticleBatch->Render(*myDirect3D->GetDeviceContext());
+	result = aShader.Render(*myDirect3D->GetDeviceContext(), myParticleBatch->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix, aTexture);
+	if (!result)
+	{
+		return false;
+	}
+	myFrameStats.drawCallCount++;
+
+	return true;
+}
+
+bool GraphicsClass::UpdateLights(const XMMATRIX& aViewProjectionMatrix)
+{
+	PointLight light;
+	XMVECTOR center, edge;
+	LARGE_INTEGER start, end;
+	DirtyRegion::Rect rect;
+	float angle, x, y;
+	int i, tileLightCount;
+	bool result;
+
+	QueryPerformanceCounter(&start);
+
+	// Wander the lights around their places and project them onto the screen, in pixels from the top left corner.
+	myLightGrid->Clear();
+	for (i = 0; i < myLightCount; i++)
+	{
+		angle = myScenarioTime * 0.7f + (float)i;
+		x = myLightOrigins[i].x + cosf(angle) * 0.3f;
+		y = myLightOrigins[i].y + sinf(angle * 1.3f) * 0.3f;
+		center = XMVector3TransformCoord(XMVectorSet(x, y, 0.0f, 1.0f), aViewProjectionMatrix);
+		edge = XMVector3TransformCoord(XMVectorSet(x + myLightOrigins[i].z, y, 0.0f, 1.0f), aViewProjectionMatrix);
+		light.x = (XMVectorGetX(center) + 1.0f) * 0.5f * (float)myScreenWidth;
+		light.y = (1.0f - XMVectorGetY(center)) * 0.5f * (float)myScreenHeight;
+		light.radius = (XMVectorGetX(edge) - XMVectorGetX(center)) * 0.5f * (float)myScreenWidth;
+		light.red = myLightColors[i].x;
+		light.green = myLightColors[i].y;
+		light.blue = myLightColors[i].z;
+		myLightGrid->AddLight(light);
+	}
 
-	// Render the model using the shader.
-	result = myShader->Render(*myDirect3D->GetDeviceContext(), myModel->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix, *myModel->GetTexture());
+	// Bin them into the tiles of the screen and hand the lists to the lit pixel shader.
+	myLightGrid->Cull();
+	result = myLightRenderer->Update(*myDirect3D->GetDeviceContext(), *myLightGrid, LIGHT_HEIGHT, NIGHT_AMBIENT, NIGHT_AMBIENT, NIGHT_AMBIENT * 1.5f);
 	if (!result)
 	{
 		return false;
 	}
 
-	// Present the rendered scene to the screen.
-	myDirect3D->EndScene();
+	// Redraw where the lights shone last frame and where they shine now.
+	myDirtyRegion->Add(myLastLightRect);
+	myLastLightRect = EMPTY_RECT;
+	if (myLightGrid->GetBounds(rect.left, rect.top, rect.right, rect.bottom))
+	{
+		myLastLightRect = rect;
+	}
+	myDirtyRegion->Add(myLastLightRect);
+
+	QueryPerformanceCounter(&end);
+	myLightGrid->GetTileLights(tileLightCount);
+	myFrameStats.lightingTime = GetMilliseconds(start, end);
+	myFrameStats.lightCount = myLightCount;
+	myFrameStats.lightsPerTile = (float)tileLightCount / (float)(myLightGrid->GetTileCountX() * myLightGrid->GetTileCountY());
 	return true;
 }
+
+DirtyRegion::Rect GraphicsClass::ProjectBounds(const AABB& aBounds, float aDepth, const XMMATRIX& aViewProjectionMatrix)
+{
+	XMVECTOR corner;
+	DirtyRegion::Rect rect;
+	float x, y, minX, minY, maxX, maxY;
+	int i;
+
+	// Project the four corners of the box at its depth to normalized device coordinates and bound them.
+	minX = minY = 1.0f;
+	maxX = maxY = -1.0f;
+	for (i = 0; i < 4; i++)
+	{
+		corner = XMVectorSet((i & 1) ? aBounds.maxX : aBounds.minX, (i & 2) ? aBounds.maxY : aBounds.minY, aDepth, 1.0f);
+		corner = XMVector3TransformCoord(corner, aViewProjectionMatrix);
+		x = XMVectorGetX(corner);
+		y = XMVectorGetY(corner);
+
+		minX = x < minX ? x : minX;
+		maxX = x > maxX ? x : maxX;
+		minY = y < minY ? y : minY;
+		maxY = y > maxY ? y : maxY;
+	}
+
+	// Whatever is off the screen does not need redrawing.
+	minX = minX < -1.0f ? -1.0f : minX;
+	minY = minY < -1.0f ? -1.0f : minY;
+	maxX = maxX > 1.0f ? 1.0f : maxX;
+	maxY = maxY > 1.0f ? 1.0f : maxY;
+
+	// Convert to pixels from the top left corner, a pixel wider on every side for the texture filtering at the edges.
+	rect.left = (int)floorf((minX + 1.0f) * 0.5f * (float)myScreenWidth) - 1;
+	rect.right = (int)ceilf((maxX + 1.0f) * 0.5f * (float)myScreenWidth) + 1;
+	rect.top = (int)floorf((1.0f - maxY) * 0.5f * (float)myScreenHeight) - 1;
+	rect.bottom = (int)ceilf((1.0f - minY) * 0.5f * (float)myScreenHeight) + 1;
+	return rect;
+}
+
+float GraphicsClass::GetMilliseconds(const LARGE_INTEGER& aStart, const LARGE_INTEGER& aEnd)
+{
+	return (float)((double)(aEnd.QuadPart - aStart.QuadPart) * 1000.0 / (double)myTimerFrequency);
+}
\ No newline at end of file
@@ -4,28 +4,189 @@
 #include "Camera.h"
 #include "Model.h"
 #include "Shader.h"
+#include "QuadIndexBuffer.h"
+#include "UploadRing.h"
+#include "TextureUploadQueue.h"
+#include "TextureResidency.h"
+#include "RenderResources.h"
+#include "RenderQueue.h"
+#include "SpriteAnimation.h"
+#include "SpriteBatch.h"
+#include "SpriteArrayBatch.h"
+#include "TextureArray.h"
+#include "TextureArrayGroups.h"
+#include "JobSystem.h"
+#include "ParticleSystem.h"
+#include "Tilemap.h"
+#include "TilemapRenderer.h"
+#include "GdiGlyphSource.h"
+#include "GlyphCache.h"
+#include "TextSystem.h"
+#include "TextRenderer.h"
+#include "LayerCache.h"
+#include "DirtyRegion.h"
+#include "Collision.h"
+#include "Scenario.h"
+#include "FrameCapture.h"
+#include "SceneFile.h"
+#include "WorldStreamer.h"
+#include "OverdrawCounter.h"
+#include "LightGrid.h"
+#include "LightRenderer.h"
 
 const bool FULL_SCREEN = false;
 const bool VSYNC_ENABLED = true;
 const float SCREEN_DEPTH = 1000.0f;
 const float SCREEN_NEAR = 0.1f;
+const int MAX_RENDER_COMMANDS = 1024;
+const size_t UPLOAD_RING_SIZE = 16 * 1024 * 1024;
+const int TEXTURE_UPLOAD_BYTES_PER_FRAME = 1024 * 1024;
+const float TEXTURE_UPLOAD_MILLISECONDS = 1.0f;
+const int TEXTURE_UPLOAD_BLOCK_BYTES = 64 * 1024;
+const int TEXTURE_BUDGET_PERCENT = 50;
+const long long DEFAULT_TEXTURE_BUDGET = 256LL * 1024 * 1024;
+const int MIN_RESIDENT_TEXTURE_SIZE = 64;
+const int MAX_SPRITES = 4096;
+const int MODEL_OUTLINE_VERTICES = 8;
+const int SPRITE_GRID_MIN_COLUMNS = 8;
+const int MAX_SPRITE_TEXTURES = 1024;
+const int MAX_SPRITE_TEXTURE_ARRAYS = 16;
+const int MAX_TEXTURE_ARRAY_SLICES = 256;
+const float SPRITE_GRID_WIDTH = 8.0f;
+const float SPRITE_GRID_TOP = 2.0f;
+const int MAX_PARTICLES = 65536;
+const float PARTICLE_DEPTH = -0.5f;
+const int TILEMAP_SIZE = 4096;
+const float TILEMAP_TILE_SIZE = 0.25f;
+const float TILEMAP_DEPTH = 1.0f;
+const int MAX_RESIDENT_CHUNKS = 256;
+const int MAX_CHUNK_BUILDS_PER_FRAME = 16;
+const int STREAM_CELL_SIZE = 64;
+const float STREAM_LOOK_AHEAD_TIME = 1.0f;
+const int MAX_RESIDENT_CELLS = 256;
+const int MAX_CELL_LOADS = 8;
+const int FONT_PIXEL_HEIGHT = 32;
+const int GLYPH_ATLAS_SIZE = 512;
+const int GLYPH_CELL_SIZE = 48;
+const int MAX_GLYPHS = 1024;
+const float TEXT_SCALE = 0.006f;
+const int MAX_LAYERS = 4;
+const float SCENARIO_TEXT_SCALE = 0.004f;
+const float SCENARIO_TEXT_SPACING = 0.14f;
+const int MAX_LIGHTS = 1024;
+const int LIGHT_TILE_SIZE = 16;
+const int MAX_LIGHTS_PER_TILE = 32;
+const float LIGHT_HEIGHT = 24.0f;
+const float NIGHT_AMBIENT = 0.08f;
+const int CAPTURE_RING_SIZE = 3;
+const int CAPTURE_BUFFER_COUNT = 4;
 
 class GraphicsClass
 {
 public:
 	GraphicsClass();
-	GraphicsClass(const GraphicsClass& aGraphicsClass);
+	GraphicsClass(const GraphicsClass& aGraphicsClass) = delete;
 	~GraphicsClass();
 
-	bool Initialize(int aScreenWidth, int aScreenHeight, HWND& aHWND);
+	bool Initialize(int aScreenWidth, int aScreenHeight, HWND& aHWND, const Scenario& aScenario, bool aHeadless);
 	void Shutdown();
-	bool Frame();
+	bool Frame(float aFrameTime);
+
+	const FrameStats& GetFrameStats();
+
+	bool StartCapture(const char* aDirectory, CaptureEncoder::Format aFormat, bool aContinuous, bool aLossless);
+	void StopCapture();
+	void FlushCapture();
+	void RequestScreenshot();
+	bool GetCaptureStats(FrameCapture::Stats& aStats);
+
+	void Invalidate();
+	bool IsIdle();
+	float GetIdleTimeout();
 
 private:
+	bool CreateSceneSprites();
+	bool CreateSpriteTextures(int aTextureCount, int aSpriteCount);
+	void UpdateScene(float aFrameTime);
+	void UpdateTextureResidency();
+	void UpdateStreaming(float aFrameTime);
+	bool UpdateLights(const XMMATRIX& aViewProjectionMatrix);
 	bool Render();
+	bool RenderSprites(Shader& aShader, ID3D11ShaderResourceView& aTexture, Camera& aCamera);
+	bool RenderSpriteArrays(Shader& aShader, Camera& aCamera);
+	bool RenderParticles(Shader& aShader, ID3D11ShaderResourceView& aTexture, Camera& aCamera);
+	float GetMilliseconds(const LARGE_INTEGER& aStart, const LARGE_INTEGER& aEnd);
+	DirtyRegion::Rect ProjectBounds(const AABB& aBounds, float aDepth, const XMMATRIX& aViewProjectionMatrix);
 
 	D3DClass* myDirect3D;
-	Camera* myCamera;
-	Model* myModel;
-	Shader* myShader;
+	SceneFile* myScene;
+	QuadIndexBuffer* myQuadIndexBuffer;
+	UploadRing* myUploadRing;
+	TextureUploadQueue* myTextureUploadQueue;
+	TextureResidency* myTextureResidency;
+	int myModelTexture;
+	RenderResources* myRenderResources;
+	RenderQueue* myRenderQueue;
+	CameraHandle myCamera;
+	ModelHandle myModel;
+	ShaderHandle myShader;
+	TextureHandle myTexture;
+	MaterialType myMaterial;
+	SpriteAnimation* mySpriteAnimation;
+	SpriteBatch* mySpriteBatch;
+	XMFLOAT2 mySpriteOrigins[MAX_SPRITES];
+	XMFLOAT2 mySpritePositions[MAX_SPRITES];
+	XMFLOAT2 mySpriteSizes[MAX_SPRITES];
+	bool mySpritesMoved;
+	SpriteArrayBatch* mySpriteArrayBatch;
+	TextureArray* mySpriteTextureArrays[MAX_SPRITE_TEXTURE_ARRAYS];
+	int mySpriteTextureArrayCount;
+	TextureArrayGroups::Location mySpriteTextures[MAX_SPRITES];
+	JobSystem* myJobSystem;
+	ParticleSystem* myParticleSystem;
+	SpriteBatch* myParticleBatch;
+	Tilemap* myTilemap;
+	TilemapRenderer* myTilemapRenderer;
+	WorldStreamer* myWorldStreamer;
+	WorldStreamer::Stats myStreamStats;
+	XMFLOAT3 myLastCameraPosition;
+	int myStreamText;
+	GdiGlyphSource* myGlyphSource;
+	GlyphCache* myGlyphCache;
+	TextSystem* myTextSystem;
+	TextRenderer* myTextRenderer;
+	LayerCache* myLayerCache;
+	int myBackgroundLayer;
+	int myHudLayer;
+	DirtyRegion* myDirtyRegion;
+	DirtyRegion::Rect myLastTextRect;
+	DirtyRegion::Rect myLastSpriteRect;
+	DirtyRegion::Rect myLastParticleRect;
+	int myScreenWidth;
+	int myScreenHeight;
+	float myRedrawCoverage;
+	bool myIdle;
+	int myStatsText;
+	float myStatsTime;
+	int myStatsFrames;
+	int myLastFrameAllocations;
+	OverdrawCounter* myOverdrawCounter;
+	long long myShadedPixelCount;
+	long long myCoveredPixelCount;
+	LightGrid* myLightGrid;
+	LightRenderer* myLightRenderer;
+	XMFLOAT3 myLightOrigins[MAX_LIGHTS];
+	XMFLOAT3 myLightColors[MAX_LIGHTS];
+	int myLightCount;
+	DirtyRegion::Rect myLastLightRect;
+	Scenario myScenario;
+	float myScenarioTime;
+	float myTextUpdateTime;
+	int myScenarioTexts[MAX_SCENARIO_TEXTS];
+	FrameStats myFrameStats;
+	FrameCapture* myFrameCapture;
+	bool myCaptureContinuous;
+	bool myScreenshotRequested;
+	int myCaptureText;
+	long long myTimerFrequency;
 };
@@ -0,0 +1,40 @@
+#pragma once
+
+// Bits of a handle that hold the slot index, the rest hold the generation of the slot.
+const unsigned int HANDLE_INDEX_BITS = 20;
+const unsigned int HANDLE_INDEX_MASK = (1u << HANDLE_INDEX_BITS) - 1;
+const unsigned int HANDLE_GENERATION_MASK = (1u << (32 - HANDLE_INDEX_BITS)) - 1;
+
+// A 32 bit reference to an entry of a handle table. A handle whose entry has been removed no longer matches the
+// generation of its slot, so looking it up fails instead of reaching whatever took the slot over.
+// Zero is never handed out and works as the null handle. Plain data, copying and comparing handles is free.
+template<typename T>
+struct Handle
+{
+	unsigned int value;
+
+	unsigned int GetIndex() const
+	{
+		return value & HANDLE_INDEX_MASK;
+	}
+
+	unsigned int GetGeneration() const
+	{
+		return value >> HANDLE_INDEX_BITS;
+	}
+
+	bool IsNull() const
+	{
+		return value == 0;
+	}
+
+	bool operator==(const Handle& aHandle) const
+	{
+		return value == aHandle.value;
+	}
+
+	bool operator!=(const Handle& aHandle) const
+	{
+		return value != aHandle.value;
+	}
+};
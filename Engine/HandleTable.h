@@ -0,0 +1,196 @@
+#pragma once
+
+#include "Handle.h"
+
+// Fixed size table of values addressed by generational handles.
+// Values live in one array next to the generation of their slot, so a lookup is a single indexed load plus a compare.
+// Removed slots are reused most recently freed first, and their generation is bumped so old handles go stale.
+template<typename T>
+class HandleTable
+{
+public:
+	HandleTable()
+	{
+		mySlots = nullptr;
+		myCapacity = 0;
+		myFirstFree = -1;
+		myCount = 0;
+		myStaleLookupCount = 0;
+	}
+
+	HandleTable(const HandleTable& aHandleTable) = delete;
+
+	~HandleTable()
+	{
+	}
+
+	bool Initialize(int aCapacity)
+	{
+		int i;
+
+		if (aCapacity <= 0 || aCapacity > (int)HANDLE_INDEX_MASK + 1)
+		{
+			return false;
+		}
+		myCapacity = aCapacity;
+
+		// Create the slots, every one free and chained to the next.
+		mySlots = new Slot[myCapacity];
+		if (!mySlots)
+		{
+			return false;
+		}
+		for (i = 0; i < myCapacity; i++)
+		{
+			mySlots[i].value = T();
+			mySlots[i].generation = 1;
+			mySlots[i].nextFree = i + 1 < myCapacity ? i + 1 : -1;
+		}
+		myFirstFree = 0;
+		myCount = 0;
+		myStaleLookupCount = 0;
+
+		return true;
+	}
+
+	void Shutdown()
+	{
+		// Release the slots.
+		delete[] mySlots;
+		mySlots = nullptr;
+
+		myCapacity = 0;
+		myFirstFree = -1;
+		myCount = 0;
+	}
+
+	Handle<T> Add(const T& aValue)
+	{
+		Handle<T> handle;
+		int index;
+
+		// A full table hands out the null handle.
+		handle.value = 0;
+		if (myFirstFree < 0)
+		{
+			return handle;
+		}
+
+		// Take the first free slot.
+		index = myFirstFree;
+		myFirstFree = mySlots[index].nextFree;
+		mySlots[index].value = aValue;
+		mySlots[index].nextFree = -2;
+		myCount++;
+
+		handle.value = (mySlots[index].generation << HANDLE_INDEX_BITS) | (unsigned int)index;
+		return handle;
+	}
+
+	bool Remove(Handle<T> aHandle)
+	{
+		Slot* slot;
+		int index;
+
+		slot = Find(aHandle);
+		if (slot == nullptr)
+		{
+			return false;
+		}
+		index = (int)aHandle.GetIndex();
+
+		// Bump the generation so handles to the removed value go stale, skipping zero to keep null handles impossible.
+		slot->value = T();
+		slot->generation = (slot->generation + 1) & HANDLE_GENERATION_MASK;
+		if (slot->generation == 0)
+		{
+			slot->generation = 1;
+		}
+
+		// Put the slot at the front of the free list.
+		slot->nextFree = myFirstFree;
+		myFirstFree = index;
+		myCount--;
+
+		return true;
+	}
+
+	T* Get(Handle<T> aHandle)
+	{
+		Slot* slot;
+
+		slot = Find(aHandle);
+		if (slot == nullptr)
+		{
+			myStaleLookupCount++;
+			return nullptr;
+		}
+		return &slot->value;
+	}
+
+	Handle<T> GetHandle(int aIndex)
+	{
+		Handle<T> handle;
+
+		// Free slots have no handle, which lets a caller walk the live values without knowing their generations.
+		handle.value = 0;
+		if (aIndex >= 0 && aIndex < myCapacity && mySlots[aIndex].nextFree == -2)
+		{
+			handle.value = (mySlots[aIndex].generation << HANDLE_INDEX_BITS) | (unsigned int)aIndex;
+		}
+		return handle;
+	}
+
+	bool IsValid(Handle<T> aHandle)
+	{
+		return Find(aHandle) != nullptr;
+	}
+
+	int GetCount()
+	{
+		return myCount;
+	}
+
+	int GetCapacity()
+	{
+		return myCapacity;
+	}
+
+	int GetStaleLookupCount()
+	{
+		return myStaleLookupCount;
+	}
+
+private:
+	struct Slot
+	{
+		T value;
+		unsigned int generation;
+		int nextFree;
+	};
+
+	Slot* Find(Handle<T> aHandle)
+	{
+		Slot* slot;
+		unsigned int index;
+
+		// The slot has to exist, hold a value and still be of the handle's generation.
+		index = aHandle.GetIndex();
+		if (index >= (unsigned int)myCapacity)
+		{
+			return nullptr;
+		}
+		slot = &mySlots[index];
+		if (slot->generation != aHandle.GetGeneration() || slot->nextFree != -2)
+		{
+			return nullptr;
+		}
+		return slot;
+	}
+
+	Slot* mySlots;
+	int myCapacity;
+	int myFirstFree;
+	int myCount;
+	int myStaleLookupCount;
+};
@@ -0,0 +1,191 @@
+#include "ImageWriter.h"
+#include "Targa.h"
+#include <string.h>
+
+// Longest stored deflate block, its length field is 16 bits.
+static const int MAX_STORED_BLOCK = 65535;
+
+// Bytes the Adler-32 sums can take in before they have to be reduced, so 32 bit sums never overflow.
+static const int ADLER_BLOCK = 5552;
+
+static void WriteBigEndian(unsigned char* aDestination, unsigned int aValue)
+{
+	aDestination[0] = (unsigned char)(aValue >> 24);
+	aDestination[1] = (unsigned char)(aValue >> 16);
+	aDestination[2] = (unsigned char)(aValue >> 8);
+	aDestination[3] = (unsigned char)aValue;
+}
+
+// Table of the PNG polynomial, built the first time a chunk is written.
+struct CrcTable
+{
+	CrcTable()
+	{
+		unsigned int value;
+		int i, bit;
+
+		for (i = 0; i < 256; i++)
+		{
+			value = (unsigned int)i;
+			for (bit = 0; bit < 8; bit++)
+			{
+				value = (value & 1) ? 0xedb88320u ^ (value >> 1) : value >> 1;
+			}
+			values[i] = value;
+		}
+	}
+
+	unsigned int values[256];
+};
+
+static unsigned int Crc(const unsigned char* aData, size_t aSize)
+{
+	static const CrcTable table;
+	unsigned int crc;
+	size_t i;
+
+	crc = 0xffffffffu;
+	for (i = 0; i < aSize; i++)
+	{
+		crc = table.values[(crc ^ aData[i]) & 0xff] ^ (crc >> 8);
+	}
+	return crc ^ 0xffffffffu;
+}
+
+static void Adler32(const unsigned char* aData, size_t aSize, unsigned int& aLow, unsigned int& aHigh)
+{
+	size_t i, count;
+
+	// Only reduce the sums once per block of bytes instead of after every one.
+	while (aSize > 0)
+	{
+		count = aSize < (size_t)ADLER_BLOCK ? aSize : (size_t)ADLER_BLOCK;
+		for (i = 0; i < count; i++)
+		{
+			aLow += aData[i];
+			aHigh += aLow;
+		}
+		aLow %= 65521u;
+		aHigh %= 65521u;
+		aData += count;
+		aSize -= count;
+	}
+}
+
+static unsigned char* BeginChunk(unsigned char* aDestination, const char* aType, unsigned int aSize)
+{
+	WriteBigEndian(aDestination, aSize);
+	memcpy(aDestination + 4, aType, 4);
+	return aDestination + 8;
+}
+
+static unsigned char* EndChunk(unsigned char* aChunk, unsigned char* aEnd)
+{
+	// The checksum covers the type and the data, not the length in front of them.
+	WriteBigEndian(aEnd, Crc(aChunk + 4, aEnd - (aChunk + 4)));
+	return aEnd + 4;
+}
+
+void EncodePng(const unsigned char* aPixels, int aWidth, int aHeight, std::vector<unsigned char>& aFile)
+{
+	static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+	unsigned char* out;
+	unsigned char* chunk;
+	size_t rowSize, rawSize, blockCount, dataSize, blockSize, rowOffset, count;
+	unsigned int adlerLow, adlerHigh;
+	int y;
+
+	// Every row starts with its filter type, always none here, followed by the pixels.
+	rowSize = (size_t)aWidth * 4 + 1;
+	rawSize = rowSize * aHeight;
+	blockCount = (rawSize + MAX_STORED_BLOCK - 1) / MAX_STORED_BLOCK;
+	dataSize = 2 + rawSize + blockCount * 5 + 4;
+
+	// Size the file up front, a buffer that is reused for every frame only grows once.
+	aFile.resize(sizeof(signature) + (12 + 13) + (12 + dataSize) + 12);
+	out = &aFile[0];
+	memcpy(out, signature, sizeof(signature));
+	out += sizeof(signature);
+
+	// 8 bit RGBA, not interlaced.
+	chunk = out;
+	out = BeginChunk(out, "IHDR", 13);
+	WriteBigEndian(out, (unsigned int)aWidth);
+	WriteBigEndian(out + 4, (unsigned int)aHeight);
+	out[8] = 8;
+	out[9] = 6;
+	out[10] = 0;
+	out[11] = 0;
+	out[12] = 0;
+	out = EndChunk(chunk, out + 13);
+
+	// A zlib stream of stored blocks, which may end and start in the middle of a row.
+	chunk = out;
+	out = BeginChunk(out, "IDAT", (unsigned int)dataSize);
+	*out++ = 0x78;
+	*out++ = 0x01;
+	adlerLow = 1;
+	adlerHigh = 0;
+	y = 0;
+	rowOffset = 0;
+	while (rawSize > 0)
+	{
+		blockSize = rawSize < (size_t)MAX_STORED_BLOCK ? rawSize : (size_t)MAX_STORED_BLOCK;
+		rawSize -= blockSize;
+
+		out[0] = rawSize == 0 ? 1 : 0;
+		out[1] = (unsigned char)blockSize;
+		out[2] = (unsigned char)(blockSize >> 8);
+		out[3] = (unsigned char)~blockSize;
+		out[4] = (unsigned char)(~blockSize >> 8);
+		out += 5;
+
+		while (blockSize > 0)
+		{
+			if (rowOffset == 0)
+			{
+				*out = 0;
+				count = 1;
+			}
+			else
+			{
+				count = rowSize - rowOffset < blockSize ? rowSize - rowOffset : blockSize;
+				memcpy(out, aPixels + (size_t)y * aWidth * 4 + rowOffset - 1, count);
+			}
+			Adler32(out, count, adlerLow, adlerHigh);
+			out += count;
+			blockSize -= count;
+			rowOffset += count;
+			if (rowOffset == rowSize)
+			{
+				rowOffset = 0;
+				y++;
+			}
+		}
+	}
+	WriteBigEndian(out, (adlerHigh << 16) | adlerLow);
+	out = EndChunk(chunk, out + 4);
+
+	chunk = out;
+	out = BeginChunk(out, "IEND", 0);
+	EndChunk(chunk, out);
+}
+
+void EncodeTarga(const unsigned char* aPixels, int aWidth, int aHeight, std::vector<unsigned char>& aFile)
+{
+	TargaHeader header;
+
+	// An uncompressed 32 bit image with 8 bits of alpha, laid out the way the texture loader reads it.
+	memset(&header, 0, sizeof(header));
+	header.data1[2] = 2;
+	header.width = (unsigned short)aWidth;
+	header.height = (unsigned short)aHeight;
+	header.bpp = 32;
+	header.data2 = 8;
+
+	aFile.resize(sizeof(header) + (size_t)aWidth * aHeight * 4);
+	memcpy(&aFile[0], &header, sizeof(header));
+
+	// Flipping the rows and swapping red and blue turns top down RGBA into targa rows, just as it does the other way.
+	ConvertTargaPixels(aPixels, aWidth, aHeight, &aFile[sizeof(header)]);
+}
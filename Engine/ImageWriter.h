@@ -0,0 +1,9 @@
+#pragma once
+
+#include <vector>
+
+// Encoding of top down RGBA rows into image files, used to write captured frames.
+// PNG output is stored without compression: it is read by every tool but costs no time to deflate, so an encoder
+// thread keeps up with the frame rate. Targa output is the raw pixels behind a header, the format textures are read from.
+void EncodePng(const unsigned char* aPixels, int aWidth, int aHeight, std::vector<unsigned char>& aFile);
+void EncodeTarga(const unsigned char* aPixels, int aWidth, int aHeight, std::vector<unsigned char>& aFile);
@@ -4,10 +4,6 @@ InputClass::InputClass()
 {
 }
 
-InputClass::InputClass(const InputClass& aInputClass)
-{
-}
-
 InputClass::~InputClass()
 {
 }
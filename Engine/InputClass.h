@@ -4,7 +4,7 @@ class InputClass
 {
 public:
 	InputClass();
-	InputClass(const InputClass& aInputClass);
+	InputClass(const InputClass& aInputClass) = delete;
 	~InputClass();
 
 	void Initialize();
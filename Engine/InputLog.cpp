@@ -0,0 +1,210 @@
+#include "InputLog.h"
+#include <string.h>
+
+// Most events one frame record can hold, the count is stored in 16 bits.
+static const size_t MAX_FRAME_EVENTS = 65535;
+
+// Size of a frame record without its events.
+static const size_t FRAME_RECORD_SIZE = sizeof(float) + sizeof(unsigned short);
+
+static FILE* OpenFile(const char* aPath, const char* aMode)
+{
+	FILE* file;
+
+#if defined(_WIN32)
+	if (fopen_s(&file, aPath, aMode) != 0)
+	{
+		file = nullptr;
+	}
+#else
+	file = fopen(aPath, aMode);
+#endif
+	return file;
+}
+
+InputLog::InputLog()
+{
+	myFile = nullptr;
+	myReadOffset = 0;
+	myFrameCount = 0;
+	myRecording = false;
+	myPlaying = false;
+}
+
+InputLog::~InputLog()
+{
+}
+
+bool InputLog::InitializeRecording(const char* aPath)
+{
+	Header header;
+
+	myFile = OpenFile(aPath, "wb");
+	if (myFile == nullptr)
+	{
+		return false;
+	}
+
+	// Write the header, the frames follow as they are recorded.
+	header.magic = INPUT_LOG_MAGIC;
+	header.version = INPUT_LOG_VERSION;
+	if (fwrite(&header, sizeof(header), 1, myFile) != 1)
+	{
+		fclose(myFile);
+		myFile = nullptr;
+		return false;
+	}
+
+	// Reserve room for a burst of input so recording does not allocate while frames run.
+	myPendingEvents.reserve(256);
+	myFrameCount = 0;
+	myRecording = true;
+	return true;
+}
+
+bool InputLog::InitializePlayback(const char* aPath)
+{
+	FILE* file;
+	Header header;
+	long fileSize;
+	size_t offset;
+	unsigned short eventCount;
+	bool result;
+
+	file = OpenFile(aPath, "rb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	// Read the whole log up front, so playing it back never waits on the disk in the middle of a measured frame.
+	result = fseek(file, 0, SEEK_END) == 0;
+	fileSize = result ? ftell(file) : -1;
+	result = fileSize >= (long)sizeof(header) && fseek(file, 0, SEEK_SET) == 0;
+	if (result)
+	{
+		myData.resize((size_t)fileSize);
+		result = fread(&myData[0], 1, myData.size(), file) == myData.size();
+	}
+	fclose(file);
+	if (!result)
+	{
+		myData.clear();
+		return false;
+	}
+
+	memcpy(&header, &myData[0], sizeof(header));
+	if (header.magic != INPUT_LOG_MAGIC || header.version != INPUT_LOG_VERSION)
+	{
+		myData.clear();
+		return false;
+	}
+
+	// Walk the records once to count the frames. A record cut short by a crash ends the log.
+	myFrameCount = 0;
+	offset = sizeof(header);
+	while (offset + FRAME_RECORD_SIZE <= myData.size())
+	{
+		memcpy(&eventCount, &myData[offset + sizeof(float)], sizeof(eventCount));
+		if (offset + FRAME_RECORD_SIZE + eventCount * sizeof(Event) > myData.size())
+		{
+			break;
+		}
+		offset += FRAME_RECORD_SIZE + eventCount * sizeof(Event);
+		myFrameCount++;
+	}
+	myData.resize(offset);
+
+	myReadOffset = sizeof(header);
+	myPlaying = true;
+	return true;
+}
+
+void InputLog::Shutdown()
+{
+	// Close the recording, everything written so far is a complete log.
+	if (myFile != nullptr)
+	{
+		fclose(myFile);
+		myFile = nullptr;
+	}
+	myPendingEvents.clear();
+	myData.clear();
+	myReadOffset = 0;
+	myFrameCount = 0;
+	myRecording = false;
+	myPlaying = false;
+}
+
+void InputLog::RecordEvent(EventType aType, unsigned int aKey)
+{
+	Event event;
+
+	if (!myRecording || aKey > 255 || myPendingEvents.size() == MAX_FRAME_EVENTS)
+	{
+		return;
+	}
+
+	// Hold the event until the frame it is applied to is recorded.
+	event.type = (unsigned char)aType;
+	event.key = (unsigned char)aKey;
+	myPendingEvents.push_back(event);
+}
+
+bool InputLog::RecordFrame(float aFrameTime)
+{
+	unsigned short eventCount;
+	bool result;
+
+	if (!myRecording)
+	{
+		return false;
+	}
+
+	// Write the frame time and the events that came in before the frame.
+	eventCount = (unsigned short)myPendingEvents.size();
+	result = fwrite(&aFrameTime, sizeof(aFrameTime), 1, myFile) == 1;
+	result = result && fwrite(&eventCount, sizeof(eventCount), 1, myFile) == 1;
+	if (result && eventCount > 0)
+	{
+		result = fwrite(&myPendingEvents[0], sizeof(Event), eventCount, myFile) == eventCount;
+	}
+	myPendingEvents.clear();
+	myFrameCount++;
+
+	return result;
+}
+
+bool InputLog::ReadFrame(float& aFrameTime, const Event*& aEvents, int& aEventCount)
+{
+	unsigned short eventCount;
+
+	if (!myPlaying || myReadOffset + FRAME_RECORD_SIZE > myData.size())
+	{
+		return false;
+	}
+
+	// Events are two bytes without padding, so they are handed out straight from the log.
+	memcpy(&aFrameTime, &myData[myReadOffset], sizeof(aFrameTime));
+	memcpy(&eventCount, &myData[myReadOffset + sizeof(float)], sizeof(eventCount));
+	aEvents = eventCount > 0 ? (const Event*)&myData[myReadOffset + FRAME_RECORD_SIZE] : nullptr;
+	aEventCount = eventCount;
+	myReadOffset += FRAME_RECORD_SIZE + eventCount * sizeof(Event);
+
+	return true;
+}
+
+int InputLog::GetFrameCount()
+{
+	return myFrameCount;
+}
+
+bool InputLog::IsRecording()
+{
+	return myRecording;
+}
+
+bool InputLog::IsPlaying()
+{
+	return myPlaying;
+}
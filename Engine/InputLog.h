@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdio.h>
+#include <vector>
+
+// Identifies an input log file and the layout of its records.
+const unsigned int INPUT_LOG_MAGIC = 0x4C504E49;
+const unsigned int INPUT_LOG_VERSION = 1;
+
+// Records the input of a session together with the time step of every frame, and plays it back.
+// The log is a header followed by one record per frame: the frame time as a float, the number of events as a 16 bit
+// count and two bytes per event. A frame without input takes six bytes, so an hour at 60 frames per second stays
+// around a megabyte. Events are applied before the frame they were recorded with, which makes a replay feed the
+// engine exactly what the session saw, frame for frame.
+class InputLog
+{
+public:
+	enum EventType
+	{
+		KEY_DOWN = 0,
+		KEY_UP = 1
+	};
+
+	struct Event
+	{
+		unsigned char type;
+		unsigned char key;
+	};
+
+	InputLog();
+	InputLog(const InputLog& aInputLog) = delete;
+	~InputLog();
+
+	bool InitializeRecording(const char* aPath);
+	bool InitializePlayback(const char* aPath);
+	void Shutdown();
+
+	void RecordEvent(EventType aType, unsigned int aKey);
+	bool RecordFrame(float aFrameTime);
+
+	bool ReadFrame(float& aFrameTime, const Event*& aEvents, int& aEventCount);
+	int GetFrameCount();
+
+	bool IsRecording();
+	bool IsPlaying();
+
+private:
+	struct Header
+	{
+		unsigned int magic;
+		unsigned int version;
+	};
+
+	FILE* myFile;
+	std::vector<Event> myPendingEvents;
+	std::vector<unsigned char> myData;
+	size_t myReadOffset;
+	int myFrameCount;
+	bool myRecording;
+	bool myPlaying;
+};
@@ -0,0 +1,155 @@
+#include "JobSystem.h"
+
+JobSystem::JobSystem()
+{
+	myJob = nullptr;
+	myCount = 0;
+	myNextItem = 0;
+	myDoneItems = 0;
+	myGeneration = 0;
+	myBusyWorkers = 0;
+	myQuit = false;
+}
+
+JobSystem::~JobSystem()
+{
+}
+
+bool JobSystem::Initialize(int aThreadCount)
+{
+	int i;
+
+	// Use one thread per core by default, the calling thread counts as one of them.
+	if (aThreadCount <= 0)
+	{
+		aThreadCount = (int)std::thread::hardware_concurrency();
+		if (aThreadCount <= 0)
+		{
+			aThreadCount = 1;
+		}
+	}
+
+	myQuit = false;
+
+	// Start the workers.
+	for (i = 1; i < aThreadCount; i++)
+	{
+		myWorkers.push_back(std::thread(&JobSystem::WorkerLoop, this));
+	}
+
+	return true;
+}
+
+void JobSystem::Shutdown()
+{
+	unsigned int i;
+
+	// Wake every worker and tell it to leave.
+	{
+		std::lock_guard<std::mutex> lock(myMutex);
+		myQuit = true;
+	}
+	myWakeCondition.notify_all();
+
+	// Wait for the workers to finish.
+	for (i = 0; i < myWorkers.size(); i++)
+	{
+		myWorkers[i].join();
+	}
+	myWorkers.clear();
+}
+
+void JobSystem::ParallelFor(int aCount, const std::function<void(int)>& aJob)
+{
+	int i;
+
+	if (aCount <= 0)
+	{
+		return;
+	}
+
+	// Without workers, or with a single item, there is nothing to split.
+	if (myWorkers.empty() || aCount == 1)
+	{
+		for (i = 0; i < aCount; i++)
+		{
+			aJob(i);
+		}
+		return;
+	}
+
+	// Publish the loop and wake the workers.
+	{
+		std::lock_guard<std::mutex> lock(myMutex);
+		myJob = &aJob;
+		myCount = aCount;
+		myNextItem = 0;
+		myDoneItems = 0;
+		myGeneration++;
+	}
+	myWakeCondition.notify_all();
+
+	// Work on the loop from this thread as well.
+	RunItems();
+
+	// Wait until every item is done and no worker still holds on to the loop.
+	{
+		std::unique_lock<std::mutex> lock(myMutex);
+		myDoneCondition.wait(lock, [this] { return myDoneItems == myCount && myBusyWorkers == 0; });
+		myJob = nullptr;
+		myCount = 0;
+	}
+}
+
+int JobSystem::GetThreadCount()
+{
+	return (int)myWorkers.size() + 1;
+}
+
+void JobSystem::WorkerLoop()
+{
+	unsigned int seenGeneration;
+
+	seenGeneration = 0;
+	for (;;)
+	{
+		// Sleep until there is a new loop to work on.
+		{
+			std::unique_lock<std::mutex> lock(myMutex);
+			myWakeCondition.wait(lock, [this, seenGeneration] { return myQuit || (myJob != nullptr && myGeneration != seenGeneration); });
+			if (myQuit)
+			{
+				return;
+			}
+			seenGeneration = myGeneration;
+			myBusyWorkers++;
+		}
+
+		RunItems();
+
+		// Let the calling thread know this worker is done with the loop.
+		{
+			std::lock_guard<std::mutex> lock(myMutex);
+			myBusyWorkers--;
+		}
+		myDoneCondition.notify_all();
+	}
+}
+
+void JobSystem::RunItems()
+{
+	int item;
+
+	// Grab items one at a time until the loop is exhausted.
+	for (;;)
+	{
+		item = myNextItem.fetch_add(1);
+		if (item >= myCount)
+		{
+			return;
+		}
+
+		(*myJob)(item);
+		myDoneItems.fetch_add(1);
+	}
+}
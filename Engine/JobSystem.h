@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small pool of worker threads that splits loops over independent items between the cores.
+// The calling thread works on the loop too and ParallelFor returns once every item is done.
+class JobSystem
+{
+public:
+	JobSystem();
+	JobSystem(const JobSystem& aJobSystem) = delete;
+	~JobSystem();
+
+	bool Initialize(int aThreadCount);
+	void Shutdown();
+
+	void ParallelFor(int aCount, const std::function<void(int)>& aJob);
+
+	int GetThreadCount();
+
+private:
+	void WorkerLoop();
+	void RunItems();
+
+	std::vector<std::thread> myWorkers;
+	std::mutex myMutex;
+	std::condition_variable myWakeCondition;
+	std::condition_variable myDoneCondition;
+
+	const std::function<void(int)>* myJob;
+	int myCount;
+	std::atomic<int> myNextItem;
+	std::atomic<int> myDoneItems;
+	unsigned int myGeneration;
+	int myBusyWorkers;
+	bool myQuit;
+};
@@ -0,0 +1,304 @@
+#include "LayerCache.h"
+#include <string.h>
+
+LayerCache::LayerCache()
+{
+	myDirect3D = nullptr;
+	myQuadIndexBuffer = nullptr;
+	myVertexBuffer = nullptr;
+	myLayers = nullptr;
+	myLayerCount = 0;
+	myMaxLayers = 0;
+	myWidth = 0;
+	myHeight = 0;
+	myRenderingLayer = -1;
+}
+
+LayerCache::~LayerCache()
+{
+}
+
+bool LayerCache::Initialize(D3DClass& aDirect3D, QuadIndexBuffer& aQuadIndexBuffer, int aWidth, int aHeight, int aMaxLayers)
+{
+	if (aWidth <= 0 || aHeight <= 0 || aMaxLayers <= 0)
+	{
+		return false;
+	}
+	myDirect3D = &aDirect3D;
+	myQuadIndexBuffer = &aQuadIndexBuffer;
+	myWidth = aWidth;
+	myHeight = aHeight;
+	myMaxLayers = aMaxLayers;
+	myLayerCount = 0;
+
+	// Create the layer array, the render targets are only created along with their layer.
+	myLayers = new Layer[myMaxLayers];
+
+	// Create the vertex buffer of the quad the layers are composited with.
+	return InitializeBuffers(*myDirect3D->GetDevice());
+}
+
+void LayerCache::Shutdown()
+{
+	int i;
+
+	// Release the render targets of the layers.
+	for (i = 0; i < myLayerCount; i++)
+	{
+		myLayers[i].target.Shutdown();
+	}
+	delete[] myLayers;
+	myLayers = nullptr;
+	myLayerCount = 0;
+	myMaxLayers = 0;
+
+	ShutdownBuffers();
+	myQuadIndexBuffer = nullptr;
+	myDirect3D = nullptr;
+}
+
+int LayerCache::CreateLayer()
+{
+	Layer* layer;
+	bool result;
+
+	if (myLayerCount == myMaxLayers)
+	{
+		return -1;
+	}
+
+	// Give the layer a target the size of the back buffer so it maps onto the screen pixel for pixel.
+	layer = &myLayers[myLayerCount];
+	result = layer->target.Initialize(*myDirect3D->GetDevice(), myWidth, myHeight);
+	if (!result)
+	{
+		layer->target.Shutdown();
+		return -1;
+	}
+	layer->revision = 0;
+	layer->pendingRevision = 0;
+	layer->valid = false;
+	layer->hitCount = 0;
+	layer->missCount = 0;
+
+	myLayerCount++;
+	return myLayerCount - 1;
+}
+
+void LayerCache::Invalidate(int aLayer)
+{
+	if (aLayer < 0 || aLayer >= myLayerCount)
+	{
+		return;
+	}
+	myLayers[aLayer].valid = false;
+}
+
+bool LayerCache::NeedsRender(int aLayer, const XMMATRIX& aViewMatrix, unsigned int aRevision)
+{
+	Layer* layer;
+	XMFLOAT4X4 viewMatrix;
+
+	if (aLayer < 0 || aLayer >= myLayerCount)
+	{
+		return false;
+	}
+	layer = &myLayers[aLayer];
+
+	// The cached image is still good if it was drawn from the same view and the content has not changed since.
+	XMStoreFloat4x4(&viewMatrix, aViewMatrix);
+	if (layer->valid && layer->revision == aRevision && memcmp(&layer->viewMatrix, &viewMatrix, sizeof(viewMatrix)) == 0)
+	{
+		layer->hitCount++;
+		return false;
+	}
+	layer->missCount++;
+
+	// Remember what the layer is about to be drawn with, it only becomes valid once EndRender is reached.
+	layer->pendingViewMatrix = viewMatrix;
+	layer->pendingRevision = aRevision;
+	return true;
+}
+
+void LayerCache::BeginRender(int aLayer)
+{
+	ID3D11DeviceContext* deviceContext;
+
+	if (aLayer < 0 || aLayer >= myLayerCount)
+	{
+		return;
+	}
+	myRenderingLayer = aLayer;
+
+	// Draw into the layer, starting from fully transparent so only what is drawn covers the scene behind it.
+	deviceContext = myDirect3D->GetDeviceContext();
+	myLayers[aLayer].target.SetRenderTarget(*deviceContext);
+	myLayers[aLayer].target.Clear(*deviceContext, 0.0f, 0.0f, 0.0f, 0.0f);
+}
+
+void LayerCache::EndRender()
+{
+	Layer* layer;
+
+	if (myRenderingLayer < 0)
+	{
+		return;
+	}
+
+	// Mark the layer as drawn with the keys NeedsRender was asked about.
+	layer = &myLayers[myRenderingLayer];
+	layer->viewMatrix = layer->pendingViewMatrix;
+	layer->revision = layer->pendingRevision;
+	layer->valid = true;
+	myRenderingLayer = -1;
+
+	// Go back to drawing into the back buffer.
+	myDirect3D->SetBackBufferRenderTarget();
+	myDirect3D->ResetViewport();
+}
+
+bool LayerCache::Composite(int aLayer, Shader& aShader, bool aBlend)
+{
+	bool result;
+
+	if (aLayer < 0 || aLayer >= myLayerCount || !myLayers[aLayer].valid)
+	{
+		return false;
+	}
+
+	// Lay the layer over what is already in the back buffer without testing or writing depth.
+	// Without blending the layer replaces what is there, transparent parts included, which can stand in for a clear.
+	myDirect3D->TurnZBufferOff();
+	if (aBlend)
+	{
+		myDirect3D->TurnOnPremultipliedAlphaBlending();
+	}
+	result = DrawLayer(aLayer, aShader, 0.0f);
+	myDirect3D->TurnOffAlphaBlending();
+	myDirect3D->TurnZBufferOn();
+
+	return result;
+}
+
+bool LayerCache::CompositeBehind(int aLayer, Shader& aShader)
+{
+	bool result;
+
+	if (aLayer < 0 || aLayer >= myLayerCount || !myLayers[aLayer].valid)
+	{
+		return false;
+	}
+
+	// Lay the layer at the far end of the depth range, so only the pixels nothing was drawn over yet are shaded.
+	// It is drawn without blending: its transparent parts hold black, which is what the back buffer is cleared to.
+	myDirect3D->TurnZBufferReadOnly();
+	myDirect3D->TurnOffAlphaBlending();
+	result = DrawLayer(aLayer, aShader, LAYER_BEHIND_DEPTH);
+	myDirect3D->TurnZBufferOn();
+
+	return result;
+}
+
+bool LayerCache::DrawLayer(int aLayer, Shader& aShader, float aDepth)
+{
+	ID3D11DeviceContext* deviceContext;
+	XMMATRIX worldMatrix, viewMatrix, projectionMatrix;
+	unsigned int stride;
+	unsigned int offset;
+
+	deviceContext = myDirect3D->GetDeviceContext();
+
+	// Set the quad that covers the screen to active in the input assembler.
+	stride = sizeof(SpriteVertex);
+	offset = 0;
+	deviceContext->IASetVertexBuffers(0, 1, &myVertexBuffer, &stride, &offset);
+	myQuadIndexBuffer->Render(*deviceContext);
+	deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+	// The quad is already in clip space, so the view and projection are the identity and the world matrix only sets its depth.
+	worldMatrix = XMMatrixTranslation(0.0f, 0.0f, aDepth);
+	viewMatrix = XMMatrixIdentity();
+	projectionMatrix = XMMatrixIdentity();
+
+	return aShader.Render(*deviceContext, 6, worldMatrix, viewMatrix, projectionMatrix, *myLayers[aLayer].target.GetShaderResourceView());
+}
+
+int LayerCache::GetHitCount(int aLayer)
+{
+	if (aLayer < 0 || aLayer >= myLayerCount)
+	{
+		return 0;
+	}
+	return myLayers[aLayer].hitCount;
+}
+
+int LayerCache::GetMissCount(int aLayer)
+{
+	if (aLayer < 0 || aLayer >= myLayerCount)
+	{
+		return 0;
+	}
+	return myLayers[aLayer].missCount;
+}
+
+bool LayerCache::InitializeBuffers(ID3D11Device& aDevice)
+{
+	SpriteVertex vertices[4];
+	D3D11_BUFFER_DESC vertexBufferDesc;
+	D3D11_SUBRESOURCE_DATA vertexData;
+	HRESULT result;
+
+	// Corners of the screen in clip space in the order of the model quad: bottom left, top left, bottom right, top right.
+	// Texture rows run downwards, so the top of the screen samples the top row of the layer.
+	vertices[0].x = -1.0f;
+	vertices[0].y = -1.0f;
+	vertices[0].u = PackUNorm16(0.0f);
+	vertices[0].v = PackUNorm16(1.0f);
+
+	vertices[1].x = -1.0f;
+	vertices[1].y = 1.0f;
+	vertices[1].u = PackUNorm16(0.0f);
+	vertices[1].v = PackUNorm16(0.0f);
+
+	vertices[2].x = 1.0f;
+	vertices[2].y = -1.0f;
+	vertices[2].u = PackUNorm16(1.0f);
+	vertices[2].v = PackUNorm16(1.0f);
+
+	vertices[3].x = 1.0f;
+	vertices[3].y = 1.0f;
+	vertices[3].u = PackUNorm16(1.0f);
+	vertices[3].v = PackUNorm16(0.0f);
+
+	// Set up the description of the static vertex buffer.
+	vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+	vertexBufferDesc.ByteWidth = sizeof(vertices);
+	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	vertexBufferDesc.CPUAccessFlags = 0;
+	vertexBufferDesc.MiscFlags = 0;
+	vertexBufferDesc.StructureByteStride = 0;
+
+	// Give the subresource structure a pointer to the vertex data.
+	vertexData.pSysMem = vertices;
+	vertexData.SysMemPitch = 0;
+	vertexData.SysMemSlicePitch = 0;
+
+	// Now create the vertex buffer.
+	result = aDevice.CreateBuffer(&vertexBufferDesc, &vertexData, &myVertexBuffer);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void LayerCache::ShutdownBuffers()
+{
+	// Release the vertex buffer.
+	if (myVertexBuffer != nullptr)
+	{
+		myVertexBuffer->Release();
+		myVertexBuffer = nullptr;
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <d3d11.h>
+#include <directxmath.h>
+#include "D3DClass.h"
+#include "RenderTarget.h"
+#include "Shader.h"
+#include "QuadIndexBuffer.h"
+#include "SpriteVertex.h"
+
+using namespace DirectX;
+
+// Depth a layer composited behind the scene is drawn at, in front of the cleared far plane and behind everything else.
+const float LAYER_BEHIND_DEPTH = 0.9999f;
+
+// Keeps layers of the scene that rarely change in offscreen render targets so they are drawn once and then composited
+// as a single quad. A layer is only redrawn when the revision of its content or the camera view it was drawn with changes.
+// Layers hold colors already multiplied by their alpha and are composited with the Z buffer off, in the order they are drawn,
+// or as the farthest opaque surface behind what the depth buffer already holds.
+class LayerCache
+{
+public:
+	LayerCache();
+	LayerCache(const LayerCache& aLayerCache) = delete;
+	~LayerCache();
+
+	bool Initialize(D3DClass& aDirect3D, QuadIndexBuffer& aQuadIndexBuffer, int aWidth, int aHeight, int aMaxLayers);
+	void Shutdown();
+
+	int CreateLayer();
+	void Invalidate(int aLayer);
+
+	bool NeedsRender(int aLayer, const XMMATRIX& aViewMatrix, unsigned int aRevision);
+	void BeginRender(int aLayer);
+	void EndRender();
+	bool Composite(int aLayer, Shader& aShader, bool aBlend);
+	bool CompositeBehind(int aLayer, Shader& aShader);
+
+	int GetHitCount(int aLayer);
+	int GetMissCount(int aLayer);
+
+private:
+	struct Layer
+	{
+		RenderTarget target;
+		XMFLOAT4X4 viewMatrix;
+		unsigned int revision;
+		XMFLOAT4X4 pendingViewMatrix;
+		unsigned int pendingRevision;
+		bool valid;
+		int hitCount;
+		int missCount;
+	};
+
+	bool InitializeBuffers(ID3D11Device& aDevice);
+	void ShutdownBuffers();
+	bool DrawLayer(int aLayer, Shader& aShader, float aDepth);
+
+	D3DClass* myDirect3D;
+	QuadIndexBuffer* myQuadIndexBuffer;
+	ID3D11Buffer* myVertexBuffer;
+	Layer* myLayers;
+	int myLayerCount;
+	int myMaxLayers;
+	int myWidth;
+	int myHeight;
+	int myRenderingLayer;
+};
@@ -0,0 +1,427 @@
+#include "LightGrid.h"
+#include <math.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define LIGHT_SIMD
+#endif
+
+// Stands in for the lights past the last one in a group of four, far off the top left of the screen and without a radius.
+static const float FAR_AWAY = -1.0e18f;
+
+LightGrid::LightGrid()
+{
+	myLights = nullptr;
+	myLightX = nullptr;
+	myLightY = nullptr;
+	myLightRadius = nullptr;
+	myRowX = nullptr;
+	myRowLimit = nullptr;
+	myRowIndex = nullptr;
+	myRowFirstColumn = nullptr;
+	myRowLastColumn = nullptr;
+	myRowTileLights = nullptr;
+	myRowTileCounts = nullptr;
+	myTileRanges = nullptr;
+	myTileLights = nullptr;
+	myLightCount = 0;
+	myMaxLights = 0;
+	myTileSize = 0;
+	myTileCountX = 0;
+	myTileCountY = 0;
+	myMaxLightsPerTile = 0;
+	myTileLightCount = 0;
+	myDroppedCount = 0;
+}
+
+LightGrid::~LightGrid()
+{
+}
+
+bool LightGrid::Initialize(int aScreenWidth, int aScreenHeight, int aTileSize, int aMaxLights, int aMaxLightsPerTile)
+{
+	int capacity, tileCount, i;
+
+	if (aScreenWidth <= 0 || aScreenHeight <= 0 || aTileSize <= 0 || aMaxLights <= 0 || aMaxLightsPerTile <= 0)
+	{
+		return false;
+	}
+
+	myMaxLights = aMaxLights;
+	myTileSize = aTileSize;
+	myTileCountX = (aScreenWidth + aTileSize - 1) / aTileSize;
+	myTileCountY = (aScreenHeight + aTileSize - 1) / aTileSize;
+	myMaxLightsPerTile = aMaxLightsPerTile;
+	tileCount = myTileCountX * myTileCountY;
+
+	// Round the arrays up to whole SIMD groups so the tests never have to handle a partial group.
+	capacity = (aMaxLights + 3) & ~3;
+
+	// Create the light arrays, the lists of the row being binned and the tile lists.
+	myLights = new PointLight[aMaxLights];
+	myLightX = new float[capacity];
+	myLightY = new float[capacity];
+	myLightRadius = new float[capacity];
+	myRowX = new float[capacity];
+	myRowLimit = new float[capacity];
+	myRowIndex = new int[capacity];
+	myRowFirstColumn = new int[capacity];
+	myRowLastColumn = new int[capacity];
+	myRowTileLights = new unsigned int[myTileCountX * aMaxLightsPerTile];
+	myRowTileCounts = new int[myTileCountX];
+	myTileRanges = new unsigned int[tileCount * 2];
+	myTileLights = new unsigned int[tileCount * aMaxLightsPerTile];
+
+	// Clear them so the padding never holds garbage floats.
+	for (i = 0; i < capacity; i++)
+	{
+		myLightX[i] = FAR_AWAY;
+		myLightY[i] = FAR_AWAY;
+		myLightRadius[i] = 0.0f;
+	}
+	Clear();
+
+	return true;
+}
+
+void LightGrid::Shutdown()
+{
+	delete[] myLights;
+	delete[] myLightX;
+	delete[] myLightY;
+	delete[] myLightRadius;
+	delete[] myRowX;
+	delete[] myRowLimit;
+	delete[] myRowIndex;
+	delete[] myRowFirstColumn;
+	delete[] myRowLastColumn;
+	delete[] myRowTileLights;
+	delete[] myRowTileCounts;
+	delete[] myTileRanges;
+	delete[] myTileLights;
+	myLights = nullptr;
+	myLightX = nullptr;
+	myLightY = nullptr;
+	myLightRadius = nullptr;
+	myRowX = nullptr;
+	myRowLimit = nullptr;
+	myRowIndex = nullptr;
+	myRowFirstColumn = nullptr;
+	myRowLastColumn = nullptr;
+	myRowTileLights = nullptr;
+	myRowTileCounts = nullptr;
+	myTileRanges = nullptr;
+	myTileLights = nullptr;
+	myLightCount = 0;
+	myMaxLights = 0;
+	myTileCountX = 0;
+	myTileCountY = 0;
+}
+
+void LightGrid::Clear()
+{
+	int i;
+
+	// Move the lights of the last frame out of the way of the padded groups and empty every tile.
+	for (i = 0; i < myLightCount; i++)
+	{
+		myLightX[i] = FAR_AWAY;
+		myLightY[i] = FAR_AWAY;
+		myLightRadius[i] = 0.0f;
+	}
+	myLightCount = 0;
+	for (i = 0; i < myTileCountX * myTileCountY; i++)
+	{
+		myTileRanges[i * 2] = 0;
+		myTileRanges[i * 2 + 1] = 0;
+	}
+	myTileLightCount = 0;
+	myDroppedCount = 0;
+}
+
+int LightGrid::AddLight(const PointLight& aLight)
+{
+	if (myLightCount >= myMaxLights || aLight.radius <= 0.0f)
+	{
+		return -1;
+	}
+
+	myLights[myLightCount] = aLight;
+	myLightX[myLightCount] = aLight.x;
+	myLightY[myLightCount] = aLight.y;
+	myLightRadius[myLightCount] = aLight.radius;
+	myLightCount++;
+	return myLightCount - 1;
+}
+
+void LightGrid::Cull()
+{
+	if (myTileSize < LIGHT_SIMD_MIN_TILE_SIZE)
+	{
+		CullScalar();
+	}
+	else
+	{
+		CullSimd();
+	}
+}
+
+void LightGrid::CullSimd()
+{
+	int row, count;
+
+	myTileLightCount = 0;
+	myDroppedCount = 0;
+	for (row = 0; row < myTileCountY; row++)
+	{
+		// Keep the lights that reach the band of this row, find the columns they reach in it and add them to those tiles.
+		count = GatherRow(row);
+		FindColumns(count);
+		BinRow(row, count);
+	}
+}
+
+void LightGrid::CullScalar()
+{
+	int row, count;
+
+	myTileLightCount = 0;
+	myDroppedCount = 0;
+	for (row = 0; row < myTileCountY; row++)
+	{
+		count = GatherRowScalar(row);
+		FindColumnsScalar(count);
+		BinRow(row, count);
+	}
+}
+
+const PointLight* LightGrid::GetLights(int& aCount)
+{
+	aCount = myLightCount;
+	return myLights;
+}
+
+const unsigned int* LightGrid::GetTileRanges()
+{
+	return myTileRanges;
+}
+
+const unsigned int* LightGrid::GetTileLights(int& aCount)
+{
+	aCount = myTileLightCount;
+	return myTileLights;
+}
+
+bool LightGrid::GetBounds(int& aLeft, int& aTop, int& aRight, int& aBottom)
+{
+	float left, top, right, bottom;
+	int i;
+
+	if (myLightCount == 0)
+	{
+		return false;
+	}
+
+	// Bound the circles of all lights, in whole pixels.
+	left = top = 1.0e30f;
+	right = bottom = -1.0e30f;
+	for (i = 0; i < myLightCount; i++)
+	{
+		left = myLightX[i] - myLightRadius[i] < left ? myLightX[i] - myLightRadius[i] : left;
+		right = myLightX[i] + myLightRadius[i] > right ? myLightX[i] + myLightRadius[i] : right;
+		top = myLightY[i] - myLightRadius[i] < top ? myLightY[i] - myLightRadius[i] : top;
+		bottom = myLightY[i] + myLightRadius[i] > bottom ? myLightY[i] + myLightRadius[i] : bottom;
+	}
+	aLeft = (int)floorf(left);
+	aTop = (int)floorf(top);
+	aRight = (int)ceilf(right);
+	aBottom = (int)ceilf(bottom);
+	return true;
+}
+
+int LightGrid::GetTileSize()
+{
+	return myTileSize;
+}
+
+int LightGrid::GetTileCountX()
+{
+	return myTileCountX;
+}
+
+int LightGrid::GetTileCountY()
+{
+	return myTileCountY;
+}
+
+int LightGrid::GetMaxLightsPerTile()
+{
+	return myMaxLightsPerTile;
+}
+
+int LightGrid::GetDroppedCount()
+{
+	return myDroppedCount;
+}
+
+int LightGrid::GatherRow(int aRow)
+{
+#ifdef LIGHT_SIMD
+	__m128 rowTop, rowBottom, y, radius, distance, zero;
+	float limits[4];
+	int count, mask, i, j;
+
+	rowTop = _mm_set1_ps((float)(aRow * myTileSize));
+	rowBottom = _mm_set1_ps((float)((aRow + 1) * myTileSize));
+	zero = _mm_setzero_ps();
+	count = 0;
+
+	// Four lights at a time, the arrays are padded to a multiple of four with lights that reach nothing. What is left of the
+	// squared radius over the squared distance to the band is not negative for the lights that reach it.
+	for (i = 0; i < myLightCount; i += 4)
+	{
+		y = _mm_loadu_ps(myLightY + i);
+		radius = _mm_loadu_ps(myLightRadius + i);
+		distance = _mm_max_ps(_mm_max_ps(_mm_sub_ps(rowTop, y), _mm_sub_ps(y, rowBottom)), zero);
+		distance = _mm_sub_ps(_mm_mul_ps(radius, radius), _mm_mul_ps(distance, distance));
+		mask = _mm_movemask_ps(_mm_cmpge_ps(distance, zero));
+		if (mask == 0)
+		{
+			continue;
+		}
+		_mm_storeu_ps(limits, distance);
+		for (j = 0; j < 4; j++)
+		{
+			if (mask & (1 << j))
+			{
+				myRowX[count] = myLightX[i + j];
+				myRowLimit[count] = limits[j];
+				myRowIndex[count] = i + j;
+				count++;
+			}
+		}
+	}
+
+	// Pad the row to a whole group with lights that reach no column.
+	for (i = count; i & 3; i++)
+	{
+		myRowX[i] = FAR_AWAY;
+		myRowLimit[i] = 0.0f;
+		myRowIndex[i] = 0;
+	}
+	return count;
+#else
+	return GatherRowScalar(aRow);
+#endif
+}
+
+int LightGrid::GatherRowScalar(int aRow)
+{
+	float top, bottom, distance, limit;
+	int count, i;
+
+	top = (float)(aRow * myTileSize);
+	bottom = (float)((aRow + 1) * myTileSize);
+	count = 0;
+	for (i = 0; i < myLightCount; i++)
+	{
+		distance = top - myLightY[i] > myLightY[i] - bottom ? top - myLightY[i] : myLightY[i] - bottom;
+		distance = distance > 0.0f ? distance : 0.0f;
+		limit = myLightRadius[i] * myLightRadius[i] - distance * distance;
+		if (limit >= 0.0f)
+		{
+			myRowX[count] = myLightX[i];
+			myRowLimit[count] = limit;
+			myRowIndex[count] = i;
+			count++;
+		}
+	}
+	return count;
+}
+
+void LightGrid::FindColumns(int aCount)
+{
+#ifdef LIGHT_SIMD
+	__m128 x, halfWidth, scale, zero, one, columns;
+	__m128i first, last;
+	int i;
+
+	scale = _mm_set1_ps(1.0f / (float)myTileSize);
+	zero = _mm_setzero_ps();
+	one = _mm_set1_ps(1.0f);
+	columns = _mm_set1_ps((float)myTileCountX);
+
+	// The circle reaches as far to either side as the root of what is left of its squared radius. Both ends are clamped to the
+	// screen before they are truncated, the last one shifted up by a column so truncation rounds down left of the screen too.
+	for (i = 0; i < aCount; i += 4)
+	{
+		x = _mm_loadu_ps(myRowX + i);
+		halfWidth = _mm_sqrt_ps(_mm_loadu_ps(myRowLimit + i));
+		first = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(x, halfWidth), scale), zero), columns));
+		last = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(_mm_add_ps(x, halfWidth), scale), one), zero), columns));
+		_mm_storeu_si128((__m128i*)(myRowFirstColumn + i), first);
+		_mm_storeu_si128((__m128i*)(myRowLastColumn + i), _mm_sub_epi32(last, _mm_set1_epi32(1)));
+	}
+#else
+	FindColumnsScalar(aCount);
+#endif
+}
+
+void LightGrid::FindColumnsScalar(int aCount)
+{
+	float scale, halfWidth, first, last;
+	int i;
+
+	scale = 1.0f / (float)myTileSize;
+	for (i = 0; i < aCount; i++)
+	{
+		halfWidth = sqrtf(myRowLimit[i]);
+		first = (myRowX[i] - halfWidth) * scale;
+		first = first < 0.0f ? 0.0f : (first > (float)myTileCountX ? (float)myTileCountX : first);
+		last = (myRowX[i] + halfWidth) * scale + 1.0f;
+		last = last < 0.0f ? 0.0f : (last > (float)myTileCountX ? (float)myTileCountX : last);
+		myRowFirstColumn[i] = (int)first;
+		myRowLastColumn[i] = (int)last - 1;
+	}
+}
+
+void LightGrid::BinRow(int aRow, int aCount)
+{
+	unsigned int* tileLights;
+	int tile, column, i, j;
+
+	for (column = 0; column < myTileCountX; column++)
+	{
+		myRowTileCounts[column] = 0;
+	}
+
+	// Add every light to the tiles it reaches, lights past the most a tile holds are left out of it.
+	for (i = 0; i < aCount; i++)
+	{
+		for (column = myRowFirstColumn[i]; column <= myRowLastColumn[i]; column++)
+		{
+			if (myRowTileCounts[column] < myMaxLightsPerTile)
+			{
+				myRowTileLights[column * myMaxLightsPerTile + myRowTileCounts[column]] = (unsigned int)myRowIndex[i];
+				myRowTileCounts[column]++;
+			}
+			else
+			{
+				myDroppedCount++;
+			}
+		}
+	}
+
+	// Pack the lists of the row into the shared array behind the rows before it.
+	for (column = 0; column < myTileCountX; column++)
+	{
+		tile = aRow * myTileCountX + column;
+		myTileRanges[tile * 2] = (unsigned int)myTileLightCount;
+		myTileRanges[tile * 2 + 1] = (unsigned int)myRowTileCounts[column];
+		tileLights = myRowTileLights + column * myMaxLightsPerTile;
+		for (j = 0; j < myRowTileCounts[column]; j++)
+		{
+			myTileLights[myTileLightCount++] = tileLights[j];
+		}
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+// A point light on the screen, its position and radius in pixels from the top left corner. It lights what is within its radius,
+// fading out towards the edge. Laid out the way the lit pixel shader reads its lights.
+struct PointLight
+{
+	float x;
+	float y;
+	float radius;
+	float red;
+	float green;
+	float blue;
+};
+
+// Smallest tiles Cull tests four lights at a time for. Below it most of the time goes into filling the tiles, and the four wide
+// tests measure no faster than testing one light at a time.
+const int LIGHT_SIMD_MIN_TILE_SIZE = 16;
+
+// Bins the lights of a frame into square tiles of the screen, so a pixel only evaluates the lights that reach its tile.
+// Lights are kept as arrays of coordinates and tested four at a time, row of tiles by row of tiles: first their circles against
+// the band of the row, then the half width of each circle that is left at its nearest line of the band gives the columns of tiles
+// the light reaches. Every tile lists its lights in one shared array, in the order they were added, as an offset and a count.
+// A tile holds at most a fixed number of lights, the ones beyond that are dropped and counted.
+class LightGrid
+{
+public:
+	LightGrid();
+	LightGrid(const LightGrid& aLightGrid) = delete;
+	~LightGrid();
+
+	bool Initialize(int aScreenWidth, int aScreenHeight, int aTileSize, int aMaxLights, int aMaxLightsPerTile);
+	void Shutdown();
+
+	void Clear();
+	int AddLight(const PointLight& aLight);
+
+	void Cull();
+	void CullScalar();
+	void CullSimd();
+
+	const PointLight* GetLights(int& aCount);
+	const unsigned int* GetTileRanges();
+	const unsigned int* GetTileLights(int& aCount);
+	bool GetBounds(int& aLeft, int& aTop, int& aRight, int& aBottom);
+
+	int GetTileSize();
+	int GetTileCountX();
+	int GetTileCountY();
+	int GetMaxLightsPerTile();
+	int GetDroppedCount();
+
+private:
+	int GatherRow(int aRow);
+	int GatherRowScalar(int aRow);
+	void FindColumns(int aCount);
+	void FindColumnsScalar(int aCount);
+	void BinRow(int aRow, int aCount);
+
+	PointLight* myLights;
+	float* myLightX;
+	float* myLightY;
+	float* myLightRadius;
+	float* myRowX;
+	float* myRowLimit;
+	int* myRowIndex;
+	int* myRowFirstColumn;
+	int* myRowLastColumn;
+	unsigned int* myRowTileLights;
+	int* myRowTileCounts;
+	unsigned int* myTileRanges;
+	unsigned int* myTileLights;
+	int myLightCount;
+	int myMaxLights;
+	int myTileSize;
+	int myTileCountX;
+	int myTileCountY;
+	int myMaxLightsPerTile;
+	int myTileLightCount;
+	int myDroppedCount;
+};
@@ -0,0 +1,202 @@
+#include "LightRenderer.h"
+#include <string.h>
+
+LightRenderer::LightRenderer()
+{
+	myLightBuffer = nullptr;
+	myLightView = nullptr;
+	myTileRangeBuffer = nullptr;
+	myTileRangeView = nullptr;
+	myTileLightBuffer = nullptr;
+	myTileLightView = nullptr;
+	myConstantBuffer = nullptr;
+	myMaxLights = 0;
+	myTileCount = 0;
+	myMaxLightsPerTile = 0;
+}
+
+LightRenderer::~LightRenderer()
+{
+}
+
+bool LightRenderer::Initialize(ID3D11Device& aDevice, int aMaxLights, int aTileCount, int aMaxLightsPerTile)
+{
+	D3D11_BUFFER_DESC constantBufferDesc;
+	HRESULT result;
+
+	if (aMaxLights <= 0 || aTileCount <= 0 || aMaxLightsPerTile <= 0)
+	{
+		return false;
+	}
+	myMaxLights = aMaxLights;
+	myTileCount = aTileCount;
+	myMaxLightsPerTile = aMaxLightsPerTile;
+
+	// Create the light buffer, the offset and count of every tile and the light indices the tiles share.
+	if (!CreateBuffer(aDevice, aMaxLights, sizeof(PointLight), DXGI_FORMAT_UNKNOWN, myLightBuffer, myLightView) ||
+		!CreateBuffer(aDevice, aTileCount, sizeof(unsigned int) * 2, DXGI_FORMAT_R32G32_UINT, myTileRangeBuffer, myTileRangeView) ||
+		!CreateBuffer(aDevice, aTileCount * aMaxLightsPerTile, sizeof(unsigned int), DXGI_FORMAT_R32_UINT, myTileLightBuffer, myTileLightView))
+	{
+		return false;
+	}
+
+	// Setup the description of the dynamic constant buffer that is in the lit pixel shader.
+	constantBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	constantBufferDesc.ByteWidth = sizeof(LightBufferType);
+	constantBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	constantBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	constantBufferDesc.MiscFlags = 0;
+	constantBufferDesc.StructureByteStride = 0;
+
+	// Create the constant buffer.
+	result = aDevice.CreateBuffer(&constantBufferDesc, nullptr, &myConstantBuffer);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void LightRenderer::Shutdown()
+{
+	// Release the constant buffer.
+	if (myConstantBuffer != nullptr)
+	{
+		myConstantBuffer->Release();
+		myConstantBuffer = nullptr;
+	}
+	// Release the tile lists and the lights along with their views.
+	if (myTileLightView != nullptr)
+	{
+		myTileLightView->Release();
+		myTileLightView = nullptr;
+	}
+	if (myTileLightBuffer != nullptr)
+	{
+		myTileLightBuffer->Release();
+		myTileLightBuffer = nullptr;
+	}
+	if (myTileRangeView != nullptr)
+	{
+		myTileRangeView->Release();
+		myTileRangeView = nullptr;
+	}
+	if (myTileRangeBuffer != nullptr)
+	{
+		myTileRangeBuffer->Release();
+		myTileRangeBuffer = nullptr;
+	}
+	if (myLightView != nullptr)
+	{
+		myLightView->Release();
+		myLightView = nullptr;
+	}
+	if (myLightBuffer != nullptr)
+	{
+		myLightBuffer->Release();
+		myLightBuffer = nullptr;
+	}
+}
+
+bool LightRenderer::Update(ID3D11DeviceContext& aDeviceContext, LightGrid& aLightGrid, float aLightHeight, float aAmbientRed,
+	float aAmbientGreen, float aAmbientBlue)
+{
+	LightBufferType constants;
+	const PointLight* lights;
+	const unsigned int* tileLights;
+	int lightCount, tileLightCount, tileCount;
+
+	// The grid has to fit the buffers it was sized for.
+	lights = aLightGrid.GetLights(lightCount);
+	tileLights = aLightGrid.GetTileLights(tileLightCount);
+	tileCount = aLightGrid.GetTileCountX() * aLightGrid.GetTileCountY();
+	if (lightCount > myMaxLights || tileCount > myTileCount || tileLightCount > myTileCount * myMaxLightsPerTile)
+	{
+		return false;
+	}
+
+	// Only the part of each buffer the frame uses is written, the tiles never point past it.
+	constants.tileSize = (unsigned int)aLightGrid.GetTileSize();
+	constants.tileCountX = (unsigned int)aLightGrid.GetTileCountX();
+	constants.lightHeight = aLightHeight;
+	constants.padding = 0.0f;
+	constants.ambientColor[0] = aAmbientRed;
+	constants.ambientColor[1] = aAmbientGreen;
+	constants.ambientColor[2] = aAmbientBlue;
+	constants.ambientColor[3] = 1.0f;
+	return Write(aDeviceContext, *myLightBuffer, lights, sizeof(PointLight) * lightCount) &&
+		Write(aDeviceContext, *myTileRangeBuffer, aLightGrid.GetTileRanges(), sizeof(unsigned int) * 2 * tileCount) &&
+		Write(aDeviceContext, *myTileLightBuffer, tileLights, sizeof(unsigned int) * tileLightCount) &&
+		Write(aDeviceContext, *myConstantBuffer, &constants, sizeof(constants));
+}
+
+void LightRenderer::Bind(ID3D11DeviceContext& aDeviceContext, ID3D11ShaderResourceView& aNormalMap)
+{
+	ID3D11ShaderResourceView* views[4];
+
+	// The shader set on the draw takes its texture from the first slot, the lighting comes after it. The unlit pixel shaders
+	// read none of it, so it can stay bound.
+	views[0] = &aNormalMap;
+	views[1] = myLightView;
+	views[2] = myTileRangeView;
+	views[3] = myTileLightView;
+	aDeviceContext.PSSetShaderResources(1, 4, views);
+	aDeviceContext.PSSetConstantBuffers(0, 1, &myConstantBuffer);
+}
+
+bool LightRenderer::CreateBuffer(ID3D11Device& aDevice, int aElementCount, int aElementSize, DXGI_FORMAT aFormat, ID3D11Buffer*& aBuffer,
+	ID3D11ShaderResourceView*& aView)
+{
+	D3D11_BUFFER_DESC bufferDesc;
+	D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc;
+	HRESULT result;
+
+	// Setup the description of a dynamic buffer the shader reads, structured when it has no format of its own.
+	bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	bufferDesc.ByteWidth = aElementCount * aElementSize;
+	bufferDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	bufferDesc.MiscFlags = aFormat == DXGI_FORMAT_UNKNOWN ? D3D11_RESOURCE_MISC_BUFFER_STRUCTURED : 0;
+	bufferDesc.StructureByteStride = aFormat == DXGI_FORMAT_UNKNOWN ? aElementSize : 0;
+
+	// Create the buffer.
+	result = aDevice.CreateBuffer(&bufferDesc, nullptr, &aBuffer);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	// Create the view the shader reads the elements through.
+	viewDesc.Format = aFormat;
+	viewDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+	viewDesc.Buffer.FirstElement = 0;
+	viewDesc.Buffer.NumElements = aElementCount;
+	result = aDevice.CreateShaderResourceView(aBuffer, &viewDesc, &aView);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+bool LightRenderer::Write(ID3D11DeviceContext& aDeviceContext, ID3D11Buffer& aBuffer, const void* aData, size_t aSize)
+{
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	HRESULT result;
+
+	// Discard what the buffer held last frame and copy the new contents in.
+	result = aDeviceContext.Map(&aBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	if (FAILED(result))
+	{
+		return false;
+	}
+	if (aSize > 0)
+	{
+		memcpy(mappedResource.pData, aData, aSize);
+	}
+	aDeviceContext.Unmap(&aBuffer, 0);
+
+	return true;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <d3d11.h>
+#include "LightGrid.h"
+
+// Hands the lights of a light grid and its tile lists to the lit pixel shader. The lights go in a structured buffer, the offset and
+// count of every tile and the shared list of light indices in typed buffers, all of them rewritten every frame. A constant buffer
+// says how the screen is split into tiles, how high the lights stand above the sprites and how bright the unlit parts are.
+class LightRenderer
+{
+public:
+	LightRenderer();
+	LightRenderer(const LightRenderer& aLightRenderer) = delete;
+	~LightRenderer();
+
+	bool Initialize(ID3D11Device& aDevice, int aMaxLights, int aTileCount, int aMaxLightsPerTile);
+	void Shutdown();
+
+	bool Update(ID3D11DeviceContext& aDeviceContext, LightGrid& aLightGrid, float aLightHeight, float aAmbientRed, float aAmbientGreen,
+		float aAmbientBlue);
+	void Bind(ID3D11DeviceContext& aDeviceContext, ID3D11ShaderResourceView& aNormalMap);
+
+private:
+	struct LightBufferType
+	{
+		unsigned int tileSize;
+		unsigned int tileCountX;
+		float lightHeight;
+		float padding;
+		float ambientColor[4];
+	};
+
+	bool CreateBuffer(ID3D11Device& aDevice, int aElementCount, int aElementSize, DXGI_FORMAT aFormat, ID3D11Buffer*& aBuffer,
+		ID3D11ShaderResourceView*& aView);
+	bool Write(ID3D11DeviceContext& aDeviceContext, ID3D11Buffer& aBuffer, const void* aData, size_t aSize);
+
+	ID3D11Buffer* myLightBuffer;
+	ID3D11ShaderResourceView* myLightView;
+	ID3D11Buffer* myTileRangeBuffer;
+	ID3D11ShaderResourceView* myTileRangeView;
+	ID3D11Buffer* myTileLightBuffer;
+	ID3D11ShaderResourceView* myTileLightView;
+	ID3D11Buffer* myConstantBuffer;
+	int myMaxLights;
+	int myTileCount;
+	int myMaxLightsPerTile;
+};
@@ -0,0 +1,120 @@
+#include "LinearArena.h"
+#include "AllocationTracker.h"
+#include <string.h>
+
+// Fill patterns of debug builds, the same bytes the debug heap uses.
+static const unsigned char ALLOCATED_FILL = 0xcd;
+static const unsigned char RELEASED_FILL = 0xdd;
+
+LinearArena::LinearArena()
+{
+	myMemory = nullptr;
+	myCapacity = 0;
+	myUsed = 0;
+	myHighWaterMark = 0;
+}
+
+LinearArena::~LinearArena()
+{
+}
+
+bool LinearArena::Initialize(size_t aCapacity)
+{
+	if (aCapacity == 0)
+	{
+		return false;
+	}
+
+	// Create the block all allocations are carved from.
+	myMemory = new unsigned char[aCapacity];
+	if (!myMemory)
+	{
+		return false;
+	}
+	myCapacity = aCapacity;
+	myUsed = 0;
+	myHighWaterMark = 0;
+
+#ifdef _DEBUG
+	memset(myMemory, RELEASED_FILL, myCapacity);
+#endif
+
+	return true;
+}
+
+void LinearArena::Shutdown()
+{
+	// Release the block.
+	delete[] myMemory;
+	myMemory = nullptr;
+
+	myCapacity = 0;
+	myUsed = 0;
+}
+
+void* LinearArena::Allocate(size_t aSize, size_t aAlignment)
+{
+	size_t start;
+
+	// Round the start up to the alignment, which has to be a power of two.
+	start = (myUsed + aAlignment - 1) & ~(aAlignment - 1);
+	if (myMemory == nullptr || start + aSize > myCapacity || start + aSize < start)
+	{
+		return nullptr;
+	}
+
+	myUsed = start + aSize;
+#ifdef ALLOCATION_TRACKING
+	AllocationTracker::RecordEngineAllocation(aSize);
+#endif
+	if (myUsed > myHighWaterMark)
+	{
+		myHighWaterMark = myUsed;
+	}
+
+#ifdef _DEBUG
+	memset(myMemory + start, ALLOCATED_FILL, aSize);
+#endif
+
+	return myMemory + start;
+}
+
+size_t LinearArena::GetMarker()
+{
+	return myUsed;
+}
+
+void LinearArena::Rewind(size_t aMarker)
+{
+	if (aMarker >= myUsed)
+	{
+		return;
+	}
+
+#ifdef _DEBUG
+	memset(myMemory + aMarker, RELEASED_FILL, myUsed - aMarker);
+#endif
+
+	// Everything allocated after the marker is released at once.
+	myUsed = aMarker;
+}
+
+void LinearArena::Reset()
+{
+	Rewind(0);
+}
+
+size_t LinearArena::GetUsed()
+{
+	return myUsed;
+}
+
+size_t LinearArena::GetCapacity()
+{
+	return myCapacity;
+}
+
+size_t LinearArena::GetHighWaterMark()
+{
+	return myHighWaterMark;
+}
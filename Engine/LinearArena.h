@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stddef.h>
+
+// Alignment used when the caller does not ask for one, enough for any SSE type.
+const size_t ARENA_DEFAULT_ALIGNMENT = 16;
+
+// Bump allocator over one fixed block of memory.
+// Allocations are never freed one by one, the arena is rewound to a marker or reset as a whole instead.
+// Debug builds fill handed out memory with 0xcd and released memory with 0xdd so stale reads show up.
+class LinearArena
+{
+public:
+	LinearArena();
+	LinearArena(const LinearArena& aLinearArena) = delete;
+	~LinearArena();
+
+	bool Initialize(size_t aCapacity);
+	void Shutdown();
+
+	void* Allocate(size_t aSize, size_t aAlignment = ARENA_DEFAULT_ALIGNMENT);
+	template<typename T> T* AllocateArray(int aCount)
+	{
+		return (T*)Allocate(sizeof(T) * aCount, alignof(T) > ARENA_DEFAULT_ALIGNMENT ? alignof(T) : ARENA_DEFAULT_ALIGNMENT);
+	}
+
+	size_t GetMarker();
+	void Rewind(size_t aMarker);
+	void Reset();
+
+	size_t GetUsed();
+	size_t GetCapacity();
+	size_t GetHighWaterMark();
+
+private:
+	unsigned char* myMemory;
+	size_t myCapacity;
+	size_t myUsed;
+	size_t myHighWaterMark;
+};
@@ -0,0 +1,24 @@
+#include "Material.h"
+
+MaterialType ClassifyAlpha(const unsigned char* aPixels, int aPixelCount)
+{
+	unsigned char alpha;
+	bool cutout;
+	int i;
+
+	// A single texel of partial alpha needs blending, texels that are fully transparent can be discarded by the alpha test.
+	cutout = false;
+	for (i = 0; i < aPixelCount; i++)
+	{
+		alpha = aPixels[i * 4 + 3];
+		if (alpha == 0)
+		{
+			cutout = true;
+		}
+		else if (alpha != 255)
+		{
+			return MATERIAL_TRANSLUCENT;
+		}
+	}
+	return cutout ? MATERIAL_ALPHA_TESTED : MATERIAL_OPAQUE;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+// How a surface covers what is behind it, which decides the pass it is drawn in. Opaque and alpha tested surfaces write depth
+// and are drawn front to back, so pixels behind them are rejected before they are shaded. Alpha tested ones discard the texels
+// below the threshold instead of blending them. Translucent surfaces blend, so they only test depth and are drawn back to front.
+enum MaterialType
+{
+	MATERIAL_OPAQUE,
+	MATERIAL_ALPHA_TESTED,
+	MATERIAL_TRANSLUCENT
+};
+
+// Texels with less alpha than this are discarded by the alpha test.
+const unsigned char ALPHA_TEST_THRESHOLD = 128;
+
+// Classifies an image of RGBA pixels by its alpha: fully opaque, only fully opaque and fully transparent texels, or anything in between.
+MaterialType ClassifyAlpha(const unsigned char* aPixels, int aPixelCount);
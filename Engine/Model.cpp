@@ -3,31 +3,31 @@
 Model::Model()
 {
 	myVertexBuffer = nullptr;
-	myIndexBuffer = nullptr;
+	myQuadIndexBuffer = nullptr;
 	myTexture = nullptr;
 }
 
-Model::Model(const Model& aModel)
-{
-}
-
 Model::~Model()
 {
 }
 
-bool Model::Initialize(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext, const std::string& aTexturePath)
+bool Model::Initialize(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext, QuadIndexBuffer& aQuadIndexBuffer,
+	const std::string& aTexturePath, int aMaxOutlineVertices, TextureUploadQueue* aUploadQueue)
 {
 	bool result;
 
-	// Initialize the vertex and index buffers
-	result = InitializeBuffers(aDevice);
+	// The model is made of quads, so it draws with the shared quad indices
+	myQuadIndexBuffer = &aQuadIndexBuffer;
+
+	// Load the texture for this model, with the outline of its visible texels, through the upload queue when there is one
+	result = LoadTexture(aDevice, aDeviceContext, aTexturePath, aMaxOutlineVertices, aUploadQueue);
 	if (!result)
 	{
 		return false;
 	}
 
-	// Load the texture for this model
-	result = LoadTexture(aDevice, aDeviceContext, aTexturePath);
+	// Initialize the vertex buffer in the shape of the outline
+	result = InitializeBuffers(aDevice);
 	if (!result)
 	{
 		return false;
@@ -41,8 +41,9 @@ void Model::Shutdown()
 	// Release the model texture
 	ReleaseTexture();
 
-	// Shutdown the vertex and index buffers
+	// Shutdown the vertex buffer
 	ShutdownBuffers();
+	myQuadIndexBuffer = nullptr;
 }
 
 void Model::Render(ID3D11DeviceContext& aDeviceContext)
@@ -61,68 +62,111 @@ ID3D11ShaderResourceView* Model::GetTexture()
 	return myTexture->GetTexture();
 }
 
+ID3D11ShaderResourceView* Model::GetNormalMap()
+{
+	return myTexture->GetNormalMap();
+}
+
+MaterialType Model::GetMaterial()
+{
+	return myTexture->GetMaterial();
+}
+
+int Model::GetTextureWidth()
+{
+	return myTexture->GetWidth();
+}
+
+int Model::GetTextureHeight()
+{
+	return myTexture->GetHeight();
+}
+
+bool Model::SetTextureFirstMip(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext, int aFirstMip)
+{
+	return myTexture->SetFirstMip(aDevice, aDeviceContext, aFirstMip);
+}
+
 bool Model::InitializeBuffers(ID3D11Device& aDevice)
 {
-	VertexType* vertices;
-	unsigned long* indices;
-	D3D11_BUFFER_DESC vertexBufferDesc;
-	D3D11_BUFFER_DESC indexBufferDesc;
-	D3D11_SUBRESOURCE_DATA vertexData;
-	D3D11_SUBRESOURCE_DATA indexData;
-	HRESULT result;
+	SpriteVertex* vertices;
+	ScratchArena scratch;
+	const OutlinePoint* outline;
+	SpriteAnimation::UVRect uv;
+	int outlineCount;
+
+	// Cover only the outline of the visible texels when the texture has one, the full quad otherwise
+	outline = myTexture->GetOutline(outlineCount);
+	if (outlineCount >= 3)
+	{
+		myVertexCount = GetOutlineQuadCount(outlineCount) * 4;
+		myIndexCount = GetOutlineQuadCount(outlineCount) * 6;
+		vertices = scratch.AllocateArray<SpriteVertex>(myVertexCount);
+		if (!vertices)
+		{
+			return false;
+		}
+		uv.left = 0.0f;
+		uv.top = 0.0f;
+		uv.right = 1.0f;
+		uv.bottom = 1.0f;
+		WriteOutlineQuads(outline, outlineCount, -1.0f, -1.0f, 1.0f, 1.0f, uv, vertices);
+		return CreateVertexBuffer(aDevice, vertices);
+	}
 
 	// Set the number of vertices in the vertex array
 	myVertexCount = 4;
 
-	// Set the number of indices in the index array
+	// Set the number of indices the quad takes from the shared index buffer
 	myIndexCount = 6;
 
-	// Create the vertex array
-	vertices = new VertexType[myVertexCount];
+	// Create the vertex array in scratch memory, it is released when the function returns
+	vertices = scratch.AllocateArray<SpriteVertex>(myVertexCount);
 	if (!vertices)
 	{
 		return false;
 	}
 
-	// Create the index array
-	indices = new unsigned long[myIndexCount];
-	if (!indices)
-	{
-		return false;
-	}
-
-	// Load the vertex array with data
-	vertices[0].position = XMFLOAT3(-1.0f, -1.0f, 0.0f);  // Bottom left
-	vertices[0].texture = XMFLOAT2(0.0f, 1.0f);
+	// Load the vertex array with data, in the corner order of the quad indices
+	vertices[0].x = -1.0f;  // Bottom left
+	vertices[0].y = -1.0f;
+	vertices[0].u = PackUNorm16(0.0f);
+	vertices[0].v = PackUNorm16(1.0f);
 
-	vertices[1].position = XMFLOAT3(-1.0f, 1.0f, 0.0f);  // Top left
-	vertices[1].texture = XMFLOAT2(0.0f, 0.0f);
+	vertices[1].x = -1.0f;  // Top left
+	vertices[1].y = 1.0f;
+	vertices[1].u = PackUNorm16(0.0f);
+	vertices[1].v = PackUNorm16(0.0f);
 
-	vertices[2].position = XMFLOAT3(1.0f, -1.0f, 0.0f);  // Bottom right
-	vertices[2].texture = XMFLOAT2(1.0f, 1.0f);
+	vertices[2].x = 1.0f;  // Bottom right
+	vertices[2].y = -1.0f;
+	vertices[2].u = PackUNorm16(1.0f);
+	vertices[2].v = PackUNorm16(1.0f);
 
-	vertices[3].position = XMFLOAT3(1.0f, 1.0f, 0.0f);  // Top Right
-	vertices[3].texture = XMFLOAT2(1.0f, 0.0f);
+	vertices[3].x = 1.0f;  // Top Right
+	vertices[3].y = 1.0f;
+	vertices[3].u = PackUNorm16(1.0f);
+	vertices[3].v = PackUNorm16(0.0f);
 
-	// Load the index array with data
-	indices[0] = 0;
-	indices[1] = 1;
-	indices[2] = 2;
-	indices[3] = 2;
-	indices[4] = 1;
-	indices[5] = 3;
+	return CreateVertexBuffer(aDevice, vertices);
+}
 
+bool Model::CreateVertexBuffer(ID3D11Device& aDevice, const SpriteVertex* aVertices)
+{
+	D3D11_BUFFER_DESC vertexBufferDesc;
+	D3D11_SUBRESOURCE_DATA vertexData;
+	HRESULT result;
 
-	// Set up the description of the static vertex buffer
-	vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-	vertexBufferDesc.ByteWidth = sizeof(VertexType) * myVertexCount;
+	// Set up the description of the immutable vertex buffer
+	vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+	vertexBufferDesc.ByteWidth = sizeof(SpriteVertex) * myVertexCount;
 	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
 	vertexBufferDesc.CPUAccessFlags = 0;
 	vertexBufferDesc.MiscFlags = 0;
 	vertexBufferDesc.StructureByteStride = 0;
 
 	// Give the subresource structure a pointer to the vertex data
-	vertexData.pSysMem = vertices;
+	vertexData.pSysMem = aVertices;
 	vertexData.SysMemPitch = 0;
 	vertexData.SysMemSlicePitch = 0;
 
@@ -133,44 +177,11 @@ bool Model::InitializeBuffers(ID3D11Device& aDevice)
 		return false;
 	}
 
-	// Set up the description of the static index buffer
-	indexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-	indexBufferDesc.ByteWidth = sizeof(unsigned long) * myIndexCount;
-	indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-	indexBufferDesc.CPUAccessFlags = 0;
-	indexBufferDesc.MiscFlags = 0;
-	indexBufferDesc.StructureByteStride = 0;
-
-	// Give the subresource structure a pointer to the index data
-	indexData.pSysMem = indices;
-	indexData.SysMemPitch = 0;
-	indexData.SysMemSlicePitch = 0;
-
-	// Create the index buffer
-	result = aDevice.CreateBuffer(&indexBufferDesc, &indexData, &myIndexBuffer);
-	if (FAILED(result))
-	{
-		return false;
-	}
-
-	// Release the arrays now that the vertex and index buffers have been created and loaded
-	delete[] vertices;
-	vertices = nullptr;
-
-	delete[] indices;
-	indices = nullptr;
-
 	return true;
 }
 
 void Model::ShutdownBuffers()
 {
-	// Release the index buffer
-	if (myIndexBuffer)
-	{
-		myIndexBuffer->Release();
-		myIndexBuffer = nullptr;
-	}
 	// Release the vertex buffer
 	if (myVertexBuffer)
 	{
@@ -185,20 +196,21 @@ void Model::RenderBuffers(ID3D11DeviceContext& aDeviceContext)
 	unsigned int offset;
 
 	// Set vertex buffer stride and offset
-	stride = sizeof(VertexType);
+	stride = sizeof(SpriteVertex);
 	offset = 0;
 
 	// Set the vertex buffer to active in the input assembler so it can be rendered
 	aDeviceContext.IASetVertexBuffers(0, 1, &myVertexBuffer, &stride, &offset);
 
-	// Set the index buffer to active in the input assembler so it can be rendered
-	aDeviceContext.IASetIndexBuffer(myIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
+	// Set the shared quad index buffer to active in the input assembler so it can be rendered
+	myQuadIndexBuffer->Render(aDeviceContext);
 
 	// Set the type of primitive that should be rendered from this vertex buffer, in this case triangles
 	aDeviceContext.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 }
 
-bool Model::LoadTexture(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext, const std::string& aTexturePath)
+bool Model::LoadTexture(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext, const std::string& aTexturePath, int aMaxOutlineVertices,
+	TextureUploadQueue* aUploadQueue)
 {
 	bool result;
 
@@ -210,7 +222,7 @@ bool Model::LoadTexture(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceConte
 	}
 
 	// Initialize the texture object
-	result = myTexture->Initialize(aDevice, aDeviceContext, aTexturePath);
+	result = myTexture->Initialize(aDevice, aDeviceContext, aTexturePath, aMaxOutlineVertices, aUploadQueue);
 	if (!result)
 	{
 		return false;
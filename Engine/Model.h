@@ -3,6 +3,9 @@
 #include <d3d11.h>
 #include <directxmath.h>
 #include "Texture.h"
+#include "QuadIndexBuffer.h"
+#include "SpriteVertex.h"
+#include "ScratchArena.h"
 #include <string>
 
 using namespace DirectX;
@@ -11,31 +14,33 @@ class Model
 {
 public:
 	Model();
-	Model(const Model& aModel);
+	Model(const Model& aModel) = delete;
 	~Model();
 
-	bool Initialize(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext, const std::string& aTexturePath);
+	bool Initialize(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext, QuadIndexBuffer& aQuadIndexBuffer,
+		const std::string& aTexturePath, int aMaxOutlineVertices, TextureUploadQueue* aUploadQueue);
 	void Shutdown();
 	void Render(ID3D11DeviceContext& aDeviceContext);
 
 	int GetIndexCount();
 	ID3D11ShaderResourceView* GetTexture();
+	ID3D11ShaderResourceView* GetNormalMap();
+	MaterialType GetMaterial();
+	int GetTextureWidth();
+	int GetTextureHeight();
+	bool SetTextureFirstMip(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext, int aFirstMip);
 
 private:
-	struct VertexType
-	{
-		XMFLOAT3 position;
-		XMFLOAT2 texture;
-	};
-
 	bool InitializeBuffers(ID3D11Device& aDevice);
+	bool CreateVertexBuffer(ID3D11Device& aDevice, const SpriteVertex* aVertices);
 	void ShutdownBuffers();
 	void RenderBuffers(ID3D11DeviceContext& aDeviceContext);
-	bool LoadTexture(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext, const std::string& aTexturePath);
+	bool LoadTexture(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext, const std::string& aTexturePath, int aMaxOutlineVertices,
+		TextureUploadQueue* aUploadQueue);
 	void ReleaseTexture();
 
 	ID3D11Buffer* myVertexBuffer;
-	ID3D11Buffer* myIndexBuffer;
+	QuadIndexBuffer* myQuadIndexBuffer;
 	Texture* myTexture;
 	int myVertexCount;
 	int myIndexCount;
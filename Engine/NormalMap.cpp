@@ -0,0 +1,44 @@
+#include "NormalMap.h"
+#include <math.h>
+
+// Height of a texel between 0 and 1, with the texels past the edge taken from the edge.
+static float GetHeight(const unsigned char* aPixels, int aWidth, int aHeight, int aX, int aY)
+{
+	const unsigned char* pixel;
+
+	aX = aX < 0 ? 0 : (aX >= aWidth ? aWidth - 1 : aX);
+	aY = aY < 0 ? 0 : (aY >= aHeight ? aHeight - 1 : aY);
+	pixel = aPixels + (aY * aWidth + aX) * 4;
+	return (0.299f * pixel[0] + 0.587f * pixel[1] + 0.114f * pixel[2]) * pixel[3] / (255.0f * 255.0f);
+}
+
+void BuildNormalMap(const unsigned char* aPixels, int aWidth, int aHeight, float aStrength, unsigned char* aNormals)
+{
+	float slopeX, slopeY, length;
+	unsigned char* normal;
+	int x, y;
+
+	for (y = 0; y < aHeight; y++)
+	{
+		for (x = 0; x < aWidth; x++)
+		{
+			// The slopes of the height field from a Sobel filter over the texels around.
+			slopeX = GetHeight(aPixels, aWidth, aHeight, x + 1, y - 1) + 2.0f * GetHeight(aPixels, aWidth, aHeight, x + 1, y) +
+				GetHeight(aPixels, aWidth, aHeight, x + 1, y + 1) - GetHeight(aPixels, aWidth, aHeight, x - 1, y - 1) -
+				2.0f * GetHeight(aPixels, aWidth, aHeight, x - 1, y) - GetHeight(aPixels, aWidth, aHeight, x - 1, y + 1);
+			slopeY = GetHeight(aPixels, aWidth, aHeight, x - 1, y + 1) + 2.0f * GetHeight(aPixels, aWidth, aHeight, x, y + 1) +
+				GetHeight(aPixels, aWidth, aHeight, x + 1, y + 1) - GetHeight(aPixels, aWidth, aHeight, x - 1, y - 1) -
+				2.0f * GetHeight(aPixels, aWidth, aHeight, x, y - 1) - GetHeight(aPixels, aWidth, aHeight, x + 1, y - 1);
+			slopeX *= aStrength;
+			slopeY *= aStrength;
+
+			// The surface leans away from where it rises.
+			length = sqrtf(slopeX * slopeX + slopeY * slopeY + 1.0f);
+			normal = aNormals + (y * aWidth + x) * 4;
+			normal[0] = (unsigned char)((-slopeX / length * 0.5f + 0.5f) * 255.0f + 0.5f);
+			normal[1] = (unsigned char)((-slopeY / length * 0.5f + 0.5f) * 255.0f + 0.5f);
+			normal[2] = (unsigned char)((1.0f / length * 0.5f + 0.5f) * 255.0f + 0.5f);
+			normal[3] = 255;
+		}
+	}
+}
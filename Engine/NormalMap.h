@@ -0,0 +1,6 @@
+#pragma once
+
+// Builds a normal map for an image of RGBA pixels that has none, treating its brightness over its alpha as a height field.
+// The normals point out of the image, x to the right and y down the rows the way the screen runs, and are stored as RGBA
+// pixels mapped from [-1, 1] to [0, 255]. The strength scales the slopes, larger values give a more pronounced relief.
+void BuildNormalMap(const unsigned char* aPixels, int aWidth, int aHeight, float aStrength, unsigned char* aNormals);
@@ -0,0 +1,111 @@
+#include "OverdrawCounter.h"
+
+OverdrawCounter::OverdrawCounter()
+{
+	int i;
+
+	for (i = 0; i < OVERDRAW_QUERY_COUNT; i++)
+	{
+		myQueries[i] = nullptr;
+		myCoveredPixelCounts[i] = 0;
+	}
+	myFirstQuery = 0;
+	myPendingCount = 0;
+	myCounting = false;
+}
+
+OverdrawCounter::~OverdrawCounter()
+{
+}
+
+bool OverdrawCounter::Initialize(ID3D11Device& aDevice)
+{
+	D3D11_QUERY_DESC queryDesc;
+	HRESULT result;
+	int i;
+
+	// Create the ring of queries that count what the pipeline stages did between their begin and end.
+	queryDesc.Query = D3D11_QUERY_PIPELINE_STATISTICS;
+	queryDesc.MiscFlags = 0;
+	for (i = 0; i < OVERDRAW_QUERY_COUNT; i++)
+	{
+		result = aDevice.CreateQuery(&queryDesc, &myQueries[i]);
+		if (FAILED(result))
+		{
+			return false;
+		}
+	}
+	myFirstQuery = 0;
+	myPendingCount = 0;
+	myCounting = false;
+
+	return true;
+}
+
+void OverdrawCounter::Shutdown()
+{
+	int i;
+
+	// Release the queries, results still pending are lost.
+	for (i = 0; i < OVERDRAW_QUERY_COUNT; i++)
+	{
+		if (myQueries[i] != nullptr)
+		{
+			myQueries[i]->Release();
+			myQueries[i] = nullptr;
+		}
+	}
+	myPendingCount = 0;
+	myCounting = false;
+}
+
+void OverdrawCounter::Begin(ID3D11DeviceContext& aDeviceContext)
+{
+	// Skip the frame rather than wait when no query is free.
+	myCounting = myPendingCount < OVERDRAW_QUERY_COUNT;
+	if (myCounting)
+	{
+		aDeviceContext.Begin(myQueries[(myFirstQuery + myPendingCount) % OVERDRAW_QUERY_COUNT]);
+	}
+}
+
+void OverdrawCounter::End(ID3D11DeviceContext& aDeviceContext, long long aCoveredPixelCount)
+{
+	int index;
+
+	if (!myCounting)
+	{
+		return;
+	}
+
+	// Keep the pixels the frame covered with its query, the shaded ones are only known once the GPU is done.
+	index = (myFirstQuery + myPendingCount) % OVERDRAW_QUERY_COUNT;
+	aDeviceContext.End(myQueries[index]);
+	myCoveredPixelCounts[index] = aCoveredPixelCount;
+	myPendingCount++;
+	myCounting = false;
+}
+
+bool OverdrawCounter::Read(ID3D11DeviceContext& aDeviceContext, Result& aResult)
+{
+	D3D11_QUERY_DATA_PIPELINE_STATISTICS statistics;
+	HRESULT result;
+
+	if (myPendingCount == 0)
+	{
+		return false;
+	}
+
+	// Look at the oldest query without flushing the commands of the frame being recorded.
+	result = aDeviceContext.GetData(myQueries[myFirstQuery], &statistics, sizeof(statistics), D3D11_ASYNC_GETDATA_DONOTFLUSH);
+	if (result != S_OK)
+	{
+		return false;
+	}
+	aResult.shadedPixelCount = (long long)statistics.PSInvocations;
+	aResult.coveredPixelCount = myCoveredPixelCounts[myFirstQuery];
+
+	myFirstQuery = (myFirstQuery + 1) % OVERDRAW_QUERY_COUNT;
+	myPendingCount--;
+	return true;
+}
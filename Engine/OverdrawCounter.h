@@ -0,0 +1,37 @@
+#pragma once
+
+#include <d3d11.h>
+
+const int OVERDRAW_QUERY_COUNT = 4;
+
+// Counts how many pixels the frames shade against how many they cover, to measure overdraw and what depth rejection saves.
+// Each counted frame is wrapped in a pipeline statistics query, whose count of pixel shader invocations is only ready a few frames
+// later. The queries form a ring that is read oldest first without waiting, and a frame that finds every query still pending
+// is not counted.
+class OverdrawCounter
+{
+public:
+	struct Result
+	{
+		long long shadedPixelCount;
+		long long coveredPixelCount;
+	};
+
+	OverdrawCounter();
+	OverdrawCounter(const OverdrawCounter& aOverdrawCounter) = delete;
+	~OverdrawCounter();
+
+	bool Initialize(ID3D11Device& aDevice);
+	void Shutdown();
+
+	void Begin(ID3D11DeviceContext& aDeviceContext);
+	void End(ID3D11DeviceContext& aDeviceContext, long long aCoveredPixelCount);
+	bool Read(ID3D11DeviceContext& aDeviceContext, Result& aResult);
+
+private:
+	ID3D11Query* myQueries[OVERDRAW_QUERY_COUNT];
+	long long myCoveredPixelCounts[OVERDRAW_QUERY_COUNT];
+	int myFirstQuery;
+	int myPendingCount;
+	bool myCounting;
+};
@@ -0,0 +1,441 @@
+#include "ParticleEmitter.h"
+#include <math.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define PARTICLE_SIMD
+#endif
+
+// Samples a curve given as keys sorted by time in [0, 1] at an evenly spaced time.
+static float SampleCurve(const float* aTimes, const float* aValues, int aKeyCount, float aTime)
+{
+	int i;
+	float t;
+
+	if (aTime <= aTimes[0])
+	{
+		return aValues[0];
+	}
+	for (i = 1; i < aKeyCount; i++)
+	{
+		if (aTime <= aTimes[i])
+		{
+			t = (aTime - aTimes[i - 1]) / (aTimes[i] - aTimes[i - 1]);
+			return aValues[i - 1] + (aValues[i] - aValues[i - 1]) * t;
+		}
+	}
+	return aValues[aKeyCount - 1];
+}
+
+ParticleEmitter::ParticleEmitter()
+{
+	myPositionsX = nullptr;
+	myPositionsY = nullptr;
+	myVelocitiesX = nullptr;
+	myVelocitiesY = nullptr;
+	myAges = nullptr;
+	myAgeRates = nullptr;
+	mySizes = nullptr;
+	myBounds.minX = 0.0f;
+	myBounds.minY = 0.0f;
+	myBounds.maxX = 0.0f;
+	myBounds.maxY = 0.0f;
+	myEmissionAccumulator = 0.0f;
+	myRandomState = 1;
+	myParticleCount = 0;
+	myMaxParticles = 0;
+}
+
+ParticleEmitter::~ParticleEmitter()
+{
+}
+
+bool ParticleEmitter::Initialize(const Settings& aSettings, int aMaxParticles, unsigned int aSeed)
+{
+	float times[2];
+	float sizes[2];
+	int capacity, i;
+
+	if (aMaxParticles <= 0)
+	{
+		return false;
+	}
+
+	mySettings = aSettings;
+	myMaxParticles = aMaxParticles;
+	myParticleCount = 0;
+	myEmissionAccumulator = 0.0f;
+
+	// The random generator must never be seeded with zero.
+	myRandomState = aSeed != 0 ? aSeed : 1;
+
+	// Round the arrays up to whole SIMD groups so the update never has to handle a partial group.
+	capacity = (aMaxParticles + 3) & ~3;
+
+	// Create the particle arrays.
+	myPositionsX = new float[capacity];
+	myPositionsY = new float[capacity];
+	myVelocitiesX = new float[capacity];
+	myVelocitiesY = new float[capacity];
+	myAges = new float[capacity];
+	myAgeRates = new float[capacity];
+	mySizes = new float[capacity];
+
+	// Clear them so the padding never holds garbage floats.
+	for (i = 0; i < capacity; i++)
+	{
+		myPositionsX[i] = 0.0f;
+		myPositionsY[i] = 0.0f;
+		myVelocitiesX[i] = 0.0f;
+		myVelocitiesY[i] = 0.0f;
+		myAges[i] = 0.0f;
+		myAgeRates[i] = 0.0f;
+		mySizes[i] = 0.0f;
+	}
+
+	// Default to a constant size.
+	times[0] = 0.0f;
+	times[1] = 1.0f;
+	sizes[0] = 0.1f;
+	sizes[1] = 0.1f;
+
+	SetSizeCurve(times, sizes, 2);
+
+	return true;
+}
+
+void ParticleEmitter::Shutdown()
+{
+	// Release the particle arrays.
+	delete[] myPositionsX;
+	myPositionsX = nullptr;
+	delete[] myPositionsY;
+	myPositionsY = nullptr;
+	delete[] myVelocitiesX;
+	myVelocitiesX = nullptr;
+	delete[] myVelocitiesY;
+	myVelocitiesY = nullptr;
+	delete[] myAges;
+	myAges = nullptr;
+	delete[] myAgeRates;
+	myAgeRates = nullptr;
+	delete[] mySizes;
+	mySizes = nullptr;
+
+	myParticleCount = 0;
+	myMaxParticles = 0;
+}
+
+void ParticleEmitter::SetPosition(float aX, float aY)
+{
+	mySettings.positionX = aX;
+	mySettings.positionY = aY;
+}
+
+void ParticleEmitter::SetEmissionRate(float aEmissionRate)
+{
+	mySettings.emissionRate = aEmissionRate;
+}
+
+void ParticleEmitter::SetSizeCurve(const float* aTimes, const float* aSizes, int aKeyCount)
+{
+	int i;
+
+	if (aKeyCount <= 0)
+	{
+		return;
+	}
+
+	// Bake the curve into a table indexed by normalized age.
+	for (i = 0; i < PARTICLE_CURVE_SAMPLES; i++)
+	{
+		mySizeCurve[i] = SampleCurve(aTimes, aSizes, aKeyCount, (float)i / (float)(PARTICLE_CURVE_SAMPLES - 1));
+	}
+}
+
+void ParticleEmitter::Burst(int aCount)
+{
+	Emit(aCount);
+	ApplyCurves();
+}
+
+void ParticleEmitter::Update(float aDeltaTime)
+{
+	int count;
+
+	// Spawn the particles the emission rate asks for this step.
+	myEmissionAccumulator += mySettings.emissionRate * aDeltaTime;
+	count = (int)myEmissionAccumulator;
+	myEmissionAccumulator -= (float)count;
+	Emit(count);
+
+	// Move and age every particle, then drop the ones that outlived their lifetime.
+	Integrate(aDeltaTime);
+	RemoveDead();
+
+	// Look up the size for the new ages.
+	ApplyCurves();
+
+	// Find the area the quads will cover, so only that part of the screen has to be redrawn.
+	UpdateBounds();
+}
+
+int ParticleEmitter::WriteQuads(SpriteVertex* aVertices, int aMaxQuads)
+{
+	int count, i;
+	float halfSize, left, right, top, bottom;
+
+	count = myParticleCount < aMaxQuads ? myParticleCount : aMaxQuads;
+
+	for (i = 0; i < count; i++)
+	{
+		// Corners of the quad around the particle.
+		halfSize = mySizes[i] * 0.5f;
+		left = myPositionsX[i] - halfSize;
+		right = myPositionsX[i] + halfSize;
+		bottom = myPositionsY[i] - halfSize;
+		top = myPositionsY[i] + halfSize;
+
+		// Bottom left, top left, bottom right, top right, the same order as the sprite batch.
+		aVertices[0].x = left;
+		aVertices[0].y = bottom;
+		aVertices[0].u = 0;
+		aVertices[0].v = 65535;
+
+		aVertices[1].x = left;
+		aVertices[1].y = top;
+		aVertices[1].u = 0;
+		aVertices[1].v = 0;
+
+		aVertices[2].x = right;
+		aVertices[2].y = bottom;
+		aVertices[2].u = 65535;
+		aVertices[2].v = 65535;
+
+		aVertices[3].x = right;
+		aVertices[3].y = top;
+		aVertices[3].u = 65535;
+		aVertices[3].v = 0;
+
+		aVertices += 4;
+	}
+
+	return count;
+}
+
+int ParticleEmitter::GetParticleCount()
+{
+	return myParticleCount;
+}
+
+bool ParticleEmitter::GetBounds(AABB& aBounds)
+{
+	if (myParticleCount == 0)
+	{
+		return false;
+	}
+	aBounds = myBounds;
+	return true;
+}
+
+const float* ParticleEmitter::GetSizes()
+{
+	return mySizes;
+}
+
+void ParticleEmitter::Emit(int aCount)
+{
+	int i, index;
+	float lifetime, speed, direction, radius, angle;
+
+	// Never spawn more than there is room for.
+	if (aCount > myMaxParticles - myParticleCount)
+	{
+		aCount = myMaxParticles - myParticleCount;
+	}
+
+	for (i = 0; i < aCount; i++)
+	{
+		index = myParticleCount + i;
+
+		// Pick a point in the spawn disc.
+		radius = mySettings.spawnRadius * sqrtf(Random());
+		angle = Random() * 6.28318531f;
+		myPositionsX[index] = mySettings.positionX + radius * cosf(angle);
+		myPositionsY[index] = mySettings.positionY + radius * sinf(angle);
+
+		// Pick a direction and speed inside the configured ranges.
+		direction = mySettings.directionMin + (mySettings.directionMax - mySettings.directionMin) * Random();
+		speed = mySettings.speedMin + (mySettings.speedMax - mySettings.speedMin) * Random();
+		myVelocitiesX[index] = speed * cosf(direction);
+		myVelocitiesY[index] = speed * sinf(direction);
+
+		// Ages are kept normalized, so store how fast this particle ages instead of its lifetime.
+		lifetime = mySettings.lifetimeMin + (mySettings.lifetimeMax - mySettings.lifetimeMin) * Random();
+		myAges[index] = 0.0f;
+		myAgeRates[index] = lifetime > 0.0f ? 1.0f / lifetime : 1.0f;
+	}
+	myParticleCount += aCount;
+}
+
+void ParticleEmitter::Integrate(float aDeltaTime)
+{
+	float damping, gravityX, gravityY;
+	int i;
+
+	// Drag removes a fraction of the velocity every second.
+	damping = 1.0f - mySettings.drag * aDeltaTime;
+	if (damping < 0.0f)
+	{
+		damping = 0.0f;
+	}
+	gravityX = mySettings.gravityX * aDeltaTime;
+	gravityY = mySettings.gravityY * aDeltaTime;
+
+	i = 0;
+
+#ifdef PARTICLE_SIMD
+	__m128 deltaTime4, damping4, gravityX4, gravityY4;
+	__m128 positionX, positionY, velocityX, velocityY, age, ageRate;
+
+	deltaTime4 = _mm_set1_ps(aDeltaTime);
+	damping4 = _mm_set1_ps(damping);
+	gravityX4 = _mm_set1_ps(gravityX);
+	gravityY4 = _mm_set1_ps(gravityY);
+
+	// Four particles at a time, the arrays are padded to a multiple of four.
+	for (; i < myParticleCount; i += 4)
+	{
+		velocityX = _mm_loadu_ps(myVelocitiesX + i);
+		velocityY = _mm_loadu_ps(myVelocitiesY + i);
+		positionX = _mm_loadu_ps(myPositionsX + i);
+		positionY = _mm_loadu_ps(myPositionsY + i);
+		age = _mm_loadu_ps(myAges + i);
+		ageRate = _mm_loadu_ps(myAgeRates + i);
+
+		velocityX = _mm_mul_ps(_mm_add_ps(velocityX, gravityX4), damping4);
+		velocityY = _mm_mul_ps(_mm_add_ps(velocityY, gravityY4), damping4);
+		positionX = _mm_add_ps(positionX, _mm_mul_ps(velocityX, deltaTime4));
+		positionY = _mm_add_ps(positionY, _mm_mul_ps(velocityY, deltaTime4));
+		age = _mm_add_ps(age, _mm_mul_ps(ageRate, deltaTime4));
+
+		_mm_storeu_ps(myVelocitiesX + i, velocityX);
+		_mm_storeu_ps(myVelocitiesY + i, velocityY);
+		_mm_storeu_ps(myPositionsX + i, positionX);
+		_mm_storeu_ps(myPositionsY + i, positionY);
+		_mm_storeu_ps(myAges + i, age);
+	}
+#else
+	for (; i < myParticleCount; i++)
+	{
+		myVelocitiesX[i] = (myVelocitiesX[i] + gravityX) * damping;
+		myVelocitiesY[i] = (myVelocitiesY[i] + gravityY) * damping;
+		myPositionsX[i] += myVelocitiesX[i] * aDeltaTime;
+		myPositionsY[i] += myVelocitiesY[i] * aDeltaTime;
+		myAges[i] += myAgeRates[i] * aDeltaTime;
+	}
+#endif
+}
+
+void ParticleEmitter::RemoveDead()
+{
+	int i, last;
+
+	i = 0;
+	while (i < myParticleCount)
+	{
+		if (myAges[i] < 1.0f)
+		{
+			i++;
+			continue;
+		}
+
+		// Move the last particle into the dead one's slot and check that slot again.
+		last = myParticleCount - 1;
+		myPositionsX[i] = myPositionsX[last];
+		myPositionsY[i] = myPositionsY[last];
+		myVelocitiesX[i] = myVelocitiesX[last];
+		myVelocitiesY[i] = myVelocitiesY[last];
+		myAges[i] = myAges[last];
+		myAgeRates[i] = myAgeRates[last];
+		myParticleCount--;
+	}
+}
+
+void ParticleEmitter::ApplyCurves()
+{
+	int i;
+
+	i = 0;
+
+#ifdef PARTICLE_SIMD
+	__m128 scale, one, zero, age;
+	__m128i samples;
+	int indices[4];
+
+	scale = _mm_set1_ps((float)(PARTICLE_CURVE_SAMPLES - 1));
+	one = _mm_set1_ps(1.0f);
+	zero = _mm_setzero_ps();
+
+	// Turn four ages into table indices at a time, then gather the table entries.
+	for (; i < myParticleCount; i += 4)
+	{
+		age = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(myAges + i), zero), one);
+		samples = _mm_cvttps_epi32(_mm_mul_ps(age, scale));
+		_mm_storeu_si128((__m128i*)indices, samples);
+
+		mySizes[i + 0] = mySizeCurve[indices[0]];
+		mySizes[i + 1] = mySizeCurve[indices[1]];
+		mySizes[i + 2] = mySizeCurve[indices[2]];
+		mySizes[i + 3] = mySizeCurve[indices[3]];
+	}
+#else
+	int sample;
+
+	for (; i < myParticleCount; i++)
+	{
+		sample = (int)(myAges[i] * (float)(PARTICLE_CURVE_SAMPLES - 1));
+		sample = sample < 0 ? 0 : (sample >= PARTICLE_CURVE_SAMPLES ? PARTICLE_CURVE_SAMPLES - 1 : sample);
+		mySizes[i] = mySizeCurve[sample];
+	}
+#endif
+}
+
+float ParticleEmitter::Random()
+{
+	// Xorshift, each emitter has its own state so emitters can update on different threads.
+	myRandomState ^= myRandomState << 13;
+	myRandomState ^= myRandomState >> 17;
+	myRandomState ^= myRandomState << 5;
+
+	return (float)(myRandomState >> 8) * (1.0f / 16777216.0f);
+}
+
+void ParticleEmitter::UpdateBounds()
+{
+	float minX, minY, maxX, maxY, maxSize;
+	int i;
+
+	if (myParticleCount == 0)
+	{
+		return;
+	}
+
+	// Bound the particle centers and pad them by the largest quad instead of bounding every corner.
+	minX = maxX = myPositionsX[0];
+	minY = maxY = myPositionsY[0];
+	maxSize = mySizes[0];
+	for (i = 1; i < myParticleCount; i++)
+	{
+		minX = myPositionsX[i] < minX ? myPositionsX[i] : minX;
+		maxX = myPositionsX[i] > maxX ? myPositionsX[i] : maxX;
+		minY = myPositionsY[i] < minY ? myPositionsY[i] : minY;
+		maxY = myPositionsY[i] > maxY ? myPositionsY[i] : maxY;
+		maxSize = mySizes[i] > maxSize ? mySizes[i] : maxSize;
+	}
+
+	myBounds.minX = minX - maxSize * 0.5f;
+	myBounds.minY = minY - maxSize * 0.5f;
+	myBounds.maxX = maxX + maxSize * 0.5f;
+	myBounds.maxY = maxY + maxSize * 0.5f;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "SpriteVertex.h"
+#include "Collision.h"
+
+const int PARTICLE_CURVE_SAMPLES = 32;
+
+// Pool of particles sharing one set of emission settings.
+// Particles are stored as structure of arrays and integrated four at a time with SSE where it is available.
+// Dead particles are removed by moving the last live particle into their slot, so the live ones stay densely packed.
+class ParticleEmitter
+{
+public:
+	struct Settings
+	{
+		float positionX;
+		float positionY;
+		float spawnRadius;
+		float emissionRate;
+		float lifetimeMin;
+		float lifetimeMax;
+		float speedMin;
+		float speedMax;
+		float directionMin;
+		float directionMax;
+		float gravityX;
+		float gravityY;
+		float drag;
+	};
+
+	ParticleEmitter();
+	ParticleEmitter(const ParticleEmitter& aParticleEmitter) = delete;
+	~ParticleEmitter();
+
+	bool Initialize(const Settings& aSettings, int aMaxParticles, unsigned int aSeed);
+	void Shutdown();
+
+	void SetPosition(float aX, float aY);
+	void SetEmissionRate(float aEmissionRate);
+	void SetSizeCurve(const float* aTimes, const float* aSizes, int aKeyCount);
+
+	void Burst(int aCount);
+	void Update(float aDeltaTime);
+	int WriteQuads(SpriteVertex* aVertices, int aMaxQuads);
+
+	int GetParticleCount();
+	bool GetBounds(AABB& aBounds);
+	const float* GetSizes();
+
+private:
+	void Emit(int aCount);
+	void Integrate(float aDeltaTime);
+	void RemoveDead();
+	void ApplyCurves();
+	void UpdateBounds();
+	float Random();
+
+	Settings mySettings;
+
+	float* myPositionsX;
+	float* myPositionsY;
+	float* myVelocitiesX;
+	float* myVelocitiesY;
+	float* myAges;
+	float* myAgeRates;
+	float* mySizes;
+
+	float mySizeCurve[PARTICLE_CURVE_SAMPLES];
+
+	AABB myBounds;
+
+	float myEmissionAccumulator;
+	unsigned int myRandomState;
+	int myParticleCount;
+	int myMaxParticles;
+};
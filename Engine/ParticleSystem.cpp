@@ -0,0 +1,150 @@
+#include "ParticleSystem.h"
+#include "AllocationTracker.h"
+
+ParticleSystem::ParticleSystem()
+{
+	myJobSystem = nullptr;
+	myWriteVertices = nullptr;
+	myWriteMaxQuads = 0;
+}
+
+ParticleSystem::~ParticleSystem()
+{
+}
+
+bool ParticleSystem::Initialize(JobSystem& aJobSystem)
+{
+	myJobSystem = &aJobSystem;
+	return true;
+}
+
+void ParticleSystem::Shutdown()
+{
+	unsigned int i;
+
+	// Release the emitters.
+	for (i = 0; i < myEmitters.size(); i++)
+	{
+		myEmitters[i]->Shutdown();
+		delete myEmitters[i];
+	}
+	myEmitters.clear();
+	myQuadOffsets.clear();
+
+	myJobSystem = nullptr;
+}
+
+int ParticleSystem::AddEmitter(const ParticleEmitter::Settings& aSettings, int aMaxParticles)
+{
+	ParticleEmitter* emitter;
+	bool result;
+
+	// Create the emitter object.
+	emitter = new ParticleEmitter;
+	if (!emitter)
+	{
+		return -1;
+	}
+
+	// Initialize the emitter object, every emitter gets its own random sequence.
+	result = emitter->Initialize(aSettings, aMaxParticles, 0x9E3779B9u * (unsigned int)(myEmitters.size() + 1));
+	if (!result)
+	{
+		delete emitter;
+		return -1;
+	}
+
+	myEmitters.push_back(emitter);
+	return (int)myEmitters.size() - 1;
+}
+
+ParticleEmitter* ParticleSystem::GetEmitter(int aEmitter)
+{
+	if (aEmitter < 0 || aEmitter >= (int)myEmitters.size())
+	{
+		return nullptr;
+	}
+	return myEmitters[aEmitter];
+}
+
+void ParticleSystem::Update(float aDeltaTime)
+{
+	ALLOCATION_SCOPE("Particles");
+
+	// Update every emitter on whichever thread picks it up.
+	myJobSystem->ParallelFor((int)myEmitters.size(), [this, aDeltaTime](int aEmitter)
+	{
+		myEmitters[aEmitter]->Update(aDeltaTime);
+	});
+}
+
+int ParticleSystem::WriteQuads(SpriteVertex* aVertices, int aMaxQuads)
+{
+	unsigned int i;
+	int total, count;
+
+	ALLOCATION_SCOPE("Particles");
+
+	// Give every emitter its own range of the output so they can all write at once.
+	myQuadOffsets.resize(myEmitters.size());
+	total = 0;
+	for (i = 0; i < myEmitters.size(); i++)
+	{
+		myQuadOffsets[i] = total;
+		count = myEmitters[i]->GetParticleCount();
+		if (count > aMaxQuads - total)
+		{
+			count = aMaxQuads - total;
+		}
+		total += count;
+	}
+
+	// The job only captures this so the function object fits without a heap allocation.
+	myWriteVertices = aVertices;
+	myWriteMaxQuads = aMaxQuads;
+	myJobSystem->ParallelFor((int)myEmitters.size(), [this](int aEmitter)
+	{
+		myEmitters[aEmitter]->WriteQuads(myWriteVertices + myQuadOffsets[aEmitter] * 4, myWriteMaxQuads - myQuadOffsets[aEmitter]);
+	});
+	myWriteVertices = nullptr;
+
+	return total;
+}
+
+int ParticleSystem::GetParticleCount()
+{
+	unsigned int i;
+	int count;
+
+	count = 0;
+	for (i = 0; i < myEmitters.size(); i++)
+	{
+		count += myEmitters[i]->GetParticleCount();
+	}
+	return count;
+}
+
+bool ParticleSystem::GetBounds(AABB& aBounds)
+{
+	unsigned int i;
+	AABB bounds;
+	bool found;
+
+	// Merge the bounds of the emitters that have live particles.
+	found = false;
+	for (i = 0; i < myEmitters.size(); i++)
+	{
+		if (!myEmitters[i]->GetBounds(bounds))
+		{
+			continue;
+		}
+		if (!found)
+		{
+			aBounds = bounds;
+			found = true;
+			continue;
+		}
+		MergeBoxes(aBounds, bounds);
+	}
+	return found;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+#include "JobSystem.h"
+#include "ParticleEmitter.h"
+
+// Owns the particle emitters of the scene.
+// Emitters are independent of each other, so they are updated and written out in parallel on the job system.
+class ParticleSystem
+{
+public:
+	ParticleSystem();
+	ParticleSystem(const ParticleSystem& aParticleSystem) = delete;
+	~ParticleSystem();
+
+	bool Initialize(JobSystem& aJobSystem);
+	void Shutdown();
+
+	int AddEmitter(const ParticleEmitter::Settings& aSettings, int aMaxParticles);
+	ParticleEmitter* GetEmitter(int aEmitter);
+
+	void Update(float aDeltaTime);
+	int WriteQuads(SpriteVertex* aVertices, int aMaxQuads);
+
+	int GetParticleCount();
+	bool GetBounds(AABB& aBounds);
+
+private:
+	JobSystem* myJobSystem;
+	std::vector<ParticleEmitter*> myEmitters;
+	std::vector<int> myQuadOffsets;
+	SpriteVertex* myWriteVertices;
+	int myWriteMaxQuads;
+};
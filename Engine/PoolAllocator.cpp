@@ -0,0 +1,157 @@
+#include "PoolAllocator.h"
+#include "AllocationTracker.h"
+#include <string.h>
+
+// Blocks are aligned for any SSE type.
+static const size_t POOL_ALIGNMENT = 16;
+
+// Fill patterns of debug builds, the same bytes the debug heap uses.
+static const unsigned char ALLOCATED_FILL = 0xcd;
+static const unsigned char RELEASED_FILL = 0xdd;
+
+PoolAllocator::PoolAllocator()
+{
+	myMemory = nullptr;
+	myFirstBlock = nullptr;
+	myFreeList = nullptr;
+	myBlockSize = 0;
+	myBlockCount = 0;
+	myUsedCount = 0;
+	myHighWaterMark = 0;
+}
+
+PoolAllocator::~PoolAllocator()
+{
+}
+
+bool PoolAllocator::Initialize(size_t aBlockSize, int aBlockCount)
+{
+	int i;
+	FreeBlock* block;
+
+	if (aBlockSize == 0 || aBlockCount <= 0)
+	{
+		return false;
+	}
+
+	// Every block has to be able to hold the free list link and keep the next block aligned.
+	if (aBlockSize < sizeof(FreeBlock))
+	{
+		aBlockSize = sizeof(FreeBlock);
+	}
+	myBlockSize = (aBlockSize + POOL_ALIGNMENT - 1) & ~(POOL_ALIGNMENT - 1);
+	myBlockCount = aBlockCount;
+
+	// Create the blocks in one array.
+	myMemory = new unsigned char[myBlockSize * myBlockCount + POOL_ALIGNMENT];
+	if (!myMemory)
+	{
+		return false;
+	}
+
+#ifdef _DEBUG
+	memset(myMemory, RELEASED_FILL, myBlockSize * myBlockCount + POOL_ALIGNMENT);
+#endif
+
+	// Link the blocks in address order so the first allocations are next to each other.
+	myFirstBlock = (unsigned char*)(((size_t)myMemory + POOL_ALIGNMENT - 1) & ~(POOL_ALIGNMENT - 1));
+	myFreeList = nullptr;
+	for (i = myBlockCount - 1; i >= 0; i--)
+	{
+		block = (FreeBlock*)(myFirstBlock + myBlockSize * i);
+		block->next = myFreeList;
+		myFreeList = block;
+	}
+	myUsedCount = 0;
+	myHighWaterMark = 0;
+
+	return true;
+}
+
+void PoolAllocator::Shutdown()
+{
+	// Release the blocks.
+	delete[] myMemory;
+	myMemory = nullptr;
+	myFirstBlock = nullptr;
+	myFreeList = nullptr;
+
+	myBlockCount = 0;
+	myUsedCount = 0;
+}
+
+void* PoolAllocator::Allocate()
+{
+	FreeBlock* block;
+
+	// Out of blocks.
+	if (myFreeList == nullptr)
+	{
+		return nullptr;
+	}
+
+	// Take the first free block.
+	block = myFreeList;
+	myFreeList = block->next;
+
+	myUsedCount++;
+#ifdef ALLOCATION_TRACKING
+	AllocationTracker::RecordEngineAllocation(myBlockSize);
+#endif
+	if (myUsedCount > myHighWaterMark)
+	{
+		myHighWaterMark = myUsedCount;
+	}
+
+#ifdef _DEBUG
+	memset(block, ALLOCATED_FILL, myBlockSize);
+#endif
+
+	return block;
+}
+
+void PoolAllocator::Free(void* aBlock)
+{
+	FreeBlock* block;
+
+	if (aBlock == nullptr)
+	{
+		return;
+	}
+
+#ifdef _DEBUG
+	memset(aBlock, RELEASED_FILL, myBlockSize);
+#endif
+
+	// Put the block at the front of the free list, it is the one most likely still in the cache.
+	block = (FreeBlock*)aBlock;
+	block->next = myFreeList;
+	myFreeList = block;
+
+	myUsedCount--;
+}
+
+bool PoolAllocator::Owns(const void* aBlock)
+{
+	return (const unsigned char*)aBlock >= myFirstBlock && (const unsigned char*)aBlock < myFirstBlock + myBlockSize * myBlockCount;
+}
+
+size_t PoolAllocator::GetBlockSize()
+{
+	return myBlockSize;
+}
+
+int PoolAllocator::GetBlockCount()
+{
+	return myBlockCount;
+}
+
+int PoolAllocator::GetUsedCount()
+{
+	return myUsedCount;
+}
+
+int PoolAllocator::GetHighWaterMark()
+{
+	return myHighWaterMark;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stddef.h>
+
+// Hands out blocks of one fixed size from a single preallocated array, for objects that are created and destroyed
+// often. Free blocks are linked through their own first bytes, so allocating and freeing are a couple of pointer moves.
+// Debug builds fill handed out blocks with 0xcd and freed blocks with 0xdd. Not thread safe.
+class PoolAllocator
+{
+public:
+	PoolAllocator();
+	PoolAllocator(const PoolAllocator& aPoolAllocator) = delete;
+	~PoolAllocator();
+
+	bool Initialize(size_t aBlockSize, int aBlockCount);
+	void Shutdown();
+
+	void* Allocate();
+	void Free(void* aBlock);
+	bool Owns(const void* aBlock);
+
+	size_t GetBlockSize();
+	int GetBlockCount();
+	int GetUsedCount();
+	int GetHighWaterMark();
+
+private:
+	struct FreeBlock
+	{
+		FreeBlock* next;
+	};
+
+	unsigned char* myMemory;
+	unsigned char* myFirstBlock;
+	FreeBlock* myFreeList;
+	size_t myBlockSize;
+	int myBlockCount;
+	int myUsedCount;
+	int myHighWaterMark;
+};
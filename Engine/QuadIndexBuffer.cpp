@@ -0,0 +1,77 @@
+#include "QuadIndexBuffer.h"
+#include "ScratchArena.h"
+
+QuadIndexBuffer::QuadIndexBuffer()
+{
+	myIndexBuffer = nullptr;
+}
+
+QuadIndexBuffer::~QuadIndexBuffer()
+{
+}
+
+bool QuadIndexBuffer::Initialize(ID3D11Device& aDevice)
+{
+	unsigned short* indices;
+	D3D11_BUFFER_DESC indexBufferDesc;
+	D3D11_SUBRESOURCE_DATA indexData;
+	HRESULT result;
+	ScratchArena scratch;
+	int i;
+
+	// Create the index array in scratch memory.
+	indices = scratch.AllocateArray<unsigned short>(QUAD_INDEX_BUFFER_QUADS * 6);
+	if (!indices)
+	{
+		return false;
+	}
+
+	// Two triangles per quad over its corners bottom left, top left, bottom right, top right.
+	for (i = 0; i < QUAD_INDEX_BUFFER_QUADS; i++)
+	{
+		indices[i * 6 + 0] = (unsigned short)(i * 4 + 0);
+		indices[i * 6 + 1] = (unsigned short)(i * 4 + 1);
+		indices[i * 6 + 2] = (unsigned short)(i * 4 + 2);
+		indices[i * 6 + 3] = (unsigned short)(i * 4 + 2);
+		indices[i * 6 + 4] = (unsigned short)(i * 4 + 1);
+		indices[i * 6 + 5] = (unsigned short)(i * 4 + 3);
+	}
+
+	// Set up the description of the immutable index buffer.
+	indexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+	indexBufferDesc.ByteWidth = sizeof(unsigned short) * QUAD_INDEX_BUFFER_QUADS * 6;
+	indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+	indexBufferDesc.CPUAccessFlags = 0;
+	indexBufferDesc.MiscFlags = 0;
+	indexBufferDesc.StructureByteStride = 0;
+
+	// Give the subresource structure a pointer to the index data.
+	indexData.pSysMem = indices;
+	indexData.SysMemPitch = 0;
+	indexData.SysMemSlicePitch = 0;
+
+	// Create the index buffer.
+	result = aDevice.CreateBuffer(&indexBufferDesc, &indexData, &myIndexBuffer);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void QuadIndexBuffer::Shutdown()
+{
+	// Release the index buffer.
+	if (myIndexBuffer != nullptr)
+	{
+		myIndexBuffer->Release();
+		myIndexBuffer = nullptr;
+	}
+}
+
+void QuadIndexBuffer::Render(ID3D11DeviceContext& aDeviceContext)
+{
+	// Set the index buffer to active in the input assembler.
+	aDeviceContext.IASetIndexBuffer(myIndexBuffer, DXGI_FORMAT_R16_UINT, 0);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <d3d11.h>
+
+// Quads one 16 bit index buffer can address, 65536 vertices.
+const int QUAD_INDEX_BUFFER_QUADS = 16384;
+
+// One immutable 16 bit index buffer holding the two triangles of every quad in order, shared by all quad geometry
+// so sprite, particle, tilemap and text buffers only carry vertices. Draws of more quads than it addresses are
+// split by the shader into spans that start at a higher base vertex.
+class QuadIndexBuffer
+{
+public:
+	QuadIndexBuffer();
+	QuadIndexBuffer(const QuadIndexBuffer& aQuadIndexBuffer) = delete;
+	~QuadIndexBuffer();
+
+	bool Initialize(ID3D11Device& aDevice);
+	void Shutdown();
+
+	void Render(ID3D11DeviceContext& aDeviceContext);
+
+private:
+	ID3D11Buffer* myIndexBuffer;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <algorithm>
+#include "Handle.h"
+#include "Material.h"
+
+class Model;
+class Shader;
+class Camera;
+struct ID3D11ShaderResourceView;
+
+typedef Handle<Model*> ModelHandle;
+typedef Handle<Shader*> ShaderHandle;
+typedef Handle<Camera*> CameraHandle;
+typedef Handle<ID3D11ShaderResourceView*> TextureHandle;
+
+// One draw of a model with a shader and texture. Plain data and 24 bytes, so a frame's worth of commands
+// can be recorded into a flat array, sorted by key and copied around without touching the resources themselves.
+struct RenderCommand
+{
+	unsigned long long sortKey;
+	ShaderHandle shader;
+	TextureHandle texture;
+	ModelHandle model;
+};
+
+// Bits of the sort key given to the texture and model index, the shader index takes the rest of the low 32 bits.
+const unsigned int SORT_KEY_TEXTURE_BITS = 12;
+const unsigned int SORT_KEY_MODEL_BITS = 12;
+
+// Bits of the sort key above the resources: the material, the depth and whether the command belongs to the translucent pass.
+const unsigned int SORT_KEY_MATERIAL_SHIFT = 32;
+const unsigned int SORT_KEY_DEPTH_SHIFT = 34;
+const unsigned int SORT_KEY_DEPTH_BITS = 24;
+const unsigned int SORT_KEY_TRANSLUCENT_SHIFT = 63;
+
+// Builds the key from the material, the depth between the near plane at 0 and the far plane at 1, and the slot indices.
+// Opaque and alpha tested commands come first, nearest first so they hide what is drawn after them. Translucent commands
+// follow farthest first, so each one blends over what is behind it. Commands at the same depth are grouped by material
+// and resources, the low bits of an index being enough to group equal resources.
+inline unsigned long long MakeSortKey(MaterialType aMaterial, float aDepth, ShaderHandle aShader, TextureHandle aTexture, ModelHandle aModel)
+{
+	unsigned long long depth, key;
+
+	aDepth = aDepth < 0.0f ? 0.0f : (aDepth > 1.0f ? 1.0f : aDepth);
+	depth = (unsigned long long)(aDepth * (float)((1u << SORT_KEY_DEPTH_BITS) - 1));
+	key = (aShader.GetIndex() << (SORT_KEY_TEXTURE_BITS + SORT_KEY_MODEL_BITS)) |
+		((aTexture.GetIndex() & ((1u << SORT_KEY_TEXTURE_BITS) - 1)) << SORT_KEY_MODEL_BITS) |
+		(aModel.GetIndex() & ((1u << SORT_KEY_MODEL_BITS) - 1));
+	key |= (unsigned long long)aMaterial << SORT_KEY_MATERIAL_SHIFT;
+	if (aMaterial == MATERIAL_TRANSLUCENT)
+	{
+		depth = ((1u << SORT_KEY_DEPTH_BITS) - 1) - depth;
+		key |= 1ull << SORT_KEY_TRANSLUCENT_SHIFT;
+	}
+	return key | (depth << SORT_KEY_DEPTH_SHIFT);
+}
+
+// Tells whether a key belongs to the translucent pass.
+inline bool IsTranslucentSortKey(unsigned long long aSortKey)
+{
+	return (aSortKey >> SORT_KEY_TRANSLUCENT_SHIFT) != 0;
+}
+
+// Tells the material a key was built with.
+inline MaterialType GetSortKeyMaterial(unsigned long long aSortKey)
+{
+	return (MaterialType)((aSortKey >> SORT_KEY_MATERIAL_SHIFT) & 3);
+}
+
+// Orders commands by pass and depth, then material, shader, texture and model.
+inline void SortRenderCommands(RenderCommand* aCommands, int aCount)
+{
+	std::sort(aCommands, aCommands + aCount, [](const RenderCommand& aLeft, const RenderCommand& aRight)
+	{
+		return aLeft.sortKey < aRight.sortKey;
+	});
+}
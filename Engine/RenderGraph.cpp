@@ -0,0 +1,517 @@
+#include "RenderGraph.h"
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+RenderGraph::RenderGraph()
+{
+	myCompiled = false;
+	memset(&myStats, 0, sizeof(myStats));
+}
+
+RenderGraph::~RenderGraph()
+{
+}
+
+bool RenderGraph::Initialize()
+{
+	Reset();
+
+	return true;
+}
+
+void RenderGraph::Shutdown()
+{
+	Reset();
+}
+
+void RenderGraph::Reset()
+{
+	// Forget the declarations, a frame whose passes change declares them again and compiles anew.
+	myResources.clear();
+	myPasses.clear();
+	myOrder.clear();
+	myTargets.clear();
+	myTargetEnds.clear();
+	myCommands.clear();
+	myCompiled = false;
+	memset(&myStats, 0, sizeof(myStats));
+}
+
+int RenderGraph::CreateTexture(const char* aName, const RenderGraphTextureDesc& aDesc)
+{
+	Resource resource;
+
+	if (aName == nullptr || aDesc.width <= 0 || aDesc.height <= 0 || aDesc.bytesPerTexel <= 0)
+	{
+		return -1;
+	}
+	snprintf(resource.name, sizeof(resource.name), "%s", aName);
+	resource.desc = aDesc;
+	resource.imported = false;
+	resource.firstUse = -1;
+	resource.lastUse = -1;
+	resource.target = -1;
+	myResources.push_back(resource);
+	myCompiled = false;
+
+	return (int)myResources.size() - 1;
+}
+
+int RenderGraph::ImportTexture(const char* aName, const RenderGraphTextureDesc& aDesc)
+{
+	int resource;
+
+	resource = CreateTexture(aName, aDesc);
+	if (resource >= 0)
+	{
+		myResources[resource].imported = true;
+	}
+	return resource;
+}
+
+int RenderGraph::AddPass(const char* aName, const std::function<void()>& aExecute)
+{
+	Pass pass;
+
+	if (aName == nullptr)
+	{
+		return -1;
+	}
+	snprintf(pass.name, sizeof(pass.name), "%s", aName);
+	pass.execute = aExecute;
+	pass.kept = false;
+	pass.culled = false;
+	pass.order = -1;
+	myPasses.push_back(pass);
+	myCompiled = false;
+
+	return (int)myPasses.size() - 1;
+}
+
+void RenderGraph::Read(int aPass, int aResource)
+{
+	if (aPass < 0 || aPass >= (int)myPasses.size() || aResource < 0 || aResource >= (int)myResources.size() ||
+		Uses(myPasses[aPass].reads, aResource))
+	{
+		return;
+	}
+	myPasses[aPass].reads.push_back(aResource);
+	myCompiled = false;
+}
+
+void RenderGraph::Write(int aPass, int aResource)
+{
+	if (aPass < 0 || aPass >= (int)myPasses.size() || aResource < 0 || aResource >= (int)myResources.size() ||
+		Uses(myPasses[aPass].writes, aResource))
+	{
+		return;
+	}
+	myPasses[aPass].writes.push_back(aResource);
+	myCompiled = false;
+}
+
+void RenderGraph::KeepPass(int aPass)
+{
+	// For passes whose work is seen outside the graph, like a readback or a query, and would otherwise look unused.
+	if (aPass >= 0 && aPass < (int)myPasses.size())
+	{
+		myPasses[aPass].kept = true;
+		myCompiled = false;
+	}
+}
+
+bool RenderGraph::Compile()
+{
+	std::chrono::high_resolution_clock::time_point start, end;
+	unsigned int i;
+
+	start = std::chrono::high_resolution_clock::now();
+	myCompiled = false;
+
+	CullPasses();
+	if (!OrderPasses())
+	{
+		return false;
+	}
+	PlaceResources();
+	RecordCommands();
+
+	// Sum up what the aliasing saved against giving every transient texture memory of its own.
+	myStats.passCount = (int)myPasses.size();
+	myStats.culledPassCount = myStats.passCount - (int)myOrder.size();
+	myStats.resourceCount = (int)myResources.size();
+	myStats.transientCount = 0;
+	myStats.transientBytes = 0;
+	for (i = 0; i < myResources.size(); i++)
+	{
+		if (myResources[i].target >= 0)
+		{
+			myStats.transientCount++;
+			myStats.transientBytes += (long long)myResources[i].desc.width * myResources[i].desc.height * myResources[i].desc.bytesPerTexel;
+		}
+	}
+	myStats.targetCount = (int)myTargets.size();
+	myStats.targetBytes = 0;
+	for (i = 0; i < myTargets.size(); i++)
+	{
+		myStats.targetBytes += (long long)myTargets[i].width * myTargets[i].height * myTargets[i].bytesPerTexel;
+	}
+
+	end = std::chrono::high_resolution_clock::now();
+	myStats.compileTime = std::chrono::duration<float, std::milli>(end - start).count();
+	myCompiled = true;
+
+	return true;
+}
+
+bool RenderGraph::Execute(RenderGraphBackend& aBackend)
+{
+	unsigned int i;
+
+	if (!myCompiled || !aBackend.CreateTargets(myTargets.data(), (int)myTargets.size()))
+	{
+		return false;
+	}
+
+	// Run the passes in order, telling the backend when each transient texture moves into and out of its target.
+	for (i = 0; i < myCommands.size(); i++)
+	{
+		switch (myCommands[i].type)
+		{
+		case COMMAND_ACQUIRE:
+			aBackend.Acquire(myCommands[i].index, myCommands[i].target);
+			break;
+		case COMMAND_PASS:
+			aBackend.BeginPass(myCommands[i].index);
+			if (myPasses[myCommands[i].index].execute)
+			{
+				myPasses[myCommands[i].index].execute();
+			}
+			break;
+		case COMMAND_RELEASE:
+			aBackend.Release(myCommands[i].index, myCommands[i].target);
+			break;
+		}
+	}
+
+	return true;
+}
+
+const RenderGraph::Command* RenderGraph::GetCommands(int& aCount)
+{
+	aCount = (int)myCommands.size();
+	return myCommands.data();
+}
+
+const RenderGraphTextureDesc* RenderGraph::GetTargets(int& aCount)
+{
+	aCount = (int)myTargets.size();
+	return myTargets.data();
+}
+
+int RenderGraph::GetTarget(int aResource)
+{
+	if (aResource < 0 || aResource >= (int)myResources.size())
+	{
+		return -1;
+	}
+	return myResources[aResource].target;
+}
+
+bool RenderGraph::IsCulled(int aPass)
+{
+	if (aPass < 0 || aPass >= (int)myPasses.size())
+	{
+		return true;
+	}
+	return myPasses[aPass].culled;
+}
+
+void RenderGraph::GetLifetime(int aResource, int& aFirstPass, int& aLastPass)
+{
+	// The passes that first and last use the texture, -1 when no pass that was kept uses it.
+	aFirstPass = -1;
+	aLastPass = -1;
+	if (aResource >= 0 && aResource < (int)myResources.size() && myResources[aResource].firstUse >= 0)
+	{
+		aFirstPass = myOrder[myResources[aResource].firstUse];
+		aLastPass = myOrder[myResources[aResource].lastUse];
+	}
+}
+
+const char* RenderGraph::GetPassName(int aPass)
+{
+	if (aPass < 0 || aPass >= (int)myPasses.size())
+	{
+		return "";
+	}
+	return myPasses[aPass].name;
+}
+
+const char* RenderGraph::GetResourceName(int aResource)
+{
+	if (aResource < 0 || aResource >= (int)myResources.size())
+	{
+		return "";
+	}
+	return myResources[aResource].name;
+}
+
+void RenderGraph::GetStats(Stats& aStats)
+{
+	aStats = myStats;
+}
+
+void RenderGraph::CullPasses()
+{
+	std::vector<bool> needed;
+	unsigned int i;
+	int pass;
+	bool used;
+
+	// What is in the imported textures at the end of the frame is needed, nothing transient is.
+	needed.resize(myResources.size());
+	for (i = 0; i < myResources.size(); i++)
+	{
+		needed[i] = myResources[i].imported;
+	}
+
+	// Walk back from the end of the frame. A pass is kept when it writes something still needed, and then what it writes is no
+	// longer needed from earlier passes while what it reads is. A pass that reads what it writes keeps the passes before it.
+	for (pass = (int)myPasses.size() - 1; pass >= 0; pass--)
+	{
+		used = myPasses[pass].kept;
+		for (i = 0; i < myPasses[pass].writes.size(); i++)
+		{
+			used = used || needed[myPasses[pass].writes[i]];
+		}
+		myPasses[pass].culled = !used;
+		if (!used)
+		{
+			continue;
+		}
+		for (i = 0; i < myPasses[pass].writes.size(); i++)
+		{
+			needed[myPasses[pass].writes[i]] = false;
+		}
+		for (i = 0; i < myPasses[pass].reads.size(); i++)
+		{
+			needed[myPasses[pass].reads[i]] = true;
+		}
+	}
+}
+
+bool RenderGraph::OrderPasses()
+{
+	std::vector<std::vector<int>> before;
+	std::vector<bool> written, done;
+	unsigned int i, j, k;
+	int pass, best, bestLatest, latest, remaining;
+
+	// A transient texture must be written before it is read, or the pass reads what another texture left in the target.
+	written.resize(myResources.size());
+	for (i = 0; i < myResources.size(); i++)
+	{
+		written[i] = myResources[i].imported;
+	}
+	for (i = 0; i < myPasses.size(); i++)
+	{
+		if (myPasses[i].culled)
+		{
+			continue;
+		}
+		for (j = 0; j < myPasses[i].reads.size(); j++)
+		{
+			if (!written[myPasses[i].reads[j]])
+			{
+				return false;
+			}
+		}
+		for (j = 0; j < myPasses[i].writes.size(); j++)
+		{
+			written[myPasses[i].writes[j]] = true;
+		}
+	}
+
+	// A pass has to come after the earlier passes that write what it uses, and after those that read what it writes.
+	before.resize(myPasses.size());
+	for (i = 0; i < myPasses.size(); i++)
+	{
+		if (myPasses[i].culled)
+		{
+			continue;
+		}
+		for (j = 0; j < i; j++)
+		{
+			if (myPasses[j].culled)
+			{
+				continue;
+			}
+			for (k = 0; k < myPasses[j].writes.size(); k++)
+			{
+				if (Uses(myPasses[i].reads, myPasses[j].writes[k]) || Uses(myPasses[i].writes, myPasses[j].writes[k]))
+				{
+					break;
+				}
+			}
+			if (k == myPasses[j].writes.size())
+			{
+				for (k = 0; k < myPasses[j].reads.size(); k++)
+				{
+					if (Uses(myPasses[i].writes, myPasses[j].reads[k]))
+					{
+						break;
+					}
+				}
+				if (k == myPasses[j].reads.size())
+				{
+					continue;
+				}
+			}
+			before[i].push_back((int)j);
+		}
+	}
+
+	// Of the passes that are ready, run the one that uses what was made most recently, so a texture is read right after it is
+	// written and its target is free again sooner. Ties go in the order the passes were declared.
+	myOrder.clear();
+	done.resize(myPasses.size());
+	remaining = 0;
+	for (i = 0; i < myPasses.size(); i++)
+	{
+		done[i] = myPasses[i].culled;
+		myPasses[i].order = -1;
+		remaining += myPasses[i].culled ? 0 : 1;
+	}
+	while (remaining > 0)
+	{
+		best = -1;
+		bestLatest = -2;
+		for (pass = 0; pass < (int)myPasses.size(); pass++)
+		{
+			if (done[pass])
+			{
+				continue;
+			}
+			latest = -1;
+			for (j = 0; j < before[pass].size(); j++)
+			{
+				if (!done[before[pass][j]])
+				{
+					break;
+				}
+				latest = myPasses[before[pass][j]].order > latest ? myPasses[before[pass][j]].order : latest;
+			}
+			if (j == before[pass].size() && latest > bestLatest)
+			{
+				best = pass;
+				bestLatest = latest;
+			}
+		}
+		myPasses[best].order = (int)myOrder.size();
+		myOrder.push_back(best);
+		done[best] = true;
+		remaining--;
+	}
+
+	return true;
+}
+
+void RenderGraph::PlaceResources()
+{
+	const Pass* pass;
+	Resource* resource;
+	unsigned int i, j;
+	int position, target;
+
+	// A texture lives from the first pass that uses it to the last, in the order the passes run.
+	for (i = 0; i < myResources.size(); i++)
+	{
+		myResources[i].firstUse = -1;
+		myResources[i].lastUse = -1;
+		myResources[i].target = -1;
+	}
+	for (position = 0; position < (int)myOrder.size(); position++)
+	{
+		pass = &myPasses[myOrder[position]];
+		for (j = 0; j < pass->reads.size() + pass->writes.size(); j++)
+		{
+			resource = &myResources[j < pass->reads.size() ? pass->reads[j] : pass->writes[j - pass->reads.size()]];
+			resource->firstUse = resource->firstUse < 0 ? position : resource->firstUse;
+			resource->lastUse = position;
+		}
+	}
+
+	// Place the transient textures as their lifetimes start, each in a target of the same size and format whose last texture
+	// was released by an earlier pass, or in a new target when none is free.
+	myTargets.clear();
+	myTargetEnds.clear();
+	for (position = 0; position < (int)myOrder.size(); position++)
+	{
+		for (i = 0; i < myResources.size(); i++)
+		{
+			resource = &myResources[i];
+			if (resource->imported || resource->firstUse != position)
+			{
+				continue;
+			}
+			for (target = 0; target < (int)myTargets.size(); target++)
+			{
+				if (myTargetEnds[target] < position && myTargets[target].width == resource->desc.width &&
+					myTargets[target].height == resource->desc.height && myTargets[target].format == resource->desc.format)
+				{
+					break;
+				}
+			}
+			if (target == (int)myTargets.size())
+			{
+				myTargets.push_back(resource->desc);
+				myTargetEnds.push_back(-1);
+			}
+			resource->target = target;
+			myTargetEnds[target] = resource->lastUse;
+		}
+	}
+}
+
+void RenderGraph::RecordCommands()
+{
+	unsigned int i;
+	int position;
+
+	// Each pass is preceded by the textures it starts using and followed by those it is the last to use.
+	myCommands.clear();
+	for (position = 0; position < (int)myOrder.size(); position++)
+	{
+		for (i = 0; i < myResources.size(); i++)
+		{
+			if (myResources[i].target >= 0 && myResources[i].firstUse == position)
+			{
+				myCommands.push_back({ COMMAND_ACQUIRE, (int)i, myResources[i].target });
+			}
+		}
+		myCommands.push_back({ COMMAND_PASS, myOrder[position], -1 });
+		for (i = 0; i < myResources.size(); i++)
+		{
+			if (myResources[i].target >= 0 && myResources[i].lastUse == position)
+			{
+				myCommands.push_back({ COMMAND_RELEASE, (int)i, myResources[i].target });
+			}
+		}
+	}
+}
+
+bool RenderGraph::Uses(const std::vector<int>& aResources, int aResource)
+{
+	unsigned int i;
+
+	for (i = 0; i < aResources.size(); i++)
+	{
+		if (aResources[i] == aResource)
+		{
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+const int RENDER_GRAPH_NAME_LENGTH = 32;
+
+// Size and format of a texture of the render graph. The format is the DXGI format as a plain number, so the graph builds
+// without the graphics headers, and the bytes per texel are only used to report memory.
+struct RenderGraphTextureDesc
+{
+	int width;
+	int height;
+	int format;
+	int bytesPerTexel;
+};
+
+// Carries out the command stream of a compiled render graph. Targets are the physical textures the transient resources
+// are placed in, a target holds a new resource whenever one is acquired and its contents are undefined until it is drawn.
+class RenderGraphBackend
+{
+public:
+	virtual ~RenderGraphBackend() {}
+
+	virtual bool CreateTargets(const RenderGraphTextureDesc* aTargets, int aCount) = 0;
+	virtual void Acquire(int aResource, int aTarget) = 0;
+	virtual void BeginPass(int aPass) = 0;
+	virtual void Release(int aResource, int aTarget) = 0;
+};
+
+// A frame declared as passes that read and write named textures, instead of render targets managed by hand.
+// Compiling culls the passes nothing that is kept depends on, orders the rest so each transient texture lives as briefly
+// as its readers allow, and places transient textures whose lifetimes do not overlap in the same target when they have
+// the same size and format. Direct3D 11 can not alias memory across formats, so sharing a target is how the memory is saved.
+// Imported textures, like the back buffer or a cached layer, live outside the frame: what is last written to them is kept, and
+// they are never placed in a target. A pass that draws onto what an earlier pass left reads the texture as well as writing it.
+// Compiling touches no graphics API, so it runs headless with a backend that only records the commands.
+class RenderGraph
+{
+public:
+	enum CommandType
+	{
+		COMMAND_ACQUIRE,
+		COMMAND_PASS,
+		COMMAND_RELEASE
+	};
+
+	// A pass to run, or a transient resource whose lifetime starts or ends in its target.
+	struct Command
+	{
+		CommandType type;
+		int index;
+		int target;
+	};
+
+	struct Stats
+	{
+		int passCount;
+		int culledPassCount;
+		int resourceCount;
+		int transientCount;
+		int targetCount;
+		long long transientBytes;
+		long long targetBytes;
+		float compileTime;
+	};
+
+	RenderGraph();
+	RenderGraph(const RenderGraph& aRenderGraph) = delete;
+	~RenderGraph();
+
+	bool Initialize();
+	void Shutdown();
+
+	void Reset();
+	int CreateTexture(const char* aName, const RenderGraphTextureDesc& aDesc);
+	int ImportTexture(const char* aName, const RenderGraphTextureDesc& aDesc);
+	int AddPass(const char* aName, const std::function<void()>& aExecute);
+	void Read(int aPass, int aResource);
+	void Write(int aPass, int aResource);
+	void KeepPass(int aPass);
+
+	bool Compile();
+	bool Execute(RenderGraphBackend& aBackend);
+
+	const Command* GetCommands(int& aCount);
+	const RenderGraphTextureDesc* GetTargets(int& aCount);
+	int GetTarget(int aResource);
+	bool IsCulled(int aPass);
+	void GetLifetime(int aResource, int& aFirstPass, int& aLastPass);
+	const char* GetPassName(int aPass);
+	const char* GetResourceName(int aResource);
+	void GetStats(Stats& aStats);
+
+private:
+	struct Resource
+	{
+		char name[RENDER_GRAPH_NAME_LENGTH];
+		RenderGraphTextureDesc desc;
+		bool imported;
+		int firstUse;
+		int lastUse;
+		int target;
+	};
+
+	struct Pass
+	{
+		char name[RENDER_GRAPH_NAME_LENGTH];
+		std::function<void()> execute;
+		std::vector<int> reads;
+		std::vector<int> writes;
+		bool kept;
+		bool culled;
+		int order;
+	};
+
+	void CullPasses();
+	bool OrderPasses();
+	void PlaceResources();
+	void RecordCommands();
+	static bool Uses(const std::vector<int>& aResources, int aResource);
+
+	std::vector<Resource> myResources;
+	std::vector<Pass> myPasses;
+	std::vector<int> myOrder;
+	std::vector<RenderGraphTextureDesc> myTargets;
+	std::vector<int> myTargetEnds;
+	std::vector<Command> myCommands;
+	bool myCompiled;
+	Stats myStats;
+};
@@ -0,0 +1,118 @@
+#include "RenderGraphTargets.h"
+#include <string.h>
+
+RenderGraphTargets::RenderGraphTargets()
+{
+	myDevice = nullptr;
+	myDeviceContext = nullptr;
+}
+
+RenderGraphTargets::~RenderGraphTargets()
+{
+}
+
+bool RenderGraphTargets::Initialize(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext)
+{
+	myDevice = &aDevice;
+	myDeviceContext = &aDeviceContext;
+
+	return true;
+}
+
+void RenderGraphTargets::Shutdown()
+{
+	ReleaseTargets();
+	myDevice = nullptr;
+	myDeviceContext = nullptr;
+}
+
+bool RenderGraphTargets::CreateTargets(const RenderGraphTextureDesc* aTargets, int aCount)
+{
+	RenderTarget* target;
+	int i;
+
+	// Keep the render targets as they are when the graph compiled to the same targets as last time.
+	if (aCount == (int)myDescs.size())
+	{
+		for (i = 0; i < aCount; i++)
+		{
+			if (aTargets[i].width != myDescs[i].width || aTargets[i].height != myDescs[i].height || aTargets[i].format != myDescs[i].format)
+			{
+				break;
+			}
+		}
+		if (i == aCount)
+		{
+			return true;
+		}
+	}
+
+	// The render targets are all RGBA, a target of any other format can not be given memory.
+	ReleaseTargets();
+	for (i = 0; i < aCount; i++)
+	{
+		if (aTargets[i].format != DXGI_FORMAT_R8G8B8A8_UNORM)
+		{
+			ReleaseTargets();
+			return false;
+		}
+		target = new RenderTarget;
+		if (!target)
+		{
+			ReleaseTargets();
+			return false;
+		}
+		myTargets.push_back(target);
+		if (!target->Initialize(*myDevice, aTargets[i].width, aTargets[i].height))
+		{
+			ReleaseTargets();
+			return false;
+		}
+		myDescs.push_back(aTargets[i]);
+	}
+
+	return true;
+}
+
+void RenderGraphTargets::Acquire(int, int aTarget)
+{
+	// The target still holds the texture that was in it before, start the new one from nothing.
+	myTargets[aTarget]->Clear(*myDeviceContext, 0.0f, 0.0f, 0.0f, 0.0f);
+}
+
+void RenderGraphTargets::BeginPass(int)
+{
+	ID3D11ShaderResourceView* nullViews[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT];
+
+	// A target the pass draws into may still be bound as a texture an earlier pass sampled, in any slot, so unbind them all
+	// before it is drawn to. The pass binds what it reads again itself.
+	memset(nullViews, 0, sizeof(nullViews));
+	myDeviceContext->PSSetShaderResources(0, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, nullViews);
+}
+
+void RenderGraphTargets::Release(int, int)
+{
+}
+
+RenderTarget* RenderGraphTargets::GetRenderTarget(int aTarget)
+{
+	if (aTarget < 0 || aTarget >= (int)myTargets.size())
+	{
+		return nullptr;
+	}
+	return myTargets[aTarget];
+}
+
+void RenderGraphTargets::ReleaseTargets()
+{
+	unsigned int i;
+
+	// Release the render targets.
+	for (i = 0; i < myTargets.size(); i++)
+	{
+		myTargets[i]->Shutdown();
+		delete myTargets[i];
+	}
+	myTargets.clear();
+	myDescs.clear();
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <d3d11.h>
+#include <vector>
+#include "RenderGraph.h"
+#include "RenderTarget.h"
+
+// Gives the targets of a compiled render graph a render target each, the memory its transient textures share.
+// The render targets are kept from frame to frame and only created again when the graph asks for different ones. A texture
+// starts out cleared when it is acquired, its target still holds whatever the texture before it left there. Each pass starts
+// with no textures bound to the pixel shader, so a target a pass draws into is never still bound as one.
+class RenderGraphTargets : public RenderGraphBackend
+{
+public:
+	RenderGraphTargets();
+	RenderGraphTargets(const RenderGraphTargets& aRenderGraphTargets) = delete;
+	~RenderGraphTargets();
+
+	bool Initialize(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext);
+	void Shutdown();
+
+	bool CreateTargets(const RenderGraphTextureDesc* aTargets, int aCount) override;
+	void Acquire(int aResource, int aTarget) override;
+	void BeginPass(int aPass) override;
+	void Release(int aResource, int aTarget) override;
+
+	RenderTarget* GetRenderTarget(int aTarget);
+
+private:
+	void ReleaseTargets();
+
+	ID3D11Device* myDevice;
+	ID3D11DeviceContext* myDeviceContext;
+	std::vector<RenderTarget*> myTargets;
+	std::vector<RenderGraphTextureDesc> myDescs;
+};
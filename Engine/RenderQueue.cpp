@@ -0,0 +1,129 @@
+#include "RenderQueue.h"
+
+RenderQueue::RenderQueue()
+{
+	myCommands = nullptr;
+	myCommandCount = 0;
+	myMaxCommands = 0;
+	mySkippedCount = 0;
+}
+
+RenderQueue::~RenderQueue()
+{
+}
+
+bool RenderQueue::Initialize(int aMaxCommands)
+{
+	if (aMaxCommands <= 0)
+	{
+		return false;
+	}
+	myMaxCommands = aMaxCommands;
+
+	// Create the command array.
+	myCommands = new RenderCommand[myMaxCommands];
+	if (!myCommands)
+	{
+		return false;
+	}
+	myCommandCount = 0;
+	mySkippedCount = 0;
+
+	return true;
+}
+
+void RenderQueue::Shutdown()
+{
+	// Release the command array.
+	delete[] myCommands;
+	myCommands = nullptr;
+
+	myCommandCount = 0;
+	myMaxCommands = 0;
+}
+
+void RenderQueue::Clear()
+{
+	myCommandCount = 0;
+}
+
+bool RenderQueue::Submit(ShaderHandle aShader, TextureHandle aTexture, ModelHandle aModel, MaterialType aMaterial, float aDepth)
+{
+	RenderCommand* command;
+
+	if (myCommandCount == myMaxCommands)
+	{
+		return false;
+	}
+	command = &myCommands[myCommandCount];
+	myCommandCount++;
+
+	command->sortKey = MakeSortKey(aMaterial, aDepth, aShader, aTexture, aModel);
+	command->shader = aShader;
+	command->texture = aTexture;
+	command->model = aModel;
+
+	return true;
+}
+
+void RenderQueue::Sort()
+{
+	SortRenderCommands(myCommands, myCommandCount);
+}
+
+bool RenderQueue::Execute(ID3D11DeviceContext& aDeviceContext, RenderResources& aResources, const XMMATRIX& aWorldMatrix,
+	const XMMATRIX& aViewMatrix, const XMMATRIX& aProjectionMatrix, bool aTranslucent)
+{
+	XMMATRIX worldMatrix, viewMatrix, projectionMatrix;
+	Shader* shader;
+	ID3D11ShaderResourceView* texture;
+	Model* model;
+	bool result;
+	int i;
+
+	for (i = 0; i < myCommandCount; i++)
+	{
+		// Only draw the commands of the pass.
+		if (IsTranslucentSortKey(myCommands[i].sortKey) != aTranslucent)
+		{
+			continue;
+		}
+
+		// Resolve the handles, skipping commands whose resources are gone.
+		shader = aResources.GetShader(myCommands[i].shader);
+		texture = aResources.GetTexture(myCommands[i].texture);
+		model = aResources.GetModel(myCommands[i].model);
+		if (shader == nullptr || texture == nullptr || model == nullptr)
+		{
+			mySkippedCount++;
+			continue;
+		}
+
+		// The shader transposes the matrices it is given, so hand it fresh copies for every draw.
+		worldMatrix = aWorldMatrix;
+		viewMatrix = aViewMatrix;
+		projectionMatrix = aProjectionMatrix;
+
+		// Put the model buffers on the pipeline and draw it, discarding the transparent texels of alpha tested materials.
+		model->Render(aDeviceContext);
+		shader->SetAlphaTest(GetSortKeyMaterial(myCommands[i].sortKey) == MATERIAL_ALPHA_TESTED);
+		result = shader->Render(aDeviceContext, model->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix, *texture);
+		shader->SetAlphaTest(false);
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int RenderQueue::GetCommandCount()
+{
+	return myCommandCount;
+}
+
+int RenderQueue::GetSkippedCount()
+{
+	return mySkippedCount;
+}
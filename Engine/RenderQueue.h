@@ -0,0 +1,39 @@
+#pragma once
+
+#include <d3d11.h>
+#include <directxmath.h>
+#include "RenderCommand.h"
+#include "RenderResources.h"
+
+using namespace DirectX;
+
+// Records the draws of a frame as plain commands and executes them sorted by pass and depth, then by shader, texture and model,
+// so hidden pixels are rejected by depth and state changes are grouped. The opaque pass holds opaque and alpha tested commands,
+// the translucent pass the blended ones, and the caller sets the depth and blend states of each pass before executing it.
+// Handles are only resolved at execution, a command whose resource has been removed in the meantime is skipped and counted
+// instead of drawing from freed memory.
+class RenderQueue
+{
+public:
+	RenderQueue();
+	RenderQueue(const RenderQueue& aRenderQueue) = delete;
+	~RenderQueue();
+
+	bool Initialize(int aMaxCommands);
+	void Shutdown();
+
+	void Clear();
+	bool Submit(ShaderHandle aShader, TextureHandle aTexture, ModelHandle aModel, MaterialType aMaterial, float aDepth);
+	void Sort();
+	bool Execute(ID3D11DeviceContext& aDeviceContext, RenderResources& aResources, const XMMATRIX& aWorldMatrix,
+		const XMMATRIX& aViewMatrix, const XMMATRIX& aProjectionMatrix, bool aTranslucent);
+
+	int GetCommandCount();
+	int GetSkippedCount();
+
+private:
+	RenderCommand* myCommands;
+	int myCommandCount;
+	int myMaxCommands;
+	int mySkippedCount;
+};
@@ -0,0 +1,204 @@
+#include "RenderResources.h"
+
+RenderResources::RenderResources()
+{
+}
+
+RenderResources::~RenderResources()
+{
+}
+
+bool RenderResources::Initialize()
+{
+	bool result;
+
+	// Create one table per resource type.
+	result = myModels.Initialize(MAX_RENDER_MODELS);
+	if (!result)
+	{
+		return false;
+	}
+	result = myShaders.Initialize(MAX_RENDER_SHADERS);
+	if (!result)
+	{
+		return false;
+	}
+	result = myCameras.Initialize(MAX_RENDER_CAMERAS);
+	if (!result)
+	{
+		return false;
+	}
+	result = myTextures.Initialize(MAX_RENDER_TEXTURES);
+	if (!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void RenderResources::Shutdown()
+{
+	int i;
+
+	// Release whatever is still in the tables.
+	for (i = 0; i < myModels.GetCapacity(); i++)
+	{
+		RemoveModel(myModels.GetHandle(i));
+	}
+	for (i = 0; i < myShaders.GetCapacity(); i++)
+	{
+		RemoveShader(myShaders.GetHandle(i));
+	}
+	for (i = 0; i < myCameras.GetCapacity(); i++)
+	{
+		RemoveCamera(myCameras.GetHandle(i));
+	}
+	for (i = 0; i < myTextures.GetCapacity(); i++)
+	{
+		RemoveTexture(myTextures.GetHandle(i));
+	}
+
+	// Release the tables.
+	myTextures.Shutdown();
+	myCameras.Shutdown();
+	myShaders.Shutdown();
+	myModels.Shutdown();
+}
+
+ModelHandle RenderResources::AddModel(Model* aModel)
+{
+	return myModels.Add(aModel);
+}
+
+ShaderHandle RenderResources::AddShader(Shader* aShader)
+{
+	return myShaders.Add(aShader);
+}
+
+CameraHandle RenderResources::AddCamera(Camera* aCamera)
+{
+	return myCameras.Add(aCamera);
+}
+
+TextureHandle RenderResources::AddTexture(ID3D11ShaderResourceView* aTexture)
+{
+	TextureHandle texture;
+
+	// Keep the view alive for as long as the handle is.
+	texture = myTextures.Add(aTexture);
+	if (!texture.IsNull())
+	{
+		aTexture->AddRef();
+	}
+	return texture;
+}
+
+void RenderResources::RemoveModel(ModelHandle aModel)
+{
+	Model** model;
+
+	// Null and stale handles have nothing left to release.
+	if (!myModels.IsValid(aModel))
+	{
+		return;
+	}
+	model = myModels.Get(aModel);
+	(*model)->Shutdown();
+	delete *model;
+	myModels.Remove(aModel);
+}
+
+void RenderResources::RemoveShader(ShaderHandle aShader)
+{
+	Shader** shader;
+
+	if (!myShaders.IsValid(aShader))
+	{
+		return;
+	}
+	shader = myShaders.Get(aShader);
+	(*shader)->Shutdown();
+	delete *shader;
+	myShaders.Remove(aShader);
+}
+
+void RenderResources::RemoveCamera(CameraHandle aCamera)
+{
+	Camera** camera;
+
+	if (!myCameras.IsValid(aCamera))
+	{
+		return;
+	}
+	camera = myCameras.Get(aCamera);
+	delete *camera;
+	myCameras.Remove(aCamera);
+}
+
+void RenderResources::RemoveTexture(TextureHandle aTexture)
+{
+	ID3D11ShaderResourceView** texture;
+
+	if (!myTextures.IsValid(aTexture))
+	{
+		return;
+	}
+	texture = myTextures.Get(aTexture);
+	(*texture)->Release();
+	myTextures.Remove(aTexture);
+}
+
+Model* RenderResources::GetModel(ModelHandle aModel)
+{
+	Model** model;
+
+	model = myModels.Get(aModel);
+	return model != nullptr ? *model : nullptr;
+}
+
+Shader* RenderResources::GetShader(ShaderHandle aShader)
+{
+	Shader** shader;
+
+	shader = myShaders.Get(aShader);
+	return shader != nullptr ? *shader : nullptr;
+}
+
+Camera* RenderResources::GetCamera(CameraHandle aCamera)
+{
+	Camera** camera;
+
+	camera = myCameras.Get(aCamera);
+	return camera != nullptr ? *camera : nullptr;
+}
+
+ID3D11ShaderResourceView* RenderResources::GetTexture(TextureHandle aTexture)
+{
+	ID3D11ShaderResourceView** texture;
+
+	texture = myTextures.Get(aTexture);
+	return texture != nullptr ? *texture : nullptr;
+}
+
+bool RenderResources::SetTexture(TextureHandle aTexture, ID3D11ShaderResourceView* aView)
+{
+	ID3D11ShaderResourceView** texture;
+
+	// Point the handle at the view of a texture that was recreated, the commands already holding the handle draw with it.
+	texture = myTextures.Get(aTexture);
+	if (texture == nullptr || aView == nullptr)
+	{
+		return false;
+	}
+	aView->AddRef();
+	(*texture)->Release();
+	*texture = aView;
+	return true;
+}
+
+int RenderResources::GetStaleLookupCount()
+{
+	return myModels.GetStaleLookupCount() + myShaders.GetStaleLookupCount() + myCameras.GetStaleLookupCount() +
+		myTextures.GetStaleLookupCount();
+}
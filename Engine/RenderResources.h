@@ -0,0 +1,51 @@
+#pragma once
+
+#include <d3d11.h>
+#include "HandleTable.h"
+#include "RenderCommand.h"
+#include "Model.h"
+#include "Shader.h"
+#include "Camera.h"
+
+const int MAX_RENDER_MODELS = 1024;
+const int MAX_RENDER_SHADERS = 64;
+const int MAX_RENDER_CAMERAS = 16;
+const int MAX_RENDER_TEXTURES = 1024;
+
+// Owns the models, shaders and cameras of the renderer and hands out handles to them instead of pointers.
+// Texture views are reference counted, the table keeps a reference for as long as the handle is alive.
+// Looking up a removed resource returns nullptr and is counted rather than touching freed memory.
+class RenderResources
+{
+public:
+	RenderResources();
+	RenderResources(const RenderResources& aRenderResources) = delete;
+	~RenderResources();
+
+	bool Initialize();
+	void Shutdown();
+
+	ModelHandle AddModel(Model* aModel);
+	ShaderHandle AddShader(Shader* aShader);
+	CameraHandle AddCamera(Camera* aCamera);
+	TextureHandle AddTexture(ID3D11ShaderResourceView* aTexture);
+
+	void RemoveModel(ModelHandle aModel);
+	void RemoveShader(ShaderHandle aShader);
+	void RemoveCamera(CameraHandle aCamera);
+	void RemoveTexture(TextureHandle aTexture);
+
+	Model* GetModel(ModelHandle aModel);
+	Shader* GetShader(ShaderHandle aShader);
+	Camera* GetCamera(CameraHandle aCamera);
+	ID3D11ShaderResourceView* GetTexture(TextureHandle aTexture);
+	bool SetTexture(TextureHandle aTexture, ID3D11ShaderResourceView* aView);
+
+	int GetStaleLookupCount();
+
+private:
+	HandleTable<Model*> myModels;
+	HandleTable<Shader*> myShaders;
+	HandleTable<Camera*> myCameras;
+	HandleTable<ID3D11ShaderResourceView*> myTextures;
+};
@@ -0,0 +1,181 @@
+#include "RenderTarget.h"
+
+RenderTarget::RenderTarget()
+{
+	myTexture = nullptr;
+	myRenderTargetView = nullptr;
+	myShaderResourceView = nullptr;
+	myDepthStencilBuffer = nullptr;
+	myDepthStencilView = nullptr;
+	myWidth = 0;
+	myHeight = 0;
+}
+
+RenderTarget::~RenderTarget()
+{
+}
+
+bool RenderTarget::Initialize(ID3D11Device& aDevice, int aWidth, int aHeight)
+{
+	D3D11_TEXTURE2D_DESC textureDesc;
+	D3D11_RENDER_TARGET_VIEW_DESC renderTargetViewDesc;
+	D3D11_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc;
+	D3D11_TEXTURE2D_DESC depthBufferDesc;
+	D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc;
+	HRESULT result;
+
+	if (aWidth <= 0 || aHeight <= 0)
+	{
+		return false;
+	}
+	myWidth = aWidth;
+	myHeight = aHeight;
+
+	// Setup the description of the color texture, drawn into and then sampled.
+	ZeroMemory(&textureDesc, sizeof(textureDesc));
+	textureDesc.Width = myWidth;
+	textureDesc.Height = myHeight;
+	textureDesc.MipLevels = 1;
+	textureDesc.ArraySize = 1;
+	textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.Usage = D3D11_USAGE_DEFAULT;
+	textureDesc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+	textureDesc.CPUAccessFlags = 0;
+	textureDesc.MiscFlags = 0;
+
+	// Create the color texture.
+	result = aDevice.CreateTexture2D(&textureDesc, nullptr, &myTexture);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	// Create the render target view of the texture.
+	renderTargetViewDesc.Format = textureDesc.Format;
+	renderTargetViewDesc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
+	renderTargetViewDesc.Texture2D.MipSlice = 0;
+	result = aDevice.CreateRenderTargetView(myTexture, &renderTargetViewDesc, &myRenderTargetView);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	// Create the shader resource view of the texture.
+	shaderResourceViewDesc.Format = textureDesc.Format;
+	shaderResourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+	shaderResourceViewDesc.Texture2D.MostDetailedMip = 0;
+	shaderResourceViewDesc.Texture2D.MipLevels = 1;
+	result = aDevice.CreateShaderResourceView(myTexture, &shaderResourceViewDesc, &myShaderResourceView);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	// Setup the description of the depth buffer, the same format as the one of the back buffer.
+	ZeroMemory(&depthBufferDesc, sizeof(depthBufferDesc));
+	depthBufferDesc.Width = myWidth;
+	depthBufferDesc.Height = myHeight;
+	depthBufferDesc.MipLevels = 1;
+	depthBufferDesc.ArraySize = 1;
+	depthBufferDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+	depthBufferDesc.SampleDesc.Count = 1;
+	depthBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	depthBufferDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
+	depthBufferDesc.CPUAccessFlags = 0;
+	depthBufferDesc.MiscFlags = 0;
+
+	// Create the depth buffer and its view.
+	result = aDevice.CreateTexture2D(&depthBufferDesc, nullptr, &myDepthStencilBuffer);
+	if (FAILED(result))
+	{
+		return false;
+	}
+	ZeroMemory(&depthStencilViewDesc, sizeof(depthStencilViewDesc));
+	depthStencilViewDesc.Format = depthBufferDesc.Format;
+	depthStencilViewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+	depthStencilViewDesc.Texture2D.MipSlice = 0;
+	result = aDevice.CreateDepthStencilView(myDepthStencilBuffer, &depthStencilViewDesc, &myDepthStencilView);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	// Setup the viewport covering the whole target.
+	myViewport.Width = (float)myWidth;
+	myViewport.Height = (float)myHeight;
+	myViewport.MinDepth = 0.0f;
+	myViewport.MaxDepth = 1.0f;
+	myViewport.TopLeftX = 0.0f;
+	myViewport.TopLeftY = 0.0f;
+
+	return true;
+}
+
+void RenderTarget::Shutdown()
+{
+	// Release the depth buffer.
+	if (myDepthStencilView != nullptr)
+	{
+		myDepthStencilView->Release();
+		myDepthStencilView = nullptr;
+	}
+	if (myDepthStencilBuffer != nullptr)
+	{
+		myDepthStencilBuffer->Release();
+		myDepthStencilBuffer = nullptr;
+	}
+	// Release the color texture and its views.
+	if (myShaderResourceView != nullptr)
+	{
+		myShaderResourceView->Release();
+		myShaderResourceView = nullptr;
+	}
+	if (myRenderTargetView != nullptr)
+	{
+		myRenderTargetView->Release();
+		myRenderTargetView = nullptr;
+	}
+	if (myTexture != nullptr)
+	{
+		myTexture->Release();
+		myTexture = nullptr;
+	}
+}
+
+void RenderTarget::SetRenderTarget(ID3D11DeviceContext& aDeviceContext)
+{
+	// Bind the color and depth buffers to the output merger and draw over the whole target.
+	aDeviceContext.OMSetRenderTargets(1, &myRenderTargetView, myDepthStencilView);
+	aDeviceContext.RSSetViewports(1, &myViewport);
+}
+
+void RenderTarget::Clear(ID3D11DeviceContext& aDeviceContext, float aRed, float aGreen, float aBlue, float aAlpha)
+{
+	float color[4];
+
+	// Setup the color to clear the target to.
+	color[0] = aRed;
+	color[1] = aGreen;
+	color[2] = aBlue;
+	color[3] = aAlpha;
+
+	// Clear the color and depth buffers.
+	aDeviceContext.ClearRenderTargetView(myRenderTargetView, color);
+	aDeviceContext.ClearDepthStencilView(myDepthStencilView, D3D11_CLEAR_DEPTH, 1.0f, 0);
+}
+
+ID3D11ShaderResourceView* RenderTarget::GetShaderResourceView()
+{
+	return myShaderResourceView;
+}
+
+int RenderTarget::GetWidth()
+{
+	return myWidth;
+}
+
+int RenderTarget::GetHeight()
+{
+	return myHeight;
+}
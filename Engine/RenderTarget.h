@@ -0,0 +1,32 @@
+#pragma once
+
+#include <d3d11.h>
+
+// Offscreen color and depth buffers that can be drawn into like the back buffer and then sampled as a texture.
+class RenderTarget
+{
+public:
+	RenderTarget();
+	RenderTarget(const RenderTarget& aRenderTarget) = delete;
+	~RenderTarget();
+
+	bool Initialize(ID3D11Device& aDevice, int aWidth, int aHeight);
+	void Shutdown();
+
+	void SetRenderTarget(ID3D11DeviceContext& aDeviceContext);
+	void Clear(ID3D11DeviceContext& aDeviceContext, float aRed, float aGreen, float aBlue, float aAlpha);
+
+	ID3D11ShaderResourceView* GetShaderResourceView();
+	int GetWidth();
+	int GetHeight();
+
+private:
+	ID3D11Texture2D* myTexture;
+	ID3D11RenderTargetView* myRenderTargetView;
+	ID3D11ShaderResourceView* myShaderResourceView;
+	ID3D11Texture2D* myDepthStencilBuffer;
+	ID3D11DepthStencilView* myDepthStencilView;
+	D3D11_VIEWPORT myViewport;
+	int myWidth;
+	int myHeight;
+};
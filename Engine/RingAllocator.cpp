@@ -0,0 +1,190 @@
+#include "RingAllocator.h"
+#include <string.h>
+
+RingAllocator::RingAllocator()
+{
+	myFrames = nullptr;
+	myMaxFramesInFlight = 0;
+	myFirstFrame = 0;
+	myFrameCount = 0;
+	myCapacity = 0;
+	myHead = 0;
+	myTail = 0;
+	myLastStart = 0;
+	myLastSize = 0;
+	myNextFence = 1;
+	myDiscardPending = true;
+	memset(&myStats, 0, sizeof(myStats));
+}
+
+RingAllocator::~RingAllocator()
+{
+}
+
+bool RingAllocator::Initialize(size_t aCapacity, int aMaxFramesInFlight)
+{
+	if (aCapacity == 0 || aMaxFramesInFlight <= 0)
+	{
+		return false;
+	}
+
+	// Create the list of frames the GPU may still be reading from.
+	myFrames = new Frame[aMaxFramesInFlight];
+	if (!myFrames)
+	{
+		return false;
+	}
+	myMaxFramesInFlight = aMaxFramesInFlight;
+	myFirstFrame = 0;
+	myFrameCount = 0;
+	myCapacity = aCapacity;
+	myHead = 0;
+	myTail = 0;
+	myLastStart = 0;
+	myLastSize = 0;
+	myNextFence = 1;
+	memset(&myStats, 0, sizeof(myStats));
+
+	// The buffer holds nothing yet, so the first map discards it.
+	myDiscardPending = true;
+
+	return true;
+}
+
+void RingAllocator::Shutdown()
+{
+	// Release the frame list.
+	delete[] myFrames;
+	myFrames = nullptr;
+
+	myMaxFramesInFlight = 0;
+	myFrameCount = 0;
+	myCapacity = 0;
+}
+
+void RingAllocator::BeginFrame(unsigned long long aCompletedFence)
+{
+	// Free the ranges of the frames the GPU has finished, oldest first. Fences pass in order, so the first frame still
+	// running holds back the ones after it.
+	while (myFrameCount > 0 && myFrames[myFirstFrame].fence <= aCompletedFence)
+	{
+		myTail = myFrames[myFirstFrame].end;
+		myFirstFrame = (myFirstFrame + 1) % myMaxFramesInFlight;
+		myFrameCount--;
+	}
+
+	myLastSize = 0;
+	myStats.frameBytes = 0;
+	myStats.frameDiscardCount = 0;
+}
+
+unsigned long long RingAllocator::EndFrame()
+{
+	int frame;
+
+	// Remember where the frame ended. When the GPU is more frames behind than can be tracked, the frame is folded into the
+	// newest one, whose ranges are then only freed once both are done.
+	if (myFrameCount == myMaxFramesInFlight)
+	{
+		frame = (myFirstFrame + myFrameCount - 1) % myMaxFramesInFlight;
+	}
+	else
+	{
+		frame = (myFirstFrame + myFrameCount) % myMaxFramesInFlight;
+		myFrameCount++;
+	}
+	myFrames[frame].fence = myNextFence;
+	myFrames[frame].end = myHead;
+
+	// Ranges can no longer be trimmed once their frame is submitted.
+	myLastSize = 0;
+
+	return myNextFence++;
+}
+
+bool RingAllocator::Allocate(size_t aSize, size_t aAlignment, size_t& aOffset, bool& aDiscard)
+{
+	unsigned long long needed;
+	size_t offset, start;
+	bool wrapped;
+
+	if (aSize == 0 || aSize > myCapacity || aAlignment == 0)
+	{
+		return false;
+	}
+
+	// Align the range after the last one, or start over at the beginning of the buffer when it would run past the end.
+	// The bytes skipped at the end stay with the frame until it is done.
+	offset = (size_t)(myHead % myCapacity);
+	start = (offset + aAlignment - 1) / aAlignment * aAlignment;
+	wrapped = start + aSize > myCapacity;
+	if (wrapped)
+	{
+		start = 0;
+		needed = myCapacity - offset + aSize;
+	}
+	else
+	{
+		needed = start - offset + aSize;
+	}
+
+	// Discard the buffer when the range reaches into the ones of a frame in flight. The driver keeps the old memory for the GPU,
+	// so every frame before is forgotten and the ring starts empty.
+	aDiscard = myDiscardPending || myHead + needed - myTail > myCapacity;
+	if (aDiscard)
+	{
+		myFirstFrame = 0;
+		myFrameCount = 0;
+		myHead = 0;
+		myTail = 0;
+		start = 0;
+		needed = aSize;
+		myDiscardPending = false;
+		myStats.discardCount++;
+		myStats.frameDiscardCount++;
+	}
+	else if (wrapped)
+	{
+		myStats.wrapCount++;
+	}
+
+	aOffset = start;
+	myHead += needed;
+	myLastStart = myHead - aSize;
+	myLastSize = aSize;
+
+	myStats.frameBytes += (size_t)needed;
+	myStats.allocationCount++;
+	myStats.allocatedBytes += (long long)aSize;
+
+	return true;
+}
+
+void RingAllocator::Trim(size_t aUsedSize)
+{
+	size_t unused;
+
+	// Give back the end of the last range when less of it was written than reserved, as long as nothing came after it.
+	if (aUsedSize >= myLastSize)
+	{
+		return;
+	}
+	unused = myLastSize - aUsedSize;
+	myHead = myLastStart + aUsedSize;
+	myLastSize = aUsedSize;
+
+	myStats.frameBytes -= unused;
+	myStats.allocatedBytes -= (long long)unused;
+}
+
+size_t RingAllocator::GetCapacity()
+{
+	return myCapacity;
+}
+
+void RingAllocator::GetStats(Stats& aStats)
+{
+	aStats = myStats;
+	aStats.usedBytes = (size_t)(myHead - myTail);
+	aStats.framesInFlight = myFrameCount;
+}
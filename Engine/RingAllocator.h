@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stddef.h>
+
+// Hands out ranges of one GPU buffer in order, wrapping around at its end, for data the CPU writes once and the GPU reads in the
+// same frame. Every frame ends with a fence value the renderer signals after its draws, the ranges of a frame are free again once
+// the GPU has passed that fence, so new data never overwrites what a frame in flight may still read.
+// When the next range is still in use the buffer has to be discarded: allocation starts over at its beginning and the caller
+// maps with a discard, which gives it fresh memory while the GPU finishes with the old. Only offsets are tracked here, the caller
+// owns the buffer, so the allocator runs without a graphics device.
+class RingAllocator
+{
+public:
+	// The frame counts cover the frame being built, or the last one ended when none is.
+	struct Stats
+	{
+		size_t usedBytes;
+		size_t frameBytes;
+		int frameDiscardCount;
+		int framesInFlight;
+		long long allocationCount;
+		long long allocatedBytes;
+		int wrapCount;
+		int discardCount;
+	};
+
+	RingAllocator();
+	RingAllocator(const RingAllocator& aRingAllocator) = delete;
+	~RingAllocator();
+
+	bool Initialize(size_t aCapacity, int aMaxFramesInFlight);
+	void Shutdown();
+
+	void BeginFrame(unsigned long long aCompletedFence);
+	unsigned long long EndFrame();
+
+	bool Allocate(size_t aSize, size_t aAlignment, size_t& aOffset, bool& aDiscard);
+	void Trim(size_t aUsedSize);
+
+	size_t GetCapacity();
+	void GetStats(Stats& aStats);
+
+private:
+	struct Frame
+	{
+		unsigned long long fence;
+		unsigned long long end;
+	};
+
+	Frame* myFrames;
+	int myMaxFramesInFlight;
+	int myFirstFrame;
+	int myFrameCount;
+	size_t myCapacity;
+	unsigned long long myHead;
+	unsigned long long myTail;
+	unsigned long long myLastStart;
+	size_t myLastSize;
+	unsigned long long myNextFence;
+	bool myDiscardPending;
+	Stats myStats;
+};
@@ -0,0 +1,567 @@
+#include "Scenario.h"
+#include <algorithm>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Longest line of a scenario script or baseline.
+static const int MAX_LINE_LENGTH = 256;
+
+// Differences below these never count as a regression, so tiny timings do not fail a run on noise alone.
+static const double TIME_TOLERANCE = 0.05;
+static const double COUNT_TOLERANCE = 0.5;
+
+static FILE* OpenFile(const char* aPath, const char* aMode)
+{
+	FILE* file;
+
+#if defined(_WIN32)
+	if (fopen_s(&file, aPath, aMode) != 0)
+	{
+		file = nullptr;
+	}
+#else
+	file = fopen(aPath, aMode);
+#endif
+	return file;
+}
+
+static void SetName(char* aName, size_t aSize, const char* aValue)
+{
+	snprintf(aName, aSize, "%s", aValue);
+}
+
+// Splits a "key value" line in place, returns false for blank lines and comments.
+static bool SplitLine(char* aLine, char*& aKey, char*& aValue)
+{
+	char* end;
+
+	// Cut the comment and the line break off.
+	end = strchr(aLine, '#');
+	if (end != nullptr)
+	{
+		*end = '\0';
+	}
+	end = aLine + strlen(aLine);
+	while (end > aLine && isspace((unsigned char)end[-1]))
+	{
+		end--;
+	}
+	*end = '\0';
+
+	// The key runs up to the first space, the value is the rest of the line.
+	aKey = aLine;
+	while (isspace((unsigned char)*aKey))
+	{
+		aKey++;
+	}
+	if (*aKey == '\0')
+	{
+		return false;
+	}
+	aValue = aKey;
+	while (*aValue != '\0' && !isspace((unsigned char)*aValue))
+	{
+		aValue++;
+	}
+	if (*aValue != '\0')
+	{
+		*aValue = '\0';
+		aValue++;
+		while (isspace((unsigned char)*aValue))
+		{
+			aValue++;
+		}
+	}
+	return true;
+}
+
+void GetDefaultScenario(Scenario& aScenario)
+{
+	// The interactive scene: a row of animated sprites over the tilemap and a fountain of particles below them.
+	SetName(aScenario.name, sizeof(aScenario.name), "demo");
+	aScenario.scene[0] = '\0';
+	aScenario.streamDistance = 0.0f;
+	aScenario.frameCount = 600;
+	aScenario.warmupFrameCount = 60;
+	aScenario.frameTime = 1.0f / 60.0f;
+	aScenario.threshold = 0.1f;
+	aScenario.spriteCount = 8;
+	aScenario.spriteSpeed = 0.0f;
+	aScenario.emitterCount = 1;
+	aScenario.emissionRate = 2000.0f;
+	aScenario.scrollSpeedX = 0.0f;
+	aScenario.scrollSpeedY = 0.0f;
+	aScenario.textCount = 0;
+	aScenario.textUpdateRate = 0.0f;
+	aScenario.lightCount = 0;
+	aScenario.textureBudget = 0;
+	aScenario.spriteTextureCount = 0;
+}
+
+bool FindScenario(const char* aName, Scenario& aScenario)
+{
+	GetDefaultScenario(aScenario);
+
+	if (strcmp(aName, "demo") == 0)
+	{
+		return true;
+	}
+
+	// Every sprite the batch holds, each one circling its place on the grid.
+	if (strcmp(aName, "sprite_storm") == 0)
+	{
+		SetName(aScenario.name, sizeof(aScenario.name), aName);
+		aScenario.spriteCount = 4096;
+		aScenario.spriteSpeed = 2.0f;
+		aScenario.emitterCount = 0;
+		return true;
+	}
+
+	// A row of fountains that keeps the particle batch close to full.
+	if (strcmp(aName, "particle_heavy") == 0)
+	{
+		SetName(aScenario.name, sizeof(aScenario.name), aName);
+		aScenario.emitterCount = 8;
+		aScenario.emissionRate = 3000.0f;
+		return true;
+	}
+
+	// The camera drifting over the tilemap, so chunks are built and the background layer is redrawn every frame.
+	if (strcmp(aName, "tilemap_scroll") == 0)
+	{
+		SetName(aScenario.name, sizeof(aScenario.name), aName);
+		aScenario.emitterCount = 0;
+		aScenario.scrollSpeedX = 1.5f;
+		aScenario.scrollSpeedY = 0.5f;
+		return true;
+	}
+
+	// A screen full of text that is laid out again every frame.
+	if (strcmp(aName, "text_hud") == 0)
+	{
+		SetName(aScenario.name, sizeof(aScenario.name), aName);
+		aScenario.emitterCount = 0;
+		aScenario.textCount = 24;
+		aScenario.textUpdateRate = 60.0f;
+		return true;
+	}
+
+	// A night scene: the sprites circling under hundreds of wandering lights, binned into screen tiles every frame.
+	if (strcmp(aName, "night_lights") == 0)
+	{
+		SetName(aScenario.name, sizeof(aScenario.name), aName);
+		aScenario.spriteCount = 1024;
+		aScenario.spriteSpeed = 1.0f;
+		aScenario.emitterCount = 0;
+		aScenario.lightCount = 512;
+		return true;
+	}
+
+	// The demo on a card with little memory for textures, so the model texture has to give up its larger mips.
+	if (strcmp(aName, "low_texture_memory") == 0)
+	{
+		SetName(aScenario.name, sizeof(aScenario.name), aName);
+		aScenario.textureBudget = 256;
+		return true;
+	}
+
+	// Sprites showing 200 images of their own, drawn a texture array at a time rather than an image at a time.
+	if (strcmp(aName, "many_textures") == 0)
+	{
+		SetName(aScenario.name, sizeof(aScenario.name), aName);
+		aScenario.spriteCount = 1024;
+		aScenario.spriteSpeed = 1.0f;
+		aScenario.emitterCount = 0;
+		aScenario.spriteTextureCount = 200;
+		return true;
+	}
+
+	return false;
+}
+
+bool LoadScenario(const char* aPath, Scenario& aScenario)
+{
+	FILE* file;
+	char line[MAX_LINE_LENGTH];
+	char* key;
+	char* value;
+	bool result;
+
+	file = OpenFile(aPath, "r");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	// A script may start from one of the built in scenes with "base", otherwise from the interactive one.
+	GetDefaultScenario(aScenario);
+	SetName(aScenario.name, sizeof(aScenario.name), aPath);
+	result = true;
+	while (result && fgets(line, sizeof(line), file) != nullptr)
+	{
+		if (!SplitLine(line, key, value))
+		{
+			continue;
+		}
+
+		if (strcmp(key, "base") == 0)
+		{
+			result = FindScenario(value, aScenario);
+		}
+		else if (strcmp(key, "name") == 0)
+		{
+			SetName(aScenario.name, sizeof(aScenario.name), value);
+		}
+		else if (strcmp(key, "scene") == 0)
+		{
+			SetName(aScenario.scene, sizeof(aScenario.scene), value);
+		}
+		else if (strcmp(key, "stream_distance") == 0)
+		{
+			aScenario.streamDistance = (float)atof(value);
+		}
+		else if (strcmp(key, "frames") == 0)
+		{
+			aScenario.frameCount = atoi(value);
+		}
+		else if (strcmp(key, "warmup_frames") == 0)
+		{
+			aScenario.warmupFrameCount = atoi(value);
+		}
+		else if (strcmp(key, "frame_time") == 0)
+		{
+			aScenario.frameTime = (float)atof(value);
+		}
+		else if (strcmp(key, "threshold") == 0)
+		{
+			aScenario.threshold = (float)atof(value);
+		}
+		else if (strcmp(key, "sprites") == 0)
+		{
+			aScenario.spriteCount = atoi(value);
+		}
+		else if (strcmp(key, "sprite_speed") == 0)
+		{
+			aScenario.spriteSpeed = (float)atof(value);
+		}
+		else if (strcmp(key, "emitters") == 0)
+		{
+			aScenario.emitterCount = atoi(value);
+		}
+		else if (strcmp(key, "emission_rate") == 0)
+		{
+			aScenario.emissionRate = (float)atof(value);
+		}
+		else if (strcmp(key, "scroll_x") == 0)
+		{
+			aScenario.scrollSpeedX = (float)atof(value);
+		}
+		else if (strcmp(key, "scroll_y") == 0)
+		{
+			aScenario.scrollSpeedY = (float)atof(value);
+		}
+		else if (strcmp(key, "texts") == 0)
+		{
+			aScenario.textCount = atoi(value);
+		}
+		else if (strcmp(key, "text_update_rate") == 0)
+		{
+			aScenario.textUpdateRate = (float)atof(value);
+		}
+		else if (strcmp(key, "lights") == 0)
+		{
+			aScenario.lightCount = atoi(value);
+		}
+		else if (strcmp(key, "texture_budget_kb") == 0)
+		{
+			aScenario.textureBudget = atoi(value);
+		}
+		else if (strcmp(key, "sprite_textures") == 0)
+		{
+			aScenario.spriteTextureCount = atoi(value);
+		}
+		else
+		{
+			// Unknown keys are mistakes in the script, not something to skip over quietly.
+			result = false;
+		}
+	}
+	fclose(file);
+
+	return result && aScenario.frameCount > 0 && aScenario.warmupFrameCount >= 0 && aScenario.frameTime > 0.0f;
+}
+
+ScenarioReport::ScenarioReport()
+{
+	GetDefaultScenario(myScenario);
+}
+
+ScenarioReport::~ScenarioReport()
+{
+}
+
+bool ScenarioReport::Initialize(const Scenario& aScenario)
+{
+	if (aScenario.frameCount <= 0)
+	{
+		return false;
+	}
+	myScenario = aScenario;
+
+	// Reserve every frame up front so recording does not allocate while frames are timed.
+	myFrames.clear();
+	myFrames.reserve(myScenario.frameCount);
+	myMetrics.clear();
+	return true;
+}
+
+void ScenarioReport::Shutdown()
+{
+	myFrames.clear();
+	myMetrics.clear();
+}
+
+void ScenarioReport::AddFrame(const FrameStats& aStats)
+{
+	myFrames.push_back(aStats);
+}
+
+void ScenarioReport::Finish()
+{
+	std::vector<float> frameTimes;
+	double animationTime, particleTime, renderTime, drawCalls, drawnChunks, builtChunks, layerRedraws, coverage, allocations;
+	double particles, sprites, pendingChunks, pendingCells, streamedBytes, popIns, seconds, shadedPixels, coveredPixels;
+	double lightingTime, lights, lightsPerTile, uploadedBytes, uploadDiscards, textureUploadTime, textureUploadMax;
+	double textureBudget, textureResident, textureEvictions, textureReloads;
+	int i, count, presented;
+
+	myMetrics.clear();
+	count = (int)myFrames.size();
+	if (count == 0)
+	{
+		return;
+	}
+
+	// The distribution of the frame times, from the median out to the slowest frame.
+	frameTimes.resize(count);
+	for (i = 0; i < count; i++)
+	{
+		frameTimes[i] = myFrames[i].frameTime;
+	}
+	std::sort(frameTimes.begin(), frameTimes.end());
+	AddMetric("frame_ms_median", Percentile(frameTimes, 50), TIME_TOLERANCE, true);
+	AddMetric("frame_ms_p90", Percentile(frameTimes, 90), TIME_TOLERANCE, true);
+	AddMetric("frame_ms_p95", Percentile(frameTimes, 95), TIME_TOLERANCE, true);
+	AddMetric("frame_ms_p99", Percentile(frameTimes, 99), TIME_TOLERANCE, true);
+	AddMetric("frame_ms_max", frameTimes.back(), TIME_TOLERANCE, false);
+
+	// Means of the subsystem times and counters.
+	animationTime = particleTime = renderTime = 0.0;
+	drawCalls = drawnChunks = builtChunks = layerRedraws = coverage = allocations = 0.0;
+	particles = sprites = 0.0;
+	pendingChunks = pendingCells = streamedBytes = popIns = seconds = 0.0;
+	shadedPixels = coveredPixels = 0.0;
+	lightingTime = lights = lightsPerTile = 0.0;
+	uploadedBytes = uploadDiscards = 0.0;
+	textureUploadTime = textureUploadMax = 0.0;
+	textureBudget = textureResident = textureEvictions = textureReloads = 0.0;
+	presented = 0;
+	for (i = 0; i < count; i++)
+	{
+		animationTime += myFrames[i].animationTime;
+		particleTime += myFrames[i].particleTime;
+		renderTime += myFrames[i].renderTime;
+		drawCalls += myFrames[i].drawCallCount;
+		drawnChunks += myFrames[i].drawnChunkCount;
+		builtChunks += myFrames[i].builtChunkCount;
+		layerRedraws += myFrames[i].layerRedrawCount;
+		coverage += myFrames[i].redrawCoverage;
+		allocations += myFrames[i].heapAllocationCount;
+		particles += myFrames[i].particleCount;
+		sprites += myFrames[i].spriteCount;
+		presented += myFrames[i].presented ? 1 : 0;
+		pendingChunks += myFrames[i].pendingChunkCount;
+		pendingCells += myFrames[i].pendingCellCount;
+		streamedBytes += myFrames[i].streamedBytes;
+		popIns += myFrames[i].popInCount;
+		shadedPixels += (double)myFrames[i].shadedPixelCount;
+		coveredPixels += (double)myFrames[i].coveredPixelCount;
+		lightingTime += myFrames[i].lightingTime;
+		lights += myFrames[i].lightCount;
+		lightsPerTile += myFrames[i].lightsPerTile;
+		uploadedBytes += myFrames[i].uploadedBytes;
+		uploadDiscards += myFrames[i].uploadDiscardCount;
+		textureUploadTime += myFrames[i].textureUploadTime;
+		textureUploadMax = std::max(textureUploadMax, (double)myFrames[i].textureUploadTime);
+		textureBudget = std::max(textureBudget, (double)myFrames[i].textureBudgetBytes);
+		textureResident = std::max(textureResident, (double)myFrames[i].textureResidentBytes);
+		textureEvictions += myFrames[i].textureEvictCount;
+		textureReloads += myFrames[i].textureReloadCount;
+		seconds += myFrames[i].frameTime / 1000.0;
+	}
+	AddMetric("animation_ms_mean", animationTime / count, TIME_TOLERANCE, true);
+	AddMetric("particles_ms_mean", particleTime / count, TIME_TOLERANCE, true);
+	AddMetric("render_ms_mean", renderTime / count, TIME_TOLERANCE, true);
+	AddMetric("lighting_ms_mean", lightingTime / count, TIME_TOLERANCE, true);
+	AddMetric("texture_upload_ms_mean", textureUploadTime / count, TIME_TOLERANCE, true);
+	AddMetric("texture_upload_ms_max", textureUploadMax, TIME_TOLERANCE, false);
+	AddMetric("draw_calls_mean", drawCalls / count, COUNT_TOLERANCE, true);
+	AddMetric("drawn_chunks_mean", drawnChunks / count, COUNT_TOLERANCE, true);
+	AddMetric("built_chunks_mean", builtChunks / count, COUNT_TOLERANCE, true);
+	AddMetric("layer_redraws_mean", layerRedraws / count, COUNT_TOLERANCE, true);
+	AddMetric("redrawn_percent_mean", coverage * 100.0 / count, COUNT_TOLERANCE, true);
+	AddMetric("heap_allocations_mean", allocations / count, COUNT_TOLERANCE, true);
+	AddMetric("presented_frames", presented, COUNT_TOLERANCE, true);
+	AddMetric("overdraw", coveredPixels > 0.0 ? shadedPixels / coveredPixels : 0.0, COUNT_TOLERANCE, true);
+	AddMetric("lights_per_tile_mean", lightsPerTile / count, COUNT_TOLERANCE, true);
+	AddMetric("upload_discards", uploadDiscards, COUNT_TOLERANCE, true);
+	AddMetric("texture_evictions", textureEvictions, COUNT_TOLERANCE, true);
+	AddMetric("texture_resident_mb_max", textureResident / (1024.0 * 1024.0), COUNT_TOLERANCE, true);
+	AddMetric("particles_mean", particles / count, 0.0, false);
+	AddMetric("sprites_mean", sprites / count, 0.0, false);
+	AddMetric("lights_mean", lights / count, 0.0, false);
+	AddMetric("upload_kb_mean", uploadedBytes / 1024.0 / count, 0.0, false);
+	AddMetric("texture_budget_mb", textureBudget / (1024.0 * 1024.0), 0.0, false);
+	AddMetric("texture_reloads", textureReloads, 0.0, false);
+
+	// Streaming reads on a thread of its own, so how far it keeps up depends on the disk and is reported but not compared.
+	AddMetric("pending_chunks_mean", pendingChunks / count, 0.0, false);
+	AddMetric("pending_cells_mean", pendingCells / count, 0.0, false);
+	AddMetric("stream_mb_per_s", seconds > 0.0 ? streamedBytes / (1024.0 * 1024.0) / seconds : 0.0, 0.0, false);
+	AddMetric("pop_ins", popIns, 0.0, false);
+}
+
+const std::vector<ScenarioReport::Metric>& ScenarioReport::GetMetrics()
+{
+	return myMetrics;
+}
+
+bool ScenarioReport::Write(const char* aPath)
+{
+	FILE* file;
+	unsigned int i;
+
+	file = OpenFile(aPath, "w");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	// The same "key value" lines a baseline is read from, so a run can be kept as the next baseline as it is.
+	fprintf(file, "# scenario %s, %d frames of %.4f s after %d warm-up frames\n", myScenario.name, (int)myFrames.size(),
+		myScenario.frameTime, myScenario.warmupFrameCount);
+	for (i = 0; i < myMetrics.size(); i++)
+	{
+		fprintf(file, "%s %.4f\n", myMetrics[i].name, myMetrics[i].value);
+	}
+
+	return fclose(file) == 0;
+}
+
+bool ScenarioReport::WriteTrace(const char* aPath)
+{
+	FILE* file;
+	unsigned int i;
+	const FrameStats* stats;
+
+	file = OpenFile(aPath, "w");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	// One row per recorded frame, for plotting the whole distribution rather than its percentiles.
+	fprintf(file, "frame,frame_ms,animation_ms,particles_ms,render_ms,sprites,particles,draw_calls,drawn_chunks,built_chunks,"
+		"layer_redraws,redrawn_percent,heap_allocations,presented,pending_chunks,pending_cells,streamed_bytes,pop_ins,shaded_pixels,"
+		"covered_pixels,lighting_ms,lights,lights_per_tile,uploaded_bytes,upload_discards,"
+		"texture_upload_ms,texture_upload_bytes,texture_resident_bytes,texture_evictions,texture_reloads\n");
+	for (i = 0; i < myFrames.size(); i++)
+	{
+		stats = &myFrames[i];
+		fprintf(file, "%u,%.4f,%.4f,%.4f,%.4f,%d,%d,%d,%d,%d,%d,%.1f,%d,%d,%d,%d,%d,%d,%lld,%lld,%.4f,%d,%.2f,%d,%d,%.4f,%d,%lld,%d,%d\n", i, stats->frameTime,
+			stats->animationTime, stats->particleTime, stats->renderTime, stats->spriteCount, stats->particleCount, stats->drawCallCount,
+			stats->drawnChunkCount, stats->builtChunkCount, stats->layerRedrawCount, stats->redrawCoverage * 100.0f,
+			stats->heapAllocationCount, stats->presented ? 1 : 0, stats->pendingChunkCount, stats->pendingCellCount,
+			stats->streamedBytes, stats->popInCount, stats->shadedPixelCount, stats->coveredPixelCount, stats->lightingTime, stats->lightCount,
+			stats->lightsPerTile, stats->uploadedBytes, stats->uploadDiscardCount,
+			stats->textureUploadTime, stats->textureUploadBytes, stats->textureResidentBytes, stats->textureEvictCount, stats->textureReloadCount);
+	}
+
+	return fclose(file) == 0;
+}
+
+bool ScenarioReport::Compare(const char* aBaselinePath, float aThreshold, int& aRegressionCount)
+{
+	FILE* file;
+	char line[MAX_LINE_LENGTH];
+	char* key;
+	char* value;
+	unsigned int i;
+	double baseline, limit;
+	const Metric* metric;
+
+	aRegressionCount = 0;
+	file = OpenFile(aBaselinePath, "r");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	// Only costs are compared, lower is better for all of them. Metrics missing from the baseline are new and pass.
+	printf("%-24s %12s %12s %8s\n", "metric", "baseline", "current", "change");
+	while (fgets(line, sizeof(line), file) != nullptr)
+	{
+		if (!SplitLine(line, key, value))
+		{
+			continue;
+		}
+
+		metric = nullptr;
+		for (i = 0; i < myMetrics.size(); i++)
+		{
+			if (strcmp(myMetrics[i].name, key) == 0)
+			{
+				metric = &myMetrics[i];
+				break;
+			}
+		}
+		if (metric == nullptr || !metric->compared)
+		{
+			continue;
+		}
+
+		baseline = atof(value);
+		limit = std::max(baseline * (1.0 + aThreshold), baseline + metric->tolerance);
+		printf("%-24s %12.4f %12.4f %+7.1f%%%s\n", metric->name, baseline, metric->value,
+			baseline > 0.0 ? (metric->value - baseline) * 100.0 / baseline : 0.0, metric->value > limit ? "  REGRESSION" : "");
+		if (metric->value > limit)
+		{
+			aRegressionCount++;
+		}
+	}
+	fclose(file);
+
+	return true;
+}
+
+void ScenarioReport::AddMetric(const char* aName, double aValue, double aTolerance, bool aCompared)
+{
+	Metric metric;
+
+	SetName(metric.name, sizeof(metric.name), aName);
+	metric.value = aValue;
+	metric.tolerance = aTolerance;
+	metric.compared = aCompared;
+	myMetrics.push_back(metric);
+}
+
+double ScenarioReport::Percentile(const std::vector<float>& aSortedSamples, int aPercent)
+{
+	size_t rank;
+
+	// Nearest rank, the smallest sample that at least aPercent of the samples are not above.
+	rank = (aSortedSamples.size() * aPercent + 99) / 100;
+	return aSortedSamples[rank > 0 ? rank - 1 : 0];
+}
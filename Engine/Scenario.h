@@ -0,0 +1,113 @@
+#pragma once
+
+#include <vector>
+
+// Most text lines a scenario can put on the screen.
+const int MAX_SCENARIO_TEXTS = 32;
+
+// A scripted scene: what the scene holds, how it moves and how many frames it runs for.
+// Every frame advances by the same fixed step, so two runs of a scenario do the same work and their times can be compared.
+// A scenario that names a binary scene takes the camera, texture, sprites and tilemap from it instead of building them.
+// With a stream distance the tilemap of the scene is streamed in cells, up to that far beyond the view, rather than loaded whole.
+// A texture budget in KB stands in for the memory of the video card, to run the scene as a smaller card would.
+// With sprite textures the sprites show that many images of their own, drawn from texture arrays, instead of the model texture.
+struct Scenario
+{
+	char name[64];
+	char scene[260];
+	float streamDistance;
+	int frameCount;
+	int warmupFrameCount;
+	float frameTime;
+	float threshold;
+	int spriteCount;
+	float spriteSpeed;
+	int emitterCount;
+	float emissionRate;
+	float scrollSpeedX;
+	float scrollSpeedY;
+	int textCount;
+	float textUpdateRate;
+	int lightCount;
+	int textureBudget;
+	int spriteTextureCount;
+};
+
+// What one call to GraphicsClass::Frame did and how long its parts took, times in milliseconds.
+struct FrameStats
+{
+	float frameTime;
+	float animationTime;
+	float particleTime;
+	float renderTime;
+	int spriteCount;
+	int particleCount;
+	int drawCallCount;
+	int drawnChunkCount;
+	int builtChunkCount;
+	int pendingChunkCount;
+	int pendingCellCount;
+	int streamedBytes;
+	int popInCount;
+	int layerRedrawCount;
+	float redrawCoverage;
+	float lightingTime;
+	int lightCount;
+	float lightsPerTile;
+	int uploadedBytes;
+	int uploadDiscardCount;
+	float textureUploadTime;
+	int textureUploadBytes;
+	long long textureBudgetBytes;
+	long long textureResidentBytes;
+	int textureEvictCount;
+	int textureReloadCount;
+	long long shadedPixelCount;
+	long long coveredPixelCount;
+	int heapAllocationCount;
+	bool presented;
+};
+
+// Scenarios are built in by name or read from a script of "key value" lines, where # starts a comment.
+// A script starts from the defaults of the interactive scene and only has to name what it changes.
+void GetDefaultScenario(Scenario& aScenario);
+bool FindScenario(const char* aName, Scenario& aScenario);
+bool LoadScenario(const char* aPath, Scenario& aScenario);
+
+// Collects the frame stats of a scenario run and reduces them to named metrics: percentiles of the frame time
+// and means of the subsystem times and counters. Metrics are written as "key value" lines, so the output of one
+// run can be stored and used as the baseline of the next, which fails when a cost grew by more than the threshold.
+class ScenarioReport
+{
+public:
+	struct Metric
+	{
+		char name[48];
+		double value;
+		double tolerance;
+		bool compared;
+	};
+
+	ScenarioReport();
+	ScenarioReport(const ScenarioReport& aScenarioReport) = delete;
+	~ScenarioReport();
+
+	bool Initialize(const Scenario& aScenario);
+	void Shutdown();
+
+	void AddFrame(const FrameStats& aStats);
+	void Finish();
+
+	const std::vector<Metric>& GetMetrics();
+	bool Write(const char* aPath);
+	bool WriteTrace(const char* aPath);
+	bool Compare(const char* aBaselinePath, float aThreshold, int& aRegressionCount);
+
+private:
+	void AddMetric(const char* aName, double aValue, double aTolerance, bool aCompared);
+	static double Percentile(const std::vector<float>& aSortedSamples, int aPercent);
+
+	Scenario myScenario;
+	std::vector<FrameStats> myFrames;
+	std::vector<Metric> myMetrics;
+};
@@ -0,0 +1,317 @@
+#include "SceneFile.h"
+#include <stdio.h>
+#include <string.h>
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Size of the records of every section type, a file written with other records is from another version.
+static const unsigned int SECTION_STRIDES[SCENE_SECTION_COUNT] =
+{
+	sizeof(SceneCamera),
+	sizeof(SceneTexture),
+	sizeof(SceneSprite),
+	sizeof(SceneEntity),
+	sizeof(SceneVector),
+	sizeof(SceneVector),
+	sizeof(SceneTilemap),
+	sizeof(unsigned short)
+};
+
+static FILE* OpenFile(const char* aPath, const char* aMode)
+{
+	FILE* file;
+
+#if defined(_WIN32)
+	if (fopen_s(&file, aPath, aMode) != 0)
+	{
+		file = nullptr;
+	}
+#else
+	file = fopen(aPath, aMode);
+#endif
+	return file;
+}
+
+SceneFile::SceneFile()
+{
+	int i;
+
+	myData = nullptr;
+	mySize = 0;
+	myBuffer = nullptr;
+	myMappedView = nullptr;
+	myMappedSize = 0;
+	for (i = 0; i < SCENE_SECTION_COUNT; i++)
+	{
+		mySections[i] = nullptr;
+	}
+}
+
+SceneFile::~SceneFile()
+{
+}
+
+bool SceneFile::Load(const char* aPath)
+{
+	FILE* file;
+	long size;
+	size_t read;
+
+	Shutdown();
+
+	file = OpenFile(aPath, "rb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	// Read the whole file into one buffer, there is nothing to convert on the way.
+	fseek(file, 0, SEEK_END);
+	size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	if (size <= 0)
+	{
+		fclose(file);
+		return false;
+	}
+	myBuffer = new unsigned char[size];
+	read = fread(myBuffer, 1, (size_t)size, file);
+	fclose(file);
+	if (read != (size_t)size)
+	{
+		Shutdown();
+		return false;
+	}
+
+	if (!Open(myBuffer, (size_t)size))
+	{
+		Shutdown();
+		return false;
+	}
+	return true;
+}
+
+bool SceneFile::Map(const char* aPath)
+{
+#if defined(_WIN32)
+	HANDLE file, mapping;
+	LARGE_INTEGER fileSize;
+#else
+	struct stat status;
+	int file;
+	void* view;
+#endif
+	size_t size;
+
+	Shutdown();
+
+	// Map the file read only, pages are only read from the disk once a section is touched.
+#if defined(_WIN32)
+	file = CreateFileA(aPath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	size = (size_t)fileSize.QuadPart;
+	mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (mapping == nullptr)
+	{
+		return false;
+	}
+
+	// The view keeps the mapping alive on its own.
+	myMappedView = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (myMappedView == nullptr)
+	{
+		return false;
+	}
+#else
+	file = open(aPath, O_RDONLY);
+	if (file < 0)
+	{
+		return false;
+	}
+	if (fstat(file, &status) != 0 || status.st_size <= 0)
+	{
+		close(file);
+		return false;
+	}
+	size = (size_t)status.st_size;
+
+	// The mapping stays valid after the file is closed.
+	view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (view == MAP_FAILED)
+	{
+		return false;
+	}
+	myMappedView = view;
+#endif
+	myMappedSize = size;
+
+	if (!Open(myMappedView, size))
+	{
+		Shutdown();
+		return false;
+	}
+	return true;
+}
+
+bool SceneFile::Open(const void* aData, size_t aSize)
+{
+	SceneHeader header;
+	const SceneSection* sections;
+	const SceneSection* section;
+	unsigned int i;
+
+	myData = nullptr;
+	mySize = 0;
+	for (i = 0; i < SCENE_SECTION_COUNT; i++)
+	{
+		mySections[i] = nullptr;
+	}
+
+	// Check the header.
+	if (aData == nullptr || aSize < sizeof(SceneHeader))
+	{
+		return false;
+	}
+	memcpy(&header, aData, sizeof(header));
+	if (header.magic != SCENE_MAGIC || header.version != SCENE_VERSION || header.fileSize != aSize)
+	{
+		return false;
+	}
+	if ((size_t)header.sectionCount > (aSize - sizeof(SceneHeader)) / sizeof(SceneSection))
+	{
+		return false;
+	}
+
+	// Check that every section is one of the known ones, lies inside the file and starts aligned. The section table
+	// follows the header directly, so it is aligned as well as the data is.
+	myData = (const unsigned char*)aData;
+	mySize = aSize;
+	sections = (const SceneSection*)(myData + sizeof(SceneHeader));
+	for (i = 0; i < header.sectionCount; i++)
+	{
+		section = &sections[i];
+		if (section->type >= SCENE_SECTION_COUNT || section->stride != SECTION_STRIDES[section->type] ||
+			section->offset % SCENE_SECTION_ALIGNMENT != 0 || section->offset > aSize ||
+			(size_t)section->count > (aSize - section->offset) / section->stride || mySections[section->type] != nullptr)
+		{
+			for (i = 0; i < SCENE_SECTION_COUNT; i++)
+			{
+				mySections[i] = nullptr;
+			}
+			myData = nullptr;
+			mySize = 0;
+			return false;
+		}
+		mySections[section->type] = section;
+	}
+
+	return true;
+}
+
+void SceneFile::Shutdown()
+{
+	int i;
+
+	// Release the buffer or the view the data came from, data handed to Open belongs to the caller.
+	delete[] myBuffer;
+	myBuffer = nullptr;
+	if (myMappedView != nullptr)
+	{
+#if defined(_WIN32)
+		UnmapViewOfFile(myMappedView);
+#else
+		munmap(myMappedView, myMappedSize);
+#endif
+		myMappedView = nullptr;
+		myMappedSize = 0;
+	}
+
+	for (i = 0; i < SCENE_SECTION_COUNT; i++)
+	{
+		mySections[i] = nullptr;
+	}
+	myData = nullptr;
+	mySize = 0;
+}
+
+const SceneCamera* SceneFile::GetCameras(int& aCount)
+{
+	return (const SceneCamera*)GetSection(SCENE_SECTION_CAMERAS, aCount);
+}
+
+const SceneTexture* SceneFile::GetTextures(int& aCount)
+{
+	return (const SceneTexture*)GetSection(SCENE_SECTION_TEXTURES, aCount);
+}
+
+const SceneSprite* SceneFile::GetSprites(int& aCount)
+{
+	return (const SceneSprite*)GetSection(SCENE_SECTION_SPRITES, aCount);
+}
+
+const SceneEntity* SceneFile::GetEntities(int& aCount)
+{
+	return (const SceneEntity*)GetSection(SCENE_SECTION_ENTITIES, aCount);
+}
+
+const SceneVector* SceneFile::GetPositions(int& aCount)
+{
+	return (const SceneVector*)GetSection(SCENE_SECTION_POSITIONS, aCount);
+}
+
+const SceneVector* SceneFile::GetSizes(int& aCount)
+{
+	return (const SceneVector*)GetSection(SCENE_SECTION_SIZES, aCount);
+}
+
+const SceneTilemap* SceneFile::GetTilemaps(int& aCount)
+{
+	return (const SceneTilemap*)GetSection(SCENE_SECTION_TILEMAPS, aCount);
+}
+
+const unsigned short* SceneFile::GetTiles(int& aCount)
+{
+	return (const unsigned short*)GetSection(SCENE_SECTION_TILES, aCount);
+}
+
+size_t SceneFile::GetSize()
+{
+	return mySize;
+}
+
+size_t SceneFile::GetOffset(const void* aRecord)
+{
+	// Where a record lies in the file, for reading it from the file again without the whole scene.
+	return (size_t)((const unsigned char*)aRecord - myData);
+}
+
+const void* SceneFile::GetSection(SceneSectionType aType, int& aCount)
+{
+	// A missing section is an empty one.
+	if (mySections[aType] == nullptr || mySections[aType]->count == 0)
+	{
+		aCount = 0;
+		return nullptr;
+	}
+
+	aCount = (int)mySections[aType]->count;
+	return myData + mySections[aType]->offset;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stddef.h>
+#include "SceneFormat.h"
+
+// Read access to a binary scene. The file is either read into one buffer with a single call or mapped read only,
+// and in both cases only the header and the section table are checked: records are handed out where they lie.
+// Indices between records are not checked here, whoever follows one checks it against the count of its section.
+class SceneFile
+{
+public:
+	SceneFile();
+	SceneFile(const SceneFile& aSceneFile) = delete;
+	~SceneFile();
+
+	bool Load(const char* aPath);
+	bool Map(const char* aPath);
+	bool Open(const void* aData, size_t aSize);
+	void Shutdown();
+
+	const SceneCamera* GetCameras(int& aCount);
+	const SceneTexture* GetTextures(int& aCount);
+	const SceneSprite* GetSprites(int& aCount);
+	const SceneEntity* GetEntities(int& aCount);
+	const SceneVector* GetPositions(int& aCount);
+	const SceneVector* GetSizes(int& aCount);
+	const SceneTilemap* GetTilemaps(int& aCount);
+	const unsigned short* GetTiles(int& aCount);
+
+	size_t GetSize();
+	size_t GetOffset(const void* aRecord);
+
+private:
+	const void* GetSection(SceneSectionType aType, int& aCount);
+
+	const unsigned char* myData;
+	size_t mySize;
+	unsigned char* myBuffer;
+	void* myMappedView;
+	size_t myMappedSize;
+	const SceneSection* mySections[SCENE_SECTION_COUNT];
+};
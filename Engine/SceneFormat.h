@@ -0,0 +1,100 @@
+#pragma once
+
+// Binary scene files: a header, a table of sections and the sections themselves, each a flat array of fixed size records.
+// Records never hold pointers, they refer to each other by index, so a file can be mapped anywhere and used in place
+// or copied into engine storage section by section without looking at single records.
+// All values are little endian, the byte order of every platform the engine runs on.
+
+// "SCN1" read as a little endian integer.
+const unsigned int SCENE_MAGIC = 0x314e4353;
+const unsigned int SCENE_VERSION = 1;
+
+// Every section starts on this boundary, wider than any record needs so sections can also be read with SIMD loads.
+const unsigned int SCENE_SECTION_ALIGNMENT = 16;
+
+// Longest texture path a scene can name, including the terminator.
+const int SCENE_PATH_LENGTH = 128;
+
+enum SceneSectionType
+{
+	SCENE_SECTION_CAMERAS,
+	SCENE_SECTION_TEXTURES,
+	SCENE_SECTION_SPRITES,
+	SCENE_SECTION_ENTITIES,
+	SCENE_SECTION_POSITIONS,
+	SCENE_SECTION_SIZES,
+	SCENE_SECTION_TILEMAPS,
+	SCENE_SECTION_TILES,
+	SCENE_SECTION_COUNT
+};
+
+struct SceneHeader
+{
+	unsigned int magic;
+	unsigned int version;
+	unsigned int sectionCount;
+	unsigned int fileSize;
+};
+
+// Where a section lies in the file, its offset counts from the start of the file.
+struct SceneSection
+{
+	unsigned int type;
+	unsigned int stride;
+	unsigned int count;
+	unsigned int offset;
+};
+
+struct SceneCamera
+{
+	float position[3];
+	float rotation[3];
+};
+
+struct SceneTexture
+{
+	char path[SCENE_PATH_LENGTH];
+};
+
+// A sprite is an animated cell range of a texture used as a grid sheet.
+struct SceneSprite
+{
+	int texture;
+	int atlasColumns;
+	int atlasRows;
+	int firstCell;
+	int frameCount;
+	float frameDuration;
+	int looping;
+};
+
+// Two floats, laid out like the XMFLOAT2 the engine keeps sprite positions and sizes in.
+struct SceneVector
+{
+	float x;
+	float y;
+};
+
+// An entity shows a sprite. Its transform is the position and size with the same index, stored in sections of their own
+// the way the engine keeps them, so they are copied over in one block each.
+struct SceneEntity
+{
+	int sprite;
+	float speed;
+	float timeOffset;
+	unsigned int flags;
+};
+
+// The tiles of a tilemap are a row major block of the tiles section, starting at firstTile.
+struct SceneTilemap
+{
+	int width;
+	int height;
+	float tileSize;
+	float originX;
+	float originY;
+	int atlasColumns;
+	int atlasRows;
+	int texture;
+	unsigned int firstTile;
+};
@@ -0,0 +1,440 @@
+#include "SceneWriter.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Longest line of a text scene, long enough for a run of a few hundred tiles.
+static const int MAX_LINE_LENGTH = 4096;
+
+// Most numbers a record line other than a run of tiles holds.
+static const int MAX_LINE_NUMBERS = 8;
+
+static FILE* OpenFile(const char* aPath, const char* aMode)
+{
+	FILE* file;
+
+#if defined(_WIN32)
+	if (fopen_s(&file, aPath, aMode) != 0)
+	{
+		file = nullptr;
+	}
+#else
+	file = fopen(aPath, aMode);
+#endif
+	return file;
+}
+
+// Reads up to aMaxCount numbers separated by spaces, returns how many there were or -1 when something else is in the way.
+static int ReadNumbers(const char* aText, double* aNumbers, int aMaxCount)
+{
+	char* end;
+	int count;
+
+	count = 0;
+	for (;;)
+	{
+		while (isspace((unsigned char)*aText))
+		{
+			aText++;
+		}
+		if (*aText == '\0')
+		{
+			return count;
+		}
+		if (count == aMaxCount)
+		{
+			return -1;
+		}
+		aNumbers[count] = strtod(aText, &end);
+		if (end == aText)
+		{
+			return -1;
+		}
+		aText = end;
+		count++;
+	}
+}
+
+static unsigned int AlignSection(size_t aOffset)
+{
+	return (unsigned int)((aOffset + SCENE_SECTION_ALIGNMENT - 1) / SCENE_SECTION_ALIGNMENT * SCENE_SECTION_ALIGNMENT);
+}
+
+SceneWriter::SceneWriter()
+{
+}
+
+SceneWriter::~SceneWriter()
+{
+}
+
+void SceneWriter::Clear()
+{
+	myCameras.clear();
+	myTextures.clear();
+	mySprites.clear();
+	myEntities.clear();
+	myPositions.clear();
+	mySizes.clear();
+	myTilemaps.clear();
+	myTiles.clear();
+}
+
+int SceneWriter::AddCamera(float aX, float aY, float aZ)
+{
+	SceneCamera camera;
+
+	memset(&camera, 0, sizeof(camera));
+	camera.position[0] = aX;
+	camera.position[1] = aY;
+	camera.position[2] = aZ;
+	myCameras.push_back(camera);
+	return (int)myCameras.size() - 1;
+}
+
+int SceneWriter::AddTexture(const char* aPath)
+{
+	SceneTexture texture;
+
+	// Clear the whole record so the file does not depend on what was on the stack.
+	memset(&texture, 0, sizeof(texture));
+	if (strlen(aPath) >= sizeof(texture.path))
+	{
+		return -1;
+	}
+	snprintf(texture.path, sizeof(texture.path), "%s", aPath);
+	myTextures.push_back(texture);
+	return (int)myTextures.size() - 1;
+}
+
+int SceneWriter::AddSprite(const SceneSprite& aSprite)
+{
+	if (aSprite.texture < 0 || aSprite.texture >= (int)myTextures.size() || aSprite.atlasColumns <= 0 || aSprite.atlasRows <= 0 ||
+		aSprite.firstCell < 0 || aSprite.frameCount <= 0 || aSprite.firstCell + aSprite.frameCount > aSprite.atlasColumns * aSprite.atlasRows)
+	{
+		return -1;
+	}
+	mySprites.push_back(aSprite);
+	return (int)mySprites.size() - 1;
+}
+
+int SceneWriter::AddEntity(const SceneEntity& aEntity, const SceneVector& aPosition, const SceneVector& aSize)
+{
+	if (aEntity.sprite < 0 || aEntity.sprite >= (int)mySprites.size())
+	{
+		return -1;
+	}
+
+	// The transform goes into the sections of its own, under the index of the entity.
+	myEntities.push_back(aEntity);
+	myPositions.push_back(aPosition);
+	mySizes.push_back(aSize);
+	return (int)myEntities.size() - 1;
+}
+
+int SceneWriter::AddTilemap(const SceneTilemap& aTilemap)
+{
+	SceneTilemap tilemap;
+
+	if (aTilemap.width <= 0 || aTilemap.height <= 0 || aTilemap.tileSize <= 0.0f || aTilemap.texture < 0 ||
+		aTilemap.texture >= (int)myTextures.size())
+	{
+		return -1;
+	}
+
+	// Reserve the tiles of the map at the end of the tiles section, all of them empty.
+	tilemap = aTilemap;
+	tilemap.firstTile = (unsigned int)myTiles.size();
+	myTiles.resize(myTiles.size() + (size_t)tilemap.width * tilemap.height, 0);
+	myTilemaps.push_back(tilemap);
+	return (int)myTilemaps.size() - 1;
+}
+
+unsigned short* SceneWriter::GetTiles(int aTilemap)
+{
+	if (aTilemap < 0 || aTilemap >= (int)myTilemaps.size())
+	{
+		return nullptr;
+	}
+	return &myTiles[myTilemaps[aTilemap].firstTile];
+}
+
+bool SceneWriter::ReadText(const char* aPath, int& aErrorLine)
+{
+	FILE* file;
+	char line[MAX_LINE_LENGTH];
+	bool result;
+
+	file = OpenFile(aPath, "r");
+	if (file == nullptr)
+	{
+		aErrorLine = 0;
+		return false;
+	}
+
+	// Add the records line by line, the first line that is not understood stops the conversion.
+	Clear();
+	result = true;
+	aErrorLine = 0;
+	while (result && fgets(line, sizeof(line), file) != nullptr)
+	{
+		aErrorLine++;
+		result = strchr(line, '\n') != nullptr || feof(file);
+		result = result && ReadLine(line);
+	}
+	fclose(file);
+
+	if (result)
+	{
+		aErrorLine = 0;
+	}
+	return result;
+}
+
+void SceneWriter::Build(std::vector<unsigned char>& aFile)
+{
+	SceneHeader header;
+	SceneSection sections[SCENE_SECTION_COUNT];
+	const void* data[SCENE_SECTION_COUNT];
+	size_t offset;
+	int i;
+
+	// List the sections in the order they are laid out.
+	sections[SCENE_SECTION_CAMERAS].count = (unsigned int)myCameras.size();
+	sections[SCENE_SECTION_CAMERAS].stride = sizeof(SceneCamera);
+	data[SCENE_SECTION_CAMERAS] = myCameras.empty() ? nullptr : &myCameras[0];
+	sections[SCENE_SECTION_TEXTURES].count = (unsigned int)myTextures.size();
+	sections[SCENE_SECTION_TEXTURES].stride = sizeof(SceneTexture);
+	data[SCENE_SECTION_TEXTURES] = myTextures.empty() ? nullptr : &myTextures[0];
+	sections[SCENE_SECTION_SPRITES].count = (unsigned int)mySprites.size();
+	sections[SCENE_SECTION_SPRITES].stride = sizeof(SceneSprite);
+	data[SCENE_SECTION_SPRITES] = mySprites.empty() ? nullptr : &mySprites[0];
+	sections[SCENE_SECTION_ENTITIES].count = (unsigned int)myEntities.size();
+	sections[SCENE_SECTION_ENTITIES].stride = sizeof(SceneEntity);
+	data[SCENE_SECTION_ENTITIES] = myEntities.empty() ? nullptr : &myEntities[0];
+	sections[SCENE_SECTION_POSITIONS].count = (unsigned int)myPositions.size();
+	sections[SCENE_SECTION_POSITIONS].stride = sizeof(SceneVector);
+	data[SCENE_SECTION_POSITIONS] = myPositions.empty() ? nullptr : &myPositions[0];
+	sections[SCENE_SECTION_SIZES].count = (unsigned int)mySizes.size();
+	sections[SCENE_SECTION_SIZES].stride = sizeof(SceneVector);
+	data[SCENE_SECTION_SIZES] = mySizes.empty() ? nullptr : &mySizes[0];
+	sections[SCENE_SECTION_TILEMAPS].count = (unsigned int)myTilemaps.size();
+	sections[SCENE_SECTION_TILEMAPS].stride = sizeof(SceneTilemap);
+	data[SCENE_SECTION_TILEMAPS] = myTilemaps.empty() ? nullptr : &myTilemaps[0];
+	sections[SCENE_SECTION_TILES].count = (unsigned int)myTiles.size();
+	sections[SCENE_SECTION_TILES].stride = sizeof(unsigned short);
+	data[SCENE_SECTION_TILES] = myTiles.empty() ? nullptr : &myTiles[0];
+
+	// Place every section on the next aligned offset after the section table.
+	offset = sizeof(SceneHeader) + sizeof(sections);
+	for (i = 0; i < SCENE_SECTION_COUNT; i++)
+	{
+		sections[i].type = (unsigned int)i;
+		sections[i].offset = AlignSection(offset);
+		offset = sections[i].offset + (size_t)sections[i].count * sections[i].stride;
+	}
+
+	header.magic = SCENE_MAGIC;
+	header.version = SCENE_VERSION;
+	header.sectionCount = SCENE_SECTION_COUNT;
+	header.fileSize = (unsigned int)offset;
+
+	// Copy each section over in one block, the padding between them stays zero.
+	aFile.assign(offset, 0);
+	memcpy(&aFile[0], &header, sizeof(header));
+	memcpy(&aFile[sizeof(header)], sections, sizeof(sections));
+	for (i = 0; i < SCENE_SECTION_COUNT; i++)
+	{
+		if (sections[i].count > 0)
+		{
+			memcpy(&aFile[sections[i].offset], data[i], (size_t)sections[i].count * sections[i].stride);
+		}
+	}
+}
+
+bool SceneWriter::Write(const char* aPath)
+{
+	std::vector<unsigned char> image;
+	FILE* file;
+	size_t written;
+
+	Build(image);
+
+	file = OpenFile(aPath, "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+	written = fwrite(&image[0], 1, image.size(), file);
+	fclose(file);
+
+	return written == image.size();
+}
+
+bool SceneWriter::ReadLine(char* aLine)
+{
+	double numbers[MAX_LINE_NUMBERS];
+	SceneSprite sprite;
+	SceneEntity entity;
+	SceneVector position, size;
+	SceneTilemap tilemap;
+	const SceneTilemap* last;
+	unsigned short* tiles;
+	char* key;
+	char* value;
+	char* end;
+	int count, x, y, width, height, i, j;
+
+	// Cut the comment and the line break off.
+	end = strchr(aLine, '#');
+	if (end != nullptr)
+	{
+		*end = '\0';
+	}
+	end = aLine + strlen(aLine);
+	while (end > aLine && isspace((unsigned char)end[-1]))
+	{
+		end--;
+	}
+	*end = '\0';
+
+	// The record type runs up to the first space, its values follow.
+	key = aLine;
+	while (isspace((unsigned char)*key))
+	{
+		key++;
+	}
+	if (*key == '\0')
+	{
+		return true;
+	}
+	value = key;
+	while (*value != '\0' && !isspace((unsigned char)*value))
+	{
+		value++;
+	}
+	if (*value != '\0')
+	{
+		*value = '\0';
+		value++;
+		while (isspace((unsigned char)*value))
+		{
+			value++;
+		}
+	}
+
+	if (strcmp(key, "texture") == 0)
+	{
+		return *value != '\0' && AddTexture(value) >= 0;
+	}
+
+	// A run of tiles is the only record whose length varies, it is read as it goes.
+	if (strcmp(key, "tiles") == 0)
+	{
+		if (myTilemaps.empty())
+		{
+			return false;
+		}
+		last = &myTilemaps.back();
+		x = (int)strtol(value, &end, 10);
+		if (end == value)
+		{
+			return false;
+		}
+		value = end;
+		y = (int)strtol(value, &end, 10);
+		if (end == value || x < 0 || y < 0 || y >= last->height)
+		{
+			return false;
+		}
+		tiles = &myTiles[last->firstTile + (size_t)y * last->width];
+		for (;;)
+		{
+			value = end;
+			i = (int)strtol(value, &end, 10);
+			if (end == value)
+			{
+				break;
+			}
+			if (x >= last->width || i < 0 || i > 0xffff)
+			{
+				return false;
+			}
+			tiles[x] = (unsigned short)i;
+			x++;
+		}
+		while (isspace((unsigned char)*end))
+		{
+			end++;
+		}
+		return *end == '\0';
+	}
+
+	count = ReadNumbers(value, numbers, MAX_LINE_NUMBERS);
+	if (strcmp(key, "camera") == 0 && count == 3)
+	{
+		return AddCamera((float)numbers[0], (float)numbers[1], (float)numbers[2]) >= 0;
+	}
+	if (strcmp(key, "sprite") == 0 && count == 7)
+	{
+		sprite.texture = (int)numbers[0];
+		sprite.atlasColumns = (int)numbers[1];
+		sprite.atlasRows = (int)numbers[2];
+		sprite.firstCell = (int)numbers[3];
+		sprite.frameCount = (int)numbers[4];
+		sprite.frameDuration = (float)numbers[5];
+		sprite.looping = numbers[6] != 0.0 ? 1 : 0;
+		return AddSprite(sprite) >= 0;
+	}
+	if (strcmp(key, "entity") == 0 && count == 7)
+	{
+		entity.sprite = (int)numbers[0];
+		position.x = (float)numbers[1];
+		position.y = (float)numbers[2];
+		size.x = (float)numbers[3];
+		size.y = (float)numbers[4];
+		entity.speed = (float)numbers[5];
+		entity.timeOffset = (float)numbers[6];
+		entity.flags = 0;
+		return AddEntity(entity, position, size) >= 0;
+	}
+	if (strcmp(key, "tilemap") == 0 && count == 8)
+	{
+		tilemap.width = (int)numbers[0];
+		tilemap.height = (int)numbers[1];
+		tilemap.tileSize = (float)numbers[2];
+		tilemap.originX = (float)numbers[3];
+		tilemap.originY = (float)numbers[4];
+		tilemap.atlasColumns = (int)numbers[5];
+		tilemap.atlasRows = (int)numbers[6];
+		tilemap.texture = (int)numbers[7];
+		tilemap.firstTile = 0;
+		return AddTilemap(tilemap) >= 0;
+	}
+	if (strcmp(key, "fill") == 0 && count == 5 && !myTilemaps.empty())
+	{
+		last = &myTilemaps.back();
+		x = (int)numbers[0];
+		y = (int)numbers[1];
+		width = (int)numbers[2];
+		height = (int)numbers[3];
+		if (x < 0 || y < 0 || width < 0 || height < 0 || x + width > last->width || y + height > last->height ||
+			numbers[4] < 0.0 || numbers[4] > 65535.0)
+		{
+			return false;
+		}
+		for (j = y; j < y + height; j++)
+		{
+			tiles = &myTiles[last->firstTile + (size_t)j * last->width];
+			for (i = x; i < x + width; i++)
+			{
+				tiles[i] = (unsigned short)numbers[4];
+			}
+		}
+		return true;
+	}
+
+	// Unknown records and wrong value counts are mistakes in the scene, not something to skip over quietly.
+	return false;
+}
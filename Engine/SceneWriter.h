@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include "SceneFormat.h"
+
+// Builds binary scenes, from code or from a text scene, and lays them out the way SceneFile reads them.
+// Text scenes hold one record per line, where # starts a comment:
+//   camera <x> <y> <z>
+//   texture <path>
+//   sprite <texture> <columns> <rows> <first cell> <frame count> <frame duration> <looping>
+//   entity <sprite> <x> <y> <width> <height> <speed> <time offset>
+//   tilemap <width> <height> <tile size> <origin x> <origin y> <columns> <rows> <texture>
+//   tiles <x> <y> <tile>...        a run of tiles along a row of the last tilemap
+//   fill <x> <y> <width> <height> <tile>
+class SceneWriter
+{
+public:
+	SceneWriter();
+	SceneWriter(const SceneWriter& aSceneWriter) = delete;
+	~SceneWriter();
+
+	void Clear();
+
+	int AddCamera(float aX, float aY, float aZ);
+	int AddTexture(const char* aPath);
+	int AddSprite(const SceneSprite& aSprite);
+	int AddEntity(const SceneEntity& aEntity, const SceneVector& aPosition, const SceneVector& aSize);
+	int AddTilemap(const SceneTilemap& aTilemap);
+	unsigned short* GetTiles(int aTilemap);
+
+	bool ReadText(const char* aPath, int& aErrorLine);
+	void Build(std::vector<unsigned char>& aFile);
+	bool Write(const char* aPath);
+
+private:
+	bool ReadLine(char* aLine);
+
+	std::vector<SceneCamera> myCameras;
+	std::vector<SceneTexture> myTextures;
+	std::vector<SceneSprite> mySprites;
+	std::vector<SceneEntity> myEntities;
+	std::vector<SceneVector> myPositions;
+	std::vector<SceneVector> mySizes;
+	std::vector<SceneTilemap> myTilemaps;
+	std::vector<unsigned short> myTiles;
+};
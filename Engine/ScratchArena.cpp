@@ -0,0 +1,82 @@
+#include "ScratchArena.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Releases the arena of a thread when the thread exits.
+struct ThreadScratch
+{
+	LinearArena arena;
+
+	~ThreadScratch()
+	{
+		arena.Shutdown();
+	}
+};
+
+static thread_local ThreadScratch threadScratch;
+
+ScratchArena::ScratchArena()
+{
+	// Remember how far the thread's arena was used so the destructor can release everything after it.
+	myArena = &GetThreadArena();
+	myMarker = myArena->GetMarker();
+	myHeapBlocks = nullptr;
+}
+
+ScratchArena::~ScratchArena()
+{
+	unsigned char* block;
+
+	// Free the blocks that did not fit in the arena, each one starts with a pointer to the one allocated before it.
+	while (myHeapBlocks != nullptr)
+	{
+		block = myHeapBlocks;
+		memcpy(&myHeapBlocks, block, sizeof(myHeapBlocks));
+		free(block);
+	}
+	myArena->Rewind(myMarker);
+}
+
+void* ScratchArena::Allocate(size_t aSize, size_t aAlignment)
+{
+	void* memory;
+
+	memory = myArena->Allocate(aSize, aAlignment);
+	if (memory == nullptr)
+	{
+		memory = AllocateFromHeap(aSize, aAlignment);
+	}
+	return memory;
+}
+
+void* ScratchArena::AllocateFromHeap(size_t aSize, size_t aAlignment)
+{
+	unsigned char* block;
+	size_t start;
+
+	// Room for the link to the previous block and for rounding the start up to the alignment.
+	if (aSize > (size_t)-1 - aAlignment - sizeof(myHeapBlocks))
+	{
+		return nullptr;
+	}
+	block = (unsigned char*)malloc(sizeof(myHeapBlocks) + aAlignment + aSize);
+	if (block == nullptr)
+	{
+		return nullptr;
+	}
+	memcpy(block, &myHeapBlocks, sizeof(myHeapBlocks));
+	myHeapBlocks = block;
+
+	start = ((size_t)block + sizeof(myHeapBlocks) + aAlignment - 1) & ~(aAlignment - 1);
+	return (void*)start;
+}
+
+LinearArena& ScratchArena::GetThreadArena()
+{
+	// Create the arena on first use, threads that never need scratch memory never pay for it.
+	if (threadScratch.arena.GetCapacity() == 0)
+	{
+		threadScratch.arena.Initialize(SCRATCH_ARENA_SIZE);
+	}
+	return threadScratch.arena;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "LinearArena.h"
+
+// Size of the scratch arena of each thread, created the first time the thread uses one. Enough for a 2048x2048
+// texture to be read and flipped, larger requests are taken from the heap.
+const size_t SCRATCH_ARENA_SIZE = 32 * 1024 * 1024;
+
+// Temporary memory for the length of a scope, taken from an arena owned by the calling thread.
+// Everything allocated through a scratch arena is released when it goes out of scope. Scratch arenas nest, an inner
+// one only releases what was allocated after it was created. What does not fit in the arena comes from the heap and is
+// freed along with the scope, so a large request is slower but never fails for lack of arena space.
+class ScratchArena
+{
+public:
+	ScratchArena();
+	ScratchArena(const ScratchArena& aScratchArena) = delete;
+	~ScratchArena();
+
+	void* Allocate(size_t aSize, size_t aAlignment = ARENA_DEFAULT_ALIGNMENT);
+	template<typename T> T* AllocateArray(int aCount)
+	{
+		return (T*)Allocate(sizeof(T) * aCount, alignof(T) > ARENA_DEFAULT_ALIGNMENT ? alignof(T) : ARENA_DEFAULT_ALIGNMENT);
+	}
+
+	static LinearArena& GetThreadArena();
+
+private:
+	void* AllocateFromHeap(size_t aSize, size_t aAlignment);
+
+	LinearArena* myArena;
+	size_t myMarker;
+	unsigned char* myHeapBlocks;
+};
@@ -1,16 +1,143 @@
 #include "Shader.h"
+#include "Material.h"
+#include "QuadIndexBuffer.h"
+#include "SpriteVertex.h"
+#include "VertexFormat.h"
+#include <stdio.h>
+
+// The textured pixel shader with texels below the alpha test threshold discarded, so cut out sprites can write depth.
+// It reads what the textured vertex shader outputs and is compiled alongside the pixel shader file.
+static const char ALPHA_TEST_PIXEL_SHADER[] =
+	"Texture2D shaderTexture;\n"
+	"SamplerState SampleType;\n"
+	"struct PixelInputType\n"
+	"{\n"
+	"	float4 position : SV_POSITION;\n"
+	"	float2 tex : TEXCOORD0;\n"
+	"};\n"
+	"float4 PixelShader_AlphaTested(PixelInputType input) : SV_TARGET\n"
+	"{\n"
+	"	float4 color = shaderTexture.Sample(SampleType, input.tex);\n"
+	"	clip(color.a - ALPHA_THRESHOLD);\n"
+	"	return color;\n"
+	"}\n";
+
+// The textured pixel shader lit by the point lights of its screen tile, for sprites with a normal map. The light renderer binds the
+// normal map, the lights and the tile lists along with the constants that say how the screen is split into tiles. Every light
+// stands a little above the sprites, so their relief catches the light from the side it comes from. It is compiled once with
+// and once without the alpha test.
+static const char LIT_PIXEL_SHADER[] =
+	"struct PointLight\n"
+	"{\n"
+	"	float2 position;\n"
+	"	float radius;\n"
+	"	float3 color;\n"
+	"};\n"
+	"Texture2D shaderTexture : register(t0);\n"
+	"Texture2D normalTexture : register(t1);\n"
+	"StructuredBuffer<PointLight> lights : register(t2);\n"
+	"Buffer<uint2> tileRanges : register(t3);\n"
+	"Buffer<uint> tileLights : register(t4);\n"
+	"SamplerState SampleType : register(s0);\n"
+	"cbuffer LightBuffer : register(b0)\n"
+	"{\n"
+	"	uint tileSize;\n"
+	"	uint tileCountX;\n"
+	"	float lightHeight;\n"
+	"	float padding;\n"
+	"	float4 ambientColor;\n"
+	"};\n"
+	"struct PixelInputType\n"
+	"{\n"
+	"	float4 position : SV_POSITION;\n"
+	"	float2 tex : TEXCOORD0;\n"
+	"};\n"
+	"float4 PixelShader_Lit(PixelInputType input) : SV_TARGET\n"
+	"{\n"
+	"	float4 color = shaderTexture.Sample(SampleType, input.tex);\n"
+	"#if ALPHA_TEST\n"
+	"	clip(color.a - ALPHA_THRESHOLD);\n"
+	"#endif\n"
+	"	float3 normal = normalize(normalTexture.Sample(SampleType, input.tex).xyz * 2.0 - 1.0);\n"
+	"	uint2 tile = (uint2)input.position.xy / tileSize;\n"
+	"	uint2 range = tileRanges[tile.y * tileCountX + tile.x];\n"
+	"	float3 light = ambientColor.rgb;\n"
+	"	for (uint i = 0; i < range.y; i++)\n"
+	"	{\n"
+	"		PointLight pointLight = lights[tileLights[range.x + i]];\n"
+	"		float3 toLight = float3(pointLight.position - input.position.xy, lightHeight);\n"
+	"		float lightDistance = length(toLight);\n"
+	"		float falloff = saturate(1.0 - lightDistance / pointLight.radius);\n"
+	"		light += pointLight.color * (falloff * falloff * saturate(dot(normal, toLight / lightDistance)));\n"
+	"	}\n"
+	"	return float4(color.rgb * light, color.a);\n"
+	"}\n";
+
+// The textured vertex and pixel shaders for sprites drawn from a texture array, the slice of the image comes with every vertex.
+// They are unlit, the images of an array come without normal maps. The pixel shader is compiled once with and once without
+// the alpha test.
+static const char TEXTURE_ARRAY_VERTEX_SHADER[] =
+	"cbuffer MatrixBuffer\n"
+	"{\n"
+	"	matrix worldMatrix;\n"
+	"	matrix viewMatrix;\n"
+	"	matrix projectionMatrix;\n"
+	"};\n"
+	"struct VertexInputType\n"
+	"{\n"
+	"	float2 position : POSITION;\n"
+	"	float2 tex : TEXCOORD0;\n"
+	"	uint2 slice : SLICE;\n"
+	"};\n"
+	"struct PixelInputType\n"
+	"{\n"
+	"	float4 position : SV_POSITION;\n"
+	"	float3 tex : TEXCOORD0;\n"
+	"};\n"
+	"PixelInputType VertexShader_TexturedArray(VertexInputType input)\n"
+	"{\n"
+	"	PixelInputType output;\n"
+	"	output.position = mul(float4(input.position, 0.0, 1.0), worldMatrix);\n"
+	"	output.position = mul(output.position, viewMatrix);\n"
+	"	output.position = mul(output.position, projectionMatrix);\n"
+	"	output.tex = float3(input.tex, (float)input.slice.x);\n"
+	"	return output;\n"
+	"}\n";
+
+static const char TEXTURE_ARRAY_PIXEL_SHADER[] =
+	"Texture2DArray shaderTexture;\n"
+	"SamplerState SampleType;\n"
+	"struct PixelInputType\n"
+	"{\n"
+	"	float4 position : SV_POSITION;\n"
+	"	float3 tex : TEXCOORD0;\n"
+	"};\n"
+	"float4 PixelShader_TexturedArray(PixelInputType input) : SV_TARGET\n"
+	"{\n"
+	"	float4 color = shaderTexture.Sample(SampleType, input.tex);\n"
+	"#if ALPHA_TEST\n"
+	"	clip(color.a - ALPHA_THRESHOLD);\n"
+	"#endif\n"
+	"	return color;\n"
+	"}\n";
 
 Shader::Shader()
 {
 	myVertexShader = nullptr;
 	myPixelShader = nullptr;
+	myAlphaTestPixelShader = nullptr;
+	myLitPixelShaders[0] = nullptr;
+	myLitPixelShaders[1] = nullptr;
+	myArrayVertexShader = nullptr;
+	myArrayPixelShaders[0] = nullptr;
+	myArrayPixelShaders[1] = nullptr;
 	myInputLayout = nullptr;
+	myArrayInputLayout = nullptr;
 	myMatrixBuffer = nullptr;
 	mySampleState = nullptr;
-}
-
-Shader::Shader(const Shader& aShader)
-{
+	myAlphaTest = false;
+	myLit = false;
+	myTextureArray = false;
 }
 
 Shader::~Shader()
@@ -54,13 +181,51 @@ bool Shader::Render(ID3D11DeviceContext& aDeviceContext, int aIndexCount, XMMATR
 	return true;
 }
 
+bool Shader::SetParameters(ID3D11DeviceContext& aDeviceContext, XMMATRIX& aWorldMatrix, XMMATRIX& aViewMatrix,
+	XMMATRIX& aProjectionMatrix, ID3D11ShaderResourceView& aTexture)
+{
+	// Set the shader parameters once for several draws that share them.
+	return SetShaderParameters(aDeviceContext, aWorldMatrix, aViewMatrix, aProjectionMatrix, &aTexture);
+}
+
+void Shader::Draw(ID3D11DeviceContext& aDeviceContext, int aIndexCount)
+{
+	// Render the bound buffers with the parameters set by the last call to SetParameters.
+	RenderShader(aDeviceContext, aIndexCount);
+}
+
+void Shader::SetAlphaTest(bool aEnabled)
+{
+	// Pick the pixel shader the following draws use.
+	myAlphaTest = aEnabled;
+}
+
+void Shader::SetLit(bool aEnabled)
+{
+	// Light the following draws with the lights the light renderer bound, or draw them unlit again.
+	myLit = aEnabled;
+}
+
+void Shader::SetTextureArray(bool aEnabled)
+{
+	// Draw the following draws from sprite array vertices and a texture array, they are never lit.
+	myTextureArray = aEnabled;
+}
+
 bool Shader::InitializeShader(ID3D11Device& aDevice, HWND& aHWND, WCHAR* aVertexShader, WCHAR* aPixelShader)
 {
 	HRESULT result;
 	ID3D10Blob* errorMessage;
 	ID3D10Blob* vertexShaderBuffer;
 	ID3D10Blob* pixelShaderBuffer;
-	D3D11_INPUT_ELEMENT_DESC polygonLayout[2];
+	ID3D10Blob* alphaTestShaderBuffer;
+	ID3D10Blob* litShaderBuffer;
+	ID3D10Blob* arrayShaderBuffer;
+	D3D_SHADER_MACRO defines[3];
+	char threshold[16];
+	int i;
+	D3D11_INPUT_ELEMENT_DESC polygonLayout[VertexFormat<SpriteVertex>::ELEMENT_COUNT];
+	D3D11_INPUT_ELEMENT_DESC arrayLayout[VertexFormat<SpriteArrayVertex>::ELEMENT_COUNT];
 	unsigned int numElements;
 	D3D11_BUFFER_DESC matrixBufferDesc;
 	D3D11_SAMPLER_DESC samplerDesc;
@@ -69,6 +234,7 @@ bool Shader::InitializeShader(ID3D11Device& aDevice, HWND& aHWND, WCHAR* aVertex
 	errorMessage = nullptr;
 	vertexShaderBuffer = nullptr;
 	pixelShaderBuffer = nullptr;
+	alphaTestShaderBuffer = nullptr;
 
 	// Compile the vertex shader code.
 	result = D3DCompileFromFile(aVertexShader, nullptr, nullptr, "VertexShader_Textured", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0,
@@ -108,6 +274,23 @@ bool Shader::InitializeShader(ID3D11Device& aDevice, HWND& aHWND, WCHAR* aVertex
 		return false;
 	}
 
+	// Compile the alpha tested pixel shader code with the threshold of the material classification.
+	sprintf_s(threshold, sizeof(threshold), "%.6f", ALPHA_TEST_THRESHOLD / 255.0f);
+	defines[0].Name = "ALPHA_THRESHOLD";
+	defines[0].Definition = threshold;
+	defines[1].Name = nullptr;
+	defines[1].Definition = nullptr;
+	result = D3DCompile(ALPHA_TEST_PIXEL_SHADER, sizeof(ALPHA_TEST_PIXEL_SHADER) - 1, "AlphaTest", defines, nullptr, "PixelShader_AlphaTested",
+		"ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, &alphaTestShaderBuffer, &errorMessage);
+	if (FAILED(result))
+	{
+		if (errorMessage != nullptr)
+		{
+			OutputShaderErrorMessage(errorMessage, aHWND, aPixelShader);
+		}
+		return false;
+	}
+
 	// Create the vertex shader from the buffer.
 	result = aDevice.CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), nullptr, &myVertexShader);
 	if (FAILED(result))
@@ -122,23 +305,16 @@ bool Shader::InitializeShader(ID3D11Device& aDevice, HWND& aHWND, WCHAR* aVertex
 		return false;
 	}
 
-	// Create the vertex input layout description.
-	// This setup needs to match the VertexType stucture in the ModelClass and in the shader.
-	polygonLayout[0].SemanticName = "POSITION";
-	polygonLayout[0].SemanticIndex = 0;
-	polygonLayout[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	polygonLayout[0].InputSlot = 0;
-	polygonLayout[0].AlignedByteOffset = 0;
-	polygonLayout[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	polygonLayout[0].InstanceDataStepRate = 0;
-
-	polygonLayout[1].SemanticName = "TEXCOORD";
-	polygonLayout[1].SemanticIndex = 0;
-	polygonLayout[1].Format = DXGI_FORMAT_R32G32_FLOAT;
-	polygonLayout[1].InputSlot = 0;
-	polygonLayout[1].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-	polygonLayout[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	polygonLayout[1].InstanceDataStepRate = 0;
+	// Create the alpha tested pixel shader from the buffer.
+	result = aDevice.CreatePixelShader(alphaTestShaderBuffer->GetBufferPointer(), alphaTestShaderBuffer->GetBufferSize(), nullptr,
+		&myAlphaTestPixelShader);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	// Create the vertex input layout description from the sprite vertex, the one vertex format all geometry uses.
+	VertexFormat<SpriteVertex>::GetInputElements(polygonLayout);
 
 	// Get a count of the elements in the layout.
 	numElements = sizeof(polygonLayout) / sizeof(polygonLayout[0]);
@@ -158,6 +334,89 @@ bool Shader::InitializeShader(ID3D11Device& aDevice, HWND& aHWND, WCHAR* aVertex
 	pixelShaderBuffer->Release();
 	pixelShaderBuffer = nullptr;
 
+	alphaTestShaderBuffer->Release();
+	alphaTestShaderBuffer = nullptr;
+
+	// Compile and create the lit pixel shaders, without the alpha test and with it.
+	defines[1].Name = "ALPHA_TEST";
+	defines[2].Name = nullptr;
+	defines[2].Definition = nullptr;
+	for (i = 0; i < 2; i++)
+	{
+		litShaderBuffer = nullptr;
+		defines[1].Definition = i == 0 ? "0" : "1";
+		result = D3DCompile(LIT_PIXEL_SHADER, sizeof(LIT_PIXEL_SHADER) - 1, "Lit", defines, nullptr, "PixelShader_Lit", "ps_5_0",
+			D3D10_SHADER_ENABLE_STRICTNESS, 0, &litShaderBuffer, &errorMessage);
+		if (FAILED(result))
+		{
+			if (errorMessage != nullptr)
+			{
+				OutputShaderErrorMessage(errorMessage, aHWND, aPixelShader);
+			}
+			return false;
+		}
+
+		result = aDevice.CreatePixelShader(litShaderBuffer->GetBufferPointer(), litShaderBuffer->GetBufferSize(), nullptr, &myLitPixelShaders[i]);
+		litShaderBuffer->Release();
+		litShaderBuffer = nullptr;
+		if (FAILED(result))
+		{
+			return false;
+		}
+	}
+
+	// Compile and create the texture array pixel shaders the same way.
+	for (i = 0; i < 2; i++)
+	{
+		arrayShaderBuffer = nullptr;
+		defines[1].Definition = i == 0 ? "0" : "1";
+		result = D3DCompile(TEXTURE_ARRAY_PIXEL_SHADER, sizeof(TEXTURE_ARRAY_PIXEL_SHADER) - 1, "TextureArray", defines, nullptr,
+			"PixelShader_TexturedArray", "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, &arrayShaderBuffer, &errorMessage);
+		if (FAILED(result))
+		{
+			if (errorMessage != nullptr)
+			{
+				OutputShaderErrorMessage(errorMessage, aHWND, aPixelShader);
+			}
+			return false;
+		}
+
+		result = aDevice.CreatePixelShader(arrayShaderBuffer->GetBufferPointer(), arrayShaderBuffer->GetBufferSize(), nullptr,
+			&myArrayPixelShaders[i]);
+		arrayShaderBuffer->Release();
+		arrayShaderBuffer = nullptr;
+		if (FAILED(result))
+		{
+			return false;
+		}
+	}
+
+	// Compile and create the texture array vertex shader along with the input layout of the sprite array vertex.
+	arrayShaderBuffer = nullptr;
+	result = D3DCompile(TEXTURE_ARRAY_VERTEX_SHADER, sizeof(TEXTURE_ARRAY_VERTEX_SHADER) - 1, "TextureArray", nullptr, nullptr,
+		"VertexShader_TexturedArray", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, &arrayShaderBuffer, &errorMessage);
+	if (FAILED(result))
+	{
+		if (errorMessage != nullptr)
+		{
+			OutputShaderErrorMessage(errorMessage, aHWND, aVertexShader);
+		}
+		return false;
+	}
+	result = aDevice.CreateVertexShader(arrayShaderBuffer->GetBufferPointer(), arrayShaderBuffer->GetBufferSize(), nullptr, &myArrayVertexShader);
+	if (SUCCEEDED(result))
+	{
+		VertexFormat<SpriteArrayVertex>::GetInputElements(arrayLayout);
+		result = aDevice.CreateInputLayout(arrayLayout, sizeof(arrayLayout) / sizeof(arrayLayout[0]), arrayShaderBuffer->GetBufferPointer(),
+			arrayShaderBuffer->GetBufferSize(), &myArrayInputLayout);
+	}
+	arrayShaderBuffer->Release();
+	arrayShaderBuffer = nullptr;
+	if (FAILED(result))
+	{
+		return false;
+	}
+
 	// Setup the description of the dynamic matrix constant buffer that is in the vertex shader.
 	matrixBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
 	matrixBufferDesc.ByteWidth = sizeof(MatrixBufferType);
@@ -200,6 +459,8 @@ bool Shader::InitializeShader(ID3D11Device& aDevice, HWND& aHWND, WCHAR* aVertex
 
 void Shader::ShutdownShader()
 {
+	int i;
+
 	// Release the sampler state.
 	if (mySampleState != nullptr)
 	{
@@ -212,19 +473,47 @@ void Shader::ShutdownShader()
 		myMatrixBuffer->Release();
 		myMatrixBuffer = nullptr;
 	}
-	// Release the layout.
+	// Release the layouts.
+	if (myArrayInputLayout != nullptr)
+	{
+		myArrayInputLayout->Release();
+		myArrayInputLayout = nullptr;
+	}
 	if (myInputLayout != nullptr)
 	{
 		myInputLayout->Release();
 		myInputLayout = nullptr;
 	}
-	// Release the pixel shader.
+	// Release the pixel shaders.
+	for (i = 0; i < 2; i++)
+	{
+		if (myArrayPixelShaders[i] != nullptr)
+		{
+			myArrayPixelShaders[i]->Release();
+			myArrayPixelShaders[i] = nullptr;
+		}
+		if (myLitPixelShaders[i] != nullptr)
+		{
+			myLitPixelShaders[i]->Release();
+			myLitPixelShaders[i] = nullptr;
+		}
+	}
+	if (myAlphaTestPixelShader != nullptr)
+	{
+		myAlphaTestPixelShader->Release();
+		myAlphaTestPixelShader = nullptr;
+	}
 	if (myPixelShader != nullptr)
 	{
 		myPixelShader->Release();
 		myPixelShader = nullptr;
 	}
-	// Release the vertex shader.
+	// Release the vertex shaders.
+	if (myArrayVertexShader != nullptr)
+	{
+		myArrayVertexShader->Release();
+		myArrayVertexShader = nullptr;
+	}
 	if (myVertexShader != nullptr)
 	{
 		myVertexShader->Release();
@@ -311,16 +600,41 @@ bool Shader::SetShaderParameters(ID3D11DeviceContext& aDeviceContext, XMMATRIX&
 
 void Shader::RenderShader(ID3D11DeviceContext& aDeviceContext, int aIndexCount)
 {
-	// Set the vertex input layout.
-	aDeviceContext.IASetInputLayout(myInputLayout);
+	int baseVertex, count;
 
-	// Set the vertex and pixel shaders that will be used to render this triangle.
-	aDeviceContext.VSSetShader(myVertexShader, nullptr, 0);
-	aDeviceContext.PSSetShader(myPixelShader, nullptr, 0);
+	// Set the vertex input layout and the vertex and pixel shaders that will be used to render this triangle. Draws from a
+	// texture array read the vertices with the slice and are never lit.
+	if (myTextureArray)
+	{
+		aDeviceContext.IASetInputLayout(myArrayInputLayout);
+		aDeviceContext.VSSetShader(myArrayVertexShader, nullptr, 0);
+		aDeviceContext.PSSetShader(myArrayPixelShaders[myAlphaTest ? 1 : 0], nullptr, 0);
+	}
+	else
+	{
+		aDeviceContext.IASetInputLayout(myInputLayout);
+		aDeviceContext.VSSetShader(myVertexShader, nullptr, 0);
+		if (myLit)
+		{
+			aDeviceContext.PSSetShader(myLitPixelShaders[myAlphaTest ? 1 : 0], nullptr, 0);
+		}
+		else
+		{
+			aDeviceContext.PSSetShader(myAlphaTest ? myAlphaTestPixelShader : myPixelShader, nullptr, 0);
+		}
+	}
 
 	// Set the sampler state in the pixel shader.
 	aDeviceContext.PSSetSamplers(0, 1, &mySampleState);
 
-	// Render the triangle.
-	aDeviceContext.DrawIndexed(aIndexCount, 0, 0);
-}
\ No newline at end of file
+	// Render the triangles. All geometry is quads indexed by the shared 16 bit quad index buffer, so a draw of more quads
+	// than it addresses is split into spans, each one reusing the indices from a higher base vertex.
+	baseVertex = 0;
+	while (aIndexCount > 0)
+	{
+		count = aIndexCount < QUAD_INDEX_BUFFER_QUADS * 6 ? aIndexCount : QUAD_INDEX_BUFFER_QUADS * 6;
+		aDeviceContext.DrawIndexed(count, 0, baseVertex);
+		aIndexCount -= count;
+		baseVertex += QUAD_INDEX_BUFFER_QUADS * 4;
+	}
+}
\ No newline at end of file
@@ -10,7 +10,7 @@ class Shader
 {
 public:
 	Shader();
-	Shader(const Shader& aShader);
+	Shader(const Shader& aShader) = delete;
 	~Shader();
 
 	bool Initialize(ID3D11Device& aDevice, HWND& aHWND);
@@ -18,6 +18,14 @@ public:
 	bool Render(ID3D11DeviceContext& aDeviceContext, int aIndexCount, XMMATRIX& aWorldMatrix, XMMATRIX& aViewMatrix,
 		XMMATRIX& aProjectionMatrix, ID3D11ShaderResourceView& aTexture);
 
+	bool SetParameters(ID3D11DeviceContext& aDeviceContext, XMMATRIX& aWorldMatrix, XMMATRIX& aViewMatrix,
+		XMMATRIX& aProjectionMatrix, ID3D11ShaderResourceView& aTexture);
+	void Draw(ID3D11DeviceContext& aDeviceContext, int aIndexCount);
+
+	void SetAlphaTest(bool aEnabled);
+	void SetLit(bool aEnabled);
+	void SetTextureArray(bool aEnabled);
+
 private:
 	struct MatrixBufferType
 	{
@@ -36,7 +44,15 @@ private:
 
 	ID3D11VertexShader* myVertexShader;
 	ID3D11PixelShader* myPixelShader;
+	ID3D11PixelShader* myAlphaTestPixelShader;
+	ID3D11PixelShader* myLitPixelShaders[2];
+	ID3D11VertexShader* myArrayVertexShader;
+	ID3D11PixelShader* myArrayPixelShaders[2];
 	ID3D11InputLayout* myInputLayout;
+	ID3D11InputLayout* myArrayInputLayout;
 	ID3D11Buffer* myMatrixBuffer;
 	ID3D11SamplerState* mySampleState;
+	bool myAlphaTest;
+	bool myLit;
+	bool myTextureArray;
 };
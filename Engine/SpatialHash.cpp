@@ -0,0 +1,237 @@
+#include "SpatialHash.h"
+#include "AllocationTracker.h"
+#include <math.h>
+
+// Number of pieces the bucket list is split into per thread, more than one so threads that finish early can help out.
+static const int TASKS_PER_THREAD = 4;
+
+SpatialHash::SpatialHash()
+{
+	myBoxes = nullptr;
+	myCount = 0;
+	myMaxBoxes = 0;
+	myBucketMask = 0;
+	myInverseCellSize = 1.0f;
+}
+
+SpatialHash::~SpatialHash()
+{
+}
+
+bool SpatialHash::Initialize(int aMaxBoxes, float aCellSize, int aBucketCount)
+{
+	int bucketCount;
+
+	if (aMaxBoxes <= 0 || aCellSize <= 0.0f || aBucketCount <= 0)
+	{
+		return false;
+	}
+
+	myMaxBoxes = aMaxBoxes;
+	myCount = 0;
+	myInverseCellSize = 1.0f / aCellSize;
+
+	// Round the bucket count up to a power of two so the hash can be masked.
+	bucketCount = 1;
+	while (bucketCount < aBucketCount)
+	{
+		bucketCount *= 2;
+	}
+	myBucketMask = bucketCount - 1;
+
+	// Create the box array and the bucket offsets.
+	myBoxes = new AABB[myMaxBoxes];
+	myBucketStarts.resize(bucketCount + 1);
+	myBucketCursors.resize(bucketCount);
+
+	return true;
+}
+
+void SpatialHash::Shutdown()
+{
+	// Release the arrays.
+	delete[] myBoxes;
+	myBoxes = nullptr;
+
+	myEntries.clear();
+	myBucketStarts.clear();
+	myBucketCursors.clear();
+	myTaskPairs.clear();
+	myCount = 0;
+	myMaxBoxes = 0;
+}
+
+void SpatialHash::Update(const AABB* aBoxes, int aCount)
+{
+	int i, x, y, minX, minY, maxX, maxY, bucket, total, count;
+	Entry entry;
+
+	ALLOCATION_SCOPE("Collision");
+
+	if (aCount > myMaxBoxes)
+	{
+		aCount = myMaxBoxes;
+	}
+	myCount = aCount;
+
+	// Count how many entries end up in every bucket.
+	for (i = 0; i <= myBucketMask; i++)
+	{
+		myBucketCursors[i] = 0;
+	}
+	for (i = 0; i < myCount; i++)
+	{
+		myBoxes[i] = aBoxes[i];
+		GetCellRange(myBoxes[i], minX, minY, maxX, maxY);
+		for (y = minY; y <= maxY; y++)
+		{
+			for (x = minX; x <= maxX; x++)
+			{
+				myBucketCursors[HashCell(x, y)]++;
+			}
+		}
+	}
+
+	// Turn the counts into where every bucket starts.
+	total = 0;
+	for (i = 0; i <= myBucketMask; i++)
+	{
+		count = myBucketCursors[i];
+		myBucketStarts[i] = total;
+		myBucketCursors[i] = total;
+		total += count;
+	}
+	myBucketStarts[myBucketMask + 1] = total;
+
+	// The entry array only grows, so once it has warmed up no frame allocates.
+	if ((int)myEntries.size() < total)
+	{
+		myEntries.resize(total);
+	}
+
+	// Write every box into the buckets of the cells it covers.
+	for (i = 0; i < myCount; i++)
+	{
+		GetCellRange(myBoxes[i], minX, minY, maxX, maxY);
+		for (y = minY; y <= maxY; y++)
+		{
+			for (x = minX; x <= maxX; x++)
+			{
+				bucket = HashCell(x, y);
+				entry.cellX = x;
+				entry.cellY = y;
+				entry.index = i;
+				myEntries[myBucketCursors[bucket]] = entry;
+				myBucketCursors[bucket]++;
+			}
+		}
+	}
+}
+
+void SpatialHash::FindPairs(std::vector<CollisionPair>& aPairs, JobSystem* aJobSystem)
+{
+	int taskCount, bucketCount, i;
+	unsigned int j;
+
+	ALLOCATION_SCOPE("Collision");
+
+	aPairs.clear();
+	bucketCount = myBucketMask + 1;
+
+	// Without a job system go through all buckets on this thread.
+	if (aJobSystem == nullptr || aJobSystem->GetThreadCount() == 1)
+	{
+		FindPairsInBuckets(0, bucketCount, aPairs);
+		return;
+	}
+
+	// Buckets are independent, so ranges of them can be tested on different threads.
+	taskCount = aJobSystem->GetThreadCount() * TASKS_PER_THREAD;
+	if ((int)myTaskPairs.size() < taskCount)
+	{
+		myTaskPairs.resize(taskCount);
+	}
+
+	aJobSystem->ParallelFor(taskCount, [this, taskCount, bucketCount](int aTask)
+	{
+		myTaskPairs[aTask].clear();
+		FindPairsInBuckets(bucketCount * aTask / taskCount, bucketCount * (aTask + 1) / taskCount, myTaskPairs[aTask]);
+	});
+
+	// Gather the pairs of every range.
+	for (i = 0; i < taskCount; i++)
+	{
+		for (j = 0; j < myTaskPairs[i].size(); j++)
+		{
+			aPairs.push_back(myTaskPairs[i][j]);
+		}
+	}
+}
+
+int SpatialHash::GetEntryCount()
+{
+	return myBucketStarts.empty() ? 0 : myBucketStarts[myBucketMask + 1];
+}
+
+void SpatialHash::GetCellRange(const AABB& aBox, int& aMinX, int& aMinY, int& aMaxX, int& aMaxY)
+{
+	aMinX = (int)floorf(aBox.minX * myInverseCellSize);
+	aMinY = (int)floorf(aBox.minY * myInverseCellSize);
+	aMaxX = (int)floorf(aBox.maxX * myInverseCellSize);
+	aMaxY = (int)floorf(aBox.maxY * myInverseCellSize);
+}
+
+int SpatialHash::HashCell(int aX, int aY)
+{
+	// Multiply by large primes so neighbouring cells spread over the buckets.
+	return (int)(((unsigned int)aX * 73856093u) ^ ((unsigned int)aY * 19349663u)) & myBucketMask;
+}
+
+void SpatialHash::FindPairsInBuckets(int aBegin, int aEnd, std::vector<CollisionPair>& aPairs)
+{
+	const Entry* first;
+	const Entry* second;
+	const AABB* boxA;
+	const AABB* boxB;
+	CollisionPair pair;
+	int bucket, i, j, end;
+	float overlapX, overlapY;
+
+	for (bucket = aBegin; bucket < aEnd; bucket++)
+	{
+		end = myBucketStarts[bucket + 1];
+		for (i = myBucketStarts[bucket]; i < end; i++)
+		{
+			first = &myEntries[i];
+			boxA = &myBoxes[first->index];
+
+			for (j = i + 1; j < end; j++)
+			{
+				// Different cells can share a bucket, only entries of the same cell are neighbours.
+				second = &myEntries[j];
+				if (second->cellX != first->cellX || second->cellY != first->cellY)
+				{
+					continue;
+				}
+
+				boxB = &myBoxes[second->index];
+				if (boxA->minX > boxB->maxX || boxB->minX > boxA->maxX || boxA->minY > boxB->maxY || boxB->minY > boxA->maxY)
+				{
+					continue;
+				}
+
+				// Report the pair only from the cell that holds the lower left corner of the overlap.
+				overlapX = boxA->minX > boxB->minX ? boxA->minX : boxB->minX;
+				overlapY = boxA->minY > boxB->minY ? boxA->minY : boxB->minY;
+				if ((int)floorf(overlapX * myInverseCellSize) != first->cellX || (int)floorf(overlapY * myInverseCellSize) != first->cellY)
+				{
+					continue;
+				}
+
+				pair.a = first->index < second->index ? first->index : second->index;
+				pair.b = first->index < second->index ? second->index : first->index;
+				aPairs.push_back(pair);
+			}
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include "Collision.h"
+#include "JobSystem.h"
+
+// Broadphase that puts every box into the grid cells it covers, hashed into a fixed number of buckets.
+// Only boxes sharing a cell are tested, and a pair is reported only from the cell holding the lower left
+// corner of the overlap, so boxes that share several cells still produce the pair once.
+class SpatialHash
+{
+public:
+	SpatialHash();
+	SpatialHash(const SpatialHash& aSpatialHash) = delete;
+	~SpatialHash();
+
+	bool Initialize(int aMaxBoxes, float aCellSize, int aBucketCount);
+	void Shutdown();
+
+	void Update(const AABB* aBoxes, int aCount);
+	void FindPairs(std::vector<CollisionPair>& aPairs, JobSystem* aJobSystem);
+
+	int GetEntryCount();
+
+private:
+	struct Entry
+	{
+		int cellX;
+		int cellY;
+		int index;
+	};
+
+	void GetCellRange(const AABB& aBox, int& aMinX, int& aMinY, int& aMaxX, int& aMaxY);
+	int HashCell(int aX, int aY);
+	void FindPairsInBuckets(int aBegin, int aEnd, std::vector<CollisionPair>& aPairs);
+
+	AABB* myBoxes;
+	std::vector<Entry> myEntries;
+	std::vector<int> myBucketStarts;
+	std::vector<int> myBucketCursors;
+	std::vector<std::vector<CollisionPair> > myTaskPairs;
+	int myCount;
+	int myMaxBoxes;
+	int myBucketMask;
+	float myInverseCellSize;
+};
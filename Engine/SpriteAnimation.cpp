@@ -0,0 +1,378 @@
+#include "SpriteAnimation.h"
+#include "AllocationTracker.h"
+#include <math.h>
+
+// Frames shorter than this are stretched so a zero duration can never stall the frame walk in Update.
+static const float MIN_FRAME_DURATION = 0.0001f;
+
+SpriteAnimation::SpriteAnimation()
+{
+	myCurrentFrames = nullptr;
+	myClipFirstFrames = nullptr;
+	myClipEndFrames = nullptr;
+	myClipDurations = nullptr;
+	myTimes = nullptr;
+	mySpeeds = nullptr;
+	myLooping = nullptr;
+	myUVRects = nullptr;
+	myInstanceToIndex = nullptr;
+	myIndexToInstance = nullptr;
+	myFreeInstances = nullptr;
+	myFreeInstanceCount = 0;
+	myInstanceCount = 0;
+	myMaxInstances = 0;
+	myChangedCount = 0;
+}
+
+SpriteAnimation::~SpriteAnimation()
+{
+}
+
+bool SpriteAnimation::Initialize(int aMaxInstances)
+{
+	int i;
+
+	if (aMaxInstances <= 0)
+	{
+		return false;
+	}
+	myMaxInstances = aMaxInstances;
+
+	// Create the per instance arrays.
+	myCurrentFrames = new int[myMaxInstances];
+	myClipFirstFrames = new int[myMaxInstances];
+	myClipEndFrames = new int[myMaxInstances];
+	myClipDurations = new float[myMaxInstances];
+	myTimes = new float[myMaxInstances];
+	mySpeeds = new float[myMaxInstances];
+	myLooping = new bool[myMaxInstances];
+	myUVRects = new UVRect[myMaxInstances];
+	myInstanceToIndex = new int[myMaxInstances];
+	myIndexToInstance = new int[myMaxInstances];
+	myFreeInstances = new int[myMaxInstances];
+
+	// Every instance handle starts out free, handed out lowest first.
+	for (i = 0; i < myMaxInstances; i++)
+	{
+		myFreeInstances[i] = myMaxInstances - 1 - i;
+		myInstanceToIndex[i] = -1;
+	}
+	myFreeInstanceCount = myMaxInstances;
+	myInstanceCount = 0;
+	myChangedCount = 0;
+
+	return true;
+}
+
+void SpriteAnimation::Shutdown()
+{
+	// Release the per instance arrays.
+	delete[] myCurrentFrames;
+	myCurrentFrames = nullptr;
+	delete[] myClipFirstFrames;
+	myClipFirstFrames = nullptr;
+	delete[] myClipEndFrames;
+	myClipEndFrames = nullptr;
+	delete[] myClipDurations;
+	myClipDurations = nullptr;
+	delete[] myTimes;
+	myTimes = nullptr;
+	delete[] mySpeeds;
+	mySpeeds = nullptr;
+	delete[] myLooping;
+	myLooping = nullptr;
+	delete[] myUVRects;
+	myUVRects = nullptr;
+	delete[] myInstanceToIndex;
+	myInstanceToIndex = nullptr;
+	delete[] myIndexToInstance;
+	myIndexToInstance = nullptr;
+	delete[] myFreeInstances;
+	myFreeInstances = nullptr;
+
+	// Release the clips.
+	myClips.clear();
+	myFrameUVs.clear();
+	myFrameDurations.clear();
+
+	myFreeInstanceCount = 0;
+	myInstanceCount = 0;
+	myMaxInstances = 0;
+}
+
+int SpriteAnimation::AddClip(const Frame* aFrames, int aFrameCount, bool aLooping)
+{
+	Clip clip;
+	int i;
+	float duration;
+
+	if (aFrames == nullptr || aFrameCount <= 0)
+	{
+		return -1;
+	}
+
+	clip.firstFrame = (int)myFrameUVs.size();
+	clip.frameCount = aFrameCount;
+	clip.duration = 0.0f;
+	clip.looping = aLooping;
+
+	// Append the frames to the shared frame arrays.
+	for (i = 0; i < aFrameCount; i++)
+	{
+		duration = aFrames[i].duration;
+		if (duration < MIN_FRAME_DURATION)
+		{
+			duration = MIN_FRAME_DURATION;
+		}
+
+		myFrameUVs.push_back(aFrames[i].uv);
+		myFrameDurations.push_back(duration);
+		clip.duration += duration;
+	}
+
+	myClips.push_back(clip);
+	return (int)myClips.size() - 1;
+}
+
+int SpriteAnimation::AddGridClip(int aColumns, int aRows, int aFirstCell, int aFrameCount, float aFrameDuration, bool aLooping)
+{
+	std::vector<Frame> frames;
+	Frame frame;
+	int i, cell;
+	float cellWidth, cellHeight;
+
+	if (aColumns <= 0 || aRows <= 0 || aFirstCell < 0 || aFrameCount <= 0 || aFirstCell + aFrameCount > aColumns * aRows)
+	{
+		return -1;
+	}
+
+	// Size of one cell of the sheet in texture coordinates.
+	cellWidth = 1.0f / (float)aColumns;
+	cellHeight = 1.0f / (float)aRows;
+
+	// Walk the cells left to right, top to bottom.
+	frames.resize(aFrameCount);
+	for (i = 0; i < aFrameCount; i++)
+	{
+		cell = aFirstCell + i;
+		frame.uv.left = (float)(cell % aColumns) * cellWidth;
+		frame.uv.top = (float)(cell / aColumns) * cellHeight;
+		frame.uv.right = frame.uv.left + cellWidth;
+		frame.uv.bottom = frame.uv.top + cellHeight;
+		frame.duration = aFrameDuration;
+		frames[i] = frame;
+	}
+
+	return AddClip(&frames[0], aFrameCount, aLooping);
+}
+
+int SpriteAnimation::CreateInstance(int aClip, float aSpeed)
+{
+	int instance, index;
+
+	if (myFreeInstanceCount == 0 || aClip < 0 || aClip >= (int)myClips.size())
+	{
+		return -1;
+	}
+
+	// Take a free handle and put it in the next dense slot.
+	myFreeInstanceCount--;
+	instance = myFreeInstances[myFreeInstanceCount];
+	index = myInstanceCount;
+	myInstanceCount++;
+
+	myInstanceToIndex[instance] = index;
+	myIndexToInstance[index] = instance;
+
+	SetSpeed(instance, aSpeed);
+	Play(instance, aClip);
+
+	return instance;
+}
+
+void SpriteAnimation::DestroyInstance(int aInstance)
+{
+	int index, last, lastInstance;
+
+	if (aInstance < 0 || aInstance >= myMaxInstances || myInstanceToIndex[aInstance] < 0)
+	{
+		return;
+	}
+
+	index = myInstanceToIndex[aInstance];
+	last = myInstanceCount - 1;
+
+	// Move the last instance into the freed slot to keep the arrays dense.
+	if (index != last)
+	{
+		myCurrentFrames[index] = myCurrentFrames[last];
+		myClipFirstFrames[index] = myClipFirstFrames[last];
+		myClipEndFrames[index] = myClipEndFrames[last];
+		myClipDurations[index] = myClipDurations[last];
+		myTimes[index] = myTimes[last];
+		mySpeeds[index] = mySpeeds[last];
+		myLooping[index] = myLooping[last];
+		myUVRects[index] = myUVRects[last];
+
+		lastInstance = myIndexToInstance[last];
+		myIndexToInstance[index] = lastInstance;
+		myInstanceToIndex[lastInstance] = index;
+	}
+	myInstanceCount--;
+
+	// Return the handle to the free list.
+	myInstanceToIndex[aInstance] = -1;
+	myFreeInstances[myFreeInstanceCount] = aInstance;
+	myFreeInstanceCount++;
+	myChangedCount++;
+}
+
+void SpriteAnimation::Play(int aInstance, int aClip)
+{
+	int index;
+	const Clip* clip;
+
+	if (aInstance < 0 || aInstance >= myMaxInstances || myInstanceToIndex[aInstance] < 0)
+	{
+		return;
+	}
+	if (aClip < 0 || aClip >= (int)myClips.size())
+	{
+		return;
+	}
+
+	index = myInstanceToIndex[aInstance];
+	clip = &myClips[aClip];
+
+	// Copy the clip range into the instance so the update loop never has to look up the clip.
+	myClipFirstFrames[index] = clip->firstFrame;
+	myClipEndFrames[index] = clip->firstFrame + clip->frameCount;
+	myClipDurations[index] = clip->duration;
+	myLooping[index] = clip->looping;
+
+	// Restart from the first frame.
+	myCurrentFrames[index] = clip->firstFrame;
+	myTimes[index] = 0.0f;
+	myUVRects[index] = myFrameUVs[clip->firstFrame];
+	myChangedCount++;
+}
+
+void SpriteAnimation::SetSpeed(int aInstance, float aSpeed)
+{
+	if (aInstance < 0 || aInstance >= myMaxInstances || myInstanceToIndex[aInstance] < 0)
+	{
+		return;
+	}
+
+	// Animations only run forwards.
+	if (aSpeed < 0.0f)
+	{
+		aSpeed = 0.0f;
+	}
+	mySpeeds[myInstanceToIndex[aInstance]] = aSpeed;
+}
+
+void SpriteAnimation::Skip(int aInstance, float aTime)
+{
+	int index;
+
+	if (aInstance < 0 || aInstance >= myMaxInstances || myInstanceToIndex[aInstance] < 0 || aTime <= 0.0f)
+	{
+		return;
+	}
+
+	// Advance the one instance as an update of that length would, so instances of a clip can start out of step.
+	index = myInstanceToIndex[aInstance];
+	UpdateRange(index, index + 1, aTime);
+}
+
+void SpriteAnimation::Update(float aDeltaTime)
+{
+	ALLOCATION_SCOPE("Animation");
+
+	UpdateRange(0, myInstanceCount, aDeltaTime);
+}
+
+void SpriteAnimation::UpdateRange(int aFirst, int aEnd, float aDeltaTime)
+{
+	const float* frameDurations;
+	const UVRect* frameUVs;
+	int i, frame;
+	float time;
+
+	frameDurations = myFrameDurations.empty() ? nullptr : &myFrameDurations[0];
+	frameUVs = myFrameUVs.empty() ? nullptr : &myFrameUVs[0];
+
+	for (i = aFirst; i < aEnd; i++)
+	{
+		// Advance the time spent in the current frame.
+		time = myTimes[i] + aDeltaTime * mySpeeds[i];
+		frame = myCurrentFrames[i];
+
+		// A step longer than the whole clip lands on the same frame as the remainder of it.
+		if (myLooping[i] && time >= myClipDurations[i])
+		{
+			time = fmodf(time, myClipDurations[i]);
+		}
+
+		// Step past every frame whose duration has run out.
+		while (time >= frameDurations[frame])
+		{
+			time -= frameDurations[frame];
+			frame++;
+
+			if (frame == myClipEndFrames[i])
+			{
+				if (myLooping[i])
+				{
+					frame = myClipFirstFrames[i];
+				}
+				else
+				{
+					// Hold the last frame of clips that play once.
+					frame--;
+					time = 0.0f;
+					break;
+				}
+			}
+		}
+
+		// Count the instances that show a different frame, ticks where none did leave the screen as it was.
+		myChangedCount += frame != myCurrentFrames[i] ? 1 : 0;
+
+		myTimes[i] = time;
+		myCurrentFrames[i] = frame;
+
+		// Write the rectangle of the current frame for the sprite batch.
+		myUVRects[i] = frameUVs[frame];
+	}
+}
+
+int SpriteAnimation::GetInstanceCount()
+{
+	return myInstanceCount;
+}
+
+int SpriteAnimation::GetChangedCount()
+{
+	return myChangedCount;
+}
+
+void SpriteAnimation::ClearChangedCount()
+{
+	myChangedCount = 0;
+}
+
+int SpriteAnimation::GetInstanceIndex(int aInstance)
+{
+	if (aInstance < 0 || aInstance >= myMaxInstances)
+	{
+		return -1;
+	}
+	return myInstanceToIndex[aInstance];
+}
+
+const SpriteAnimation::UVRect* SpriteAnimation::GetUVRects()
+{
+	return myUVRects;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vector>
+
+// Flipbook animation over frames of a sprite sheet.
+// Instances are stored as structure of arrays so every instance is advanced in one tight loop per tick,
+// and the current frame of each instance is written straight into an array of UV rectangles for the sprite batch.
+class SpriteAnimation
+{
+public:
+	struct UVRect
+	{
+		float left;
+		float top;
+		float right;
+		float bottom;
+	};
+
+	struct Frame
+	{
+		UVRect uv;
+		float duration;
+	};
+
+	SpriteAnimation();
+	SpriteAnimation(const SpriteAnimation& aSpriteAnimation) = delete;
+	~SpriteAnimation();
+
+	bool Initialize(int aMaxInstances);
+	void Shutdown();
+
+	int AddClip(const Frame* aFrames, int aFrameCount, bool aLooping);
+	int AddGridClip(int aColumns, int aRows, int aFirstCell, int aFrameCount, float aFrameDuration, bool aLooping);
+
+	int CreateInstance(int aClip, float aSpeed);
+	void DestroyInstance(int aInstance);
+	void Play(int aInstance, int aClip);
+	void SetSpeed(int aInstance, float aSpeed);
+	void Skip(int aInstance, float aTime);
+
+	void Update(float aDeltaTime);
+
+	int GetInstanceCount();
+	int GetChangedCount();
+	void ClearChangedCount();
+	int GetInstanceIndex(int aInstance);
+	const UVRect* GetUVRects();
+
+private:
+	void UpdateRange(int aFirst, int aEnd, float aDeltaTime);
+
+	struct Clip
+	{
+		int firstFrame;
+		int frameCount;
+		float duration;
+		bool looping;
+	};
+
+	std::vector<Clip> myClips;
+	std::vector<UVRect> myFrameUVs;
+	std::vector<float> myFrameDurations;
+
+	// Per instance data, densely packed in [0, myInstanceCount).
+	int* myCurrentFrames;
+	int* myClipFirstFrames;
+	int* myClipEndFrames;
+	float* myClipDurations;
+	float* myTimes;
+	float* mySpeeds;
+	bool* myLooping;
+	UVRect* myUVRects;
+
+	// Maps instance handles to dense slots and back so destroying an instance can swap the last one into its place.
+	int* myInstanceToIndex;
+	int* myIndexToInstance;
+	int* myFreeInstances;
+	int myFreeInstanceCount;
+
+	int myInstanceCount;
+	int myMaxInstances;
+	int myChangedCount;
+};
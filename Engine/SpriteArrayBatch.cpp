@@ -0,0 +1,93 @@
+#include "SpriteArrayBatch.h"
+
+SpriteArrayBatch::SpriteArrayBatch()
+{
+	myUploadRing = nullptr;
+	myQuadIndexBuffer = nullptr;
+	myMappedVertices = nullptr;
+	myOffset = 0;
+	myMaxSprites = 0;
+	mySpriteCount = 0;
+}
+
+SpriteArrayBatch::~SpriteArrayBatch()
+{
+}
+
+bool SpriteArrayBatch::Initialize(UploadRing& aUploadRing, QuadIndexBuffer& aQuadIndexBuffer, int aMaxSprites)
+{
+	if (aMaxSprites <= 0)
+	{
+		return false;
+	}
+	myMaxSprites = aMaxSprites;
+	myUploadRing = &aUploadRing;
+	myQuadIndexBuffer = &aQuadIndexBuffer;
+
+	return true;
+}
+
+void SpriteArrayBatch::Shutdown()
+{
+	myUploadRing = nullptr;
+	myQuadIndexBuffer = nullptr;
+}
+
+bool SpriteArrayBatch::Begin(ID3D11DeviceContext& aDeviceContext)
+{
+	mySpriteCount = 0;
+
+	// Reserve four vertices for every sprite the batch can hold and lock them for writing.
+	myMappedVertices = (SpriteArrayVertex*)myUploadRing->Map(aDeviceContext, sizeof(SpriteArrayVertex) * myMaxSprites * 4,
+		sizeof(SpriteArrayVertex), myOffset);
+	if (myMappedVertices == nullptr)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void SpriteArrayBatch::Add(const float* aPosition, const float* aSize, const SpriteAnimation::UVRect& aUV, int aSlice)
+{
+	// Whatever does not fit in the buffer is dropped.
+	if (myMappedVertices == nullptr || mySpriteCount == myMaxSprites)
+	{
+		return;
+	}
+
+	WriteSpriteArrayQuad(aPosition, aSize, aUV, aSlice, myMappedVertices + mySpriteCount * 4);
+	mySpriteCount++;
+}
+
+void SpriteArrayBatch::End(ID3D11DeviceContext& aDeviceContext)
+{
+	// Unlock the vertices and give back the ones no sprite was written to.
+	if (myMappedVertices != nullptr)
+	{
+		myUploadRing->Unmap(aDeviceContext, sizeof(SpriteArrayVertex) * mySpriteCount * 4);
+		myMappedVertices = nullptr;
+	}
+}
+
+void SpriteArrayBatch::Render(ID3D11DeviceContext& aDeviceContext)
+{
+	ID3D11Buffer* vertexBuffer;
+	unsigned int stride;
+
+	// Set vertex buffer stride, the vertices of the batch start at its range of the ring.
+	vertexBuffer = myUploadRing->GetBuffer();
+	stride = sizeof(SpriteArrayVertex);
+
+	// Set the vertex and index buffers to active in the input assembler so they can be rendered.
+	aDeviceContext.IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &myOffset);
+	myQuadIndexBuffer->Render(aDeviceContext);
+
+	// Set the type of primitive that should be rendered from this vertex buffer, in this case triangles.
+	aDeviceContext.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+}
+
+int SpriteArrayBatch::GetIndexCount()
+{
+	return mySpriteCount * 6;
+}
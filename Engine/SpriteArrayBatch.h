@@ -0,0 +1,37 @@
+#pragma once
+
+#include <d3d11.h>
+#include "SpriteAnimation.h"
+#include "SpriteVertex.h"
+#include "SpriteQuads.h"
+#include "QuadIndexBuffer.h"
+#include "UploadRing.h"
+
+// Collects textured quads drawn from one texture array into a range of the upload ring so they are drawn with one call,
+// whichever image of the array each of them shows. Works like the sprite batch, with the slice of the image in every vertex.
+class SpriteArrayBatch
+{
+public:
+	SpriteArrayBatch();
+	SpriteArrayBatch(const SpriteArrayBatch& aSpriteArrayBatch) = delete;
+	~SpriteArrayBatch();
+
+	bool Initialize(UploadRing& aUploadRing, QuadIndexBuffer& aQuadIndexBuffer, int aMaxSprites);
+	void Shutdown();
+
+	bool Begin(ID3D11DeviceContext& aDeviceContext);
+	void Add(const float* aPosition, const float* aSize, const SpriteAnimation::UVRect& aUV, int aSlice);
+	void End(ID3D11DeviceContext& aDeviceContext);
+
+	void Render(ID3D11DeviceContext& aDeviceContext);
+
+	int GetIndexCount();
+
+private:
+	UploadRing* myUploadRing;
+	QuadIndexBuffer* myQuadIndexBuffer;
+	SpriteArrayVertex* myMappedVertices;
+	unsigned int myOffset;
+	int myMaxSprites;
+	int mySpriteCount;
+};
@@ -0,0 +1,126 @@
+#include "SpriteBatch.h"
+
+SpriteBatch::SpriteBatch()
+{
+	myUploadRing = nullptr;
+	myQuadIndexBuffer = nullptr;
+	myMappedVertices = nullptr;
+	myOffset = 0;
+	myMaxSprites = 0;
+	mySpriteCount = 0;
+}
+
+SpriteBatch::~SpriteBatch()
+{
+}
+
+bool SpriteBatch::Initialize(UploadRing& aUploadRing, QuadIndexBuffer& aQuadIndexBuffer, int aMaxSprites)
+{
+	if (aMaxSprites <= 0)
+	{
+		return false;
+	}
+	myMaxSprites = aMaxSprites;
+	myUploadRing = &aUploadRing;
+	myQuadIndexBuffer = &aQuadIndexBuffer;
+
+	return true;
+}
+
+void SpriteBatch::Shutdown()
+{
+	myUploadRing = nullptr;
+	myQuadIndexBuffer = nullptr;
+}
+
+bool SpriteBatch::Begin(ID3D11DeviceContext& aDeviceContext)
+{
+	mySpriteCount = 0;
+
+	// Reserve four vertices for every sprite the batch can hold and lock them for writing.
+	myMappedVertices = (SpriteVertex*)myUploadRing->Map(aDeviceContext, sizeof(SpriteVertex) * myMaxSprites * 4, sizeof(SpriteVertex), myOffset);
+	if (myMappedVertices == nullptr)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void SpriteBatch::Add(const XMFLOAT2& aPosition, const XMFLOAT2& aSize, const SpriteAnimation::UVRect& aUV)
+{
+	Add(&aPosition, &aSize, &aUV, 1);
+}
+
+void SpriteBatch::Add(const XMFLOAT2* aPositions, const XMFLOAT2* aSizes, const SpriteAnimation::UVRect* aUVs, int aCount)
+{
+	SpriteVertex* vertices;
+
+	// Reserve room for the sprites, whatever does not fit in the buffer is dropped.
+	vertices = Allocate(aCount);
+	if (vertices == nullptr)
+	{
+		return;
+	}
+
+	WriteSpriteQuads(&aPositions[0].x, 2, &aSizes[0].x, 2, aUVs, aCount, vertices);
+}
+
+SpriteVertex* SpriteBatch::Allocate(int& aSpriteCount)
+{
+	SpriteVertex* vertices;
+
+	if (myMappedVertices == nullptr || aSpriteCount <= 0)
+	{
+		aSpriteCount = 0;
+		return nullptr;
+	}
+
+	// Clamp the request to the space left in the buffer.
+	if (aSpriteCount > myMaxSprites - mySpriteCount)
+	{
+		aSpriteCount = myMaxSprites - mySpriteCount;
+	}
+	if (aSpriteCount == 0)
+	{
+		return nullptr;
+	}
+
+	// Hand out the next quads of the mapped buffer for the caller to fill in.
+	vertices = myMappedVertices + mySpriteCount * 4;
+	mySpriteCount += aSpriteCount;
+
+	return vertices;
+}
+
+void SpriteBatch::End(ID3D11DeviceContext& aDeviceContext)
+{
+	// Unlock the vertices and give back the ones no sprite was written to.
+	if (myMappedVertices != nullptr)
+	{
+		myUploadRing->Unmap(aDeviceContext, sizeof(SpriteVertex) * mySpriteCount * 4);
+		myMappedVertices = nullptr;
+	}
+}
+
+void SpriteBatch::Render(ID3D11DeviceContext& aDeviceContext)
+{
+	ID3D11Buffer* vertexBuffer;
+	unsigned int stride;
+
+	// Set vertex buffer stride, the vertices of the batch start at its range of the ring.
+	vertexBuffer = myUploadRing->GetBuffer();
+	stride = sizeof(SpriteVertex);
+
+	// Set the vertex and index buffers to active in the input assembler so they can be rendered.
+	aDeviceContext.IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &myOffset);
+	myQuadIndexBuffer->Render(aDeviceContext);
+
+	// Set the type of primitive that should be rendered from this vertex buffer, in this case triangles.
+	aDeviceContext.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+}
+
+int SpriteBatch::GetIndexCount()
+{
+	return mySpriteCount * 6;
+}
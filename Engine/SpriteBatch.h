@@ -0,0 +1,43 @@
+#pragma once
+
+#include <d3d11.h>
+#include <directxmath.h>
+#include "SpriteAnimation.h"
+#include "SpriteVertex.h"
+#include "SpriteQuads.h"
+#include "QuadIndexBuffer.h"
+#include "UploadRing.h"
+
+using namespace DirectX;
+
+// Collects textured quads that share one texture into a range of the upload ring so they are drawn with one call.
+// Begin reserves room for the most sprites the batch holds and vertices are written straight into the mapped range, End gives
+// back what was not written. Indices come from the shared quad index buffer.
+class SpriteBatch
+{
+public:
+	SpriteBatch();
+	SpriteBatch(const SpriteBatch& aSpriteBatch) = delete;
+	~SpriteBatch();
+
+	bool Initialize(UploadRing& aUploadRing, QuadIndexBuffer& aQuadIndexBuffer, int aMaxSprites);
+	void Shutdown();
+
+	bool Begin(ID3D11DeviceContext& aDeviceContext);
+	void Add(const XMFLOAT2& aPosition, const XMFLOAT2& aSize, const SpriteAnimation::UVRect& aUV);
+	void Add(const XMFLOAT2* aPositions, const XMFLOAT2* aSizes, const SpriteAnimation::UVRect* aUVs, int aCount);
+	SpriteVertex* Allocate(int& aSpriteCount);
+	void End(ID3D11DeviceContext& aDeviceContext);
+
+	void Render(ID3D11DeviceContext& aDeviceContext);
+
+	int GetIndexCount();
+
+private:
+	UploadRing* myUploadRing;
+	QuadIndexBuffer* myQuadIndexBuffer;
+	SpriteVertex* myMappedVertices;
+	unsigned int myOffset;
+	int myMaxSprites;
+	int mySpriteCount;
+};
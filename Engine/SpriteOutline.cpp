@@ -0,0 +1,265 @@
+#include "SpriteOutline.h"
+#include <algorithm>
+#include <vector>
+
+// Cross product of the vectors from a to b and from a to c, positive when c lies to the left of a to b with y down.
+static float Cross(const OutlinePoint& aA, const OutlinePoint& aB, const OutlinePoint& aC)
+{
+	return (aB.x - aA.x) * (aC.y - aA.y) - (aB.y - aA.y) * (aC.x - aA.x);
+}
+
+// Andrew's monotone chain over points sorted by x then y, leaving the hull without collinear points.
+static void BuildHull(std::vector<OutlinePoint>& aPoints, std::vector<OutlinePoint>& aHull)
+{
+	int i, count, lower;
+
+	std::sort(aPoints.begin(), aPoints.end(), [](const OutlinePoint& aLeft, const OutlinePoint& aRight)
+	{
+		return aLeft.x < aRight.x || (aLeft.x == aRight.x && aLeft.y < aRight.y);
+	});
+	aHull.resize(aPoints.size() * 2);
+	count = 0;
+	for (i = 0; i < (int)aPoints.size(); i++)
+	{
+		while (count >= 2 && Cross(aHull[count - 2], aHull[count - 1], aPoints[i]) <= 0.0f)
+		{
+			count--;
+		}
+		aHull[count++] = aPoints[i];
+	}
+	lower = count + 1;
+	for (i = (int)aPoints.size() - 2; i >= 0; i--)
+	{
+		while (count >= lower && Cross(aHull[count - 2], aHull[count - 1], aPoints[i]) <= 0.0f)
+		{
+			count--;
+		}
+		aHull[count++] = aPoints[i];
+	}
+	aHull.resize(count - 1);
+}
+
+static float GetArea(const std::vector<OutlinePoint>& aPolygon)
+{
+	float area;
+	int i, next;
+
+	area = 0.0f;
+	for (i = 0; i < (int)aPolygon.size(); i++)
+	{
+		next = (i + 1) % (int)aPolygon.size();
+		area += aPolygon[i].x * aPolygon[next].y - aPolygon[next].x * aPolygon[i].y;
+	}
+	return area < 0.0f ? -area * 0.5f : area * 0.5f;
+}
+
+// Finds where the edges before and after the edge from corner i to i + 1 meet when both are extended past it.
+static bool GetEdgeRemoval(const std::vector<OutlinePoint>& aPolygon, int aIndex, float aWidth, float aHeight, OutlinePoint& aPoint,
+	float& aAddedArea)
+{
+	const OutlinePoint *previous, *start, *end, *next;
+	float startX, startY, endX, endY, denominator, t, s;
+	int count;
+
+	count = (int)aPolygon.size();
+	previous = &aPolygon[(aIndex + count - 1) % count];
+	start = &aPolygon[aIndex];
+	end = &aPolygon[(aIndex + 1) % count];
+	next = &aPolygon[(aIndex + 2) % count];
+
+	// The lines only meet beyond the edge when the two corners turn by less than half a circle together.
+	startX = start->x - previous->x;
+	startY = start->y - previous->y;
+	endX = next->x - end->x;
+	endY = next->y - end->y;
+	denominator = startX * endY - startY * endX;
+	if (denominator <= 1e-6f)
+	{
+		return false;
+	}
+	t = ((end->x - start->x) * endY - (end->y - start->y) * endX) / denominator;
+	s = (startX * (end->y - start->y) - startY * (end->x - start->x)) / denominator;
+	if (t < 0.0f || s < 0.0f)
+	{
+		return false;
+	}
+	aPoint.x = start->x + startX * t;
+	aPoint.y = start->y + startY * t;
+
+	// A corner outside the region would show texels of its neighbors in an atlas.
+	if (aPoint.x < -1e-3f || aPoint.y < -1e-3f || aPoint.x > aWidth + 1e-3f || aPoint.y > aHeight + 1e-3f)
+	{
+		return false;
+	}
+	aAddedArea = Cross(*start, *end, aPoint) * 0.5f;
+	aAddedArea = aAddedArea < 0.0f ? -aAddedArea : aAddedArea;
+	return true;
+}
+
+int BuildSpriteOutline(const unsigned char* aPixels, int aRowPitch, int aLeft, int aTop, int aRight, int aBottom, unsigned char aMinAlpha,
+	int aMaxVertices, OutlinePoint* aOutline)
+{
+	std::vector<OutlinePoint> points, polygon;
+	OutlinePoint point, bestPoint;
+	const unsigned char* row;
+	float width, height, addedArea, bestArea, minX, minY, maxX, maxY;
+	int x, y, first, last, i, best, count;
+
+	aMaxVertices = aMaxVertices < 4 ? 4 : (aMaxVertices > MAX_OUTLINE_VERTICES ? MAX_OUTLINE_VERTICES : aMaxVertices);
+	width = (float)(aRight - aLeft);
+	height = (float)(aBottom - aTop);
+
+	// The first and last visible texel of every row are all the hull needs, each one by the four corners of its square.
+	for (y = aTop; y < aBottom; y++)
+	{
+		row = aPixels + y * aRowPitch;
+		first = -1;
+		last = -1;
+		for (x = aLeft; x < aRight; x++)
+		{
+			if (row[x * 4 + 3] >= aMinAlpha)
+			{
+				first = first < 0 ? x : first;
+				last = x;
+			}
+		}
+		if (first < 0)
+		{
+			continue;
+		}
+		point.y = (float)(y - aTop);
+		point.x = (float)(first - aLeft);
+		points.push_back(point);
+		point.x = (float)(last + 1 - aLeft);
+		points.push_back(point);
+		point.y += 1.0f;
+		points.push_back(point);
+		point.x = (float)(first - aLeft);
+		points.push_back(point);
+	}
+	if (points.empty())
+	{
+		return 0;
+	}
+	BuildHull(points, polygon);
+
+	// Remove the cheapest edge until the outline fits the budget.
+	while ((int)polygon.size() > aMaxVertices)
+	{
+		best = -1;
+		bestArea = 0.0f;
+		for (i = 0; i < (int)polygon.size(); i++)
+		{
+			if (GetEdgeRemoval(polygon, i, width, height, point, addedArea) && (best < 0 || addedArea < bestArea))
+			{
+				best = i;
+				bestArea = addedArea;
+				bestPoint = point;
+			}
+		}
+		if (best < 0)
+		{
+			break;
+		}
+		polygon[best] = bestPoint;
+		polygon.erase(polygon.begin() + (best + 1) % (int)polygon.size());
+	}
+
+	// The bounding rectangle of the texels is the fallback, it is used whenever the outline does not come out smaller.
+	minX = maxX = polygon[0].x;
+	minY = maxY = polygon[0].y;
+	for (i = 1; i < (int)polygon.size(); i++)
+	{
+		minX = std::min(minX, polygon[i].x);
+		maxX = std::max(maxX, polygon[i].x);
+		minY = std::min(minY, polygon[i].y);
+		maxY = std::max(maxY, polygon[i].y);
+	}
+	if ((int)polygon.size() > aMaxVertices || GetArea(polygon) >= (maxX - minX) * (maxY - minY))
+	{
+		polygon.resize(4);
+		polygon[0].x = minX;
+		polygon[0].y = minY;
+		polygon[1].x = minX;
+		polygon[1].y = maxY;
+		polygon[2].x = maxX;
+		polygon[2].y = maxY;
+		polygon[3].x = maxX;
+		polygon[3].y = minY;
+	}
+
+	// Hand the corners out across the region from 0 to 1.
+	count = (int)polygon.size();
+	for (i = 0; i < count; i++)
+	{
+		aOutline[i].x = polygon[i].x / width;
+		aOutline[i].y = polygon[i].y / height;
+	}
+	return count;
+}
+
+float GetOutlineArea(const OutlinePoint* aOutline, int aCount)
+{
+	return GetArea(std::vector<OutlinePoint>(aOutline, aOutline + aCount));
+}
+
+int GetOutlineQuadCount(int aCount)
+{
+	// The polygon splits into two triangles less than it has corners, two to a quad.
+	return aCount < 3 ? 0 : (aCount - 1) / 2;
+}
+
+void WriteOutlineQuads(const OutlinePoint* aOutline, int aCount, float aLeft, float aBottom, float aRight, float aTop,
+	const SpriteAnimation::UVRect& aUV, SpriteVertex* aVertices)
+{
+	SpriteVertex corners[MAX_OUTLINE_VERTICES];
+	SpriteVertex strip[MAX_OUTLINE_VERTICES + 1];
+	float area;
+	int i, quadCount, front, back;
+
+	if (aCount < 3)
+	{
+		return;
+	}
+
+	// Place the corners over the sprite rectangle and its texture coordinates, y running down the image and up the screen.
+	area = 0.0f;
+	for (i = 0; i < aCount; i++)
+	{
+		corners[i].x = aLeft + aOutline[i].x * (aRight - aLeft);
+		corners[i].y = aTop - aOutline[i].y * (aTop - aBottom);
+		corners[i].u = PackUNorm16(aUV.left + aOutline[i].x * (aUV.right - aUV.left));
+		corners[i].v = PackUNorm16(aUV.top + aOutline[i].y * (aUV.bottom - aUV.top));
+	}
+	for (i = 0; i < aCount; i++)
+	{
+		area += corners[i].x * corners[(i + 1) % aCount].y - corners[(i + 1) % aCount].x * corners[i].y;
+	}
+
+	// Front faces turn clockwise on screen, the way the quad corners bottom left, top left, bottom right turn.
+	if (area > 0.0f)
+	{
+		std::reverse(corners, corners + aCount);
+	}
+
+	// Zigzag between both ends of the corner list, so consecutive triangles of the strip fan out over the polygon.
+	front = 0;
+	back = aCount - 1;
+	strip[0] = corners[front++];
+	for (i = 1; i < aCount; i++)
+	{
+		strip[i] = (i & 1) != 0 ? corners[front++] : corners[back--];
+	}
+	strip[aCount] = strip[aCount - 1];
+
+	// Every quad takes four consecutive strip corners and the next one starts two corners on, the last may repeat a corner.
+	quadCount = GetOutlineQuadCount(aCount);
+	for (i = 0; i < quadCount; i++)
+	{
+		aVertices[0] = strip[i * 2 + 0];
+		aVertices[1] = strip[i * 2 + 1];
+		aVertices[2] = strip[i * 2 + 2];
+		aVertices[3] = strip[i * 2 + 3];
+		aVertices += 4;
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "SpriteAnimation.h"
+#include "SpriteVertex.h"
+
+// Most corners an outline can have.
+const int MAX_OUTLINE_VERTICES = 16;
+
+// Corner of an outline, across and down its image region from 0 to 1, the way texture coordinates run.
+struct OutlinePoint
+{
+	float x;
+	float y;
+};
+
+// Builds a convex outline of at most the given number of corners, 4 or more, around every texel of a region of RGBA pixels
+// with at least the given alpha, so a sprite drawn as the outline instead of its rectangle rasterizes only around what is visible.
+// The convex hull of the texels is cut down by replacing the edge whose removal adds the least area with the meeting point of its
+// neighbors, as long as that point stays inside the region. Returns the number of corners, 0 for a region without visible texels.
+int BuildSpriteOutline(const unsigned char* aPixels, int aRowPitch, int aLeft, int aTop, int aRight, int aBottom, unsigned char aMinAlpha,
+	int aMaxVertices, OutlinePoint* aOutline);
+
+// Area of an outline as a fraction of its region.
+float GetOutlineArea(const OutlinePoint* aOutline, int aCount);
+
+// Outlines are drawn with the shared quad indices, as a strip of quads that split the polygon into its triangles.
+int GetOutlineQuadCount(int aCount);
+void WriteOutlineQuads(const OutlinePoint* aOutline, int aCount, float aLeft, float aBottom, float aRight, float aTop,
+	const SpriteAnimation::UVRect& aUV, SpriteVertex* aVertices);
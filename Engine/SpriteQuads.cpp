@@ -0,0 +1,88 @@
+#include "SpriteQuads.h"
+
+void WriteSpriteQuads(const float* aPositions, int aPositionStride, const float* aSizes, int aSizeStride,
+	const SpriteAnimation::UVRect* aUVs, int aCount, SpriteVertex* aVertices)
+{
+	float left, right, top, bottom;
+	unsigned short uvLeft, uvRight, uvTop, uvBottom;
+	int i;
+
+	for (i = 0; i < aCount; i++)
+	{
+		// Corners of the quad around its center.
+		left = aPositions[0] - aSizes[0] * 0.5f;
+		right = aPositions[0] + aSizes[0] * 0.5f;
+		bottom = aPositions[1] - aSizes[1] * 0.5f;
+		top = aPositions[1] + aSizes[1] * 0.5f;
+
+		// Texture coordinates of the frame, packed once for the four corners.
+		uvLeft = PackUNorm16(aUVs[i].left);
+		uvRight = PackUNorm16(aUVs[i].right);
+		uvTop = PackUNorm16(aUVs[i].top);
+		uvBottom = PackUNorm16(aUVs[i].bottom);
+
+		// Same corner order as the model quad: bottom left, top left, bottom right, top right.
+		aVertices[0].x = left;
+		aVertices[0].y = bottom;
+		aVertices[0].u = uvLeft;
+		aVertices[0].v = uvBottom;
+
+		aVertices[1].x = left;
+		aVertices[1].y = top;
+		aVertices[1].u = uvLeft;
+		aVertices[1].v = uvTop;
+
+		aVertices[2].x = right;
+		aVertices[2].y = bottom;
+		aVertices[2].u = uvRight;
+		aVertices[2].v = uvBottom;
+
+		aVertices[3].x = right;
+		aVertices[3].y = top;
+		aVertices[3].u = uvRight;
+		aVertices[3].v = uvTop;
+
+		aVertices += 4;
+		aPositions += aPositionStride;
+		aSizes += aSizeStride;
+	}
+}
+
+void WriteSpriteArrayQuad(const float* aPosition, const float* aSize, const SpriteAnimation::UVRect& aUV, int aSlice,
+	SpriteArrayVertex* aVertices)
+{
+	float left, right, top, bottom;
+	int i;
+
+	left = aPosition[0] - aSize[0] * 0.5f;
+	right = aPosition[0] + aSize[0] * 0.5f;
+	bottom = aPosition[1] - aSize[1] * 0.5f;
+	top = aPosition[1] + aSize[1] * 0.5f;
+
+	// Same corner order as the sprite quads: bottom left, top left, bottom right, top right.
+	aVertices[0].x = left;
+	aVertices[0].y = bottom;
+	aVertices[0].u = PackUNorm16(aUV.left);
+	aVertices[0].v = PackUNorm16(aUV.bottom);
+
+	aVertices[1].x = left;
+	aVertices[1].y = top;
+	aVertices[1].u = aVertices[0].u;
+	aVertices[1].v = PackUNorm16(aUV.top);
+
+	aVertices[2].x = right;
+	aVertices[2].y = bottom;
+	aVertices[2].u = PackUNorm16(aUV.right);
+	aVertices[2].v = aVertices[0].v;
+
+	aVertices[3].x = right;
+	aVertices[3].y = top;
+	aVertices[3].u = aVertices[2].u;
+	aVertices[3].v = aVertices[1].v;
+
+	for (i = 0; i < 4; i++)
+	{
+		aVertices[i].slice = (unsigned short)aSlice;
+		aVertices[i].padding = 0;
+	}
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "SpriteAnimation.h"
+#include "SpriteVertex.h"
+
+// Writes one textured quad per sprite, centered on its position, in the corner order every quad in the engine uses.
+// The strides are in floats, so XMFLOAT2 positions and sizes use a stride of 2.
+void WriteSpriteQuads(const float* aPositions, int aPositionStride, const float* aSizes, int aSizeStride,
+	const SpriteAnimation::UVRect* aUVs, int aCount, SpriteVertex* aVertices);
+
+// Writes one quad the same way for a single sprite drawn from a texture array, with the slice of its image.
+void WriteSpriteArrayQuad(const float* aPosition, const float* aSize, const SpriteAnimation::UVRect& aUV, int aSlice,
+	SpriteArrayVertex* aVertices);
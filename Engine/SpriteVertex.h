@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stddef.h>
+#include "VertexLayout.h"
+
+// Vertex of a sprite quad, a 2D position and a texture coordinate packed to 16 bit unsigned normalized, 12 bytes.
+// All quads of a draw lie in one layer, so its depth comes from the world matrix of the draw instead of every vertex.
+// Kept free of DirectX types so the CPU side systems can write quads without the graphics headers.
+struct SpriteVertex
+{
+	float x;
+	float y;
+	unsigned short u;
+	unsigned short v;
+};
+
+template<>
+struct VertexTraits<SpriteVertex>
+{
+	static const int ELEMENT_COUNT = 2;
+
+	static constexpr VertexElement GetElement(int aIndex)
+	{
+		return aIndex == 0 ? VertexElement{ "POSITION", VertexElementType::Float2, offsetof(SpriteVertex, x) } :
+			VertexElement{ "TEXCOORD", VertexElementType::UNorm16x2, offsetof(SpriteVertex, u) };
+	}
+};
+
+static_assert(GetVertexLayoutSize<SpriteVertex>() == sizeof(SpriteVertex), "SpriteVertex elements do not match the struct");
+
+// Vertex of a sprite quad drawn from a texture array, the sprite vertex with the slice of its image, 16 bytes.
+// Sprites of different images that share an array are drawn in one call, the slice picks the image per quad.
+struct SpriteArrayVertex
+{
+	float x;
+	float y;
+	unsigned short u;
+	unsigned short v;
+	unsigned short slice;
+	unsigned short padding;
+};
+
+template<>
+struct VertexTraits<SpriteArrayVertex>
+{
+	static const int ELEMENT_COUNT = 3;
+
+	static constexpr VertexElement GetElement(int aIndex)
+	{
+		return aIndex == 0 ? VertexElement{ "POSITION", VertexElementType::Float2, offsetof(SpriteArrayVertex, x) } :
+			aIndex == 1 ? VertexElement{ "TEXCOORD", VertexElementType::UNorm16x2, offsetof(SpriteArrayVertex, u) } :
+			VertexElement{ "SLICE", VertexElementType::UInt16x2, offsetof(SpriteArrayVertex, slice) };
+	}
+};
+
+static_assert(GetVertexLayoutSize<SpriteArrayVertex>() == sizeof(SpriteArrayVertex), "SpriteArrayVertex elements do not match the struct");
@@ -0,0 +1,192 @@
+#include "SweepAndPrune.h"
+#include "AllocationTracker.h"
+#include <algorithm>
+
+// Number of pieces the sweep is split into per thread, more than one so threads that finish early can help out.
+static const int TASKS_PER_THREAD = 4;
+
+SweepAndPrune::SweepAndPrune()
+{
+	mySortedBoxes = nullptr;
+	myCount = 0;
+	myMaxBoxes = 0;
+	mySwapCount = 0;
+}
+
+SweepAndPrune::~SweepAndPrune()
+{
+}
+
+bool SweepAndPrune::Initialize(int aMaxBoxes)
+{
+	if (aMaxBoxes <= 0)
+	{
+		return false;
+	}
+
+	myMaxBoxes = aMaxBoxes;
+	myCount = 0;
+
+	// Create the sorted box array.
+	mySortedBoxes = new SortedBox[myMaxBoxes];
+
+	return true;
+}
+
+void SweepAndPrune::Shutdown()
+{
+	// Release the arrays.
+	delete[] mySortedBoxes;
+	mySortedBoxes = nullptr;
+
+	myTaskPairs.clear();
+	myCount = 0;
+	myMaxBoxes = 0;
+}
+
+void SweepAndPrune::Update(const AABB* aBoxes, int aCount)
+{
+	SortedBox box;
+	int i, j, index, kept;
+
+	ALLOCATION_SCOPE("Collision");
+
+	if (aCount > myMaxBoxes)
+	{
+		aCount = myMaxBoxes;
+	}
+
+	// Keep the order of the last frame for the boxes that are still there, and add the new boxes after them.
+	kept = 0;
+	for (i = 0; i < myCount; i++)
+	{
+		if (mySortedBoxes[i].index < aCount)
+		{
+			mySortedBoxes[kept++] = mySortedBoxes[i];
+		}
+	}
+	for (i = myCount; i < aCount; i++)
+	{
+		mySortedBoxes[kept + i - myCount].index = i;
+	}
+	myCount = aCount;
+
+	// Copy the new boxes into the order of the last frame.
+	for (i = 0; i < myCount; i++)
+	{
+		index = mySortedBoxes[i].index;
+		mySortedBoxes[i].minX = aBoxes[index].minX;
+		mySortedBoxes[i].maxX = aBoxes[index].maxX;
+		mySortedBoxes[i].minY = aBoxes[index].minY;
+		mySortedBoxes[i].maxY = aBoxes[index].maxY;
+	}
+
+	// Insertion sort on the left edge, which only has to fix up the boxes that moved past a neighbour.
+	mySwapCount = 0;
+	for (i = 1; i < kept; i++)
+	{
+		if (mySortedBoxes[i - 1].minX <= mySortedBoxes[i].minX)
+		{
+			continue;
+		}
+
+		box = mySortedBoxes[i];
+		j = i - 1;
+		while (j >= 0 && mySortedBoxes[j].minX > box.minX)
+		{
+			mySortedBoxes[j + 1] = mySortedBoxes[j];
+			j--;
+			mySwapCount++;
+		}
+		mySortedBoxes[j + 1] = box;
+	}
+
+	// The new boxes come in index order, which can be far from sorted, and on the first frame every box is new. Sort them on
+	// their own and merge them in rather than have the insertion sort move each one across the list.
+	if (kept < myCount)
+	{
+		std::sort(mySortedBoxes + kept, mySortedBoxes + myCount, [](const SortedBox& aLeft, const SortedBox& aRight)
+		{
+			return aLeft.minX < aRight.minX;
+		});
+		std::inplace_merge(mySortedBoxes, mySortedBoxes + kept, mySortedBoxes + myCount, [](const SortedBox& aLeft, const SortedBox& aRight)
+		{
+			return aLeft.minX < aRight.minX;
+		});
+	}
+}
+
+void SweepAndPrune::FindPairs(std::vector<CollisionPair>& aPairs, JobSystem* aJobSystem)
+{
+	int taskCount, i;
+	unsigned int j;
+
+	ALLOCATION_SCOPE("Collision");
+
+	aPairs.clear();
+
+	// Without a job system sweep the whole list on this thread.
+	if (aJobSystem == nullptr || aJobSystem->GetThreadCount() == 1)
+	{
+		FindPairsInRange(0, myCount, aPairs);
+		return;
+	}
+
+	// Every box only looks ahead in the sorted list, so ranges of it can be swept independently.
+	taskCount = aJobSystem->GetThreadCount() * TASKS_PER_THREAD;
+	if ((int)myTaskPairs.size() < taskCount)
+	{
+		myTaskPairs.resize(taskCount);
+	}
+
+	aJobSystem->ParallelFor(taskCount, [this, taskCount](int aTask)
+	{
+		myTaskPairs[aTask].clear();
+		FindPairsInRange((int)((long long)myCount * aTask / taskCount), (int)((long long)myCount * (aTask + 1) / taskCount), myTaskPairs[aTask]);
+	});
+
+	// Gather the pairs of every range.
+	for (i = 0; i < taskCount; i++)
+	{
+		for (j = 0; j < myTaskPairs[i].size(); j++)
+		{
+			aPairs.push_back(myTaskPairs[i][j]);
+		}
+	}
+}
+
+long long SweepAndPrune::GetSwapCount()
+{
+	return mySwapCount;
+}
+
+void SweepAndPrune::FindPairsInRange(int aBegin, int aEnd, std::vector<CollisionPair>& aPairs)
+{
+	const SortedBox* box;
+	const SortedBox* other;
+	CollisionPair pair;
+	int i, j;
+
+	for (i = aBegin; i < aEnd; i++)
+	{
+		box = &mySortedBoxes[i];
+
+		// Walk the boxes that start before this one ends, they are the only ones that can overlap it on x.
+		for (j = i + 1; j < myCount; j++)
+		{
+			other = &mySortedBoxes[j];
+			if (other->minX > box->maxX)
+			{
+				break;
+			}
+
+			// Keep the pair if the boxes also overlap on y.
+			if (other->minY <= box->maxY && other->maxY >= box->minY)
+			{
+				pair.a = box->index < other->index ? box->index : other->index;
+				pair.b = box->index < other->index ? other->index : box->index;
+				aPairs.push_back(pair);
+			}
+		}
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include "Collision.h"
+#include "JobSystem.h"
+
+// Broadphase that keeps the boxes sorted along the x axis and sweeps the sorted list for overlaps.
+// Objects move little from one frame to the next, so the order of the last frame is nearly sorted
+// and an insertion sort brings it up to date in close to linear time.
+class SweepAndPrune
+{
+public:
+	SweepAndPrune();
+	SweepAndPrune(const SweepAndPrune& aSweepAndPrune) = delete;
+	~SweepAndPrune();
+
+	bool Initialize(int aMaxBoxes);
+	void Shutdown();
+
+	void Update(const AABB* aBoxes, int aCount);
+	void FindPairs(std::vector<CollisionPair>& aPairs, JobSystem* aJobSystem);
+
+	long long GetSwapCount();
+
+private:
+	struct SortedBox
+	{
+		float minX;
+		float maxX;
+		float minY;
+		float maxY;
+		int index;
+	};
+
+	void FindPairsInRange(int aBegin, int aEnd, std::vector<CollisionPair>& aPairs);
+
+	SortedBox* mySortedBoxes;
+	std::vector<std::vector<CollisionPair> > myTaskPairs;
+	int myCount;
+	int myMaxBoxes;
+	long long mySwapCount;
+};
@@ -1,30 +1,38 @@
 #include "SystemClass.h"
+#include <stdio.h>
 
 SystemClass::SystemClass()
 {
 	myInput = nullptr;
 	myGraphics = nullptr;
-}
-
-SystemClass::SystemClass(const SystemClass& aSystemClass)
-{
+	myTimer = nullptr;
+	myInputLog = nullptr;
+	myReplayRealTime = false;
+	myReplayFixedStep = 0.0f;
+	myScreenshotKeyDown = false;
+	GetDefaultScenario(myScenario);
+	myHeadless = false;
 }
 
 SystemClass::~SystemClass()
 {
 }
 
-bool SystemClass::Initialize()
+bool SystemClass::Initialize(const Scenario& aScenario, bool aHeadless)
 {
 	int screenWidth, screenHeight;
 	bool result;
 
+	// Keep the scenario to run, the interactive scene is one as well.
+	myScenario = aScenario;
+	myHeadless = aHeadless;
+
 	// Initialize the width and height of the screen to zero before sending the variables into the function.
 	screenWidth = 0;
 	screenHeight = 0;
 
 	// Initialize the windows api.
-	InitializeWindows(screenWidth, screenHeight);
+	InitializeWindows(screenWidth, screenHeight, myHeadless);
 
 	// Create the input object.  This object will be used to handle reading the keyboard input from the user.
 	myInput = new InputClass;
@@ -44,17 +52,47 @@ bool SystemClass::Initialize()
 	}
 
 	// Initialize the graphics object.
-	result = myGraphics->Initialize(screenWidth, screenHeight, myHWND);
+	result = myGraphics->Initialize(screenWidth, screenHeight, myHWND, myScenario, myHeadless);
 	if (!result)
 	{
 		return false;
 	}
 
+	// Create the timer object.
+	myTimer = new Timer;
+	if (!myTimer)
+	{
+		return false;
+	}
+
+	// Initialize the timer object.
+	result = myTimer->Initialize();
+	if (!result)
+	{
+		MessageBox(myHWND, L"Could not initialize the timer object.", L"Error", MB_OK);
+		return false;
+	}
+
 	return true;
 }
 
 void SystemClass::Shutdown()
 {
+	// Release the input log object, a recording is complete up to the last frame.
+	if (myInputLog != nullptr)
+	{
+		myInputLog->Shutdown();
+		delete myInputLog;
+		myInputLog = nullptr;
+	}
+
+	// Release the timer object.
+	if (myTimer != nullptr)
+	{
+		delete myTimer;
+		myTimer = nullptr;
+	}
+
 	// Release the graphics object.
 	if (myGraphics != nullptr)
 	{
@@ -88,8 +126,15 @@ void SystemClass::Run()
 	done = false;
 	while (!done)
 	{
-		// Handle the windows messages.
-		if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+		// When the last frame had nothing to draw, sleep until input arrives or the graphics object expects a change.
+		// A replay does not wait for input, its frames come from the log.
+		if (myGraphics->IsIdle() && (myInputLog == nullptr || !myInputLog->IsPlaying()))
+		{
+			MsgWaitForMultipleObjectsEx(0, nullptr, (DWORD)(myGraphics->GetIdleTimeout() * 1000.0f), QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+		}
+
+		// Handle all the windows messages that are waiting.
+		while (msg.message != WM_QUIT && PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
 		{
 			TranslateMessage(&msg);
 			DispatchMessage(&msg);
@@ -111,28 +156,287 @@ void SystemClass::Run()
 		}
 	}
 
+	ReportCapture();
+
 	return;
 }
 
+int SystemClass::RunScenario(const char* aOutputPath, const char* aTracePath, const char* aBaselinePath, float aThreshold)
+{
+	ScenarioReport report;
+	MSG msg;
+	unsigned int i;
+	int frame, regressionCount;
+	float frameTime;
+	bool result;
+
+	// A replay runs for as many frames as were recorded.
+	if (myInputLog != nullptr && myInputLog->IsPlaying())
+	{
+		myScenario.frameCount = myInputLog->GetFrameCount() - myScenario.warmupFrameCount;
+	}
+
+	// Initialize the report for every frame that is measured.
+	result = report.Initialize(myScenario);
+	if (!result)
+	{
+		printf("Scenario %s has no frames to run.\n", myScenario.name);
+		return 1;
+	}
+
+	// Run the warm-up frames first so chunks are built, caches are filled and the particle counts have settled,
+	// then record every frame. Each frame advances by the same step however long it took.
+	printf("Scenario %s: %d frames of %.4f s after %d warm-up frames\n", myScenario.name, myScenario.frameCount, myScenario.frameTime,
+		myScenario.warmupFrameCount);
+	for (frame = 0; frame < myScenario.warmupFrameCount + myScenario.frameCount; frame++)
+	{
+		// Keep the hidden window responsive.
+		while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+		{
+			TranslateMessage(&msg);
+			DispatchMessage(&msg);
+		}
+
+		// A replay takes the time step and the input of every frame from the log, and ends where the session did.
+		frameTime = myScenario.frameTime;
+		if (myInputLog != nullptr && myInputLog->IsPlaying())
+		{
+			if (!ReadReplayFrame(frameTime) || myInput->IsKeyDown(VK_ESCAPE))
+			{
+				break;
+			}
+		}
+
+		result = myGraphics->Frame(frameTime);
+		if (!result)
+		{
+			printf("Frame %d failed.\n", frame);
+			return 1;
+		}
+		if (frame >= myScenario.warmupFrameCount)
+		{
+			report.AddFrame(myGraphics->GetFrameStats());
+		}
+	}
+	report.Finish();
+
+	for (i = 0; i < report.GetMetrics().size(); i++)
+	{
+		printf("  %-24s %12.4f\n", report.GetMetrics()[i].name, report.GetMetrics()[i].value);
+	}
+	ReportCapture();
+
+	// Write the metrics in the format a baseline is read from, and every frame when asked to.
+	if (aOutputPath != nullptr && !report.Write(aOutputPath))
+	{
+		printf("Could not write %s.\n", aOutputPath);
+		return 1;
+	}
+	if (aTracePath != nullptr && !report.WriteTrace(aTracePath))
+	{
+		printf("Could not write %s.\n", aTracePath);
+		return 1;
+	}
+
+	// Fail the run when any cost grew past the threshold of its baseline.
+	if (aBaselinePath != nullptr)
+	{
+		result = report.Compare(aBaselinePath, aThreshold, regressionCount);
+		if (!result)
+		{
+			printf("Could not read baseline %s.\n", aBaselinePath);
+			return 1;
+		}
+		if (regressionCount > 0)
+		{
+			printf("Scenario %s: %d metrics regressed by more than %.0f%%.\n", myScenario.name, regressionCount, aThreshold * 100.0f);
+			return 1;
+		}
+		printf("Scenario %s: within %.0f%% of the baseline.\n", myScenario.name, aThreshold * 100.0f);
+	}
+
+	return 0;
+}
+
+bool SystemClass::StartRecording(const char* aPath)
+{
+	bool result;
+
+	// Create the input log object.
+	myInputLog = new InputLog;
+	if (!myInputLog)
+	{
+		return false;
+	}
+
+	// Initialize the input log object to record every key and frame time from here on.
+	result = myInputLog->InitializeRecording(aPath);
+	if (!result)
+	{
+		MessageBox(myHWND, L"Could not create the input log.", L"Error", MB_OK);
+		return false;
+	}
+
+	return true;
+}
+
+bool SystemClass::StartReplay(const char* aPath, bool aRealTime, float aFixedStep)
+{
+	bool result;
+
+	// Create the input log object.
+	myInputLog = new InputLog;
+	if (!myInputLog)
+	{
+		return false;
+	}
+
+	// Initialize the input log object to play a recorded session back.
+	result = myInputLog->InitializePlayback(aPath);
+	if (!result)
+	{
+		MessageBox(myHWND, L"Could not read the input log.", L"Error", MB_OK);
+		return false;
+	}
+
+	// Either keep the pace of the session or run as fast as possible, optionally with one fixed step for every frame.
+	myReplayRealTime = aRealTime;
+	myReplayFixedStep = aFixedStep;
+	return true;
+}
+
+bool SystemClass::StartCapture(const char* aDirectory, CaptureEncoder::Format aFormat, bool aLossless)
+{
+	bool result;
+
+	// Capture every frame from here on into an image sequence.
+	result = myGraphics->StartCapture(aDirectory, aFormat, true, aLossless);
+	if (!result)
+	{
+		MessageBox(myHWND, L"Could not start the frame capture.", L"Error", MB_OK);
+		return false;
+	}
+
+	return true;
+}
+
 bool SystemClass::Frame()
 {
+	float frameTime;
 	bool result;
 
+	if (myInputLog != nullptr && myInputLog->IsPlaying())
+	{
+		// Take the input and time step of the frame from the log, the replay is over when the log is.
+		result = ReadReplayFrame(frameTime);
+		if (!result)
+		{
+			return false;
+		}
+	}
+	else
+	{
+		// Update the system stats.
+		myTimer->Frame();
+		frameTime = myTimer->GetTime();
+
+		// Write the frame with the input that arrived before it.
+		if (myInputLog != nullptr && myInputLog->IsRecording())
+		{
+			myInputLog->RecordFrame(frameTime);
+		}
+	}
+
 	// Check if the user pressed escape and wants to exit the application.
 	if (myInput->IsKeyDown(VK_ESCAPE))
 	{
 		return false;
 	}
 
+	// Take a screenshot when F12 goes down, holding it down takes only one.
+	if (myInput->IsKeyDown(VK_F12))
+	{
+		if (!myScreenshotKeyDown)
+		{
+			myGraphics->RequestScreenshot();
+		}
+		myScreenshotKeyDown = true;
+	}
+	else
+	{
+		myScreenshotKeyDown = false;
+	}
+
 	// Do the frame processing for the graphics object.
-	result = myGraphics->Frame();
+	result = myGraphics->Frame(frameTime);
+	if (!result)
+	{
+		return false;
+	}
+	return true;
+}
+
+bool SystemClass::ReadReplayFrame(float& aFrameTime)
+{
+	const InputLog::Event* events;
+	int eventCount, i;
+	float remaining;
+	bool result;
+
+	result = myInputLog->ReadFrame(aFrameTime, events, eventCount);
 	if (!result)
 	{
 		return false;
 	}
+
+	// Feed the recorded input to the input object as if it had just arrived.
+	for (i = 0; i < eventCount; i++)
+	{
+		if (events[i].type == InputLog::KEY_DOWN)
+		{
+			myInput->KeyDown(events[i].key);
+		}
+		else if (events[i].type == InputLog::KEY_UP)
+		{
+			myInput->KeyUp(events[i].key);
+		}
+	}
+
+	// In real time wait until the frame took as long as it did in the session, sleeping while there is time to spare.
+	if (myReplayRealTime)
+	{
+		remaining = aFrameTime - myTimer->GetTimeSinceFrame();
+		while (remaining > 0.0f)
+		{
+			Sleep(remaining > 0.002f ? 1 : 0);
+			remaining = aFrameTime - myTimer->GetTimeSinceFrame();
+		}
+		myTimer->Frame();
+	}
+
+	// A fixed step replaces the recorded one, so replays on any machine simulate the same frames.
+	if (myReplayFixedStep > 0.0f)
+	{
+		aFrameTime = myReplayFixedStep;
+	}
 	return true;
 }
 
+void SystemClass::ReportCapture()
+{
+	FrameCapture::Stats stats;
+
+	// Wait until every captured frame is on the disk, then tell how the capture kept up.
+	myGraphics->FlushCapture();
+	if (!myGraphics->GetCaptureStats(stats))
+	{
+		return;
+	}
+	printf("Capture: %d frames written, %d failed, %d dropped\n", stats.writtenCount, stats.failedCount, stats.droppedCount);
+	printf("  readback latency %.2f ms average, %.2f ms max, %.1f frames average, %d frames max\n", stats.averageLatency,
+		stats.maxLatency, stats.averageLatencyFrames, stats.maxLatencyFrames);
+}
+
 LRESULT CALLBACK SystemClass::MessageHandler(HWND aHWND, UINT aUINT, WPARAM aWPARAM, LPARAM aLPARAM)
 {
 	switch (aUINT)
@@ -140,19 +444,48 @@ LRESULT CALLBACK SystemClass::MessageHandler(HWND aHWND, UINT aUINT, WPARAM aWPA
 		// Check if a key has been pressed on the keyboard.
 	case WM_KEYDOWN:
 	{
+		// A replay only listens to escape, everything else comes from the log.
+		if (myInputLog != nullptr && myInputLog->IsPlaying() && aWPARAM != VK_ESCAPE)
+		{
+			return 0;
+		}
+
 		// If a key is pressed send it to the input object so it can record that state.
 		myInput->KeyDown((unsigned int)aWPARAM);
+		if (myInputLog != nullptr && myInputLog->IsRecording())
+		{
+			myInputLog->RecordEvent(InputLog::KEY_DOWN, (unsigned int)aWPARAM);
+		}
 		return 0;
 	}
 
 	// Check if a key has been released on the keyboard.
 	case WM_KEYUP:
 	{
+		if (myInputLog != nullptr && myInputLog->IsPlaying() && aWPARAM != VK_ESCAPE)
+		{
+			return 0;
+		}
+
 		// If a key is released then send it to the input object so it can unset the state for that key.
 		myInput->KeyUp((unsigned int)aWPARAM);
+		if (myInputLog != nullptr && myInputLog->IsRecording())
+		{
+			myInputLog->RecordEvent(InputLog::KEY_UP, (unsigned int)aWPARAM);
+		}
 		return 0;
 	}
 
+	// Check if part of the window has to be repainted, the back buffer no longer matches what is on the screen.
+	case WM_PAINT:
+	{
+		if (myGraphics != nullptr)
+		{
+			myGraphics->Invalidate();
+		}
+		return DefWindowProc(aHWND, aUINT, aWPARAM, aLPARAM);
+	}
+
 	// Any other messages send to the default message handler as our application won't make use of them.
 	default:
 	{
@@ -161,7 +494,7 @@ LRESULT CALLBACK SystemClass::MessageHandler(HWND aHWND, UINT aUINT, WPARAM aWPA
 	}
 }
 
-void SystemClass::InitializeWindows(int& aScreenWidth, int& aScreenHeight)
+void SystemClass::InitializeWindows(int& aScreenWidth, int& aScreenHeight, bool aHeadless)
 {
 	WNDCLASSEX wc;
 	DEVMODE dmScreenSettings;
@@ -198,7 +531,7 @@ void SystemClass::InitializeWindows(int& aScreenWidth, int& aScreenHeight)
 	aScreenHeight = GetSystemMetrics(SM_CYSCREEN);
 
 	// Setup the screen settings depending on whether it is running in full screen or in windowed mode.
-	if (FULL_SCREEN)
+	if (FULL_SCREEN && !aHeadless)
 	{
 		// If full screen set the screen to maximum size of the users desktop and 32bit.
 		memset(&dmScreenSettings, 0, sizeof(dmScreenSettings));
@@ -230,6 +563,12 @@ void SystemClass::InitializeWindows(int& aScreenWidth, int& aScreenHeight)
 		WS_CLIPSIBLINGS | WS_CLIPCHILDREN | WS_POPUP,
 		posX, posY, aScreenWidth, aScreenHeight, nullptr, nullptr, myHinstance, nullptr);
 
+	// A headless run keeps the window hidden, it only exists for the error messages.
+	if (aHeadless)
+	{
+		return;
+	}
+
 	// Bring the window up on the screen and set it as main focus.
 	ShowWindow(myHWND, SW_SHOW);
 	SetForegroundWindow(myHWND);
@@ -244,10 +583,13 @@ void SystemClass::InitializeWindows(int& aScreenWidth, int& aScreenHeight)
 void SystemClass::ShutdownWindows()
 {
 	// Show the mouse cursor.
-	ShowCursor(true);
+	if (!myHeadless)
+	{
+		ShowCursor(true);
+	}
 
 	// Fix the display settings if leaving full screen mode.
-	if (FULL_SCREEN)
+	if (FULL_SCREEN && !myHeadless)
 	{
 		ChangeDisplaySettings(nullptr, 0);
 	}
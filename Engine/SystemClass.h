@@ -4,23 +4,32 @@
 #include <windows.h>
 #include "inputclass.h"
 #include "graphicsclass.h"
+#include "Timer.h"
+#include "InputLog.h"
 
 class SystemClass
 {
 public:
 	SystemClass();
-	SystemClass(const SystemClass& aSystemClass);
+	SystemClass(const SystemClass& aSystemClass) = delete;
 	~SystemClass();
 
-	bool Initialize();
+	bool Initialize(const Scenario& aScenario, bool aHeadless);
 	void Shutdown();
 	void Run();
+	int RunScenario(const char* aOutputPath, const char* aTracePath, const char* aBaselinePath, float aThreshold);
+
+	bool StartRecording(const char* aPath);
+	bool StartReplay(const char* aPath, bool aRealTime, float aFixedStep);
+	bool StartCapture(const char* aDirectory, CaptureEncoder::Format aFormat, bool aLossless);
 
 	LRESULT CALLBACK MessageHandler(HWND aHWND, UINT aUINT, WPARAM aWPARAM, LPARAM aLPARAM);
 
 private:
 	bool Frame();
-	void InitializeWindows(int& aScreenWidth, int& aScreenHeight);
+	bool ReadReplayFrame(float& aFrameTime);
+	void ReportCapture();
+	void InitializeWindows(int& aScreenWidth, int& aScreenHeight, bool aHeadless);
 	void ShutdownWindows();
 
 	LPCWSTR myApplicationName;
@@ -29,6 +38,13 @@ private:
 
 	InputClass* myInput;
 	GraphicsClass* myGraphics;
+	Timer* myTimer;
+	InputLog* myInputLog;
+	bool myReplayRealTime;
+	float myReplayFixedStep;
+	bool myScreenshotKeyDown;
+	Scenario myScenario;
+	bool myHeadless;
 };
 
 
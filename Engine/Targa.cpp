@@ -0,0 +1,74 @@
+#include "Targa.h"
+#include <string.h>
+
+// Image type of uncompressed true color images, the only kind the decoder reads.
+static const unsigned char TARGA_TYPE_TRUE_COLOR = 2;
+
+bool ReadTargaHeader(const TargaHeader& aHeader, int& aWidth, int& aHeight)
+{
+	// Check that it is uncompressed and 32 bit, not 24 bit.
+	if (aHeader.data1[2] != TARGA_TYPE_TRUE_COLOR || aHeader.bpp != 32)
+	{
+		return false;
+	}
+
+	// Get the important information from the header.
+	aWidth = (int)aHeader.width;
+	aHeight = (int)aHeader.height;
+	return aWidth > 0 && aHeight > 0;
+}
+
+void SwizzleRedBlue(const unsigned char* aSource, unsigned char* aDestination, int aPixelCount)
+{
+	unsigned int pixel;
+	int i;
+
+	// Work on whole pixels instead of single bytes: keep green and alpha, swap the other two.
+	// Byte order in memory is the same on every platform the engine runs on, so this is B G R A to R G B A.
+	for (i = 0; i < aPixelCount; i++)
+	{
+		memcpy(&pixel, aSource + i * 4, 4);
+		pixel = (pixel & 0xff00ff00u) | ((pixel & 0x000000ffu) << 16) | ((pixel & 0x00ff0000u) >> 16);
+		memcpy(aDestination + i * 4, &pixel, 4);
+	}
+}
+
+void ConvertTargaPixels(const unsigned char* aSource, int aWidth, int aHeight, unsigned char* aDestination)
+{
+	int y;
+
+	// Targa rows are stored upside down, so the last row of the file is the first of the texture.
+	for (y = 0; y < aHeight; y++)
+	{
+		SwizzleRedBlue(aSource + (size_t)(aHeight - 1 - y) * aWidth * 4, aDestination + (size_t)y * aWidth * 4, aWidth);
+	}
+}
+
+bool DecodeTarga(const unsigned char* aFile, size_t aFileSize, unsigned char* aPixels, size_t aPixelsSize, int& aWidth, int& aHeight)
+{
+	TargaHeader header;
+	size_t imageSize;
+	bool result;
+
+	// Read and check the header.
+	if (aFileSize < sizeof(TargaHeader))
+	{
+		return false;
+	}
+	memcpy(&header, aFile, sizeof(TargaHeader));
+	result = ReadTargaHeader(header, aWidth, aHeight);
+	if (!result)
+	{
+		return false;
+	}
+
+	// Both the file and the output have to hold the whole image.
+	imageSize = (size_t)aWidth * aHeight * 4;
+	if (aFileSize - sizeof(TargaHeader) < imageSize || aPixelsSize < imageSize)
+	{
+		return false;
+	}
+
+	ConvertTargaPixels(aFile + sizeof(TargaHeader), aWidth, aHeight, aPixels);
+	return true;
+}
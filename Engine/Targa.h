@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stddef.h>
+
+// Header at the start of a targa file.
+struct TargaHeader
+{
+	unsigned char data1[12];
+	unsigned short width;
+	unsigned short height;
+	unsigned char bpp;
+	unsigned char data2;
+};
+
+// Decoding of uncompressed 32 bit targa images into the top down RGBA rows textures are created from.
+// Kept free of any graphics API so loading can be measured and reused without a device.
+bool ReadTargaHeader(const TargaHeader& aHeader, int& aWidth, int& aHeight);
+void SwizzleRedBlue(const unsigned char* aSource, unsigned char* aDestination, int aPixelCount);
+void ConvertTargaPixels(const unsigned char* aSource, int aWidth, int aHeight, unsigned char* aDestination);
+bool DecodeTarga(const unsigned char* aFile, size_t aFileSize, unsigned char* aPixels, size_t aPixelsSize, int& aWidth, int& aHeight);
@@ -0,0 +1,104 @@
+#include "TextRenderer.h"
+
+TextRenderer::TextRenderer()
+{
+	myGlyphCache = nullptr;
+	myAtlas = nullptr;
+	myBatch = nullptr;
+}
+
+TextRenderer::~TextRenderer()
+{
+}
+
+bool TextRenderer::Initialize(ID3D11Device& aDevice, GlyphCache& aGlyphCache, UploadRing& aUploadRing, QuadIndexBuffer& aQuadIndexBuffer,
+	int aMaxGlyphs)
+{
+	bool result;
+
+	myGlyphCache = &aGlyphCache;
+
+	// Create the atlas texture object.
+	myAtlas = new Texture;
+	if (!myAtlas)
+	{
+		return false;
+	}
+
+	// Initialize the atlas texture object at the size of the glyph cache.
+	result = myAtlas->Initialize(aDevice, myGlyphCache->GetAtlasSize(), myGlyphCache->GetAtlasSize());
+	if (!result)
+	{
+		return false;
+	}
+
+	// Create the glyph batch object.
+	myBatch = new SpriteBatch;
+	if (!myBatch)
+	{
+		return false;
+	}
+
+	// Initialize the glyph batch object.
+	return myBatch->Initialize(aUploadRing, aQuadIndexBuffer, aMaxGlyphs);
+}
+
+void TextRenderer::Shutdown()
+{
+	// Release the glyph batch object.
+	if (myBatch != nullptr)
+	{
+		myBatch->Shutdown();
+		delete myBatch;
+		myBatch = nullptr;
+	}
+	// Release the atlas texture object.
+	if (myAtlas != nullptr)
+	{
+		myAtlas->Shutdown();
+		delete myAtlas;
+		myAtlas = nullptr;
+	}
+	myGlyphCache = nullptr;
+}
+
+bool TextRenderer::Render(ID3D11DeviceContext& aDeviceContext, TextSystem& aTextSystem, Shader& aShader, XMMATRIX& aWorldMatrix,
+	XMMATRIX& aViewMatrix, XMMATRIX& aProjectionMatrix)
+{
+	SpriteVertex* vertices;
+	int glyphCount, left, top, right, bottom;
+	bool result;
+
+	// Lay out the texts that changed, this is also where new glyphs get rasterized into the atlas.
+	aTextSystem.Update();
+
+	// Copy the cells that changed to the atlas texture.
+	if (myGlyphCache->GetDirtyRect(left, top, right, bottom))
+	{
+		myAtlas->Update(aDeviceContext, myGlyphCache->GetPixels(), myGlyphCache->GetAtlasSize() * 4, left, top, right, bottom);
+		myGlyphCache->ClearDirtyRect();
+	}
+
+	// Copy the cached glyph quads into the batch.
+	result = myBatch->Begin(aDeviceContext);
+	if (!result)
+	{
+		return false;
+	}
+	glyphCount = aTextSystem.GetQuadCount();
+	vertices = myBatch->Allocate(glyphCount);
+	if (vertices != nullptr)
+	{
+		aTextSystem.Emit(vertices, glyphCount);
+	}
+	myBatch->End(aDeviceContext);
+
+	if (myBatch->GetIndexCount() == 0)
+	{
+		return true;
+	}
+
+	// Draw all glyphs in one call.
+	myBatch->Render(aDeviceContext);
+	return aShader.Render(aDeviceContext, myBatch->GetIndexCount(), aWorldMatrix, aViewMatrix, aProjectionMatrix, *myAtlas->GetTexture());
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <d3d11.h>
+#include <directxmath.h>
+#include "GlyphCache.h"
+#include "Shader.h"
+#include "SpriteBatch.h"
+#include "TextSystem.h"
+#include "Texture.h"
+
+using namespace DirectX;
+
+// Draws every visible text of a text system with one call.
+// Cells of the glyph atlas that changed since the last frame are copied to the atlas texture before drawing.
+class TextRenderer
+{
+public:
+	TextRenderer();
+	TextRenderer(const TextRenderer& aTextRenderer) = delete;
+	~TextRenderer();
+
+	bool Initialize(ID3D11Device& aDevice, GlyphCache& aGlyphCache, UploadRing& aUploadRing, QuadIndexBuffer& aQuadIndexBuffer, int aMaxGlyphs);
+	void Shutdown();
+
+	bool Render(ID3D11DeviceContext& aDeviceContext, TextSystem& aTextSystem, Shader& aShader, XMMATRIX& aWorldMatrix,
+		XMMATRIX& aViewMatrix, XMMATRIX& aProjectionMatrix);
+
+private:
+	GlyphCache* myGlyphCache;
+	Texture* myAtlas;
+	SpriteBatch* myBatch;
+};
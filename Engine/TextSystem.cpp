@@ -0,0 +1,386 @@
+#include "TextSystem.h"
+#include "AllocationTracker.h"
+#include <string.h>
+
+TextSystem::TextSystem()
+{
+	myGlyphCache = nullptr;
+	myQuadCount = 0;
+	myLayoutCount = 0;
+	myRevision = 0;
+}
+
+TextSystem::~TextSystem()
+{
+}
+
+bool TextSystem::Initialize(GlyphCache& aGlyphCache)
+{
+	myGlyphCache = &aGlyphCache;
+	myQuadCount = 0;
+	myLayoutCount = 0;
+
+	return true;
+}
+
+void TextSystem::Shutdown()
+{
+	// Release the texts.
+	myTexts.clear();
+	myFreeTexts.clear();
+	myGlyphCache = nullptr;
+}
+
+int TextSystem::CreateText()
+{
+	int text;
+
+	// Reuse a destroyed text before growing the array.
+	if (!myFreeTexts.empty())
+	{
+		text = myFreeTexts.back();
+		myFreeTexts.pop_back();
+	}
+	else
+	{
+		text = (int)myTexts.size();
+		myTexts.push_back(Text());
+	}
+
+	myTexts[text].string.clear();
+	myTexts[text].x = 0.0f;
+	myTexts[text].y = 0.0f;
+	myTexts[text].scale = 1.0f;
+	myTexts[text].active = true;
+	myTexts[text].visible = true;
+	myTexts[text].dirty = true;
+	myTexts[text].evictionCount = 0;
+	myTexts[text].slots.clear();
+	myTexts[text].vertices.clear();
+	myRevision++;
+
+	return text;
+}
+
+void TextSystem::DestroyText(int aText)
+{
+	if (aText < 0 || aText >= (int)myTexts.size() || !myTexts[aText].active)
+	{
+		return;
+	}
+
+	myTexts[aText].active = false;
+	myFreeTexts.push_back(aText);
+	myRevision++;
+}
+
+void TextSystem::SetText(int aText, const char* aString)
+{
+	if (aText < 0 || aText >= (int)myTexts.size() || !myTexts[aText].active)
+	{
+		return;
+	}
+
+	// Setting the same string again keeps the layout.
+	if (strcmp(myTexts[aText].string.c_str(), aString) == 0)
+	{
+		return;
+	}
+	myTexts[aText].string = aString;
+	myTexts[aText].dirty = true;
+	myRevision++;
+}
+
+void TextSystem::SetPosition(int aText, float aX, float aY)
+{
+	Text* text;
+
+	if (aText < 0 || aText >= (int)myTexts.size() || !myTexts[aText].active)
+	{
+		return;
+	}
+
+	text = &myTexts[aText];
+	if (text->x != aX || text->y != aY)
+	{
+		text->x = aX;
+		text->y = aY;
+		text->dirty = true;
+		myRevision++;
+	}
+}
+
+void TextSystem::SetScale(int aText, float aScale)
+{
+	if (aText < 0 || aText >= (int)myTexts.size() || !myTexts[aText].active)
+	{
+		return;
+	}
+
+	if (myTexts[aText].scale != aScale)
+	{
+		myTexts[aText].scale = aScale;
+		myTexts[aText].dirty = true;
+		myRevision++;
+	}
+}
+
+void TextSystem::SetVisible(int aText, bool aVisible)
+{
+	if (aText < 0 || aText >= (int)myTexts.size() || !myTexts[aText].active)
+	{
+		return;
+	}
+
+	if (myTexts[aText].visible != aVisible)
+	{
+		myTexts[aText].visible = aVisible;
+		myRevision++;
+	}
+}
+
+void TextSystem::Update()
+{
+	Text* text;
+	int i, j;
+
+	ALLOCATION_SCOPE("Text");
+
+	myGlyphCache->BeginFrame();
+	myQuadCount = 0;
+	myLayoutCount = 0;
+
+	for (i = 0; i < (int)myTexts.size(); i++)
+	{
+		text = &myTexts[i];
+		if (!text->active || !text->visible)
+		{
+			continue;
+		}
+
+		// Glyphs are only ever evicted when unused in the current frame, so a text laid out before the last
+		// eviction may have lost one of its cells while it was hidden. Otherwise marking its glyphs as used is enough.
+		if (text->dirty || text->evictionCount != myGlyphCache->GetEvictionCount())
+		{
+			Layout(*text);
+			myLayoutCount++;
+		}
+		else
+		{
+			for (j = 0; j < (int)text->slots.size(); j++)
+			{
+				myGlyphCache->Touch(text->slots[j]);
+			}
+		}
+
+		myQuadCount += (int)text->vertices.size() / 4;
+	}
+}
+
+int TextSystem::GetQuadCount()
+{
+	return myQuadCount;
+}
+
+int TextSystem::Emit(SpriteVertex* aVertices, int aMaxQuads)
+{
+	const Text* text;
+	int i, quadCount, count;
+
+	// Copy the cached quads of every visible text, whatever does not fit is dropped.
+	quadCount = 0;
+	for (i = 0; i < (int)myTexts.size() && quadCount < aMaxQuads; i++)
+	{
+		text = &myTexts[i];
+		if (!text->active || !text->visible || text->vertices.empty())
+		{
+			continue;
+		}
+
+		count = (int)text->vertices.size() / 4;
+		if (count > aMaxQuads - quadCount)
+		{
+			count = aMaxQuads - quadCount;
+		}
+
+		memcpy(aVertices + quadCount * 4, &text->vertices[0], sizeof(SpriteVertex) * count * 4);
+		quadCount += count;
+	}
+
+	return quadCount;
+}
+
+bool TextSystem::GetBounds(AABB& aBounds)
+{
+	const Text* text;
+	int i, j;
+	bool found;
+
+	// Bound the quads of every visible text as they were last laid out.
+	found = false;
+	for (i = 0; i < (int)myTexts.size(); i++)
+	{
+		text = &myTexts[i];
+		if (!text->active || !text->visible)
+		{
+			continue;
+		}
+
+		for (j = 0; j < (int)text->vertices.size(); j++)
+		{
+			if (!found)
+			{
+				aBounds.minX = aBounds.maxX = text->vertices[j].x;
+				aBounds.minY = aBounds.maxY = text->vertices[j].y;
+				found = true;
+				continue;
+			}
+			aBounds.minX = text->vertices[j].x < aBounds.minX ? text->vertices[j].x : aBounds.minX;
+			aBounds.minY = text->vertices[j].y < aBounds.minY ? text->vertices[j].y : aBounds.minY;
+			aBounds.maxX = text->vertices[j].x > aBounds.maxX ? text->vertices[j].x : aBounds.maxX;
+			aBounds.maxY = text->vertices[j].y > aBounds.maxY ? text->vertices[j].y : aBounds.maxY;
+		}
+	}
+	return found;
+}
+
+int TextSystem::GetLayoutCount()
+{
+	return myLayoutCount;
+}
+
+unsigned int TextSystem::GetRevision()
+{
+	return myRevision;
+}
+
+void TextSystem::Layout(Text& aText)
+{
+	const char* string;
+	unsigned int codepoint;
+	int slot;
+	float penX, baseline, left, top, right, bottom;
+	SpriteVertex* vertices;
+	bool complete;
+
+	aText.slots.clear();
+	aText.vertices.clear();
+	complete = true;
+
+	// The pen starts on the baseline of the first line.
+	penX = 0.0f;
+	baseline = -myGlyphCache->GetAscent();
+
+	string = aText.string.c_str();
+	while (*string != 0)
+	{
+		codepoint = DecodeUTF8(string);
+
+		// Line breaks move the pen to the start of the next line.
+		if (codepoint == '\n')
+		{
+			penX = 0.0f;
+			baseline -= myGlyphCache->GetLineHeight();
+			continue;
+		}
+
+		// Glyphs that find no room in the atlas this frame are left out and the text is laid out again next frame.
+		slot = myGlyphCache->FindGlyph(codepoint);
+		if (slot < 0)
+		{
+			complete = false;
+			continue;
+		}
+		const GlyphCache::Glyph& glyph = myGlyphCache->GetGlyph(slot);
+
+		// Blank glyphs only move the pen.
+		if (glyph.width > 0.0f)
+		{
+			left = aText.x + (penX + glyph.offsetX) * aText.scale;
+			top = aText.y + (baseline + glyph.offsetY) * aText.scale;
+			right = left + glyph.width * aText.scale;
+			bottom = top - glyph.height * aText.scale;
+
+			aText.slots.push_back(slot);
+			aText.vertices.resize(aText.vertices.size() + 4);
+			vertices = &aText.vertices[aText.vertices.size() - 4];
+
+			// Same corner order as the sprite batch: bottom left, top left, bottom right, top right.
+			vertices[0].x = left;
+			vertices[0].y = bottom;
+			vertices[0].u = PackUNorm16(glyph.left);
+			vertices[0].v = PackUNorm16(glyph.bottom);
+
+			vertices[1].x = left;
+			vertices[1].y = top;
+			vertices[1].u = PackUNorm16(glyph.left);
+			vertices[1].v = PackUNorm16(glyph.top);
+
+			vertices[2].x = right;
+			vertices[2].y = bottom;
+			vertices[2].u = PackUNorm16(glyph.right);
+			vertices[2].v = PackUNorm16(glyph.bottom);
+
+			vertices[3].x = right;
+			vertices[3].y = top;
+			vertices[3].u = PackUNorm16(glyph.right);
+			vertices[3].v = PackUNorm16(glyph.top);
+		}
+
+		penX += glyph.advance;
+	}
+
+	aText.evictionCount = myGlyphCache->GetEvictionCount();
+	aText.dirty = !complete;
+}
+
+unsigned int TextSystem::DecodeUTF8(const char*& aString)
+{
+	const unsigned char* bytes;
+	unsigned int codepoint;
+	int length, i;
+
+	bytes = (const unsigned char*)aString;
+
+	// The lead byte tells how many continuation bytes follow.
+	if (bytes[0] < 0x80)
+	{
+		aString++;
+		return bytes[0];
+	}
+	else if ((bytes[0] & 0xe0) == 0xc0)
+	{
+		codepoint = bytes[0] & 0x1f;
+		length = 2;
+	}
+	else if ((bytes[0] & 0xf0) == 0xe0)
+	{
+		codepoint = bytes[0] & 0x0f;
+		length = 3;
+	}
+	else if ((bytes[0] & 0xf8) == 0xf0)
+	{
+		codepoint = bytes[0] & 0x07;
+		length = 4;
+	}
+	else
+	{
+		// Stray continuation bytes show as the replacement character.
+		aString++;
+		return 0xfffd;
+	}
+
+	for (i = 1; i < length; i++)
+	{
+		// A sequence cut short by the end of the string or by a new lead byte.
+		if ((bytes[i] & 0xc0) != 0x80)
+		{
+			aString += i;
+			return 0xfffd;
+		}
+		codepoint = (codepoint << 6) | (bytes[i] & 0x3f);
+	}
+
+	aString += length;
+	return codepoint;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "GlyphCache.h"
+#include "SpriteVertex.h"
+#include "Collision.h"
+
+// Lays out strings into glyph quads and keeps the result until the string, its position or its scale changes,
+// so text that stays the same from frame to frame costs one copy of its vertices.
+// Text is anchored at its top left corner, scale is world units per font pixel.
+// Only one text system should drive a glyph cache since Update starts the cache's frame.
+class TextSystem
+{
+public:
+	TextSystem();
+	TextSystem(const TextSystem& aTextSystem) = delete;
+	~TextSystem();
+
+	bool Initialize(GlyphCache& aGlyphCache);
+	void Shutdown();
+
+	int CreateText();
+	void DestroyText(int aText);
+	void SetText(int aText, const char* aString);
+	void SetPosition(int aText, float aX, float aY);
+	void SetScale(int aText, float aScale);
+	void SetVisible(int aText, bool aVisible);
+
+	void Update();
+	int GetQuadCount();
+	int Emit(SpriteVertex* aVertices, int aMaxQuads);
+	bool GetBounds(AABB& aBounds);
+
+	int GetLayoutCount();
+	unsigned int GetRevision();
+
+private:
+	struct Text
+	{
+		std::string string;
+		float x;
+		float y;
+		float scale;
+		bool active;
+		bool visible;
+		bool dirty;
+		unsigned int evictionCount;
+		std::vector<int> slots;
+		std::vector<SpriteVertex> vertices;
+	};
+
+	void Layout(Text& aText);
+	static unsigned int DecodeUTF8(const char*& aString);
+
+	GlyphCache* myGlyphCache;
+	std::vector<Text> myTexts;
+	std::vector<int> myFreeTexts;
+	int myQuadCount;
+	int myLayoutCount;
+	unsigned int myRevision;
+};
@@ -1,49 +1,136 @@
 #include "Texture.h"
 
+// How steep the relief of the normal maps built from the brightness of a texture is.
+static const float NORMAL_MAP_STRENGTH = 2.0f;
+
 Texture::Texture()
 {
 	myTargaData = nullptr;
 	myTexture = nullptr;
 	myTextureView = nullptr;
-}
-
-Texture::Texture(const Texture& aTexture)
-{
+	myNormalMap = nullptr;
+	myNormalMapView = nullptr;
+	myUploadQueue = nullptr;
+	myTextureTarget.deviceContext = nullptr;
+	myTextureTarget.texture = nullptr;
+	myTextureTarget.firstMip = 0;
+	myTextureTarget.mostDetailedMip = 0;
+	myNormalMapTarget.deviceContext = nullptr;
+	myNormalMapTarget.texture = nullptr;
+	myNormalMapTarget.firstMip = 0;
+	myNormalMapTarget.mostDetailedMip = 0;
+	myWidth = 0;
+	myHeight = 0;
+	myMipCount = 0;
+	myFirstMip = 0;
+	myMaterial = MATERIAL_OPAQUE;
+	myOutlineCount = 0;
 }
 
 Texture::~Texture()
 {
 }
 
-bool Texture::Initialize(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext, const std::string& aTexturePath)
+bool Texture::Initialize(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext, const std::string& aTexturePath, int aMaxOutlineVertices,
+	TextureUploadQueue* aUploadQueue)
 {
 	bool result;
 	int height;
 	int width;
-	D3D11_TEXTURE2D_DESC textureDesc;
-	HRESULT hResult;
-	unsigned int rowPitch;
-	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+	unsigned char* normals;
+	ScratchArena scratch;
 
-	// Load the targa image data into memory.
-	result = LoadTarga(aTexturePath.c_str(), height, width);
+	// Load the targa image data into scratch memory, it is released when the function returns.
+	result = LoadTarga(aTexturePath.c_str(), height, width, scratch);
 	if (!result)
 	{
 		return false;
 	}
 
-	// Setup the description of the texture.
-	textureDesc.Height = height;
-	textureDesc.Width = width;
-	textureDesc.MipLevels = 0;
+	// Remember where the image came from, a texture that lost its larger mips to the memory budget reads them again from there.
+	myTexturePath = aTexturePath;
+	myWidth = width;
+	myHeight = height;
+	myMipCount = TextureUploadQueue::GetMipCount(width, height);
+	myFirstMip = 0;
+
+	// Classify the image by its alpha while it is in memory, it decides which pass the texture is drawn in.
+	myMaterial = ClassifyAlpha(myTargaData, width * height);
+
+	// Outline the texels that are not fully transparent, so the image can be drawn without the empty space around it.
+	myOutlineCount = 0;
+	if (aMaxOutlineVertices > 0)
+	{
+		myOutlineCount = BuildSpriteOutline(myTargaData, width * 4, 0, 0, width, height, 1, aMaxOutlineVertices, myOutline);
+	}
+
+	// Create the texture with its mipmaps from the targa image data. With an upload queue the image arrives over the next frames,
+	// smallest mip first, instead of being copied and filtered on the GPU right away.
+	myUploadQueue = aUploadQueue;
+	if (myUploadQueue != nullptr)
+	{
+		result = CreateStreamedTexture(aDevice, aDeviceContext, 0, myTextureTarget, myTexture, myTextureView) &&
+			myUploadQueue->Submit(myTargaData, width, height, 0, myMipCount, myTextureTarget);
+	}
+	else
+	{
+		result = CreateMippedTexture(aDevice, aDeviceContext, myTargaData, width, height, myTexture, myTextureView);
+	}
+	if (!result)
+	{
+		return false;
+	}
+
+	// Build a normal map from the brightness of the image for the lit pixel shader, the sprites come without one of their own.
+	// It is a third image sized buffer, so it comes from the heap and leaves the scratch arena to the targa data.
+	normals = new unsigned char[width * height * 4];
+	if (normals == nullptr)
+	{
+		return false;
+	}
+	BuildNormalMap(myTargaData, width, height, NORMAL_MAP_STRENGTH, normals);
+	if (myUploadQueue != nullptr)
+	{
+		result = CreateStreamedTexture(aDevice, aDeviceContext, 0, myNormalMapTarget, myNormalMap, myNormalMapView) &&
+			myUploadQueue->Submit(normals, width, height, 0, myMipCount, myNormalMapTarget);
+	}
+	else
+	{
+		result = CreateMippedTexture(aDevice, aDeviceContext, normals, width, height, myNormalMap, myNormalMapView);
+	}
+	delete[] normals;
+	if (!result)
+	{
+		return false;
+	}
+
+	// Forget the targa image data now that the image data has been loaded into the texture.
+	myTargaData = nullptr;
+
+	return true;
+}
+
+bool Texture::Initialize(ID3D11Device& aDevice, int aWidth, int aHeight)
+{
+	D3D11_TEXTURE2D_DESC textureDesc;
+	HRESULT hResult;
+	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+
+	// The contents are not known yet, so the texture is treated as blended.
+	myMaterial = MATERIAL_TRANSLUCENT;
+
+	// Setup the description of a single mip texture that is filled in piece by piece with Update.
+	textureDesc.Height = aHeight;
+	textureDesc.Width = aWidth;
+	textureDesc.MipLevels = 1;
 	textureDesc.ArraySize = 1;
 	textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
 	textureDesc.SampleDesc.Count = 1;
 	textureDesc.SampleDesc.Quality = 0;
 	textureDesc.Usage = D3D11_USAGE_DEFAULT;
-	textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+	textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
 	textureDesc.CPUAccessFlags = 0;
-	textureDesc.MiscFlags = D3D11_RESOURCE_MISC_GENERATE_MIPS;
+	textureDesc.MiscFlags = 0;
 
 	// Create the empty texture.
 	hResult = aDevice.CreateTexture2D(&textureDesc, nullptr, &myTexture);
@@ -52,17 +139,11 @@ bool Texture::Initialize(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceCont
 		return false;
 	}
 
-	// Set the row pitch of the targa image data.
-	rowPitch = (width * 4) * sizeof(unsigned char);
-
-	// Copy the targa image data into the texture.
-	aDeviceContext.UpdateSubresource(myTexture, 0, nullptr, myTargaData, rowPitch, 0);
-
 	// Setup the shader resource view description.
 	srvDesc.Format = textureDesc.Format;
 	srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
 	srvDesc.Texture2D.MostDetailedMip = 0;
-	srvDesc.Texture2D.MipLevels = -1;
+	srvDesc.Texture2D.MipLevels = 1;
 
 	// Create the shader resource view for the texture.
 	hResult = aDevice.CreateShaderResourceView(myTexture, &srvDesc, &myTextureView);
@@ -71,18 +152,126 @@ bool Texture::Initialize(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceCont
 		return false;
 	}
 
-	// Generate mipmaps for this texture.
-	aDeviceContext.GenerateMips(myTextureView);
+	return true;
+}
 
-	// Release the targa image data now that the image data has been loaded into the texture.
-	delete[] myTargaData;
-	myTargaData = nullptr;
+void Texture::Update(ID3D11DeviceContext& aDeviceContext, const unsigned char* aPixels, int aRowPitch, int aLeft, int aTop, int aRight, int aBottom)
+{
+	D3D11_BOX box;
+
+	if (myTexture == nullptr || aRight <= aLeft || aBottom <= aTop)
+	{
+		return;
+	}
+
+	// Only copy the changed rectangle, the source pointer has to point at its top left pixel.
+	box.left = aLeft;
+	box.top = aTop;
+	box.front = 0;
+	box.right = aRight;
+	box.bottom = aBottom;
+	box.back = 1;
+
+	aDeviceContext.UpdateSubresource(myTexture, 0, &box, aPixels + aTop * aRowPitch + aLeft * 4, aRowPitch, 0);
+}
+
+bool Texture::SetFirstMip(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext, int aFirstMip)
+{
+	bool result;
+	int height;
+	int width;
+	unsigned char* normals;
+	ScratchArena scratch;
+
+	// Only a texture streamed in through the upload queue can give up its mips and get them back.
+	if (myUploadQueue == nullptr || aFirstMip < 0 || aFirstMip > myMipCount)
+	{
+		return false;
+	}
+	if (aFirstMip == myFirstMip)
+	{
+		return true;
+	}
+
+	// Drop the pieces still on their way, the mips they were bringing are read again below if they are still wanted.
+	myUploadQueue->Cancel(myNormalMapTarget);
+	myUploadQueue->Cancel(myTextureTarget);
+
+	// Move both textures to the new first mip, keeping the mips they already had.
+	result = ResizeStreamedTexture(aDevice, aDeviceContext, aFirstMip, myTextureTarget, myTexture, myTextureView);
+	if (!result)
+	{
+		return false;
+	}
+	result = ResizeStreamedTexture(aDevice, aDeviceContext, aFirstMip, myNormalMapTarget, myNormalMap, myNormalMapView);
+	if (!result)
+	{
+		return false;
+	}
+	myFirstMip = aFirstMip;
+
+	// The larger mips that are missing come from the image file again, the queue builds them down from the full image and only
+	// uploads those the texture does not have.
+	if (myTextureTarget.mostDetailedMip > aFirstMip || myNormalMapTarget.mostDetailedMip > aFirstMip)
+	{
+		result = LoadTarga(myTexturePath, height, width, scratch);
+		if (!result || width != myWidth || height != myHeight)
+		{
+			myTargaData = nullptr;
+			return false;
+		}
+		if (myTextureTarget.mostDetailedMip > aFirstMip)
+		{
+			result = myUploadQueue->Submit(myTargaData, width, height, aFirstMip, myTextureTarget.mostDetailedMip, myTextureTarget);
+			if (!result)
+			{
+				myTargaData = nullptr;
+				return false;
+			}
+		}
+		if (myNormalMapTarget.mostDetailedMip > aFirstMip)
+		{
+			normals = new unsigned char[width * height * 4];
+			if (normals == nullptr)
+			{
+				myTargaData = nullptr;
+				return false;
+			}
+			BuildNormalMap(myTargaData, width, height, NORMAL_MAP_STRENGTH, normals);
+			result = myUploadQueue->Submit(normals, width, height, aFirstMip, myNormalMapTarget.mostDetailedMip, myNormalMapTarget);
+			delete[] normals;
+			if (!result)
+			{
+				myTargaData = nullptr;
+				return false;
+			}
+		}
+		myTargaData = nullptr;
+	}
 
 	return true;
 }
 
 void Texture::Shutdown()
 {
+	// Drop the pieces still waiting to be uploaded.
+	if (myUploadQueue != nullptr)
+	{
+		myUploadQueue->Cancel(myNormalMapTarget);
+		myUploadQueue->Cancel(myTextureTarget);
+		myUploadQueue = nullptr;
+	}
+	// Release the normal map.
+	if (myNormalMapView != nullptr)
+	{
+		myNormalMapView->Release();
+		myNormalMapView = nullptr;
+	}
+	if (myNormalMap != nullptr)
+	{
+		myNormalMap->Release();
+		myNormalMap = nullptr;
+	}
 	// Release the texture view resource.
 	if (myTextureView != nullptr)
 	{
@@ -95,12 +284,7 @@ void Texture::Shutdown()
 		myTexture->Release();
 		myTexture = nullptr;
 	}
-	// Release the targa data.
-	if (myTargaData != nullptr)
-	{
-		delete[] myTargaData;
-		myTargaData = nullptr;
-	}
+	myTargaData = nullptr;
 }
 
 ID3D11ShaderResourceView* Texture::GetTexture()
@@ -108,13 +292,40 @@ ID3D11ShaderResourceView* Texture::GetTexture()
 	return myTextureView;
 }
 
-bool Texture::LoadTarga(const std::string& aTexturePath, int& aHeight, int& aWidth)
+ID3D11ShaderResourceView* Texture::GetNormalMap()
+{
+	return myNormalMapView;
+}
+
+MaterialType Texture::GetMaterial()
+{
+	return myMaterial;
+}
+
+const OutlinePoint* Texture::GetOutline(int& aCount)
+{
+	aCount = myOutlineCount;
+	return myOutline;
+}
+
+int Texture::GetWidth()
+{
+	return myWidth;
+}
+
+int Texture::GetHeight()
+{
+	return myHeight;
+}
+
+bool Texture::LoadTarga(const std::string& aTexturePath, int& aHeight, int& aWidth, ScratchArena& aScratch)
 {
-	int error, bpp, imageSize, index, i, j, k;
+	int error, imageSize;
 	FILE* filePtr;
 	unsigned int count;
 	TargaHeader targaFileHeader;
 	unsigned char* targaImage;
+	bool result;
 
 
 	// Open the targa file for reading in binary.
@@ -128,17 +339,15 @@ bool Texture::LoadTarga(const std::string& aTexturePath, int& aHeight, int& aWid
 	count = (unsigned int)fread(&targaFileHeader, sizeof(TargaHeader), 1, filePtr);
 	if (count != 1)
 	{
+		fclose(filePtr);
 		return false;
 	}
 
-	// Get the important information from the header.
-	aHeight = (int)targaFileHeader.height;
-	aWidth = (int)targaFileHeader.width;
-	bpp = (int)targaFileHeader.bpp;
-
-	// Check that it is 32 bit and not 24 bit.
-	if (bpp != 32)
+	// Check that it is an uncompressed 32 bit image and get its size.
+	result = ReadTargaHeader(targaFileHeader, aWidth, aHeight);
+	if (!result)
 	{
+		fclose(filePtr);
 		return false;
 	}
 
@@ -146,16 +355,18 @@ bool Texture::LoadTarga(const std::string& aTexturePath, int& aHeight, int& aWid
 	imageSize = aWidth * aHeight * 4;
 
 	// Allocate memory for the targa image data.
-	targaImage = new unsigned char[imageSize];
+	targaImage = aScratch.AllocateArray<unsigned char>(imageSize);
 	if (!targaImage)
 	{
+		fclose(filePtr);
 		return false;
 	}
 
 	// Read in the targa image data.
 	count = (unsigned int)fread(targaImage, 1, imageSize, filePtr);
-	if (count != imageSize)
+	if (count != (unsigned int)imageSize)
 	{
+		fclose(filePtr);
 		return false;
 	}
 
@@ -167,40 +378,205 @@ bool Texture::LoadTarga(const std::string& aTexturePath, int& aHeight, int& aWid
 	}
 
 	// Allocate memory for the targa destination data.
-	myTargaData = new unsigned char[imageSize];
+	myTargaData = aScratch.AllocateArray<unsigned char>(imageSize);
 	if (!myTargaData)
 	{
 		return false;
 	}
 
-	// Initialize the index into the targa destination data array.
-	index = 0;
+	// Flip the rows and swap red and blue to get the top down RGBA the texture is created from.
+	ConvertTargaPixels(targaImage, aWidth, aHeight, myTargaData);
+
+	return true;
+}
+
+bool Texture::CreateMippedTexture(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext, const unsigned char* aPixels, int aWidth, int aHeight,
+	ID3D11Texture2D*& aTexture, ID3D11ShaderResourceView*& aTextureView)
+{
+	D3D11_TEXTURE2D_DESC textureDesc;
+	HRESULT hResult;
+	unsigned int rowPitch;
+	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+
+	// Setup the description of the texture.
+	textureDesc.Height = aHeight;
+	textureDesc.Width = aWidth;
+	textureDesc.MipLevels = 0;
+	textureDesc.ArraySize = 1;
+	textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.SampleDesc.Quality = 0;
+	textureDesc.Usage = D3D11_USAGE_DEFAULT;
+	textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+	textureDesc.CPUAccessFlags = 0;
+	textureDesc.MiscFlags = D3D11_RESOURCE_MISC_GENERATE_MIPS;
+
+	// Create the empty texture.
+	hResult = aDevice.CreateTexture2D(&textureDesc, nullptr, &aTexture);
+	if (FAILED(hResult))
+	{
+		return false;
+	}
+
+	// Set the row pitch of the image data.
+	rowPitch = (aWidth * 4) * sizeof(unsigned char);
+
+	// Copy the image data into the texture.
+	aDeviceContext.UpdateSubresource(aTexture, 0, nullptr, aPixels, rowPitch, 0);
 
-	// Initialize the index into the targa image data.
-	k = (aWidth * aHeight * 4) - (aWidth * 4);
+	// Setup the shader resource view description.
+	srvDesc.Format = textureDesc.Format;
+	srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Texture2D.MostDetailedMip = 0;
+	srvDesc.Texture2D.MipLevels = -1;
 
-	// Now copy the targa image data into the targa destination array in the correct order since the targa format is stored upside down.
-	for (j = 0; j < aHeight; j++)
+	// Create the shader resource view for the texture.
+	hResult = aDevice.CreateShaderResourceView(aTexture, &srvDesc, &aTextureView);
+	if (FAILED(hResult))
 	{
-		for (i = 0; i < aWidth; i++)
+		return false;
+	}
+
+	// Generate mipmaps for this texture.
+	aDeviceContext.GenerateMips(aTextureView);
+
+	return true;
+}
+
+bool Texture::CreateStreamedTexture(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext, int aFirstMip, MipTarget& aTarget,
+	ID3D11Texture2D*& aTexture, ID3D11ShaderResourceView*& aTextureView)
+{
+	D3D11_TEXTURE2D_DESC textureDesc;
+	HRESULT hResult;
+	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+
+	// Setup the description of the texture from its first mip down, with room for every mip since the upload queue fills them
+	// in itself.
+	textureDesc.Height = TextureUploadQueue::GetMipSize(myHeight, aFirstMip);
+	textureDesc.Width = TextureUploadQueue::GetMipSize(myWidth, aFirstMip);
+	textureDesc.MipLevels = myMipCount - aFirstMip;
+	textureDesc.ArraySize = 1;
+	textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.SampleDesc.Quality = 0;
+	textureDesc.Usage = D3D11_USAGE_DEFAULT;
+	textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	textureDesc.CPUAccessFlags = 0;
+	textureDesc.MiscFlags = 0;
+
+	// Create the empty texture.
+	hResult = aDevice.CreateTexture2D(&textureDesc, nullptr, &aTexture);
+	if (FAILED(hResult))
+	{
+		return false;
+	}
+
+	// Setup the shader resource view description.
+	srvDesc.Format = textureDesc.Format;
+	srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Texture2D.MostDetailedMip = 0;
+	srvDesc.Texture2D.MipLevels = -1;
+
+	// Create the shader resource view for the texture.
+	hResult = aDevice.CreateShaderResourceView(aTexture, &srvDesc, &aTextureView);
+	if (FAILED(hResult))
+	{
+		return false;
+	}
+
+	// Only sample the smallest mip until the larger ones arrive, none of them has yet.
+	aDeviceContext.SetResourceMinLOD(aTexture, (float)(myMipCount - aFirstMip - 1));
+	aTarget.deviceContext = &aDeviceContext;
+	aTarget.texture = aTexture;
+	aTarget.firstMip = aFirstMip;
+	aTarget.mostDetailedMip = myMipCount;
+
+	return true;
+}
+
+bool Texture::ResizeStreamedTexture(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext, int aFirstMip, MipTarget& aTarget,
+	ID3D11Texture2D*& aTexture, ID3D11ShaderResourceView*& aTextureView)
+{
+	ID3D11Texture2D* oldTexture;
+	ID3D11ShaderResourceView* oldTextureView;
+	int oldFirstMip, mostDetailedMip, mip;
+	bool result;
+
+	oldTexture = aTexture;
+	oldTextureView = aTextureView;
+	oldFirstMip = aTarget.firstMip;
+	mostDetailedMip = aTarget.mostDetailedMip;
+	aTexture = nullptr;
+	aTextureView = nullptr;
+
+	// An evicted texture keeps nothing.
+	if (aFirstMip < myMipCount)
+	{
+		result = CreateStreamedTexture(aDevice, aDeviceContext, aFirstMip, aTarget, aTexture, aTextureView);
+		if (!result)
 		{
-			myTargaData[index + 0] = targaImage[k + 2];  // Red.
-			myTargaData[index + 1] = targaImage[k + 1];  // Green.
-			myTargaData[index + 2] = targaImage[k + 0];  // Blue
-			myTargaData[index + 3] = targaImage[k + 3];  // Alpha
-
-			// Increment the indexes into the targa data.
-			k += 4;
-			index += 4;
+			if (aTexture != nullptr)
+			{
+				aTexture->Release();
+			}
+			aTexture = oldTexture;
+			aTextureView = oldTextureView;
+			aTarget.texture = oldTexture;
+			aTarget.firstMip = oldFirstMip;
+			aTarget.mostDetailedMip = mostDetailedMip;
+			return false;
 		}
 
-		// Set the targa image data index back to the preceding row at the beginning of the column since its reading it in upside down.
-		k -= (aWidth * 8);
+		// Copy the mips that both the old and the new texture hold on the GPU, and let them be sampled.
+		mostDetailedMip = mostDetailedMip > aFirstMip ? mostDetailedMip : aFirstMip;
+		for (mip = mostDetailedMip; mip < myMipCount && oldTexture != nullptr; mip++)
+		{
+			aDeviceContext.CopySubresourceRegion(aTexture, D3D11CalcSubresource(mip - aFirstMip, 0, myMipCount - aFirstMip), 0, 0, 0, oldTexture,
+				D3D11CalcSubresource(mip - oldFirstMip, 0, myMipCount - oldFirstMip), nullptr);
+		}
+		if (oldTexture != nullptr && mostDetailedMip < myMipCount)
+		{
+			aTarget.SetMostDetailedMip(mostDetailedMip);
+		}
+	}
+	else
+	{
+		aTarget.texture = nullptr;
+		aTarget.firstMip = aFirstMip;
+		aTarget.mostDetailedMip = myMipCount;
 	}
 
-	// Release the targa image data now that it was copied into the destination array.
-	delete[] targaImage;
-	targaImage = nullptr;
+	// Release the old texture, anything still drawing with it holds its own reference to the view.
+	if (oldTextureView != nullptr)
+	{
+		oldTextureView->Release();
+	}
+	if (oldTexture != nullptr)
+	{
+		oldTexture->Release();
+	}
 
 	return true;
+}
+
+void Texture::MipTarget::UploadRows(int aMip, int aTop, int aBottom, const unsigned char* aPixels, int aRowPitch)
+{
+	D3D11_BOX box;
+
+	// Copy the rows across the whole width of the mip.
+	box.left = 0;
+	box.top = aTop;
+	box.front = 0;
+	box.right = aRowPitch / 4;
+	box.bottom = aBottom;
+	box.back = 1;
+
+	deviceContext->UpdateSubresource(texture, D3D11CalcSubresource(aMip - firstMip, 0, 0), &box, aPixels, aRowPitch, 0);
+}
+
+void Texture::MipTarget::SetMostDetailedMip(int aMip)
+{
+	// Let the sampler use the mip that just arrived.
+	deviceContext->SetResourceMinLOD(texture, (float)(aMip - firstMip));
+	mostDetailedMip = aMip;
 }
\ No newline at end of file
@@ -3,32 +3,72 @@
 #include <d3d11.h>
 #include <stdio.h>
 #include <string>
+#include "Material.h"
+#include "NormalMap.h"
+#include "ScratchArena.h"
+#include "SpriteOutline.h"
+#include "Targa.h"
+#include "TextureUploadQueue.h"
 
 class Texture
 {
 public:
 	Texture();
-	Texture(const Texture& aTexture);
+	Texture(const Texture& aTexture) = delete;
 	~Texture();
 
-	bool Initialize(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext, const std::string& aTexturePath);
+	bool Initialize(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext, const std::string& aTexturePath, int aMaxOutlineVertices,
+		TextureUploadQueue* aUploadQueue);
+	bool Initialize(ID3D11Device& aDevice, int aWidth, int aHeight);
 	void Shutdown();
 
+	void Update(ID3D11DeviceContext& aDeviceContext, const unsigned char* aPixels, int aRowPitch, int aLeft, int aTop, int aRight, int aBottom);
+	bool SetFirstMip(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext, int aFirstMip);
+
 	ID3D11ShaderResourceView* GetTexture();
+	ID3D11ShaderResourceView* GetNormalMap();
+	MaterialType GetMaterial();
+	const OutlinePoint* GetOutline(int& aCount);
+	int GetWidth();
+	int GetHeight();
 
 private:
-	struct TargaHeader
+	// Copies the pieces of one of the textures from the upload queue and lets it be sampled down to the mips that arrived.
+	// Mips are counted in the full chain of the image, the texture itself may start further down it at its first mip.
+	class MipTarget : public TextureUploadTarget
 	{
-		unsigned char data1[12];
-		unsigned short width;
-		unsigned short height;
-		unsigned char bpp;
-		unsigned char data2;
+	public:
+		void UploadRows(int aMip, int aTop, int aBottom, const unsigned char* aPixels, int aRowPitch) override;
+		void SetMostDetailedMip(int aMip) override;
+
+		ID3D11DeviceContext* deviceContext;
+		ID3D11Texture2D* texture;
+		int firstMip;
+		int mostDetailedMip;
 	};
 
-	bool LoadTarga(const std::string& aTexturePath, int& aHeight, int& aWidth);
+	bool LoadTarga(const std::string& aTexturePath, int& aHeight, int& aWidth, ScratchArena& aScratch);
+	bool CreateMippedTexture(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext, const unsigned char* aPixels, int aWidth, int aHeight,
+		ID3D11Texture2D*& aTexture, ID3D11ShaderResourceView*& aTextureView);
+	bool CreateStreamedTexture(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext, int aFirstMip, MipTarget& aTarget,
+		ID3D11Texture2D*& aTexture, ID3D11ShaderResourceView*& aTextureView);
+	bool ResizeStreamedTexture(ID3D11Device& aDevice, ID3D11DeviceContext& aDeviceContext, int aFirstMip, MipTarget& aTarget,
+		ID3D11Texture2D*& aTexture, ID3D11ShaderResourceView*& aTextureView);
 	
 	unsigned char* myTargaData;
 	ID3D11Texture2D* myTexture;
 	ID3D11ShaderResourceView* myTextureView;
+	ID3D11Texture2D* myNormalMap;
+	ID3D11ShaderResourceView* myNormalMapView;
+	TextureUploadQueue* myUploadQueue;
+	MipTarget myTextureTarget;
+	MipTarget myNormalMapTarget;
+	std::string myTexturePath;
+	int myWidth;
+	int myHeight;
+	int myMipCount;
+	int myFirstMip;
+	MaterialType myMaterial;
+	OutlinePoint myOutline[MAX_OUTLINE_VERTICES];
+	int myOutlineCount;
 };
@@ -0,0 +1,116 @@
+#include "TextureArray.h"
+
+TextureArray::TextureArray()
+{
+	myTexture = nullptr;
+	myTextureView = nullptr;
+	myWidth = 0;
+	mySliceCount = 0;
+	myMipCount = 0;
+}
+
+TextureArray::~TextureArray()
+{
+}
+
+bool TextureArray::Initialize(ID3D11Device& aDevice, int aWidth, int aHeight, int aSliceCount)
+{
+	D3D11_TEXTURE2D_DESC textureDesc;
+	HRESULT hResult;
+	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+
+	if (aWidth <= 0 || aHeight <= 0 || aSliceCount <= 0 || aSliceCount > D3D11_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION)
+	{
+		return false;
+	}
+
+	// Setup the description of the texture array, with a full mip chain for every slice.
+	textureDesc.Height = aHeight;
+	textureDesc.Width = aWidth;
+	textureDesc.MipLevels = 0;
+	textureDesc.ArraySize = aSliceCount;
+	textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.SampleDesc.Quality = 0;
+	textureDesc.Usage = D3D11_USAGE_DEFAULT;
+	textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+	textureDesc.CPUAccessFlags = 0;
+	textureDesc.MiscFlags = D3D11_RESOURCE_MISC_GENERATE_MIPS;
+
+	// Create the empty texture array.
+	hResult = aDevice.CreateTexture2D(&textureDesc, nullptr, &myTexture);
+	if (FAILED(hResult))
+	{
+		return false;
+	}
+
+	// Read back how many mips the device gave it, the subresources of a slice are counted with it.
+	myTexture->GetDesc(&textureDesc);
+	myMipCount = textureDesc.MipLevels;
+	myWidth = aWidth;
+	mySliceCount = aSliceCount;
+
+	// Setup the shader resource view description over every slice.
+	srvDesc.Format = textureDesc.Format;
+	srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+	srvDesc.Texture2DArray.MostDetailedMip = 0;
+	srvDesc.Texture2DArray.MipLevels = -1;
+	srvDesc.Texture2DArray.FirstArraySlice = 0;
+	srvDesc.Texture2DArray.ArraySize = aSliceCount;
+
+	// Create the shader resource view for the texture array.
+	hResult = aDevice.CreateShaderResourceView(myTexture, &srvDesc, &myTextureView);
+	if (FAILED(hResult))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void TextureArray::Shutdown()
+{
+	// Release the texture view resource.
+	if (myTextureView != nullptr)
+	{
+		myTextureView->Release();
+		myTextureView = nullptr;
+	}
+	// Release the texture array.
+	if (myTexture != nullptr)
+	{
+		myTexture->Release();
+		myTexture = nullptr;
+	}
+	mySliceCount = 0;
+}
+
+void TextureArray::SetSlice(ID3D11DeviceContext& aDeviceContext, int aSlice, const unsigned char* aPixels)
+{
+	if (myTexture == nullptr || aSlice < 0 || aSlice >= mySliceCount)
+	{
+		return;
+	}
+
+	// Copy the tightly packed RGBA image into the largest mip of its slice.
+	aDeviceContext.UpdateSubresource(myTexture, D3D11CalcSubresource(0, aSlice, myMipCount), nullptr, aPixels, myWidth * 4, 0);
+}
+
+void TextureArray::GenerateMips(ID3D11DeviceContext& aDeviceContext)
+{
+	// Filter the smaller mips of every slice from the largest one.
+	if (myTextureView != nullptr)
+	{
+		aDeviceContext.GenerateMips(myTextureView);
+	}
+}
+
+ID3D11ShaderResourceView* TextureArray::GetTexture()
+{
+	return myTextureView;
+}
+
+int TextureArray::GetSliceCount()
+{
+	return mySliceCount;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <d3d11.h>
+
+// A texture array of images that share one size, each image in a slice of its own with a full mip chain.
+// The slices are filled one at a time, then the mips of all of them are generated on the GPU in one go.
+class TextureArray
+{
+public:
+	TextureArray();
+	TextureArray(const TextureArray& aTextureArray) = delete;
+	~TextureArray();
+
+	bool Initialize(ID3D11Device& aDevice, int aWidth, int aHeight, int aSliceCount);
+	void Shutdown();
+
+	void SetSlice(ID3D11DeviceContext& aDeviceContext, int aSlice, const unsigned char* aPixels);
+	void GenerateMips(ID3D11DeviceContext& aDeviceContext);
+
+	ID3D11ShaderResourceView* GetTexture();
+	int GetSliceCount();
+
+private:
+	ID3D11Texture2D* myTexture;
+	ID3D11ShaderResourceView* myTextureView;
+	int myWidth;
+	int mySliceCount;
+	int myMipCount;
+};
@@ -0,0 +1,66 @@
+#include "TextureArrayGroups.h"
+
+TextureArrayGroups::TextureArrayGroups()
+{
+	myMaxSlices = 0;
+}
+
+TextureArrayGroups::~TextureArrayGroups()
+{
+}
+
+bool TextureArrayGroups::Initialize(int aMaxSlices)
+{
+	if (aMaxSlices <= 0)
+	{
+		return false;
+	}
+	myMaxSlices = aMaxSlices;
+	myGroups.clear();
+
+	return true;
+}
+
+void TextureArrayGroups::Shutdown()
+{
+	myGroups.clear();
+}
+
+bool TextureArrayGroups::Add(int aWidth, int aHeight, int aFormat, Location& aLocation)
+{
+	Group group;
+	unsigned int i;
+
+	if (aWidth <= 0 || aHeight <= 0)
+	{
+		return false;
+	}
+
+	// Take the next slice of a group the texture matches, the groups are few so they are searched in order.
+	for (i = 0; i < myGroups.size(); i++)
+	{
+		if (myGroups[i].width == aWidth && myGroups[i].height == aHeight && myGroups[i].format == aFormat && myGroups[i].sliceCount < myMaxSlices)
+		{
+			aLocation.group = (int)i;
+			aLocation.slice = myGroups[i].sliceCount++;
+			return true;
+		}
+	}
+
+	// Start a new group when none matches or the ones that do are full.
+	group.width = aWidth;
+	group.height = aHeight;
+	group.format = aFormat;
+	group.sliceCount = 1;
+	myGroups.push_back(group);
+	aLocation.group = (int)myGroups.size() - 1;
+	aLocation.slice = 0;
+
+	return true;
+}
+
+const TextureArrayGroups::Group* TextureArrayGroups::GetGroups(int& aCount)
+{
+	aCount = (int)myGroups.size();
+	return myGroups.data();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+// Sorts textures into groups that can each be one texture array: the same size and format, up to the most slices an array
+// holds. Every texture drawn from a group binds the same view, so sprites of different images are drawn in one call with
+// the slice of their image in their vertices, without packing the images into an atlas.
+class TextureArrayGroups
+{
+public:
+	// Where a texture went, the group is the array and the slice its place in it.
+	struct Location
+	{
+		int group;
+		int slice;
+	};
+
+	struct Group
+	{
+		int width;
+		int height;
+		int format;
+		int sliceCount;
+	};
+
+	TextureArrayGroups();
+	TextureArrayGroups(const TextureArrayGroups& aTextureArrayGroups) = delete;
+	~TextureArrayGroups();
+
+	bool Initialize(int aMaxSlices);
+	void Shutdown();
+
+	bool Add(int aWidth, int aHeight, int aFormat, Location& aLocation);
+
+	const Group* GetGroups(int& aCount);
+
+private:
+	std::vector<Group> myGroups;
+	int myMaxSlices;
+};
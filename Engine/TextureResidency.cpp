@@ -0,0 +1,360 @@
+#include "TextureResidency.h"
+#include <string.h>
+
+TextureResidency::TextureResidency()
+{
+	myBudgetBytes = 0;
+	myResidentBytes = 0;
+	myMinResidentSize = 0;
+	myFrame = 1;
+	memset(&myStats, 0, sizeof(myStats));
+}
+
+TextureResidency::~TextureResidency()
+{
+}
+
+bool TextureResidency::Initialize(long long aBudgetBytes, int aMinResidentSize)
+{
+	if (aBudgetBytes <= 0 || aMinResidentSize <= 0)
+	{
+		return false;
+	}
+	myBudgetBytes = aBudgetBytes;
+	myResidentBytes = 0;
+	myMinResidentSize = aMinResidentSize;
+
+	// Frame zero stands for never used.
+	myFrame = 1;
+	memset(&myStats, 0, sizeof(myStats));
+
+	return true;
+}
+
+void TextureResidency::Shutdown()
+{
+	myTextures.clear();
+	myChanges.clear();
+	myResidentBytes = 0;
+}
+
+int TextureResidency::AddTexture(int aWidth, int aHeight, int aBytesPerTexel)
+{
+	Entry entry;
+	int texture, mip;
+
+	if (aWidth <= 0 || aHeight <= 0 || aBytesPerTexel <= 0)
+	{
+		return -1;
+	}
+
+	// Add up the bytes from every mip to the smallest, so the size of any resident tail of the chain is one lookup.
+	entry.mipCount = TextureUploadQueue::GetMipCount(aWidth, aHeight);
+	entry.mipBytes[entry.mipCount] = 0;
+	for (mip = entry.mipCount - 1; mip >= 0; mip--)
+	{
+		entry.mipBytes[mip] = entry.mipBytes[mip + 1] +
+			(long long)TextureUploadQueue::GetMipSize(aWidth, mip) * TextureUploadQueue::GetMipSize(aHeight, mip) * aBytesPerTexel;
+	}
+
+	// The floor is the largest mip that fits in the minimum size, textures are only reduced down to it before being evicted.
+	entry.floorMip = 0;
+	while (entry.floorMip < entry.mipCount - 1 && (TextureUploadQueue::GetMipSize(aWidth, entry.floorMip) > myMinResidentSize ||
+		TextureUploadQueue::GetMipSize(aHeight, entry.floorMip) > myMinResidentSize))
+	{
+		entry.floorMip++;
+	}
+
+	// The texture was just loaded whole, and counts as used so it is not evicted in the frame it arrived.
+	entry.firstMip = 0;
+	entry.lastUsedFrame = myFrame;
+	entry.usedSinceFrame = myFrame;
+	entry.active = true;
+	myResidentBytes += entry.mipBytes[0];
+
+	// Reuse the slot of a removed texture when there is one.
+	for (texture = 0; texture < (int)myTextures.size(); texture++)
+	{
+		if (!myTextures[texture].active)
+		{
+			myTextures[texture] = entry;
+			return texture;
+		}
+	}
+	myTextures.push_back(entry);
+	return (int)myTextures.size() - 1;
+}
+
+void TextureResidency::RemoveTexture(int aTexture)
+{
+	unsigned int i;
+
+	if (aTexture < 0 || aTexture >= (int)myTextures.size() || !myTextures[aTexture].active)
+	{
+		return;
+	}
+
+	// Give back its memory and forget what was decided for it this frame.
+	myResidentBytes -= myTextures[aTexture].mipBytes[myTextures[aTexture].firstMip];
+	myTextures[aTexture].active = false;
+	for (i = 0; i < myChanges.size(); i++)
+	{
+		if (myChanges[i].texture == aTexture)
+		{
+			myChanges.erase(myChanges.begin() + i);
+			break;
+		}
+	}
+}
+
+void TextureResidency::BeginFrame()
+{
+	myFrame++;
+	myChanges.clear();
+}
+
+void TextureResidency::Touch(int aTexture)
+{
+	if (aTexture >= 0 && aTexture < (int)myTextures.size())
+	{
+		// A texture not used in the last frame starts a new run of frames in use.
+		if (myTextures[aTexture].lastUsedFrame + 1 < myFrame)
+		{
+			myTextures[aTexture].usedSinceFrame = myFrame;
+		}
+		myTextures[aTexture].lastUsedFrame = myFrame;
+	}
+}
+
+void TextureResidency::Update()
+{
+	Entry* entry;
+	long long extra, largest;
+	unsigned int i;
+	int texture;
+
+	// Bring the textures used this frame back up a mip at a time, as long as the budget has room or room can be made from
+	// textures that are not in use. A texture in use is always given its floor, whatever the budget says, but only goes above
+	// it once it has been in use for a while.
+	for (texture = 0; texture < (int)myTextures.size(); texture++)
+	{
+		entry = &myTextures[texture];
+		if (!entry->active || entry->lastUsedFrame != myFrame || entry->firstMip == 0)
+		{
+			continue;
+		}
+		if (entry->firstMip > entry->floorMip)
+		{
+			SetFirstMip(texture, entry->floorMip);
+		}
+		if (myFrame - entry->usedSinceFrame < TEXTURE_RAISE_DELAY_FRAMES)
+		{
+			continue;
+		}
+		while (entry->firstMip > 0)
+		{
+			extra = entry->mipBytes[entry->firstMip - 1] - entry->mipBytes[entry->firstMip];
+			if (myResidentBytes + extra > myBudgetBytes && (GetFreeableBytes() < myResidentBytes + extra - myBudgetBytes ||
+				!FreeUnused(myResidentBytes + extra - myBudgetBytes)))
+			{
+				break;
+			}
+			SetFirstMip(texture, entry->firstMip - 1);
+		}
+	}
+
+	// Shrink what no longer fits, the budget may have been lowered or textures added. The textures not in use go first, then the
+	// largest of those in use drop their top mips down to their floor.
+	if (myResidentBytes > myBudgetBytes)
+	{
+		FreeUnused(myResidentBytes - myBudgetBytes);
+	}
+	while (myResidentBytes > myBudgetBytes)
+	{
+		texture = -1;
+		largest = 0;
+		for (i = 0; i < myTextures.size(); i++)
+		{
+			entry = &myTextures[i];
+			if (entry->active && entry->firstMip < entry->floorMip && entry->mipBytes[entry->firstMip] > largest)
+			{
+				largest = entry->mipBytes[entry->firstMip];
+				texture = (int)i;
+			}
+		}
+		if (texture < 0)
+		{
+			break;
+		}
+		SetFirstMip(texture, myTextures[texture].firstMip + 1);
+	}
+
+	// Sum up the frame for the telemetry.
+	myStats.frameReduceCount = 0;
+	myStats.frameEvictCount = 0;
+	myStats.frameReloadCount = 0;
+	for (i = 0; i < myChanges.size(); i++)
+	{
+		if (myChanges[i].firstMip < myChanges[i].previousFirstMip)
+		{
+			myStats.frameReloadCount++;
+		}
+		else if (myChanges[i].firstMip == myTextures[myChanges[i].texture].mipCount)
+		{
+			myStats.frameEvictCount++;
+		}
+		else
+		{
+			myStats.frameReduceCount++;
+		}
+	}
+}
+
+const TextureResidency::Change* TextureResidency::GetChanges(int& aCount)
+{
+	aCount = (int)myChanges.size();
+	return myChanges.data();
+}
+
+int TextureResidency::GetFirstMip(int aTexture)
+{
+	if (aTexture < 0 || aTexture >= (int)myTextures.size())
+	{
+		return 0;
+	}
+	return myTextures[aTexture].firstMip;
+}
+
+void TextureResidency::SetBudget(long long aBudgetBytes)
+{
+	myBudgetBytes = aBudgetBytes;
+}
+
+void TextureResidency::GetStats(TextureResidency::Stats& aStats)
+{
+	unsigned int i;
+
+	aStats = myStats;
+	aStats.budgetBytes = myBudgetBytes;
+	aStats.residentBytes = myResidentBytes;
+	aStats.fullBytes = 0;
+	aStats.textureCount = 0;
+	aStats.fullCount = 0;
+	aStats.reducedCount = 0;
+	aStats.evictedCount = 0;
+	for (i = 0; i < myTextures.size(); i++)
+	{
+		if (!myTextures[i].active)
+		{
+			continue;
+		}
+		aStats.fullBytes += myTextures[i].mipBytes[0];
+		aStats.textureCount++;
+		if (myTextures[i].firstMip == 0)
+		{
+			aStats.fullCount++;
+		}
+		else if (myTextures[i].firstMip == myTextures[i].mipCount)
+		{
+			aStats.evictedCount++;
+		}
+		else
+		{
+			aStats.reducedCount++;
+		}
+	}
+	aStats.overBudget = myResidentBytes > myBudgetBytes;
+}
+
+long long TextureResidency::GetFreeableBytes()
+{
+	long long bytes;
+	unsigned int i;
+
+	// Everything resident of the textures not used this frame.
+	bytes = 0;
+	for (i = 0; i < myTextures.size(); i++)
+	{
+		if (myTextures[i].active && myTextures[i].lastUsedFrame != myFrame)
+		{
+			bytes += myTextures[i].mipBytes[myTextures[i].firstMip];
+		}
+	}
+	return bytes;
+}
+
+bool TextureResidency::FreeUnused(long long aBytes)
+{
+	long long target;
+	int texture;
+
+	// Reduce the textures not in use to their floor, least recently used first, and only then evict them.
+	target = myResidentBytes - aBytes;
+	while (myResidentBytes > target)
+	{
+		texture = FindUnused(true);
+		if (texture >= 0)
+		{
+			SetFirstMip(texture, myTextures[texture].floorMip);
+			continue;
+		}
+		texture = FindUnused(false);
+		if (texture < 0)
+		{
+			return false;
+		}
+		SetFirstMip(texture, myTextures[texture].mipCount);
+	}
+	return true;
+}
+
+int TextureResidency::FindUnused(bool aAboveFloor)
+{
+	unsigned int i, oldest;
+	int texture;
+
+	// The least recently used texture that still has something to give, as long as it was not used this frame.
+	texture = -1;
+	oldest = myFrame;
+	for (i = 0; i < myTextures.size(); i++)
+	{
+		if (myTextures[i].active && myTextures[i].lastUsedFrame < oldest &&
+			myTextures[i].firstMip < (aAboveFloor ? myTextures[i].floorMip : myTextures[i].mipCount))
+		{
+			oldest = myTextures[i].lastUsedFrame;
+			texture = (int)i;
+		}
+	}
+	return texture;
+}
+
+void TextureResidency::SetFirstMip(int aTexture, int aFirstMip)
+{
+	Entry* entry;
+	unsigned int i;
+
+	entry = &myTextures[aTexture];
+	myResidentBytes += entry->mipBytes[aFirstMip] - entry->mipBytes[entry->firstMip];
+
+	// Keep one change per texture and frame, from where it started the frame to where it ends up.
+	for (i = 0; i < myChanges.size(); i++)
+	{
+		if (myChanges[i].texture == aTexture)
+		{
+			break;
+		}
+	}
+	if (i == myChanges.size())
+	{
+		myChanges.push_back({ aTexture, aFirstMip, entry->firstMip });
+	}
+	else if (myChanges[i].previousFirstMip == aFirstMip)
+	{
+		myChanges.erase(myChanges.begin() + i);
+	}
+	else
+	{
+		myChanges[i].firstMip = aFirstMip;
+	}
+	entry->firstMip = aFirstMip;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vector>
+#include "TextureUploadQueue.h"
+
+// Frames in a row a texture has to be used before it is raised above its floor again. A texture drawn for a frame or two is
+// drawn blurry rather than reloaded, only to be reduced again as soon as it is out of use.
+const int TEXTURE_RAISE_DELAY_FRAMES = 8;
+
+// Keeps the textures within a budget of video memory by deciding which of their mips stay resident.
+// Textures are touched in the frames that draw them. Each Update first raises the textures used this frame back to full detail
+// as far as the budget allows, then shrinks what no longer fits: textures not used this frame lose their top mips down to a
+// small floor, least recently used first, then are evicted outright, and only then do the textures in use drop their top mips,
+// largest first, so a card with little memory draws blurrier textures rather than none. Textures in use are never evicted.
+// Textures that were reduced only come back once they have been in use for a few frames in a row, so the ones drawn in passing
+// do not make others give up their mips for a single frame.
+// Only the decisions are made here: the renderer reads the changes of the frame and recreates or reloads its textures.
+class TextureResidency
+{
+public:
+	// A new first resident mip for a texture, the mip count when it was evicted.
+	struct Change
+	{
+		int texture;
+		int firstMip;
+		int previousFirstMip;
+	};
+
+	// The frame counts cover the last call to Update.
+	struct Stats
+	{
+		long long budgetBytes;
+		long long residentBytes;
+		long long fullBytes;
+		int textureCount;
+		int fullCount;
+		int reducedCount;
+		int evictedCount;
+		int frameReduceCount;
+		int frameEvictCount;
+		int frameReloadCount;
+		bool overBudget;
+	};
+
+	TextureResidency();
+	TextureResidency(const TextureResidency& aTextureResidency) = delete;
+	~TextureResidency();
+
+	bool Initialize(long long aBudgetBytes, int aMinResidentSize);
+	void Shutdown();
+
+	int AddTexture(int aWidth, int aHeight, int aBytesPerTexel);
+	void RemoveTexture(int aTexture);
+
+	void BeginFrame();
+	void Touch(int aTexture);
+	void Update();
+
+	const Change* GetChanges(int& aCount);
+	int GetFirstMip(int aTexture);
+	void SetBudget(long long aBudgetBytes);
+	void GetStats(Stats& aStats);
+
+private:
+	struct Entry
+	{
+		long long mipBytes[MAX_TEXTURE_MIPS + 1];
+		int mipCount;
+		int floorMip;
+		int firstMip;
+		unsigned int lastUsedFrame;
+		unsigned int usedSinceFrame;
+		bool active;
+	};
+
+	long long GetFreeableBytes();
+	bool FreeUnused(long long aBytes);
+	int FindUnused(bool aAboveFloor);
+	void SetFirstMip(int aTexture, int aFirstMip);
+
+	std::vector<Entry> myTextures;
+	std::vector<Change> myChanges;
+	long long myBudgetBytes;
+	long long myResidentBytes;
+	int myMinResidentSize;
+	unsigned int myFrame;
+	Stats myStats;
+};
@@ -0,0 +1,292 @@
+#include "TextureUploadQueue.h"
+#include <chrono>
+#include <string.h>
+
+TextureUploadQueue::TextureUploadQueue()
+{
+	myMaxBytesPerFrame = 0;
+	myMaxMilliseconds = 0.0f;
+	myBlockBytes = 0;
+	memset(&myStats, 0, sizeof(myStats));
+}
+
+TextureUploadQueue::~TextureUploadQueue()
+{
+}
+
+bool TextureUploadQueue::Initialize(int aMaxBytesPerFrame, float aMaxMilliseconds, int aBlockBytes)
+{
+	if (aMaxBytesPerFrame <= 0 || aMaxMilliseconds <= 0.0f || aBlockBytes <= 0)
+	{
+		return false;
+	}
+	myMaxBytesPerFrame = aMaxBytesPerFrame;
+	myMaxMilliseconds = aMaxMilliseconds;
+	myBlockBytes = aBlockBytes;
+	memset(&myStats, 0, sizeof(myStats));
+
+	return true;
+}
+
+void TextureUploadQueue::Shutdown()
+{
+	unsigned int i;
+
+	// Drop the uploads that are still pending along with their images.
+	for (i = 0; i < myUploads.size(); i++)
+	{
+		delete[] myUploads[i].pixels;
+	}
+	myUploads.clear();
+}
+
+bool TextureUploadQueue::Submit(const unsigned char* aPixels, int aWidth, int aHeight, int aFirstMip, int aEndMip, TextureUploadTarget& aTarget)
+{
+	Upload upload;
+	size_t size;
+	int mip, width, height;
+
+	if (aPixels == nullptr || aWidth <= 0 || aHeight <= 0 || aFirstMip < 0 || aFirstMip >= aEndMip || aEndMip > GetMipCount(aWidth, aHeight))
+	{
+		return false;
+	}
+
+	// Lay the mip chain out in one block down to the last mip uploaded, the largest mip first, each one half the size of the one
+	// before.
+	upload.mipCount = aEndMip;
+	size = 0;
+	for (mip = 0; mip < upload.mipCount; mip++)
+	{
+		width = GetMipSize(aWidth, mip);
+		height = GetMipSize(aHeight, mip);
+		upload.mipOffsets[mip] = size;
+		size += (size_t)width * height * 4;
+	}
+
+	// Keep a copy of the image, the caller's memory only has to last until this returns. The smaller mips are built from it
+	// over the next frames.
+	upload.pixels = new unsigned char[size];
+	if (!upload.pixels)
+	{
+		return false;
+	}
+	memcpy(upload.pixels, aPixels, (size_t)aWidth * aHeight * 4);
+
+	upload.target = &aTarget;
+	upload.width = aWidth;
+	upload.height = aHeight;
+	upload.firstMip = aFirstMip;
+	upload.buildMip = 1;
+	upload.buildRow = 0;
+	upload.uploadMip = upload.mipCount - 1;
+	upload.uploadRow = 0;
+	myUploads.push_back(upload);
+
+	return true;
+}
+
+void TextureUploadQueue::Cancel(TextureUploadTarget& aTarget)
+{
+	unsigned int i;
+
+	// Forget the uploads of a texture that is released before they finished.
+	for (i = 0; i < myUploads.size();)
+	{
+		if (myUploads[i].target == &aTarget)
+		{
+			delete[] myUploads[i].pixels;
+			myUploads.erase(myUploads.begin() + i);
+		}
+		else
+		{
+			i++;
+		}
+	}
+}
+
+void TextureUploadQueue::Update()
+{
+	std::chrono::high_resolution_clock::time_point start, now;
+	Upload* upload;
+	int width, height, top, bottom, bytes, mip;
+	unsigned int i;
+
+	start = std::chrono::high_resolution_clock::now();
+	myStats.frameBytes = 0;
+	myStats.frameBlockCount = 0;
+	myStats.frameMipCount = 0;
+
+	// Work on the oldest texture first, so each one finishes as early as it can.
+	while (!myUploads.empty())
+	{
+		upload = &myUploads[0];
+		if (upload->buildMip < upload->mipCount)
+		{
+			// Build the next rows of the mip being built from the one above it.
+			width = GetMipSize(upload->width, upload->buildMip);
+			height = GetMipSize(upload->height, upload->buildMip);
+			top = upload->buildRow;
+			bottom = top + GetBlockRows(width) < height ? top + GetBlockRows(width) : height;
+			BuildRows(*upload, upload->buildMip, top, bottom);
+			upload->buildRow = bottom;
+			if (bottom == height)
+			{
+				upload->buildMip++;
+				upload->buildRow = 0;
+			}
+		}
+		else
+		{
+			// Stop short of the byte budget rather than go over it, unless the frame has not uploaded anything yet.
+			width = GetMipSize(upload->width, upload->uploadMip);
+			height = GetMipSize(upload->height, upload->uploadMip);
+			bytes = (height - upload->uploadRow < GetBlockRows(width) ? height - upload->uploadRow : GetBlockRows(width)) * width * 4;
+			if (myStats.frameBytes > 0 && myStats.frameBytes + bytes > myMaxBytesPerFrame)
+			{
+				break;
+			}
+			myStats.frameBytes += UploadBlock(*upload);
+
+			// The texture is done once the largest mip asked for is.
+			if (upload->uploadMip < upload->firstMip)
+			{
+				delete[] upload->pixels;
+				myUploads.erase(myUploads.begin());
+				myStats.completedCount++;
+			}
+		}
+		myStats.frameBlockCount++;
+
+		now = std::chrono::high_resolution_clock::now();
+		if (std::chrono::duration<float, std::milli>(now - start).count() >= myMaxMilliseconds || myStats.frameBytes >= myMaxBytesPerFrame)
+		{
+			break;
+		}
+	}
+
+	// Count what is left for the next frames.
+	myStats.pendingCount = (int)myUploads.size();
+	myStats.pendingBytes = 0;
+	for (i = 0; i < myUploads.size(); i++)
+	{
+		upload = &myUploads[i];
+		for (mip = upload->firstMip; mip <= upload->uploadMip; mip++)
+		{
+			width = GetMipSize(upload->width, mip);
+			height = GetMipSize(upload->height, mip);
+			myStats.pendingBytes += (long long)width * height * 4;
+		}
+		myStats.pendingBytes -= (long long)upload->uploadRow * GetMipSize(upload->width, upload->uploadMip) * 4;
+	}
+
+	now = std::chrono::high_resolution_clock::now();
+	myStats.frameTime = std::chrono::duration<float, std::milli>(now - start).count();
+}
+
+bool TextureUploadQueue::IsPending(TextureUploadTarget& aTarget)
+{
+	unsigned int i;
+
+	for (i = 0; i < myUploads.size(); i++)
+	{
+		if (myUploads[i].target == &aTarget)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void TextureUploadQueue::GetStats(Stats& aStats)
+{
+	aStats = myStats;
+}
+
+int TextureUploadQueue::GetMipCount(int aWidth, int aHeight)
+{
+	int count, size;
+
+	// The full chain down to a single texel, the way Direct3D counts the mips of a texture.
+	size = aWidth > aHeight ? aWidth : aHeight;
+	count = 1;
+	while (size > 1 && count < MAX_TEXTURE_MIPS)
+	{
+		size >>= 1;
+		count++;
+	}
+	return count;
+}
+
+int TextureUploadQueue::GetMipSize(int aSize, int aMip)
+{
+	// Every mip halves the size of the one above it, down to a single texel.
+	return aSize >> aMip > 1 ? aSize >> aMip : 1;
+}
+
+int TextureUploadQueue::GetBlockRows(int aWidth)
+{
+	int rows;
+
+	// As many rows as fit in a block, at least one however wide the mip is.
+	rows = myBlockBytes / (aWidth * 4);
+	return rows > 1 ? rows : 1;
+}
+
+void TextureUploadQueue::BuildRows(Upload& aUpload, int aMip, int aTop, int aBottom)
+{
+	const unsigned char* source;
+	const unsigned char* row0;
+	const unsigned char* row1;
+	unsigned char* destination;
+	int sourceWidth, sourceHeight, width, x, y, x0, x1, channel;
+
+	sourceWidth = GetMipSize(aUpload.width, aMip - 1);
+	sourceHeight = GetMipSize(aUpload.height, aMip - 1);
+	width = GetMipSize(aUpload.width, aMip);
+	source = aUpload.pixels + aUpload.mipOffsets[aMip - 1];
+	destination = aUpload.pixels + aUpload.mipOffsets[aMip] + (size_t)aTop * width * 4;
+
+	// Average each 2x2 block of the mip above. A side of odd length repeats its last texel, and a side already down to one
+	// texel is only halved along the other.
+	for (y = aTop; y < aBottom; y++)
+	{
+		row0 = source + (size_t)(y * 2 < sourceHeight ? y * 2 : sourceHeight - 1) * sourceWidth * 4;
+		row1 = source + (size_t)(y * 2 + 1 < sourceHeight ? y * 2 + 1 : sourceHeight - 1) * sourceWidth * 4;
+		for (x = 0; x < width; x++)
+		{
+			x0 = (x * 2 < sourceWidth ? x * 2 : sourceWidth - 1) * 4;
+			x1 = (x * 2 + 1 < sourceWidth ? x * 2 + 1 : sourceWidth - 1) * 4;
+			for (channel = 0; channel < 4; channel++)
+			{
+				destination[channel] = (unsigned char)((row0[x0 + channel] + row0[x1 + channel] + row1[x0 + channel] + row1[x1 + channel] + 2) >> 2);
+			}
+			destination += 4;
+		}
+	}
+}
+
+int TextureUploadQueue::UploadBlock(Upload& aUpload)
+{
+	int width, height, top, bottom;
+
+	width = GetMipSize(aUpload.width, aUpload.uploadMip);
+	height = GetMipSize(aUpload.height, aUpload.uploadMip);
+	top = aUpload.uploadRow;
+	bottom = top + GetBlockRows(width) < height ? top + GetBlockRows(width) : height;
+
+	// Hand the next rows of the mip to the target.
+	aUpload.target->UploadRows(aUpload.uploadMip, top, bottom, aUpload.pixels + aUpload.mipOffsets[aUpload.uploadMip] + (size_t)top * width * 4,
+		width * 4);
+	aUpload.uploadRow = bottom;
+
+	// A finished mip can be sampled, move on to the next larger one.
+	if (bottom == height)
+	{
+		aUpload.target->SetMostDetailedMip(aUpload.uploadMip);
+		myStats.frameMipCount++;
+		aUpload.uploadMip--;
+		aUpload.uploadRow = 0;
+	}
+
+	return (bottom - top) * width * 4;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+const int MAX_TEXTURE_MIPS = 16;
+
+// Receives the pieces of one texture from the upload queue, the renderer copies them to the GPU.
+// Rows are tightly packed RGBA. A mip is only complete once SetMostDetailedMip names it, until then the texture must not be
+// sampled above the last mip it was told about.
+class TextureUploadTarget
+{
+public:
+	virtual ~TextureUploadTarget() {}
+
+	virtual void UploadRows(int aMip, int aTop, int aBottom, const unsigned char* aPixels, int aRowPitch) = 0;
+	virtual void SetMostDetailedMip(int aMip) = 0;
+};
+
+// Spreads the uploads of textures over frames, so loading a large image does not stall the frame it is loaded in.
+// A submitted image is copied and its mip chain is built on the CPU, a block of rows at a time, then the mips are handed to the
+// target from the smallest up, so a blurry version is on screen at once and sharpens as the larger mips arrive. Only the mips
+// from the first to the end one asked for are uploaded, a texture that kept its smaller mips only needs the larger ones again.
+// Every frame works through the queue until it has spent its time or uploaded its bytes, but always does at least one block.
+class TextureUploadQueue
+{
+public:
+	// The frame counts cover the last call to Update.
+	struct Stats
+	{
+		float frameTime;
+		int frameBytes;
+		int frameBlockCount;
+		int frameMipCount;
+		int pendingCount;
+		long long pendingBytes;
+		int completedCount;
+	};
+
+	TextureUploadQueue();
+	TextureUploadQueue(const TextureUploadQueue& aTextureUploadQueue) = delete;
+	~TextureUploadQueue();
+
+	bool Initialize(int aMaxBytesPerFrame, float aMaxMilliseconds, int aBlockBytes);
+	void Shutdown();
+
+	bool Submit(const unsigned char* aPixels, int aWidth, int aHeight, int aFirstMip, int aEndMip, TextureUploadTarget& aTarget);
+	void Cancel(TextureUploadTarget& aTarget);
+	void Update();
+
+	bool IsPending(TextureUploadTarget& aTarget);
+	void GetStats(Stats& aStats);
+
+	static int GetMipCount(int aWidth, int aHeight);
+	static int GetMipSize(int aSize, int aMip);
+
+private:
+	struct Upload
+	{
+		TextureUploadTarget* target;
+		unsigned char* pixels;
+		size_t mipOffsets[MAX_TEXTURE_MIPS];
+		int width;
+		int height;
+		int firstMip;
+		int mipCount;
+		int buildMip;
+		int buildRow;
+		int uploadMip;
+		int uploadRow;
+	};
+
+	int GetBlockRows(int aWidth);
+	void BuildRows(Upload& aUpload, int aMip, int aTop, int aBottom);
+	int UploadBlock(Upload& aUpload);
+
+	std::vector<Upload> myUploads;
+	int myMaxBytesPerFrame;
+	float myMaxMilliseconds;
+	int myBlockBytes;
+	Stats myStats;
+};
@@ -0,0 +1,301 @@
+#include "Tilemap.h"
+#include <math.h>
+#include <string.h>
+
+Tilemap::Tilemap()
+{
+	myTiles = nullptr;
+	myDirtyChunks = nullptr;
+	myAtlasUVs = nullptr;
+	myWidth = 0;
+	myHeight = 0;
+	myChunkCountX = 0;
+	myChunkCountY = 0;
+	myAtlasCellCount = 0;
+	myRevision = 0;
+	myTileSize = 1.0f;
+	myOriginX = 0.0f;
+	myOriginY = 0.0f;
+}
+
+Tilemap::~Tilemap()
+{
+}
+
+bool Tilemap::Initialize(int aWidth, int aHeight, float aTileSize, float aOriginX, float aOriginY, int aAtlasColumns, int aAtlasRows)
+{
+	int i, count;
+
+	if (aWidth <= 0 || aHeight <= 0 || aTileSize <= 0.0f || aAtlasColumns <= 0 || aAtlasRows <= 0)
+	{
+		return false;
+	}
+
+	myWidth = aWidth;
+	myHeight = aHeight;
+	myTileSize = aTileSize;
+	myOriginX = aOriginX;
+	myOriginY = aOriginY;
+
+	// Partial chunks at the right and top edges still count as chunks.
+	myChunkCountX = (myWidth + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE;
+	myChunkCountY = (myHeight + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE;
+
+	// Create the tile array, every tile starts out empty.
+	count = myWidth * myHeight;
+	myTiles = new unsigned short[count];
+	for (i = 0; i < count; i++)
+	{
+		myTiles[i] = 0;
+	}
+
+	// Create the dirty flags, every chunk needs its first build.
+	count = myChunkCountX * myChunkCountY;
+	myDirtyChunks = new bool[count];
+	for (i = 0; i < count; i++)
+	{
+		myDirtyChunks[i] = true;
+	}
+
+	// Precompute the texture rectangle of every atlas cell.
+	myAtlasCellCount = aAtlasColumns * aAtlasRows;
+	myAtlasUVs = new TileUV[myAtlasCellCount];
+	for (i = 0; i < myAtlasCellCount; i++)
+	{
+		myAtlasUVs[i].left = PackUNorm16((float)(i % aAtlasColumns) / (float)aAtlasColumns);
+		myAtlasUVs[i].top = PackUNorm16((float)(i / aAtlasColumns) / (float)aAtlasRows);
+		myAtlasUVs[i].right = PackUNorm16((float)(i % aAtlasColumns + 1) / (float)aAtlasColumns);
+		myAtlasUVs[i].bottom = PackUNorm16((float)(i / aAtlasColumns + 1) / (float)aAtlasRows);
+	}
+
+	return true;
+}
+
+void Tilemap::Shutdown()
+{
+	// Release the arrays.
+	delete[] myTiles;
+	myTiles = nullptr;
+	delete[] myDirtyChunks;
+	myDirtyChunks = nullptr;
+	delete[] myAtlasUVs;
+	myAtlasUVs = nullptr;
+
+	myWidth = 0;
+	myHeight = 0;
+	myChunkCountX = 0;
+	myChunkCountY = 0;
+}
+
+void Tilemap::SetTile(int aX, int aY, unsigned short aTile)
+{
+	unsigned short* tile;
+
+	if (aX < 0 || aY < 0 || aX >= myWidth || aY >= myHeight)
+	{
+		return;
+	}
+
+	// Only a real change makes the chunk dirty.
+	tile = &myTiles[aY * myWidth + aX];
+	if (*tile != aTile)
+	{
+		*tile = aTile;
+		myDirtyChunks[(aY / TILEMAP_CHUNK_SIZE) * myChunkCountX + aX / TILEMAP_CHUNK_SIZE] = true;
+		myRevision++;
+	}
+}
+
+void Tilemap::SetTiles(const unsigned short* aTiles)
+{
+	int i;
+
+	// Replace every tile with one copy, as a level load does, and have every chunk built again.
+	memcpy(myTiles, aTiles, sizeof(unsigned short) * myWidth * myHeight);
+	for (i = 0; i < myChunkCountX * myChunkCountY; i++)
+	{
+		myDirtyChunks[i] = true;
+	}
+	myRevision++;
+}
+
+unsigned short Tilemap::GetTile(int aX, int aY)
+{
+	if (aX < 0 || aY < 0 || aX >= myWidth || aY >= myHeight)
+	{
+		return 0;
+	}
+	return myTiles[aY * myWidth + aX];
+}
+
+int Tilemap::GetWidth()
+{
+	return myWidth;
+}
+
+int Tilemap::GetHeight()
+{
+	return myHeight;
+}
+
+int Tilemap::GetChunkCountX()
+{
+	return myChunkCountX;
+}
+
+int Tilemap::GetChunkCountY()
+{
+	return myChunkCountY;
+}
+
+int Tilemap::GetChunkCount()
+{
+	return myChunkCountX * myChunkCountY;
+}
+
+unsigned int Tilemap::GetRevision()
+{
+	return myRevision;
+}
+
+bool Tilemap::IsChunkDirty(int aChunk)
+{
+	return myDirtyChunks[aChunk];
+}
+
+void Tilemap::ClearChunkDirty(int aChunk)
+{
+	myDirtyChunks[aChunk] = false;
+}
+
+void Tilemap::SetTileRect(int aX, int aY, int aWidth, int aHeight, const unsigned short* aTiles, int aPitch)
+{
+	int y;
+
+	if (aX < 0 || aY < 0 || aWidth <= 0 || aHeight <= 0 || aX + aWidth > myWidth || aY + aHeight > myHeight)
+	{
+		return;
+	}
+
+	// Copy the block a row at a time, rows of the source are aPitch tiles apart.
+	for (y = 0; y < aHeight; y++)
+	{
+		memcpy(&myTiles[(aY + y) * myWidth + aX], &aTiles[y * aPitch], sizeof(unsigned short) * aWidth);
+	}
+	MarkRectDirty(aX, aY, aWidth, aHeight);
+}
+
+void Tilemap::ClearTileRect(int aX, int aY, int aWidth, int aHeight)
+{
+	int y;
+
+	if (aX < 0 || aY < 0 || aWidth <= 0 || aHeight <= 0 || aX + aWidth > myWidth || aY + aHeight > myHeight)
+	{
+		return;
+	}
+
+	// Empty the block, its chunks are built again with nothing in them.
+	for (y = 0; y < aHeight; y++)
+	{
+		memset(&myTiles[(aY + y) * myWidth + aX], 0, sizeof(unsigned short) * aWidth);
+	}
+	MarkRectDirty(aX, aY, aWidth, aHeight);
+}
+
+void Tilemap::GetChunksInRect(float aLeft, float aBottom, float aRight, float aTop, int& aMinX, int& aMinY, int& aMaxX, int& aMaxY)
+{
+	float chunkSize;
+
+	// Convert the rectangle to chunk coordinates, the range is inclusive and empty when min is above max.
+	chunkSize = myTileSize * (float)TILEMAP_CHUNK_SIZE;
+	aMinX = (int)floorf((aLeft - myOriginX) / chunkSize);
+	aMinY = (int)floorf((aBottom - myOriginY) / chunkSize);
+	aMaxX = (int)floorf((aRight - myOriginX) / chunkSize);
+	aMaxY = (int)floorf((aTop - myOriginY) / chunkSize);
+
+	// Clamp to the chunks that exist.
+	aMinX = aMinX < 0 ? 0 : aMinX;
+	aMinY = aMinY < 0 ? 0 : aMinY;
+	aMaxX = aMaxX >= myChunkCountX ? myChunkCountX - 1 : aMaxX;
+	aMaxY = aMaxY >= myChunkCountY ? myChunkCountY - 1 : aMaxY;
+}
+
+int Tilemap::BuildChunkMesh(int aChunk, SpriteVertex* aVertices)
+{
+	int startX, startY, endX, endY, x, y, cell;
+	unsigned int quads;
+	unsigned short tile;
+	const unsigned short* row;
+	const TileUV* uv;
+	float left, right, bottom, top;
+
+	// Find the tiles covered by the chunk.
+	startX = (aChunk % myChunkCountX) * TILEMAP_CHUNK_SIZE;
+	startY = (aChunk / myChunkCountX) * TILEMAP_CHUNK_SIZE;
+	endX = startX + TILEMAP_CHUNK_SIZE < myWidth ? startX + TILEMAP_CHUNK_SIZE : myWidth;
+	endY = startY + TILEMAP_CHUNK_SIZE < myHeight ? startY + TILEMAP_CHUNK_SIZE : myHeight;
+
+	quads = 0;
+	for (y = startY; y < endY; y++)
+	{
+		row = myTiles + y * myWidth;
+		bottom = myOriginY + (float)y * myTileSize;
+		top = bottom + myTileSize;
+
+		for (x = startX; x < endX; x++)
+		{
+			// Empty tiles get no geometry.
+			tile = row[x];
+			if (tile == 0)
+			{
+				continue;
+			}
+
+			cell = (tile - 1) % myAtlasCellCount;
+			uv = &myAtlasUVs[cell];
+			left = myOriginX + (float)x * myTileSize;
+			right = left + myTileSize;
+
+			// Bottom left, top left, bottom right, top right, the same order as the sprite batch.
+			aVertices[0].x = left;
+			aVertices[0].y = bottom;
+			aVertices[0].u = uv->left;
+			aVertices[0].v = uv->bottom;
+
+			aVertices[1].x = left;
+			aVertices[1].y = top;
+			aVertices[1].u = uv->left;
+			aVertices[1].v = uv->top;
+
+			aVertices[2].x = right;
+			aVertices[2].y = bottom;
+			aVertices[2].u = uv->right;
+			aVertices[2].v = uv->bottom;
+
+			aVertices[3].x = right;
+			aVertices[3].y = top;
+			aVertices[3].u = uv->right;
+			aVertices[3].v = uv->top;
+
+			aVertices += 4;
+			quads++;
+		}
+	}
+
+	return (int)quads;
+}
+
+void Tilemap::MarkRectDirty(int aX, int aY, int aWidth, int aHeight)
+{
+	int x, y;
+
+	// Every chunk the block touches is built again.
+	for (y = aY / TILEMAP_CHUNK_SIZE; y <= (aY + aHeight - 1) / TILEMAP_CHUNK_SIZE; y++)
+	{
+		for (x = aX / TILEMAP_CHUNK_SIZE; x <= (aX + aWidth - 1) / TILEMAP_CHUNK_SIZE; x++)
+		{
+			myDirtyChunks[y * myChunkCountX + x] = true;
+		}
+	}
+	myRevision++;
+}
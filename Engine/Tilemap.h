@@ -0,0 +1,62 @@
+#pragma once
+
+#include "SpriteVertex.h"
+
+const int TILEMAP_CHUNK_SIZE = 32;
+
+// Grid of tiles drawn from an atlas, split into square chunks of TILEMAP_CHUNK_SIZE tiles.
+// Tile 0 is empty, any other tile n uses cell n - 1 of the atlas, counted left to right, top to bottom.
+// Changing a tile marks its chunk dirty so only that chunk's mesh has to be built again.
+// Chunk meshes are quads for the shared quad index buffer, the depth of the map is up to the world matrix it is drawn with.
+class Tilemap
+{
+public:
+	Tilemap();
+	Tilemap(const Tilemap& aTilemap) = delete;
+	~Tilemap();
+
+	bool Initialize(int aWidth, int aHeight, float aTileSize, float aOriginX, float aOriginY, int aAtlasColumns, int aAtlasRows);
+	void Shutdown();
+
+	void SetTile(int aX, int aY, unsigned short aTile);
+	void SetTiles(const unsigned short* aTiles);
+	void SetTileRect(int aX, int aY, int aWidth, int aHeight, const unsigned short* aTiles, int aPitch);
+	void ClearTileRect(int aX, int aY, int aWidth, int aHeight);
+	unsigned short GetTile(int aX, int aY);
+
+	int GetWidth();
+	int GetHeight();
+	int GetChunkCountX();
+	int GetChunkCountY();
+	int GetChunkCount();
+	unsigned int GetRevision();
+	bool IsChunkDirty(int aChunk);
+	void ClearChunkDirty(int aChunk);
+
+	void GetChunksInRect(float aLeft, float aBottom, float aRight, float aTop, int& aMinX, int& aMinY, int& aMaxX, int& aMaxY);
+	int BuildChunkMesh(int aChunk, SpriteVertex* aVertices);
+
+private:
+	void MarkRectDirty(int aX, int aY, int aWidth, int aHeight);
+
+	struct TileUV
+	{
+		unsigned short left;
+		unsigned short top;
+		unsigned short right;
+		unsigned short bottom;
+	};
+
+	unsigned short* myTiles;
+	bool* myDirtyChunks;
+	TileUV* myAtlasUVs;
+	int myWidth;
+	int myHeight;
+	int myChunkCountX;
+	int myChunkCountY;
+	int myAtlasCellCount;
+	unsigned int myRevision;
+	float myTileSize;
+	float myOriginX;
+	float myOriginY;
+};
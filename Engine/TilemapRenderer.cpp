@@ -0,0 +1,280 @@
+#include "TilemapRenderer.h"
+#include "AllocationTracker.h"
+
+TilemapRenderer::TilemapRenderer()
+{
+	myDevice = nullptr;
+	myTilemap = nullptr;
+	myQuadIndexBuffer = nullptr;
+	mySlots = nullptr;
+	myScratchVertices = nullptr;
+	myMaxResidentChunks = 0;
+	myMaxBuildsPerFrame = 0;
+	myFrame = 0;
+	myDrawnChunkCount = 0;
+	myBuiltChunkCount = 0;
+	myPendingChunkCount = 0;
+}
+
+TilemapRenderer::~TilemapRenderer()
+{
+}
+
+bool TilemapRenderer::Initialize(ID3D11Device& aDevice, Tilemap& aTilemap, QuadIndexBuffer& aQuadIndexBuffer, int aMaxResidentChunks, int aMaxBuildsPerFrame)
+{
+	int i;
+
+	if (aMaxResidentChunks <= 0 || aMaxBuildsPerFrame <= 0)
+	{
+		return false;
+	}
+
+	myDevice = &aDevice;
+	myTilemap = &aTilemap;
+	myQuadIndexBuffer = &aQuadIndexBuffer;
+	myMaxResidentChunks = aMaxResidentChunks;
+	myMaxBuildsPerFrame = aMaxBuildsPerFrame;
+
+	// Create the slots that hold chunk buffers, all of them empty.
+	mySlots = new ChunkBuffers[myMaxResidentChunks];
+	for (i = 0; i < myMaxResidentChunks; i++)
+	{
+		mySlots[i].vertexBuffer = nullptr;
+		mySlots[i].indexCount = 0;
+		mySlots[i].chunk = -1;
+		mySlots[i].lastVisibleFrame = 0;
+	}
+
+	// No chunk has buffers yet.
+	myChunkSlots.assign(myTilemap->GetChunkCount(), -1);
+
+	// Create the array chunk meshes are built into before they are copied to the GPU.
+	myScratchVertices = new SpriteVertex[TILEMAP_CHUNK_SIZE * TILEMAP_CHUNK_SIZE * 4];
+
+	myFrame = 0;
+	return true;
+}
+
+void TilemapRenderer::Shutdown()
+{
+	int i;
+
+	// Release the chunk buffers.
+	if (mySlots != nullptr)
+	{
+		for (i = 0; i < myMaxResidentChunks; i++)
+		{
+			ReleaseSlot(mySlots[i]);
+		}
+		delete[] mySlots;
+		mySlots = nullptr;
+	}
+	myChunkSlots.clear();
+
+	// Release the scratch array.
+	delete[] myScratchVertices;
+	myScratchVertices = nullptr;
+
+	myDevice = nullptr;
+	myTilemap = nullptr;
+	myQuadIndexBuffer = nullptr;
+}
+
+bool TilemapRenderer::Render(ID3D11DeviceContext& aDeviceContext, Shader& aShader, XMMATRIX& aWorldMatrix, XMMATRIX& aViewMatrix,
+	XMMATRIX& aProjectionMatrix, ID3D11ShaderResourceView& aAtlas, float aLeft, float aBottom, float aRight, float aTop)
+{
+	int minX, minY, maxX, maxY, x, y, chunk, slot;
+	unsigned int stride, offset;
+	bool result;
+
+	ALLOCATION_SCOPE("Tilemap");
+
+	myFrame++;
+	myDrawnChunkCount = 0;
+	myBuiltChunkCount = 0;
+	myPendingChunkCount = 0;
+
+	// Find the chunks that overlap the view.
+	myTilemap->GetChunksInRect(aLeft, aBottom, aRight, aTop, minX, minY, maxX, maxY);
+	if (minX > maxX || minY > maxY)
+	{
+		return true;
+	}
+
+	// All chunks share the shader parameters, so set them once.
+	result = aShader.SetParameters(aDeviceContext, aWorldMatrix, aViewMatrix, aProjectionMatrix, aAtlas);
+	if (!result)
+	{
+		return false;
+	}
+
+	stride = sizeof(SpriteVertex);
+	offset = 0;
+	aDeviceContext.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	myQuadIndexBuffer->Render(aDeviceContext);
+
+	for (y = minY; y <= maxY; y++)
+	{
+		for (x = minX; x <= maxX; x++)
+		{
+			chunk = y * myTilemap->GetChunkCountX() + x;
+
+			// Give the chunk buffers if it has none yet, unless no more chunks can be built this frame.
+			// A chunk that gets no slot because every slot is visible counts as pending, so it shows up in the stats and is retried.
+			slot = myChunkSlots[chunk];
+			if (slot < 0)
+			{
+				if (myBuiltChunkCount >= myMaxBuildsPerFrame)
+				{
+					myPendingChunkCount++;
+					continue;
+				}
+				slot = AcquireSlot(chunk);
+				if (slot < 0)
+				{
+					myPendingChunkCount++;
+					continue;
+				}
+			}
+			mySlots[slot].lastVisibleFrame = myFrame;
+
+			// Build the chunk if it is new or its tiles changed since the last build. Over the budget a changed chunk shows its old tiles.
+			if (mySlots[slot].chunk == chunk && myTilemap->IsChunkDirty(chunk) && myBuiltChunkCount >= myMaxBuildsPerFrame)
+			{
+				myPendingChunkCount++;
+			}
+			else if (mySlots[slot].chunk != chunk || myTilemap->IsChunkDirty(chunk))
+			{
+				mySlots[slot].chunk = chunk;
+				result = BuildChunk(mySlots[slot]);
+				if (!result)
+				{
+					return false;
+				}
+			}
+
+			// Chunks without tiles have nothing to draw.
+			if (mySlots[slot].indexCount == 0)
+			{
+				continue;
+			}
+
+			aDeviceContext.IASetVertexBuffers(0, 1, &mySlots[slot].vertexBuffer, &stride, &offset);
+			aShader.Draw(aDeviceContext, mySlots[slot].indexCount);
+			myDrawnChunkCount++;
+		}
+	}
+
+	return true;
+}
+
+int TilemapRenderer::GetDrawnChunkCount()
+{
+	return myDrawnChunkCount;
+}
+
+int TilemapRenderer::GetBuiltChunkCount()
+{
+	return myBuiltChunkCount;
+}
+
+int TilemapRenderer::GetPendingChunkCount()
+{
+	return myPendingChunkCount;
+}
+
+int TilemapRenderer::AcquireSlot(int aChunk)
+{
+	int i, best;
+
+	// Take an unused slot, or else the one whose chunk has been out of view the longest.
+	best = -1;
+	for (i = 0; i < myMaxResidentChunks; i++)
+	{
+		if (mySlots[i].chunk < 0)
+		{
+			best = i;
+			break;
+		}
+		if (mySlots[i].lastVisibleFrame != myFrame && (best < 0 || mySlots[i].lastVisibleFrame < mySlots[best].lastVisibleFrame))
+		{
+			best = i;
+		}
+	}
+
+	// Every slot holds a chunk that is visible this frame.
+	if (best < 0)
+	{
+		return -1;
+	}
+
+	// Evict the old chunk.
+	if (mySlots[best].chunk >= 0)
+	{
+		myChunkSlots[mySlots[best].chunk] = -1;
+		ReleaseSlot(mySlots[best]);
+	}
+
+	myChunkSlots[aChunk] = best;
+	return best;
+}
+
+bool TilemapRenderer::BuildChunk(ChunkBuffers& aSlot)
+{
+	D3D11_BUFFER_DESC vertexBufferDesc;
+	D3D11_SUBRESOURCE_DATA vertexData;
+	HRESULT result;
+	int quads;
+
+	// Immutable buffers can not be updated, so drop the old one.
+	if (aSlot.vertexBuffer != nullptr)
+	{
+		aSlot.vertexBuffer->Release();
+		aSlot.vertexBuffer = nullptr;
+	}
+
+	// Build the mesh of the chunk on the CPU.
+	quads = myTilemap->BuildChunkMesh(aSlot.chunk, myScratchVertices);
+	myTilemap->ClearChunkDirty(aSlot.chunk);
+	aSlot.indexCount = quads * 6;
+	myBuiltChunkCount++;
+
+	if (quads == 0)
+	{
+		return true;
+	}
+
+	// Set up the description of the immutable vertex buffer.
+	vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+	vertexBufferDesc.ByteWidth = sizeof(SpriteVertex) * quads * 4;
+	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	vertexBufferDesc.CPUAccessFlags = 0;
+	vertexBufferDesc.MiscFlags = 0;
+	vertexBufferDesc.StructureByteStride = 0;
+
+	// Give the subresource structure a pointer to the vertex data.
+	vertexData.pSysMem = myScratchVertices;
+	vertexData.SysMemPitch = 0;
+	vertexData.SysMemSlicePitch = 0;
+
+	// Now create the vertex buffer.
+	result = myDevice->CreateBuffer(&vertexBufferDesc, &vertexData, &aSlot.vertexBuffer);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void TilemapRenderer::ReleaseSlot(ChunkBuffers& aSlot)
+{
+	// Release the vertex buffer.
+	if (aSlot.vertexBuffer != nullptr)
+	{
+		aSlot.vertexBuffer->Release();
+		aSlot.vertexBuffer = nullptr;
+	}
+	aSlot.indexCount = 0;
+	aSlot.chunk = -1;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <d3d11.h>
+#include <directxmath.h>
+#include <vector>
+#include "Shader.h"
+#include "Tilemap.h"
+#include "QuadIndexBuffer.h"
+
+using namespace DirectX;
+
+// Draws the chunks of a tilemap that overlap the view, one draw per chunk from immutable per chunk vertex buffers
+// indexed by the shared quad index buffer.
+// Chunk buffers are built the first time a chunk is seen and again only when its tiles change.
+// At most a fixed number of chunks keep buffers, the ones out of view the longest are released first.
+// At most a fixed number of chunks are built per frame. A changed chunk over the budget keeps drawing its old buffer and a new
+// one is left out, both are counted as pending and built in a later frame.
+class TilemapRenderer
+{
+public:
+	TilemapRenderer();
+	TilemapRenderer(const TilemapRenderer& aTilemapRenderer) = delete;
+	~TilemapRenderer();
+
+	bool Initialize(ID3D11Device& aDevice, Tilemap& aTilemap, QuadIndexBuffer& aQuadIndexBuffer, int aMaxResidentChunks, int aMaxBuildsPerFrame);
+	void Shutdown();
+
+	bool Render(ID3D11DeviceContext& aDeviceContext, Shader& aShader, XMMATRIX& aWorldMatrix, XMMATRIX& aViewMatrix,
+		XMMATRIX& aProjectionMatrix, ID3D11ShaderResourceView& aAtlas, float aLeft, float aBottom, float aRight, float aTop);
+
+	int GetDrawnChunkCount();
+	int GetBuiltChunkCount();
+	int GetPendingChunkCount();
+
+private:
+	struct ChunkBuffers
+	{
+		ID3D11Buffer* vertexBuffer;
+		int indexCount;
+		int chunk;
+		unsigned int lastVisibleFrame;
+	};
+
+	int AcquireSlot(int aChunk);
+	bool BuildChunk(ChunkBuffers& aSlot);
+	void ReleaseSlot(ChunkBuffers& aSlot);
+
+	ID3D11Device* myDevice;
+	Tilemap* myTilemap;
+	QuadIndexBuffer* myQuadIndexBuffer;
+	ChunkBuffers* mySlots;
+	std::vector<int> myChunkSlots;
+	SpriteVertex* myScratchVertices;
+	int myMaxResidentChunks;
+	int myMaxBuildsPerFrame;
+	unsigned int myFrame;
+	int myDrawnChunkCount;
+	int myBuiltChunkCount;
+	int myPendingChunkCount;
+};
@@ -0,0 +1,60 @@
+#include "Timer.h"
+
+Timer::Timer()
+{
+	myFrequency = 0;
+	myStartTime = 0;
+	myFrameTime = 0.0f;
+}
+
+Timer::~Timer()
+{
+}
+
+bool Timer::Initialize()
+{
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER startTime;
+
+	// Check to see if this system supports high performance timers.
+	QueryPerformanceFrequency(&frequency);
+	if (frequency.QuadPart == 0)
+	{
+		return false;
+	}
+	myFrequency = frequency.QuadPart;
+
+	// Get the time the first frame starts from.
+	QueryPerformanceCounter(&startTime);
+	myStartTime = startTime.QuadPart;
+
+	return true;
+}
+
+void Timer::Frame()
+{
+	LARGE_INTEGER currentTime;
+
+	// Query the current time.
+	QueryPerformanceCounter(&currentTime);
+
+	// Calculate the seconds elapsed since the last frame.
+	myFrameTime = (float)(currentTime.QuadPart - myStartTime) / (float)myFrequency;
+
+	// Restart the timer.
+	myStartTime = currentTime.QuadPart;
+}
+
+float Timer::GetTime()
+{
+	return myFrameTime;
+}
+
+float Timer::GetTimeSinceFrame()
+{
+	LARGE_INTEGER currentTime;
+
+	// Calculate the seconds elapsed since the last frame without restarting the timer.
+	QueryPerformanceCounter(&currentTime);
+	return (float)(currentTime.QuadPart - myStartTime) / (float)myFrequency;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#define WIN32_LEAN_AND_MEAN
+
+#include <windows.h>
+
+class Timer
+{
+public:
+	Timer();
+	Timer(const Timer& aTimer) = delete;
+	~Timer();
+
+	bool Initialize();
+	void Frame();
+
+	float GetTime();
+	float GetTimeSinceFrame();
+
+private:
+	LONGLONG myFrequency;
+	LONGLONG myStartTime;
+	float myFrameTime;
+};
@@ -0,0 +1,178 @@
+#include "UploadRing.h"
+
+UploadRing::UploadRing()
+{
+	int i;
+
+	myBuffer = nullptr;
+	for (i = 0; i < UPLOAD_FENCE_COUNT; i++)
+	{
+		myQueries[i] = nullptr;
+		myFences[i] = 0;
+	}
+	myFirstQuery = 0;
+	myPendingCount = 0;
+	myCompletedFence = 0;
+	myMapped = false;
+}
+
+UploadRing::~UploadRing()
+{
+}
+
+bool UploadRing::Initialize(ID3D11Device& aDevice, size_t aCapacity)
+{
+	D3D11_BUFFER_DESC bufferDesc;
+	D3D11_QUERY_DESC queryDesc;
+	HRESULT result;
+	int i;
+
+	// Track as many frames in flight as there are queries to fence them.
+	if (!myAllocator.Initialize(aCapacity, UPLOAD_FENCE_COUNT))
+	{
+		return false;
+	}
+
+	// Set up the description of the dynamic buffer, its ranges are read as vertices or indices.
+	bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	bufferDesc.ByteWidth = (unsigned int)aCapacity;
+	bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER | D3D11_BIND_INDEX_BUFFER;
+	bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	bufferDesc.MiscFlags = 0;
+	bufferDesc.StructureByteStride = 0;
+
+	// Create the buffer, it is filled a range at a time.
+	result = aDevice.CreateBuffer(&bufferDesc, nullptr, &myBuffer);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	// Create the queries that mark the end of each frame.
+	queryDesc.Query = D3D11_QUERY_EVENT;
+	queryDesc.MiscFlags = 0;
+	for (i = 0; i < UPLOAD_FENCE_COUNT; i++)
+	{
+		result = aDevice.CreateQuery(&queryDesc, &myQueries[i]);
+		if (FAILED(result))
+		{
+			return false;
+		}
+	}
+	myFirstQuery = 0;
+	myPendingCount = 0;
+	myCompletedFence = 0;
+	myMapped = false;
+
+	return true;
+}
+
+void UploadRing::Shutdown()
+{
+	int i;
+
+	// Release the queries.
+	for (i = 0; i < UPLOAD_FENCE_COUNT; i++)
+	{
+		if (myQueries[i] != nullptr)
+		{
+			myQueries[i]->Release();
+			myQueries[i] = nullptr;
+		}
+	}
+	myPendingCount = 0;
+
+	// Release the buffer.
+	if (myBuffer != nullptr)
+	{
+		myBuffer->Release();
+		myBuffer = nullptr;
+	}
+
+	myAllocator.Shutdown();
+}
+
+void UploadRing::BeginFrame(ID3D11DeviceContext& aDeviceContext)
+{
+	HRESULT result;
+
+	// Look at the oldest queries without flushing, every one the GPU has passed frees the ranges of its frame and those before.
+	while (myPendingCount > 0)
+	{
+		result = aDeviceContext.GetData(myQueries[myFirstQuery], nullptr, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH);
+		if (result != S_OK)
+		{
+			break;
+		}
+		myCompletedFence = myFences[myFirstQuery];
+		myFirstQuery = (myFirstQuery + 1) % UPLOAD_FENCE_COUNT;
+		myPendingCount--;
+	}
+
+	myAllocator.BeginFrame(myCompletedFence);
+}
+
+void UploadRing::EndFrame(ID3D11DeviceContext& aDeviceContext)
+{
+	unsigned long long fence;
+	int index;
+
+	// Fence the frame behind its draws. When every query is still pending the frame goes without one, its ranges are then
+	// freed along with the next frame that gets a query.
+	fence = myAllocator.EndFrame();
+	if (myPendingCount < UPLOAD_FENCE_COUNT)
+	{
+		index = (myFirstQuery + myPendingCount) % UPLOAD_FENCE_COUNT;
+		aDeviceContext.End(myQueries[index]);
+		myFences[index] = fence;
+		myPendingCount++;
+	}
+}
+
+void* UploadRing::Map(ID3D11DeviceContext& aDeviceContext, size_t aSize, size_t aAlignment, unsigned int& aOffset)
+{
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	HRESULT result;
+	size_t offset;
+	bool discard;
+
+	if (myMapped || !myAllocator.Allocate(aSize, aAlignment, offset, discard))
+	{
+		return nullptr;
+	}
+
+	// Append to the buffer without touching what earlier draws read, or start a fresh one when the ring is full.
+	result = aDeviceContext.Map(myBuffer, 0, discard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mappedResource);
+	if (FAILED(result))
+	{
+		myAllocator.Trim(0);
+		return nullptr;
+	}
+	myMapped = true;
+
+	aOffset = (unsigned int)offset;
+	return (unsigned char*)mappedResource.pData + offset;
+}
+
+void UploadRing::Unmap(ID3D11DeviceContext& aDeviceContext, size_t aUsedSize)
+{
+	if (!myMapped)
+	{
+		return;
+	}
+
+	// Hand back what the caller did not write and unlock the buffer.
+	myAllocator.Trim(aUsedSize);
+	aDeviceContext.Unmap(myBuffer, 0);
+	myMapped = false;
+}
+
+ID3D11Buffer* UploadRing::GetBuffer()
+{
+	return myBuffer;
+}
+
+void UploadRing::GetStats(RingAllocator::Stats& aStats)
+{
+	myAllocator.GetStats(aStats);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <d3d11.h>
+#include "RingAllocator.h"
+
+const int UPLOAD_FENCE_COUNT = 4;
+
+// One large dynamic buffer the transient geometry of every frame is written to, shared by all batches.
+// Ranges are handed out by a ring allocator and mapped without overwriting, so writing one batch never waits for the GPU to
+// finish drawing another. The buffer is only mapped with a discard when the ring runs into a frame still in flight.
+// Event queries stand in for fences: the end of every frame is marked by one, and the queries are read oldest first without
+// waiting to learn which frames the GPU has finished.
+class UploadRing
+{
+public:
+	UploadRing();
+	UploadRing(const UploadRing& aUploadRing) = delete;
+	~UploadRing();
+
+	bool Initialize(ID3D11Device& aDevice, size_t aCapacity);
+	void Shutdown();
+
+	void BeginFrame(ID3D11DeviceContext& aDeviceContext);
+	void EndFrame(ID3D11DeviceContext& aDeviceContext);
+
+	void* Map(ID3D11DeviceContext& aDeviceContext, size_t aSize, size_t aAlignment, unsigned int& aOffset);
+	void Unmap(ID3D11DeviceContext& aDeviceContext, size_t aUsedSize);
+
+	ID3D11Buffer* GetBuffer();
+	void GetStats(RingAllocator::Stats& aStats);
+
+private:
+	RingAllocator myAllocator;
+	ID3D11Buffer* myBuffer;
+	ID3D11Query* myQueries[UPLOAD_FENCE_COUNT];
+	unsigned long long myFences[UPLOAD_FENCE_COUNT];
+	int myFirstQuery;
+	int myPendingCount;
+	unsigned long long myCompletedFence;
+	bool myMapped;
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <d3d11.h>
+#include "VertexLayout.h"
+
+constexpr DXGI_FORMAT GetVertexElementFormat(VertexElementType aType)
+{
+	switch (aType)
+	{
+	case VertexElementType::Float2:
+		return DXGI_FORMAT_R32G32_FLOAT;
+	case VertexElementType::Float3:
+		return DXGI_FORMAT_R32G32B32_FLOAT;
+	case VertexElementType::Float4:
+		return DXGI_FORMAT_R32G32B32A32_FLOAT;
+	case VertexElementType::Half2:
+		return DXGI_FORMAT_R16G16_FLOAT;
+	case VertexElementType::Half4:
+		return DXGI_FORMAT_R16G16B16A16_FLOAT;
+	case VertexElementType::UNorm16x2:
+		return DXGI_FORMAT_R16G16_UNORM;
+	case VertexElementType::SNorm16x2:
+		return DXGI_FORMAT_R16G16_SNORM;
+	case VertexElementType::SNorm16x4:
+		return DXGI_FORMAT_R16G16B16A16_SNORM;
+	case VertexElementType::UNorm8x4:
+		return DXGI_FORMAT_R8G8B8A8_UNORM;
+	case VertexElementType::UInt16x2:
+		return DXGI_FORMAT_R16G16_UINT;
+	}
+	return DXGI_FORMAT_UNKNOWN;
+}
+
+// Input layout of a vertex struct generated from its VertexTraits, so the layout handed to the device can not
+// drift from the struct the CPU writes.
+template<typename V>
+class VertexFormat
+{
+public:
+	static const int ELEMENT_COUNT = VertexTraits<V>::ELEMENT_COUNT;
+
+	static void GetInputElements(D3D11_INPUT_ELEMENT_DESC* aElements)
+	{
+		VertexElement element;
+		int i;
+
+		for (i = 0; i < ELEMENT_COUNT; i++)
+		{
+			element = VertexTraits<V>::GetElement(i);
+			aElements[i].SemanticName = element.semantic;
+			aElements[i].SemanticIndex = 0;
+			aElements[i].Format = GetVertexElementFormat(element.type);
+			aElements[i].InputSlot = 0;
+			aElements[i].AlignedByteOffset = element.offset;
+			aElements[i].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+			aElements[i].InstanceDataStepRate = 0;
+		}
+	}
+};
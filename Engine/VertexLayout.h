@@ -0,0 +1,138 @@
+#pragma once
+
+#include <string.h>
+
+// Storage formats a vertex element can be packed in. Every one of them but the integer one reaches the shader as floats,
+// so a vertex struct can shrink its elements without touching the shader code. Indices that must stay exact, like the slice
+// of a texture array, use the integer one.
+enum class VertexElementType
+{
+	Float2,
+	Float3,
+	Float4,
+	Half2,
+	Half4,
+	UNorm16x2,
+	SNorm16x2,
+	SNorm16x4,
+	UNorm8x4,
+	UInt16x2
+};
+
+struct VertexElement
+{
+	const char* semantic;
+	VertexElementType type;
+	unsigned int offset;
+};
+
+// Describes the elements of a vertex struct. Each vertex struct specializes it with ELEMENT_COUNT and a
+// constexpr GetElement(index), and the graphics side turns that into its input layout.
+template<typename V>
+struct VertexTraits;
+
+constexpr unsigned int GetVertexElementSize(VertexElementType aType)
+{
+	switch (aType)
+	{
+	case VertexElementType::Float2:
+		return 8;
+	case VertexElementType::Float3:
+		return 12;
+	case VertexElementType::Float4:
+		return 16;
+	case VertexElementType::Half2:
+		return 4;
+	case VertexElementType::Half4:
+		return 8;
+	case VertexElementType::UNorm16x2:
+		return 4;
+	case VertexElementType::SNorm16x2:
+		return 4;
+	case VertexElementType::SNorm16x4:
+		return 8;
+	case VertexElementType::UNorm8x4:
+		return 4;
+	case VertexElementType::UInt16x2:
+		return 4;
+	}
+	return 0;
+}
+
+// Bytes covered by the elements of a vertex, meant for a static_assert against sizeof so a description that
+// has fallen out of step with its struct fails to compile instead of rendering garbage.
+template<typename V>
+constexpr unsigned int GetVertexLayoutSize()
+{
+	unsigned int size = 0;
+
+	for (int i = 0; i < VertexTraits<V>::ELEMENT_COUNT; i++)
+	{
+		if (VertexTraits<V>::GetElement(i).offset != size)
+		{
+			return 0;
+		}
+		size += GetVertexElementSize(VertexTraits<V>::GetElement(i).type);
+	}
+	return size;
+}
+
+// Packs a value in [0, 1] into a 16 bit unsigned normalized element, rounding to the nearest step.
+inline unsigned short PackUNorm16(float aValue)
+{
+	if (aValue <= 0.0f)
+	{
+		return 0;
+	}
+	if (aValue >= 1.0f)
+	{
+		return 65535;
+	}
+	return (unsigned short)(aValue * 65535.0f + 0.5f);
+}
+
+// Packs a value in [-1, 1] into a 16 bit signed normalized element.
+inline short PackSNorm16(float aValue)
+{
+	if (aValue <= -1.0f)
+	{
+		return -32767;
+	}
+	if (aValue >= 1.0f)
+	{
+		return 32767;
+	}
+	return (short)(aValue * 32767.0f + (aValue < 0.0f ? -0.5f : 0.5f));
+}
+
+// Packs a float into a half float element. Values too small for a half flush to zero and values too large
+// saturate to infinity, the mantissa is rounded to nearest.
+inline unsigned short PackHalf(float aValue)
+{
+	unsigned int bits, sign, mantissa;
+	int exponent;
+
+	memcpy(&bits, &aValue, sizeof(bits));
+	sign = (bits >> 16) & 0x8000;
+	exponent = (int)((bits >> 23) & 0xff) - 127 + 15;
+	mantissa = bits & 0x7fffff;
+
+	if (exponent <= 0)
+	{
+		return (unsigned short)sign;
+	}
+	if (exponent >= 31)
+	{
+		return (unsigned short)(sign | 0x7c00);
+	}
+
+	// Rounding can carry into the exponent, which still yields the correctly rounded half.
+	return (unsigned short)(sign | (((unsigned int)exponent << 10) + ((mantissa + 0x1000) >> 13)));
+}
+
+// Packs a color with channels in [0, 1] into an 8 bit per channel element, red in the lowest byte.
+inline unsigned int PackColor(float aRed, float aGreen, float aBlue, float aAlpha)
+{
+	return (unsigned int)(PackUNorm16(aRed) >> 8) | ((unsigned int)(PackUNorm16(aGreen) >> 8) << 8) |
+		((unsigned int)(PackUNorm16(aBlue) >> 8) << 16) | ((unsigned int)(PackUNorm16(aAlpha) >> 8) << 24);
+}
@@ -0,0 +1,438 @@
+#include "WorldStreamer.h"
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+
+// Distance of cells outside the map or a range that holds none.
+static const int FAR_AWAY = 0x7fffffff;
+
+static FILE* OpenFile(const char* aPath, const char* aMode)
+{
+	FILE* file;
+
+#if defined(_WIN32)
+	if (fopen_s(&file, aPath, aMode) != 0)
+	{
+		file = nullptr;
+	}
+#else
+	file = fopen(aPath, aMode);
+#endif
+	return file;
+}
+
+static bool SeekFile(FILE* aFile, size_t aOffset)
+{
+	// Levels can be larger than a long reaches.
+#if defined(_WIN32)
+	return _fseeki64(aFile, (long long)aOffset, SEEK_SET) == 0;
+#else
+	return fseeko(aFile, (off_t)aOffset, SEEK_SET) == 0;
+#endif
+}
+
+WorldStreamer::WorldStreamer()
+{
+	myTilemap = nullptr;
+	myFile = nullptr;
+	myOffset = 0;
+	memset(&mySettings, 0, sizeof(mySettings));
+	myMapWidth = 0;
+	myMapHeight = 0;
+	myCellCountX = 0;
+	myCellCountY = 0;
+	myLoadingCount = 0;
+	memset(&myStats, 0, sizeof(myStats));
+	myWindowBytes = 0;
+	myWindowTime = 0.0f;
+	myKeptRange.minX = myKeptRange.minY = 0;
+	myKeptRange.maxX = myKeptRange.maxY = -1;
+	myQuit = false;
+}
+
+WorldStreamer::~WorldStreamer()
+{
+}
+
+bool WorldStreamer::Initialize(const char* aPath, size_t aOffset, Tilemap& aTilemap, const Settings& aSettings)
+{
+	int i;
+
+	// Cells are whole chunks, so a cell arriving never leaves half a chunk to be built again with the next one.
+	if (aSettings.cellSize <= 0 || aSettings.cellSize % TILEMAP_CHUNK_SIZE != 0 || aSettings.prefetchDistance < 0.0f ||
+		aSettings.lookAheadTime < 0.0f || aSettings.maxResidentCells <= 0 || aSettings.maxLoadsInFlight <= 0)
+	{
+		return false;
+	}
+
+	myFile = OpenFile(aPath, "rb");
+	if (myFile == nullptr)
+	{
+		return false;
+	}
+	myTilemap = &aTilemap;
+	myOffset = aOffset;
+	mySettings = aSettings;
+	myMapWidth = myTilemap->GetWidth();
+	myMapHeight = myTilemap->GetHeight();
+	myCellCountX = (myMapWidth + mySettings.cellSize - 1) / mySettings.cellSize;
+	myCellCountY = (myMapHeight + mySettings.cellSize - 1) / mySettings.cellSize;
+
+	// Nothing is loaded yet, the first update asks for the cells around the view.
+	myCellStates.assign(myCellCountX * myCellCountY, CELL_UNLOADED);
+	myResidentCells.reserve(mySettings.maxResidentCells);
+	myRequests.reserve(mySettings.maxResidentCells);
+
+	// Create a tile buffer for every load that can be in flight, finished loads keep theirs until they are applied.
+	for (i = 0; i < mySettings.maxLoadsInFlight; i++)
+	{
+		myBuffers.push_back(new unsigned short[mySettings.cellSize * mySettings.cellSize]);
+		myFreeBuffers.push_back(myBuffers.back());
+	}
+	myDoneLoads.reserve(mySettings.maxLoadsInFlight);
+	myAppliedLoads.reserve(mySettings.maxLoadsInFlight);
+	myLoadingCount = 0;
+	memset(&myStats, 0, sizeof(myStats));
+	myWindowBytes = 0;
+	myWindowTime = 0.0f;
+	myQuit = false;
+
+	// Start the loader thread.
+	myThread = std::thread(&WorldStreamer::LoaderLoop, this);
+
+	return true;
+}
+
+void WorldStreamer::Shutdown()
+{
+	unsigned int i;
+
+	// Stop the loader thread, the load it is in the middle of is finished first.
+	if (myThread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(myMutex);
+			myQuit = true;
+		}
+		myWorkCondition.notify_one();
+		myThread.join();
+	}
+
+	// Release the tile buffers.
+	for (i = 0; i < myBuffers.size(); i++)
+	{
+		delete[] myBuffers[i];
+	}
+	myBuffers.clear();
+	myFreeBuffers.clear();
+	myDoneLoads.clear();
+	myAppliedLoads.clear();
+	myRequests.clear();
+	myResidentCells.clear();
+	myCellStates.clear();
+
+	// Close the file.
+	if (myFile != nullptr)
+	{
+		fclose(myFile);
+		myFile = nullptr;
+	}
+	myTilemap = nullptr;
+}
+
+void WorldStreamer::Update(float aLeft, float aBottom, float aRight, float aTop, float aVelocityX, float aVelocityY, float aDeltaTime)
+{
+	CellRange visible, ahead, wanted, kept;
+	Request request;
+	float shiftX, shiftY;
+	int x, y, cell, budget;
+	unsigned int i;
+	bool requested;
+
+	if (myTilemap == nullptr)
+	{
+		return;
+	}
+
+	// The cells in view now, those in view after the look ahead time and those within the prefetch distance of either.
+	shiftX = aVelocityX * mySettings.lookAheadTime;
+	shiftY = aVelocityY * mySettings.lookAheadTime;
+	GetCellRange(aLeft, aBottom, aRight, aTop, visible);
+	GetCellRange(aLeft + shiftX, aBottom + shiftY, aRight + shiftX, aTop + shiftY, ahead);
+	GetCellRange((shiftX < 0.0f ? aLeft + shiftX : aLeft) - mySettings.prefetchDistance,
+		(shiftY < 0.0f ? aBottom + shiftY : aBottom) - mySettings.prefetchDistance,
+		(shiftX > 0.0f ? aRight + shiftX : aRight) + mySettings.prefetchDistance,
+		(shiftY > 0.0f ? aTop + shiftY : aTop) + mySettings.prefetchDistance, wanted);
+
+	// Cells are only let go of a cell beyond the ones wanted, so a camera wobbling over a border does not reload them.
+	kept.minX = wanted.minX - 1;
+	kept.minY = wanted.minY - 1;
+	kept.maxX = wanted.maxX + 1;
+	kept.maxY = wanted.maxY + 1;
+	myKeptRange = kept;
+
+	// Take the cells the loader finished into the tilemap.
+	ApplyLoads(visible, kept);
+
+	// Empty the resident cells that are out of reach.
+	for (i = 0; i < myResidentCells.size();)
+	{
+		cell = myResidentCells[i];
+		x = cell % myCellCountX;
+		y = cell / myCellCountX;
+		if (x >= kept.minX && x <= kept.maxX && y >= kept.minY && y <= kept.maxY)
+		{
+			i++;
+			continue;
+		}
+		myTilemap->ClearTileRect(x * mySettings.cellSize, y * mySettings.cellSize, std::min(mySettings.cellSize, myMapWidth - x * mySettings.cellSize),
+			std::min(mySettings.cellSize, myMapHeight - y * mySettings.cellSize));
+		myCellStates[cell] = CELL_UNLOADED;
+		myResidentCells[i] = myResidentCells.back();
+		myResidentCells.pop_back();
+		myStats.unloadedCellCount++;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(myMutex);
+
+		// Drop the requests the loader has not started on, they are asked for again below if they are still wanted.
+		for (i = 0; i < myRequests.size(); i++)
+		{
+			myCellStates[myRequests[i].cell] = CELL_UNLOADED;
+		}
+		myRequests.clear();
+
+		// Ask for every wanted cell that is not loaded or loading, nearest to the view first. Visible cells are at
+		// distance zero, cells ahead of the camera count from wherever they will be seen soonest.
+		for (y = wanted.minY; y <= wanted.maxY; y++)
+		{
+			for (x = wanted.minX; x <= wanted.maxX; x++)
+			{
+				cell = y * myCellCountX + x;
+				if (myCellStates[cell] != CELL_UNLOADED)
+				{
+					continue;
+				}
+				request.cell = cell;
+				request.priority = std::min(GetDistance(x, y, visible), GetDistance(x, y, ahead));
+				myRequests.push_back(request);
+			}
+		}
+
+		// Keep the nearest ones that fit in the budget, the loader takes them from the back.
+		budget = mySettings.maxResidentCells - (int)myResidentCells.size() - myLoadingCount - (int)myDoneLoads.size();
+		budget = budget < 0 ? 0 : budget;
+		std::sort(myRequests.begin(), myRequests.end(), [](const Request& aA, const Request& aB) { return aA.priority < aB.priority; });
+		if ((int)myRequests.size() > budget)
+		{
+			myRequests.resize(budget);
+		}
+		std::reverse(myRequests.begin(), myRequests.end());
+		for (i = 0; i < myRequests.size(); i++)
+		{
+			myCellStates[myRequests[i].cell] = CELL_QUEUED;
+		}
+		requested = !myRequests.empty();
+
+		// Measure the bandwidth over whole seconds.
+		myWindowTime += aDeltaTime;
+		if (myWindowTime >= 1.0f)
+		{
+			myStats.bandwidth = (float)((double)myWindowBytes / myWindowTime);
+			myWindowBytes = 0;
+			myWindowTime = 0.0f;
+		}
+	}
+	if (requested)
+	{
+		myWorkCondition.notify_one();
+	}
+}
+
+void WorldStreamer::Flush()
+{
+	CellRange none;
+	bool done;
+
+	// Take every cell asked for into the tilemap, as a level load would before its first frame. Nothing is shown
+	// in between, so none of them pop in.
+	none.minX = none.minY = 0;
+	none.maxX = none.maxY = -1;
+	do
+	{
+		// Wait until the loader is done or has run out of buffers, which applying the cells read so far hands back.
+		{
+			std::unique_lock<std::mutex> lock(myMutex);
+			myDoneCondition.wait(lock, [this] { return myLoadingCount == 0 && (myRequests.empty() || myFreeBuffers.empty()); });
+			done = myRequests.empty();
+		}
+		ApplyLoads(none, myKeptRange);
+	} while (!done);
+}
+
+int WorldStreamer::GetPendingCellCount()
+{
+	std::lock_guard<std::mutex> lock(myMutex);
+
+	return (int)myRequests.size() + myLoadingCount + (int)myDoneLoads.size();
+}
+
+void WorldStreamer::GetStats(Stats& aStats)
+{
+	std::lock_guard<std::mutex> lock(myMutex);
+
+	// The loader counts the bytes it read, so the stats are copied under the lock.
+	aStats = myStats;
+	aStats.residentCellCount = (int)myResidentCells.size();
+	aStats.pendingCellCount = (int)myRequests.size() + myLoadingCount + (int)myDoneLoads.size();
+}
+
+void WorldStreamer::GetCellRange(float aLeft, float aBottom, float aRight, float aTop, CellRange& aRange)
+{
+	int cellChunks;
+
+	// Cells are squares of chunks, so the chunks in the rectangle give the cells.
+	cellChunks = mySettings.cellSize / TILEMAP_CHUNK_SIZE;
+	myTilemap->GetChunksInRect(aLeft, aBottom, aRight, aTop, aRange.minX, aRange.minY, aRange.maxX, aRange.maxY);
+	aRange.minX /= cellChunks;
+	aRange.minY /= cellChunks;
+	aRange.maxX = aRange.maxX < 0 ? -1 : aRange.maxX / cellChunks;
+	aRange.maxY = aRange.maxY < 0 ? -1 : aRange.maxY / cellChunks;
+}
+
+int WorldStreamer::GetDistance(int aX, int aY, const CellRange& aRange)
+{
+	int distanceX, distanceY;
+
+	if (aRange.minX > aRange.maxX || aRange.minY > aRange.maxY)
+	{
+		return FAR_AWAY;
+	}
+
+	// Count in cells outside the range along the farther axis, so every ring around the range is one step further out.
+	distanceX = aX < aRange.minX ? aRange.minX - aX : (aX > aRange.maxX ? aX - aRange.maxX : 0);
+	distanceY = aY < aRange.minY ? aRange.minY - aY : (aY > aRange.maxY ? aY - aRange.maxY : 0);
+	return std::max(distanceX, distanceY);
+}
+
+void WorldStreamer::ApplyLoads(const CellRange& aVisible, const CellRange& aKept)
+{
+	Load* load;
+	int x, y, width, height;
+	unsigned int i;
+
+	// Take the finished loads, the loader keeps working on the next ones meanwhile.
+	{
+		std::lock_guard<std::mutex> lock(myMutex);
+		myAppliedLoads.swap(myDoneLoads);
+	}
+
+	for (i = 0; i < myAppliedLoads.size(); i++)
+	{
+		load = &myAppliedLoads[i];
+		x = load->cell % myCellCountX;
+		y = load->cell / myCellCountX;
+
+		// A cell the camera moved away from while it was read is thrown away, as is one that could not be read.
+		if (load->failed || x < aKept.minX || x > aKept.maxX || y < aKept.minY || y > aKept.maxY)
+		{
+			myCellStates[load->cell] = CELL_UNLOADED;
+			continue;
+		}
+
+		// Copy the tiles into the tilemap, which marks their chunks to be built.
+		width = std::min(mySettings.cellSize, myMapWidth - x * mySettings.cellSize);
+		height = std::min(mySettings.cellSize, myMapHeight - y * mySettings.cellSize);
+		myTilemap->SetTileRect(x * mySettings.cellSize, y * mySettings.cellSize, width, height, load->tiles, mySettings.cellSize);
+		myCellStates[load->cell] = CELL_RESIDENT;
+		myResidentCells.push_back(load->cell);
+		myStats.loadedCellCount++;
+
+		// A cell that is already in view shows up all at once.
+		if (x >= aVisible.minX && x <= aVisible.maxX && y >= aVisible.minY && y <= aVisible.maxY)
+		{
+			myStats.popInCount++;
+		}
+	}
+
+	// Hand the buffers back to the loader.
+	if (!myAppliedLoads.empty())
+	{
+		{
+			std::lock_guard<std::mutex> lock(myMutex);
+			for (i = 0; i < myAppliedLoads.size(); i++)
+			{
+				myFreeBuffers.push_back(myAppliedLoads[i].tiles);
+			}
+		}
+		myAppliedLoads.clear();
+		myWorkCondition.notify_one();
+	}
+}
+
+void WorldStreamer::LoaderLoop()
+{
+	Load load;
+	int width, height;
+
+	for (;;)
+	{
+		// Sleep until a cell is asked for and there is a buffer to read it into.
+		{
+			std::unique_lock<std::mutex> lock(myMutex);
+			myWorkCondition.wait(lock, [this] { return (!myRequests.empty() && !myFreeBuffers.empty()) || myQuit; });
+			if (myQuit)
+			{
+				return;
+			}
+			load.cell = myRequests.back().cell;
+			load.tiles = myFreeBuffers.back();
+			myRequests.pop_back();
+			myFreeBuffers.pop_back();
+			myCellStates[load.cell] = CELL_LOADING;
+			myLoadingCount++;
+		}
+
+		// Read the cell outside the lock so the frame can go on asking for others.
+		load.failed = !ReadCell(load);
+
+		{
+			std::lock_guard<std::mutex> lock(myMutex);
+			myDoneLoads.push_back(load);
+			myLoadingCount--;
+			if (!load.failed)
+			{
+				width = std::min(mySettings.cellSize, myMapWidth - (load.cell % myCellCountX) * mySettings.cellSize);
+				height = std::min(mySettings.cellSize, myMapHeight - (load.cell / myCellCountX) * mySettings.cellSize);
+				myStats.bytesRead += (long long)width * height * sizeof(unsigned short);
+				myWindowBytes += (long long)width * height * sizeof(unsigned short);
+			}
+		}
+		myDoneCondition.notify_all();
+	}
+}
+
+bool WorldStreamer::ReadCell(Load& aLoad)
+{
+	int x, y, row, width, height;
+
+	x = (aLoad.cell % myCellCountX) * mySettings.cellSize;
+	y = (aLoad.cell / myCellCountX) * mySettings.cellSize;
+	width = std::min(mySettings.cellSize, myMapWidth - x);
+	height = std::min(mySettings.cellSize, myMapHeight - y);
+
+	// The map is stored row by row, so every row of the cell is a read of its own.
+	for (row = 0; row < height; row++)
+	{
+		if (!SeekFile(myFile, myOffset + ((size_t)(y + row) * myMapWidth + x) * sizeof(unsigned short)))
+		{
+			return false;
+		}
+		if (fread(&aLoad.tiles[row * mySettings.cellSize], sizeof(unsigned short), width, myFile) != (size_t)width)
+		{
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "Tilemap.h"
+
+// Streams the tiles of a tilemap from a file in square cells around the view, so only the part of a level near the camera is
+// read and built. The file holds the tiles of the whole map row by row from a given offset, the way a binary scene stores them.
+// A thread of its own reads the cells, those closest to being seen first, and Update copies finished cells into the tilemap.
+// Cells are wanted within the prefetch distance of the view and of where the view will be after the look ahead time at the
+// current velocity, and emptied again once they are a cell further away than that.
+class WorldStreamer
+{
+public:
+	struct Settings
+	{
+		int cellSize;
+		float prefetchDistance;
+		float lookAheadTime;
+		int maxResidentCells;
+		int maxLoadsInFlight;
+	};
+
+	// Cells that became visible before their tiles were read count as pop-ins. The bandwidth covers the last full second.
+	struct Stats
+	{
+		int residentCellCount;
+		int pendingCellCount;
+		int loadedCellCount;
+		int unloadedCellCount;
+		int popInCount;
+		long long bytesRead;
+		float bandwidth;
+	};
+
+	WorldStreamer();
+	WorldStreamer(const WorldStreamer& aWorldStreamer) = delete;
+	~WorldStreamer();
+
+	bool Initialize(const char* aPath, size_t aOffset, Tilemap& aTilemap, const Settings& aSettings);
+	void Shutdown();
+
+	void Update(float aLeft, float aBottom, float aRight, float aTop, float aVelocityX, float aVelocityY, float aDeltaTime);
+	void Flush();
+
+	int GetPendingCellCount();
+	void GetStats(Stats& aStats);
+
+private:
+	enum CellState
+	{
+		CELL_UNLOADED,
+		CELL_QUEUED,
+		CELL_LOADING,
+		CELL_RESIDENT
+	};
+
+	struct Request
+	{
+		int cell;
+		int priority;
+	};
+
+	struct Load
+	{
+		int cell;
+		unsigned short* tiles;
+		bool failed;
+	};
+
+	struct CellRange
+	{
+		int minX;
+		int minY;
+		int maxX;
+		int maxY;
+	};
+
+	void GetCellRange(float aLeft, float aBottom, float aRight, float aTop, CellRange& aRange);
+	static int GetDistance(int aX, int aY, const CellRange& aRange);
+	void ApplyLoads(const CellRange& aVisible, const CellRange& aKept);
+	void LoaderLoop();
+	bool ReadCell(Load& aLoad);
+
+	std::thread myThread;
+	std::mutex myMutex;
+	std::condition_variable myWorkCondition;
+	std::condition_variable myDoneCondition;
+
+	Tilemap* myTilemap;
+	FILE* myFile;
+	size_t myOffset;
+	Settings mySettings;
+	int myMapWidth;
+	int myMapHeight;
+	int myCellCountX;
+	int myCellCountY;
+
+	std::vector<unsigned char> myCellStates;
+	std::vector<int> myResidentCells;
+	std::vector<Request> myRequests;
+	std::vector<unsigned short*> myBuffers;
+	std::vector<unsigned short*> myFreeBuffers;
+	std::vector<Load> myDoneLoads;
+	std::vector<Load> myAppliedLoads;
+	int myLoadingCount;
+
+	CellRange myKeptRange;
+	Stats myStats;
+	long long myWindowBytes;
+	float myWindowTime;
+	bool myQuit;
+};
@@ -1,11 +1,160 @@
 #include "systemclass.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pScmdline, int iCmdshow)
 {
 	SystemClass* System;
-	bool result;
+	Scenario scenario;
+	const char* scenarioName;
+	const char* outputPath;
+	const char* tracePath;
+	const char* baselinePath;
+	const char* recordPath;
+	const char* replayPath;
+	const char* capturePath;
+	const char* scenePath;
+	float streamDistance;
+	CaptureEncoder::Format captureFormat;
+	FILE* console;
+	float threshold, fixedStep;
+	int i, frameCount, exitCode;
+	bool result, headless, fast, offline;
 
 
+	// Read the options of a headless scenario run, of recording and replaying input and of capturing the frames,
+	// without any the interactive scene is shown.
+	scenarioName = nullptr;
+	outputPath = nullptr;
+	tracePath = nullptr;
+	baselinePath = nullptr;
+	recordPath = nullptr;
+	replayPath = nullptr;
+	capturePath = nullptr;
+	scenePath = nullptr;
+	streamDistance = 0.0f;
+	captureFormat = CaptureEncoder::FORMAT_PNG;
+	threshold = -1.0f;
+	fixedStep = 0.0f;
+	frameCount = 0;
+	headless = false;
+	fast = false;
+	offline = false;
+	for (i = 1; i < __argc; i++)
+	{
+		if (strcmp(__argv[i], "--scenario") == 0 && i + 1 < __argc)
+		{
+			scenarioName = __argv[++i];
+		}
+		else if (strcmp(__argv[i], "--frames") == 0 && i + 1 < __argc)
+		{
+			frameCount = atoi(__argv[++i]);
+		}
+		else if (strcmp(__argv[i], "--output") == 0 && i + 1 < __argc)
+		{
+			outputPath = __argv[++i];
+		}
+		else if (strcmp(__argv[i], "--trace") == 0 && i + 1 < __argc)
+		{
+			tracePath = __argv[++i];
+		}
+		else if (strcmp(__argv[i], "--baseline") == 0 && i + 1 < __argc)
+		{
+			baselinePath = __argv[++i];
+		}
+		else if (strcmp(__argv[i], "--threshold") == 0 && i + 1 < __argc)
+		{
+			threshold = (float)atof(__argv[++i]);
+		}
+		else if (strcmp(__argv[i], "--record") == 0 && i + 1 < __argc)
+		{
+			recordPath = __argv[++i];
+		}
+		else if (strcmp(__argv[i], "--replay") == 0 && i + 1 < __argc)
+		{
+			replayPath = __argv[++i];
+		}
+		else if (strcmp(__argv[i], "--fixed-step") == 0 && i + 1 < __argc)
+		{
+			fixedStep = (float)atof(__argv[++i]);
+		}
+		else if (strcmp(__argv[i], "--fast") == 0)
+		{
+			fast = true;
+		}
+		else if (strcmp(__argv[i], "--headless") == 0)
+		{
+			headless = true;
+		}
+		else if (strcmp(__argv[i], "--capture") == 0 && i + 1 < __argc)
+		{
+			capturePath = __argv[++i];
+		}
+		else if (strcmp(__argv[i], "--capture-format") == 0 && i + 1 < __argc)
+		{
+			captureFormat = strcmp(__argv[++i], "tga") == 0 ? CaptureEncoder::FORMAT_TARGA : CaptureEncoder::FORMAT_PNG;
+		}
+		else if (strcmp(__argv[i], "--offline") == 0)
+		{
+			offline = true;
+		}
+		else if (strcmp(__argv[i], "--scene") == 0 && i + 1 < __argc)
+		{
+			scenePath = __argv[++i];
+		}
+		else if (strcmp(__argv[i], "--stream") == 0 && i + 1 < __argc)
+		{
+			streamDistance = (float)atof(__argv[++i]);
+		}
+	}
+
+	// An offline render runs headless as fast as the frames can be drawn and captures without dropping any.
+	headless = headless || offline || scenarioName != nullptr;
+	fast = fast || offline;
+
+	// Print to the console a headless or captured run was started from, if there is one.
+	if ((headless || capturePath != nullptr) && AttachConsole(ATTACH_PARENT_PROCESS))
+	{
+		freopen_s(&console, "CONOUT$", "w", stdout);
+	}
+
+	// Scenarios are found by name first and read from a script otherwise. A replay without one plays the interactive scene.
+	GetDefaultScenario(scenario);
+	if (scenarioName != nullptr)
+	{
+		result = FindScenario(scenarioName, scenario) || LoadScenario(scenarioName, scenario);
+		if (!result)
+		{
+			printf("Unknown scenario or invalid script %s.\n", scenarioName);
+			return 1;
+		}
+		if (frameCount > 0)
+		{
+			scenario.frameCount = frameCount;
+		}
+	}
+	if (threshold < 0.0f)
+	{
+		threshold = scenario.threshold;
+	}
+
+	// A scene or a stream distance given on the command line replaces the one of the scenario.
+	if (scenePath != nullptr)
+	{
+		snprintf(scenario.scene, sizeof(scenario.scene), "%s", scenePath);
+	}
+	if (streamDistance > 0.0f)
+	{
+		scenario.streamDistance = streamDistance;
+	}
+
+	// Offline frames of a replay are a fixed step apart, so the image sequence plays back at the pace of the scenario.
+	if (offline && fixedStep <= 0.0f)
+	{
+		fixedStep = scenario.frameTime;
+	}
+
 	// Create the system object.
 	System = new SystemClass;
 	if (!System)
@@ -13,9 +162,32 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pScmdline,
 		return 0;
 	}
 
-	// Initialize and run the system object.
-	result = System->Initialize();
-	if (result)
+	// Initialize the system object and start recording or replaying the input.
+	exitCode = 0;
+	result = System->Initialize(scenario, headless);
+	if (result && recordPath != nullptr)
+	{
+		result = System->StartRecording(recordPath);
+	}
+	if (result && replayPath != nullptr)
+	{
+		result = System->StartReplay(replayPath, !fast, fixedStep);
+	}
+	if (result && capturePath != nullptr)
+	{
+		result = System->StartCapture(capturePath, captureFormat, offline);
+	}
+
+	// Run the system object, interactively or measured like a scenario.
+	if (!result)
+	{
+		exitCode = 1;
+	}
+	else if (headless)
+	{
+		exitCode = System->RunScenario(outputPath, tracePath, baselinePath, threshold);
+	}
+	else
 	{
 		System->Run();
 	}
@@ -25,5 +197,5 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pScmdline,
 	delete System;
 	System = 0;
 
-	return 0;
+	return exitCode;
 }
\ No newline at end of file
@@ -0,0 +1,40 @@
+#include "SceneWriter.h"
+#include <stdio.h>
+
+int main(int argc, char* argv[])
+{
+	SceneWriter writer;
+	int errorLine;
+	bool result;
+
+	if (argc != 3)
+	{
+		printf("Usage: %s <text scene> <binary scene>\n", argv[0]);
+		return 1;
+	}
+
+	// Read the text scene, the line that stopped the read is reported so it can be fixed.
+	result = writer.ReadText(argv[1], errorLine);
+	if (!result)
+	{
+		if (errorLine > 0)
+		{
+			printf("%s(%d): invalid record.\n", argv[1], errorLine);
+		}
+		else
+		{
+			printf("Could not read %s.\n", argv[1]);
+		}
+		return 1;
+	}
+
+	// Lay the records out in sections and write them in one go.
+	result = writer.Write(argv[2]);
+	if (!result)
+	{
+		printf("Could not write %s.\n", argv[2]);
+		return 1;
+	}
+
+	return 0;
+}